@@ -0,0 +1,224 @@
+/**
+ * @file bench/chair_tracker_bench.c
+ * @brief Arrival-path benchmark: linear chair scan vs direct-indexed chair table.
+ *
+ * Builds a trace with MAX_CHAIRS_IN_TRANSIT chairs always in transit and
+ * riders arriving in random order, then replays it against the previous
+ * upper_worker tracker (linear search + swap-and-pop) and against
+ * core/chair_tracker. Usage: chair_tracker_bench [arrivals]
+ */
+
+#include "constants.h"
+#include "core/chair_tracker.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DEFAULT_ARRIVALS 4000000
+#define BENCH_REPEATS 5
+
+/**
+ * @brief One trace event: an arrival, optionally followed by the next departure.
+ */
+typedef struct {
+    int chair_id;
+    uint32_t seq;
+    int expected;
+    int depart_id;        // Chair that departs after this arrival (0 = none)
+    int depart_expected;  // Riders on the departing chair
+} TraceEvent;
+
+// Chairs already in transit when the trace starts (id, expected)
+static int g_initial[MAX_CHAIRS_IN_TRANSIT][2];
+
+// ============================================================================
+// Previous tracker (linear scan), kept here as the baseline
+// ============================================================================
+
+#define MAX_ACTIVE_CHAIRS 64
+
+typedef struct {
+    int chair_id;
+    int expected;
+    int arrived;
+} LinearTracker;
+
+static LinearTracker g_linear[MAX_ACTIVE_CHAIRS];
+static int g_linear_count = 0;
+
+/**
+ * @brief Count one arrival with the linear tracker.
+ *
+ * @return 1 if the chair completed, 0 otherwise.
+ */
+static int linear_arrive(int chair_id, int expected) {
+    LinearTracker *tracker = NULL;
+    for (int i = 0; i < g_linear_count; i++) {
+        if (g_linear[i].chair_id == chair_id) {
+            tracker = &g_linear[i];
+            break;
+        }
+    }
+    if (tracker == NULL) {
+        if (g_linear_count == MAX_ACTIVE_CHAIRS) {
+            return 0;
+        }
+        tracker = &g_linear[g_linear_count++];
+        tracker->chair_id = chair_id;
+        tracker->expected = expected;
+        tracker->arrived = 0;
+    }
+
+    if (++tracker->arrived < tracker->expected) {
+        return 0;
+    }
+    *tracker = g_linear[--g_linear_count];
+    return 1;
+}
+
+// ============================================================================
+// Trace generation and timing
+// ============================================================================
+
+/**
+ * @brief xorshift32 step (deterministic trace).
+ */
+static uint32_t next_rand(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+/**
+ * @brief Build an arrival trace with MAX_CHAIRS_IN_TRANSIT chairs in flight.
+ */
+static void build_trace(TraceEvent *trace, int count) {
+    ChairTrack tracks[TOTAL_CHAIRS];
+    uint32_t seq_counter = 0;
+    memset(tracks, 0, sizeof(tracks));
+
+    int in_flight[MAX_CHAIRS_IN_TRANSIT];
+    int chair_id = 0;
+    uint32_t rng = 0x9e3779b9u;
+
+    for (int i = 0; i < MAX_CHAIRS_IN_TRANSIT; i++) {
+        chair_id = (chair_id == 0) ? 1 : chair_tracker_next_id(tracks, chair_id);
+        in_flight[i] = chair_id;
+        g_initial[i][0] = chair_id;
+        g_initial[i][1] = 1 + (int)(next_rand(&rng) % CHAIR_CAPACITY);
+        chair_tracker_register(tracks, &seq_counter, chair_id, g_initial[i][1]);
+    }
+
+    for (int n = 0; n < count; n++) {
+        int k = (int)(next_rand(&rng) % MAX_CHAIRS_IN_TRANSIT);
+        ChairTrack *track = &tracks[in_flight[k] - 1];
+
+        trace[n].chair_id = in_flight[k];
+        trace[n].seq = track->seq;
+        trace[n].expected = track->expected;
+        trace[n].depart_id = 0;
+        trace[n].depart_expected = 0;
+
+        if (chair_tracker_arrive(tracks, in_flight[k], track->seq, NULL, NULL) == 1) {
+            chair_id = chair_tracker_next_id(tracks, chair_id);
+            in_flight[k] = chair_id;
+            trace[n].depart_id = chair_id;
+            trace[n].depart_expected = 1 + (int)(next_rand(&rng) % CHAIR_CAPACITY);
+            chair_tracker_register(tracks, &seq_counter, chair_id, trace[n].depart_expected);
+        }
+    }
+}
+
+/**
+ * @brief Monotonic clock in nanoseconds.
+ */
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Replay the trace against the linear tracker.
+ *
+ * @return Nanoseconds per arrival.
+ */
+static double run_linear(const TraceEvent *trace, int count, long *completed) {
+    g_linear_count = 0;
+    long done = 0;
+    double start = now_ns();
+    for (int n = 0; n < count; n++) {
+        done += linear_arrive(trace[n].chair_id, trace[n].expected);
+    }
+    double elapsed = now_ns() - start;
+    *completed = done;
+    return elapsed / count;
+}
+
+/**
+ * @brief Replay the trace against the direct-indexed chair table.
+ *
+ * Includes the departure-side registration the lower worker now performs.
+ *
+ * @return Nanoseconds per arrival.
+ */
+static double run_direct(const TraceEvent *trace, int count, long *completed) {
+    static ChairTrack tracks[TOTAL_CHAIRS];
+    uint32_t seq_counter = 0;
+    memset(tracks, 0, sizeof(tracks));
+    for (int i = 0; i < MAX_CHAIRS_IN_TRANSIT; i++) {
+        chair_tracker_register(tracks, &seq_counter, g_initial[i][0], g_initial[i][1]);
+    }
+    long done = 0;
+    double start = now_ns();
+    for (int n = 0; n < count; n++) {
+        done += (chair_tracker_arrive(tracks, trace[n].chair_id, trace[n].seq, NULL, NULL) == 1);
+        if (trace[n].depart_id != 0) {
+            chair_tracker_register(tracks, &seq_counter, trace[n].depart_id,
+                                   trace[n].depart_expected);
+        }
+    }
+    double elapsed = now_ns() - start;
+    *completed = done;
+    return elapsed / count;
+}
+
+int main(int argc, char *argv[]) {
+    int count = (argc > 1) ? atoi(argv[1]) : DEFAULT_ARRIVALS;
+    if (count <= 0) {
+        fprintf(stderr, "Usage: %s [arrivals]\n", argv[0]);
+        return 1;
+    }
+
+    TraceEvent *trace = malloc((size_t)count * sizeof(TraceEvent));
+    if (trace == NULL) {
+        perror("chair_tracker_bench: malloc");
+        return 1;
+    }
+    build_trace(trace, count);
+
+    double best_linear = 0.0;
+    double best_direct = 0.0;
+    long linear_done = 0;
+    long direct_done = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double linear = run_linear(trace, count, &linear_done);
+        double direct = run_direct(trace, count, &direct_done);
+        if (r == 0 || linear < best_linear) best_linear = linear;
+        if (r == 0 || direct < best_direct) best_direct = direct;
+    }
+
+    printf("chair_tracker_bench: %d arrivals, %d chairs in transit, %d chair IDs\n",
+           count, MAX_CHAIRS_IN_TRANSIT, TOTAL_CHAIRS);
+    printf("  linear scan    %8.2f ns/arrival  (%ld chairs completed)\n", best_linear, linear_done);
+    printf("  direct table   %8.2f ns/arrival  (%ld chairs completed)\n", best_direct, direct_done);
+    printf("  speedup        %8.2fx\n", best_direct > 0.0 ? best_linear / best_direct : 0.0);
+
+    free(trace);
+    return (linear_done == direct_done) ? 0 : 1;
+}
@@ -0,0 +1,377 @@
+/**
+ * @file bench/ipc_bench.c
+ * @brief IPC primitive microbenchmarks: SysV vs futex/ring implementations.
+ *
+ * Creates the simulation's real IPC resources (ipc_create) once per
+ * implementation and times the calls the processes make:
+ * - sem_wait/sem_post and sem_trywait/sem_post on the SEM_STATE mutex with
+ *   1..max_procs processes (1 = uncontended);
+ * - send+receive of CashierMsg (cashier queue, always SysV), PlatformMsg
+ *   and ArrivalMsg (transport_*) at queue depths 1..DEPTH_MAX: depth
+ *   messages are sent, then all are received;
+ * - PlatformMsg/ArrivalMsg streaming from 1..max_procs producer processes
+ *   to one consumer process;
+ * - shmat/shmdt of the segment and the full ipc_attach/ipc_detach a child
+ *   does at startup.
+ * "sysv" runs with SEM_BACKEND=0, QUEUE_TRANSPORT=0; "shm" with
+ * SEM_BACKEND=1, QUEUE_TRANSPORT=1. Every row has the same columns for both,
+ * so the two blocks compare line by line. ns_per_op is the mean time one
+ * process spends per operation (wall time * processes / operations). Usage:
+ * ipc_bench [ops] [max_procs]
+ *
+ * Contended rows need several CPUs to show contention; with one CPU they
+ * mostly measure scheduler handoffs.
+ */
+
+#include "constants.h"
+#include "core/config.h"
+#include "ipc/ipc.h"
+#include "ipc/transport.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/msg.h>
+#include <sys/shm.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_OPS 200000L
+#define DEFAULT_MAX_PROCS 4
+#define DEPTH_MAX 256
+#define SHM_ATTACH_DIVISOR 10           // Attach rows run ops / 10 iterations (each is several syscalls)
+
+/**
+ * @brief Message kinds the simulation exchanges.
+ */
+typedef enum {
+    MSG_CASHIER = 0,
+    MSG_PLATFORM = 1,
+    MSG_ARRIVAL = 2,
+    MSG_KIND_COUNT = 3
+} MsgKind;
+
+static const char *msg_names[MSG_KIND_COUNT] = {"cashier", "platform", "arrival"};
+static const size_t msg_sizes[MSG_KIND_COUNT] = {sizeof(CashierMsg), sizeof(PlatformMsg),
+                                                 sizeof(ArrivalMsg)};
+
+/**
+ * @brief Worker body run in each forked process.
+ *
+ * @param res Resources inherited from the parent.
+ * @param index Process index 0..procs-1.
+ * @param procs Processes in the run.
+ * @param ops Total operations of the run (all processes).
+ * @param arg Test-specific argument.
+ */
+typedef void (*WorkerFn)(IPCResources *res, int index, int procs, long ops, int arg);
+
+static IPCKeys g_keys;
+
+/**
+ * @brief Monotonic clock in nanoseconds.
+ */
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void print_header(void) {
+    printf("%-5s %-18s %-8s %5s %9s %5s %10s %12s %14s\n", "impl", "primitive", "message",
+           "procs", "msg_bytes", "depth", "ops", "ns_per_op", "ops_per_sec");
+}
+
+static void print_row(const char *impl, const char *primitive, const char *message, int procs,
+                      size_t msg_bytes, int depth, long ops, double elapsed_ns) {
+    double per_op = ops > 0 ? elapsed_ns * procs / (double)ops : 0.0;
+    double per_sec = elapsed_ns > 0.0 ? (double)ops * 1e9 / elapsed_ns : 0.0;
+    printf("%-5s %-18s %-8s %5d %9zu %5d %10ld %12.1f %14.0f\n", impl, primitive, message,
+           procs, msg_bytes, depth, ops, per_op, per_sec);
+    fflush(stdout);
+}
+
+/**
+ * @brief Fork procs workers, release them together and time until all exit.
+ *
+ * @return Wall time in ns, or -1 on error.
+ */
+static double run_procs(IPCResources *res, int procs, long ops, WorkerFn fn, int arg) {
+    int start[2];
+    if (pipe(start) == -1) {
+        perror("ipc_bench: pipe");
+        return -1;
+    }
+
+    int forked = 0;
+    for (int i = 0; i < procs; i++) {
+        pid_t pid = fork();
+        if (pid == -1) {
+            perror("ipc_bench: fork");
+            break;
+        }
+        if (pid == 0) {
+            close(start[1]);
+            char c;
+            while (read(start[0], &c, 1) == -1 && errno == EINTR) {
+                // Retry
+            }
+            fn(res, i, procs, ops, arg);
+            _exit(0);
+        }
+        forked++;
+    }
+
+    // EOF on the pipe releases every worker at once
+    close(start[0]);
+    double t0 = now_ns();
+    close(start[1]);
+    int failed = forked < procs;
+    for (int i = 0; i < forked; i++) {
+        int status;
+        while (wait(&status) == -1 && errno == EINTR) {
+            // Retry
+        }
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            failed = 1;
+        }
+    }
+    return failed ? -1 : now_ns() - t0;
+}
+
+/**
+ * @brief Share of ops for one of procs processes (remainder to process 0).
+ */
+static long share_of(long ops, int index, int procs) {
+    return ops / procs + (index == 0 ? ops % procs : 0);
+}
+
+// ============================================================================
+// Semaphores
+// ============================================================================
+
+static void sem_wait_post_worker(IPCResources *res, int index, int procs, long ops, int arg) {
+    (void)arg;
+    for (long n = share_of(ops, index, procs); n > 0; n--) {
+        if (sem_wait(res->sem_id, SEM_STATE, 1) == -1) _exit(1);
+        sem_post(res->sem_id, SEM_STATE, 1);
+    }
+}
+
+static void sem_trywait_post_worker(IPCResources *res, int index, int procs, long ops, int arg) {
+    (void)arg;
+    for (long n = share_of(ops, index, procs); n > 0; n--) {
+        if (sem_trywait(res->sem_id, SEM_STATE) == 0) {
+            sem_post(res->sem_id, SEM_STATE, 1);
+        }
+    }
+}
+
+// ============================================================================
+// Messages
+// ============================================================================
+
+/**
+ * @brief Send one message of a kind.
+ *
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+static int msg_send(IPCResources *res, MsgKind kind, int id, int flags) {
+    switch (kind) {
+        case MSG_CASHIER: {
+            CashierMsg msg = {.mtype = 1, .tourist_id = id, .age = 30};
+            return msgsnd(res->mq_cashier_id, &msg, sizeof(msg) - sizeof(long), flags);
+        }
+        case MSG_PLATFORM: {
+            PlatformMsg msg = {.mtype = 2, .tourist_id = id, .slots_needed = 1};
+            return transport_platform_send(res, &msg, flags);
+        }
+        default: {
+            ArrivalMsg msg = {.mtype = 1, .tourist_id = id, .tourists_on_chair = 1};
+            return transport_arrival_send(res, &msg, flags);
+        }
+    }
+}
+
+/**
+ * @brief Receive one message of a kind (blocking).
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int msg_recv(IPCResources *res, MsgKind kind) {
+    switch (kind) {
+        case MSG_CASHIER: {
+            CashierMsg msg;
+            return msgrcv(res->mq_cashier_id, &msg, sizeof(msg) - sizeof(long), 0, 0) == -1 ? -1 : 0;
+        }
+        case MSG_PLATFORM: {
+            PlatformMsg msg;
+            return transport_platform_recv(res, &msg);
+        }
+        default: {
+            ArrivalMsg msg;
+            return transport_arrival_recv(res, &msg);
+        }
+    }
+}
+
+/**
+ * @brief Send depth messages, then receive them, until ops messages passed.
+ *
+ * @return Wall time in ns, or -1 on error. depth is lowered if the queue fills first.
+ */
+static double run_batched(IPCResources *res, MsgKind kind, long ops, int *depth) {
+    double t0 = now_ns();
+    for (long done = 0; done < ops;) {
+        int sent = 0;
+        while (sent < *depth && done + sent < ops) {
+            if (msg_send(res, kind, sent + 1, IPC_NOWAIT) == -1) {
+                if (errno != EAGAIN || sent == 0) {
+                    perror("ipc_bench: send");
+                    return -1;
+                }
+                *depth = sent;  // Queue limit (msgmnb or ring capacity) reached
+                break;
+            }
+            sent++;
+        }
+        for (int i = 0; i < sent; i++) {
+            if (msg_recv(res, kind) == -1) {
+                perror("ipc_bench: recv");
+                return -1;
+            }
+        }
+        done += sent;
+    }
+    return now_ns() - t0;
+}
+
+/**
+ * @brief Process 0 consumes every message, the others produce their share.
+ */
+static void stream_worker(IPCResources *res, int index, int procs, long ops, int kind) {
+    if (index == 0) {
+        for (long n = 0; n < ops; n++) {
+            if (msg_recv(res, (MsgKind)kind) == -1) _exit(1);
+        }
+        return;
+    }
+    for (long n = share_of(ops, index - 1, procs - 1); n > 0; n--) {
+        if (msg_send(res, (MsgKind)kind, index, 0) == -1) _exit(1);
+    }
+}
+
+// ============================================================================
+// Shared memory attach
+// ============================================================================
+
+static double run_shmat(IPCResources *res, long ops) {
+    double t0 = now_ns();
+    for (long n = 0; n < ops; n++) {
+        void *addr = shmat(res->shm_id, NULL, 0);
+        if (addr == (void *)-1) {
+            perror("ipc_bench: shmat");
+            return -1;
+        }
+        shmdt(addr);
+    }
+    return now_ns() - t0;
+}
+
+static double run_ipc_attach(long ops) {
+    double t0 = now_ns();
+    for (long n = 0; n < ops; n++) {
+        IPCResources child;
+        if (ipc_attach(&child, &g_keys) == -1) {
+            return -1;
+        }
+        ipc_detach(&child);
+    }
+    return now_ns() - t0;
+}
+
+/**
+ * @brief Run every test against one implementation.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int bench_impl(const char *impl, int sem_backend, int queue_transport, long ops,
+                      int max_procs) {
+    Config cfg;
+    config_set_defaults(&cfg);
+    cfg.sem_backend = sem_backend;
+    cfg.queue_transport = queue_transport;
+
+    IPCResources res;
+    ipc_cleanup_stale(&g_keys);
+    if (ipc_create(&res, &g_keys, &cfg) == -1) {
+        return -1;
+    }
+    ipc_select_cashier(&res, 0);
+
+    int rc = 0;
+    double ns;
+    for (int procs = 1; procs <= max_procs && rc == 0; procs *= 2) {
+        if ((ns = run_procs(&res, procs, ops, sem_wait_post_worker, 0)) < 0) rc = -1;
+        else print_row(impl, "sem_wait+post", "-", procs, 0, 0, ops, ns);
+    }
+    for (int procs = 1; procs <= max_procs && rc == 0; procs *= 2) {
+        if ((ns = run_procs(&res, procs, ops, sem_trywait_post_worker, 0)) < 0) rc = -1;
+        else print_row(impl, "sem_trywait+post", "-", procs, 0, 0, ops, ns);
+    }
+
+    for (int kind = 0; kind < MSG_KIND_COUNT && rc == 0; kind++) {
+        const char *primitive = kind == MSG_CASHIER ? "msgsnd+msgrcv" : "send+recv";
+        for (int depth = 1; depth <= DEPTH_MAX && rc == 0; depth *= 4) {
+            int used = depth;
+            if ((ns = run_batched(&res, (MsgKind)kind, ops, &used)) < 0) rc = -1;
+            else print_row(impl, primitive, msg_names[kind], 1, msg_sizes[kind], used, ops, ns);
+        }
+    }
+    for (int kind = MSG_PLATFORM; kind < MSG_KIND_COUNT && rc == 0; kind++) {
+        // procs producers plus one consumer
+        for (int procs = 1; procs <= max_procs && rc == 0; procs *= 2) {
+            if ((ns = run_procs(&res, procs + 1, ops, stream_worker, kind)) < 0) rc = -1;
+            else print_row(impl, "stream", msg_names[kind], procs + 1, msg_sizes[kind], 0, ops, ns);
+        }
+    }
+
+    long attach_ops = ops / SHM_ATTACH_DIVISOR > 0 ? ops / SHM_ATTACH_DIVISOR : 1;
+    if (rc == 0) {
+        if ((ns = run_shmat(&res, attach_ops)) < 0) rc = -1;
+        else print_row(impl, "shmat+shmdt", "-", 1, res.state->shm_size, 0, attach_ops, ns);
+    }
+    if (rc == 0) {
+        if ((ns = run_ipc_attach(attach_ops)) < 0) rc = -1;
+        else print_row(impl, "ipc_attach+detach", "-", 1, 0, 0, attach_ops, ns);
+    }
+
+    ipc_destroy(&res);
+    return rc;
+}
+
+int main(int argc, char *argv[]) {
+    long ops = (argc > 1) ? atol(argv[1]) : DEFAULT_OPS;
+    int max_procs = (argc > 2) ? atoi(argv[2]) : DEFAULT_MAX_PROCS;
+    if (ops <= 0 || max_procs <= 0) {
+        fprintf(stderr, "Usage: %s [ops] [max_procs]\n", argv[0]);
+        return 1;
+    }
+
+    // Keys from the benchmark binary, never the simulation's "." keys
+    if (ipc_generate_keys(&g_keys, "/proc/self/exe") == -1) {
+        return 1;
+    }
+
+    printf("IPC microbenchmark: %ld operations per row, 1..%d processes, %ld CPUs\n",
+           ops, max_procs, sysconf(_SC_NPROCESSORS_ONLN));
+    print_header();
+    if (bench_impl("sysv", SEM_BACKEND_SYSV, QUEUE_TRANSPORT_SYSV, ops, max_procs) == -1 ||
+        bench_impl("shm", SEM_BACKEND_FUTEX, QUEUE_TRANSPORT_SHM, ops, max_procs) == -1) {
+        fprintf(stderr, "ipc_bench: run failed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file bench/rng_bench.c
+ * @brief PRNG benchmark: rand() % 100 vs xoshiro256** single and lane draws.
+ *
+ * Times the draw tourist attribute generation and check_for_danger make per
+ * random value (a percentage in [0, 100)) with rand(), with one Rng
+ * (rng_below) and with RngLanes (RNG_LANES values per call). Usage:
+ * rng_bench [draws]
+ */
+
+#include "core/rng.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_DRAWS 20000000L
+#define BENCH_REPEATS 3
+
+/**
+ * @brief Monotonic clock in nanoseconds.
+ */
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double run_rand(long draws, long *sum) {
+    long acc = 0;
+    double start = now_ns();
+    for (long n = 0; n < draws; n++) {
+        acc += rand() % 100;
+    }
+    double elapsed = now_ns() - start;
+    *sum = acc;
+    return elapsed / (double)draws;
+}
+
+static double run_single(long draws, long *sum) {
+    Rng rng;
+    rng_seed(&rng, 12345, RNG_STREAM_GENERATOR);
+    long acc = 0;
+    double start = now_ns();
+    for (long n = 0; n < draws; n++) {
+        acc += rng_below(&rng, 100);
+    }
+    double elapsed = now_ns() - start;
+    *sum = acc;
+    return elapsed / (double)draws;
+}
+
+static double run_lanes(long draws, long *sum) {
+    RngLanes lanes;
+    rng_lanes_seed(&lanes, 12345, RNG_STREAM_GENERATOR);
+    uint64_t out[RNG_LANES];
+    long acc = 0;
+    double start = now_ns();
+    for (long n = 0; n < draws; n += RNG_LANES) {
+        rng_lanes_next(&lanes, out);
+        for (int l = 0; l < RNG_LANES; l++) {
+            acc += rng_scale(out[l], 100);
+        }
+    }
+    double elapsed = now_ns() - start;
+    *sum = acc;
+    return elapsed / (double)draws;
+}
+
+int main(int argc, char *argv[]) {
+    long draws = (argc > 1) ? atol(argv[1]) : DEFAULT_DRAWS;
+    if (draws <= 0) {
+        fprintf(stderr, "Usage: %s [draws]\n", argv[0]);
+        return 1;
+    }
+    srand(12345);
+
+    double best_rand = 0.0, best_single = 0.0, best_lanes = 0.0;
+    long rand_sum = 0, single_sum = 0, lanes_sum = 0;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double t = run_rand(draws, &rand_sum);
+        if (r == 0 || t < best_rand) best_rand = t;
+        t = run_single(draws, &single_sum);
+        if (r == 0 || t < best_single) best_single = t;
+        t = run_lanes(draws, &lanes_sum);
+        if (r == 0 || t < best_lanes) best_lanes = t;
+    }
+
+    // Mean of a uniform draw in [0, 100) is 49.5
+    printf("rng_bench: %ld draws in [0, 100) (best of %d)\n", draws, BENCH_REPEATS);
+    printf("  rand() %% 100     %6.2f ns/draw  (mean %.2f)\n", best_rand,
+           (double)rand_sum / (double)draws);
+    printf("  rng_below        %6.2f ns/draw  (mean %.2f)\n", best_single,
+           (double)single_sum / (double)draws);
+    printf("  rng_lanes_next   %6.2f ns/draw  (mean %.2f, %d lanes)\n", best_lanes,
+           (double)lanes_sum / (double)draws, RNG_LANES);
+    printf("  speedup          %6.2fx single, %.2fx lanes\n",
+           best_single > 0.0 ? best_rand / best_single : 0.0,
+           best_lanes > 0.0 ? best_rand / best_lanes : 0.0);
+    return 0;
+}
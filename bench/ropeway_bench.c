@@ -0,0 +1,486 @@
+/**
+ * @file bench/ropeway_bench.c
+ * @brief Scenario benchmark: runs config/test*.conf headless and reports JSON.
+ *
+ * Each named scenario (config/<name>.conf, e.g. test5_stress) runs through
+ * ./ropeway_simulation with debug logs off and its output discarded, so
+ * the benchmark must be started from the build directory like the
+ * simulation itself. Tourists/rides per second, chair slot utilization,
+ * wait latency percentiles and the shm segment size are read from
+ * simulation_report.txt. CPU time, context switches, page faults and peak
+ * RSS come from getrusage(RUSAGE_CHILDREN) of a helper process that runs
+ * only that scenario, so every scenario is measured on its own. Read and
+ * write system calls come from the helper's /proc/self/io, which sums the
+ * I/O accounting of every reaped descendant; getrusage has no syscall
+ * count. Usage:
+ * ropeway_bench [-c config_dir] [-o output.json] [-r repeats] [-t timeout_s] <scenario|--all>...
+ */
+
+#include "constants.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <glob.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_CONFIG_DIR "../config"
+#define DEFAULT_TIMEOUT_S 300
+#define REPORT_FILE "simulation_report.txt"
+#define SIMULATION_EXE "./ropeway_simulation"
+#define NAME_MAX_LEN 128
+#define PATH_MAX_LEN 512
+#define POLL_US 50000
+
+static const char *stage_keys[LAT_STAGE_COUNT] = {"entry_gates", "lower_station", "platform_gates",
+                                                  "boarding", "exit_gates"};
+
+/**
+ * @brief Resource usage of one scenario, measured by its helper process.
+ */
+typedef struct {
+    int exit_code;                  // Simulation exit status (-1 = killed or not started)
+    int timed_out;                  // 1 if the simulation was stopped after the timeout
+    double wall_seconds;
+    double user_seconds;
+    double system_seconds;
+    long voluntary_switches;
+    long involuntary_switches;
+    long minor_faults;
+    long major_faults;
+    long max_rss_kb;                // Largest resident set of any process in the tree
+    long long read_syscalls;        // -1 if /proc/self/io is unavailable
+    long long write_syscalls;
+} RunUsage;
+
+/**
+ * @brief One wait latency row of the report.
+ */
+typedef struct {
+    unsigned long long samples;
+    double mean, p50, p90, p99, max;
+} StageLatency;
+
+/**
+ * @brief Figures parsed from simulation_report.txt.
+ */
+typedef struct {
+    int found;                      // 1 if the report was read
+    long tourists;
+    long rides;
+    unsigned long long chairs;
+    double slot_utilization;        // Percent
+    unsigned long long shm_bytes;
+    StageLatency latency[LAT_STAGE_COUNT];
+} ReportFigures;
+
+/**
+ * @brief Monotonic clock in seconds.
+ */
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Copy a scenario config and turn debug logging off (later keys win).
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int write_headless_config(const char *src, const char *dst) {
+    FILE *in = fopen(src, "r");
+    if (in == NULL) {
+        perror("ropeway_bench: open config");
+        return -1;
+    }
+    FILE *out = fopen(dst, "w");
+    if (out == NULL) {
+        perror("ropeway_bench: create config");
+        fclose(in);
+        return -1;
+    }
+
+    char line[512];
+    while (fgets(line, sizeof(line), in) != NULL) {
+        fputs(line, out);
+    }
+    fputs("\nDEBUG_LOGS_ENABLED=0\n", out);
+    fclose(in);
+    if (fclose(out) != 0) {
+        perror("ropeway_bench: write config");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read/write syscall counters of this process (children included once reaped).
+ */
+static void read_proc_io(long long *syscr, long long *syscw) {
+    *syscr = -1;
+    *syscw = -1;
+    FILE *f = fopen("/proc/self/io", "r");
+    if (f == NULL) {
+        return;
+    }
+    char key[32];
+    long long value;
+    while (fscanf(f, "%31[^:]: %lld\n", key, &value) == 2) {
+        if (strcmp(key, "syscr") == 0) *syscr = value;
+        if (strcmp(key, "syscw") == 0) *syscw = value;
+    }
+    fclose(f);
+}
+
+/**
+ * @brief Helper process body: run the simulation once and measure its tree.
+ *
+ * @param config Headless config path.
+ * @param timeout_s Seconds before the simulation is sent SIGTERM.
+ * @param out Output: usage of the run.
+ */
+static void measure_run(const char *config, int timeout_s, RunUsage *out) {
+    memset(out, 0, sizeof(*out));
+    out->exit_code = -1;
+
+    double start = now_s();
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("ropeway_bench: fork");
+        return;
+    }
+    if (pid == 0) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull != -1) {
+            dup2(devnull, STDOUT_FILENO);
+            dup2(devnull, STDERR_FILENO);
+            close(devnull);
+        }
+        execl(SIMULATION_EXE, "ropeway_simulation", config, NULL);
+        _exit(127);
+    }
+
+    int status = 0;
+    int signalled = 0;
+    while (1) {
+        pid_t r = waitpid(pid, &status, WNOHANG);
+        if (r == pid) {
+            break;
+        }
+        if (r == -1 && errno != EINTR) {
+            perror("ropeway_bench: waitpid");
+            return;
+        }
+        if (!signalled && now_s() - start > timeout_s) {
+            // SIGTERM lets the simulation clean up its IPC objects
+            kill(pid, SIGTERM);
+            signalled = 1;
+            out->timed_out = 1;
+        }
+        usleep(POLL_US);
+    }
+    out->wall_seconds = now_s() - start;
+    out->exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+
+    struct rusage ru;
+    getrusage(RUSAGE_CHILDREN, &ru);
+    out->user_seconds = (double)ru.ru_utime.tv_sec + (double)ru.ru_utime.tv_usec / 1e6;
+    out->system_seconds = (double)ru.ru_stime.tv_sec + (double)ru.ru_stime.tv_usec / 1e6;
+    out->voluntary_switches = ru.ru_nvcsw;
+    out->involuntary_switches = ru.ru_nivcsw;
+    out->minor_faults = ru.ru_minflt;
+    out->major_faults = ru.ru_majflt;
+    out->max_rss_kb = ru.ru_maxrss;
+    read_proc_io(&out->read_syscalls, &out->write_syscalls);
+}
+
+/**
+ * @brief Run one scenario in a fresh helper so its rusage is not mixed with others.
+ *
+ * @return 0 on success, -1 if the helper failed.
+ */
+static int run_scenario(const char *config, int timeout_s, RunUsage *usage) {
+    int fds[2];
+    if (pipe(fds) == -1) {
+        perror("ropeway_bench: pipe");
+        return -1;
+    }
+
+    pid_t helper = fork();
+    if (helper == -1) {
+        perror("ropeway_bench: fork helper");
+        close(fds[0]);
+        close(fds[1]);
+        return -1;
+    }
+    if (helper == 0) {
+        close(fds[0]);
+        RunUsage u;
+        measure_run(config, timeout_s, &u);
+        ssize_t n = write(fds[1], &u, sizeof(u));
+        _exit(n == (ssize_t)sizeof(u) ? 0 : 1);
+    }
+
+    close(fds[1]);
+    ssize_t n;
+    while ((n = read(fds[0], usage, sizeof(*usage))) == -1 && errno == EINTR) {
+        // Retry
+    }
+    close(fds[0]);
+    while (waitpid(helper, NULL, 0) == -1 && errno == EINTR) {
+        // Retry
+    }
+    return n == (ssize_t)sizeof(*usage) ? 0 : -1;
+}
+
+/**
+ * @brief Parse one "  <stage name> samples mean p50 p90 p99 max" row.
+ *
+ * @return Stage index, or -1 if the line is not a latency row.
+ */
+static int parse_latency_row(const char *line, StageLatency *out) {
+    static const char *stage_names[LAT_STAGE_COUNT] = {"Entry gates", "Lower station",
+                                                       "Platform gates", "Boarding", "Exit gates"};
+    while (*line == ' ') line++;
+    for (int i = 0; i < LAT_STAGE_COUNT; i++) {
+        size_t len = strlen(stage_names[i]);
+        if (strncmp(line, stage_names[i], len) == 0 &&
+            sscanf(line + len, "%llu %lf %lf %lf %lf %lf", &out->samples, &out->mean,
+                   &out->p50, &out->p90, &out->p99, &out->max) == 6) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Read the figures of the last run from simulation_report.txt.
+ */
+static void parse_report(const char *path, ReportFigures *fig) {
+    memset(fig, 0, sizeof(*fig));
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return;
+    }
+    fig->found = 1;
+
+    char line[512];
+    int in_latency = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "Total tourists: %ld", &fig->tourists) == 1 ||
+            sscanf(line, "Total rides: %ld", &fig->rides) == 1 ||
+            sscanf(line, "  Chairs departed: %llu", &fig->chairs) == 1 ||
+            sscanf(line, "  Slot utilization: %lf", &fig->slot_utilization) == 1 ||
+            sscanf(line, "  Shared memory: %llu", &fig->shm_bytes) == 1) {
+            continue;
+        }
+        if (strncmp(line, "--- Wait Latency", 16) == 0) {
+            in_latency = 1;
+            continue;
+        }
+        if (in_latency) {
+            StageLatency row;
+            int stage = parse_latency_row(line, &row);
+            if (stage >= 0) {
+                fig->latency[stage] = row;
+            } else if (line[0] != ' ') {
+                in_latency = 0;
+            }
+        }
+    }
+    fclose(f);
+}
+
+/**
+ * @brief Print one scenario run as a JSON object.
+ */
+static void print_json(FILE *out, const char *name, int repeat, const RunUsage *u,
+                       const ReportFigures *fig, int first) {
+    double wall = u->wall_seconds > 0.0 ? u->wall_seconds : 1.0;
+
+    fprintf(out, "%s    {\n", first ? "" : ",\n");
+    fprintf(out, "      \"scenario\": \"%s\",\n", name);
+    fprintf(out, "      \"repeat\": %d,\n", repeat);
+    fprintf(out, "      \"exit_code\": %d,\n", u->exit_code);
+    fprintf(out, "      \"timed_out\": %s,\n", u->timed_out ? "true" : "false");
+    fprintf(out, "      \"report_found\": %s,\n", fig->found ? "true" : "false");
+    fprintf(out, "      \"wall_seconds\": %.3f,\n", u->wall_seconds);
+    fprintf(out, "      \"tourists\": %ld,\n", fig->tourists);
+    fprintf(out, "      \"rides\": %ld,\n", fig->rides);
+    fprintf(out, "      \"tourists_per_sec\": %.2f,\n", (double)fig->tourists / wall);
+    fprintf(out, "      \"rides_per_sec\": %.2f,\n", (double)fig->rides / wall);
+    fprintf(out, "      \"chairs_departed\": %llu,\n", fig->chairs);
+    fprintf(out, "      \"slot_utilization_pct\": %.1f,\n", fig->slot_utilization);
+    fprintf(out, "      \"latency_ms\": {\n");
+    for (int i = 0; i < LAT_STAGE_COUNT; i++) {
+        const StageLatency *s = &fig->latency[i];
+        fprintf(out, "        \"%s\": {\"samples\": %llu, \"mean\": %.3f, \"p50\": %.3f, "
+                     "\"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f}%s\n",
+                stage_keys[i], s->samples, s->mean, s->p50, s->p90, s->p99, s->max,
+                i + 1 < LAT_STAGE_COUNT ? "," : "");
+    }
+    fprintf(out, "      },\n");
+    fprintf(out, "      \"user_seconds\": %.3f,\n", u->user_seconds);
+    fprintf(out, "      \"system_seconds\": %.3f,\n", u->system_seconds);
+    fprintf(out, "      \"voluntary_ctx_switches\": %ld,\n", u->voluntary_switches);
+    fprintf(out, "      \"involuntary_ctx_switches\": %ld,\n", u->involuntary_switches);
+    fprintf(out, "      \"minor_faults\": %ld,\n", u->minor_faults);
+    fprintf(out, "      \"major_faults\": %ld,\n", u->major_faults);
+    if (u->read_syscalls >= 0) {
+        fprintf(out, "      \"read_syscalls\": %lld,\n", u->read_syscalls);
+        fprintf(out, "      \"write_syscalls\": %lld,\n", u->write_syscalls);
+    } else {
+        fprintf(out, "      \"read_syscalls\": null,\n");
+        fprintf(out, "      \"write_syscalls\": null,\n");
+    }
+    fprintf(out, "      \"peak_rss_kb\": %ld,\n", u->max_rss_kb);
+    fprintf(out, "      \"shm_bytes\": %llu\n", fig->shm_bytes);
+    fprintf(out, "    }");
+}
+
+/**
+ * @brief Scenario name of a config path (basename without .conf).
+ */
+static void scenario_name(const char *path, char *name, size_t size) {
+    const char *base = strrchr(path, '/');
+    base = base ? base + 1 : path;
+    snprintf(name, size, "%s", base);
+    char *dot = strstr(name, ".conf");
+    if (dot != NULL) *dot = '\0';
+}
+
+/**
+ * @brief Run every repeat of one scenario and print it.
+ *
+ * @return 0 if every run exited cleanly, 1 otherwise.
+ */
+static int bench_scenario(FILE *out, const char *config_dir, const char *name, int repeats,
+                          int timeout_s, int *first) {
+    char config[PATH_MAX_LEN];
+    char headless[] = "/tmp/ropeway_bench_XXXXXX";
+    snprintf(config, sizeof(config), "%s/%s.conf", config_dir, name);
+
+    int fd = mkstemp(headless);
+    if (fd == -1) {
+        perror("ropeway_bench: mkstemp");
+        return 1;
+    }
+    close(fd);
+    if (write_headless_config(config, headless) == -1) {
+        unlink(headless);
+        return 1;
+    }
+
+    int failed = 0;
+    for (int r = 1; r <= repeats; r++) {
+        fprintf(stderr, "ropeway_bench: %s (run %d/%d)\n", name, r, repeats);
+        unlink(REPORT_FILE);
+
+        RunUsage usage;
+        if (run_scenario(headless, timeout_s, &usage) == -1) {
+            failed = 1;
+            continue;
+        }
+        ReportFigures fig;
+        parse_report(REPORT_FILE, &fig);
+        print_json(out, name, r, &usage, &fig, *first);
+        *first = 0;
+        if (usage.exit_code != 0 || usage.timed_out || !fig.found) {
+            failed = 1;
+        }
+    }
+    unlink(headless);
+    return failed;
+}
+
+static void usage(const char *argv0) {
+    fprintf(stderr, "Usage: %s [-c config_dir] [-o output.json] [-r repeats] [-t timeout_s] "
+                    "<scenario|--all>...\n", argv0);
+    fprintf(stderr, "  scenario: config file name without .conf (e.g. test5_stress)\n");
+    fprintf(stderr, "  --all:    every test*.conf in config_dir\n");
+}
+
+int main(int argc, char *argv[]) {
+    const char *config_dir = DEFAULT_CONFIG_DIR;
+    const char *output = NULL;
+    int repeats = 1;
+    int timeout_s = DEFAULT_TIMEOUT_S;
+    int all = 0;
+
+    // "--all" is not an option getopt knows; pick it out first
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--all") == 0) {
+            all = 1;
+            for (int j = i; j + 1 < argc; j++) argv[j] = argv[j + 1];
+            argc--;
+            i--;
+        }
+    }
+
+    int opt;
+    while ((opt = getopt(argc, argv, "c:o:r:t:h")) != -1) {
+        switch (opt) {
+            case 'c': config_dir = optarg; break;
+            case 'o': output = optarg; break;
+            case 'r': repeats = atoi(optarg); break;
+            case 't': timeout_s = atoi(optarg); break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (repeats <= 0 || timeout_s <= 0 || (!all && optind >= argc)) {
+        usage(argv[0]);
+        return 1;
+    }
+    if (access(SIMULATION_EXE, X_OK) == -1) {
+        fprintf(stderr, "ropeway_bench: %s not found, run from the build directory\n",
+                SIMULATION_EXE);
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (output != NULL && (out = fopen(output, "w")) == NULL) {
+        perror("ropeway_bench: open output");
+        return 1;
+    }
+
+    int failed = 0;
+    int first = 1;
+    fprintf(out, "{\n  \"benchmark\": \"ropeway_bench\",\n");
+    fprintf(out, "  \"cpus\": %ld,\n", sysconf(_SC_NPROCESSORS_ONLN));
+    fprintf(out, "  \"scenarios\": [\n");
+
+    if (all) {
+        char pattern[PATH_MAX_LEN];
+        snprintf(pattern, sizeof(pattern), "%s/test*.conf", config_dir);
+        glob_t g;
+        if (glob(pattern, 0, NULL, &g) == 0) {
+            for (size_t i = 0; i < g.gl_pathc; i++) {
+                char name[NAME_MAX_LEN];
+                scenario_name(g.gl_pathv[i], name, sizeof(name));
+                failed |= bench_scenario(out, config_dir, name, repeats, timeout_s, &first);
+            }
+            globfree(&g);
+        } else {
+            fprintf(stderr, "ropeway_bench: no scenarios match %s\n", pattern);
+            failed = 1;
+        }
+    }
+    for (int i = optind; i < argc; i++) {
+        char name[NAME_MAX_LEN];
+        scenario_name(argv[i], name, sizeof(name));
+        failed |= bench_scenario(out, config_dir, name, repeats, timeout_s, &first);
+    }
+
+    fprintf(out, "\n  ]\n}\n");
+    if (out != stdout) {
+        fclose(out);
+    }
+    return failed;
+}
@@ -0,0 +1,269 @@
+/**
+ * @file bench/shared_state_bench.c
+ * @brief False-sharing benchmark: packed vs cache-line-aligned SharedState.
+ *
+ * Forks writer processes that hammer the hot words tourists update (futex
+ * semaphore values of the gates, station and chairs, the occupancy counters,
+ * the dispatch sequence), each writer on its own word, while reader
+ * processes repeatedly load the flags and config values every tourist
+ * checks. The same loop runs against a replica of the previous packed
+ * layout and against the real SharedState. Usage:
+ * shared_state_bench [writers] [ops_per_writer] [readers]
+ *
+ * False sharing needs several CPUs: with one CPU both layouts time the same.
+ */
+
+#include "constants.h"
+#include "ipc/shared_state.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#define DEFAULT_WRITERS 8
+#define DEFAULT_OPS 2000000
+#define DEFAULT_READERS 2
+#define BENCH_REPEATS 3
+#define HOT_WORDS 8
+#define READ_WORDS 6
+
+// ============================================================================
+// Previous layout (hot words packed between read-mostly fields), the baseline
+// ============================================================================
+
+typedef struct {
+    uint32_t value;
+    uint32_t waiters;
+} PackedFutexSem;
+
+typedef struct {
+    time_t real_start_time;
+    int sim_start_minutes;
+    int sim_end_minutes;
+    double time_acceleration;
+    int chair_travel_time_sim;
+    int64_t current_sim_time_ms;
+    int running;
+    int closing;
+    int emergency_stop;
+    int emergency_waiters;
+    int lower_station_count;
+    int tourists_on_chairs;
+    uint32_t chair_dispatch_seq;
+    int station_capacity;
+    int tourists_to_generate;
+    int tourist_spawn_delay_us;
+    int tourist_pool_size;
+    int tourist_engine;
+    int queue_transport;
+    size_t transport_offset;
+    int sem_backend;
+    int boarding_batch;
+    int chair_fill_deadline_sim;
+    PackedFutexSem futex_sems[SEM_COUNT];
+    int vip_percentage;
+    int walker_percentage;
+    int family_percentage;
+} PackedState;
+
+/**
+ * @brief Words one layout exposes to the benchmark loop.
+ */
+typedef struct {
+    uint32_t *hot[HOT_WORDS];         // Written by writers (one each)
+    const int *read[READ_WORDS];      // Loaded by readers
+} LayoutWords;
+
+/**
+ * @brief Start/stop flags in their own mapping (never shared with the layout).
+ */
+typedef struct {
+    _Alignas(64) int go;
+    _Alignas(64) int writers_done;
+    _Alignas(64) unsigned long long reads[64]; // Per reader, summed after the run
+    int sink;                                  // Keeps the reader loads observable
+} BenchControl;
+
+static void packed_words(PackedState *s, LayoutWords *w) {
+    w->hot[0] = &s->futex_sems[SEM_ENTRY_GATES].value;
+    w->hot[1] = &s->futex_sems[SEM_LOWER_STATION].value;
+    w->hot[2] = &s->futex_sems[SEM_PLATFORM_GATES].value;
+    w->hot[3] = &s->futex_sems[SEM_EXIT_GATES].value;
+    w->hot[4] = &s->futex_sems[SEM_CHAIRS].value;
+    w->hot[5] = (uint32_t *)&s->lower_station_count;
+    w->hot[6] = (uint32_t *)&s->tourists_on_chairs;
+    w->hot[7] = &s->chair_dispatch_seq;
+    w->read[0] = &s->running;
+    w->read[1] = &s->emergency_stop;
+    w->read[2] = &s->station_capacity;
+    w->read[3] = &s->sem_backend;
+    w->read[4] = &s->vip_percentage;
+    w->read[5] = &s->sim_end_minutes;
+}
+
+static void aligned_words(SharedState *s, LayoutWords *w) {
+    LineState *line = &s->lines[0];
+    w->hot[0] = &line->futex_sems[SEM_ENTRY_GATES].value;
+    w->hot[1] = &line->futex_sems[SEM_LOWER_STATION].value;
+    w->hot[2] = &line->futex_sems[SEM_PLATFORM_GATES].value;
+    w->hot[3] = &line->futex_sems[SEM_EXIT_GATES].value;
+    w->hot[4] = &line->futex_sems[SEM_CHAIRS].value;
+    w->hot[5] = (uint32_t *)&line->lower_station_count;
+    w->hot[6] = (uint32_t *)&line->tourists_on_chairs;
+    w->hot[7] = &line->chair_dispatch_seq;
+    w->read[0] = &s->control.running;
+    w->read[1] = &s->control.emergency_stop;
+    w->read[2] = &s->cfg.station_capacity;
+    w->read[3] = &s->cfg.sem_backend;
+    w->read[4] = &s->cfg.vip_percentage;
+    w->read[5] = &s->sim_end_minutes;
+}
+
+/**
+ * @brief Monotonic clock in nanoseconds.
+ */
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief Writer process: acquire/release pairs on one hot word.
+ */
+static void writer_loop(BenchControl *ctl, uint32_t *word, long ops) {
+    while (!__atomic_load_n(&ctl->go, __ATOMIC_ACQUIRE)) {
+        // Spin until every process is forked
+    }
+    for (long n = 0; n < ops; n++) {
+        __atomic_add_fetch(word, 1, __ATOMIC_ACQ_REL);
+        __atomic_sub_fetch(word, 1, __ATOMIC_ACQ_REL);
+    }
+}
+
+/**
+ * @brief Reader process: load the checked flags until the writers finish.
+ */
+static void reader_loop(BenchControl *ctl, const LayoutWords *w, int idx) {
+    unsigned long long reads = 0;
+    int sink = 0;
+    while (!__atomic_load_n(&ctl->go, __ATOMIC_ACQUIRE)) {
+        // Spin until every process is forked
+    }
+    while (!__atomic_load_n(&ctl->writers_done, __ATOMIC_ACQUIRE)) {
+        for (int i = 0; i < READ_WORDS; i++) {
+            sink += __atomic_load_n(w->read[i], __ATOMIC_RELAXED);
+        }
+        reads += READ_WORDS;
+    }
+    ctl->reads[idx] = reads;
+    __atomic_add_fetch(&ctl->sink, sink, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief Run writers and readers against one layout.
+ *
+ * @param w_out Output: nanoseconds per writer acquire/release pair.
+ * @param r_out Output: reader loads per microsecond (all readers).
+ * @return 0 on success, -1 on fork failure.
+ */
+static int run_layout(BenchControl *ctl, const LayoutWords *w, int writers, long ops,
+                      int readers, double *w_out, double *r_out) {
+    memset(ctl, 0, sizeof(*ctl));
+    int forked = 0;
+    for (int i = 0; i < writers + readers; i++) {
+        pid_t pid = fork();
+        if (pid == -1) {
+            perror("shared_state_bench: fork");
+            __atomic_store_n(&ctl->go, 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&ctl->writers_done, 1, __ATOMIC_RELEASE);
+            while (forked-- > 0) wait(NULL);
+            return -1;
+        }
+        if (pid == 0) {
+            if (i < writers) {
+                writer_loop(ctl, w->hot[i % HOT_WORDS], ops);
+            } else {
+                reader_loop(ctl, w, i - writers);
+            }
+            _exit(0);
+        }
+        forked++;
+    }
+
+    double start = now_ns();
+    __atomic_store_n(&ctl->go, 1, __ATOMIC_RELEASE);
+    // Writers are the first children to finish; readers stop on writers_done
+    for (int i = 0; i < writers; i++) {
+        wait(NULL);
+    }
+    double elapsed = now_ns() - start;
+    __atomic_store_n(&ctl->writers_done, 1, __ATOMIC_RELEASE);
+    for (int i = 0; i < readers; i++) {
+        wait(NULL);
+    }
+
+    unsigned long long reads = 0;
+    for (int i = 0; i < readers; i++) {
+        reads += ctl->reads[i];
+    }
+    *w_out = elapsed / (double)ops;
+    *r_out = (double)reads / (elapsed / 1000.0);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int writers = (argc > 1) ? atoi(argv[1]) : DEFAULT_WRITERS;
+    long ops = (argc > 2) ? atol(argv[2]) : DEFAULT_OPS;
+    int readers = (argc > 3) ? atoi(argv[3]) : DEFAULT_READERS;
+    if (writers <= 0 || ops <= 0 || readers < 0 || readers > 64) {
+        fprintf(stderr, "Usage: %s [writers] [ops_per_writer] [readers (0-64)]\n", argv[0]);
+        return 1;
+    }
+
+    size_t state_size = sizeof(SharedState) > sizeof(PackedState) ? sizeof(SharedState)
+                                                                  : sizeof(PackedState);
+    void *state = mmap(NULL, state_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    BenchControl *ctl = mmap(NULL, sizeof(BenchControl), PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (state == MAP_FAILED || ctl == MAP_FAILED) {
+        perror("shared_state_bench: mmap");
+        return 1;
+    }
+
+    LayoutWords packed;
+    LayoutWords aligned;
+    packed_words(state, &packed);
+    aligned_words(state, &aligned);
+
+    double best_packed_w = 0.0, best_packed_r = 0.0;
+    double best_aligned_w = 0.0, best_aligned_r = 0.0;
+    for (int r = 0; r < BENCH_REPEATS; r++) {
+        double w_ns, r_rate;
+        memset(state, 0, state_size);
+        if (run_layout(ctl, &packed, writers, ops, readers, &w_ns, &r_rate) == -1) return 1;
+        if (r == 0 || w_ns < best_packed_w) best_packed_w = w_ns;
+        if (r_rate > best_packed_r) best_packed_r = r_rate;
+
+        memset(state, 0, state_size);
+        if (run_layout(ctl, &aligned, writers, ops, readers, &w_ns, &r_rate) == -1) return 1;
+        if (r == 0 || w_ns < best_aligned_w) best_aligned_w = w_ns;
+        if (r_rate > best_aligned_r) best_aligned_r = r_rate;
+    }
+
+    printf("SharedState layout: %d writers x %ld ops, %d readers, %ld CPUs (best of %d)\n",
+           writers, ops, readers, sysconf(_SC_NPROCESSORS_ONLN), BENCH_REPEATS);
+    printf("  packed (previous):  %8.1f ns/op (writers)  %10.1f loads/us (readers)\n",
+           best_packed_w, best_packed_r);
+    printf("  aligned regions:    %8.1f ns/op (writers)  %10.1f loads/us (readers)\n",
+           best_aligned_w, best_aligned_r);
+    printf("  writer speedup: %.2fx\n", best_packed_w / best_aligned_w);
+
+    munmap(state, state_size);
+    munmap(ctl, sizeof(BenchControl));
+    return 0;
+}
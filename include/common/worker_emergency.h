@@ -17,10 +17,23 @@ typedef struct {
     double *start_time_sim;      // Pointer to worker's g_emergency_start_time_sim
 } WorkerEmergencyState;
 
+/**
+ * Logging tag of a worker on res's line.
+ * "LOWER_WORKER"/"UPPER_WORKER" on line 0, "LOWER_WORKER_<line>" and
+ * "UPPER_WORKER_<line>" on the others.
+ *
+ * @param res IPC resources (selected line)
+ * @param role Worker role (WORKER_LOWER or WORKER_UPPER)
+ * @return Tag string (valid for the life of the process)
+ */
+const char *worker_log_tag(const IPCResources *res, WorkerRole role);
+
 /**
  * Trigger an emergency stop.
  * Called when THIS worker detects danger.
  * Sets emergency flag, sends SIGUSR1 to other worker, records start time.
+ * With EMERGENCY_BACKEND=1 the emergency epoch CAS replaces the lock and
+ * the signal: the other worker notices the stop on its next loop pass.
  *
  * @param res IPC resources
  * @param role This worker's role (WORKER_LOWER or WORKER_UPPER)
@@ -32,6 +45,8 @@ void worker_trigger_emergency_stop(IPCResources *res, WorkerRole role, WorkerEme
  * Acknowledge an emergency stop from the other worker.
  * Called when receiving SIGUSR1 signal.
  * Blocks until detecting worker initiates resume via message queue.
+ * With EMERGENCY_BACKEND=1 it sleeps on the line's emergency epoch instead
+ * (returns at once if the line is not stopped).
  *
  * @param res IPC resources
  * @param role This worker's role (WORKER_LOWER or WORKER_UPPER)
@@ -43,6 +58,7 @@ void worker_acknowledge_emergency_stop(IPCResources *res, WorkerRole role, Worke
  * Initiate resume after cooldown period.
  * Called by detecting worker after cooldown to wake up the receiving worker.
  * Uses message queue handshake for synchronization.
+ * With EMERGENCY_BACKEND=1: one epoch increment and one futex wake, no handshake.
  *
  * @param res IPC resources
  * @param role This worker's role (WORKER_LOWER or WORKER_UPPER)
@@ -20,12 +20,120 @@
 #define EXIT_GATES 2              // Number of exit gates at upper station
 #define PLATFORM_GATES 3          // Number of platform gates (before boarding)
 #define MAX_KIDS_PER_ADULT 2      // Maximum kids per guardian
+#define MAX_LINES 8               // Upper bound on LINE_COUNT (independent chairlift lines)
+#define MAX_BOARDING_WORKERS 8    // Upper bound on BOARDING_WORKERS (per line)
+#define MAX_BOARDING_WINDOW 16    // Upper bound on BOARDING_WINDOW (look-ahead requests)
+#define MAX_CASHIERS 8            // Upper bound on CASHIER_COUNT (ticket office shards)
+#define MAX_CASHIER_BATCH 32      // Upper bound on CASHIER_BATCH (requests per wakeup)
+#define MAX_WORKER_CPUS 64        // Upper bound on WORKER_CPUS (cores reserved for fixed workers)
+
+// Stack size for tourist threads in the thread engine (TOURIST_ENGINE=1)
+#define TOURIST_THREAD_STACK_SIZE (256 * 1024)
+
+// Fiber engine (TOURIST_ENGINE=3)
+#define MAX_FIBER_THREADS 16      // Upper bound on FIBER_THREADS (scheduler threads of the fiber host)
+#define FIBER_STACK_SIZE (64 * 1024) // Stack per tourist fiber (pages committed as they are touched)
+#define FIBER_STACK_SLAB 32       // Fiber stacks per mmap (one mapping per slab, not per fiber)
+#define FIBER_RING_ENTRIES 256    // io_uring submission queue entries per scheduler thread
+#define FIBER_CQ_ENTRIES 16384    // io_uring completion queue entries per scheduler thread
+#define FIBER_POLL_NS 1000000     // Retry step for System V waits and the spawn queue (1ms)
+#define FIBER_SPAWN_BATCH 256     // Spawn descriptors a scheduler thread takes per pass
+
+// Sharded statistics: one cache-line slot per claiming thread/process
+// (slot 0 is the shared overflow slot updated with atomic adds)
+#define STATS_SHARD_COUNT 1024
+
+// Configuration block at the start of the segment (SharedState.cfg)
+#define CONFIG_BLOCK_SIZE 4096    // One base page, sealed read-only in child processes
+
+// Shared-memory ring transport (QUEUE_TRANSPORT=1)
+#define SHM_RING_CAPACITY 1024    // Slots per ring (power of two)
+#define SHM_RING_PAYLOAD 56       // Bytes per slot payload (fits PlatformMsg/ArrivalMsg)
+#define SHM_WAIT_TIMEOUT_MS 100   // Futex wait slice before re-checking running flag
+#define CONTROL_WRITE_SPINS 10000 // Yields before a stuck control block writer is overridden
+#define TIME_PAUSE_POLL_NS 10000000 // Deadline sleep step while the clock epoch is frozen (10ms)
+#define CHAIR_COMMIT_SPINS 10000  // Yields before a chair leaves without a claimed-but-unwritten rider
+
+// Asynchronous logging (LOG_ASYNC > 0)
+#define LOG_RING_CAPACITY 4096    // Records in the shm log ring (power of two)
+#define LOG_RECORD_TEXT 200       // Message bytes per record (longer messages are truncated)
+#define LOG_DRAIN_BUFFER 65536    // Bytes the drainer batches into one write()
+#define LOG_STALL_MS 1000         // Claimed-but-unpublished head slot is skipped after this
+
+// Binary event trace (EVENT_TRACE=1)
+#define TRACE_MAX_RECORDS (1u << 22)        // Record slots in the (sparse) trace file
+#define TRACE_FILE_NAME "event_trace.bin"   // Written to the working directory
+#define TRACE_PATH_MAX 256                  // SharedState.trace_path size
+
+// Precomputed arrival schedule (ARRIVAL_SCHEDULE > 0)
+#define ARRIVAL_SCHEDULE_FILE_NAME "arrival_schedule.bin" // Saved by mode 1, loaded by mode 2 (working directory)
+
+// Recorded danger events (DANGER_SCHEDULE > 0)
+#define DANGER_SCHEDULE_FILE_NAME "danger_schedule.bin" // Saved by mode 1, loaded by mode 2 (working directory)
+#define DANGER_SCHEDULE_MAX 256             // Danger events one run records or replays
+
+// Open-loop Poisson arrivals (ARRIVAL_RATE / ARRIVAL_RATE_HH)
+#define ARRIVAL_RATE_HOURS 24     // Rate profile entries, one per simulated hour of the day
+#define ARRIVAL_LATE_NS 1000000   // Spawn this far past its arrival time counts as late (1ms)
+
+// Headless max-speed mode (MAX_SPEED=1, virtual clock, see core/time_sim.h)
+#define VCLOCK_TIMER_SLOTS 64           // Virtual alarm/hold slots (one per worker or event host)
+#define VCLOCK_IDLE_STEP_NS 10000000    // Clock step when nobody waits on a deadline (10ms, like the tick)
+#define VCLOCK_SETTLE_NS 20000          // Time Server sleep before each quiescence check (20us)
+#define VCLOCK_STALL_MS 1000            // Real time with a participant not waiting before a forced advance
+
+// Parameter sweep (--sweep KEY=v1,v2,...: runs share one set of IPC resources)
+#define SWEEP_MAX_AXES 4                // --sweep options per invocation (cartesian product)
+#define SWEEP_MAX_VALUES 16             // Values per swept key
+#define SWEEP_VALUE_MAX 16              // Bytes per value text
+#define SWEEP_MAX_RUNS 256              // Runs per sweep (product of the value counts)
+#define SWEEP_DRAIN_MS 3000             // Wait for a run's processes to exit before SIGKILL
+#define SWEEP_REPORT_FILE_NAME "sweep_report.txt" // Aggregated results (working directory)
+
+// Checkpoints (CHECKPOINT_INTERVAL_SIM_MINUTES > 0, restored with --restore)
+#define CHECKPOINT_FILE_NAME "simulation_checkpoint.bin"  // Replaced atomically (working directory)
+#define CHECKPOINT_TMP_SUFFIX ".tmp"    // Written here first, then renamed over the file
+#define MAIN_VCLOCK_POLL_MS 10          // Main's checkpoint poll under MAX_SPEED=1
+
+// Report
+#define REPORT_CSV_FILE_NAME "simulation_report.csv" // Per-tourist CSV (REPORT_FORMAT=1)
+#define REPORT_THREADS 4          // Max threads formatting per-tourist report rows
+#define REPORT_BLOCK_ROWS 65536   // Tourist slots formatted per block (per thread per round)
+#define REPORT_ROW_MAX 64         // Upper bound on one formatted row in bytes
+#define REPORT_SPOOL_FILE_NAME "simulation_report.rows" // Rows appended by the report writer (REPORT_INCREMENTAL=1)
+#define REPORT_SPOOL_BUFFER 65536 // Bytes the report writer batches into one write()
+#define COMPLETION_RING_CAPACITY 4096 // Completed-tourist records in the shm ring (power of two)
+#define COMPLETION_STALL_MS 1000  // Claimed-but-unpublished completion slot is skipped after this
+
+// Live metrics exporter (METRICS_INTERVAL_MS > 0)
+#define METRICS_FILE_NAME "ropeway_metrics.prom"  // Prometheus text file in the working directory
+#define METRICS_SNAPSHOT_RETRIES 4                // Re-reads until two passes agree
+
+// Remote gateway (REMOTE_PORT > 0, protocol in ipc/remote.h)
+#define REMOTE_MAX_HOSTS 16       // Remote hosts connected at once
+#define REMOTE_POLL_MS 100        // Gateway and generator check the run flags this often
+#define REMOTE_TOKEN_LEN 64       // REMOTE_TOKEN bytes, NUL-padded (at most 63 characters)
+#define REMOTE_HELLO_TIMEOUT_MS 2000 // A connection without a HELLO by then is closed
+
+// Process profile (report "CPU Usage per Process" section, PERF_COUNTERS=1 for hardware counters)
+#define PROFILE_MAX_PROCESSES (STARTUP_MAX_WORKERS + 8) // Fixed workers, helpers, generator, main
+
+// Startup preflight (PREFLIGHT > 0): needs of the run against kernel limits, before any fork
+#define PREFLIGHT_SEMVMX 32767    // Largest System V semaphore value (compile-time SEMVMX, not a sysctl)
+#define PREFLIGHT_PROCESS_KB 2048 // Resident memory assumed per process (workers and tourists measure 1.5-2 MB)
+#define PREFLIGHT_TASK_MARGIN 16  // Tasks kept free for helper threads, report threads and checkpoint writers
+#define PREFLIGHT_FD_MIN 64       // Descriptors any process needs (the gateway adds REMOTE_MAX_HOSTS)
+
+// Wait-latency histograms (log-linear buckets of real microseconds)
+#define LAT_SUB_BUCKET_BITS 4     // 16 linear sub-buckets per power of two (~6% resolution)
+#define LAT_MAX_EXPONENT 32       // Waits of 2^32 us (~71 minutes) and longer share the top bucket
+#define LAT_BUCKET_COUNT ((1 << LAT_SUB_BUCKET_BITS) * (LAT_MAX_EXPONENT - LAT_SUB_BUCKET_BITS + 1))
 
 // ============================================================================
 // Semaphore Indices
 // ============================================================================
 
-#define SEM_STATE 0           // Mutex for SharedState access
+#define SEM_STATE 0           // Mutex for emergency waiter registration
 #define SEM_STATS 1           // Mutex for statistics access
 #define SEM_ENTRY_GATES 2     // Entry gates capacity (4)
 #define SEM_EXIT_GATES 3      // Exit gates capacity (2)
@@ -37,9 +145,25 @@
 #define SEM_EMERGENCY_LOCK 9  // Mutex for emergency initiator determination
 #define SEM_COUNT 10          // Total number of semaphores
 
-// Number of workers that must signal ready before generator starts
-// (TimeServer, Cashier, LowerWorker, UpperWorker)
+// Semaphores served from SharedState.futex_sems when SEM_BACKEND=1. Worker
+// barrier, chairs and emergency semaphores always stay on the SysV set.
+#define SEM_FUTEX_MASK ((1u << SEM_STATE) | (1u << SEM_STATS) | \
+                        (1u << SEM_ENTRY_GATES) | (1u << SEM_EXIT_GATES) | \
+                        (1u << SEM_LOWER_STATION) | (1u << SEM_PLATFORM_GATES))
+
+// Number of workers that must signal ready on line 0's set before generator
+// starts (TimeServer, Cashier, LowerWorker, UpperWorker); every further line
+// adds its own worker pair on that line's set, and every line its
+// BOARDING_WORKERS - 1 extra boarding workers; line 0 also counts the
+// CASHIER_COUNT - 1 extra cashiers
 #define WORKER_COUNT_FOR_BARRIER 4
+#define WORKER_COUNT_PER_LINE 2
+
+// Ready barrier: main shuts the run down if the workers are not all ready by then
+#define WORKER_READY_TIMEOUT_MS 10000
+// Workers that pass the ready barrier: time server, cashiers, every line's
+// lower, upper and extra boarding workers (StartupTiming.ready slots)
+#define STARTUP_MAX_WORKERS (1 + MAX_CASHIERS + MAX_LINES * (1 + MAX_BOARDING_WORKERS))
 
 // ============================================================================
 // Message Queue IDs (for ftok project_id)
@@ -50,6 +174,20 @@
 #define MQ_BOARDING_ID 3      // Lower Worker -> Tourist (boarding confirmation)
 #define MQ_ARRIVALS_ID 4      // Tourist -> Upper Worker (arrival notification)
 #define MQ_WORKER_ID 5        // Worker <-> Worker emergency communication
+#define MQ_SPAWN_ID 6         // Generator -> Tourist pool (spawn descriptors)
+
+// ftok project IDs of lines 1..MAX_LINES-1: LINE_KEY_BASE | line << 3 | kind
+// (line 0 keeps the letters in ipc/keys.c; all of these are >= 0x88)
+#define LINE_KEY_BASE 0x80
+#define LINE_KEY_SEM 0
+#define LINE_KEY_PLATFORM 1
+#define LINE_KEY_BOARDING 2
+#define LINE_KEY_ARRIVALS 3
+#define LINE_KEY_WORKER 4
+
+// ftok project IDs of cashier queues 1..MAX_CASHIERS-1: CASHIER_KEY_BASE | cashier
+// (cashier 0 keeps 'C'; above every line key)
+#define CASHIER_KEY_BASE 0xc0
 
 // ============================================================================
 // Worker Message Constants
@@ -107,6 +245,107 @@ typedef enum {
     STAGE_LEAVING = 9                   // Terminal: leaving (ticket invalid, station closing, or done)
 } TouristStage;
 
+// Blocking points measured by the wait-latency histograms
+typedef enum {
+    LAT_ENTRY_GATES = 0,                // SEM_ENTRY_GATES (non-VIP tourists)
+    LAT_LOWER_STATION = 1,              // SEM_LOWER_STATION
+    LAT_PLATFORM_GATES = 2,             // SEM_PLATFORM_GATES
+    LAT_BOARDING = 3,                   // Platform message sent -> boarding confirmation received
+    LAT_EXIT_GATES = 4,                 // SEM_EXIT_GATES
+    LAT_STAGE_COUNT = 5
+} LatencyStage;
+
+// Message queues watched for backpressure (QueueStats)
+typedef enum {
+    QUEUE_CASHIER = 0,                  // Ticket requests and replies, one queue per cashier
+    QUEUE_PLATFORM = 1,                 // Tourists waiting for the lower worker (per line)
+    QUEUE_BOARDING = 2,                 // Boarding confirmations (per line)
+    QUEUE_ARRIVALS = 3,                 // Arrivals for the upper worker (per line)
+    QUEUE_WORKER = 4,                   // Emergency stop handshake (per line)
+    QUEUE_SPAWN = 5,                    // Tourist descriptors for pool, host and engine processes
+    QUEUE_KIND_COUNT = 6
+} QueueKind;
+
+// Tourist execution engine (TOURIST_ENGINE config value)
+typedef enum {
+    TOURIST_ENGINE_PROCESS = 0,         // One process per tourist (exec or pool)
+    TOURIST_ENGINE_THREAD = 1,          // One thread per tourist inside host processes
+    TOURIST_ENGINE_EVENT = 2,           // Discrete-event state records in one event host
+    TOURIST_ENGINE_FIBER = 3            // One ucontext fiber per tourist on FIBER_THREADS threads
+} TouristEngine;
+
+// Platform/boarding/arrivals transport (QUEUE_TRANSPORT config value)
+typedef enum {
+    QUEUE_TRANSPORT_SYSV = 0,           // System V message queues
+    QUEUE_TRANSPORT_SHM = 1             // Lock-free rings and mailboxes in shared memory
+} QueueTransport;
+
+// Simulated clock source (CLOCK_SOURCE)
+typedef enum {
+    CLOCK_SOURCE_TICK = 0,              // Time Server publishes the sim time every 10ms (setitimer)
+    CLOCK_SOURCE_EPOCH = 1              // Time Server publishes an epoch, readers compute the time
+} ClockSource;
+
+// Semaphore backend for the futex-capable indices (SEM_BACKEND)
+typedef enum {
+    SEM_BACKEND_SYSV = 0,               // semop() on the System V set
+    SEM_BACKEND_FUTEX = 1               // Atomic fast path + futex in SharedState
+} SemBackend;
+
+// Emergency stop coordination (EMERGENCY_BACKEND)
+typedef enum {
+    EMERGENCY_BACKEND_SIGNALS = 0,      // SIGUSR1/SIGUSR2, MQ_WORKER handshake, SEM_EMERGENCY_CLEAR
+    EMERGENCY_BACKEND_FUTEX = 1         // LineState.emergency_epoch: one store + one futex wake
+} EmergencyBackend;
+
+// Shared memory pages (SHM_HUGE_PAGES)
+typedef enum {
+    SHM_PAGES_NORMAL = 0,               // Base pages
+    SHM_PAGES_HUGETLB = 1,              // shmget(SHM_HUGETLB) from the reserved pool, base pages if none
+    SHM_PAGES_TRANSPARENT = 2           // Base-page segment, madvise(MADV_HUGEPAGE) in every attacher
+} ShmPages;
+
+// Virtual clock timer slot use (MAX_SPEED=1, VirtualTimer.kind)
+typedef enum {
+    VTIMER_NONE = 0,                    // Slot owned but idle
+    VTIMER_ALARM = 1,                   // Time Server sends SIGALRM at the deadline, then clears it
+    VTIMER_HOLD = 2                     // Clock may reach the deadline but not pass it until renewed
+} VirtualTimerKind;
+
+// Logging mode (LOG_ASYNC)
+typedef enum {
+    LOG_ASYNC_OFF = 0,                  // log_msg() writes to stderr itself
+    LOG_ASYNC_BLOCK = 1,                // Records to the shm ring; wait while it is full
+    LOG_ASYNC_DROP = 2                  // Records to the shm ring; drop (and count) when full
+} LogAsyncMode;
+
+// Startup preflight (PREFLIGHT)
+typedef enum {
+    PREFLIGHT_OFF = 0,                  // No checks; limits are hit when a call fails
+    PREFLIGHT_ADAPT = 1,                // Change queue length, transport or pool size to fit, else fail
+    PREFLIGHT_CHECK = 2                 // Fail wherever PREFLIGHT_ADAPT would change the configuration
+} PreflightMode;
+
+// Report output (REPORT_FORMAT)
+typedef enum {
+    REPORT_FORMAT_TEXT = 0,             // simulation_report.txt only
+    REPORT_FORMAT_CSV = 1               // Also per-tourist rows in REPORT_CSV_FILE_NAME
+} ReportFormat;
+
+// Tourist descriptor source (ARRIVAL_SCHEDULE)
+typedef enum {
+    ARRIVAL_SCHEDULE_OFF = 0,           // Generator draws each tourist as it spawns it
+    ARRIVAL_SCHEDULE_GENERATE = 1,      // Whole schedule drawn at startup, saved to ARRIVAL_SCHEDULE_FILE_NAME
+    ARRIVAL_SCHEDULE_REPLAY = 2         // Schedule loaded from ARRIVAL_SCHEDULE_FILE_NAME
+} ArrivalScheduleMode;
+
+// Danger detection source (DANGER_SCHEDULE)
+typedef enum {
+    DANGER_SCHEDULE_OFF = 0,            // Workers draw against DANGER_PROBABILITY
+    DANGER_SCHEDULE_RECORD = 1,         // Draws as in 0, triggers saved to DANGER_SCHEDULE_FILE_NAME
+    DANGER_SCHEDULE_REPLAY = 2          // Triggers taken from DANGER_SCHEDULE_FILE_NAME, no draws
+} DangerScheduleMode;
+
 // Cashier message queue mtype values
 typedef enum {
     MSG_CASHIER_REQUEST = 1,            // All tourists send requests with this mtype
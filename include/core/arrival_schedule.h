@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file core/arrival_schedule.h
+ * @brief Precomputed tourist descriptors in shared memory (ARRIVAL_SCHEDULE > 0).
+ *
+ * With ARRIVAL_SCHEDULE=1 the generator draws every tourist and its spawn
+ * time once at startup into a compact descriptor array at the end of the
+ * segment, and saves it to ARRIVAL_SCHEDULE_FILE_NAME. With
+ * ARRIVAL_SCHEDULE=2 main loads that file instead, so a run replays the
+ * exact same arrivals. The generator then only paces spawns: a tourist
+ * process is exec'd with its ID alone and a pool member, thread host or the
+ * event host receives a descriptor carrying only the ID. Each one reads its
+ * attributes from the schedule (tourist_init_scheduled) instead of argv or
+ * the message.
+ */
+
+#include "ipc/shared_state.h"
+#include "core/config.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define ARRIVAL_SCHEDULE_MAGIC "RWSCHED1"
+#define ARRIVAL_SCHEDULE_VERSION 1
+
+/**
+ * @brief One scheduled tourist (16 bytes).
+ */
+typedef struct {
+    int32_t id;                         // Tourist ID (index + 1)
+    uint8_t age;
+    uint8_t type;                       // TouristType
+    uint8_t vip;
+    uint8_t kid_count;
+    uint8_t ticket;                     // TicketType
+    uint8_t reserved[3];
+    uint32_t spawn_us;                  // Spawn time, pause-adjusted us since the start (time_elapsed_ns)
+} TouristDescriptor;
+
+/**
+ * @brief Schedule block in shared memory.
+ */
+typedef struct {
+    _Alignas(64) uint32_t count;        // Descriptors in use
+    uint32_t capacity;                  // Descriptors the block holds (TOTAL_TOURISTS)
+    uint32_t ready;                     // 1 once every descriptor is written (release)
+    uint32_t reserved;
+    TouristDescriptor tourists[];
+} ArrivalSchedule;
+
+/**
+ * @brief Header of ARRIVAL_SCHEDULE_FILE_NAME (followed by count descriptors).
+ */
+typedef struct {
+    char magic[8];                      // ARRIVAL_SCHEDULE_MAGIC, not NUL-terminated
+    uint32_t version;                   // ARRIVAL_SCHEDULE_VERSION
+    uint32_t record_size;               // sizeof(TouristDescriptor)
+    uint32_t count;                     // Descriptors in the file
+    uint32_t reserved;
+} ArrivalScheduleFileHeader;
+
+/**
+ * @brief Extra shm bytes needed by the schedule (0 when ARRIVAL_SCHEDULE=0).
+ *
+ * @param cfg Configuration.
+ * @param base_size Bytes already used in the segment.
+ * @return Bytes to add to the segment so the schedule fits aligned.
+ */
+size_t arrival_schedule_shm_size(const Config *cfg, size_t base_size);
+
+/**
+ * @brief Record the schedule offset and, with ARRIVAL_SCHEDULE=2, load the file.
+ *
+ * Main, after ipc_shm_init_state. A replayed file with fewer tourists than
+ * TOTAL_TOURISTS lowers tourists_to_generate; a longer one is cut.
+ *
+ * @param state Freshly zeroed shared state.
+ * @param cfg Configuration.
+ * @param base_size Bytes already used in the segment.
+ * @return 0 on success, -1 if the file cannot be loaded.
+ */
+int arrival_schedule_init(SharedState *state, const Config *cfg, size_t base_size);
+
+/**
+ * @brief Locate the schedule in this process's mapping.
+ *
+ * @param state Shared state.
+ * @return Schedule, or NULL when ARRIVAL_SCHEDULE=0.
+ */
+ArrivalSchedule *arrival_schedule_get(SharedState *state);
+
+/**
+ * @brief Descriptor of one tourist.
+ *
+ * @param state Shared state.
+ * @param id Tourist ID.
+ * @return Descriptor, or NULL if there is no schedule, it is not ready or id is out of range.
+ */
+const TouristDescriptor *arrival_schedule_lookup(SharedState *state, int id);
+
+/**
+ * @brief Mark the schedule complete (generator, after writing every descriptor).
+ *
+ * @param schedule Schedule.
+ * @param count Descriptors written.
+ */
+void arrival_schedule_publish(ArrivalSchedule *schedule, uint32_t count);
+
+/**
+ * @brief Write the schedule to a file for a later ARRIVAL_SCHEDULE=2 run.
+ *
+ * @param schedule Published schedule.
+ * @param path Output path.
+ * @return 0 on success, -1 on error.
+ */
+int arrival_schedule_save(const ArrivalSchedule *schedule, const char *path);
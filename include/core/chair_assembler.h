@@ -0,0 +1,91 @@
+#pragma once
+
+/**
+ * @file core/chair_assembler.h
+ * @brief Lock-free chair under construction shared by a line's boarding workers.
+ *
+ * With BOARDING_WORKERS > 1 every boarding worker pops platform requests
+ * and claims seats on the same ChairAssembler. A claim is one CAS on the
+ * packed state word that adds the group's slots, so two workers can never
+ * overfill a chair. The claim that fills the chair, or the first one that
+ * does not fit, also sets the closed bit and makes its caller the chair's
+ * only dispatcher: it takes the riders, opens the next chair (new epoch)
+ * and then lets the chair depart. A group that did not fit boards the next
+ * chair directly instead of being requeued. Workers that find the chair
+ * closed sleep on the epoch futex until it reopens.
+ */
+
+#include "ipc/shared_state.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Outcome of chair_assembler_claim().
+ */
+typedef enum {
+    CHAIR_CLAIM_BOARDED = 0,            // Boarded, chair still open
+    CHAIR_CLAIM_FILLED = 1,             // Boarded and filled the chair: caller dispatches it
+    CHAIR_CLAIM_NO_FIT = 2,             // Did not fit: caller closed the partial chair, dispatches it, retries
+    CHAIR_CLAIM_BUSY = 3                // Chair closed by another worker: wait for the epoch, retry
+} ChairClaimResult;
+
+/**
+ * @brief Where a claim landed.
+ */
+typedef struct {
+    int chair_id;                       // Chair the group boarded (BOARDED/FILLED)
+    int slots_used;                     // Slots taken on that chair after the claim
+    uint32_t epoch;                     // Epoch observed (for chair_assembler_wait)
+} ChairClaim;
+
+/**
+ * @brief Claim seats for one group on the open chair.
+ *
+ * @param a Line's assembler.
+ * @param tourist_id Group leader's tourist ID.
+ * @param slots Slots the group needs (1..CHAIR_CAPACITY).
+ * @param out Output: chair, slots used and epoch.
+ * @return ChairClaimResult.
+ */
+ChairClaimResult chair_assembler_claim(ChairAssembler *a, int tourist_id, int slots,
+                                       ChairClaim *out);
+
+/**
+ * @brief Close a partially filled chair so it can leave (poll/timeout path).
+ *
+ * @param a Line's assembler.
+ * @return 1 if the caller closed a non-empty chair and must dispatch it, 0 otherwise.
+ */
+int chair_assembler_close(ChairAssembler *a);
+
+/**
+ * @brief Collect the riders of the chair the caller closed.
+ *
+ * Waits (yielding, up to CHAIR_COMMIT_SPINS times) for every claimed group
+ * to write its member ID; a group whose claimer died before writing it is
+ * left out.
+ *
+ * @param a Line's assembler (closed by the caller).
+ * @param chair_id_out Output: chair ID.
+ * @param members_out Output: CHAIR_CAPACITY tourist IDs.
+ * @param slots_out Output: slots used.
+ * @return Riders (groups) collected.
+ */
+int chair_assembler_take(ChairAssembler *a, int *chair_id_out, int *members_out, int *slots_out);
+
+/**
+ * @brief Open the next chair (closer only, after chair_assembler_take).
+ *
+ * @param a Line's assembler.
+ * @param chair_id Next chair ID (see chair_tracker_next_id).
+ */
+void chair_assembler_open(ChairAssembler *a, int chair_id);
+
+/**
+ * @brief Sleep until the chair observed closed at epoch reopens.
+ *
+ * @param a Line's assembler.
+ * @param epoch Epoch from the CHAIR_CLAIM_BUSY claim.
+ * @param timeout_ms Maximum wait in milliseconds.
+ */
+void chair_assembler_wait(ChairAssembler *a, uint32_t epoch, int timeout_ms);
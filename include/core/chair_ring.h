@@ -0,0 +1,57 @@
+#pragma once
+
+/**
+ * @file core/chair_ring.h
+ * @brief Circulating chair ring for cadence departures (CHAIR_INTERVAL_SIM_SECONDS > 0).
+ *
+ * The TOTAL_CHAIRS chairs sit on a rope loop that moves one position every
+ * interval: the chair at the lower platform leaves then, full or not, and
+ * the next one takes its place. Position p (the p-th departure) is ring slot
+ * p % TOTAL_CHAIRS, which is (sim time / interval) % TOTAL_CHAIRS until the
+ * first emergency stop freezes the rope. A chair reaches the top
+ * chair_ring_transit() departures after it left, so seats on the way up are
+ * a running sum kept in O(1) per departure with no SEM_CHAIRS traffic. Only
+ * the lower worker writes the ring; anyone may read the counters.
+ */
+
+#include "ipc/shared_state.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Departures a chair spends going up (ride time over the interval, rounded up).
+ *
+ * @param cfg Configuration (CHAIR_TRAVEL_TIME_SIM_MINUTES, CHAIR_INTERVAL_SIM_SECONDS > 0).
+ * @return Positions between the lower and the upper platform (1..MAX_CHAIRS_IN_TRANSIT).
+ */
+int chair_ring_transit(const Config *cfg);
+
+/**
+ * @brief Chair ID waiting at the lower platform (the next to leave).
+ *
+ * @param line Line state.
+ * @return Chair ID 1..TOTAL_CHAIRS.
+ */
+int chair_ring_platform_chair(const LineState *line);
+
+/**
+ * @brief Move the rope one position: the platform chair leaves with its riders.
+ *
+ * Records the trip in its slot, adds its seats to ring_slots_up and takes
+ * off the seats of the chair reaching the top in the same step.
+ *
+ * @param line Line state (lower worker only).
+ * @param transit chair_ring_transit() of the run.
+ * @param slots Seats taken on the departing chair (0 = empty chair).
+ * @param riders Groups on it.
+ * @return Chair ID that left (1..TOTAL_CHAIRS).
+ */
+int chair_ring_depart(LineState *line, int transit, int slots, int riders);
+
+/**
+ * @brief Seats taken on chairs between the platforms.
+ *
+ * @param line Line state.
+ * @return Occupied seats going up.
+ */
+uint32_t chair_ring_slots_up(const LineState *line);
@@ -0,0 +1,54 @@
+#pragma once
+
+/**
+ * @file core/chair_tracker.h
+ * @brief O(1) tracking of chairs in transit for SEM_CHAIRS release.
+ *
+ * The table has one ChairTrack per chair ID (TOTAL_CHAIRS entries in
+ * SharedState). The lower worker registers the expected rider count when a
+ * chair departs and hands out a dispatch sequence number; riders carry
+ * (chair_id, dispatch_seq) to the upper worker, which finds the entry by
+ * indexing and checks the sequence, so a late rider from an earlier trip of
+ * the same chair ID can never be counted against the current one.
+ */
+
+#include "ipc/shared_state.h"
+
+/**
+ * @brief Register a departing chair (lower worker, before confirming boarding).
+ *
+ * @param tracks Chair table (TOTAL_CHAIRS entries).
+ * @param seq_counter Dispatch sequence counter (incremented atomically).
+ * @param chair_id Chair ID 1..TOTAL_CHAIRS.
+ * @param expected Riders (groups) on the chair.
+ * @return Dispatch sequence for this trip (never 0), or 0 if chair_id is out of range.
+ */
+uint32_t chair_tracker_register(ChairTrack *tracks, uint32_t *seq_counter,
+                                int chair_id, int expected);
+
+/**
+ * @brief Count one rider arriving at the upper platform (upper worker).
+ *
+ * @param tracks Chair table (TOTAL_CHAIRS entries).
+ * @param chair_id Chair ID from the arrival message.
+ * @param seq Dispatch sequence from the arrival message.
+ * @param arrived_out Output: riders arrived so far (may be NULL).
+ * @param expected_out Output: riders expected (may be NULL).
+ * @return 1 if this was the last rider (chair free again), 0 if more are
+ *         expected, -1 if the chair is unknown or seq does not match.
+ */
+int chair_tracker_arrive(ChairTrack *tracks, int chair_id, uint32_t seq,
+                         int *arrived_out, int *expected_out);
+
+/**
+ * @brief Pick the next chair ID to load after chair_id.
+ *
+ * Skips IDs whose chair is still in transit so a registered trip is never
+ * overwritten. With MAX_CHAIRS_IN_TRANSIT < TOTAL_CHAIRS a free ID always
+ * exists; if none does, the plain successor is returned.
+ *
+ * @param tracks Chair table (TOTAL_CHAIRS entries).
+ * @param chair_id Current chair ID 1..TOTAL_CHAIRS.
+ * @return Next chair ID 1..TOTAL_CHAIRS.
+ */
+int chair_tracker_next_id(const ChairTrack *tracks, int chair_id);
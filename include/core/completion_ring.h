@@ -0,0 +1,118 @@
+#pragma once
+
+/**
+ * @file core/completion_ring.h
+ * @brief Shared-memory ring of finished tourists drained by the report writer (REPORT_INCREMENTAL=1).
+ *
+ * With REPORT_INCREMENTAL=1 there is no per-tourist table in shared memory:
+ * each tourist keeps its TouristEntry privately and pushes it here once,
+ * when it leaves. The report writer process appends every record to the
+ * report spool file and frees the slot, so the segment holds
+ * COMPLETION_RING_CAPACITY records whatever TOTAL_TOURISTS is. Producers
+ * claim a slot with one CAS (same handshake as the log ring) and wait for
+ * space when the ring is full; records are only dropped once the writer is
+ * gone.
+ */
+
+#include "ipc/shared_state.h"
+#include "core/config.h"
+
+#include <stddef.h>
+
+/**
+ * @brief One finished tourist.
+ */
+typedef struct {
+    uint64_t seq;                       // Slot sequence (publish/consume handshake)
+    int32_t id;                         // Tourist ID
+    uint32_t reserved;
+    TouristEntry entry;                 // Final entry, total_rides included
+} CompletionRecord;
+
+/**
+ * @brief Bounded multi-producer, single-consumer completion ring.
+ */
+typedef struct {
+    _Alignas(64) uint64_t tail;         // Next slot to claim (producers, CAS)
+    _Alignas(64) uint64_t head;         // Next slot to drain (writer only)
+    _Alignas(64) uint32_t items;        // Futex word bumped on publish while the writer sleeps
+    uint32_t space;                     // Futex word bumped when a slot frees while producers wait
+    uint32_t item_waiters;              // 1 while the writer sleeps
+    uint32_t space_waiters;             // Producers waiting for space
+    uint32_t writer_alive;              // 1 while the report writer runs
+    uint32_t stop;                      // Set by main: drain what is left and exit
+    uint64_t dropped;                   // Records lost (writer gone, or producer died mid-push)
+    uint64_t written;                   // Records appended by the writer
+    CompletionRecord slots[COMPLETION_RING_CAPACITY];
+} CompletionRing;
+
+/**
+ * @brief Extra shm bytes needed by the completion ring (0 when REPORT_INCREMENTAL=0).
+ *
+ * @param cfg Configuration.
+ * @param base_size Bytes already used in the segment.
+ * @return Bytes to add to the segment so the ring fits aligned.
+ */
+size_t completion_ring_shm_size(const Config *cfg, size_t base_size);
+
+/**
+ * @brief Initialize the completion ring and record its offset (main, after ipc_shm_init_state).
+ *
+ * @param state Freshly zeroed shared state.
+ * @param cfg Configuration.
+ * @param base_size Bytes already used in the segment.
+ */
+void completion_ring_init(SharedState *state, const Config *cfg, size_t base_size);
+
+/**
+ * @brief Locate the completion ring in this process's mapping.
+ *
+ * @param state Shared state.
+ * @return Ring, or NULL when REPORT_INCREMENTAL=0.
+ */
+CompletionRing *completion_ring_get(SharedState *state);
+
+/**
+ * @brief Push one finished tourist, waiting for space while the writer runs.
+ *
+ * @param ring Completion ring.
+ * @param id Tourist ID.
+ * @param entry Final entry.
+ * @return 0 on success, -1 if the record was dropped.
+ */
+int completion_ring_push(CompletionRing *ring, int id, const TouristEntry *entry);
+
+/**
+ * @brief Next published record, or NULL if none (writer only).
+ *
+ * @param ring Completion ring.
+ * @return Record to read; hand it back with completion_ring_release().
+ */
+CompletionRecord *completion_ring_peek(CompletionRing *ring);
+
+/**
+ * @brief Return the record from completion_ring_peek() to the producers (writer only).
+ *
+ * @param ring Completion ring.
+ * @param rec Record from completion_ring_peek().
+ */
+void completion_ring_release(CompletionRing *ring, CompletionRecord *rec);
+
+/**
+ * @brief Skip a slot that was claimed but never published (writer only).
+ *
+ * Only called after the head slot has been stuck for COMPLETION_STALL_MS,
+ * which means its producer died between claim and publish. The slot is
+ * counted as dropped.
+ *
+ * @param ring Completion ring.
+ * @return 1 if a slot was skipped, 0 otherwise.
+ */
+int completion_ring_skip_stalled(CompletionRing *ring);
+
+/**
+ * @brief Tell the writer to drain what is left and exit (main, after every tourist exited).
+ *
+ * @param ring Completion ring.
+ */
+void completion_ring_stop(CompletionRing *ring);
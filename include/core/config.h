@@ -5,12 +5,17 @@
  * @brief Configuration loading and validation.
  */
 
+#include "constants.h"
+
 /**
  * @brief Configuration structure (loaded at startup).
  */
 typedef struct {
     // Station settings
-    int station_capacity;           // Max tourists in lower station
+    int station_capacity;           // Max tourists in each lower station
+    int line_count;                 // Independent chairlift lines (1-MAX_LINES)
+    int cashier_count;              // Cashiers, each with its own queue (1-MAX_CASHIERS)
+    int cashier_batch;              // Requests a cashier serves per wakeup (1-MAX_CASHIER_BATCH)
 
     // Time settings
     int simulation_duration_real;   // Real seconds for simulation
@@ -19,10 +24,35 @@ typedef struct {
     int sim_end_hour;               // End hour (e.g., 17)
     int sim_end_minute;             // End minute (e.g., 0)
     int chair_travel_time_sim;      // Simulated minutes for chair ride
+    int clock_source;               // ClockSource: 0 = 10ms ticks, 1 = epoch read locally
+    int max_speed;                  // 1 = virtual clock jumps to the next deadline once all are blocked
 
     // Tourist generation
     int total_tourists;             // Total number of tourists to generate
     int tourist_spawn_delay_us;     // Delay between spawns in microseconds (0 = no delay)
+    int arrival_schedule;           // ArrivalScheduleMode: 0 = draw per spawn, 1 = precompute, 2 = replay file
+    int arrival_rate;               // Poisson arrivals per sim hour (0 = fixed TOURIST_SPAWN_DELAY_US)
+    int arrival_rate_hour[ARRIVAL_RATE_HOURS]; // Per-hour override of arrival_rate (-1 = not set)
+    int tourist_pool_size;          // Pre-forked tourist processes (0 = fork+exec per tourist)
+    int tourist_engine;             // TouristEngine: 0 = process, 1 = thread, 2 = event, 3 = fiber
+    int fiber_threads;              // Scheduler threads of the fiber host (TOURIST_ENGINE=3)
+    int remote_port;                // TCP port of the remote gateway (0 = no remote hosts)
+    int remote_tourists;            // Tourist IDs (the last ones) left to remote hosts
+    unsigned int remote_bind;       // IPv4 address the gateway listens on, host order (INADDR_NONE = invalid)
+    char remote_token[REMOTE_TOKEN_LEN]; // Secret every remote HELLO must carry (NUL-padded, empty = none)
+    int queue_transport;            // QueueTransport: 0 = SysV queues, 1 = shm rings
+    int sem_backend;                // SemBackend: 0 = SysV semop, 1 = futex in shm
+    int queue_bytes;                // msg_qbytes of every System V queue (0 = kernel.msgmnb)
+    int preflight;                  // PreflightMode: 0 = off, 1 = adapt to kernel limits, 2 = check only
+    int shm_huge_pages;             // ShmPages: 0 = base pages, 1 = SHM_HUGETLB, 2 = transparent
+    int numa_lines;                 // 1 = each line's shared regions and workers on its own NUMA node
+    int worker_cpus;                // Cores reserved for the fixed workers (0 = no pinning)
+    int worker_sched_fifo;          // SCHED_FIFO priority of the time server and boarding workers (0 = off)
+    int boarding_batch;             // 1 = chair table + one wake per chair (needs QUEUE_TRANSPORT=1)
+    int chair_fill_deadline_sim;    // Sim seconds a partial chair waits (0 = 100ms SIGALRM polling)
+    int boarding_workers;           // Platform consumers per line sharing a chair assembler
+    int boarding_window;            // Platform requests the loader packs from (0 = FIFO + requeue)
+    int chair_interval_sim;         // Sim seconds between ring departures, full or not (0 = leave when full)
 
     // Tourist distribution (percentages 0-100)
     int vip_percentage;
@@ -43,14 +73,44 @@ typedef struct {
     // Danger detection settings
     int danger_probability;         // Probability per check (0-100), 0 = disabled
     int danger_duration_sim;        // Simulated minutes emergency stop lasts
+    int danger_schedule;            // DangerScheduleMode: 0 = random draws, 1 = record, 2 = replay file
+    int emergency_backend;          // EmergencyBackend: 0 = signals + MQ handshake, 1 = futex epoch
 
     // Logging settings
     int debug_logs_enabled;         // 1 = show debug logs, 0 = hide debug logs
+    int log_async;                  // LogAsyncMode: 0 = direct, 1 = ring + drainer (wait), 2 = ring (drop)
+    int event_trace;                // 1 = write binary stage records to TRACE_FILE_NAME
+    int perf_counters;              // 1 = count each process's user-space cycles and instructions (perf_event_open)
+    int metrics_interval_ms;        // Real ms between METRICS_FILE_NAME updates (0 = no exporter)
+    int queue_sample_ms;            // Real ms between queue depth samples by the exporter (0 = none)
+    int report_format;              // ReportFormat: 0 = text, 1 = text + per-tourist CSV
+    int report_incremental;         // 1 = stream completed tourists to the report writer (no tourist table)
+    int checkpoint_interval_sim;    // Sim minutes between CHECKPOINT_FILE_NAME snapshots (0 = none)
 
     // Tourist behavior settings
     int scared_enabled;             // 1 = tourists can be scared, 0 = disabled
+    int random_seed;                // Base seed of every generator (0 = clock and PID, not reproducible)
 } Config;
 
+/**
+ * @brief Poisson arrival rate in effect during one simulated hour.
+ *
+ * @param cfg Configuration.
+ * @param hour Hour of the day (0-23).
+ * @return ARRIVAL_RATE_HH if set, ARRIVAL_RATE otherwise (tourists per sim hour).
+ */
+int config_arrival_rate(const Config *cfg, int hour);
+
+/**
+ * @brief Set one configuration key from its text value (as in a config file).
+ *
+ * @param cfg Configuration structure to update.
+ * @param key Key name (e.g. STATION_CAPACITY).
+ * @param value Value text.
+ * @return 0 on success, -1 if the key is unknown.
+ */
+int config_set_value(Config *cfg, const char *key, const char *value);
+
 /**
  * @brief Load configuration from a file.
  *
@@ -0,0 +1,85 @@
+#pragma once
+
+/**
+ * @file core/danger_schedule.h
+ * @brief Recorded danger detections and their replay (DANGER_SCHEDULE > 0).
+ *
+ * Danger detection is the one random draw the workers make on their own.
+ * With DANGER_SCHEDULE=1 each trigger (sim time, line, worker) is kept in
+ * SharedState.danger and main saves the list to DANGER_SCHEDULE_FILE_NAME at
+ * the end of the run. With DANGER_SCHEDULE=2 main loads that file instead and
+ * the workers make no draws: each one triggers its recorded stops at its
+ * first check at or after their sim time. Together with ARRIVAL_SCHEDULE=2
+ * and the same RANDOM_SEED a run replays the recorded arrivals and stops.
+ *
+ * Chair assignments are not replayed: they are what the run computes from
+ * those inputs. EVENT_TRACE=1 records them (chair_departed and on_chair
+ * records) for comparing a replay with its recording.
+ */
+
+#include "ipc/shared_state.h"
+#include "core/config.h"
+
+#include <stdint.h>
+
+#define DANGER_SCHEDULE_MAGIC "RWDANGR1"
+#define DANGER_SCHEDULE_VERSION 1
+
+/**
+ * @brief Header of DANGER_SCHEDULE_FILE_NAME (followed by count events).
+ */
+typedef struct {
+    char magic[8];                      // DANGER_SCHEDULE_MAGIC, not NUL-terminated
+    uint32_t version;                   // DANGER_SCHEDULE_VERSION
+    uint32_t record_size;               // sizeof(DangerEvent)
+    uint32_t count;                     // Events in the file
+    uint32_t reserved;
+} DangerScheduleFileHeader;
+
+/**
+ * @brief With DANGER_SCHEDULE=2, load the replay script.
+ *
+ * Main, after ipc_shm_init_state (every sweep run reloads it).
+ *
+ * @param state Freshly zeroed shared state.
+ * @param cfg Configuration.
+ * @return 0 on success, -1 if the file cannot be loaded.
+ */
+int danger_schedule_init(SharedState *state, const Config *cfg);
+
+/**
+ * @brief Record one danger trigger of this run.
+ *
+ * @param state Shared state.
+ * @param line Chairlift line.
+ * @param worker WorkerRole of the detecting worker.
+ * @param sim_ms Sim ms since midnight of the trigger.
+ */
+void danger_schedule_record(SharedState *state, int line, int worker, int64_t sim_ms);
+
+/**
+ * @brief Whether a replayed danger stop is due for one worker.
+ *
+ * Consumes the worker's next script event once its sim time has come. An
+ * event overdue by more than DANGER_DURATION_SIM_MINUTES fell inside a stop
+ * (the line was halted past it, typically by the other worker detecting
+ * the same danger); it is counted as missed and skipped.
+ *
+ * @param state Shared state.
+ * @param line Chairlift line.
+ * @param worker WorkerRole of the caller.
+ * @param cursor Caller's position in the script (starts at 0).
+ * @param now_ms Current sim ms since midnight.
+ * @return 1 if a stop is due, 0 otherwise.
+ */
+int danger_schedule_due(SharedState *state, int line, int worker, uint32_t *cursor,
+                        int64_t now_ms);
+
+/**
+ * @brief Write the recorded triggers for a later DANGER_SCHEDULE=2 run.
+ *
+ * @param state Shared state after the run.
+ * @param path Output path.
+ * @return 0 on success, -1 on error.
+ */
+int danger_schedule_save(const SharedState *state, const char *path);
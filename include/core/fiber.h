@@ -0,0 +1,136 @@
+#pragma once
+
+/**
+ * @file core/fiber.h
+ * @brief ucontext fibers on an io_uring scheduler, and the waits that suspend them.
+ *
+ * The fiber engine (TOURIST_ENGINE=3) runs tourist_run() unchanged, one
+ * fiber per tourist, on a few scheduler threads. Tourist code never calls
+ * into the scheduler: its blocking points already go through a handful of
+ * primitives (futex_wait, time_sleep_until_elapsed_ns, semop and the
+ * msgsnd/msgrcv calls of the tourist path), and those check fiber_active().
+ * On a scheduler thread they suspend the calling fiber instead of the thread:
+ * - futex waits become IORING_OP_FUTEX_WAIT with a linked timeout (Linux
+ *   6.7+; older kernels re-check the word every FIBER_POLL_NS);
+ * - sleeps become IORING_OP_TIMEOUT, absolute on CLOCK_MONOTONIC like the
+ *   clock_nanosleep they replace;
+ * - System V semaphores and queues have nothing to wait on, so the call is
+ *   retried with IPC_NOWAIT once per FIBER_POLL_NS pass of the scheduler.
+ * Everywhere else (workers, other engines) the wrappers are the plain call.
+ *
+ * A scheduler belongs to the thread that created it, and its fibers never
+ * migrate. The thread-local state tourist code relies on (the rng_local()
+ * generator, the logger's thread component) is saved and restored on every
+ * switch, so each fiber keeps its own. Stacks are FIBER_STACK_SIZE bytes,
+ * carved from slabs of FIBER_STACK_SLAB per mmap, with a canary at the
+ * bottom checked after every switch instead of a guard page (guard pages
+ * would cost one mapping per fiber and cap fibers at vm.max_map_count).
+ */
+
+#include <stdint.h>
+#include <sys/sem.h>
+#include <sys/types.h>
+#include <time.h>
+
+typedef struct FiberScheduler FiberScheduler;
+
+/**
+ * @brief Fiber entry point; the fiber ends when it returns.
+ */
+typedef void (*FiberFunc)(void *arg);
+
+/**
+ * @brief Counters of one scheduler, for the engine's summary line.
+ */
+typedef struct {
+    int live;                           // Fibers not yet returned
+    int peak;                           // Most live fibers at once
+    unsigned long long spawned;
+    unsigned long long switches;        // Resumes
+    unsigned long long uring_waits;     // Futex waits and sleeps sent to the ring
+    unsigned long long polls;           // System V retries
+    int futex_op;                       // 1 if the kernel has IORING_OP_FUTEX_WAIT
+} FiberStats;
+
+/**
+ * @brief Create a scheduler (and its io_uring) for the calling thread.
+ *
+ * @return Scheduler, or NULL if io_uring is unavailable or on allocation failure.
+ */
+FiberScheduler *fiber_scheduler_create(void);
+
+/**
+ * @brief Start a fiber; it first runs at the next fiber_scheduler_run().
+ *
+ * @param s Scheduler of the calling thread.
+ * @param fn Entry point.
+ * @param arg Argument for fn.
+ * @return 0 on success, -1 if no stack could be allocated.
+ */
+int fiber_spawn(FiberScheduler *s, FiberFunc fn, void *arg);
+
+/**
+ * @brief One scheduler pass.
+ *
+ * Runs every ready fiber, then waits up to wait_ns for completions (at most
+ * FIBER_POLL_NS while System V waiters are parked) and makes their fibers
+ * ready. Returns early on a signal.
+ *
+ * @param s Scheduler of the calling thread.
+ * @param wait_ns Longest wait for a completion (0 = do not wait).
+ * @return Live fibers after the pass.
+ */
+int fiber_scheduler_run(FiberScheduler *s, int64_t wait_ns);
+
+/**
+ * @brief Counters of a scheduler.
+ */
+FiberStats fiber_scheduler_stats(const FiberScheduler *s);
+
+/**
+ * @brief Close the ring and free every stack (no fiber may be live).
+ */
+void fiber_scheduler_destroy(FiberScheduler *s);
+
+/**
+ * @brief Whether the calling code runs on a fiber.
+ *
+ * @return 1 on a fiber, 0 on a plain thread.
+ */
+int fiber_active(void);
+
+/**
+ * @brief futex_wait() that suspends the calling fiber (only when fiber_active()).
+ *
+ * futex_wait hands its callers' waits here on a fiber. Same contract: 0 when woken (or spuriously), -1 with errno
+ * EAGAIN (value changed), ETIMEDOUT or EINTR.
+ *
+ * @param addr Futex word (shared memory, process-shared).
+ * @param expected Value the caller last observed.
+ * @param timeout_ms Maximum wait in milliseconds (<= 0 waits forever).
+ */
+int fiber_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms);
+
+/**
+ * @brief clock_nanosleep(CLOCK_MONOTONIC, flags, ts, NULL), suspending a fiber.
+ *
+ * @param flags 0 or TIMER_ABSTIME.
+ * @param ts Relative duration or absolute CLOCK_MONOTONIC time.
+ * @return 0, or an error number like clock_nanosleep (EINTR on a signal).
+ */
+int fiber_clock_nanosleep(int flags, const struct timespec *ts);
+
+/**
+ * @brief semop() that retries with IPC_NOWAIT on a fiber instead of blocking.
+ */
+int fiber_semop(int semid, struct sembuf *sops, size_t nsops);
+
+/**
+ * @brief msgsnd() that retries with IPC_NOWAIT on a fiber instead of blocking.
+ */
+int fiber_msgsnd(int msqid, const void *msgp, size_t msgsz, int msgflg);
+
+/**
+ * @brief msgrcv() that retries with IPC_NOWAIT on a fiber instead of blocking.
+ */
+ssize_t fiber_msgrcv(int msqid, void *msgp, size_t msgsz, long msgtyp, int msgflg);
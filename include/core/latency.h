@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * @file core/latency.h
+ * @brief Lock-free wait-latency histograms in shared memory.
+ *
+ * Each LatencyStage has one LatencyHistogram in SharedState. Values are real
+ * microseconds. Waits below 2^LAT_SUB_BUCKET_BITS us get one bucket per
+ * microsecond; above that every power of two is split into
+ * 2^LAT_SUB_BUCKET_BITS linear sub-buckets, so any reported percentile is
+ * within ~6% of the true value (HDR-style). Writers use relaxed atomic adds
+ * only; the report reads the buckets after every writer has exited.
+ */
+
+#include "ipc/shared_state.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Current monotonic time in microseconds (start/end of a wait).
+ *
+ * @return Microseconds on CLOCK_MONOTONIC.
+ */
+uint64_t latency_now_us(void);
+
+/**
+ * @brief Record one wait.
+ *
+ * @param state Shared state holding the histograms.
+ * @param stage Blocking point.
+ * @param start_us latency_now_us() taken before the wait.
+ */
+void latency_record_since(SharedState *state, LatencyStage stage, uint64_t start_us);
+
+/**
+ * @brief Record one wait of a known duration.
+ *
+ * @param state Shared state holding the histograms.
+ * @param stage Blocking point.
+ * @param wait_us Wait duration in microseconds.
+ */
+void latency_record(SharedState *state, LatencyStage stage, uint64_t wait_us);
+
+/**
+ * @brief Record one sample into a histogram outside the LatencyStage set.
+ *
+ * @param hist Histogram.
+ * @param value_us Sample in microseconds.
+ */
+void latency_hist_record(LatencyHistogram *hist, uint64_t value_us);
+
+/**
+ * @brief Value at or below which a fraction q of the samples fall.
+ *
+ * Returns the upper edge of the bucket holding that sample, capped at the
+ * largest recorded value.
+ *
+ * @param hist Histogram.
+ * @param q Quantile 0.0-1.0 (0.99 = p99).
+ * @return Wait in microseconds (0 if the histogram is empty).
+ */
+uint64_t latency_percentile(const LatencyHistogram *hist, double q);
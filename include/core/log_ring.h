@@ -0,0 +1,121 @@
+#pragma once
+
+/**
+ * @file core/log_ring.h
+ * @brief Shared-memory log ring drained by the log drainer process (LOG_ASYNC > 0).
+ *
+ * Producers (every process and thread that calls log_msg) claim a slot with
+ * one CAS, vsnprintf the message straight into it and publish it; they never
+ * call write(). The single log drainer formats the prefix and colors and
+ * writes many records per write(). When the ring is full a producer either
+ * waits for space (LOG_ASYNC_BLOCK) or drops the record and bumps the drop
+ * counter (LOG_ASYNC_DROP).
+ */
+
+#include "ipc/shared_state.h"
+#include "core/config.h"
+
+#include <stddef.h>
+
+/**
+ * @brief One log line in binary form (formatted by the drainer).
+ */
+typedef struct {
+    uint64_t seq;                       // Slot sequence (publish/consume handshake)
+    double sim_minutes;                 // Sim time when logged
+    uint32_t len;                       // Bytes used in text
+    uint32_t comp;                      // LogComponent of the producer (color)
+    char level[8];                      // LOG_DEBUG/LOG_INFO/...
+    char component[24];                 // Component tag ("MAIN", "KID", ...)
+    char text[LOG_RECORD_TEXT];         // Formatted message, not NUL-terminated
+} LogRecord;
+
+/**
+ * @brief Bounded multi-producer, single-consumer log ring.
+ */
+typedef struct {
+    _Alignas(64) uint64_t tail;         // Next slot to claim (producers, CAS)
+    _Alignas(64) uint64_t head;         // Next slot to drain (drainer only)
+    _Alignas(64) uint32_t items;        // Futex word bumped on publish while the drainer sleeps
+    uint32_t space;                     // Futex word bumped when a slot frees while producers wait
+    uint32_t item_waiters;              // 1 while the drainer sleeps
+    uint32_t space_waiters;             // Producers waiting for space (LOG_ASYNC_BLOCK)
+    uint32_t drainer_alive;             // 1 while the drainer runs
+    uint32_t stop;                      // Set by main: drain what is left and exit
+    uint64_t dropped;                   // Records lost to a full ring
+    uint64_t written;                   // Records written by the drainer
+    LogRecord slots[LOG_RING_CAPACITY];
+} LogRing;
+
+/**
+ * @brief Extra shm bytes needed by the log ring (0 when LOG_ASYNC=0).
+ *
+ * @param cfg Configuration.
+ * @param base_size Bytes already used in the segment.
+ * @return Bytes to add to the segment so the ring fits aligned.
+ */
+size_t log_ring_shm_size(const Config *cfg, size_t base_size);
+
+/**
+ * @brief Initialize the log ring and record its offset (main, after ipc_shm_init_state).
+ *
+ * @param state Freshly zeroed shared state.
+ * @param cfg Configuration.
+ * @param base_size Bytes already used in the segment.
+ */
+void log_ring_init(SharedState *state, const Config *cfg, size_t base_size);
+
+/**
+ * @brief Locate the log ring in this process's mapping.
+ *
+ * @param state Shared state.
+ * @return Ring, or NULL when asynchronous logging is off.
+ */
+LogRing *log_ring_get(SharedState *state);
+
+/**
+ * @brief Claim a free slot for one record.
+ *
+ * @param ring Log ring.
+ * @param wait_when_full 1 = wait for the drainer to make space, 0 = drop.
+ * @param pos_out Output: ring position to pass to log_ring_publish().
+ * @return Slot to fill, or NULL if the record was dropped.
+ */
+LogRecord *log_ring_claim(LogRing *ring, int wait_when_full, uint64_t *pos_out);
+
+/**
+ * @brief Publish a filled slot and wake the drainer if it sleeps.
+ *
+ * @param ring Log ring.
+ * @param rec Slot from log_ring_claim().
+ * @param pos Position from log_ring_claim().
+ */
+void log_ring_publish(LogRing *ring, LogRecord *rec, uint64_t pos);
+
+/**
+ * @brief Next published record, or NULL if none (drainer only).
+ *
+ * @param ring Log ring.
+ * @return Record to read; hand it back with log_ring_release().
+ */
+LogRecord *log_ring_peek(LogRing *ring);
+
+/**
+ * @brief Return the record from log_ring_peek() to the producers (drainer only).
+ *
+ * @param ring Log ring.
+ * @param rec Record from log_ring_peek().
+ */
+void log_ring_release(LogRing *ring, LogRecord *rec);
+
+/**
+ * @brief Skip a slot that was claimed but never published (drainer only).
+ *
+ * Only called after the head slot has been stuck for LOG_STALL_MS, which
+ * means its producer died between claim and publish (e.g. SIGKILL). The
+ * slot is counted as dropped.
+ *
+ * @param ring Log ring.
+ * @return 1 if a slot was skipped, 0 otherwise.
+ */
+int log_ring_skip_stalled(LogRing *ring);
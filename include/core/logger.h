@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ipc/shared_state.h"
+#include "core/log_ring.h"
 
 // Log levels
 #define LOG_DEBUG "DEBUG"
@@ -8,6 +9,26 @@
 #define LOG_WARN  "WARN"
 #define LOG_ERROR "ERROR"
 
+// Numeric log levels for filtering (compared before any argument is evaluated)
+#define LOG_LEVEL_DEBUG 0
+#define LOG_LEVEL_INFO  1
+#define LOG_LEVEL_WARN  2
+#define LOG_LEVEL_ERROR 3
+
+// Lowest level compiled in (set by the ROPEWAY_LOG_LEVEL CMake option).
+// Calls below it compile to nothing.
+#ifndef LOG_COMPILE_LEVEL
+#define LOG_COMPILE_LEVEL LOG_LEVEL_DEBUG
+#endif
+
+// Lowest level printed at runtime (set by logger_set_debug_enabled)
+extern int g_log_level;
+
+/**
+ * @brief Check whether a level is compiled in and enabled at runtime.
+ */
+#define LOG_ENABLED(lvl) ((lvl) >= LOG_COMPILE_LEVEL && (lvl) >= g_log_level)
+
 // Component types for colored logging
 typedef enum {
     LOG_TOURIST,
@@ -31,6 +52,26 @@ typedef enum {
  */
 void logger_init(SharedState *state, LogComponent comp);
 
+/**
+ * @brief Override the component color for the calling thread only.
+ *
+ * Used when many tourists share one process (thread engine), so a VIP
+ * thread keeps its color without changing the process-wide component.
+ *
+ * @param comp Component type for this thread's log lines.
+ */
+void logger_set_thread_component(LogComponent comp);
+
+/**
+ * @brief Component override of the calling thread.
+ *
+ * Lets the fiber engine keep one override per fiber (saved and restored by
+ * logger_set_thread_component on every switch).
+ *
+ * @return Override set by logger_set_thread_component, or -1 if none.
+ */
+int logger_get_thread_component(void);
+
 /**
  * @brief Enable or disable debug log output.
  *
@@ -41,6 +82,12 @@ void logger_set_debug_enabled(int enabled);
 /**
  * @brief Log a formatted message to stderr.
  *
+ * Call through the log_* macros, which skip the call (and the evaluation of
+ * its arguments) when the level is compiled out or disabled.
+ *
+ * With LOG_ASYNC > 0 the message is appended to the shm log ring instead and
+ * written by the log drainer process.
+ *
  * NOT signal-safe (uses snprintf). Format: [HH:MM:SS] [LEVEL] [COMPONENT] message
  *
  * @param level Log level string (LOG_DEBUG, LOG_INFO, etc.).
@@ -50,11 +97,37 @@ void logger_set_debug_enabled(int enabled);
  */
 void log_msg(const char *level, const char *component, const char *fmt, ...);
 
-// Convenience macros
-#define log_debug(component, fmt, ...) log_msg(LOG_DEBUG, component, fmt, ##__VA_ARGS__)
-#define log_info(component, fmt, ...)  log_msg(LOG_INFO, component, fmt, ##__VA_ARGS__)
-#define log_warn(component, fmt, ...)  log_msg(LOG_WARN, component, fmt, ##__VA_ARGS__)
-#define log_error(component, fmt, ...) log_msg(LOG_ERROR, component, fmt, ##__VA_ARGS__)
+// Convenience macros (level test happens before the call)
+#define log_at(lvl, level_str, component, fmt, ...) \
+    do { \
+        if (LOG_ENABLED(lvl)) { \
+            log_msg(level_str, component, fmt, ##__VA_ARGS__); \
+        } \
+    } while (0)
+
+#define log_debug(component, fmt, ...) log_at(LOG_LEVEL_DEBUG, LOG_DEBUG, component, fmt, ##__VA_ARGS__)
+#define log_info(component, fmt, ...)  log_at(LOG_LEVEL_INFO, LOG_INFO, component, fmt, ##__VA_ARGS__)
+#define log_warn(component, fmt, ...)  log_at(LOG_LEVEL_WARN, LOG_WARN, component, fmt, ##__VA_ARGS__)
+#define log_error(component, fmt, ...) log_at(LOG_LEVEL_ERROR, LOG_ERROR, component, fmt, ##__VA_ARGS__)
+
+/**
+ * @brief Format one ring record as a complete log line (log drainer).
+ *
+ * @param rec Record from the log ring.
+ * @param buf Output buffer.
+ * @param buf_size Size of the output buffer (at least 512 bytes).
+ * @param use_colors 1 to add ANSI colors.
+ * @return Number of bytes written.
+ */
+int logger_format_record(const LogRecord *rec, char *buf, int buf_size, int use_colors);
+
+/**
+ * @brief Stop the log drainer and switch this process back to direct writes.
+ *
+ * Main calls this once every other worker has exited; the drainer writes
+ * whatever is still in the ring and exits. No-op when LOG_ASYNC=0.
+ */
+void logger_async_stop(void);
 
 /**
  * @brief Signal-safe logging for use in signal handlers only.
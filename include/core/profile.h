@@ -0,0 +1,72 @@
+#pragma once
+
+/**
+ * @file core/profile.h
+ * @brief Per-process CPU time, context switches and optional cycle counters.
+ *
+ * Every process main forks (workers, helpers, the generator) calls
+ * profile_begin() before its entry function and profile_end() after it, so
+ * each one's wall time, getrusage() totals and, with PERF_COUNTERS=1, its
+ * user-space cycles and instructions reach ProcessProfile in shared memory.
+ * The counters are inherited by the threads a process starts, not by the
+ * children it forks. They exclude the kernel and the hypervisor, which keeps
+ * them available under perf_event_paranoid=2; if perf_event_open still
+ * refuses, the errno is kept and reported instead. Tourists are not
+ * profiled one by one: the generator reports them as one aggregate with
+ * RUSAGE_CHILDREN once it has reaped all of them.
+ */
+
+#include "ipc/shared_state.h"
+
+#include <sys/resource.h>
+
+/**
+ * @brief Start-of-run snapshot of one process.
+ */
+typedef struct {
+    int64_t start_ns;               // time_monotonic_ns() at profile_begin()
+    struct rusage self;             // RUSAGE_SELF at profile_begin()
+    struct rusage children;         // RUSAGE_CHILDREN at profile_begin()
+    int cycles_fd;                  // perf group leader (-1 = none)
+    int instructions_fd;
+    int perf_error;                 // errno of a failed perf_event_open
+} ProfileScope;
+
+/**
+ * @brief Snapshot rusage and, with PERF_COUNTERS=1, start the cycle counters.
+ *
+ * @param scope Snapshot to fill.
+ * @param cfg Run configuration.
+ */
+void profile_begin(ProfileScope *scope, const Config *cfg);
+
+/**
+ * @brief Record the calling process's usage since profile_begin() in a ProcessProfile slot.
+ *
+ * Closes the counters.
+ *
+ * @param scope Snapshot taken by profile_begin().
+ * @param state Shared state receiving the slot.
+ */
+void profile_end(ProfileScope *scope, SharedState *state);
+
+/**
+ * @brief Record the usage of the caller's reaped children since profile_begin().
+ *
+ * The generator calls it once every tourist has been reaped.
+ *
+ * @param scope Snapshot taken by profile_begin().
+ * @param state Shared state.
+ * @param processes Children the aggregate covers.
+ */
+void profile_end_tourists(const ProfileScope *scope, SharedState *state, uint32_t processes);
+
+/**
+ * @brief Record main's own usage plus every reaped child's as the run total.
+ *
+ * Main calls it once every process of the run has been waited for.
+ *
+ * @param scope Snapshot taken by profile_begin() at the start of the run.
+ * @param state Shared state.
+ */
+void profile_end_total(const ProfileScope *scope, SharedState *state);
@@ -7,13 +7,51 @@
 
 #include "ipc/shared_state.h"
 
+#define REPORT_CSV_HEADER "id,type,ticket,rides,vip,kids\n"
+
 /**
  * @brief Write final simulation report to a file.
  *
- * Writes the same content as print_report() to the specified file.
+ * Header and aggregates are formatted with stdio; the per-tourist rows are
+ * formatted in parallel blocks and written with writev() (see report.c).
+ * With REPORT_INCREMENTAL=1 the rows come from the report writer's spool
+ * file, which is removed afterwards.
  *
  * @param state Shared state with simulation data.
  * @param filepath Path to the output file.
  * @return 0 on success, -1 on error.
  */
 int write_report_to_file(SharedState *state, const char *filepath);
+
+/**
+ * @brief Write the per-tourist table as CSV (REPORT_FORMAT=1).
+ *
+ * One row per tracked tourist: id,type,ticket,rides,vip,kids, with the same
+ * names as the text report and vip as 0/1. With REPORT_INCREMENTAL=1 the
+ * report writer produces this file while the simulation runs instead.
+ *
+ * @param state Shared state with simulation data.
+ * @param filepath Path to the output file.
+ * @return 0 on success, -1 on error.
+ */
+int write_report_csv(SharedState *state, const char *filepath);
+
+/**
+ * @brief Format one text report row ("%-6d %-8s %-10s %-6d %s\n" layout).
+ *
+ * @param p Output, at least REPORT_ROW_MAX bytes free.
+ * @param id Tourist ID.
+ * @param e Tourist entry.
+ * @return End of the written bytes (not NUL-terminated).
+ */
+char *report_format_text_row(char *p, int id, const TouristEntry *e);
+
+/**
+ * @brief Format one CSV row (REPORT_CSV_HEADER columns).
+ *
+ * @param p Output, at least REPORT_ROW_MAX bytes free.
+ * @param id Tourist ID.
+ * @param e Tourist entry.
+ * @return End of the written bytes (not NUL-terminated).
+ */
+char *report_format_csv_row(char *p, int id, const TouristEntry *e);
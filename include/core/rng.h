@@ -0,0 +1,124 @@
+#pragma once
+
+/**
+ * @file core/rng.h
+ * @brief Per-process xoshiro256** generators with reproducible streams.
+ *
+ * Replaces rand(), which takes a libc lock on every call and has a weak low
+ * bit. Every generator is seeded from a base seed (RANDOM_SEED, or the clock
+ * and PID when it is 0, see rng_base_seed) and a stream number, expanded
+ * with splitmix64, so components never share a sequence and a seeded run
+ * draws the same values in every component that is not timing-dependent.
+ * RngLanes runs RNG_LANES independent streams side by side in plain arrays
+ * (no branches), which the compiler vectorizes, for bulk draws such as the
+ * generator's tourist attribute batches.
+ */
+
+#include <stdint.h>
+
+#define RNG_LANES 4                     // Streams per RngLanes (SIMD width in 64-bit lanes)
+
+// Stream numbers (added to the base seed's stream space)
+#define RNG_STREAM_GENERATOR 1          // Tourist attribute batches
+#define RNG_STREAM_EVENTS 2             // Event engine host
+#define RNG_STREAM_ARRIVALS 3           // Poisson arrival times (generator)
+#define RNG_STREAM_REMOTE 4             // Remote tourist hosts (tools/remote_tourists.c)
+#define RNG_STREAM_LOWER_WORKER 0x100   // + line (danger checks)
+#define RNG_STREAM_UPPER_WORKER 0x200   // + line (danger checks)
+#define RNG_STREAM_TOURIST 0x10000      // + tourist ID (scared check, trail choice)
+
+/**
+ * @brief One xoshiro256** generator.
+ */
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+/**
+ * @brief RNG_LANES xoshiro256** generators, state word-major for vectorization.
+ */
+typedef struct {
+    uint64_t s[4][RNG_LANES];
+} RngLanes;
+
+/**
+ * @brief Base seed for a run.
+ *
+ * @param configured RANDOM_SEED (0 = not reproducible).
+ * @return configured, or a value mixed from CLOCK_MONOTONIC and the PID when it is 0.
+ */
+uint64_t rng_base_seed(int configured);
+
+/**
+ * @brief Seed a generator for one stream.
+ *
+ * @param rng Generator.
+ * @param seed Base seed (rng_base_seed).
+ * @param stream Stream number (RNG_STREAM_*).
+ */
+void rng_seed(Rng *rng, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief Next 64 random bits.
+ *
+ * @param rng Generator.
+ * @return Uniform 64-bit value.
+ */
+uint64_t rng_next(Rng *rng);
+
+/**
+ * @brief Map 64 random bits to [0, n) (multiply-shift, no division).
+ *
+ * Uses the high 32 bits; the bias is below n / 2^32.
+ *
+ * @param x Random bits.
+ * @param n Range size (> 0).
+ * @return Value in [0, n).
+ */
+static inline int rng_scale(uint64_t x, uint32_t n) {
+    return (int)(((x >> 32) * (uint64_t)n) >> 32);
+}
+
+/**
+ * @brief Uniform integer in [0, n).
+ *
+ * @param rng Generator.
+ * @param n Range size (> 0).
+ * @return Value in [0, n).
+ */
+int rng_below(Rng *rng, uint32_t n);
+
+/**
+ * @brief Seed every lane (lane L uses stream * RNG_LANES + L).
+ *
+ * @param lanes Generators.
+ * @param seed Base seed (rng_base_seed).
+ * @param stream Stream number (RNG_STREAM_*).
+ */
+void rng_lanes_seed(RngLanes *lanes, uint64_t seed, uint64_t stream);
+
+/**
+ * @brief Next 64 random bits from every lane.
+ *
+ * @param lanes Generators.
+ * @param out Output: RNG_LANES values.
+ */
+void rng_lanes_next(RngLanes *lanes, uint64_t out[RNG_LANES]);
+
+/**
+ * @brief This thread's generator (tourist side: one per thread).
+ *
+ * Seeded from the clock, PID and thread on first use unless
+ * rng_local_seed() ran first.
+ *
+ * @return Thread-local generator.
+ */
+Rng *rng_local(void);
+
+/**
+ * @brief Reseed this thread's generator.
+ *
+ * @param seed Base seed (rng_base_seed).
+ * @param stream Stream number (RNG_STREAM_*).
+ */
+void rng_local_seed(uint64_t seed, uint64_t stream);
@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * @file core/stats.h
+ * @brief Sharded simulation statistics in shared memory.
+ *
+ * Every thread that records statistics claims its own cache-line-sized
+ * StatsShard on first use and updates it with plain (non-RMW) stores, so
+ * the ride path has no shared cache line and no lock. When all shards are
+ * taken, writers fall back to slot 0 with atomic adds. Totals are only
+ * ever read by summing every shard.
+ */
+
+#include "ipc/shared_state.h"
+
+/**
+ * @brief Merged view of all statistics shards.
+ */
+typedef struct {
+    int total_tourists;
+    int total_rides;
+    int rides_by_ticket[TICKET_COUNT];
+    int tourists_by_ticket[TICKET_COUNT];
+} StatsSnapshot;
+
+/**
+ * @brief Count completed rides for this thread's shard.
+ *
+ * @param state Shared state.
+ * @param ticket_type TicketType of the riders (ignored if out of range).
+ * @param rides Number of riders (parent + kids).
+ */
+void stats_add_rides(SharedState *state, int ticket_type, int rides);
+
+/**
+ * @brief Count tourists sold a ticket for this thread's shard.
+ *
+ * @param state Shared state.
+ * @param ticket_type TicketType sold (ignored if out of range).
+ * @param tourists Number of tourists (parent + kids).
+ */
+void stats_add_tourists(SharedState *state, int ticket_type, int tourists);
+
+/**
+ * @brief Return this thread's shard to the free pool.
+ *
+ * Call when a thread or process that recorded statistics is done, so
+ * short-lived tourists do not exhaust the shard table. Values stay in the
+ * shard and keep counting towards the totals.
+ *
+ * @param state Shared state.
+ */
+void stats_release(SharedState *state);
+
+/**
+ * @brief Sum all shards into a snapshot (safe while writers run).
+ *
+ * @param state Shared state.
+ * @param out Output snapshot.
+ */
+void stats_snapshot(const SharedState *state, StatsSnapshot *out);
@@ -0,0 +1,103 @@
+#pragma once
+
+/**
+ * @file core/sweep.h
+ * @brief Parameter sweeps over one set of IPC resources.
+ *
+ * Each `--sweep KEY=v1,v2,...` option adds one axis; the runs are the
+ * cartesian product of all axes (the last axis changes fastest). Every run
+ * starts from the base configuration with its values applied through
+ * config_set_value(). Results are collected from shared memory after each
+ * run and written as one table.
+ */
+
+#include "core/config.h"
+#include "ipc/shared_state.h"
+
+/**
+ * @brief One swept key and its values.
+ */
+typedef struct {
+    char key[64];
+    int value_count;
+    char values[SWEEP_MAX_VALUES][SWEEP_VALUE_MAX];
+} SweepAxis;
+
+/**
+ * @brief All swept keys of one invocation.
+ */
+typedef struct {
+    int axis_count;
+    SweepAxis axes[SWEEP_MAX_AXES];
+} Sweep;
+
+/**
+ * @brief Summary of one finished run.
+ */
+typedef struct {
+    int total_tourists;
+    int total_rides;
+    unsigned long long chairs_departed;
+    double slot_utilization;        // Percent of CHAIR_CAPACITY slots used on departed chairs
+    double lower_wait_p50_ms;       // LAT_LOWER_STATION percentiles (real ms)
+    double lower_wait_p99_ms;
+    double wall_seconds;            // Real time from spawning workers to the last exit
+} SweepResult;
+
+/**
+ * @brief Add one axis from a `KEY=v1,v2,...` option.
+ *
+ * @param sweep Sweep to extend.
+ * @param spec Option text.
+ * @return 0 on success, -1 on a malformed spec, unknown key or too many axes/values.
+ */
+int sweep_add_axis(Sweep *sweep, const char *spec);
+
+/**
+ * @brief Value text of one axis in a run.
+ *
+ * @param sweep Sweep.
+ * @param axis Axis index.
+ * @param run Run index.
+ * @return Value text.
+ */
+const char *sweep_value(const Sweep *sweep, int axis, int run);
+
+/**
+ * @brief Number of runs (product of the axes' value counts).
+ *
+ * @param sweep Sweep.
+ * @return Run count (1 with no axes).
+ */
+int sweep_run_count(const Sweep *sweep);
+
+/**
+ * @brief Configuration of one run.
+ *
+ * @param sweep Sweep.
+ * @param base Base configuration (from the config file).
+ * @param run Run index 0..sweep_run_count()-1.
+ * @param out Configuration to fill.
+ */
+void sweep_run_config(const Sweep *sweep, const Config *base, int run, Config *out);
+
+/**
+ * @brief Collect the summary of a finished run from shared memory.
+ *
+ * @param state Shared state (every run process has exited).
+ * @param wall_seconds Real duration of the run.
+ * @param out Result to fill.
+ */
+void sweep_collect(const SharedState *state, double wall_seconds, SweepResult *out);
+
+/**
+ * @brief Write the aggregated report: one row per run.
+ *
+ * @param sweep Sweep.
+ * @param results Results of the first run_count runs.
+ * @param run_count Runs finished (may be fewer than planned after a shutdown).
+ * @param filepath Output path.
+ * @return 0 on success, -1 on error.
+ */
+int sweep_write_report(const Sweep *sweep, const SweepResult *results, int run_count,
+                       const char *filepath);
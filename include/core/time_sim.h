@@ -3,6 +3,17 @@
 /**
  * @file core/time_sim.h
  * @brief Time simulation and acceleration functions.
+ *
+ * With MAX_SPEED=1 the pause-adjusted elapsed time is virtual
+ * (SharedState.vclock): it stands still while anything can still run and
+ * the Time Server jumps it to the earliest pending deadline once every
+ * participant is blocked, like a conservative discrete-event clock.
+ * Participants are the cashiers, line workers, generator and tourists (each
+ * hosted thread); every wait that can last until another participant acts
+ * or the clock moves is bracketed by time_wait_begin/time_wait_end. Deadline
+ * sleeps, the workers' SIGALRM polls (time_alarm_us) and the event engine's
+ * timers (time_hold_until_elapsed_ns) are on that timeline, so the day runs
+ * as fast as the processes can serve it with the same ordering.
  */
 
 #include "ipc/shared_state.h"
@@ -18,6 +29,142 @@
  */
 void time_init(SharedState *state, const Config *cfg);
 
+/**
+ * @brief CLOCK_MONOTONIC in nanoseconds (the epoch clock's time base).
+ *
+ * @return Monotonic nanoseconds, 0 if clock_gettime fails.
+ */
+int64_t time_monotonic_ns(void);
+
+/**
+ * @brief Pause-adjusted real time since the simulation started.
+ *
+ * CLOCK_MONOTONIC minus the control epoch: pauses are not counted and the
+ * value stands still while the Time Server is stopped. Ride and trail
+ * deadlines are on this timeline (see time_sleep_until_elapsed_ns).
+ *
+ * @param state Shared memory state.
+ * @return Nanoseconds since the start, excluding pauses.
+ */
+int64_t time_elapsed_ns(const SharedState *state);
+
+/**
+ * @brief Sleep until time_elapsed_ns() reaches a deadline.
+ *
+ * Sleeps with clock_nanosleep(TIMER_ABSTIME) on CLOCK_MONOTONIC, so wakeups
+ * do not drift. After every wakeup the deadline is mapped to CLOCK_MONOTONIC
+ * again with the current epoch, so a pause moves it back by the pause
+ * length; while the Time Server is stopped (or has not yet published the
+ * resume) the sleep waits in TIME_PAUSE_POLL_NS steps. With MAX_SPEED=1 it
+ * registers the deadline with the virtual clock and sleeps on its futex.
+ *
+ * @param state Shared memory state.
+ * @param deadline_ns Deadline on the time_elapsed_ns() timeline.
+ * @param running_flag Optional caller flag (NULL = none), checked after each wakeup.
+ * @return 0 once the deadline passed, -1 if the simulation (or caller) is stopping.
+ */
+int time_sleep_until_elapsed_ns(SharedState *state, int64_t deadline_ns, const int *running_flag);
+
+/**
+ * @brief Arm (us > 0) or cancel (us == 0) a one-shot SIGALRM for this process.
+ *
+ * ualarm() normally. With MAX_SPEED=1 it is a virtual alarm that the Time
+ * Server fires once the virtual clock reaches now + us; a stale alarm may
+ * fire early once, which callers already treat as an ordinary poll.
+ *
+ * @param state Shared memory state.
+ * @param us Microseconds on the time_elapsed_ns() timeline, 0 to cancel.
+ */
+void time_alarm_us(SharedState *state, unsigned int us);
+
+/**
+ * @brief Keep the virtual clock from passing a deadline until renewed (MAX_SPEED=1).
+ *
+ * For a process that polls rather than sleeping in
+ * time_sleep_until_elapsed_ns (the event engine): the clock advances at most
+ * to deadline_ns and stays there until the caller holds again with a later
+ * deadline or releases the hold. No-op without MAX_SPEED.
+ *
+ * @param state Shared memory state.
+ * @param deadline_ns Deadline on the time_elapsed_ns() timeline, < 0 releases.
+ */
+void time_hold_until_elapsed_ns(SharedState *state, int64_t deadline_ns);
+
+/**
+ * @brief Sleep until the virtual clock advances or timeout_ms passes (MAX_SPEED=1).
+ *
+ * @param state Shared memory state.
+ * @param timeout_ms Real milliseconds to wait at most.
+ */
+void time_wait_advance(SharedState *state, int timeout_ms);
+
+/**
+ * @brief Count one more participant about to start (MAX_SPEED=1).
+ *
+ * Called by the starter before fork or pthread_create, so the clock cannot
+ * pass the new participant's start; the new process or thread then calls
+ * time_participant_adopt(). No-op without MAX_SPEED.
+ *
+ * @param state Shared memory state.
+ */
+void time_participant_add(SharedState *state);
+
+/**
+ * @brief Undo time_participant_add() for a start that failed.
+ *
+ * @param state Shared memory state.
+ */
+void time_participant_remove(SharedState *state);
+
+/**
+ * @brief Make the calling thread the participant added for it.
+ *
+ * Its waits count from now on. A forked child starts as no participant,
+ * whatever its parent was.
+ *
+ * @param state Shared memory state.
+ */
+void time_participant_adopt(SharedState *state);
+
+/**
+ * @brief Add and adopt the calling thread in one step.
+ *
+ * For a participant that cannot be outrun while it starts: the workers join
+ * before they report ready, while main itself still holds the clock.
+ *
+ * @param state Shared memory state.
+ */
+void time_participant_join(SharedState *state);
+
+/**
+ * @brief The calling thread stops participating (no-op if it never adopted).
+ *
+ * @param state Shared memory state.
+ */
+void time_participant_leave(SharedState *state);
+
+/**
+ * @brief The calling participant is about to block (nests; no-op otherwise).
+ *
+ * Call right before the blocking call and time_wait_end() right after it,
+ * so a participant is only counted as waiting while it really may sleep.
+ */
+void time_wait_begin(void);
+
+/**
+ * @brief The calling participant runs again after time_wait_begin().
+ */
+void time_wait_end(void);
+
+/**
+ * @brief Convert a simulated time of day to the time_elapsed_ns() timeline.
+ *
+ * @param state Shared memory state.
+ * @param sim_ms Simulated milliseconds from midnight.
+ * @return Pause-adjusted nanoseconds since the start at which the clock shows sim_ms.
+ */
+int64_t time_sim_ms_to_elapsed_ns(const SharedState *state, int64_t sim_ms);
+
 /**
  * @brief Get current simulated time in minutes from midnight.
  *
@@ -36,6 +183,17 @@ int time_get_sim_minutes(SharedState *state);
  */
 double time_get_sim_minutes_f(SharedState *state);
 
+/**
+ * @brief Get current simulated time in milliseconds from midnight.
+ *
+ * Stands still while the simulation is paused (Time Server stops updating it,
+ * or with CLOCK_SOURCE=1 freezes the epoch).
+ *
+ * @param state Shared memory state.
+ * @return Simulated milliseconds from midnight.
+ */
+int64_t time_get_sim_ms(SharedState *state);
+
 /**
  * @brief Check if simulation time has ended (past sim_end_minutes).
  *
@@ -61,6 +219,15 @@ int time_is_closing(SharedState *state);
  */
 double time_sim_to_real_seconds(SharedState *state, int sim_minutes);
 
+/**
+ * @brief Convert simulated milliseconds to real milliseconds.
+ *
+ * @param state Shared memory state with time acceleration factor.
+ * @param sim_ms Duration in simulated milliseconds.
+ * @return Duration in real milliseconds.
+ */
+double time_sim_ms_to_real_ms(SharedState *state, int64_t sim_ms);
+
 /**
  * @brief Sleep for simulated minutes (handles pause via EINTR).
  *
@@ -0,0 +1,124 @@
+#pragma once
+
+/**
+ * @file core/trace.h
+ * @brief Binary event trace (EVENT_TRACE=1): one fixed-size record per stage transition.
+ *
+ * Main creates the trace file before spawning anyone and maps it MAP_SHARED,
+ * so forked workers inherit the mapping; exec'd tourist processes map it
+ * again with trace_attach(). Writers claim a record with one atomic add on
+ * the header cursor and never block or enter the kernel. The file is
+ * append-only: records are never rewritten once published. Readers (see
+ * tools/trace_convert.c) skip records whose source is still 0.
+ */
+
+#include "ipc/shared_state.h"
+
+#include <stdint.h>
+
+#define TRACE_MAGIC "RWTRACE1"
+#define TRACE_VERSION 1
+
+/**
+ * @brief File header (64 bytes, followed by capacity records).
+ */
+typedef struct {
+    char magic[8];                  // TRACE_MAGIC, not NUL-terminated
+    uint32_t version;               // TRACE_VERSION
+    uint32_t record_size;           // sizeof(TraceRecord)
+    uint32_t capacity;              // Record slots in the file while open
+    uint32_t reserved;
+    uint64_t count;                 // Claim cursor (atomic, may exceed capacity)
+    uint64_t records;               // Records kept, set by trace_close() (0 while open)
+    uint64_t dropped;               // Claims past capacity, set by trace_close()
+    int32_t sim_start_minutes;      // Simulation start (minutes from midnight)
+    int32_t sim_end_minutes;        // Simulation end (minutes from midnight)
+    double time_acceleration;       // Sim minutes per real second
+} TraceHeader;
+
+/**
+ * @brief One trace record (24 bytes).
+ */
+typedef struct {
+    int64_t sim_time_ms;            // Simulated ms from midnight
+    int32_t tourist_id;             // Tourist ID (0 = none)
+    int32_t chair_id;               // Chair ID (0 = none)
+    uint16_t event;                 // TouristStage (0-9) or TraceWorkerEvent
+    int16_t gate;                   // Semaphore index of the gate involved (-1 = none)
+    uint16_t source;                // TraceSource, written last (0 = not published)
+    uint16_t count;                 // Tourists involved (family size, riders on chair)
+} TraceRecord;
+
+_Static_assert(sizeof(TraceHeader) == 64, "TraceHeader must stay 64 bytes");
+_Static_assert(sizeof(TraceRecord) == 24, "TraceRecord must stay 24 bytes");
+
+/**
+ * @brief Process that wrote a record.
+ */
+typedef enum {
+    TRACE_SRC_TOURIST = 1,
+    TRACE_SRC_CASHIER = 2,
+    TRACE_SRC_LOWER = 3,
+    TRACE_SRC_UPPER = 4
+} TraceSource;
+
+/**
+ * @brief Worker events (tourist records use TouristStage values).
+ */
+typedef enum {
+    TRACE_TICKET_SOLD = 16,         // Cashier sold a ticket (count = family size)
+    TRACE_CHAIR_DEPARTED = 17,      // Lower worker dispatched a chair (count = riders)
+    TRACE_RIDER_ARRIVED = 18,       // Upper worker received an arrival
+    TRACE_CHAIR_RELEASED = 19,      // Upper worker released the chair slot (count = riders)
+    TRACE_DANGER_DETECTED = 20      // A worker stopped its line for danger (count = line)
+} TraceWorkerEvent;
+
+/**
+ * @brief Create and map the trace file (main process, before spawning).
+ *
+ * Records the absolute path in state->trace_path for trace_attach().
+ *
+ * @param state Shared state (times, trace path).
+ * @param path File to create (truncated if it exists).
+ * @return 0 on success, -1 on error.
+ */
+int trace_create(SharedState *state, const char *path);
+
+/**
+ * @brief Map the trace file created by main (exec'd tourist processes).
+ *
+ * Does nothing if EVENT_TRACE is off or the file is already mapped.
+ *
+ * @param state Attached shared state.
+ * @return 0 on success or when tracing is off, -1 on error.
+ */
+int trace_attach(SharedState *state);
+
+/**
+ * @brief Append one record (no-op when the trace is not mapped).
+ *
+ * @param source TraceSource.
+ * @param event TouristStage or TraceWorkerEvent.
+ * @param tourist_id Tourist ID (0 = none).
+ * @param chair_id Chair ID (0 = none).
+ * @param gate Semaphore index of the gate involved (-1 = none).
+ * @param count Tourists involved.
+ */
+void trace_emit(int source, int event, int tourist_id, int chair_id, int gate, int count);
+
+/**
+ * @brief Append a tourist stage transition; the gate is derived from the stage.
+ *
+ * @param tourist_id Tourist ID.
+ * @param stage New stage.
+ * @param chair_id Chair ID (0 unless boarding or riding).
+ * @param count Family size (parent + kids).
+ */
+void trace_tourist_stage(int tourist_id, TouristStage stage, int chair_id, int count);
+
+/**
+ * @brief Finish the trace: stop new claims, shrink the file to the records kept, unmap.
+ *
+ * Main process only, after every writer has exited.
+ */
+void trace_close(void);
@@ -0,0 +1,115 @@
+#pragma once
+
+/**
+ * @file ipc/control.h
+ * @brief Seqlock-versioned control block (run state and simulated clock).
+ *
+ * Writers are the time server (clock or clock epoch), main (running, closing) and the
+ * worker emergency protocol (emergency_stop, one bit per line, still under
+ * that line's SEM_STATE so that waiter registration stays ordered). Writers serialize on seq with a CAS;
+ * readers never write to the control cache line and never enter the kernel.
+ */
+
+#include "ipc/shared_state.h"
+
+#include <stdint.h>
+
+/**
+ * @brief Consistent copy of every control field.
+ *
+ * Retries while a writer is active, so running, closing, emergency_stop and
+ * the clock all come from the same version.
+ *
+ * @param state Shared state.
+ * @param out Output copy (out->seq is the version that was read).
+ */
+void control_snapshot(const SharedState *state, ControlBlock *out);
+
+/**
+ * @brief Current run flag (one atomic load).
+ *
+ * @param state Shared state.
+ * @return 0 once shutdown has started.
+ */
+int control_running(const SharedState *state);
+
+/**
+ * @brief Current closing flag (one atomic load).
+ *
+ * @param state Shared state.
+ * @return 1 once the station stopped accepting tourists.
+ */
+int control_closing(const SharedState *state);
+
+/**
+ * @brief Current emergency stop flag of one line (one atomic load).
+ *
+ * @param state Shared state.
+ * @param line Line index.
+ * @return 1 while that line's chairlift is stopped.
+ */
+int control_emergency_stop(const SharedState *state, int line);
+
+/**
+ * @brief Publish a new run flag.
+ *
+ * @param state Shared state.
+ * @param running 0 to start shutdown.
+ */
+void control_set_running(SharedState *state, int running);
+
+/**
+ * @brief Publish a new closing flag.
+ *
+ * @param state Shared state.
+ * @param closing 1 to stop accepting tourists.
+ */
+void control_set_closing(SharedState *state, int closing);
+
+/**
+ * @brief Publish a new emergency stop flag for one line (caller holds its SEM_STATE).
+ *
+ * Other lines' bits are left as they are.
+ *
+ * @param state Shared state.
+ * @param line Line index.
+ * @param emergency_stop 1 to stop the chairlift, 0 to resume.
+ */
+void control_set_emergency_stop(SharedState *state, int line, int emergency_stop);
+
+/**
+ * @brief Publish the simulated clock (Time Server only).
+ *
+ * @param state Shared state.
+ * @param sim_ms Simulated milliseconds from midnight.
+ */
+void control_set_sim_time_ms(SharedState *state, int64_t sim_ms);
+
+/**
+ * @brief Consistent copy of the clock epoch.
+ *
+ * @param state Shared state.
+ * @param base_ns Output: CLOCK_MONOTONIC ns at sim_start_minutes.
+ * @param paused_ns Output: CLOCK_MONOTONIC ns the current pause began (0 = running).
+ */
+void control_epoch(const SharedState *state, int64_t *base_ns, int64_t *paused_ns);
+
+/**
+ * @brief Publish a new clock epoch (Time Server only).
+ *
+ * @param state Shared state.
+ * @param base_ns CLOCK_MONOTONIC ns at sim_start_minutes (start plus every pause so far).
+ * @param paused_ns Start of the current pause, 0 when running.
+ */
+void control_set_epoch(SharedState *state, int64_t base_ns, int64_t paused_ns);
+
+/**
+ * @brief Freeze the epoch clock at a pause start (Time Server SIGTSTP handler).
+ *
+ * A single atomic store, so it is async-signal-safe; the base stays as it
+ * is, so readers see a consistent pair with or without the seqlock.
+ *
+ * @param state Shared state.
+ * @param paused_ns CLOCK_MONOTONIC ns the pause began.
+ */
+void control_mark_epoch_paused(SharedState *state, int64_t paused_ns);
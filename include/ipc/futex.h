@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * @file ipc/futex.h
+ * @brief Process-shared futex wait/wake on words in the shm segment.
+ */
+
+#include <stdint.h>
+
+/**
+ * @brief Sleep while *addr == expected (process-shared futex).
+ *
+ * Returns immediately if the word already differs. Interrupted by signals
+ * (EINTR) like a blocking msgrcv, so SIGALRM timeouts keep working.
+ *
+ * @param addr Futex word (must live in shared memory).
+ * @param expected Value the caller last observed.
+ * @param timeout_ms Maximum wait in milliseconds (<= 0 waits forever).
+ * @return 0 when woken, -1 with errno EAGAIN (value changed), ETIMEDOUT or EINTR.
+ */
+int futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms);
+
+/**
+ * @brief Wake up to count waiters sleeping on addr.
+ *
+ * @param addr Futex word.
+ * @param count Maximum number of waiters to wake (INT32_MAX for all).
+ * @return Number of waiters woken, or -1 on error.
+ */
+int futex_wake(uint32_t *addr, int count);
@@ -15,7 +15,7 @@
 // Shared Memory (shm.c)
 // ============================================================================
 
-int ipc_shm_create(IPCResources *res, key_t key, size_t size);
+int ipc_shm_create(IPCResources *res, key_t key, size_t size, int pages);
 int ipc_shm_attach(IPCResources *res, key_t key);
 void ipc_shm_detach(IPCResources *res);
 void ipc_shm_destroy(IPCResources *res);
@@ -26,10 +26,12 @@ void ipc_shm_init_state(IPCResources *res, const Config *cfg);
 // Semaphores (sem.c)
 // ============================================================================
 
-int ipc_sem_create(IPCResources *res, key_t key, const Config *cfg);
-int ipc_sem_attach(IPCResources *res, key_t key);
+int ipc_sem_create(IPCResources *res, int line, key_t key, const Config *cfg);
+int ipc_sem_reset(IPCResources *res, int line, const Config *cfg);
+int ipc_sem_attach(IPCResources *res, int line, key_t key);
 void ipc_sem_destroy(IPCResources *res);
 void ipc_sem_destroy_signal_safe(IPCResources *res);
+void ipc_sem_bind(IPCResources *res);
 
 // ============================================================================
 // Message Queues (mq.c)
@@ -37,5 +39,9 @@ void ipc_sem_destroy_signal_safe(IPCResources *res);
 
 int ipc_mq_create(IPCResources *res, const IPCKeys *keys);
 int ipc_mq_attach(IPCResources *res, const IPCKeys *keys);
+int ipc_mq_create_line(IPCResources *res, int line, const LineKeys *keys);
+int ipc_mq_attach_line(IPCResources *res, int line, const LineKeys *keys);
+int ipc_mq_drain(IPCResources *res);
+int ipc_mq_set_limit(IPCResources *res, int qbytes);
 void ipc_mq_destroy(IPCResources *res);
 void ipc_mq_destroy_signal_safe(IPCResources *res);
@@ -39,6 +39,31 @@ int ipc_cleanup_stale(const IPCKeys *keys);
  */
 int ipc_create(IPCResources *res, const IPCKeys *keys, const Config *cfg);
 
+/**
+ * @brief Shared memory segment size a configuration needs.
+ *
+ * Two configurations with the same size, LINE_COUNT and CASHIER_COUNT can
+ * share one set of IPC resources (see ipc_reset).
+ *
+ * @param cfg Configuration.
+ * @return Size in bytes.
+ */
+size_t ipc_shm_size(const Config *cfg);
+
+/**
+ * @brief Reset existing IPC resources for another run without recreating them.
+ *
+ * Drains every message queue, zeroes the shared state, resets the
+ * semaphores with SETALL and copies cfg in. Only the caller may be attached.
+ * The caller's mapping of the config block stays writable, so each run
+ * gets its own values while the children read them sealed.
+ *
+ * @param res IPC resources from ipc_create.
+ * @param cfg Configuration of the next run (same layout as the created one).
+ * @return 0 on success, -1 on error (layout differs, semctl failed).
+ */
+int ipc_reset(IPCResources *res, const Config *cfg);
+
 /**
  * @brief Attach to existing IPC resources (for child processes).
  *
@@ -48,6 +73,18 @@ int ipc_create(IPCResources *res, const IPCKeys *keys, const Config *cfg);
  */
 int ipc_attach(IPCResources *res, const IPCKeys *keys);
 
+/**
+ * @brief Make the config block (SharedState.cfg) read-only in this process.
+ *
+ * Called by every child after fork or attach; a stray write then faults
+ * instead of changing the run's configuration for everyone. The protection
+ * belongs to the caller's mapping only. Skipped when the segment uses pages
+ * larger than CONFIG_BLOCK_SIZE (SHM_HUGETLB).
+ *
+ * @param res IPC resources (created or attached).
+ */
+void ipc_seal_config(const IPCResources *res);
+
 /**
  * @brief Detach from IPC resources (for child processes before exit).
  *
@@ -72,6 +109,42 @@ void ipc_destroy(IPCResources *res);
  */
 void ipc_cleanup_signal_safe(IPCResources *res);
 
+/**
+ * @brief Point the line-scoped IDs of res at one chairlift line.
+ *
+ * Copies lines[line] into sem_id and the platform, boarding, arrivals and
+ * worker queue IDs. The cashier and spawn queues are shared by all lines.
+ *
+ * @param res IPC resources (created or attached).
+ * @param line Line index 0..res->line_count-1.
+ */
+void ipc_select_line(IPCResources *res, int line);
+
+/**
+ * @brief Point mq_cashier_id at one cashier's request/response queue.
+ *
+ * @param res IPC resources (created or attached).
+ * @param cashier Cashier index 0..res->cashier_count-1.
+ */
+void ipc_select_cashier(IPCResources *res, int cashier);
+
+/**
+ * @brief Queue of the cashier that serves a tourist (tourist_id % CASHIER_COUNT).
+ *
+ * @param res IPC resources.
+ * @param tourist_id Tourist ID.
+ * @return Message queue ID.
+ */
+int ipc_cashier_queue(const IPCResources *res, int tourist_id);
+
+/**
+ * @brief Shared state of the line res currently points at.
+ *
+ * @param res IPC resources.
+ * @return LineState of res->line.
+ */
+LineState *ipc_line_state(const IPCResources *res);
+
 /**
  * @brief Atomically wait (decrement) a semaphore by count.
  *
@@ -106,6 +179,16 @@ int sem_post(int sem_id, int sem_num, int count);
  */
 int sem_trywait(int sem_id, int sem_num);
 
+/**
+ * @brief Non-blocking semaphore wait by count (all or nothing).
+ *
+ * @param sem_id Semaphore set ID.
+ * @param sem_num Semaphore index within the set.
+ * @param count Number of slots to acquire.
+ * @return 0 on success, -1 if would block (errno EAGAIN) or on error.
+ */
+int sem_trywait_count(int sem_id, int sem_num, int count);
+
 /**
  * @brief Semaphore wait with EINTR handling and pause support.
  *
@@ -129,25 +212,55 @@ int sem_wait_pauseable(IPCResources *res, int sem_num, int count);
 int sem_getval(int sem_id, int sem_num);
 
 /**
- * @brief Wait for emergency stop to clear.
+ * @brief Wait for the emergency stop of res's line to clear.
  *
- * Properly tracks emergency_waiters for reliable wakeup.
+ * Properly tracks the line's emergency_waiters for reliable wakeup. With
+ * EMERGENCY_BACKEND=1 it sleeps on the line's emergency_epoch instead, in
+ * SHM_WAIT_TIMEOUT_MS slices so a shutdown still ends the wait.
  *
  * @param res IPC resources.
  */
 void ipc_wait_emergency_clear(IPCResources *res);
 
 /**
- * @brief Release all emergency waiters (called when emergency clears).
+ * @brief Stop res's line through its emergency epoch (EMERGENCY_BACKEND=1).
+ *
+ * One CAS makes the epoch odd; only one worker can win it, so no lock is
+ * needed to pick the initiator. Also sets the line's control emergency bit.
+ *
+ * @param res IPC resources.
+ * @return 1 if the caller stopped the line, 0 if it was already stopped.
+ */
+int ipc_emergency_epoch_stop(IPCResources *res);
+
+/**
+ * @brief Resume res's line: clear the emergency bit, make the epoch even, wake every sleeper.
+ *
+ * One atomic add and, if anyone sleeps on the epoch, one futex wake for all.
+ *
+ * @param res IPC resources.
+ */
+void ipc_emergency_epoch_resume(IPCResources *res);
+
+/**
+ * @brief Release all emergency waiters of res's line (called when emergency clears).
  *
  * @param res IPC resources.
  */
 void ipc_release_emergency_waiters(IPCResources *res);
 
+/**
+ * @brief Remember when the calling worker was forked (for its ready latency).
+ *
+ * @param spawn_ns time_monotonic_ns() taken by the parent before fork().
+ */
+void ipc_note_spawn(int64_t spawn_ns);
+
 /**
  * @brief Signal worker ready for startup synchronization barrier.
  *
- * Workers call this after initialization to signal readiness.
+ * Workers call this after initialization to signal readiness. The worker's
+ * fork and ready times go to a SharedState.startup.ready slot.
  *
  * @param res IPC resources.
  * @return 0 on success, -1 on error.
@@ -157,10 +270,11 @@ int ipc_signal_worker_ready(IPCResources *res);
 /**
  * @brief Wait for all workers to be ready.
  *
- * Main process calls this before spawning tourist generator.
+ * Main process calls this before spawning tourist generator, once per line.
  *
- * @param res IPC resources.
+ * @param res IPC resources (selected line's barrier).
  * @param expected_count Number of workers to wait for.
- * @return 0 on success, -1 on error.
+ * @param timeout_ms Wait cap in milliseconds (> 0).
+ * @return 0 on success, -1 on error or timeout (errno EAGAIN).
  */
-int ipc_wait_workers_ready(IPCResources *res, int expected_count);
+int ipc_wait_workers_ready(IPCResources *res, int expected_count, int timeout_ms);
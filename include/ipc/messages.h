@@ -35,9 +35,10 @@ typedef struct {
     TouristType tourist_type;       // Walker/cyclist
     int slots_needed;               // 1 for walker, 2 for cyclist (includes kids for families)
     int kid_count;                  // Number of kids in family group (0-2)
-    time_t departure_time;          // Real timestamp when chair departed (in boarding confirmation)
+    int64_t departure_ns;           // Chair departure, time_elapsed_ns() (in boarding confirmation)
     int chair_id;                   // Which chair this tourist is on (for tracking)
     int tourists_on_chair;          // Total tourists on this chair
+    uint32_t dispatch_seq;          // Chair dispatch sequence (generation tag for tracking)
 } PlatformMsg;
 
 /**
@@ -50,8 +51,24 @@ typedef struct {
     int kid_count;                  // Number of kids arriving with parent (for logging)
     int chair_id;                   // Which chair arrived (for tracking)
     int tourists_on_chair;          // Total tourists expected from this chair
+    uint32_t dispatch_seq;          // Chair dispatch sequence from the boarding confirmation
 } ArrivalMsg;
 
+/**
+ * @brief Tourist descriptor sent from generator to pooled tourist processes.
+ *
+ * A descriptor with tourist_id == 0 is a sentinel telling the pool member to exit.
+ */
+typedef struct {
+    long mtype;                     // Always 1
+    int tourist_id;                 // 0 = sentinel (pool member exits)
+    int age;
+    TouristType tourist_type;       // Walker/cyclist/family
+    int is_vip;
+    int kid_count;                  // Number of kids (0-2)
+    int ticket_type;                // TicketType requested at cashier
+} TouristSpawnMsg;
+
 /**
  * @brief Message for worker-to-worker emergency communication.
  */
@@ -0,0 +1,80 @@
+#pragma once
+
+/**
+ * @file ipc/numa.h
+ * @brief Huge page size, NUMA node discovery and per-line placement.
+ *
+ * With NUMA_LINES=1 each line's shared regions (its LineState and, with
+ * QUEUE_TRANSPORT=1, its ShmTransport block) get a preferred-node memory
+ * policy (mbind MPOL_PREFERRED), and the line's workers are bound to that
+ * node's CPUs. Line l uses the (l % online nodes)th online node. Only whole
+ * pages inside a region are placed: a page shared with a neighbouring region
+ * keeps the default policy. The syscalls are made directly, so there is no
+ * libnuma dependency; on a kernel without NUMA support placement is skipped.
+ */
+
+#include "ipc/resources.h"
+
+#include <stddef.h>
+
+/**
+ * @brief Default huge page size (`Hugepagesize` in /proc/meminfo).
+ *
+ * @return Size in bytes, 0 if the kernel reports none.
+ */
+size_t numa_huge_page_size(void);
+
+/**
+ * @brief Number of online NUMA nodes.
+ *
+ * @return Node count (1 when /sys/devices/system/node is missing).
+ */
+int numa_node_count(void);
+
+/**
+ * @brief NUMA node that holds a line's regions and runs its workers.
+ *
+ * @param line Line index.
+ * @return Node ID (the (line % node count)th online node).
+ */
+int numa_line_node(int line);
+
+/**
+ * @brief Prefer a node for the whole pages of an address range.
+ *
+ * Pages already touched are moved if only the caller maps them (MPOL_MF_MOVE).
+ *
+ * @param addr Range start.
+ * @param len Range length in bytes.
+ * @param node Preferred node.
+ * @param page_size Page size of the mapping (huge page size for SHM_HUGETLB).
+ * @return Bytes placed (0 if the range holds no whole page), -1 on error.
+ */
+long numa_place_range(void *addr, size_t len, int node, size_t page_size);
+
+/**
+ * @brief Place every line's shared regions on its node (NUMA_LINES=1).
+ *
+ * Sets SharedState.numa_nodes once every line is placed. Called by the
+ * creator after the regions are initialized; failures are logged and leave
+ * the default policy.
+ *
+ * @param res IPC resources of the creator.
+ */
+void numa_place_lines(IPCResources *res);
+
+/**
+ * @brief Bind the calling process to a node's CPUs and prefer its memory.
+ *
+ * @param node Node ID.
+ * @return CPUs in the new affinity mask, -1 on error.
+ */
+int numa_bind_node(int node);
+
+/**
+ * @brief Bind a line worker to its line's node (no-op unless NUMA_LINES=1).
+ *
+ * @param res IPC resources (res->line selects the node).
+ * @param tag Log tag of the worker.
+ */
+void numa_bind_line_worker(const IPCResources *res, const char *tag);
@@ -0,0 +1,76 @@
+#pragma once
+
+/**
+ * @file ipc/queue_stats.h
+ * @brief Queue depth sampling and blocked-sender counts (QueueStats).
+ *
+ * queue_msgsnd() is the msgsnd of every System V sender of the run: it
+ * first tries with IPC_NOWAIT, which costs nothing while there is room,
+ * and counts a blocked send before falling back to the blocking call. The
+ * ring transport counts its full rings the same way. Callers that poll with
+ * IPC_NOWAIT (the event engine) are not counted on each retry: they call
+ * queue_note_blocked() once per send that has to wait. With QUEUE_SAMPLE_MS
+ * > 0 the metrics exporter calls queue_stats_sample() to record depths,
+ * high-water marks and time at full for the metrics file and the report.
+ */
+
+#include "ipc/resources.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/**
+ * @brief Fill level of one queue at one instant.
+ */
+typedef struct {
+    uint32_t messages;
+    uint64_t bytes;                 // Bytes queued (System V only)
+    uint64_t limit_bytes;           // msg_qbytes (0 = ring or mailbox)
+    uint32_t limit_messages;        // Ring slots (0 = System V)
+    int full;                       // 1 if one more message would block its sender
+} QueueSample;
+
+/**
+ * @brief Count one send that found a queue of this kind full.
+ *
+ * @param state Shared state.
+ * @param kind Queue kind.
+ */
+void queue_note_blocked(SharedState *state, QueueKind kind);
+
+/**
+ * @brief msgsnd() (fiber-aware) that counts the sends that have to wait for room.
+ *
+ * Same contract as msgsnd: 0, or -1 with errno (EAGAIN only with IPC_NOWAIT).
+ * With IPC_NOWAIT a full queue is not counted.
+ *
+ * @param state Shared state.
+ * @param kind Kind of the queue msqid.
+ * @param msqid Queue.
+ * @param msgp Message.
+ * @param msgsz Payload size (without mtype).
+ * @param msgflg 0 or IPC_NOWAIT.
+ */
+int queue_msgsnd(SharedState *state, QueueKind kind, int msqid, const void *msgp,
+                 size_t msgsz, int msgflg);
+
+/**
+ * @brief IPC_STAT one System V queue.
+ *
+ * @param msqid Queue.
+ * @param msgsz Payload size of the messages it carries ("full" = no room for one more).
+ * @param out Sample to fill.
+ * @return 0 on success, -1 if the queue is gone (shutdown).
+ */
+int queue_sample_msq(int msqid, size_t msgsz, QueueSample *out);
+
+/**
+ * @brief Sample every queue of the run into state->queue_stats.
+ *
+ * Called by the metrics exporter only. Queues already removed at shutdown
+ * are skipped.
+ *
+ * @param res IPC resources.
+ */
+void queue_stats_sample(IPCResources *res);
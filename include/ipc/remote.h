@@ -0,0 +1,127 @@
+#pragma once
+
+/**
+ * @file ipc/remote.h
+ * @brief Wire protocol between the remote gateway and remote tourist hosts (REMOTE_PORT > 0).
+ *
+ * Every piece of coordination inside a run is System V IPC on one host. The
+ * gateway (processes/remote_gateway.c) is the one door to it from other
+ * hosts: a remote host connects over TCP, receives the run's sim clock
+ * epoch and its share of tourist IDs, and sends arrivals in batches of up
+ * to REMOTE_BATCH_MAX tourists per round trip. The gateway hands each one
+ * to the local pool or engine over MQ_SPAWN, exactly like a generated
+ * tourist, and answers with one acknowledgement carrying the current sim
+ * time, so remote hosts pace their arrivals on the run's clock (paused
+ * time included) and resynchronize on every round trip.
+ *
+ * A frame is a RemoteFrameHeader followed by its payload. Every field is a
+ * 32-bit unsigned integer in network byte order, or bytes, so hosts of any
+ * endianness interoperate. The whole protocol:
+ *
+ *   host -> gateway  REMOTE_MSG_HELLO     RemoteHello
+ *   gateway -> host  REMOTE_MSG_WELCOME   RemoteWelcome
+ *   host -> gateway  REMOTE_MSG_ARRIVALS  count x RemoteTourist (0 = clock query)
+ *   gateway -> host  REMOTE_MSG_ACK       RemoteAck
+ *
+ * Anyone who reaches the gateway can add tourists to the run and take host
+ * slots. So the gateway listens on REMOTE_BIND, which defaults to 127.0.0.1.
+ * To serve other hosts the run has to opt in with an address such as
+ * 0.0.0.0, and then also needs a REMOTE_TOKEN. Every HELLO carries the token,
+ * NUL-padded to REMOTE_TOKEN_LEN bytes. A host whose token does not match
+ * the run's is refused, and so is a connection that sends no HELLO within
+ * REMOTE_HELLO_TIMEOUT_MS. The token is a shared secret, not encryption:
+ * it travels in clear, so use it on trusted networks only.
+ *
+ * tools/remote_tourists.c is the reference remote host.
+ */
+
+#include "constants.h"
+
+#include <stdint.h>
+
+#define REMOTE_MAGIC 0x5257524du           // "RWRM"
+#define REMOTE_VERSION 2                    // 2: token in RemoteHello
+#define REMOTE_BATCH_MAX 64                 // Tourists per ARRIVALS frame
+#define REMOTE_HOST_NAME_LEN 16
+#define REMOTE_MIN_AGE 8                    // Ages a remote tourist may have (as the generator draws)
+#define REMOTE_MAX_AGE 80
+
+/**
+ * @brief Frame types.
+ */
+typedef enum {
+    REMOTE_MSG_HELLO = 1,
+    REMOTE_MSG_WELCOME = 2,
+    REMOTE_MSG_ARRIVALS = 3,
+    REMOTE_MSG_ACK = 4
+} RemoteMsgType;
+
+/**
+ * @brief Flags of a RemoteAck.
+ */
+typedef enum {
+    REMOTE_FLAG_CLOSED = 1              // Station closing or every remote ID used: send no more
+} RemoteAckFlag;
+
+/**
+ * @brief Header of every frame.
+ */
+typedef struct {
+    uint32_t type;                      // RemoteMsgType
+    uint32_t count;                     // RemoteTourist records after an ARRIVALS header, else 0
+} RemoteFrameHeader;
+
+/**
+ * @brief First frame of a remote host.
+ */
+typedef struct {
+    uint32_t magic;                     // REMOTE_MAGIC
+    uint32_t version;                   // REMOTE_VERSION
+    char host[REMOTE_HOST_NAME_LEN];    // Name for the gateway's log (NUL-padded)
+    char token[REMOTE_TOKEN_LEN];       // The run's REMOTE_TOKEN (NUL-padded, all zero if none)
+} RemoteHello;
+
+/**
+ * @brief Sim clock epoch, ID range and population mix of the run.
+ */
+typedef struct {
+    uint32_t version;                   // REMOTE_VERSION
+    uint32_t sim_start_ms;              // Opening time, sim ms since midnight
+    uint32_t sim_end_ms;                // Closing time
+    uint32_t sim_ms;                    // Sim time when the frame was sent
+    uint32_t sim_ms_per_real_s;         // Clock rate while not paused
+    uint32_t first_id;                  // Tourist IDs reserved for remote hosts (shared by all of them)
+    uint32_t last_id;
+    uint32_t batch_max;                 // REMOTE_BATCH_MAX
+    uint32_t vip_percentage;            // The run's mix, for hosts that draw tourists
+    uint32_t walker_percentage;
+    uint32_t family_percentage;
+} RemoteWelcome;
+
+/**
+ * @brief One remote tourist.
+ */
+typedef struct {
+    uint8_t age;                        // REMOTE_MIN_AGE..REMOTE_MAX_AGE
+    uint8_t type;                       // TouristType
+    uint8_t vip;
+    uint8_t kid_count;                  // Families only
+    uint8_t ticket;                     // TicketType
+    uint8_t reserved[3];
+} RemoteTourist;
+
+/**
+ * @brief Answer to one ARRIVALS frame.
+ */
+typedef struct {
+    uint32_t accepted;                  // Tourists handed to the pool or engine
+    uint32_t rejected;                  // Invalid, or sent after REMOTE_FLAG_CLOSED
+    uint32_t sim_ms;                    // Sim time after the batch was queued
+    uint32_t flags;                     // RemoteAckFlag bits
+} RemoteAck;
+
+_Static_assert(sizeof(RemoteFrameHeader) == 8, "RemoteFrameHeader must stay 8 bytes");
+_Static_assert(sizeof(RemoteHello) == 88, "RemoteHello must stay 88 bytes");
+_Static_assert(sizeof(RemoteWelcome) == 44, "RemoteWelcome must stay 44 bytes");
+_Static_assert(sizeof(RemoteTourist) == 8, "RemoteTourist must stay 8 bytes");
+_Static_assert(sizeof(RemoteAck) == 16, "RemoteAck must stay 16 bytes");
@@ -11,8 +11,22 @@
 // IPC Keys Structure
 // ============================================================================
 
+/**
+ * @brief Keys of the objects every chairlift line has its own copy of.
+ */
+typedef struct {
+    key_t sem_key;
+    key_t mq_platform_key;
+    key_t mq_boarding_key;
+    key_t mq_arrivals_key;
+    key_t mq_worker_key;
+} LineKeys;
+
 /**
  * @brief Container for all System V IPC keys.
+ *
+ * The line-scoped fields are line 0's; lines[] holds every line's keys
+ * (lines[0] repeats the line 0 fields).
  */
 typedef struct {
     key_t shm_key;
@@ -22,14 +36,34 @@ typedef struct {
     key_t mq_boarding_key;
     key_t mq_arrivals_key;
     key_t mq_worker_key;
+    key_t mq_spawn_key;
+    key_t mq_cashier_keys[MAX_CASHIERS]; // [0] repeats mq_cashier_key
+    LineKeys lines[MAX_LINES];
 } IPCKeys;
 
 // ============================================================================
 // IPC IDs Structure
 // ============================================================================
 
+/**
+ * @brief IDs of the objects every chairlift line has its own copy of.
+ */
+typedef struct {
+    int sem_id;
+    int mq_platform_id;
+    int mq_boarding_id;
+    int mq_arrivals_id;
+    int mq_worker_id;
+} LineIds;
+
 /**
  * @brief Container for all System V IPC resource IDs and attached shared memory.
+ *
+ * sem_id and the platform/boarding/arrivals/worker queue IDs are a view of
+ * one line (ipc_select_line), so workers and tourists run unchanged on
+ * whichever line they were given. lines[] is the authoritative copy.
+ * Likewise mq_cashier_id is the queue of the cashier a process serves or
+ * talks to (ipc_select_cashier); mq_cashier_ids[] holds every cashier's.
  */
 typedef struct {
     int shm_id;
@@ -39,5 +73,13 @@ typedef struct {
     int mq_boarding_id;
     int mq_arrivals_id;
     int mq_worker_id;
+    int mq_spawn_id;
     SharedState *state;  // Attached shared memory pointer
+    int line;            // Line the view fields above belong to
+    int line_count;      // Lines created or attached
+    LineIds lines[MAX_LINES];
+    int cashier;         // Cashier mq_cashier_id belongs to
+    int cashier_count;   // Cashier queues created or attached
+    int mq_cashier_ids[MAX_CASHIERS];
+    size_t shm_page_size; // Page size of the segment (creator only, see ipc_shm_create)
 } IPCResources;
@@ -6,101 +6,527 @@
  */
 
 #include "constants.h"
+#include "core/config.h"
 
 // ============================================================================
 // Per-Tourist Tracking Entry
 // ============================================================================
 
 /**
- * @brief Tracking entry for a single tourist in shared memory.
+ * @brief Tracking entry for a single tourist in shared memory (8 bytes).
+ *
+ * Indexed by tourist ID - 1, so the ID itself is not stored. Only the
+ * tourist writes its entry; active is set last (release) to publish it.
  */
 typedef struct {
-    int active;                     // 1 if this slot is in use
-    int tourist_id;                 // Tourist ID
-    int ticket_type;                // TicketType
-    int entry_time_sim;             // Simulated time of first entry (minutes from midnight)
-    int total_rides;                // Number of rides completed
-    int is_vip;                     // VIP status
-    TouristType tourist_type;       // Walker/cyclist
-    int kid_count;                  // Number of kids (for family tracking)
+    uint16_t total_rides;           // Number of rides completed (atomic add)
+    uint16_t entry_time_sim;        // Simulated time of first entry (minutes from midnight)
+    uint8_t ticket_type : 3;        // TicketType
+    uint8_t tourist_type : 2;       // TouristType
+    uint8_t is_vip : 1;             // VIP status
+    uint8_t kid_count : 2;          // Number of kids (0-MAX_KIDS_PER_ADULT)
+    uint8_t active;                 // 1 if this slot is in use
+    uint8_t reserved[2];
 } TouristEntry;
 
+// ============================================================================
+// Futex Semaphore
+// ============================================================================
+
+/**
+ * @brief Counting semaphore backed by a futex word (SEM_BACKEND=1).
+ *
+ * One cache line per semaphore: gates, station and chairs are taken by
+ * different tourists at the same time.
+ */
+typedef struct {
+    _Alignas(64) uint32_t value;    // Futex word: available slots
+    uint32_t waiters;               // Processes sleeping on value
+} FutexSem;
+
+// ============================================================================
+// Statistics Shard
+// ============================================================================
+
+/**
+ * @brief One cache line of statistics owned by a single thread or process.
+ *
+ * The owner updates it without read-modify-write atomics. Readers
+ * (report, stats_snapshot) sum all shards.
+ */
+typedef struct {
+    _Alignas(64) uint32_t claimed;  // 1 while owned (slot 0 is always shared)
+    int total_tourists;             // Tourists sold a ticket (parent + kids)
+    int total_rides;                // Rides completed (parent + kids)
+    int rides_by_ticket[TICKET_COUNT];
+    int tourists_by_ticket[TICKET_COUNT];
+} StatsShard;
+
+// ============================================================================
+// Chair Tracker Entry
+// ============================================================================
+
+/**
+ * @brief Arrival tracking for one chair, indexed directly by chair_id - 1.
+ *
+ * Registered by the lower worker at dispatch, counted down by the upper
+ * worker as riders arrive (see core/chair_tracker.h).
+ */
+typedef struct {
+    uint32_t seq;                   // Dispatch sequence of the chair using this ID (0 = never)
+    uint32_t in_transit;            // 1 from dispatch until the last rider arrives
+    int expected;                   // Riders (groups) that boarded
+    int arrived;                    // Riders that reached the upper platform
+} ChairTrack;
+
+/**
+ * @brief One position of the circulating chair ring (CHAIR_INTERVAL_SIM_SECONDS > 0).
+ *
+ * Written by the lower worker as the chair at that position leaves the
+ * lower platform (see core/chair_ring.h).
+ */
+typedef struct {
+    uint32_t trip;                  // Ring departure number of the last trip (0 before the first lap)
+    uint16_t slots;                 // Seats taken on that trip
+    uint16_t riders;                // Groups on that trip
+} ChairRingSlot;
+
+/**
+ * @brief Chair being loaded by a line's boarding workers (BOARDING_WORKERS > 1).
+ *
+ * state packs the whole fill state so one CAS claims capacity: bits 0-7
+ * slots used, 8-15 groups claimed, 16-23 groups whose member ID is written,
+ * bit 24 closed, bits 32-63 the chair's epoch (see core/chair_assembler.h).
+ */
+typedef struct {
+    uint64_t state;                 // Packed fill state (CAS)
+    uint32_t epoch;                 // Futex word: copy of the epoch, set when a chair opens
+    uint32_t waiters;               // Workers sleeping on epoch
+    int chair_id;                   // Chair ID being loaded (written before the chair opens)
+    int members[CHAIR_CAPACITY];    // Tourist ID per claimed group (0 = not written)
+} ChairAssembler;
+
+// ============================================================================
+// Wait-Latency Histogram
+// ============================================================================
+
+/**
+ * @brief Log-linear histogram of wait times for one blocking point.
+ *
+ * Updated lock-free with relaxed atomic adds (see core/latency.h).
+ */
+typedef struct {
+    _Alignas(64) uint64_t count;    // Samples recorded
+    uint64_t sum_us;                // Sum of all samples
+    uint64_t max_us;                // Largest sample (CAS max)
+    uint64_t buckets[LAT_BUCKET_COUNT];
+} LatencyHistogram;
+
+// ============================================================================
+// Tourist Process Exits
+// ============================================================================
+
+/**
+ * @brief Exit accounting of the generator's children (tourists, pool members, hosts).
+ *
+ * Written only by the generator's reaper thread, read by the report after
+ * the generator has exited.
+ */
+typedef struct {
+    _Alignas(64) uint32_t reaped;   // Children reaped
+    uint32_t exit_ok;               // exit(0)
+    uint32_t exit_error;            // exit() with a non-zero status
+    uint32_t killed;                // Terminated by a signal
+    uint32_t wakeups;               // signalfd reads that reaped at least one child
+    uint32_t max_batch;             // Most children reaped in one wakeup
+    LatencyHistogram lifetime;      // Fork to reap, real us (children with a known fork time)
+} TouristExits;
+
+// ============================================================================
+// Process Profile
+// ============================================================================
+
+/**
+ * @brief Resource usage of one process over its run (or of a group of them).
+ *
+ * CPU times and context switches are getrusage() deltas; cycles and
+ * instructions are user-space perf_event_open counts (PERF_COUNTERS=1).
+ */
+typedef struct {
+    pid_t pid;                      // 0 for aggregates
+    int perf_error;                 // 0 = counters read (or not asked for), else the perf_event_open errno
+    int64_t wall_ns;                // Start to exit, real ns
+    int64_t user_us;
+    int64_t sys_us;
+    int64_t voluntary_cs;           // Blocked waiting (semaphore, queue, futex, sleep)
+    int64_t involuntary_cs;         // Preempted
+    int64_t max_rss_kb;             // Largest resident set (largest child's for aggregates)
+    uint64_t cycles;
+    uint64_t instructions;
+} ProcessUsage;
+
+/**
+ * @brief Resource usage of every process of the run, for the report.
+ *
+ * Each worker, helper and the generator claim a usage[] slot with one
+ * atomic add as they exit; the generator adds its reaped children as one
+ * aggregate, and main its own usage and all of its children's before the
+ * report is written.
+ */
+typedef struct {
+    _Alignas(64) uint32_t count;    // usage[] slots claimed (atomic, may exceed PROFILE_MAX_PROCESSES)
+    uint32_t tourist_processes;     // Generator children in tourists (0 = not recorded)
+    ProcessUsage usage[PROFILE_MAX_PROCESSES];
+    ProcessUsage tourists;          // RUSAGE_CHILDREN of the generator: tourists, pool members, hosts
+    ProcessUsage total;             // RUSAGE_SELF + RUSAGE_CHILDREN of main: the whole run
+} ProcessProfile;
+
+// ============================================================================
+// Queue Backpressure
+// ============================================================================
+
+/**
+ * @brief Backpressure of one kind of queue, over every line or cashier.
+ *
+ * Senders count blocked_sends themselves, with one atomic add when a send
+ * finds its queue full (sampling or not). The rest comes from the metrics
+ * exporter's IPC_STAT (or ring) samples every QUEUE_SAMPLE_MS, and only
+ * the exporter writes it. Peaks are those of the fullest single queue of
+ * the kind, since each one has its own limit.
+ */
+typedef struct {
+    _Alignas(64) uint64_t blocked_sends; // Sends that found the queue full (atomic)
+    uint64_t samples;
+    uint64_t full_samples;          // Samples where some queue could not take one more message
+    int64_t full_ns;                // Real time some queue was full (sampling intervals ending full)
+    uint32_t depth;                 // Messages in all queues at the last sample
+    uint32_t high_water;            // Most messages in one queue
+    uint64_t high_water_bytes;      // Most bytes in one queue (System V)
+    uint64_t limit_bytes;           // msg_qbytes of one queue (0 = shm ring or mailbox)
+    uint32_t limit_messages;        // Slots of one ring (0 = System V)
+} QueuePressure;
+
+/**
+ * @brief Backpressure of every queue kind (indexed by QueueKind).
+ */
+typedef struct {
+    int64_t last_sample_ns;         // time_monotonic_ns() of the last sample (0 = none yet)
+    QueuePressure queue[QUEUE_KIND_COUNT];
+} QueueStats;
+
+// ============================================================================
+// Checkpoints
+// ============================================================================
+
+/**
+ * @brief Checkpoints of this run (CHECKPOINT_INTERVAL_SIM_MINUTES > 0).
+ *
+ * Main counts the copies it takes, the writer child it forks for each
+ * records how the file write went (see lifecycle/checkpoint.h).
+ */
+typedef struct {
+    _Alignas(64) uint32_t taken;    // State copies taken by main
+    uint32_t written;               // Files written and renamed into place (writer)
+    uint32_t failed;                // Writers that could not write the file (or fork failed)
+    uint32_t skipped;               // Due while the previous writer was still running
+    uint32_t writer_busy;           // 1 from fork until the writer finishes (atomic)
+    int64_t last_sim_ms;            // Sim time of the last file written
+    uint64_t last_bytes;            // Its size
+    int64_t copy_ns_sum;            // Time main spent copying the state (the run's only stall)
+    int64_t copy_ns_max;
+    int64_t write_ns_max;           // Longest write + fsync in a writer
+} CheckpointStats;
+
+// ============================================================================
+// Danger Schedule
+// ============================================================================
+
+/**
+ * @brief One danger detection (16 bytes, also the DANGER_SCHEDULE_FILE_NAME record).
+ */
+typedef struct {
+    int64_t sim_ms;                 // Sim ms since midnight of the trigger
+    uint16_t line;                  // Chairlift line
+    uint16_t worker;                // WorkerRole that detected it
+    uint32_t reserved;
+} DangerEvent;
+
+/**
+ * @brief Danger detections of this run and the script a replay follows.
+ *
+ * events holds every trigger of the run whatever the mode (claimed with one
+ * atomic add, dropped past DANGER_SCHEDULE_MAX). With DANGER_SCHEDULE=2
+ * script holds the loaded file, read-only after init (see
+ * core/danger_schedule.h).
+ */
+typedef struct {
+    _Alignas(64) uint32_t count;    // Events claimed (atomic, may exceed DANGER_SCHEDULE_MAX)
+    uint32_t dropped;               // Claims past DANGER_SCHEDULE_MAX (atomic)
+    uint32_t script_count;          // Events loaded for replay
+    uint32_t missed;                // Script events skipped, overdue by more than a stop (atomic)
+    DangerEvent events[DANGER_SCHEDULE_MAX];
+    DangerEvent script[DANGER_SCHEDULE_MAX];
+} DangerLog;
+
+// ============================================================================
+// Remote Hosts
+// ============================================================================
+
+/**
+ * @brief Remote gateway counters (REMOTE_PORT > 0), written by the gateway only.
+ *
+ * done tells the generator that no remote tourist will be queued any more
+ * (every remote ID used, station closing, or no gateway), so its pool
+ * sentinels go behind the last remote descriptor.
+ */
+typedef struct {
+    _Alignas(64) uint32_t done;     // 1 once no remote tourist can be queued (atomic, release)
+    uint32_t hosts;                 // Connections that completed the HELLO
+    uint32_t hosts_refused;         // Over REMOTE_MAX_HOSTS, or a bad HELLO
+    uint32_t batches;               // ARRIVALS frames (clock queries included)
+    uint32_t max_batch;             // Most tourists in one frame
+    uint32_t accepted;              // Remote tourists queued
+    uint32_t rejected;              // Invalid, or sent once done
+    int next_id;                    // Next remote tourist ID
+    int64_t batch_ns_sum;           // Frame received to ACK sent, real ns
+    int64_t batch_ns_max;
+} RemoteStats;
+
+// ============================================================================
+// Startup Telemetry
+// ============================================================================
+
+/**
+ * @brief Ready time of one worker (claimed by the worker at the barrier).
+ */
+typedef struct {
+    pid_t pid;
+    int64_t spawn_ns;               // time_monotonic_ns() just before its fork (0 = unknown)
+    int64_t ready_ns;               // time_monotonic_ns() when it signaled the barrier
+} WorkerReady;
+
+/**
+ * @brief Startup stage durations of one run, in nanoseconds.
+ *
+ * The first three stages happen once per process; later sweep runs report
+ * ipc_ns as the ipc_reset() time and the other two as 0.
+ */
+typedef struct {
+    int64_t config_ns;              // Config load, validation, sweep checks
+    int64_t cleanup_ns;             // ipc_cleanup_stale()
+    int64_t ipc_ns;                 // ipc_create() or ipc_reset()
+    int64_t fork_ns;                // First to last fixed-worker fork
+    int64_t ready_ns;               // Last fork until every worker passed the ready barrier
+    int ipc_reset;                  // 1 = ipc_ns measured ipc_reset()
+    uint32_t ready_count;           // ready[] slots claimed (atomic)
+    WorkerReady ready[STARTUP_MAX_WORKERS];
+} StartupTiming;
+
+// ============================================================================
+// Per-Line State
+// ============================================================================
+
+/**
+ * @brief Words written on the hot path of one chairlift line.
+ *
+ * Each of the LINE_COUNT lines has its own lower station, gates, chairs and
+ * worker pair, so its counters, futex semaphores and chair tracker live in
+ * their own cache lines and never contend with another line's.
+ */
+typedef struct {
+    _Alignas(64) int lower_station_count; // Tourists in this lower station (atomic, routing + display)
+    _Alignas(64) int tourists_on_chairs;  // Tourists on this line's chairs (display only)
+    _Alignas(64) uint32_t chair_dispatch_seq; // Last dispatch sequence handed out on this line
+    uint32_t chairs_departed;             // Chairs sent off (atomic, utilization report)
+    uint32_t chair_slots_departed;        // Slots occupied on those chairs (atomic)
+    _Alignas(64) int emergency_waiters;   // Processes waiting on this line's SEM_EMERGENCY_CLEAR (SEM_STATE)
+    uint32_t emergency_epoch;             // Futex word: odd while stopped, +1 on every stop and resume (EMERGENCY_BACKEND=1)
+    uint32_t emergency_sleepers;          // Processes in futex_wait on emergency_epoch (atomic, 0 = skip the wake)
+    FutexSem futex_sems[SEM_COUNT];       // Used for SEM_FUTEX_MASK indices when sem_backend = 1
+    _Alignas(64) ChairTrack chair_tracks[TOTAL_CHAIRS]; // Lower worker registers, upper worker completes
+    _Alignas(64) ChairAssembler assembler; // Chair under construction (BOARDING_WORKERS > 1)
+    _Alignas(64) uint32_t ring_departures; // Cadence mode: chairs departed around the ring (lower worker)
+    uint32_t ring_empty;                  // Of those, chairs that left with no riders
+    uint32_t ring_slots_up;               // Seats taken on the chairs going up (O(1) occupancy)
+    ChairRingSlot chair_ring[TOTAL_CHAIRS]; // Indexed by ring_departures % TOTAL_CHAIRS
+} LineState;
+
+// ============================================================================
+// Virtual Clock (MAX_SPEED=1)
+// ============================================================================
+
+/**
+ * @brief Virtual alarm or hold of one process (VirtualClock.timers).
+ */
+typedef struct {
+    int32_t pid;                    // Owner (0 = free slot, claimed with CAS)
+    uint32_t kind;                  // VirtualTimerKind
+    int64_t deadline_ns;            // On the time_elapsed_ns() timeline
+} VirtualTimer;
+
+/**
+ * @brief Clock the Time Server advances once every participant is blocked.
+ *
+ * now_ns replaces CLOCK_MONOTONIC - epoch as time_elapsed_ns(). Deadline
+ * sleepers lower next_deadline_ns and sleep on generation; the Time Server
+ * jumps to the earliest deadline, alarm or hold once waiting equals
+ * participants (see core/time_sim.h).
+ */
+typedef struct {
+    _Alignas(64) int64_t now_ns;    // Virtual pause-adjusted elapsed time (written by the Time Server)
+    uint32_t generation;            // Futex word bumped on every advance
+    int64_t next_deadline_ns;       // Earliest sleeper deadline since the last advance (CAS min)
+    uint64_t activity;              // Bumped by every sleep, wait, alarm and hold change (atomic)
+    int32_t participants;           // Live workers, generator and tourists (threads) on this clock
+    int32_t waiting;                // Participants blocked in a wait (time_wait_begin/end)
+    uint64_t advances;              // Clock jumps so far (reported)
+    _Alignas(64) VirtualTimer timers[VCLOCK_TIMER_SLOTS];
+} VirtualClock;
+
 // ============================================================================
 // Shared Memory Structure
 // ============================================================================
 
+/**
+ * @brief Run-state flags and simulated clock, read without SEM_STATE.
+ *
+ * Lives in its own cache line so the per-message checks of the workers and
+ * tourists never share a line with counters. The epoch pair is kept under
+ * both clock sources: CLOCK_MONOTONIC - epoch_base_ns is the pause-adjusted
+ * real time since the start (frozen at epoch_paused_ns while the Time Server
+ * is stopped), which ride and trail deadlines use. With CLOCK_SOURCE=1 it is
+ * also the clock (sim_start_minutes plus that time accelerated) instead of
+ * current_sim_time_ms. Every update is bracketed by
+ * seq (odd while a write is in flight, see ipc/control.h); readers needing
+ * several fields at once use control_snapshot(), single fields are one
+ * atomic load.
+ */
+typedef struct {
+    _Alignas(64) uint32_t seq;      // Seqlock version (odd = write in progress)
+    int running;                    // 0 = shutdown
+    int closing;                    // 1 = stop accepting new tourists
+    int emergency_stop;             // Bit per line: 1 = that chairlift is stopped (SIGUSR1)
+    int64_t current_sim_time_ms;    // Current simulated time in milliseconds (CLOCK_SOURCE=0)
+    int64_t epoch_base_ns;          // CLOCK_MONOTONIC at sim_start_minutes, shifted by every pause
+    int64_t epoch_paused_ns;        // CLOCK_MONOTONIC the current pause began (0 = running)
+} ControlBlock;
+
 /**
  * @brief Main shared memory structure containing simulation state.
  *
- * This structure is shared across all processes and protected by semaphores.
- * The tourist_entries flexible array member MUST BE LAST.
+ * Laid out in cache-line-aligned regions so that words written on the hot
+ * path never share a line with words everyone else only reads:
+ * - cfg: the run's Config, copied in once per run and alone on the first
+ *   page, which child processes map read-only (ipc_seal_config());
+ * - setup: read-only after init (time settings, derived values, PIDs);
+ * - control: run flags and sim clock (ControlBlock, seqlock);
+ * - sync: the stats shard hint (rarely written);
+ * - stats: one line per StatsShard;
+ * - lines: one LineState per chairlift line (counters, futex semaphores,
+ *   emergency waiters, chair tracker);
+ * - latency: histograms (own lines);
+ * - tourist_exits, checkpoint: generator reaper and checkpoint counters;
+ * - danger: danger detections and the replay script;
+ * - remote: remote gateway counters;
+ * - vclock: virtual clock and timer slots (MAX_SPEED=1 only);
+ * - tourist table: per-tourist entries (flexible array, MUST BE LAST).
+ *
+ * Region starts are checked by static asserts in ipc/shm.c. Fields are
+ * protected by semaphores, except for the counters marked atomic, which are
+ * only accessed through __atomic builtins, and the statistics shards (see
+ * core/stats.h).
  */
 typedef struct {
+    // ---- Config block (immutable in children, rewritten only by ipc_reset) ----
+    union {
+        Config cfg;                 // Every configuration value of the run
+        char cfg_page[CONFIG_BLOCK_SIZE];
+    };
+
+    // ---- Setup region (read-only after init) ----
     // Time management
-    time_t real_start_time;         // When simulation started (real time)
+    _Alignas(64) time_t real_start_time; // When simulation started (real time)
     int sim_start_minutes;          // 480 = 08:00 (minutes from midnight)
     int sim_end_minutes;            // 1020 = 17:00 (minutes from midnight)
     double time_acceleration;       // Sim minutes per real second
-    int chair_travel_time_sim;      // Simulated minutes for ride
 
-    // Time Server manages this atomically (no locks needed to read)
-    int64_t current_sim_time_ms;    // Current simulated time in milliseconds
+    // Values derived from the config or fixed when the regions are laid out
+    int tourists_to_generate;       // Total number of tourists to generate
+    size_t transport_offset;        // Byte offset of line 0's ShmTransport from segment start (0 = unused)
+    size_t transport_stride;        // Bytes between the ShmTransport blocks of consecutive lines
+    size_t log_offset;              // Byte offset of LogRing from segment start (0 = unused)
+    int event_trace;                // 1 = trace file created (cleared if it cannot be, see core/trace.h)
+    char trace_path[TRACE_PATH_MAX];// Absolute path of the trace file
+    size_t completion_offset;       // Byte offset of CompletionRing from segment start (0 = unused)
+    size_t shm_size;                // Bytes in the whole segment (reported)
+    size_t shm_page_size;           // Page size the segment got (huge page size with SHM_HUGETLB)
+    int cfg_sealed;                 // 1 = children map cfg read-only (pages no larger than CONFIG_BLOCK_SIZE)
+    int numa_nodes;                 // Online NUMA nodes the lines were placed over (0 = not placed)
+    int worker_cpus;                // Cores reserved for fixed workers (WORKER_CPUS, capped by main's mask)
+    int tourist_cpus;               // Cores left to main, helpers and tourists (0 = none, they share the worker cores)
+    size_t schedule_offset;         // Byte offset of ArrivalSchedule from segment start (0 = unused)
+    int arrival_poisson;            // 1 = Poisson arrivals from arrival_rate_hour (any rate > 0)
+    int arrival_rate_hour[ARRIVAL_RATE_HOURS]; // Tourists per sim hour, by hour of the day
+    int restored;                   // 1 = this run continues a checkpoint (--restore)
+    int resume_tourists;            // Tourists spawned before the checkpoint (next ID - 1)
+    int64_t resume_elapsed_ns;      // time_elapsed_ns() at the checkpoint (0 = fresh start)
+    int64_t resume_sim_ms;          // Sim ms since midnight at the checkpoint
 
-    // Simulation state (protected by SEM_STATE)
-    int running;                    // 0 = shutdown
-    int closing;                    // 1 = stop accepting new tourists
-    int emergency_stop;             // 1 = chairlift stopped (SIGUSR1)
-    int emergency_waiters;          // Count of processes waiting on SEM_EMERGENCY_CLEAR
+    // Process IDs for signal handling (written once at spawn)
+    pid_t main_pid;
+    pid_t time_server_pid;
+    pid_t cashier_pid[MAX_CASHIERS];
+    pid_t lower_worker_pid[MAX_LINES];
+    pid_t upper_worker_pid[MAX_LINES];
+    pid_t boarding_worker_pid[MAX_LINES][MAX_BOARDING_WORKERS - 1]; // Extra boarding workers
+    pid_t generator_pid;
+    pid_t log_drainer_pid;          // 0 unless LOG_ASYNC > 0
+    pid_t metrics_pid;              // 0 unless METRICS_INTERVAL_MS or QUEUE_SAMPLE_MS > 0
+    pid_t report_writer_pid;        // 0 unless REPORT_INCREMENTAL=1
+    pid_t gateway_pid;              // 0 unless REMOTE_PORT > 0
 
-    // Statistics (protected by SEM_STATS)
-    int total_tourists;             // Total tourists spawned
-    int total_rides;                // Total rides completed
-    int rides_by_ticket[TICKET_COUNT]; // Rides per ticket type
-    int tourists_by_ticket[TICKET_COUNT]; // Tourists per ticket type
+    // Startup stages and worker ready times (written once per run, reported)
+    StartupTiming startup;
 
-    // For logging/debugging
-    int lower_station_count;        // Current tourists in lower station
-    int tourists_on_chairs;         // Current tourists on chairlift
+    // ---- Control region: sim time (Time Server) and run state (main, emergency protocol) ----
+    ControlBlock control;
 
-    // Config values (read-only after init)
-    int station_capacity;           // Max tourists in lower station
-    int tourists_to_generate;       // Total number of tourists to generate
-    int tourist_spawn_delay_us;     // Delay between spawns in microseconds (0 = no delay)
-    int vip_percentage;             // VIP percentage (0-100)
-    int walker_percentage;          // Walker percentage (0-100)
-    int family_percentage;          // Family percentage of eligible walkers (0-100)
+    // ---- Sync region (rarely written) ----
+    _Alignas(64) uint32_t stats_shard_hint; // Rotating start index for shard claims (atomic)
+    int tourists_spawned;           // Tourist IDs handed out by the generator (atomic, checkpoints)
 
-    // Trail times in simulated minutes
-    int trail_walk_time;
-    int trail_bike_fast_time;
-    int trail_bike_medium_time;
-    int trail_bike_slow_time;
+    // ---- Statistics (sharded, merged by stats_snapshot) ----
+    StatsShard stats_shards[STATS_SHARD_COUNT];
 
-    // Ticket durations in simulated minutes
-    int ticket_t1_duration;
-    int ticket_t2_duration;
-    int ticket_t3_duration;
+    // ---- Chairlift lines (hot counters, futex semaphores, chairs in transit) ----
+    LineState lines[MAX_LINES];
 
-    // Danger detection settings
-    int danger_probability;         // Probability per check (0-100), 0 = disabled
-    int danger_duration_sim;        // Simulated minutes emergency stop lasts
+    // ---- Wait latencies per blocking point (indexed by LatencyStage) ----
+    LatencyHistogram latency[LAT_STAGE_COUNT];
 
-    // Logging settings
-    int debug_logs_enabled;         // 1 = show debug logs, 0 = hide debug logs
+    // ---- Generator children: exit status and lifetime (reaper thread) ----
+    TouristExits tourist_exits;
 
-    // Tourist behavior settings
-    int scared_enabled;             // 1 = tourists can be scared, 0 = disabled
+    // ---- CPU time and context switches per process (written at exit) ----
+    ProcessProfile profile;
 
-    // Process IDs for signal handling
-    pid_t main_pid;
-    pid_t time_server_pid;
-    pid_t cashier_pid;
-    pid_t lower_worker_pid;
-    pid_t upper_worker_pid;
-    pid_t generator_pid;
+    // ---- Queue depths, limits and blocked senders (QUEUE_SAMPLE_MS) ----
+    QueueStats queue_stats;
+
+    // ---- Checkpoint files: copies by main, writes by its writer children ----
+    CheckpointStats checkpoint;
+
+    // ---- Danger detections of this run (DANGER_SCHEDULE replay script) ----
+    DangerLog danger;
+
+    // ---- Remote hosts: tourists queued by the gateway (REMOTE_PORT > 0) ----
+    RemoteStats remote;
+
+    // ---- Virtual clock (MAX_SPEED=1) ----
+    VirtualClock vclock;
 
-    // Per-tourist tracking (flexible array - MUST BE LAST)
-    int max_tracked_tourists;       // Config value for array sizing
+    // ---- Per-tourist tracking (flexible array - MUST BE LAST) ----
+    _Alignas(64) int max_tracked_tourists; // Config value for array sizing
     int tourist_entry_count;        // Number of entries used
     TouristEntry tourist_entries[]; // Flexible array member
 } SharedState;
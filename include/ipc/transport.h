@@ -0,0 +1,244 @@
+#pragma once
+
+/**
+ * @file ipc/transport.h
+ * @brief Platform/boarding/arrivals transport (System V queues or shm rings).
+ *
+ * With QUEUE_TRANSPORT=0 every call maps 1:1 onto msgsnd/msgrcv on
+ * mq_platform_id, mq_boarding_id and mq_arrivals_id. With QUEUE_TRANSPORT=1
+ * the same calls use lock-free rings and per-tourist mailboxes placed after
+ * the tourist table in the shm segment, and only enter the kernel (futex)
+ * when a side actually has to sleep. With BOARDING_BATCH=1 a departing chair
+ * is written once to a chair table and all its riders are woken by a single
+ * futex call. Each line has its own queues or block; calls use the line
+ * res points at (ipc_select_line). Errors mirror msgsnd/msgrcv: -1 with
+ * errno EINTR (signal), EAGAIN (IPC_NOWAIT and full), ENOMSG (IPC_NOWAIT and
+ * empty) or EIDRM (shutdown).
+ */
+
+#include "ipc/resources.h"
+#include "ipc/messages.h"
+#include "ipc/queue_stats.h"
+#include "core/config.h"
+
+#include <stddef.h>
+
+/**
+ * @brief One ring slot (Vyukov bounded queue cell).
+ */
+typedef struct {
+    uint64_t seq;                       // Slot sequence (publish/consume handshake)
+    unsigned char payload[SHM_RING_PAYLOAD];
+} ShmRingSlot;
+
+/**
+ * @brief Bounded multi-producer ring in shared memory.
+ *
+ * Producer and consumer cursors live on separate cache lines.
+ */
+typedef struct {
+    _Alignas(64) uint64_t tail;         // Next slot to claim (producers, CAS)
+    _Alignas(64) uint64_t head;         // Next slot to consume
+    _Alignas(64) uint32_t items;        // Futex word bumped on every push
+    uint32_t space;                     // Futex word bumped on every pop
+    uint32_t item_waiters;              // Consumers sleeping on items
+    uint32_t space_waiters;             // Producers sleeping on space (ring full)
+    ShmRingSlot slots[SHM_RING_CAPACITY];
+} ShmRing;
+
+/**
+ * @brief Single-message boarding mailbox for one tourist.
+ */
+typedef struct {
+    uint32_t full;                      // Futex word: 1 = msg holds an unread confirmation
+    uint32_t waiters;                   // Processes sleeping on full
+    uint32_t chair_ref;                 // BOARDING_BATCH: chair table slot + 1 (0 = none)
+    PlatformMsg msg;
+} ShmMailbox;
+
+/**
+ * @brief One chair departure: who rides and when it left.
+ */
+typedef struct {
+    int chair_id;                       // Chair number (logging/tracking)
+    uint32_t dispatch_seq;              // Generation tag from chair_tracker_register()
+    int64_t departure_ns;               // Departure on the pause-adjusted clock (time_elapsed_ns)
+    int count;                          // Tourists (groups) on the chair
+    int members[CHAIR_CAPACITY];        // Tourist IDs
+} ChairDispatch;
+
+/**
+ * @brief Chair table entry (BOARDING_BATCH=1).
+ */
+typedef struct {
+    uint32_t pending;                   // Riders that have not read the record yet
+    ChairDispatch chair;
+} ShmChairSlot;
+
+/**
+ * @brief Ring transport block placed after the tourist table.
+ */
+typedef struct {
+    ShmRing platform_priority;          // Requeued tourists (mtype 1), drained first
+    ShmRing platform;                   // Tourists ready to board (mtype 2)
+    ShmRing arrivals;                   // Tourists arriving at upper platform
+    _Alignas(64) uint32_t board_epoch;  // Futex word bumped on every batched departure
+    uint32_t board_waiters;             // Tourists sleeping on board_epoch
+    uint32_t chair_cursor;              // Next chair table slot to try (hint, boarding workers)
+    ShmChairSlot chairs[TOTAL_CHAIRS];  // Chair table, reused once every rider has read
+    int mailbox_count;                  // Mailboxes indexed by tourist ID 0..count-1
+    ShmMailbox mailboxes[];
+} ShmTransport;
+
+/**
+ * @brief Channels reported by transport_depth().
+ */
+typedef enum {
+    TRANSPORT_PLATFORM = 0,             // Tourists waiting for the lower worker
+    TRANSPORT_BOARDING = 1,             // Confirmations not yet read by their tourist
+    TRANSPORT_ARRIVALS = 2              // Arrivals not yet read by the upper worker
+} TransportChannel;
+
+/**
+ * @brief Extra shm bytes needed by the ring transport (0 for SysV).
+ *
+ * One ShmTransport block (rings, chair table, mailboxes) per line.
+ *
+ * @param cfg Configuration (QUEUE_TRANSPORT, TOTAL_TOURISTS, LINE_COUNT).
+ * @param base_size Size of SharedState plus tourist table.
+ * @return Bytes to add to the segment so the transport block fits aligned.
+ */
+size_t transport_shm_size(const Config *cfg, size_t base_size);
+
+/**
+ * @brief Initialize every line's ring transport block (main process, after ipc_shm_init_state).
+ *
+ * @param res IPC resources with freshly zeroed shared state.
+ * @param cfg Configuration.
+ * @param base_size Size of SharedState plus tourist table.
+ */
+void transport_init(IPCResources *res, const Config *cfg, size_t base_size);
+
+/**
+ * @brief Wake every process sleeping in the ring transport of any line (shutdown).
+ *
+ * @param res IPC resources.
+ */
+void transport_wake_all(IPCResources *res);
+
+/**
+ * @brief Send a tourist's "ready to board" message to the lower worker.
+ *
+ * @param res IPC resources.
+ * @param msg Message (mtype 1 = priority/requeue, 2 = regular).
+ * @param flags 0 or IPC_NOWAIT.
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_platform_send(IPCResources *res, const PlatformMsg *msg, int flags);
+
+/**
+ * @brief Receive the next platform message, priority (mtype 1) first.
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @return 0 on success, -1 on error (errno as msgrcv).
+ */
+int transport_platform_recv(IPCResources *res, PlatformMsg *msg);
+
+/**
+ * @brief Take the next platform message if one is waiting, priority first.
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @return 0 on success, -1 with errno ENOMSG if none is waiting (or as msgrcv).
+ */
+int transport_platform_try_recv(IPCResources *res, PlatformMsg *msg);
+
+/**
+ * @brief Receive the next platform message, waiting at most timeout_ms.
+ *
+ * Ring mode wakes exactly when a message arrives or the timeout expires.
+ * SysV mode ignores timeout_ms and blocks in msgrcv; the caller bounds the
+ * wait with its own one-shot timer.
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @param timeout_ms Maximum wait in milliseconds (< 0 waits until a message or signal).
+ * @return 0 on success, -1 with errno ETIMEDOUT, EINTR or EIDRM.
+ */
+int transport_platform_recv_timeout(IPCResources *res, PlatformMsg *msg, int timeout_ms);
+
+/**
+ * @brief Send a boarding confirmation to the tourist msg->mtype.
+ *
+ * @param res IPC resources.
+ * @param msg Confirmation (mtype = tourist ID).
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_boarding_send(IPCResources *res, const PlatformMsg *msg);
+
+/**
+ * @brief Confirm boarding for every tourist on a departing chair.
+ *
+ * With BOARDING_BATCH=1 the record is written once to the chair table and
+ * all riders are woken with one futex call; otherwise one confirmation per
+ * rider is sent with transport_boarding_send().
+ *
+ * @param res IPC resources.
+ * @param chair Departing chair.
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_chair_dispatch(IPCResources *res, const ChairDispatch *chair);
+
+/**
+ * @brief Receive this tourist's boarding confirmation.
+ *
+ * @param res IPC resources.
+ * @param tourist_id Tourist ID (mailbox / mtype).
+ * @param msg Output message.
+ * @param flags 0 or IPC_NOWAIT.
+ * @return 0 on success, -1 on error (errno as msgrcv).
+ */
+int transport_boarding_recv(IPCResources *res, int tourist_id, PlatformMsg *msg, int flags);
+
+/**
+ * @brief Notify the upper worker of an arrival.
+ *
+ * @param res IPC resources.
+ * @param msg Arrival message.
+ * @param flags 0 or IPC_NOWAIT.
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_arrival_send(IPCResources *res, const ArrivalMsg *msg, int flags);
+
+/**
+ * @brief Receive the next arrival notification.
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @return 0 on success, -1 on error (errno as msgrcv).
+ */
+int transport_arrival_recv(IPCResources *res, ArrivalMsg *msg);
+
+/**
+ * @brief Messages currently waiting in a channel of res's line (metrics, approximate).
+ *
+ * SysV: msg_qnum from msgctl(IPC_STAT). Ring transport: ring fill level,
+ * and for boarding the unread mailboxes plus unread chair table records.
+ * Lock-free and never blocks.
+ *
+ * @param res IPC resources.
+ * @param channel Channel to measure.
+ * @return Messages waiting, or -1 if the queue is gone (shutdown).
+ */
+int transport_depth(IPCResources *res, TransportChannel channel);
+
+/**
+ * @brief Fill level and limit of one channel (queue sampling).
+ *
+ * @param res IPC resources.
+ * @param channel Channel to measure.
+ * @param out Sample to fill.
+ * @return 0 on success, -1 if the queue is gone (shutdown).
+ */
+int transport_stat(IPCResources *res, TransportChannel channel, QueueSample *out);
@@ -0,0 +1,117 @@
+#pragma once
+
+/**
+ * @file lifecycle/checkpoint.h
+ * @brief Checkpoint files of a running simulation and restore (--restore).
+ *
+ * Every CHECKPOINT_INTERVAL_SIM_MINUTES main copies the state a later run
+ * needs into one private buffer and forks a writer child that writes it to
+ * CHECKPOINT_FILE_NAME (temporary file, fsync, rename). The writer owns a
+ * copy-on-write view of the buffer, so the run only stalls for the memcpy.
+ * SysV shared memory stays shared across fork(), which is why the copy is
+ * taken before the fork and not by the writer. Counters are copied one by
+ * one while the run goes on, so a checkpoint is consistent per counter, not
+ * across counters.
+ *
+ * The file holds the Config, the sim clock, the generator's position, the
+ * merged statistics, per-line chair counters, latency histograms, tourist
+ * exits, the used tourist table and the arrival schedule. What lives in
+ * processes (tourists in flight, their queue messages, chairs carrying
+ * them) cannot be recreated: a restored run starts with empty queues and
+ * chairs, keeps those tourists' table entries as they were and spawns new
+ * tourists from the next ID on. The checkpoint records how many messages
+ * were queued so a restore can say what was lost.
+ */
+
+#include "ipc/resources.h"
+#include "core/arrival_schedule.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#define CHECKPOINT_MAGIC "RWCKPT01"
+#define CHECKPOINT_VERSION 1
+
+/**
+ * @brief Chair counters of one line that carry over to a restored run.
+ */
+typedef struct {
+    uint32_t chair_dispatch_seq;
+    uint32_t chairs_departed;
+    uint32_t chair_slots_departed;
+    uint32_t ring_departures;
+    uint32_t ring_empty;
+    uint32_t reserved;
+} CheckpointLine;
+
+/**
+ * @brief Fixed part of a checkpoint (followed by the tourist entries and descriptors).
+ */
+typedef struct {
+    char magic[8];                  // CHECKPOINT_MAGIC, not NUL-terminated
+    uint32_t version;               // CHECKPOINT_VERSION
+    uint32_t header_size;           // sizeof(CheckpointHeader), a build check
+    uint32_t entry_count;           // TouristEntry records that follow
+    uint32_t schedule_count;        // TouristDescriptor records after them (0 = no schedule)
+    int64_t sim_ms;                 // Sim ms since midnight when the copy was taken
+    int64_t elapsed_ns;             // time_elapsed_ns() at the same moment
+    int32_t tourists_spawned;       // Tourist IDs the generator had handed out
+    uint32_t queued_messages;       // Messages in the SysV queues (not restored)
+    uint64_t queued_bytes;
+    Config cfg;                     // Configuration of the run
+    StatsShard stats;               // All shards merged
+    CheckpointLine lines[MAX_LINES];
+    LatencyHistogram latency[LAT_STAGE_COUNT];
+    TouristExits tourist_exits;
+} CheckpointHeader;
+
+/**
+ * @brief Checkpoint loaded from a file.
+ */
+typedef struct {
+    CheckpointHeader *header;       // Start of the file image
+    const TouristEntry *entries;    // header->entry_count records
+    const TouristDescriptor *schedule; // header->schedule_count records
+    size_t size;                    // Bytes in the image
+} Checkpoint;
+
+/**
+ * @brief Copy the state and fork a writer for CHECKPOINT_FILE_NAME.
+ *
+ * Main only. Skipped (counted) while the previous writer is still running.
+ * The writer is an ordinary child: main's reap_zombies() collects it.
+ *
+ * @param res IPC resources (state and queue IDs).
+ * @param path Checkpoint file path.
+ * @return Writer PID, 0 if skipped, -1 on error.
+ */
+pid_t checkpoint_take(const IPCResources *res, const char *path);
+
+/**
+ * @brief Load and check a checkpoint file.
+ *
+ * @param path Checkpoint file path.
+ * @param out Loaded checkpoint (free with checkpoint_free()).
+ * @return 0 on success, -1 if the file is unreadable or not a checkpoint of this build.
+ */
+int checkpoint_load(const char *path, Checkpoint *out);
+
+/**
+ * @brief Copy a loaded checkpoint into freshly created shared state.
+ *
+ * After ipc_create() and before the run starts. Sets the resume fields
+ * time_init(), the Time Server and the generator continue from.
+ *
+ * @param ckpt Loaded checkpoint.
+ * @param state Shared state created with ckpt->header->cfg.
+ * @return 0 on success, -1 if the checkpoint does not fit the segment.
+ */
+int checkpoint_restore(const Checkpoint *ckpt, SharedState *state);
+
+/**
+ * @brief Release a loaded checkpoint.
+ *
+ * @param ckpt Checkpoint from checkpoint_load().
+ */
+void checkpoint_free(Checkpoint *ckpt);
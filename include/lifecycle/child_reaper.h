@@ -0,0 +1,84 @@
+#pragma once
+
+/**
+ * @file lifecycle/child_reaper.h
+ * @brief Event-loop reaper for the generator's children (signalfd + epoll).
+ *
+ * SIGCHLD is blocked in every thread and read from a signalfd, so coalesced
+ * signals cost one read: each wakeup drains every exited child with
+ * waitid(WNOHANG). A pid-indexed table (private, MAP_NORESERVE) holds each
+ * child's fork time and tourist ID, giving its exit status and lifetime
+ * without a lookup structure shared with the spawning thread. Results go to
+ * SharedState.tourist_exits for the report.
+ *
+ * pidfd_open was not used: one descriptor per live tourist runs into
+ * RLIMIT_NOFILE long before the tens of thousands of tourists a day can hold.
+ */
+
+#include "ipc/shared_state.h"
+
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+/**
+ * @brief Fork time and tourist ID of one live child (pid-indexed).
+ */
+typedef struct {
+    int64_t spawn_ns;               // time_monotonic_ns() before fork (0 = slot free)
+    int tourist_id;                 // 0 for pool members and hosts
+} ChildSlot;
+
+/**
+ * @brief Reaper thread and its descriptors.
+ */
+typedef struct {
+    SharedState *state;             // Receives the exit accounting
+    pthread_t thread;
+    int running;                    // 1 between start and finish
+    int signal_fd;                  // signalfd for SIGCHLD
+    int stop_fd;                    // eventfd: finish() asks for the final drain
+    int epoll_fd;
+    ChildSlot *slots;               // Indexed by PID (NULL: lifetimes not recorded)
+    size_t slot_count;              // pid_max
+    int active;                     // Children tracked and not yet reaped (atomic)
+} ChildReaper;
+
+/**
+ * @brief Start the reaper thread.
+ *
+ * Blocks SIGCHLD in the calling thread first, so call it before any other
+ * thread is created.
+ *
+ * @param reaper Reaper to initialize.
+ * @param state Shared state (tourist_exits).
+ * @return 0 on success, -1 on error.
+ */
+int child_reaper_start(ChildReaper *reaper, SharedState *state);
+
+/**
+ * @brief Record a child forked by the caller.
+ *
+ * @param reaper Reaper.
+ * @param pid Child PID.
+ * @param spawn_ns time_monotonic_ns() taken before fork().
+ * @param tourist_id Tourist ID (0 for pool members and hosts).
+ */
+void child_reaper_track(ChildReaper *reaper, pid_t pid, int64_t spawn_ns, int tourist_id);
+
+/**
+ * @brief Children tracked and not yet reaped.
+ *
+ * @param reaper Reaper.
+ * @return Live child count.
+ */
+int child_reaper_active(const ChildReaper *reaper);
+
+/**
+ * @brief Reap every remaining child, then stop the thread and close its descriptors.
+ *
+ * Blocks until waitid reports no children left.
+ *
+ * @param reaper Reaper.
+ */
+void child_reaper_finish(ChildReaper *reaper);
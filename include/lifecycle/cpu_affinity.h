@@ -0,0 +1,61 @@
+#pragma once
+
+/**
+ * @file lifecycle/cpu_affinity.h
+ * @brief Dedicated cores for the fixed workers (WORKER_CPUS).
+ *
+ * The first WORKER_CPUS cores of main's initial affinity mask are reserved
+ * for the time server, cashiers and line workers, handed out round-robin in
+ * spawn order. Main moves itself to the remaining cores before spawning, so
+ * the helpers, the generator and every tourist inherit them. When no core
+ * is left over, the other processes share the worker cores.
+ */
+
+#include "constants.h"
+
+#include <sched.h>
+
+/**
+ * @brief Core assignment of one run.
+ */
+typedef struct {
+    int worker_count;                   // Reserved cores (0 = no pinning)
+    int worker_cpus[MAX_WORKER_CPUS];   // Reserved core IDs, in assignment order
+    int next;                           // Round-robin cursor into worker_cpus
+    cpu_set_t other_cpus;               // Cores for main, helpers, generator and tourists
+    int shared;                         // 1 = no core left over, other_cpus includes worker cores
+} CpuPlan;
+
+/**
+ * @brief Reserve worker cores from an affinity mask.
+ *
+ * @param plan Plan to fill.
+ * @param allowed Cores main may use (its mask at startup).
+ * @param worker_cpus Cores to reserve (WORKER_CPUS, 0 = none).
+ * @return Cores reserved (fewer than asked if the mask is smaller).
+ */
+int cpu_plan_init(CpuPlan *plan, const cpu_set_t *allowed, int worker_cpus);
+
+/**
+ * @brief Core for the next fixed worker.
+ *
+ * @param plan Plan.
+ * @return Core ID, -1 without pinning.
+ */
+int cpu_plan_next(CpuPlan *plan);
+
+/**
+ * @brief Pin the calling process to one core.
+ *
+ * @param cpu Core ID.
+ * @return 0 on success, -1 on error (errno from sched_setaffinity).
+ */
+int cpu_pin(int cpu);
+
+/**
+ * @brief Switch the calling process to SCHED_FIFO.
+ *
+ * @param priority Real-time priority (1-99).
+ * @return 0 on success, -1 on error (EPERM without CAP_SYS_NICE or RLIMIT_RTPRIO).
+ */
+int cpu_set_fifo(int priority);
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * @file lifecycle/preflight.h
+ * @brief Startup check of the run against kernel IPC limits, rlimits and memory.
+ *
+ * config_validate() only checks that values are in range. A large run can
+ * still die halfway through: a QUEUE_BYTES too small for the platform gate
+ * holders leaves them waiting in msgsnd, a STATION_CAPACITY above SEMVMX
+ * fails the SETALL, and thousands of tourist processes run into
+ * RLIMIT_NPROC. Main calls preflight_run() once stale IPC is cleaned up and
+ * before anything is created or forked. It reads kernel.sem, msg* and shm*,
+ * the /proc/sysvipc tables for what other programs already hold, the task and
+ * descriptor limits and MemAvailable, and estimates what the run needs.
+ * With PREFLIGHT=1 it then raises QUEUE_BYTES (beyond kernel.msgmnb only
+ * with CAP_SYS_RESOURCE), switches the line queues to shm rings, caps tourist processes with a
+ * pool or raises the soft descriptor limit; whatever still does not fit,
+ * and with PREFLIGHT=2 anything that would need changing, fails the run.
+ */
+
+#include "core/config.h"
+
+/**
+ * @brief Check every run of the invocation and adapt it to the host.
+ *
+ * Changes that alter the IPC layout (QUEUE_TRANSPORT) are applied to every
+ * run alike, so sweep runs keep sharing one set of resources.
+ *
+ * @param runs Run configurations (one, or every sweep run).
+ * @param run_count Entries in runs.
+ * @param mode PreflightMode of the invocation.
+ * @return 0 if every run fits (possibly adapted), -1 otherwise (reasons on stderr).
+ */
+int preflight_run(Config *runs, int run_count, int mode);
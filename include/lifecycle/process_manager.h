@@ -20,12 +20,31 @@ pid_t spawn_worker(void (*worker_func)(IPCResources*, IPCKeys*),
                    IPCResources *res, IPCKeys *keys,
                    const char *name);
 
+/**
+ * @brief Spawn a worker process on a dedicated core.
+ *
+ * The child pins itself and switches to SCHED_FIFO before entering
+ * worker_func; a refused setting is logged and the worker runs without it.
+ *
+ * @param worker_func Entry point function for the worker.
+ * @param res IPC resources.
+ * @param keys IPC keys.
+ * @param name Process name for logging.
+ * @param cpu Core to pin to (-1 = inherit main's mask).
+ * @param fifo_priority SCHED_FIFO priority (0 = keep SCHED_OTHER).
+ * @return PID of spawned process, -1 on error.
+ */
+pid_t spawn_worker_pinned(void (*worker_func)(IPCResources*, IPCKeys*),
+                          IPCResources *res, IPCKeys *keys,
+                          const char *name, int cpu, int fifo_priority);
+
 /**
  * @brief Spawn tourist generator process.
  *
  * @param res IPC resources.
  * @param keys IPC keys.
  * @param tourist_exe Path to tourist executable.
+ * @param own_group 1 = generator leads a new process group its tourists inherit (sweeps).
  * @return PID of spawned process, -1 on error.
  */
-pid_t spawn_generator(IPCResources *res, IPCKeys *keys, const char *tourist_exe);
+pid_t spawn_generator(IPCResources *res, IPCKeys *keys, const char *tourist_exe, int own_group);
@@ -5,6 +5,8 @@
  * @brief Zombie process reaping and worker wait functions.
  */
 
+#include <sys/types.h>
+
 /**
  * @brief Reap zombie child processes (non-blocking).
  *
@@ -18,3 +20,26 @@ void reap_zombies(void);
  * Called during shutdown after signaling workers.
  */
 void wait_for_workers(void);
+
+/**
+ * @brief Wait for one worker process to exit (blocking).
+ *
+ * Returns at once if pid <= 0 or the child was already reaped.
+ *
+ * @param pid Child PID.
+ */
+void wait_for_worker(pid_t pid);
+
+/**
+ * @brief Wait for one worker process to exit, killing it after a timeout.
+ *
+ * Used between sweep runs, where no IPC_RMID unblocks stuck processes. With
+ * kill_group the SIGKILL goes to the process group pid leads (generator and
+ * tourists).
+ *
+ * @param pid Child PID (ignored if <= 0).
+ * @param timeout_ms Grace period before SIGKILL.
+ * @param kill_group 1 = SIGKILL the process group, 0 = the process only.
+ * @return 0 if it exited in time, 1 if it had to be killed.
+ */
+int wait_for_worker_timeout(pid_t pid, int timeout_ms, int kill_group);
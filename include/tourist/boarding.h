@@ -6,7 +6,7 @@
  */
 
 #include "tourist/types.h"
-#include <time.h>
+#include <stdint.h>
 
 /**
  * @brief Board chair at lower platform.
@@ -16,13 +16,15 @@
  *
  * @param res IPC resources
  * @param data Tourist data
- * @param departure_time_out Receives the chair's departure timestamp for synchronized arrival
+ * @param departure_ns_out Receives the chair's departure (time_elapsed_ns) for synchronized arrival
  * @param chair_id_out Receives the chair ID for upper worker tracking
  * @param tourists_on_chair_out Receives total tourists on this chair
+ * @param dispatch_seq_out Receives the chair's dispatch sequence (tracker generation tag)
  * @return 0 on success, -1 on failure or shutdown
  */
-int tourist_board_chair(IPCResources *res, TouristData *data, time_t *departure_time_out,
-                        int *chair_id_out, int *tourists_on_chair_out);
+int tourist_board_chair(IPCResources *res, TouristData *data, int64_t *departure_ns_out,
+                        int *chair_id_out, int *tourists_on_chair_out,
+                        uint32_t *dispatch_seq_out);
 
 /**
  * @brief Arrive at upper platform.
@@ -33,7 +35,8 @@ int tourist_board_chair(IPCResources *res, TouristData *data, time_t *departure_
  * @param data Tourist data
  * @param chair_id Which chair this tourist arrived on
  * @param tourists_on_chair Total tourists expected from this chair
+ * @param dispatch_seq Dispatch sequence from the boarding confirmation
  * @return 0 on success, -1 on failure
  */
 int tourist_arrive_upper(IPCResources *res, TouristData *data,
-                         int chair_id, int tourists_on_chair);
+                         int chair_id, int tourists_on_chair, uint32_t dispatch_seq);
@@ -0,0 +1,25 @@
+#pragma once
+
+/**
+ * @file tourist/events.h
+ * @brief Discrete-event tourist engine (TOURIST_ENGINE=2).
+ */
+
+#include "tourist/types.h"
+
+/**
+ * @brief Run all tourists as state records in a single-threaded event loop.
+ *
+ * Tourists received over MQ_SPAWN become lightweight records that move
+ * between TouristStage values. Chair rides and trail descents are timers in
+ * a min-heap keyed on SharedState.control.current_sim_time_ms (so pausing stops
+ * them), and every semaphore/queue operation that could block is issued
+ * with IPC_NOWAIT; a record that would block is parked in a FIFO wait
+ * queue for that resource. Returns once the sentinel has been received and
+ * every record has left, or on shutdown. The caller must have called logger_init().
+ *
+ * @param res Attached IPC resources
+ * @param running_flag Pointer to running flag cleared on SIGTERM/SIGINT
+ * @return Number of tourists served
+ */
+int tourist_events_run(IPCResources *res, int *running_flag);
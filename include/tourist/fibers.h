@@ -0,0 +1,24 @@
+#pragma once
+
+/**
+ * @file tourist/fibers.h
+ * @brief Fiber tourist engine (TOURIST_ENGINE=3).
+ */
+
+#include "tourist/types.h"
+
+/**
+ * @brief Run every tourist as a fiber on FIBER_THREADS scheduler threads.
+ *
+ * Each thread (the caller is the first) takes descriptors from MQ_SPAWN
+ * with IPC_NOWAIT and runs tourist_run() for each on its own fiber
+ * (core/fiber.h), so the tourist code is the same as in the other engines
+ * while thousands of tourists share a few threads. Returns once the
+ * sentinel has been received and every fiber has returned, or on shutdown.
+ * The caller must have called logger_init().
+ *
+ * @param res Attached IPC resources
+ * @param running_flag Pointer to running flag cleared on SIGTERM/SIGINT
+ * @return Number of tourists served, or -1 if no scheduler could be created
+ */
+int tourist_fibers_run(IPCResources *res, int *running_flag);
@@ -11,6 +11,8 @@
  * @brief Parse command line arguments for tourist process.
  *
  * Format: tourist <id> <age> <type> <vip> <kid_count> <ticket_type>
+ * (pool mode "tourist --pool" and the scheduled form "tourist <id>" are
+ * handled by main before this is called)
  *
  * @param argc Argument count
  * @param argv Argument values
@@ -19,6 +21,36 @@
  */
 int tourist_parse_args(int argc, char *argv[], TouristData *data);
 
+/**
+ * @brief Populate tourist data from descriptor fields.
+ *
+ * Shared by argv parsing and pool mode (descriptors received over MQ_SPAWN).
+ * Resets per-tourist progress and derives station/chair slot counts.
+ *
+ * @param data Tourist data to populate
+ * @param id Tourist ID
+ * @param age Tourist age
+ * @param type TouristType value
+ * @param is_vip VIP flag
+ * @param kid_count Number of kids (0-2, families only)
+ * @param ticket_type TicketType value
+ * @return 0 on success, -1 if constraints are violated
+ */
+int tourist_init_data(TouristData *data, int id, int age, int type,
+                      int is_vip, int kid_count, int ticket_type);
+
+/**
+ * @brief Populate tourist data from the arrival schedule (ARRIVAL_SCHEDULE > 0).
+ *
+ * Used when the generator passes only the tourist ID (argv or MQ_SPAWN).
+ *
+ * @param data Tourist data to populate
+ * @param state Shared state holding the schedule
+ * @param id Tourist ID
+ * @return 0 on success, -1 if the ID is not scheduled or constraints are violated
+ */
+int tourist_init_scheduled(TouristData *data, SharedState *state, int id);
+
 /**
  * @brief Get the appropriate logging tag based on tourist type.
  *
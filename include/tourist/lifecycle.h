@@ -38,6 +38,19 @@ int tourist_is_ticket_valid(IPCResources *res, TouristData *data);
  */
 int tourist_is_station_closing(IPCResources *res);
 
+/**
+ * @brief Pick the chairlift line for the next ride and point res at it.
+ *
+ * Least-loaded routing: the line with the fewest tourists in its lower
+ * station wins; ties go to the first line at or after id % LINE_COUNT so a
+ * burst of arrivals spreads over idle lines. No-op for LINE_COUNT=1.
+ *
+ * @param res IPC resources (the tourist's own copy, see tourist_run)
+ * @param data Tourist data
+ * @return Selected line index
+ */
+int tourist_choose_line(IPCResources *res, TouristData *data);
+
 /**
  * @brief Check if tourist is too scared to ride.
  *
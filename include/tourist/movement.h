@@ -6,10 +6,10 @@
  */
 
 #include "tourist/types.h"
-#include <time.h>
+#include <stdint.h>
 
 /**
- * @brief Pause-aware sleep (handles SIGTSTP during sleep).
+ * @brief Pause-aware sleep (absolute deadline on the pause-adjusted clock).
  *
  * @param res IPC resources
  * @param real_seconds Duration to sleep in real seconds
@@ -19,16 +19,16 @@
 int tourist_pauseable_sleep(IPCResources *res, double real_seconds, int *running_flag);
 
 /**
- * @brief Ride the chairlift (synchronized with other passengers via departure_time).
+ * @brief Ride the chairlift (synchronized with other passengers via departure_ns).
  *
  * @param res IPC resources
  * @param data Tourist data
- * @param departure_time Real timestamp when chair departed
+ * @param departure_ns Chair departure (time_elapsed_ns) from the boarding confirmation
  * @param running_flag Pointer to running flag
  * @return 0 on success, -1 if simulation should stop
  */
 int tourist_ride_chairlift(IPCResources *res, TouristData *data,
-                           time_t departure_time, int *running_flag);
+                           int64_t departure_ns, int *running_flag);
 
 /**
  * @brief Walk/bike the trail back down.
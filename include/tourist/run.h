@@ -0,0 +1,23 @@
+#pragma once
+
+/**
+ * @file tourist/run.h
+ * @brief Single tourist lifecycle, shared by exec and pool modes.
+ */
+
+#include "tourist/types.h"
+
+/**
+ * @brief Run one tourist from arrival to exit.
+ *
+ * Creates family threads, buys the ticket, records the entry and runs the
+ * ride loop until the ticket expires, the station closes or shutdown.
+ * Does not attach or detach IPC, so pooled processes and thread hosts can
+ * call it repeatedly (and concurrently). The caller must have called logger_init().
+ *
+ * @param res Attached IPC resources
+ * @param data Tourist data (from tourist_parse_args or tourist_init_data)
+ * @param running_flag Pointer to running flag cleared on SIGTERM/SIGINT
+ * @return 0 on completion, -1 if family threads could not be created
+ */
+int tourist_run(IPCResources *res, TouristData *data, int *running_flag);
@@ -11,6 +11,7 @@
  * @brief Record tourist entry in shared memory for final report.
  *
  * Called once when tourist first enters the system with valid ticket.
+ * Lock-free: only this tourist writes its slot.
  *
  * @param res IPC resources
  * @param data Tourist data
@@ -20,9 +21,22 @@ void tourist_record_entry(IPCResources *res, TouristData *data);
 /**
  * @brief Update statistics for completed ride.
  *
- * Counts rides for parent and all kids in the family.
+ * Counts rides for parent and all kids in the family in this thread's
+ * statistics shard.
  *
  * @param res IPC resources
  * @param data Tourist data
  */
 void tourist_update_stats(IPCResources *res, TouristData *data);
+
+/**
+ * @brief Report a tourist that is leaving (REPORT_INCREMENTAL=1 only).
+ *
+ * Pushes the final entry (rides included) to the completion ring once;
+ * later calls and tourists that never got a ticket are ignored. No-op in
+ * table mode.
+ *
+ * @param res IPC resources
+ * @param data Tourist data
+ */
+void tourist_record_exit(IPCResources *res, TouristData *data);
@@ -23,6 +23,7 @@ typedef struct TouristData {
     int station_slots;       // For lower station: 1 + kid_count (bike doesn't count)
     int chair_slots;         // For chair: walker=1, cyclist=2, plus kid_count
     int kid_count;           // Number of kids (0-2)
+    int entry_time_sim;      // Sim minutes the ticket was sold, -1 before that and once reported
 } TouristData;
 
 /**
@@ -1,5 +1,7 @@
 #include "common/worker_emergency.h"
 #include "ipc/messages.h"
+#include "ipc/control.h"
+#include "ipc/queue_stats.h"
 #include "core/logger.h"
 #include "core/time_sim.h"
 
@@ -36,17 +38,26 @@ static int get_other_dest(WorkerRole role) {
  * @return PID of the other worker.
  */
 static pid_t get_other_pid(IPCResources *res, WorkerRole role) {
-    return (role == WORKER_LOWER) ? res->state->upper_worker_pid : res->state->lower_worker_pid;
+    return (role == WORKER_LOWER) ? res->state->upper_worker_pid[res->line]
+                                  : res->state->lower_worker_pid[res->line];
 }
 
 /**
- * @brief Get the logging tag for this worker.
+ * @brief Get the logging tag of a worker on res's line.
  *
+ * @param res IPC resources (selected line).
  * @param role Worker role (WORKER_LOWER or WORKER_UPPER).
- * @return Logging tag string.
+ * @return Logging tag string (static per process).
  */
-static const char* get_worker_tag(WorkerRole role) {
-    return (role == WORKER_LOWER) ? "LOWER_WORKER" : "UPPER_WORKER";
+const char *worker_log_tag(const IPCResources *res, WorkerRole role) {
+    static char tags[2][24];
+    const char *base = (role == WORKER_LOWER) ? "LOWER_WORKER" : "UPPER_WORKER";
+    if (res->line == 0) {
+        return base;
+    }
+    char *tag = tags[role == WORKER_LOWER ? 0 : 1];
+    snprintf(tag, sizeof(tags[0]), "%s_%d", base, res->line);
+    return tag;
 }
 
 /**
@@ -59,6 +70,18 @@ static const char* get_other_worker_name(WorkerRole role) {
     return (role == WORKER_LOWER) ? "upper worker" : "lower worker";
 }
 
+/**
+ * @brief Block for the next worker message addressed to dest.
+ *
+ * @return 0 on success, -1 on error (errno as msgrcv).
+ */
+static int worker_msgrcv(IPCResources *res, WorkerMsg *msg, int dest) {
+    time_wait_begin();
+    ssize_t ret = msgrcv(res->mq_worker_id, msg, sizeof(*msg) - sizeof(long), dest, 0);
+    time_wait_end();
+    return ret == -1 ? -1 : 0;
+}
+
 /**
  * @brief Initiate emergency stop when danger is detected.
  *
@@ -71,9 +94,23 @@ static const char* get_other_worker_name(WorkerRole role) {
  * @param state Emergency state tracking.
  */
 void worker_trigger_emergency_stop(IPCResources *res, WorkerRole role, WorkerEmergencyState *state) {
-    const char *tag = get_worker_tag(role);
+    const char *tag = worker_log_tag(res, role);
     log_warn(tag, "Danger detected! Attempting to become emergency initiator");
 
+    if (res->state->cfg.emergency_backend == EMERGENCY_BACKEND_FUTEX) {
+        // The epoch CAS picks the initiator; the other worker sees the stop
+        // on its next loop pass, tourists before they board
+        if (!ipc_emergency_epoch_stop(res)) {
+            log_debug(tag, "Line already stopped, becoming receiver");
+            worker_acknowledge_emergency_stop(res, role, state);
+            return;
+        }
+        log_info(tag, "Stopped the line (emergency epoch), becoming initiator");
+        *state->is_initiator = 1;
+        *state->start_time_sim = time_get_sim_minutes_f(res->state);
+        return;
+    }
+
     // Try to acquire emergency lock - only one worker can be initiator
     if (sem_trywait(res->sem_id, SEM_EMERGENCY_LOCK) == -1) {
         // Failed to acquire lock - another worker is already initiator
@@ -95,7 +132,7 @@ void worker_trigger_emergency_stop(IPCResources *res, WorkerRole role, WorkerEme
         sem_post(res->sem_id, SEM_EMERGENCY_LOCK, 1);
         return;
     }
-    res->state->emergency_stop = 1;
+    control_set_emergency_stop(res->state, res->line, 1);
     sem_post(res->sem_id, SEM_STATE, 1);
 
     // Signal other worker about emergency
@@ -116,11 +153,24 @@ void worker_trigger_emergency_stop(IPCResources *res, WorkerRole role, WorkerEme
  * @param state Emergency state tracking.
  */
 void worker_acknowledge_emergency_stop(IPCResources *res, WorkerRole role, WorkerEmergencyState *state) {
-    const char *tag = get_worker_tag(role);
+    const char *tag = worker_log_tag(res, role);
     const char *other_name = get_other_worker_name(role);
     int my_dest = get_my_dest(role);
     int other_dest = get_other_dest(role);
 
+    if (res->state->cfg.emergency_backend == EMERGENCY_BACKEND_FUTEX) {
+        if (!control_emergency_stop(res->state, res->line)) {
+            return;  // Already resumed (or a stray SIGUSR1)
+        }
+        log_warn(tag, "Emergency stop acknowledged from %s", other_name);
+        *state->is_initiator = 0;
+        ipc_wait_emergency_clear(res);
+        if (control_running(res->state)) {
+            log_info(tag, "Chairlift resumed");
+        }
+        return;
+    }
+
     log_warn(tag, "Emergency stop acknowledged from %s", other_name);
 
     *state->is_initiator = 0;
@@ -130,13 +180,13 @@ void worker_acknowledge_emergency_stop(IPCResources *res, WorkerRole role, Worke
         if (errno != EINTR) return;  // Shutdown in progress
         // Kernel handles SIGTSTP automatically
     }
-    res->state->emergency_stop = 1;
+    control_set_emergency_stop(res->state, res->line, 1);
     sem_post(res->sem_id, SEM_STATE, 1);
 
     // Block until detecting worker says we can resume (via message queue)
     log_debug(tag, "Waiting for resume message from %s...", other_name);
     WorkerMsg msg;
-    while (msgrcv(res->mq_worker_id, &msg, sizeof(msg) - sizeof(long), my_dest, 0) == -1) {
+    while (worker_msgrcv(res, &msg, my_dest) == -1) {
         if (errno == EIDRM) return;  // Queue removed, shutdown
         if (errno != EINTR) {
             perror("worker_acknowledge_emergency_stop: msgrcv worker");
@@ -153,7 +203,8 @@ void worker_acknowledge_emergency_stop(IPCResources *res, WorkerRole role, Worke
     // Signal that we're ready to resume (via message queue)
     log_debug(tag, "Signaling ready to resume");
     WorkerMsg response = { .mtype = other_dest, .msg_type = WORKER_MSG_I_AM_READY };
-    if (msgsnd(res->mq_worker_id, &response, sizeof(response) - sizeof(long), 0) == -1) {
+    if (queue_msgsnd(res->state, QUEUE_WORKER, res->mq_worker_id, &response,
+                     sizeof(response) - sizeof(long), 0) == -1) {
         if (errno != EINTR && errno != EIDRM) {
             perror("worker_acknowledge_emergency_stop: msgsnd I_AM_READY");
         }
@@ -165,7 +216,7 @@ void worker_acknowledge_emergency_stop(IPCResources *res, WorkerRole role, Worke
         if (errno != EINTR) return;  // Shutdown in progress
         // Kernel handles SIGTSTP automatically
     }
-    res->state->emergency_stop = 0;
+    control_set_emergency_stop(res->state, res->line, 0);
     sem_post(res->sem_id, SEM_STATE, 1);
 
     log_info(tag, "Chairlift resumed");
@@ -182,7 +233,7 @@ void worker_acknowledge_emergency_stop(IPCResources *res, WorkerRole role, Worke
  * @param state Emergency state tracking.
  */
 void worker_initiate_resume(IPCResources *res, WorkerRole role, WorkerEmergencyState *state) {
-    const char *tag = get_worker_tag(role);
+    const char *tag = worker_log_tag(res, role);
     const char *other_name = get_other_worker_name(role);
     int my_dest = get_my_dest(role);
     int other_dest = get_other_dest(role);
@@ -190,9 +241,17 @@ void worker_initiate_resume(IPCResources *res, WorkerRole role, WorkerEmergencyS
 
     log_info(tag, "Danger resolved, initiating resume");
 
+    if (res->state->cfg.emergency_backend == EMERGENCY_BACKEND_FUTEX) {
+        ipc_emergency_epoch_resume(res);
+        *state->is_initiator = 0;
+        *state->start_time_sim = 0.0;
+        log_info(tag, "Chairlift resumed");
+        return;
+    }
+
     // Send READY_TO_RESUME to receiving worker (via message queue)
     WorkerMsg msg = { .mtype = other_dest, .msg_type = WORKER_MSG_READY_TO_RESUME };
-    if (msgsnd(res->mq_worker_id, &msg, sizeof(msg) - sizeof(long), 0) == -1) {
+    if (queue_msgsnd(res->state, QUEUE_WORKER, res->mq_worker_id, &msg, sizeof(msg) - sizeof(long), 0) == -1) {
         if (errno != EINTR && errno != EIDRM) {
             perror("worker_initiate_resume: msgsnd READY_TO_RESUME");
         }
@@ -202,7 +261,7 @@ void worker_initiate_resume(IPCResources *res, WorkerRole role, WorkerEmergencyS
     // Wait for I_AM_READY response from other worker (via message queue)
     log_debug(tag, "Waiting for %s to be ready...", other_name);
     WorkerMsg response;
-    while (msgrcv(res->mq_worker_id, &response, sizeof(response) - sizeof(long), my_dest, 0) == -1) {
+    while (worker_msgrcv(res, &response, my_dest) == -1) {
         if (errno == EIDRM) return;  // Queue removed, shutdown
         if (errno != EINTR) {
             perror("worker_initiate_resume: msgrcv I_AM_READY");
@@ -226,7 +285,7 @@ void worker_initiate_resume(IPCResources *res, WorkerRole role, WorkerEmergencyS
         if (errno != EINTR) return;  // Shutdown in progress
         // Kernel handles SIGTSTP automatically
     }
-    res->state->emergency_stop = 0;
+    control_set_emergency_stop(res->state, res->line, 0);
     sem_post(res->sem_id, SEM_STATE, 1);
 
     // Release any tourist waiters
@@ -0,0 +1,151 @@
+/**
+ * @file core/arrival_schedule.c
+ * @brief Precomputed tourist descriptors in shared memory (ARRIVAL_SCHEDULE > 0).
+ */
+
+#include "core/arrival_schedule.h"
+#include "core/logger.h"
+
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert(sizeof(TouristDescriptor) == 16, "TouristDescriptor must stay 16 bytes");
+
+/**
+ * @brief Cache-line aligned offset of the schedule.
+ */
+static size_t arrival_schedule_offset_for(size_t base_size) {
+    return (base_size + 63) & ~(size_t)63;
+}
+
+size_t arrival_schedule_shm_size(const Config *cfg, size_t base_size) {
+    if (cfg->arrival_schedule == ARRIVAL_SCHEDULE_OFF) {
+        return 0;
+    }
+    return (arrival_schedule_offset_for(base_size) - base_size) + sizeof(ArrivalSchedule) +
+           (size_t)cfg->total_tourists * sizeof(TouristDescriptor);
+}
+
+/**
+ * @brief Check one loaded descriptor (position and value ranges).
+ *
+ * @return 1 if usable, 0 otherwise.
+ */
+static int descriptor_valid(const TouristDescriptor *d, uint32_t index) {
+    return d->id == (int32_t)index + 1 && d->type <= TOURIST_FAMILY &&
+           d->ticket < TICKET_COUNT && d->vip <= 1 && d->kid_count <= MAX_KIDS_PER_ADULT;
+}
+
+/**
+ * @brief Load ARRIVAL_SCHEDULE_FILE_NAME into the schedule block.
+ *
+ * @return Descriptors loaded, or -1 on error.
+ */
+static long arrival_schedule_load(ArrivalSchedule *schedule, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror("arrival_schedule: fopen");
+        return -1;
+    }
+
+    ArrivalScheduleFileHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        memcmp(header.magic, ARRIVAL_SCHEDULE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != ARRIVAL_SCHEDULE_VERSION ||
+        header.record_size != sizeof(TouristDescriptor)) {
+        fprintf(stderr, "arrival_schedule: %s is not a schedule file of this build\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    uint32_t count = header.count;
+    if (count > schedule->capacity) {
+        log_warn("IPC", "Arrival schedule holds %u tourists, replaying the first %u",
+                 count, schedule->capacity);
+        count = schedule->capacity;
+    }
+    if (fread(schedule->tourists, sizeof(TouristDescriptor), count, f) != count) {
+        fprintf(stderr, "arrival_schedule: %s is truncated\n", path);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    for (uint32_t i = 0; i < count; i++) {
+        if (!descriptor_valid(&schedule->tourists[i], i)) {
+            fprintf(stderr, "arrival_schedule: %s: invalid descriptor %u\n", path, i + 1);
+            return -1;
+        }
+    }
+    return (long)count;
+}
+
+int arrival_schedule_init(SharedState *state, const Config *cfg, size_t base_size) {
+    if (cfg->arrival_schedule == ARRIVAL_SCHEDULE_OFF) {
+        state->schedule_offset = 0;
+        return 0;
+    }
+    state->schedule_offset = arrival_schedule_offset_for(base_size);
+    ArrivalSchedule *schedule = arrival_schedule_get(state);
+    schedule->capacity = (uint32_t)cfg->total_tourists;
+
+    if (cfg->arrival_schedule == ARRIVAL_SCHEDULE_REPLAY) {
+        long count = arrival_schedule_load(schedule, ARRIVAL_SCHEDULE_FILE_NAME);
+        if (count == -1) {
+            return -1;
+        }
+        if (count < cfg->total_tourists) {
+            state->tourists_to_generate = (int)count;
+        }
+        arrival_schedule_publish(schedule, (uint32_t)count);
+        log_debug("IPC", "Loaded arrival schedule: %ld tourists from %s",
+                  count, ARRIVAL_SCHEDULE_FILE_NAME);
+    }
+    return 0;
+}
+
+ArrivalSchedule *arrival_schedule_get(SharedState *state) {
+    if (state == NULL || state->cfg.arrival_schedule == ARRIVAL_SCHEDULE_OFF ||
+        state->schedule_offset == 0) {
+        return NULL;
+    }
+    return (ArrivalSchedule *)((char *)state + state->schedule_offset);
+}
+
+const TouristDescriptor *arrival_schedule_lookup(SharedState *state, int id) {
+    ArrivalSchedule *schedule = arrival_schedule_get(state);
+    if (schedule == NULL || !__atomic_load_n(&schedule->ready, __ATOMIC_ACQUIRE) ||
+        id < 1 || (uint32_t)id > schedule->count) {
+        return NULL;
+    }
+    return &schedule->tourists[id - 1];
+}
+
+void arrival_schedule_publish(ArrivalSchedule *schedule, uint32_t count) {
+    schedule->count = count;
+    __atomic_store_n(&schedule->ready, 1, __ATOMIC_RELEASE);
+}
+
+int arrival_schedule_save(const ArrivalSchedule *schedule, const char *path) {
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        perror("arrival_schedule: fopen");
+        return -1;
+    }
+
+    ArrivalScheduleFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, ARRIVAL_SCHEDULE_MAGIC, sizeof(header.magic));
+    header.version = ARRIVAL_SCHEDULE_VERSION;
+    header.record_size = sizeof(TouristDescriptor);
+    header.count = schedule->count;
+
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+             fwrite(schedule->tourists, sizeof(TouristDescriptor), schedule->count, f) ==
+                 schedule->count;
+    if (fclose(f) != 0 || !ok) {
+        perror("arrival_schedule: write");
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,115 @@
+/**
+ * @file core/chair_assembler.c
+ * @brief Lock-free chair under construction shared by a line's boarding workers.
+ */
+
+#include "core/chair_assembler.h"
+#include "ipc/futex.h"
+#include "core/time_sim.h"
+
+#include <sched.h>
+
+// Packed ChairAssembler.state fields
+#define ASM_SLOTS(w) ((int)((w) & 0xff))
+#define ASM_GROUPS(w) ((int)(((w) >> 8) & 0xff))
+#define ASM_COMMITTED(w) ((int)(((w) >> 16) & 0xff))
+#define ASM_CLOSED (UINT64_C(1) << 24)
+#define ASM_GROUP_ONE (UINT64_C(1) << 8)
+#define ASM_COMMIT_ONE (UINT64_C(1) << 16)
+#define ASM_EPOCH(w) ((uint32_t)((w) >> 32))
+
+ChairClaimResult chair_assembler_claim(ChairAssembler *a, int tourist_id, int slots,
+                                       ChairClaim *out) {
+    uint64_t w = __atomic_load_n(&a->state, __ATOMIC_ACQUIRE);
+
+    while (1) {
+        out->epoch = ASM_EPOCH(w);
+        if (w & ASM_CLOSED) {
+            return CHAIR_CLAIM_BUSY;
+        }
+
+        if (ASM_SLOTS(w) + slots > CHAIR_CAPACITY) {
+            // Does not fit: close the partial chair, the caller sends it off
+            if (__atomic_compare_exchange_n(&a->state, &w, w | ASM_CLOSED, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                return CHAIR_CLAIM_NO_FIT;
+            }
+            continue;
+        }
+
+        uint64_t next = w + (uint64_t)slots + ASM_GROUP_ONE;
+        int filled = ASM_SLOTS(w) + slots == CHAIR_CAPACITY;
+        if (filled) {
+            next |= ASM_CLOSED;
+        }
+        if (__atomic_compare_exchange_n(&a->state, &w, next, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            // Seat index is ours; read the chair before the commit lets it leave
+            out->chair_id = a->chair_id;
+            out->slots_used = ASM_SLOTS(next);
+            __atomic_store_n(&a->members[ASM_GROUPS(w)], tourist_id, __ATOMIC_RELAXED);
+            __atomic_add_fetch(&a->state, ASM_COMMIT_ONE, __ATOMIC_RELEASE);
+            return filled ? CHAIR_CLAIM_FILLED : CHAIR_CLAIM_BOARDED;
+        }
+        // w reloaded by the failed CAS
+    }
+}
+
+int chair_assembler_close(ChairAssembler *a) {
+    uint64_t w = __atomic_load_n(&a->state, __ATOMIC_ACQUIRE);
+    while (!(w & ASM_CLOSED) && ASM_GROUPS(w) > 0) {
+        if (__atomic_compare_exchange_n(&a->state, &w, w | ASM_CLOSED, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int chair_assembler_take(ChairAssembler *a, int *chair_id_out, int *members_out, int *slots_out) {
+    uint64_t w = __atomic_load_n(&a->state, __ATOMIC_ACQUIRE);
+    for (int spins = 0; ASM_COMMITTED(w) < ASM_GROUPS(w) && spins < CHAIR_COMMIT_SPINS; spins++) {
+        sched_yield();
+        w = __atomic_load_n(&a->state, __ATOMIC_ACQUIRE);
+    }
+
+    int count = 0;
+    for (int i = 0; i < ASM_GROUPS(w); i++) {
+        int id = __atomic_load_n(&a->members[i], __ATOMIC_RELAXED);
+        if (id > 0) {
+            members_out[count++] = id;
+        }
+    }
+    *chair_id_out = a->chair_id;
+    *slots_out = ASM_SLOTS(w);
+    return count;
+}
+
+void chair_assembler_open(ChairAssembler *a, int chair_id) {
+    uint32_t epoch = ASM_EPOCH(__atomic_load_n(&a->state, __ATOMIC_RELAXED)) + 1;
+
+    a->chair_id = chair_id;
+    for (int i = 0; i < CHAIR_CAPACITY; i++) {
+        __atomic_store_n(&a->members[i], 0, __ATOMIC_RELAXED);
+    }
+    // Publish: a claim that sees the new epoch also sees chair_id and cleared seats
+    __atomic_store_n(&a->state, (uint64_t)epoch << 32, __ATOMIC_RELEASE);
+    __atomic_store_n(&a->epoch, epoch, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&a->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&a->epoch, INT32_MAX);
+    }
+}
+
+void chair_assembler_wait(ChairAssembler *a, uint32_t epoch, int timeout_ms) {
+    __atomic_add_fetch(&a->waiters, 1, __ATOMIC_SEQ_CST);
+    // The chair reopens with epoch + 1; the copy may still lag at epoch - 1
+    uint32_t seen = __atomic_load_n(&a->epoch, __ATOMIC_SEQ_CST);
+    if (seen == epoch) {
+        time_wait_begin();
+        futex_wait(&a->epoch, epoch, timeout_ms);
+        time_wait_end();
+    } else if (seen == epoch - 1) {
+        sched_yield();
+    }
+    __atomic_sub_fetch(&a->waiters, 1, __ATOMIC_SEQ_CST);
+}
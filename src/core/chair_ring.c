@@ -0,0 +1,41 @@
+/**
+ * @file core/chair_ring.c
+ * @brief Circulating chair ring for cadence departures (CHAIR_INTERVAL_SIM_SECONDS > 0).
+ */
+
+#include "core/chair_ring.h"
+
+int chair_ring_transit(const Config *cfg) {
+    int ride_s = cfg->chair_travel_time_sim * 60;
+    int transit = (ride_s + cfg->chair_interval_sim - 1) / cfg->chair_interval_sim;
+    return transit > 0 ? transit : 1;
+}
+
+int chair_ring_platform_chair(const LineState *line) {
+    uint32_t pos = __atomic_load_n(&line->ring_departures, __ATOMIC_RELAXED);
+    return (int)(pos % TOTAL_CHAIRS) + 1;
+}
+
+int chair_ring_depart(LineState *line, int transit, int slots, int riders) {
+    uint32_t pos = line->ring_departures;
+    ChairRingSlot *slot = &line->chair_ring[pos % TOTAL_CHAIRS];
+    slot->trip = pos + 1;           // 0 stays "never departed"
+    slot->slots = (uint16_t)slots;
+    slot->riders = (uint16_t)riders;
+
+    // The chair that left transit positions ago reaches the top now
+    uint32_t up = line->ring_slots_up + (uint32_t)slots;
+    if (pos >= (uint32_t)transit) {
+        up -= line->chair_ring[(pos - (uint32_t)transit) % TOTAL_CHAIRS].slots;
+    }
+    __atomic_store_n(&line->ring_slots_up, up, __ATOMIC_RELAXED);
+    if (slots == 0) {
+        __atomic_add_fetch(&line->ring_empty, 1, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&line->ring_departures, pos + 1, __ATOMIC_RELEASE);
+    return (int)(pos % TOTAL_CHAIRS) + 1;
+}
+
+uint32_t chair_ring_slots_up(const LineState *line) {
+    return __atomic_load_n(&line->ring_slots_up, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,61 @@
+/**
+ * @file core/chair_tracker.c
+ * @brief O(1) tracking of chairs in transit for SEM_CHAIRS release.
+ */
+
+#include "core/chair_tracker.h"
+
+uint32_t chair_tracker_register(ChairTrack *tracks, uint32_t *seq_counter,
+                                int chair_id, int expected) {
+    if (chair_id < 1 || chair_id > TOTAL_CHAIRS) {
+        return 0;
+    }
+
+    uint32_t seq = __atomic_add_fetch(seq_counter, 1, __ATOMIC_RELAXED);
+    if (seq == 0) {
+        seq = __atomic_add_fetch(seq_counter, 1, __ATOMIC_RELAXED);  // 0 means "never"
+    }
+
+    ChairTrack *track = &tracks[chair_id - 1];
+    track->expected = expected;
+    track->arrived = 0;
+    __atomic_store_n(&track->seq, seq, __ATOMIC_RELAXED);
+    // Publish: an arrival that sees in_transit also sees seq/expected
+    __atomic_store_n(&track->in_transit, 1, __ATOMIC_RELEASE);
+    return seq;
+}
+
+int chair_tracker_arrive(ChairTrack *tracks, int chair_id, uint32_t seq,
+                         int *arrived_out, int *expected_out) {
+    if (chair_id < 1 || chair_id > TOTAL_CHAIRS) {
+        return -1;
+    }
+
+    ChairTrack *track = &tracks[chair_id - 1];
+    if (!__atomic_load_n(&track->in_transit, __ATOMIC_ACQUIRE) || track->seq != seq) {
+        return -1;
+    }
+
+    track->arrived++;
+    if (arrived_out) *arrived_out = track->arrived;
+    if (expected_out) *expected_out = track->expected;
+
+    if (track->arrived < track->expected) {
+        return 0;
+    }
+
+    // Hand the ID back to the lower worker
+    __atomic_store_n(&track->in_transit, 0, __ATOMIC_RELEASE);
+    return 1;
+}
+
+int chair_tracker_next_id(const ChairTrack *tracks, int chair_id) {
+    int next = chair_id;
+    for (int n = 0; n < TOTAL_CHAIRS; n++) {
+        next = (next % TOTAL_CHAIRS) + 1;
+        if (!__atomic_load_n(&tracks[next - 1].in_transit, __ATOMIC_ACQUIRE)) {
+            return next;
+        }
+    }
+    return (chair_id % TOTAL_CHAIRS) + 1;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file core/completion_ring.c
+ * @brief Shared-memory ring of finished tourists drained by the report writer (REPORT_INCREMENTAL=1).
+ */
+
+#include "core/completion_ring.h"
+#include "ipc/futex.h"
+
+_Static_assert((COMPLETION_RING_CAPACITY & (COMPLETION_RING_CAPACITY - 1)) == 0,
+               "COMPLETION_RING_CAPACITY must be a power of two");
+
+/**
+ * @brief Cache-line aligned offset of the ring.
+ */
+static size_t completion_ring_offset_for(size_t base_size) {
+    return (base_size + 63) & ~(size_t)63;
+}
+
+size_t completion_ring_shm_size(const Config *cfg, size_t base_size) {
+    if (!cfg->report_incremental) {
+        return 0;
+    }
+    return (completion_ring_offset_for(base_size) - base_size) + sizeof(CompletionRing);
+}
+
+void completion_ring_init(SharedState *state, const Config *cfg, size_t base_size) {
+    if (!cfg->report_incremental) {
+        state->completion_offset = 0;
+        return;
+    }
+    state->completion_offset = completion_ring_offset_for(base_size);
+    CompletionRing *ring = completion_ring_get(state);
+    for (uint64_t i = 0; i < COMPLETION_RING_CAPACITY; i++) {
+        ring->slots[i].seq = i;
+    }
+}
+
+CompletionRing *completion_ring_get(SharedState *state) {
+    if (state == NULL || !state->cfg.report_incremental || state->completion_offset == 0) {
+        return NULL;
+    }
+    return (CompletionRing *)((char *)state + state->completion_offset);
+}
+
+/**
+ * @brief Try to claim one slot (lock-free, multi-producer).
+ *
+ * @return Slot, or NULL if the ring is full.
+ */
+static CompletionRecord *ring_try_claim(CompletionRing *ring, uint64_t *pos_out) {
+    uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    while (1) {
+        CompletionRecord *rec = &ring->slots[pos & (COMPLETION_RING_CAPACITY - 1)];
+        uint64_t seq = __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *pos_out = pos;
+                return rec;
+            }
+        } else if (diff < 0) {
+            return NULL;  // Slot not drained yet: full
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+int completion_ring_push(CompletionRing *ring, int id, const TouristEntry *entry) {
+    uint64_t pos;
+    CompletionRecord *rec = ring_try_claim(ring, &pos);
+
+    // Unlike log lines a completion is never dropped while the writer runs
+    while (rec == NULL && __atomic_load_n(&ring->writer_alive, __ATOMIC_ACQUIRE) &&
+           !__atomic_load_n(&ring->stop, __ATOMIC_ACQUIRE)) {
+        __atomic_add_fetch(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t observed = __atomic_load_n(&ring->space, __ATOMIC_SEQ_CST);
+        rec = ring_try_claim(ring, &pos);
+        if (rec == NULL) {
+            futex_wait(&ring->space, observed, SHM_WAIT_TIMEOUT_MS);
+            rec = ring_try_claim(ring, &pos);
+        }
+        __atomic_sub_fetch(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+    }
+
+    if (rec == NULL) {
+        __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+        return -1;
+    }
+
+    rec->id = id;
+    rec->entry = *entry;
+    __atomic_store_n(&rec->seq, pos + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->item_waiters, __ATOMIC_SEQ_CST) > 0) {
+        __atomic_add_fetch(&ring->items, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&ring->items, 1);
+    }
+    return 0;
+}
+
+CompletionRecord *completion_ring_peek(CompletionRing *ring) {
+    uint64_t pos = ring->head;
+    CompletionRecord *rec = &ring->slots[pos & (COMPLETION_RING_CAPACITY - 1)];
+    if (__atomic_load_n(&rec->seq, __ATOMIC_SEQ_CST) != pos + 1) {
+        return NULL;  // Not yet published: empty
+    }
+    return rec;
+}
+
+void completion_ring_release(CompletionRing *ring, CompletionRecord *rec) {
+    uint64_t pos = ring->head;
+    ring->head = pos + 1;
+    __atomic_store_n(&rec->seq, pos + COMPLETION_RING_CAPACITY, __ATOMIC_RELEASE);
+    if (__atomic_load_n(&ring->space_waiters, __ATOMIC_SEQ_CST) > 0) {
+        __atomic_add_fetch(&ring->space, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&ring->space, INT32_MAX);
+    }
+}
+
+int completion_ring_skip_stalled(CompletionRing *ring) {
+    uint64_t pos = ring->head;
+    if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == pos) {
+        return 0;  // Empty, nothing claimed
+    }
+    CompletionRecord *rec = &ring->slots[pos & (COMPLETION_RING_CAPACITY - 1)];
+    uint64_t claimed = pos;
+    if (!__atomic_compare_exchange_n(&rec->seq, &claimed, pos + COMPLETION_RING_CAPACITY, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        return 0;  // Published in the meantime, or not claimed yet
+    }
+    ring->head = pos + 1;
+    __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+    return 1;
+}
+
+void completion_ring_stop(CompletionRing *ring) {
+    __atomic_store_n(&ring->stop, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&ring->items, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&ring->items, INT32_MAX);
+    futex_wake(&ring->space, INT32_MAX);
+}
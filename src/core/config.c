@@ -4,10 +4,14 @@
  */
 
 #include "core/config.h"
+#include "constants.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
 #include <errno.h>
+#include <arpa/inet.h>
 
 /**
  * @brief Initialize configuration with default values.
@@ -16,15 +20,40 @@
  */
 void config_set_defaults(Config *cfg) {
     cfg->station_capacity = 50;
+    cfg->line_count = 1;                   // One chairlift line
+    cfg->cashier_count = 1;                // One cashier serves everyone
+    cfg->cashier_batch = 1;                // One request per wakeup
     cfg->simulation_duration_real = 120;  // 2 minutes real time
     cfg->sim_start_hour = 8;
     cfg->sim_start_minute = 0;
     cfg->sim_end_hour = 17;
     cfg->sim_end_minute = 0;
     cfg->chair_travel_time_sim = 5;  // 5 sim minutes per ride
+    cfg->clock_source = 0;           // Time Server ticks every 10ms
+    cfg->max_speed = 0;              // Day takes SIMULATION_DURATION_REAL_SECONDS
 
     cfg->total_tourists = 100;
     cfg->tourist_spawn_delay_us = 200000;  // 200ms default
+    cfg->tourist_pool_size = 0;            // fork+exec per tourist by default
+    cfg->tourist_engine = 0;               // process per tourist by default
+    cfg->fiber_threads = 2;                // Fiber host scheduler threads (TOURIST_ENGINE=3)
+    cfg->remote_port = 0;                  // No remote gateway
+    cfg->remote_tourists = 0;
+    cfg->remote_bind = INADDR_LOOPBACK;    // Only this host can reach the gateway
+    memset(cfg->remote_token, 0, sizeof(cfg->remote_token));
+    cfg->queue_transport = 0;              // System V message queues by default
+    cfg->sem_backend = 0;                  // System V semaphores by default
+    cfg->queue_bytes = 0;                  // Queues keep kernel.msgmnb
+    cfg->preflight = PREFLIGHT_ADAPT;      // Fit the run to the host's limits before forking
+    cfg->shm_huge_pages = 0;               // Base pages for the shm segment
+    cfg->numa_lines = 0;                   // Default memory policy, no worker affinity
+    cfg->worker_cpus = 0;                  // Workers and tourists share every core
+    cfg->worker_sched_fifo = 0;            // SCHED_OTHER for every process
+    cfg->boarding_batch = 0;               // One boarding confirmation per tourist
+    cfg->chair_fill_deadline_sim = 0;      // 100ms SIGALRM polling for partial chairs
+    cfg->boarding_workers = 1;             // Lower worker fills chairs alone
+    cfg->boarding_window = 0;              // FIFO loading, misfits requeued
+    cfg->chair_interval_sim = 0;           // Chairs leave when full (or on the poll tick)
 
     cfg->vip_percentage = 1;
     cfg->walker_percentage = 50;
@@ -41,10 +70,183 @@ void config_set_defaults(Config *cfg) {
 
     cfg->danger_probability = 0;    // Disabled by default
     cfg->danger_duration_sim = 30;  // 30 sim minutes duration
+    cfg->danger_schedule = DANGER_SCHEDULE_OFF; // Danger drawn at every check
+    cfg->emergency_backend = 0;     // SIGUSR1/SIGUSR2 protocol by default
 
     cfg->debug_logs_enabled = 1;    // Debug logs enabled by default
+    cfg->log_async = LOG_ASYNC_OFF; // Every process writes its own lines to stderr
+    cfg->event_trace = 0;           // No binary event trace
+    cfg->perf_counters = 0;         // Resource usage only, no hardware counters
+    cfg->metrics_interval_ms = 0;   // No live metrics exporter
+    cfg->queue_sample_ms = 0;       // Blocked sends counted, depths not sampled
+    cfg->report_format = REPORT_FORMAT_TEXT; // Text report only
+    cfg->report_incremental = 0;    // Per-tourist table in shared memory
+    cfg->checkpoint_interval_sim = 0; // No checkpoint files
 
     cfg->scared_enabled = 1;        // Tourists can be scared by default
+    cfg->random_seed = 0;           // Different random draws every run
+    cfg->arrival_schedule = ARRIVAL_SCHEDULE_OFF; // Tourists drawn as they are spawned
+    cfg->arrival_rate = 0;          // Fixed spawn delay instead of Poisson arrivals
+    for (int h = 0; h < ARRIVAL_RATE_HOURS; h++) {
+        cfg->arrival_rate_hour[h] = -1;
+    }
+}
+
+/**
+ * @brief Poisson arrival rate in effect during one simulated hour.
+ *
+ * @param cfg Configuration.
+ * @param hour Hour of the day (0-23).
+ * @return Tourists per simulated hour.
+ */
+int config_arrival_rate(const Config *cfg, int hour) {
+    int rate = cfg->arrival_rate_hour[hour];
+    return rate >= 0 ? rate : cfg->arrival_rate;
+}
+
+/**
+ * @brief Set one configuration key from its text value.
+ *
+ * @param cfg Configuration structure to update.
+ * @param key Key name as written in config files (e.g. STATION_CAPACITY).
+ * @param value Value text (parsed with atoi).
+ * @return 0 on success, -1 if the key is unknown.
+ */
+int config_set_value(Config *cfg, const char *key, const char *value) {
+    if (strcmp(key, "STATION_CAPACITY") == 0) {
+        cfg->station_capacity = atoi(value);
+    } else if (strcmp(key, "LINE_COUNT") == 0) {
+        cfg->line_count = atoi(value);
+    } else if (strcmp(key, "CASHIER_COUNT") == 0) {
+        cfg->cashier_count = atoi(value);
+    } else if (strcmp(key, "CASHIER_BATCH") == 0) {
+        cfg->cashier_batch = atoi(value);
+    } else if (strcmp(key, "SIMULATION_DURATION_REAL_SECONDS") == 0) {
+        cfg->simulation_duration_real = atoi(value);
+    } else if (strcmp(key, "SIM_START_HOUR") == 0) {
+        cfg->sim_start_hour = atoi(value);
+    } else if (strcmp(key, "SIM_START_MINUTE") == 0) {
+        cfg->sim_start_minute = atoi(value);
+    } else if (strcmp(key, "SIM_END_HOUR") == 0) {
+        cfg->sim_end_hour = atoi(value);
+    } else if (strcmp(key, "SIM_END_MINUTE") == 0) {
+        cfg->sim_end_minute = atoi(value);
+    } else if (strcmp(key, "CHAIR_TRAVEL_TIME_SIM_MINUTES") == 0) {
+        cfg->chair_travel_time_sim = atoi(value);
+    } else if (strcmp(key, "CLOCK_SOURCE") == 0) {
+        cfg->clock_source = atoi(value);
+    } else if (strcmp(key, "MAX_SPEED") == 0) {
+        cfg->max_speed = atoi(value);
+    } else if (strcmp(key, "TOTAL_TOURISTS") == 0) {
+        cfg->total_tourists = atoi(value);
+    } else if (strcmp(key, "TOURIST_SPAWN_DELAY_US") == 0) {
+        cfg->tourist_spawn_delay_us = atoi(value);
+    } else if (strcmp(key, "TOURIST_POOL_SIZE") == 0) {
+        cfg->tourist_pool_size = atoi(value);
+    } else if (strcmp(key, "TOURIST_ENGINE") == 0) {
+        cfg->tourist_engine = atoi(value);
+    } else if (strcmp(key, "FIBER_THREADS") == 0) {
+        cfg->fiber_threads = atoi(value);
+    } else if (strcmp(key, "REMOTE_PORT") == 0) {
+        cfg->remote_port = atoi(value);
+    } else if (strcmp(key, "REMOTE_TOURISTS") == 0) {
+        cfg->remote_tourists = atoi(value);
+    } else if (strcmp(key, "REMOTE_BIND") == 0) {
+        struct in_addr addr;
+        cfg->remote_bind = inet_pton(AF_INET, value, &addr) == 1 ? ntohl(addr.s_addr) : INADDR_NONE;
+    } else if (strcmp(key, "REMOTE_TOKEN") == 0) {
+        size_t len = strlen(value);
+        memset(cfg->remote_token, 0, sizeof(cfg->remote_token));
+        memcpy(cfg->remote_token, value, len < sizeof(cfg->remote_token) ? len : sizeof(cfg->remote_token) - 1);
+    } else if (strcmp(key, "QUEUE_TRANSPORT") == 0) {
+        cfg->queue_transport = atoi(value);
+    } else if (strcmp(key, "SEM_BACKEND") == 0) {
+        cfg->sem_backend = atoi(value);
+    } else if (strcmp(key, "QUEUE_BYTES") == 0) {
+        cfg->queue_bytes = atoi(value);
+    } else if (strcmp(key, "PREFLIGHT") == 0) {
+        cfg->preflight = atoi(value);
+    } else if (strcmp(key, "SHM_HUGE_PAGES") == 0) {
+        cfg->shm_huge_pages = atoi(value);
+    } else if (strcmp(key, "NUMA_LINES") == 0) {
+        cfg->numa_lines = atoi(value);
+    } else if (strcmp(key, "WORKER_CPUS") == 0) {
+        cfg->worker_cpus = atoi(value);
+    } else if (strcmp(key, "WORKER_SCHED_FIFO") == 0) {
+        cfg->worker_sched_fifo = atoi(value);
+    } else if (strcmp(key, "BOARDING_BATCH") == 0) {
+        cfg->boarding_batch = atoi(value);
+    } else if (strcmp(key, "CHAIR_FILL_DEADLINE_SIM_SECONDS") == 0) {
+        cfg->chair_fill_deadline_sim = atoi(value);
+    } else if (strcmp(key, "BOARDING_WORKERS") == 0) {
+        cfg->boarding_workers = atoi(value);
+    } else if (strcmp(key, "BOARDING_WINDOW") == 0) {
+        cfg->boarding_window = atoi(value);
+    } else if (strcmp(key, "CHAIR_INTERVAL_SIM_SECONDS") == 0) {
+        cfg->chair_interval_sim = atoi(value);
+    } else if (strcmp(key, "VIP_PERCENTAGE") == 0) {
+        cfg->vip_percentage = atoi(value);
+    } else if (strcmp(key, "WALKER_PERCENTAGE") == 0) {
+        cfg->walker_percentage = atoi(value);
+    } else if (strcmp(key, "FAMILY_PERCENTAGE") == 0) {
+        cfg->family_percentage = atoi(value);
+    } else if (strcmp(key, "TRAIL_WALK_TIME_SIM_MINUTES") == 0) {
+        cfg->trail_walk_time = atoi(value);
+    } else if (strcmp(key, "TRAIL_BIKE_FAST_TIME_SIM_MINUTES") == 0) {
+        cfg->trail_bike_fast_time = atoi(value);
+    } else if (strcmp(key, "TRAIL_BIKE_MEDIUM_TIME_SIM_MINUTES") == 0) {
+        cfg->trail_bike_medium_time = atoi(value);
+    } else if (strcmp(key, "TRAIL_BIKE_SLOW_TIME_SIM_MINUTES") == 0) {
+        cfg->trail_bike_slow_time = atoi(value);
+    } else if (strcmp(key, "TICKET_T1_DURATION_SIM_MINUTES") == 0) {
+        cfg->ticket_t1_duration = atoi(value);
+    } else if (strcmp(key, "TICKET_T2_DURATION_SIM_MINUTES") == 0) {
+        cfg->ticket_t2_duration = atoi(value);
+    } else if (strcmp(key, "TICKET_T3_DURATION_SIM_MINUTES") == 0) {
+        cfg->ticket_t3_duration = atoi(value);
+    } else if (strcmp(key, "DANGER_PROBABILITY") == 0) {
+        cfg->danger_probability = atoi(value);
+    } else if (strcmp(key, "DANGER_DURATION_SIM_MINUTES") == 0) {
+        cfg->danger_duration_sim = atoi(value);
+    } else if (strcmp(key, "DANGER_SCHEDULE") == 0) {
+        cfg->danger_schedule = atoi(value);
+    } else if (strcmp(key, "EMERGENCY_BACKEND") == 0) {
+        cfg->emergency_backend = atoi(value);
+    } else if (strcmp(key, "DEBUG_LOGS_ENABLED") == 0) {
+        cfg->debug_logs_enabled = atoi(value);
+    } else if (strcmp(key, "LOG_ASYNC") == 0) {
+        cfg->log_async = atoi(value);
+    } else if (strcmp(key, "EVENT_TRACE") == 0) {
+        cfg->event_trace = atoi(value);
+    } else if (strcmp(key, "PERF_COUNTERS") == 0) {
+        cfg->perf_counters = atoi(value);
+    } else if (strcmp(key, "METRICS_INTERVAL_MS") == 0) {
+        cfg->metrics_interval_ms = atoi(value);
+    } else if (strcmp(key, "QUEUE_SAMPLE_MS") == 0) {
+        cfg->queue_sample_ms = atoi(value);
+    } else if (strcmp(key, "REPORT_FORMAT") == 0) {
+        cfg->report_format = atoi(value);
+    } else if (strcmp(key, "REPORT_INCREMENTAL") == 0) {
+        cfg->report_incremental = atoi(value);
+    } else if (strcmp(key, "CHECKPOINT_INTERVAL_SIM_MINUTES") == 0) {
+        cfg->checkpoint_interval_sim = atoi(value);
+    } else if (strcmp(key, "SCARED_ENABLED") == 0) {
+        cfg->scared_enabled = atoi(value);
+    } else if (strcmp(key, "RANDOM_SEED") == 0) {
+        cfg->random_seed = atoi(value);
+    } else if (strcmp(key, "ARRIVAL_SCHEDULE") == 0) {
+        cfg->arrival_schedule = atoi(value);
+    } else if (strcmp(key, "ARRIVAL_RATE") == 0) {
+        cfg->arrival_rate = atoi(value);
+    } else if (strncmp(key, "ARRIVAL_RATE_", 13) == 0 && isdigit((unsigned char)key[13]) &&
+               isdigit((unsigned char)key[14]) && key[15] == '\0' &&
+               atoi(key + 13) < ARRIVAL_RATE_HOURS) {
+        // Rate profile: ARRIVAL_RATE_00 .. ARRIVAL_RATE_23
+        cfg->arrival_rate_hour[atoi(key + 13)] = atoi(value);
+    } else {
+        return -1;
+    }
+    return 0;
 }
 
 /**
@@ -96,54 +298,7 @@ int config_load(const char *path, Config *cfg) {
             continue;
         }
 
-        // Match keys
-        if (strcmp(key, "STATION_CAPACITY") == 0) {
-            cfg->station_capacity = atoi(value);
-        } else if (strcmp(key, "SIMULATION_DURATION_REAL_SECONDS") == 0) {
-            cfg->simulation_duration_real = atoi(value);
-        } else if (strcmp(key, "SIM_START_HOUR") == 0) {
-            cfg->sim_start_hour = atoi(value);
-        } else if (strcmp(key, "SIM_START_MINUTE") == 0) {
-            cfg->sim_start_minute = atoi(value);
-        } else if (strcmp(key, "SIM_END_HOUR") == 0) {
-            cfg->sim_end_hour = atoi(value);
-        } else if (strcmp(key, "SIM_END_MINUTE") == 0) {
-            cfg->sim_end_minute = atoi(value);
-        } else if (strcmp(key, "CHAIR_TRAVEL_TIME_SIM_MINUTES") == 0) {
-            cfg->chair_travel_time_sim = atoi(value);
-        } else if (strcmp(key, "TOTAL_TOURISTS") == 0) {
-            cfg->total_tourists = atoi(value);
-        } else if (strcmp(key, "TOURIST_SPAWN_DELAY_US") == 0) {
-            cfg->tourist_spawn_delay_us = atoi(value);
-        } else if (strcmp(key, "VIP_PERCENTAGE") == 0) {
-            cfg->vip_percentage = atoi(value);
-        } else if (strcmp(key, "WALKER_PERCENTAGE") == 0) {
-            cfg->walker_percentage = atoi(value);
-        } else if (strcmp(key, "FAMILY_PERCENTAGE") == 0) {
-            cfg->family_percentage = atoi(value);
-        } else if (strcmp(key, "TRAIL_WALK_TIME_SIM_MINUTES") == 0) {
-            cfg->trail_walk_time = atoi(value);
-        } else if (strcmp(key, "TRAIL_BIKE_FAST_TIME_SIM_MINUTES") == 0) {
-            cfg->trail_bike_fast_time = atoi(value);
-        } else if (strcmp(key, "TRAIL_BIKE_MEDIUM_TIME_SIM_MINUTES") == 0) {
-            cfg->trail_bike_medium_time = atoi(value);
-        } else if (strcmp(key, "TRAIL_BIKE_SLOW_TIME_SIM_MINUTES") == 0) {
-            cfg->trail_bike_slow_time = atoi(value);
-        } else if (strcmp(key, "TICKET_T1_DURATION_SIM_MINUTES") == 0) {
-            cfg->ticket_t1_duration = atoi(value);
-        } else if (strcmp(key, "TICKET_T2_DURATION_SIM_MINUTES") == 0) {
-            cfg->ticket_t2_duration = atoi(value);
-        } else if (strcmp(key, "TICKET_T3_DURATION_SIM_MINUTES") == 0) {
-            cfg->ticket_t3_duration = atoi(value);
-        } else if (strcmp(key, "DANGER_PROBABILITY") == 0) {
-            cfg->danger_probability = atoi(value);
-        } else if (strcmp(key, "DANGER_DURATION_SIM_MINUTES") == 0) {
-            cfg->danger_duration_sim = atoi(value);
-        } else if (strcmp(key, "DEBUG_LOGS_ENABLED") == 0) {
-            cfg->debug_logs_enabled = atoi(value);
-        } else if (strcmp(key, "SCARED_ENABLED") == 0) {
-            cfg->scared_enabled = atoi(value);
-        } else {
+        if (config_set_value(cfg, key, value) == -1) {
             fprintf(stderr, "[--:--:--] [WARN ] [CONFIG] Unknown key at line %d: %s\n", line_num, key);
         }
     }
@@ -211,6 +366,171 @@ int config_validate(const Config *cfg) {
         valid = 0;
     }
 
+    if (cfg->tourist_pool_size < 0) {
+        fprintf(stderr, "config: TOURIST_POOL_SIZE must be >= 0\n");
+        valid = 0;
+    }
+
+    if (cfg->tourist_engine < 0 || cfg->tourist_engine > 3) {
+        fprintf(stderr, "config: TOURIST_ENGINE must be 0 (process), 1 (thread), 2 (event) or 3 (fiber)\n");
+        valid = 0;
+    } else if (cfg->tourist_engine == TOURIST_ENGINE_FIBER && cfg->max_speed) {
+        // Fibers wait inside io_uring, where the virtual clock cannot see them block
+        fprintf(stderr, "config: TOURIST_ENGINE=3 cannot be combined with MAX_SPEED=1\n");
+        valid = 0;
+    }
+
+    if (cfg->fiber_threads < 1 || cfg->fiber_threads > MAX_FIBER_THREADS) {
+        fprintf(stderr, "config: FIBER_THREADS must be 1-%d\n", MAX_FIBER_THREADS);
+        valid = 0;
+    }
+
+    if (cfg->remote_port < 0 || cfg->remote_port > 65535) {
+        fprintf(stderr, "config: REMOTE_PORT must be 0-65535\n");
+        valid = 0;
+    }
+    if (cfg->remote_tourists < 0 || cfg->remote_tourists > cfg->total_tourists) {
+        fprintf(stderr, "config: REMOTE_TOURISTS must be 0-TOTAL_TOURISTS\n");
+        valid = 0;
+    }
+    if (cfg->remote_port > 0) {
+        // Remote tourists arrive as spawn descriptors with their attributes, on the real clock
+        if (cfg->remote_tourists == 0) {
+            fprintf(stderr, "config: REMOTE_PORT needs REMOTE_TOURISTS > 0\n");
+            valid = 0;
+        }
+        if (cfg->tourist_pool_size == 0 && cfg->tourist_engine == 0) {
+            fprintf(stderr, "config: REMOTE_PORT needs TOURIST_POOL_SIZE > 0 or TOURIST_ENGINE > 0\n");
+            valid = 0;
+        }
+        if (cfg->arrival_schedule != ARRIVAL_SCHEDULE_OFF || cfg->max_speed) {
+            fprintf(stderr, "config: REMOTE_PORT cannot be combined with ARRIVAL_SCHEDULE or MAX_SPEED\n");
+            valid = 0;
+        }
+        // Anyone reaching the gateway can add tourists: beyond this host, only with the token
+        if (cfg->remote_bind == INADDR_NONE) {
+            fprintf(stderr, "config: REMOTE_BIND must be an IPv4 address\n");
+            valid = 0;
+        } else if ((cfg->remote_bind >> 24) != 127 && cfg->remote_token[0] == '\0') {
+            fprintf(stderr, "config: REMOTE_BIND beyond loopback needs REMOTE_TOKEN\n");
+            valid = 0;
+        }
+    }
+
+    if (cfg->line_count < 1 || cfg->line_count > MAX_LINES) {
+        fprintf(stderr, "config: LINE_COUNT must be 1-%d\n", MAX_LINES);
+        valid = 0;
+    } else if (cfg->line_count > 1 && cfg->tourist_engine == TOURIST_ENGINE_EVENT) {
+        // The event engine keeps one wait queue per resource, not per line
+        fprintf(stderr, "config: LINE_COUNT > 1 requires TOURIST_ENGINE 0 or 1\n");
+        valid = 0;
+    }
+
+    if (cfg->cashier_count < 1 || cfg->cashier_count > MAX_CASHIERS) {
+        fprintf(stderr, "config: CASHIER_COUNT must be 1-%d\n", MAX_CASHIERS);
+        valid = 0;
+    }
+
+    if (cfg->cashier_batch < 1 || cfg->cashier_batch > MAX_CASHIER_BATCH) {
+        fprintf(stderr, "config: CASHIER_BATCH must be 1-%d\n", MAX_CASHIER_BATCH);
+        valid = 0;
+    }
+
+    if (cfg->queue_transport < 0 || cfg->queue_transport > 1) {
+        fprintf(stderr, "config: QUEUE_TRANSPORT must be 0 (sysv) or 1 (shm)\n");
+        valid = 0;
+    }
+
+    if (cfg->sem_backend < 0 || cfg->sem_backend > 1) {
+        fprintf(stderr, "config: SEM_BACKEND must be 0 (sysv) or 1 (futex)\n");
+        valid = 0;
+    }
+
+    if (cfg->queue_bytes < 0) {
+        fprintf(stderr, "config: QUEUE_BYTES must be >= 0\n");
+        valid = 0;
+    }
+
+    if (cfg->preflight < PREFLIGHT_OFF || cfg->preflight > PREFLIGHT_CHECK) {
+        fprintf(stderr, "config: PREFLIGHT must be 0 (off), 1 (adapt) or 2 (check)\n");
+        valid = 0;
+    }
+
+    if (cfg->shm_huge_pages < SHM_PAGES_NORMAL || cfg->shm_huge_pages > SHM_PAGES_TRANSPARENT) {
+        fprintf(stderr, "config: SHM_HUGE_PAGES must be 0 (off), 1 (hugetlb) or 2 (transparent)\n");
+        valid = 0;
+    }
+
+    if (cfg->numa_lines < 0 || cfg->numa_lines > 1) {
+        fprintf(stderr, "config: NUMA_LINES must be 0 or 1\n");
+        valid = 0;
+    }
+
+    if (cfg->worker_cpus < 0 || cfg->worker_cpus > MAX_WORKER_CPUS) {
+        fprintf(stderr, "config: WORKER_CPUS must be 0-%d\n", MAX_WORKER_CPUS);
+        valid = 0;
+    } else if (cfg->worker_cpus > 0 && cfg->numa_lines) {
+        // Line workers would leave their dedicated core for the node's CPUs
+        fprintf(stderr, "config: WORKER_CPUS and NUMA_LINES=1 cannot be combined\n");
+        valid = 0;
+    }
+
+    if (cfg->worker_sched_fifo < 0 || cfg->worker_sched_fifo > 99) {
+        fprintf(stderr, "config: WORKER_SCHED_FIFO must be 0-99\n");
+        valid = 0;
+    }
+
+    if (cfg->boarding_batch < 0 || cfg->boarding_batch > 1) {
+        fprintf(stderr, "config: BOARDING_BATCH must be 0 or 1\n");
+        valid = 0;
+    } else if (cfg->boarding_batch && cfg->queue_transport != QUEUE_TRANSPORT_SHM) {
+        fprintf(stderr, "config: BOARDING_BATCH=1 requires QUEUE_TRANSPORT=1\n");
+        valid = 0;
+    }
+
+    if (cfg->chair_fill_deadline_sim < 0) {
+        fprintf(stderr, "config: CHAIR_FILL_DEADLINE_SIM_SECONDS must be >= 0\n");
+        valid = 0;
+    }
+
+    if (cfg->boarding_workers < 1 || cfg->boarding_workers > MAX_BOARDING_WORKERS) {
+        fprintf(stderr, "config: BOARDING_WORKERS must be 1-%d\n", MAX_BOARDING_WORKERS);
+        valid = 0;
+    } else if (cfg->boarding_workers > 1 && cfg->chair_fill_deadline_sim > 0) {
+        fprintf(stderr, "config: BOARDING_WORKERS > 1 requires CHAIR_FILL_DEADLINE_SIM_SECONDS=0\n");
+        valid = 0;
+    }
+
+    if (cfg->boarding_window < 0 || cfg->boarding_window > MAX_BOARDING_WINDOW) {
+        fprintf(stderr, "config: BOARDING_WINDOW must be 0-%d\n", MAX_BOARDING_WINDOW);
+        valid = 0;
+    } else if (cfg->boarding_window > 0 &&
+               (cfg->boarding_workers > 1 || cfg->chair_fill_deadline_sim > 0)) {
+        fprintf(stderr, "config: BOARDING_WINDOW > 0 requires BOARDING_WORKERS=1 and "
+                        "CHAIR_FILL_DEADLINE_SIM_SECONDS=0\n");
+        valid = 0;
+    }
+
+    if (cfg->chair_interval_sim < 0) {
+        fprintf(stderr, "config: CHAIR_INTERVAL_SIM_SECONDS must be >= 0\n");
+        valid = 0;
+    } else if (cfg->chair_interval_sim > 0 &&
+               (cfg->boarding_workers > 1 || cfg->boarding_window > 0 ||
+                cfg->chair_fill_deadline_sim > 0 || cfg->max_speed)) {
+        fprintf(stderr, "config: CHAIR_INTERVAL_SIM_SECONDS > 0 requires BOARDING_WORKERS=1, "
+                        "BOARDING_WINDOW=0, CHAIR_FILL_DEADLINE_SIM_SECONDS=0 and MAX_SPEED=0\n");
+        valid = 0;
+    } else if (cfg->chair_interval_sim > 0 &&
+               (long)cfg->chair_interval_sim * MAX_CHAIRS_IN_TRANSIT <
+                   (long)cfg->chair_travel_time_sim * 60) {
+        // Chairs going up fill at most half the ring, as SEM_CHAIRS allows
+        fprintf(stderr, "config: CHAIR_INTERVAL_SIM_SECONDS must be >= %d for a %d minute ride "
+                        "(at most %d chairs going up)\n",
+                (cfg->chair_travel_time_sim * 60 + MAX_CHAIRS_IN_TRANSIT - 1) / MAX_CHAIRS_IN_TRANSIT,
+                cfg->chair_travel_time_sim, MAX_CHAIRS_IN_TRANSIT);
+        valid = 0;
+    }
+
     if (cfg->vip_percentage < 0 || cfg->vip_percentage > 100) {
         fprintf(stderr, "config: VIP_PERCENTAGE must be 0-100\n");
         valid = 0;
@@ -231,6 +551,20 @@ int config_validate(const Config *cfg) {
         valid = 0;
     }
 
+    if (cfg->clock_source < 0 || cfg->clock_source > 1) {
+        fprintf(stderr, "config: CLOCK_SOURCE must be 0 (tick) or 1 (epoch)\n");
+        valid = 0;
+    }
+
+    if (cfg->max_speed < 0 || cfg->max_speed > 1) {
+        fprintf(stderr, "config: MAX_SPEED must be 0 or 1\n");
+        valid = 0;
+    } else if (cfg->max_speed && cfg->chair_fill_deadline_sim > 0) {
+        // The deadline dispatcher waits on real-time timeouts the virtual clock cannot see
+        fprintf(stderr, "config: MAX_SPEED=1 requires CHAIR_FILL_DEADLINE_SIM_SECONDS=0\n");
+        valid = 0;
+    }
+
     if (cfg->danger_probability < 0 || cfg->danger_probability > 100) {
         fprintf(stderr, "config: DANGER_PROBABILITY must be 0-100\n");
         valid = 0;
@@ -241,5 +575,98 @@ int config_validate(const Config *cfg) {
         valid = 0;
     }
 
+    if (cfg->danger_schedule < DANGER_SCHEDULE_OFF ||
+        cfg->danger_schedule > DANGER_SCHEDULE_REPLAY) {
+        fprintf(stderr, "config: DANGER_SCHEDULE must be 0, 1 or 2\n");
+        valid = 0;
+    }
+
+    if (cfg->emergency_backend < EMERGENCY_BACKEND_SIGNALS ||
+        cfg->emergency_backend > EMERGENCY_BACKEND_FUTEX) {
+        fprintf(stderr, "config: EMERGENCY_BACKEND must be 0 (signals) or 1 (futex)\n");
+        valid = 0;
+    }
+
+    if (cfg->log_async < LOG_ASYNC_OFF || cfg->log_async > LOG_ASYNC_DROP) {
+        fprintf(stderr, "config: LOG_ASYNC must be 0-2\n");
+        valid = 0;
+    }
+
+    if (cfg->event_trace < 0 || cfg->event_trace > 1) {
+        fprintf(stderr, "config: EVENT_TRACE must be 0 or 1\n");
+        valid = 0;
+    }
+
+    if (cfg->perf_counters < 0 || cfg->perf_counters > 1) {
+        fprintf(stderr, "config: PERF_COUNTERS must be 0 or 1\n");
+        valid = 0;
+    }
+
+    if (cfg->metrics_interval_ms < 0) {
+        fprintf(stderr, "config: METRICS_INTERVAL_MS must be >= 0\n");
+        valid = 0;
+    }
+
+    if (cfg->queue_sample_ms < 0) {
+        fprintf(stderr, "config: QUEUE_SAMPLE_MS must be >= 0\n");
+        valid = 0;
+    }
+
+    if (cfg->report_format < REPORT_FORMAT_TEXT || cfg->report_format > REPORT_FORMAT_CSV) {
+        fprintf(stderr, "config: REPORT_FORMAT must be 0 or 1\n");
+        valid = 0;
+    }
+
+    if (cfg->report_incremental != 0 && cfg->report_incremental != 1) {
+        fprintf(stderr, "config: REPORT_INCREMENTAL must be 0 or 1\n");
+        valid = 0;
+    }
+
+    if (cfg->checkpoint_interval_sim < 0) {
+        fprintf(stderr, "config: CHECKPOINT_INTERVAL_SIM_MINUTES must be >= 0\n");
+        valid = 0;
+    }
+
+    if (cfg->random_seed < 0) {
+        fprintf(stderr, "config: RANDOM_SEED must be >= 0\n");
+        valid = 0;
+    }
+
+    if (cfg->arrival_schedule < ARRIVAL_SCHEDULE_OFF ||
+        cfg->arrival_schedule > ARRIVAL_SCHEDULE_REPLAY) {
+        fprintf(stderr, "config: ARRIVAL_SCHEDULE must be 0, 1 or 2\n");
+        valid = 0;
+    }
+
+    int poisson = 0;
+    if (cfg->arrival_rate < 0) {
+        fprintf(stderr, "config: ARRIVAL_RATE must be >= 0\n");
+        valid = 0;
+    }
+    for (int h = 0; h < ARRIVAL_RATE_HOURS; h++) {
+        // -1 (unset) falls back to ARRIVAL_RATE; anything lower is an error
+        if (cfg->arrival_rate_hour[h] < -1) {
+            fprintf(stderr, "config: ARRIVAL_RATE_%02d must be >= 0\n", h);
+            valid = 0;
+        }
+        if (config_arrival_rate(cfg, h) > 0) {
+            poisson = 1;
+        }
+    }
+
+    // Descriptor spawn times are 32-bit microsecond offsets
+    if (cfg->arrival_schedule == ARRIVAL_SCHEDULE_GENERATE && !poisson &&
+        (long long)(cfg->total_tourists - 1) * cfg->tourist_spawn_delay_us > UINT32_MAX) {
+        fprintf(stderr, "config: ARRIVAL_SCHEDULE=1 needs (TOTAL_TOURISTS - 1) * "
+                        "TOURIST_SPAWN_DELAY_US <= %u us\n", UINT32_MAX);
+        valid = 0;
+    }
+    if (cfg->arrival_schedule == ARRIVAL_SCHEDULE_GENERATE && poisson &&
+        (long long)cfg->simulation_duration_real * 1000000 > UINT32_MAX) {
+        fprintf(stderr, "config: ARRIVAL_SCHEDULE=1 with ARRIVAL_RATE needs "
+                        "SIMULATION_DURATION_REAL_SECONDS <= %u\n", UINT32_MAX / 1000000);
+        valid = 0;
+    }
+
     return valid ? 0 : -1;
 }
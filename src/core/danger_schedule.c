@@ -0,0 +1,135 @@
+/**
+ * @file core/danger_schedule.c
+ * @brief Recorded danger detections and their replay (DANGER_SCHEDULE > 0).
+ */
+
+#include "core/danger_schedule.h"
+#include "core/logger.h"
+
+#include <stdio.h>
+#include <string.h>
+
+_Static_assert(sizeof(DangerEvent) == 16, "DangerEvent must stay 16 bytes");
+
+/**
+ * @brief Load DANGER_SCHEDULE_FILE_NAME into the replay script.
+ *
+ * @return Events loaded, or -1 on error.
+ */
+static long danger_schedule_load(DangerLog *log, const Config *cfg, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror("danger_schedule: fopen");
+        return -1;
+    }
+
+    DangerScheduleFileHeader header;
+    if (fread(&header, sizeof(header), 1, f) != 1 ||
+        memcmp(header.magic, DANGER_SCHEDULE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != DANGER_SCHEDULE_VERSION ||
+        header.record_size != sizeof(DangerEvent)) {
+        fprintf(stderr, "danger_schedule: %s is not a danger schedule of this build\n", path);
+        fclose(f);
+        return -1;
+    }
+
+    uint32_t count = header.count;
+    if (count > DANGER_SCHEDULE_MAX) {
+        fprintf(stderr, "danger_schedule: %s holds %u events, more than %d\n",
+                path, count, DANGER_SCHEDULE_MAX);
+        fclose(f);
+        return -1;
+    }
+    if (fread(log->script, sizeof(DangerEvent), count, f) != count) {
+        fprintf(stderr, "danger_schedule: %s is truncated\n", path);
+        fclose(f);
+        return -1;
+    }
+    fclose(f);
+
+    for (uint32_t i = 0; i < count; i++) {
+        const DangerEvent *e = &log->script[i];
+        if (e->line >= cfg->line_count || e->worker > WORKER_UPPER || e->sim_ms < 0) {
+            fprintf(stderr, "danger_schedule: %s: invalid event %u (line %u of %d)\n",
+                    path, i + 1, e->line, cfg->line_count);
+            return -1;
+        }
+    }
+    return (long)count;
+}
+
+int danger_schedule_init(SharedState *state, const Config *cfg) {
+    if (cfg->danger_schedule != DANGER_SCHEDULE_REPLAY) {
+        return 0;
+    }
+    long count = danger_schedule_load(&state->danger, cfg, DANGER_SCHEDULE_FILE_NAME);
+    if (count == -1) {
+        return -1;
+    }
+    state->danger.script_count = (uint32_t)count;
+    log_debug("IPC", "Loaded danger schedule: %ld events from %s",
+              count, DANGER_SCHEDULE_FILE_NAME);
+    return 0;
+}
+
+void danger_schedule_record(SharedState *state, int line, int worker, int64_t sim_ms) {
+    DangerLog *log = &state->danger;
+    uint32_t slot = __atomic_fetch_add(&log->count, 1, __ATOMIC_RELAXED);
+    if (slot >= DANGER_SCHEDULE_MAX) {
+        __atomic_add_fetch(&log->dropped, 1, __ATOMIC_RELAXED);
+        return;
+    }
+    DangerEvent *e = &log->events[slot];
+    e->sim_ms = sim_ms;
+    e->line = (uint16_t)line;
+    e->worker = (uint16_t)worker;
+}
+
+int danger_schedule_due(SharedState *state, int line, int worker, uint32_t *cursor,
+                        int64_t now_ms) {
+    DangerLog *log = &state->danger;
+    int64_t stale_ms = (int64_t)state->cfg.danger_duration_sim * 60000;
+    while (*cursor < log->script_count) {
+        const DangerEvent *e = &log->script[(*cursor)++];
+        if (e->line != line || e->worker != worker) {
+            continue;  // Another worker's event
+        }
+        if (e->sim_ms > now_ms) {
+            (*cursor)--;
+            return 0;
+        }
+        if (now_ms - e->sim_ms <= stale_ms) {
+            return 1;
+        }
+        __atomic_add_fetch(&log->missed, 1, __ATOMIC_RELAXED);
+        log_warn("DANGER", "Replayed stop of line %d at sim ms %lld missed (line halted past it)",
+                 line, (long long)e->sim_ms);
+    }
+    return 0;
+}
+
+int danger_schedule_save(const SharedState *state, const char *path) {
+    const DangerLog *log = &state->danger;
+    uint32_t count = log->count < DANGER_SCHEDULE_MAX ? log->count : DANGER_SCHEDULE_MAX;
+
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        perror("danger_schedule: fopen");
+        return -1;
+    }
+
+    DangerScheduleFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, DANGER_SCHEDULE_MAGIC, sizeof(header.magic));
+    header.version = DANGER_SCHEDULE_VERSION;
+    header.record_size = sizeof(DangerEvent);
+    header.count = count;
+
+    int ok = fwrite(&header, sizeof(header), 1, f) == 1 &&
+             fwrite(log->events, sizeof(DangerEvent), count, f) == count;
+    if (fclose(f) != 0 || !ok) {
+        perror("danger_schedule: write");
+        return -1;
+    }
+    return 0;
+}
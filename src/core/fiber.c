@@ -0,0 +1,596 @@
+/**
+ * @file core/fiber.c
+ * @brief ucontext fibers on an io_uring scheduler (TOURIST_ENGINE=3).
+ */
+
+#include "core/fiber.h"
+#include "core/logger.h"
+#include "core/rng.h"
+#include "core/time_sim.h"
+#include "constants.h"
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <linux/io_uring.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/msg.h>
+#include <sys/syscall.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+// Futex waits on io_uring (Linux 6.7), newer than some uapi headers
+#define FIBER_OP_FUTEX_WAIT 51          // IORING_OP_FUTEX_WAIT
+#ifndef FUTEX2_SIZE_U32
+#define FUTEX2_SIZE_U32 0x02
+#endif
+
+#define FIBER_STACK_CANARY UINT64_C(0x52574649424552ff)
+#define FIBER_PROBE_OPS 256
+
+typedef struct Fiber Fiber;
+
+/**
+ * @brief One fiber: its context, stack and the thread-local state it owns.
+ */
+struct Fiber {
+    ucontext_t ctx;
+    Fiber *next;                        // Ready, poll or free list
+    FiberScheduler *sched;
+    FiberFunc fn;
+    void *arg;
+    uint64_t *stack;                    // Lowest address; stack[0] holds the canary
+    int32_t result;                     // res of the completion that made it ready
+    int done;
+    Rng rng;                            // rng_local() while switched out
+    int rng_saved;
+    int log_component;                  // Logger thread component while switched out
+};
+
+/**
+ * @brief Intrusive FIFO of fibers.
+ */
+typedef struct {
+    Fiber *head;
+    Fiber *tail;
+} FiberList;
+
+/**
+ * @brief FIBER_STACK_SLAB fibers and one mapping holding their stacks.
+ */
+typedef struct FiberSlab {
+    struct FiberSlab *next;
+    void *stacks;
+    Fiber fibers[FIBER_STACK_SLAB];
+} FiberSlab;
+
+struct FiberScheduler {
+    int ring_fd;
+    void *ring_map;                     // SQ and CQ rings (IORING_FEAT_SINGLE_MMAP)
+    size_t ring_map_size;
+    struct io_uring_sqe *sqes;
+    size_t sqes_size;
+    uint32_t *sq_head;
+    uint32_t *sq_tail;
+    uint32_t *sq_array;
+    uint32_t sq_mask;
+    uint32_t sq_entries;
+    uint32_t sq_local_tail;             // SQEs written, published to sq_tail at io_uring_enter
+    uint32_t *cq_head;
+    uint32_t *cq_tail;
+    uint32_t cq_mask;
+    struct io_uring_cqe *cqes;
+
+    ucontext_t main_ctx;                // Scheduler loop, resumed when a fiber switches out
+    FiberList ready;
+    FiberList polls;                    // System V waiters, retried every FIBER_POLL_NS
+    FiberList free_list;
+    FiberSlab *slabs;
+    int64_t next_poll_ns;
+    FiberStats stats;
+};
+
+static __thread Fiber *tls_current = NULL;
+
+static void list_push(FiberList *l, Fiber *f) {
+    f->next = NULL;
+    if (l->tail != NULL) {
+        l->tail->next = f;
+    } else {
+        l->head = f;
+    }
+    l->tail = f;
+}
+
+static Fiber *list_pop(FiberList *l) {
+    Fiber *f = l->head;
+    if (f != NULL) {
+        l->head = f->next;
+        if (l->head == NULL) {
+            l->tail = NULL;
+        }
+    }
+    return f;
+}
+
+/**
+ * @brief Move every fiber of src to the end of dst.
+ */
+static void list_splice(FiberList *dst, FiberList *src) {
+    if (src->head == NULL) {
+        return;
+    }
+    if (dst->tail != NULL) {
+        dst->tail->next = src->head;
+    } else {
+        dst->head = src->head;
+    }
+    dst->tail = src->tail;
+    src->head = src->tail = NULL;
+}
+
+static struct __kernel_timespec kernel_ts_ns(int64_t ns) {
+    struct __kernel_timespec ts;
+    ts.tv_sec = ns / 1000000000;
+    ts.tv_nsec = ns % 1000000000;
+    return ts;
+}
+
+// ---------------------------------------------------------------------------
+// io_uring (raw syscalls: one ring per scheduler thread, no SQPOLL)
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Whether the kernel supports an opcode (IORING_REGISTER_PROBE).
+ */
+static int ring_probe(int fd, int opcode) {
+    size_t len = sizeof(struct io_uring_probe) + FIBER_PROBE_OPS * sizeof(struct io_uring_probe_op);
+    struct io_uring_probe *probe = calloc(1, len);
+    if (probe == NULL) {
+        return 0;
+    }
+    int supported = 0;
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, FIBER_PROBE_OPS) == 0 &&
+        opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED)) {
+        supported = 1;
+    }
+    free(probe);
+    return supported;
+}
+
+/**
+ * @brief Create the ring and map its queues.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int ring_init(FiberScheduler *s) {
+    struct io_uring_params p;
+    memset(&p, 0, sizeof(p));
+    p.flags = IORING_SETUP_CQSIZE;
+    p.cq_entries = FIBER_CQ_ENTRIES;
+
+    s->ring_fd = (int)syscall(__NR_io_uring_setup, FIBER_RING_ENTRIES, &p);
+    if (s->ring_fd < 0) {
+        perror("fiber: io_uring_setup");
+        return -1;
+    }
+    // Single mapping (5.4), no dropped completions (5.5), timed waits (5.11)
+    unsigned need = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if ((p.features & need) != need) {
+        fprintf(stderr, "fiber: io_uring features 0x%x lack 0x%x (Linux 5.11 or later needed)\n",
+                p.features, need);
+        close(s->ring_fd);
+        return -1;
+    }
+
+    size_t sq_size = p.sq_off.array + p.sq_entries * sizeof(uint32_t);
+    size_t cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+    s->ring_map_size = sq_size > cq_size ? sq_size : cq_size;
+    s->ring_map = mmap(NULL, s->ring_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       s->ring_fd, IORING_OFF_SQ_RING);
+    s->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+    s->sqes = mmap(NULL, s->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                   s->ring_fd, IORING_OFF_SQES);
+    if (s->ring_map == MAP_FAILED || s->sqes == MAP_FAILED) {
+        perror("fiber: mmap io_uring");
+        if (s->ring_map != MAP_FAILED) munmap(s->ring_map, s->ring_map_size);
+        if (s->sqes != MAP_FAILED) munmap(s->sqes, s->sqes_size);
+        close(s->ring_fd);
+        return -1;
+    }
+
+    char *ring = s->ring_map;
+    s->sq_head = (uint32_t *)(ring + p.sq_off.head);
+    s->sq_tail = (uint32_t *)(ring + p.sq_off.tail);
+    s->sq_array = (uint32_t *)(ring + p.sq_off.array);
+    s->sq_mask = *(uint32_t *)(ring + p.sq_off.ring_mask);
+    s->sq_entries = p.sq_entries;
+    s->sq_local_tail = *s->sq_tail;
+    s->cq_head = (uint32_t *)(ring + p.cq_off.head);
+    s->cq_tail = (uint32_t *)(ring + p.cq_off.tail);
+    s->cq_mask = *(uint32_t *)(ring + p.cq_off.ring_mask);
+    s->cqes = (struct io_uring_cqe *)(ring + p.cq_off.cqes);
+
+    s->stats.futex_op = ring_probe(s->ring_fd, FIBER_OP_FUTEX_WAIT);
+    return 0;
+}
+
+/**
+ * @brief Submit the SQEs written so far, optionally waiting for one completion.
+ *
+ * @param wait_ns Longest wait (0 = submit only).
+ */
+static void ring_enter(FiberScheduler *s, int64_t wait_ns) {
+    __atomic_store_n(s->sq_tail, s->sq_local_tail, __ATOMIC_RELEASE);
+    unsigned to_submit = s->sq_local_tail - __atomic_load_n(s->sq_head, __ATOMIC_ACQUIRE);
+    if (to_submit == 0 && wait_ns <= 0) {
+        return;
+    }
+
+    struct __kernel_timespec ts = kernel_ts_ns(wait_ns);
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.ts = (uint64_t)(uintptr_t)&ts;
+    unsigned flags = wait_ns > 0 ? IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG : 0;
+
+    if (syscall(__NR_io_uring_enter, s->ring_fd, to_submit, wait_ns > 0 ? 1 : 0, flags,
+                wait_ns > 0 ? &arg : NULL, wait_ns > 0 ? sizeof(arg) : 0) == -1 &&
+        errno != ETIME && errno != EINTR && errno != EBUSY && errno != EAGAIN) {
+        perror("fiber: io_uring_enter");
+    }
+}
+
+/**
+ * @brief Make room for n SQEs, submitting the pending ones if the queue is full.
+ *
+ * @return 0 if n SQEs can be written, -1 otherwise.
+ */
+static int ring_space(FiberScheduler *s, uint32_t n) {
+    if (s->sq_local_tail - __atomic_load_n(s->sq_head, __ATOMIC_ACQUIRE) + n <= s->sq_entries) {
+        return 0;
+    }
+    ring_enter(s, 0);
+    return s->sq_local_tail - __atomic_load_n(s->sq_head, __ATOMIC_ACQUIRE) + n <= s->sq_entries
+        ? 0 : -1;
+}
+
+/**
+ * @brief Claim the next SQE (after ring_space), zeroed.
+ */
+static struct io_uring_sqe *ring_sqe(FiberScheduler *s) {
+    uint32_t idx = s->sq_local_tail & s->sq_mask;
+    struct io_uring_sqe *sqe = &s->sqes[idx];
+    memset(sqe, 0, sizeof(*sqe));
+    s->sq_array[idx] = idx;
+    s->sq_local_tail++;
+    return sqe;
+}
+
+/**
+ * @brief Make the fiber of every completion ready (user_data 0 = ignored).
+ */
+static void ring_reap(FiberScheduler *s) {
+    uint32_t head = *s->cq_head;
+    uint32_t tail = __atomic_load_n(s->cq_tail, __ATOMIC_ACQUIRE);
+    while (head != tail) {
+        const struct io_uring_cqe *cqe = &s->cqes[head & s->cq_mask];
+        Fiber *f = (Fiber *)(uintptr_t)cqe->user_data;
+        if (f != NULL) {
+            f->result = cqe->res;
+            list_push(&s->ready, f);
+        }
+        head++;
+    }
+    __atomic_store_n(s->cq_head, head, __ATOMIC_RELEASE);
+}
+
+// ---------------------------------------------------------------------------
+// Fibers
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Add FIBER_STACK_SLAB fibers to the free list.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int slab_alloc(FiberScheduler *s) {
+    FiberSlab *slab = calloc(1, sizeof(*slab));
+    if (slab == NULL) {
+        perror("fiber: calloc slab");
+        return -1;
+    }
+    slab->stacks = mmap(NULL, (size_t)FIBER_STACK_SLAB * FIBER_STACK_SIZE, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (slab->stacks == MAP_FAILED) {
+        perror("fiber: mmap stacks");
+        free(slab);
+        return -1;
+    }
+    for (int i = 0; i < FIBER_STACK_SLAB; i++) {
+        Fiber *f = &slab->fibers[i];
+        f->sched = s;
+        f->stack = (uint64_t *)((char *)slab->stacks + (size_t)i * FIBER_STACK_SIZE);
+        f->stack[0] = FIBER_STACK_CANARY;
+        list_push(&s->free_list, f);
+    }
+    slab->next = s->slabs;
+    s->slabs = slab;
+    return 0;
+}
+
+/**
+ * @brief First code a fiber runs; returning resumes the scheduler (uc_link).
+ */
+static void fiber_trampoline(void) {
+    Fiber *f = tls_current;
+    f->fn(f->arg);
+    f->done = 1;
+}
+
+/**
+ * @brief Run a fiber until it waits or returns.
+ */
+static void fiber_resume(FiberScheduler *s, Fiber *f) {
+    // The scheduler thread's own generator and log component stay its own
+    Rng thread_rng = *rng_local();
+    int thread_component = logger_get_thread_component();
+    if (f->rng_saved) {
+        *rng_local() = f->rng;
+    }
+    logger_set_thread_component((LogComponent)f->log_component);
+
+    tls_current = f;
+    s->stats.switches++;
+    swapcontext(&s->main_ctx, &f->ctx);
+    tls_current = NULL;
+
+    f->rng = *rng_local();
+    f->rng_saved = 1;
+    f->log_component = logger_get_thread_component();
+    *rng_local() = thread_rng;
+    logger_set_thread_component((LogComponent)thread_component);
+
+    if (f->stack[0] != FIBER_STACK_CANARY) {
+        fprintf(stderr, "fiber: stack overflow (FIBER_STACK_SIZE %d bytes)\n", FIBER_STACK_SIZE);
+        abort();
+    }
+    if (f->done) {
+        s->stats.live--;
+        list_push(&s->free_list, f);
+    }
+}
+
+/**
+ * @brief Switch from the calling fiber back to the scheduler.
+ *
+ * @return Result of the completion that resumed the fiber (0 for polls).
+ */
+static int32_t fiber_suspend(Fiber *f) {
+    f->result = 0;
+    swapcontext(&f->ctx, &f->sched->main_ctx);
+    return f->result;
+}
+
+/**
+ * @brief Park the calling fiber until the next poll pass.
+ */
+static void fiber_poll(Fiber *f) {
+    list_push(&f->sched->polls, f);
+    f->sched->stats.polls++;
+    fiber_suspend(f);
+}
+
+FiberScheduler *fiber_scheduler_create(void) {
+    FiberScheduler *s = calloc(1, sizeof(*s));
+    if (s == NULL) {
+        perror("fiber: calloc scheduler");
+        return NULL;
+    }
+    if (ring_init(s) == -1) {
+        free(s);
+        return NULL;
+    }
+    return s;
+}
+
+int fiber_spawn(FiberScheduler *s, FiberFunc fn, void *arg) {
+    if (s->free_list.head == NULL && slab_alloc(s) == -1) {
+        return -1;
+    }
+    Fiber *f = list_pop(&s->free_list);
+
+    getcontext(&f->ctx);
+    f->ctx.uc_stack.ss_sp = f->stack;
+    f->ctx.uc_stack.ss_size = FIBER_STACK_SIZE;
+    f->ctx.uc_link = &s->main_ctx;
+    makecontext(&f->ctx, fiber_trampoline, 0);
+
+    f->fn = fn;
+    f->arg = arg;
+    f->done = 0;
+    f->rng_saved = 0;
+    f->log_component = logger_get_thread_component();
+    list_push(&s->ready, f);
+
+    s->stats.spawned++;
+    if (++s->stats.live > s->stats.peak) {
+        s->stats.peak = s->stats.live;
+    }
+    return 0;
+}
+
+int fiber_scheduler_run(FiberScheduler *s, int64_t wait_ns) {
+    Fiber *f;
+    while ((f = list_pop(&s->ready)) != NULL) {
+        fiber_resume(s, f);
+    }
+
+    if (s->polls.head != NULL) {
+        int64_t until_poll = s->next_poll_ns - time_monotonic_ns();
+        if (wait_ns > until_poll) {
+            wait_ns = until_poll > 0 ? until_poll : 0;
+        }
+    }
+    ring_enter(s, wait_ns);
+    ring_reap(s);
+
+    int64_t now = time_monotonic_ns();
+    if (s->polls.head != NULL && now >= s->next_poll_ns) {
+        list_splice(&s->ready, &s->polls);
+        s->next_poll_ns = now + FIBER_POLL_NS;
+    }
+    return s->stats.live;
+}
+
+FiberStats fiber_scheduler_stats(const FiberScheduler *s) {
+    return s->stats;
+}
+
+void fiber_scheduler_destroy(FiberScheduler *s) {
+    while (s->slabs != NULL) {
+        FiberSlab *slab = s->slabs;
+        s->slabs = slab->next;
+        munmap(slab->stacks, (size_t)FIBER_STACK_SLAB * FIBER_STACK_SIZE);
+        free(slab);
+    }
+    munmap(s->sqes, s->sqes_size);
+    munmap(s->ring_map, s->ring_map_size);
+    close(s->ring_fd);
+    free(s);
+}
+
+// ---------------------------------------------------------------------------
+// Suspending waits
+// ---------------------------------------------------------------------------
+
+int fiber_active(void) {
+    return tls_current != NULL;
+}
+
+int fiber_futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms) {
+    Fiber *f = tls_current;
+    FiberScheduler *s = f->sched;
+    if (__atomic_load_n(addr, __ATOMIC_SEQ_CST) != expected) {
+        errno = EAGAIN;
+        return -1;
+    }
+
+    if (!s->stats.futex_op || ring_space(s, 2) == -1) {
+        // No futex op (before Linux 6.7): re-check the word every poll pass
+        int64_t deadline_ns = timeout_ms > 0 ? time_monotonic_ns() + (int64_t)timeout_ms * 1000000 : 0;
+        while (__atomic_load_n(addr, __ATOMIC_SEQ_CST) == expected) {
+            if (deadline_ns > 0 && time_monotonic_ns() >= deadline_ns) {
+                errno = ETIMEDOUT;
+                return -1;
+            }
+            fiber_poll(f);
+        }
+        return 0;
+    }
+
+    // Shared futex (no FUTEX2_PRIVATE): the wakers are other processes
+    struct io_uring_sqe *sqe = ring_sqe(s);
+    sqe->opcode = FIBER_OP_FUTEX_WAIT;
+    sqe->fd = FUTEX2_SIZE_U32;
+    sqe->addr = (uint64_t)(uintptr_t)addr;
+    sqe->addr2 = expected;
+    sqe->addr3 = FUTEX_BITSET_MATCH_ANY;
+    sqe->user_data = (uint64_t)(uintptr_t)f;
+
+    // The kernel copies the timespec when it takes the SQE, while this stack is parked
+    struct __kernel_timespec ts = kernel_ts_ns((int64_t)timeout_ms * 1000000);
+    if (timeout_ms > 0) {
+        sqe->flags |= IOSQE_IO_LINK;
+        struct io_uring_sqe *timeout = ring_sqe(s);
+        timeout->opcode = IORING_OP_LINK_TIMEOUT;
+        timeout->addr = (uint64_t)(uintptr_t)&ts;
+        timeout->len = 1;
+        timeout->user_data = 0;
+    }
+
+    s->stats.uring_waits++;
+    int32_t res = fiber_suspend(f);
+    if (res >= 0) {
+        return 0;
+    }
+    errno = (res == -ECANCELED) ? ETIMEDOUT : -res;  // Cancelled by the linked timeout
+    return -1;
+}
+
+int fiber_clock_nanosleep(int flags, const struct timespec *ts) {
+    Fiber *f = tls_current;
+    if (f == NULL) {
+        return clock_nanosleep(CLOCK_MONOTONIC, flags, ts, NULL);
+    }
+    FiberScheduler *s = f->sched;
+    if (ring_space(s, 1) == -1) {
+        fiber_poll(f);
+        return EINTR;  // Callers re-check their deadline after EINTR
+    }
+
+    struct __kernel_timespec kts;
+    kts.tv_sec = ts->tv_sec;
+    kts.tv_nsec = ts->tv_nsec;
+    struct io_uring_sqe *sqe = ring_sqe(s);
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = (uint64_t)(uintptr_t)&kts;
+    sqe->len = 1;
+    sqe->timeout_flags = (flags & TIMER_ABSTIME) ? IORING_TIMEOUT_ABS : 0;  // CLOCK_MONOTONIC
+    sqe->user_data = (uint64_t)(uintptr_t)f;
+
+    s->stats.uring_waits++;
+    int32_t res = fiber_suspend(f);
+    return (res == -ETIME || res >= 0) ? 0 : -res;
+}
+
+int fiber_semop(int semid, struct sembuf *sops, size_t nsops) {
+    Fiber *f = tls_current;
+    if (f == NULL) {
+        return semop(semid, sops, nsops);
+    }
+    struct sembuf nowait[nsops];
+    int blocking = 0;
+    for (size_t i = 0; i < nsops; i++) {
+        nowait[i] = sops[i];
+        blocking |= !(sops[i].sem_flg & IPC_NOWAIT);
+        nowait[i].sem_flg |= IPC_NOWAIT;
+    }
+    while (semop(semid, nowait, nsops) == -1) {
+        if (errno != EAGAIN || !blocking) {
+            return -1;
+        }
+        fiber_poll(f);
+    }
+    return 0;
+}
+
+int fiber_msgsnd(int msqid, const void *msgp, size_t msgsz, int msgflg) {
+    Fiber *f = tls_current;
+    if (f == NULL || (msgflg & IPC_NOWAIT)) {
+        return msgsnd(msqid, msgp, msgsz, msgflg);
+    }
+    while (msgsnd(msqid, msgp, msgsz, msgflg | IPC_NOWAIT) == -1) {
+        if (errno != EAGAIN) {
+            return -1;
+        }
+        fiber_poll(f);
+    }
+    return 0;
+}
+
+ssize_t fiber_msgrcv(int msqid, void *msgp, size_t msgsz, long msgtyp, int msgflg) {
+    Fiber *f = tls_current;
+    if (f == NULL || (msgflg & IPC_NOWAIT)) {
+        return msgrcv(msqid, msgp, msgsz, msgtyp, msgflg);
+    }
+    ssize_t n;
+    while ((n = msgrcv(msqid, msgp, msgsz, msgtyp, msgflg | IPC_NOWAIT)) == -1) {
+        if (errno != ENOMSG) {
+            return -1;
+        }
+        fiber_poll(f);
+    }
+    return n;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file core/latency.c
+ * @brief Lock-free wait-latency histograms in shared memory.
+ */
+
+#include "core/latency.h"
+
+#include <time.h>
+
+#define LAT_SUB_BUCKETS (1 << LAT_SUB_BUCKET_BITS)
+#define LAT_MAX_VALUE ((UINT64_C(1) << LAT_MAX_EXPONENT) - 1)
+
+/**
+ * @brief Bucket holding a value (log-linear).
+ */
+static int latency_bucket_index(uint64_t us) {
+    if (us > LAT_MAX_VALUE) {
+        us = LAT_MAX_VALUE;
+    }
+    if (us < LAT_SUB_BUCKETS) {
+        return (int)us;
+    }
+    int exponent = 63 - __builtin_clzll(us);
+    int shift = exponent - LAT_SUB_BUCKET_BITS;
+    int sub = (int)((us >> shift) & (LAT_SUB_BUCKETS - 1));
+    return LAT_SUB_BUCKETS * (shift + 1) + sub;
+}
+
+/**
+ * @brief Largest value that falls into a bucket.
+ */
+static uint64_t latency_bucket_upper(int idx) {
+    if (idx < LAT_SUB_BUCKETS) {
+        return (uint64_t)idx;
+    }
+    int shift = idx / LAT_SUB_BUCKETS - 1;
+    uint64_t sub = (uint64_t)(idx % LAT_SUB_BUCKETS);
+    uint64_t low = (LAT_SUB_BUCKETS + sub) << shift;
+    return low + (UINT64_C(1) << shift) - 1;
+}
+
+uint64_t latency_now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000 + (uint64_t)ts.tv_nsec / 1000;
+}
+
+void latency_record_since(SharedState *state, LatencyStage stage, uint64_t start_us) {
+    uint64_t now = latency_now_us();
+    latency_record(state, stage, now > start_us ? now - start_us : 0);
+}
+
+void latency_record(SharedState *state, LatencyStage stage, uint64_t wait_us) {
+    latency_hist_record(&state->latency[stage], wait_us);
+}
+
+void latency_hist_record(LatencyHistogram *hist, uint64_t wait_us) {
+    __atomic_add_fetch(&hist->buckets[latency_bucket_index(wait_us)], 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&hist->count, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&hist->sum_us, wait_us, __ATOMIC_RELAXED);
+
+    uint64_t max = __atomic_load_n(&hist->max_us, __ATOMIC_RELAXED);
+    while (wait_us > max &&
+           !__atomic_compare_exchange_n(&hist->max_us, &max, wait_us, 1,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        // max reloaded by the failed CAS
+    }
+}
+
+uint64_t latency_percentile(const LatencyHistogram *hist, double q) {
+    uint64_t total = 0;
+    for (int i = 0; i < LAT_BUCKET_COUNT; i++) {
+        total += hist->buckets[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+
+    // Rank of the sample (1-based), at least the first one
+    uint64_t rank = (uint64_t)(q * (double)total + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > total) rank = total;
+
+    uint64_t seen = 0;
+    for (int i = 0; i < LAT_BUCKET_COUNT; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank) {
+            uint64_t upper = latency_bucket_upper(i);
+            return upper < hist->max_us ? upper : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
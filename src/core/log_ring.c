@@ -0,0 +1,136 @@
+/**
+ * @file core/log_ring.c
+ * @brief Shared-memory log ring drained by the log drainer process (LOG_ASYNC > 0).
+ */
+
+#include "core/log_ring.h"
+#include "ipc/futex.h"
+
+#include <string.h>
+
+_Static_assert((LOG_RING_CAPACITY & (LOG_RING_CAPACITY - 1)) == 0,
+               "LOG_RING_CAPACITY must be a power of two");
+
+/**
+ * @brief Cache-line aligned offset of the ring.
+ */
+static size_t log_ring_offset_for(size_t base_size) {
+    return (base_size + 63) & ~(size_t)63;
+}
+
+size_t log_ring_shm_size(const Config *cfg, size_t base_size) {
+    if (cfg->log_async == LOG_ASYNC_OFF) {
+        return 0;
+    }
+    return (log_ring_offset_for(base_size) - base_size) + sizeof(LogRing);
+}
+
+void log_ring_init(SharedState *state, const Config *cfg, size_t base_size) {
+    if (cfg->log_async == LOG_ASYNC_OFF) {
+        state->log_offset = 0;
+        return;
+    }
+    state->log_offset = log_ring_offset_for(base_size);
+    LogRing *ring = log_ring_get(state);
+    for (uint64_t i = 0; i < LOG_RING_CAPACITY; i++) {
+        ring->slots[i].seq = i;
+    }
+}
+
+LogRing *log_ring_get(SharedState *state) {
+    if (state == NULL || state->cfg.log_async == LOG_ASYNC_OFF || state->log_offset == 0) {
+        return NULL;
+    }
+    return (LogRing *)((char *)state + state->log_offset);
+}
+
+/**
+ * @brief Try to claim one slot (lock-free, multi-producer).
+ *
+ * @return Slot, or NULL if the ring is full.
+ */
+static LogRecord *ring_try_claim(LogRing *ring, uint64_t *pos_out) {
+    uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+
+    while (1) {
+        LogRecord *rec = &ring->slots[pos & (LOG_RING_CAPACITY - 1)];
+        uint64_t seq = __atomic_load_n(&rec->seq, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                *pos_out = pos;
+                return rec;
+            }
+        } else if (diff < 0) {
+            return NULL;  // Slot not drained yet: full
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+LogRecord *log_ring_claim(LogRing *ring, int wait_when_full, uint64_t *pos_out) {
+    LogRecord *rec = ring_try_claim(ring, pos_out);
+
+    while (rec == NULL && wait_when_full &&
+           __atomic_load_n(&ring->drainer_alive, __ATOMIC_ACQUIRE) &&
+           !__atomic_load_n(&ring->stop, __ATOMIC_ACQUIRE)) {
+        __atomic_add_fetch(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t observed = __atomic_load_n(&ring->space, __ATOMIC_SEQ_CST);
+        rec = ring_try_claim(ring, pos_out);
+        if (rec == NULL) {
+            futex_wait(&ring->space, observed, SHM_WAIT_TIMEOUT_MS);
+            rec = ring_try_claim(ring, pos_out);
+        }
+        __atomic_sub_fetch(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+    }
+
+    if (rec == NULL) {
+        __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+    }
+    return rec;
+}
+
+void log_ring_publish(LogRing *ring, LogRecord *rec, uint64_t pos) {
+    __atomic_store_n(&rec->seq, pos + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->item_waiters, __ATOMIC_SEQ_CST) > 0) {
+        __atomic_add_fetch(&ring->items, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&ring->items, 1);
+    }
+}
+
+LogRecord *log_ring_peek(LogRing *ring) {
+    uint64_t pos = ring->head;
+    LogRecord *rec = &ring->slots[pos & (LOG_RING_CAPACITY - 1)];
+    if (__atomic_load_n(&rec->seq, __ATOMIC_SEQ_CST) != pos + 1) {
+        return NULL;  // Not yet published: empty
+    }
+    return rec;
+}
+
+void log_ring_release(LogRing *ring, LogRecord *rec) {
+    uint64_t pos = ring->head;
+    ring->head = pos + 1;
+    __atomic_store_n(&rec->seq, pos + LOG_RING_CAPACITY, __ATOMIC_RELEASE);
+    if (__atomic_load_n(&ring->space_waiters, __ATOMIC_SEQ_CST) > 0) {
+        __atomic_add_fetch(&ring->space, 1, __ATOMIC_SEQ_CST);
+        futex_wake(&ring->space, INT32_MAX);
+    }
+}
+
+int log_ring_skip_stalled(LogRing *ring) {
+    uint64_t pos = ring->head;
+    if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == pos) {
+        return 0;  // Empty, nothing claimed
+    }
+    LogRecord *rec = &ring->slots[pos & (LOG_RING_CAPACITY - 1)];
+    uint64_t claimed = pos;
+    if (!__atomic_compare_exchange_n(&rec->seq, &claimed, pos + LOG_RING_CAPACITY, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST)) {
+        return 0;  // Published in the meantime, or not claimed yet
+    }
+    ring->head = pos + 1;
+    __atomic_add_fetch(&ring->dropped, 1, __ATOMIC_RELAXED);
+    return 1;
+}
@@ -1,5 +1,7 @@
 #include "core/logger.h"
+#include "core/log_ring.h"
 #include "core/time_sim.h"
+#include "ipc/futex.h"
 #include <stdio.h>
 #include <stdarg.h>
 #include <string.h>
@@ -9,7 +11,10 @@
 static SharedState *g_state = NULL;
 static int g_use_colors = 0;
 static LogComponent g_component = LOG_UNKNOWN;
-static int g_debug_enabled = 1;
+static _Thread_local int g_thread_component = -1;  // -1 = use g_component
+int g_log_level = LOG_LEVEL_DEBUG;     // Runtime threshold checked by the log_* macros
+static LogRing *g_ring = NULL;          // LOG_ASYNC > 0: records go here instead of stderr
+static int g_ring_wait = 0;             // 1 = wait for space, 0 = drop when full
 
 #define COLOR_RESET "\033[0m"
 
@@ -37,6 +42,24 @@ void logger_init(SharedState *state, LogComponent comp) {
     g_state = state;
     g_component = comp;
     g_use_colors = isatty(STDERR_FILENO);
+    g_ring = log_ring_get(state);
+    g_ring_wait = (g_ring != NULL && state->cfg.log_async == LOG_ASYNC_BLOCK);
+}
+
+/**
+ * @brief Override the component color for the calling thread only.
+ *
+ * @param comp Component type for this thread's log lines.
+ */
+void logger_set_thread_component(LogComponent comp) {
+    g_thread_component = comp;
+}
+
+/**
+ * @brief Component override of the calling thread (-1 if none).
+ */
+int logger_get_thread_component(void) {
+    return g_thread_component;
 }
 
 /**
@@ -45,17 +68,17 @@ void logger_init(SharedState *state, LogComponent comp) {
  * @param enabled 1 to enable debug logs, 0 to disable.
  */
 void logger_set_debug_enabled(int enabled) {
-    g_debug_enabled = enabled;
+    g_log_level = enabled ? LOG_LEVEL_DEBUG : LOG_LEVEL_INFO;
 }
 
 /**
  * @brief Format simulation time as HH:MM:SS string.
  *
+ * @param total_sim_minutes Simulated minutes from midnight.
  * @param buf Output buffer for the formatted time.
  * @param buf_size Size of the output buffer.
  */
-static void format_sim_time(char *buf, int buf_size) {
-    double total_sim_minutes = g_state ? time_get_sim_minutes_f(g_state) : 0.0;
+static void format_sim_time(double total_sim_minutes, char *buf, int buf_size) {
     int total_minutes = (int)total_sim_minutes;
     int hours = total_minutes / 60;
     int minutes = total_minutes % 60;
@@ -73,7 +96,70 @@ static void format_sim_time(char *buf, int buf_size) {
 }
 
 /**
- * @brief Log a formatted message to stderr.
+ * @brief Format the line prefix: [TIME] [LEVEL] [COMPONENT] (with color).
+ *
+ * @param buf Output buffer.
+ * @param buf_size Size of the output buffer.
+ * @param level Log level string.
+ * @param component Component tag.
+ * @param comp Component type of the logging thread (color selection).
+ * @param sim_minutes Sim time of the entry.
+ * @param use_colors 1 to add ANSI colors.
+ * @param reset_out Output: reset sequence to append after the message.
+ * @return Number of bytes written.
+ */
+static int format_prefix(char *buf, int buf_size, const char *level, const char *component,
+                         LogComponent comp, double sim_minutes, int use_colors,
+                         const char **reset_out) {
+    char time_buf[16];
+    format_sim_time(sim_minutes, time_buf, sizeof(time_buf));
+
+    // Special case: KID logs use green for visibility
+    const char *color = "";
+    *reset_out = "";
+    if (use_colors) {
+        if (strcmp(component, "KID") == 0) {
+            color = "\033[32m";  // green for kids (darker than tourist's bright green)
+        } else if (comp < LOG_COMPONENT_COUNT) {
+            color = g_component_colors[comp];
+        }
+        *reset_out = COLOR_RESET;
+    }
+
+    return snprintf(buf, buf_size, "%s[%s] [%-5s] [%s] ", color, time_buf, level, component);
+}
+
+/**
+ * @brief Append one record to the log ring (LOG_ASYNC > 0).
+ *
+ * The message is formatted straight into the claimed slot; prefix, colors
+ * and the write() are left to the drainer.
+ */
+static void log_to_ring(const char *level, const char *component, LogComponent comp,
+                        const char *fmt, va_list args) {
+    uint64_t pos;
+    LogRecord *rec = log_ring_claim(g_ring, g_ring_wait, &pos);
+    if (rec == NULL) {
+        return;  // Dropped (counted in ring->dropped)
+    }
+
+    rec->sim_minutes = g_state ? time_get_sim_minutes_f(g_state) : 0.0;
+    rec->comp = (uint32_t)comp;
+    strncpy(rec->level, level, sizeof(rec->level) - 1);
+    rec->level[sizeof(rec->level) - 1] = '\0';
+    strncpy(rec->component, component, sizeof(rec->component) - 1);
+    rec->component[sizeof(rec->component) - 1] = '\0';
+
+    int len = vsnprintf(rec->text, sizeof(rec->text), fmt, args);
+    if (len < 0) len = 0;
+    if (len >= (int)sizeof(rec->text)) len = (int)sizeof(rec->text) - 1;
+    rec->len = (uint32_t)len;
+
+    log_ring_publish(g_ring, rec, pos);
+}
+
+/**
+ * @brief Log a formatted message to stderr (or to the log ring when LOG_ASYNC > 0).
  *
  * NOT signal-safe (uses snprintf). Format: [HH:MM:SS] [LEVEL] [COMPONENT] message
  *
@@ -82,36 +168,24 @@ static void format_sim_time(char *buf, int buf_size) {
  * @param fmt Printf-style format string.
  */
 void log_msg(const char *level, const char *component, const char *fmt, ...) {
-    // Skip debug logs if disabled
-    if (!g_debug_enabled && strcmp(level, LOG_DEBUG) == 0) {
+    // Get color for this component (based on process's component type set at init)
+    LogComponent comp = g_thread_component >= 0 ? (LogComponent)g_thread_component : g_component;
+
+    va_list args;
+    if (g_ring != NULL && !__atomic_load_n(&g_ring->stop, __ATOMIC_ACQUIRE)) {
+        va_start(args, fmt);
+        log_to_ring(level, component, comp, fmt, args);
+        va_end(args);
         return;
     }
 
     char buf[512];
-    char time_buf[16];
-    int len = 0;
-
-    // Format sim time
-    format_sim_time(time_buf, sizeof(time_buf));
-
-    // Get color for this component (based on process's component type set at init)
-    // Special case: KID logs use bright green for visibility
-    const char *color = "";
-    const char *reset = "";
-    if (g_use_colors) {
-        if (strcmp(component, "KID") == 0) {
-            color = "\033[32m";  // green for kids (darker than tourist's bright green)
-        } else if (g_component < LOG_COMPONENT_COUNT) {
-            color = g_component_colors[g_component];
-        }
-        reset = COLOR_RESET;
-    }
-
-    // Format prefix: [TIME] [LEVEL] [COMPONENT] (with color)
-    len = snprintf(buf, sizeof(buf), "%s[%s] [%-5s] [%s] ", color, time_buf, level, component);
+    const char *reset;
+    double sim_minutes = g_state ? time_get_sim_minutes_f(g_state) : 0.0;
+    int len = format_prefix(buf, sizeof(buf), level, component, comp, sim_minutes,
+                            g_use_colors, &reset);
 
     // Format message
-    va_list args;
     va_start(args, fmt);
     len += vsnprintf(buf + len, sizeof(buf) - len, fmt, args);
     va_end(args);
@@ -125,6 +199,45 @@ void log_msg(const char *level, const char *component, const char *fmt, ...) {
     write(STDERR_FILENO, buf, len);
 }
 
+/**
+ * @brief Format one ring record as a complete log line.
+ *
+ * @param rec Record from the log ring.
+ * @param buf Output buffer.
+ * @param buf_size Size of the output buffer (at least 512 bytes).
+ * @param use_colors 1 to add ANSI colors.
+ * @return Number of bytes written.
+ */
+int logger_format_record(const LogRecord *rec, char *buf, int buf_size, int use_colors) {
+    const char *reset;
+    int len = format_prefix(buf, buf_size, rec->level, rec->component,
+                            (LogComponent)rec->comp, rec->sim_minutes, use_colors, &reset);
+    int text_len = (int)rec->len;
+    if (len + text_len > buf_size - (int)sizeof(COLOR_RESET) - 1) {
+        text_len = buf_size - (int)sizeof(COLOR_RESET) - 1 - len;
+    }
+    memcpy(buf + len, rec->text, (size_t)text_len);
+    len += text_len;
+    len += snprintf(buf + len, buf_size - len, "%s\n", reset);
+    return len;
+}
+
+/**
+ * @brief Stop the log drainer and switch this process back to direct writes.
+ *
+ * The drainer writes everything still in the ring, then exits.
+ */
+void logger_async_stop(void) {
+    if (g_ring == NULL) {
+        return;
+    }
+    __atomic_store_n(&g_ring->stop, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&g_ring->items, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&g_ring->items, INT32_MAX);
+    futex_wake(&g_ring->space, INT32_MAX);
+    g_ring = NULL;
+}
+
 /**
  * @brief Signal-safe logging for use in signal handlers only.
  *
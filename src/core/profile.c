@@ -0,0 +1,145 @@
+/**
+ * @file core/profile.c
+ * @brief Per-process CPU time, context switches and optional cycle counters.
+ */
+
+#include "core/profile.h"
+#include "core/time_sim.h"
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief Open one user-space hardware counter for the calling process and its future threads.
+ *
+ * inherit_thread (Linux 5.13) keeps the forked children, tourists among
+ * them, out of the count; older kernels count the calling thread only.
+ *
+ * @param config PERF_COUNT_HW_* event.
+ * @param group_fd Group leader (-1 = this counter leads, created disabled).
+ * @return Descriptor, or -1 with errno.
+ */
+static int perf_open(uint64_t config, int group_fd) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    attr.disabled = group_fd == -1;     // The leader starts the whole group
+    attr.inherit = 1;
+    attr.inherit_thread = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    int fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+    if (fd == -1 && errno == EINVAL) {
+        attr.inherit = 0;
+        attr.inherit_thread = 0;
+        fd = (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, PERF_FLAG_FD_CLOEXEC);
+    }
+    return fd;
+}
+
+static int64_t timeval_us(const struct timeval *tv) {
+    return (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+}
+
+/**
+ * @brief Fill a ProcessUsage with the difference of two rusage snapshots.
+ */
+static void usage_delta(ProcessUsage *u, const struct rusage *now, const struct rusage *start,
+                        int64_t wall_ns) {
+    u->wall_ns = wall_ns;
+    u->user_us = timeval_us(&now->ru_utime) - timeval_us(&start->ru_utime);
+    u->sys_us = timeval_us(&now->ru_stime) - timeval_us(&start->ru_stime);
+    u->voluntary_cs = now->ru_nvcsw - start->ru_nvcsw;
+    u->involuntary_cs = now->ru_nivcsw - start->ru_nivcsw;
+    u->max_rss_kb = now->ru_maxrss;
+}
+
+void profile_begin(ProfileScope *scope, const Config *cfg) {
+    memset(scope, 0, sizeof(*scope));
+    scope->cycles_fd = -1;
+    scope->instructions_fd = -1;
+    getrusage(RUSAGE_SELF, &scope->self);
+    getrusage(RUSAGE_CHILDREN, &scope->children);
+
+    if (cfg->perf_counters) {
+        scope->cycles_fd = perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+        if (scope->cycles_fd == -1) {
+            scope->perf_error = errno;
+        } else {
+            scope->instructions_fd = perf_open(PERF_COUNT_HW_INSTRUCTIONS, scope->cycles_fd);
+            if (scope->instructions_fd == -1) {
+                scope->perf_error = errno;
+                close(scope->cycles_fd);
+                scope->cycles_fd = -1;
+            } else {
+                ioctl(scope->cycles_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(scope->cycles_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+        }
+    }
+    scope->start_ns = time_monotonic_ns();
+}
+
+void profile_end(ProfileScope *scope, SharedState *state) {
+    ProcessUsage u;
+    memset(&u, 0, sizeof(u));
+
+    if (scope->cycles_fd != -1) {
+        // Stop first, so the rest of this function is not counted
+        errno = 0;
+        ioctl(scope->cycles_fd, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+        if (read(scope->cycles_fd, &u.cycles, sizeof(u.cycles)) != sizeof(u.cycles) ||
+            read(scope->instructions_fd, &u.instructions, sizeof(u.instructions)) != sizeof(u.instructions)) {
+            scope->perf_error = errno != 0 ? errno : EIO;
+        }
+        close(scope->instructions_fd);
+        close(scope->cycles_fd);
+        scope->cycles_fd = scope->instructions_fd = -1;
+    }
+
+    struct rusage now;
+    getrusage(RUSAGE_SELF, &now);
+    usage_delta(&u, &now, &scope->self, time_monotonic_ns() - scope->start_ns);
+    u.pid = getpid();
+    u.perf_error = state->cfg.perf_counters ? scope->perf_error : 0;
+
+    ProcessProfile *p = &state->profile;
+    uint32_t slot = __atomic_fetch_add(&p->count, 1, __ATOMIC_RELAXED);
+    if (slot < PROFILE_MAX_PROCESSES) {
+        p->usage[slot] = u;  // Published to main by the process exit it waits for
+    }
+}
+
+void profile_end_tourists(const ProfileScope *scope, SharedState *state, uint32_t processes) {
+    struct rusage now;
+    getrusage(RUSAGE_CHILDREN, &now);
+    ProcessProfile *p = &state->profile;
+    usage_delta(&p->tourists, &now, &scope->children, time_monotonic_ns() - scope->start_ns);
+    p->tourist_processes = processes;
+}
+
+void profile_end_total(const ProfileScope *scope, SharedState *state) {
+    struct rusage self, children;
+    getrusage(RUSAGE_SELF, &self);
+    getrusage(RUSAGE_CHILDREN, &children);
+
+    ProcessUsage own, reaped;
+    int64_t wall_ns = time_monotonic_ns() - scope->start_ns;
+    usage_delta(&own, &self, &scope->self, wall_ns);
+    usage_delta(&reaped, &children, &scope->children, wall_ns);
+
+    ProcessUsage *t = &state->profile.total;
+    memset(t, 0, sizeof(*t));
+    t->wall_ns = wall_ns;
+    t->user_us = own.user_us + reaped.user_us;
+    t->sys_us = own.sys_us + reaped.sys_us;
+    t->voluntary_cs = own.voluntary_cs + reaped.voluntary_cs;
+    t->involuntary_cs = own.involuntary_cs + reaped.involuntary_cs;
+    t->max_rss_kb = own.max_rss_kb > reaped.max_rss_kb ? own.max_rss_kb : reaped.max_rss_kb;
+}
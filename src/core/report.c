@@ -1,71 +1,689 @@
 /**
  * @file report.c
  * @brief Final simulation report generation.
+ *
+ * The per-tourist section dominates the report for large runs, so it is not
+ * written through stdio. Tourist slots are formatted in blocks of
+ * REPORT_BLOCK_ROWS with int_to_str and fixed-width padding into plain
+ * buffers; up to REPORT_THREADS blocks are formatted in parallel per round
+ * (the first on the calling thread) and each round goes out with one
+ * writev() in slot order. Memory stays bounded at REPORT_THREADS blocks
+ * whatever the tourist count.
+ *
+ * With REPORT_INCREMENTAL=1 there is no table: the report writer process
+ * has already appended every row to REPORT_SPOOL_FILE_NAME (in completion
+ * order), and the report is the header, the spool copied with sendfile()
+ * and the aggregates.
  */
 
 #include "core/report.h"
 #include "constants.h"
+#include "core/stats.h"
+#include "core/chair_ring.h"
+#include "core/latency.h"
+#include "core/logger.h"
 #include "core/time_sim.h"
 
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
 
-int write_report_to_file(SharedState *state, const char *filepath) {
-    FILE *f = fopen(filepath, "w");
-    if (!f) {
+#define REPORT_TEXT_MAX 32768
+
+static const char *ticket_names[] = {"SINGLE", "TIME_T1", "TIME_T2", "TIME_T3", "DAILY"};
+static const char *type_names[] = {"Walker", "Cyclist", "Family"};
+
+/**
+ * @brief Formats one tourist row; returns the end of the written bytes.
+ */
+typedef char *(*RowFormatter)(char *p, int id, const TouristEntry *e);
+
+/**
+ * @brief One block of tourist slots and the buffer its rows go to.
+ */
+typedef struct {
+    const SharedState *state;
+    RowFormatter format;
+    int begin;                      // First slot (inclusive)
+    int end;                        // Last slot (exclusive)
+    char *buf;                      // REPORT_BLOCK_ROWS * REPORT_ROW_MAX bytes
+    size_t len;                     // Bytes formatted
+} RowBlock;
+
+/**
+ * @brief Small text section (header, aggregates, latency table).
+ */
+typedef struct {
+    char data[REPORT_TEXT_MAX];
+    size_t len;
+} TextBuf;
+
+/**
+ * @brief Name of a worker or helper process from its PID (as spawned, "?" if unknown).
+ */
+static void worker_name(const SharedState *state, pid_t pid, char *buf, size_t size) {
+    snprintf(buf, size, "?");
+    if (pid == state->time_server_pid) {
+        snprintf(buf, size, "TimeServer");
+    } else if (pid == state->main_pid) {
+        snprintf(buf, size, "Main");
+    } else if (pid == state->generator_pid) {
+        snprintf(buf, size, "Generator");
+    } else if (pid == state->gateway_pid) {
+        snprintf(buf, size, "RemoteGateway");
+    } else if (pid == state->log_drainer_pid) {
+        snprintf(buf, size, "LogDrainer");
+    } else if (pid == state->metrics_pid) {
+        snprintf(buf, size, "MetricsExporter");
+    } else if (pid == state->report_writer_pid) {
+        snprintf(buf, size, "ReportWriter");
+    }
+    for (int c = 0; c < state->cfg.cashier_count; c++) {
+        if (pid == state->cashier_pid[c]) {
+            snprintf(buf, size, c > 0 ? "Cashier%d" : "Cashier", c);
+        }
+    }
+    for (int l = 0; l < state->cfg.line_count; l++) {
+        if (pid == state->lower_worker_pid[l]) {
+            snprintf(buf, size, l > 0 ? "LowerWorker%d" : "LowerWorker", l);
+        } else if (pid == state->upper_worker_pid[l]) {
+            snprintf(buf, size, l > 0 ? "UpperWorker%d" : "UpperWorker", l);
+        }
+        for (int b = 0; b < state->cfg.boarding_workers - 1; b++) {
+            if (pid == state->boarding_worker_pid[l][b]) {
+                snprintf(buf, size, "BoardingWorker%d.%d", l, b + 1);
+            }
+        }
+    }
+}
+
+static void text_printf(TextBuf *t, const char *fmt, ...) {
+    if (t->len >= sizeof(t->data)) return;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(t->data + t->len, sizeof(t->data) - t->len, fmt, ap);
+    va_end(ap);
+    if (n > 0) {
+        t->len += (size_t)n;
+        if (t->len > sizeof(t->data) - 1) t->len = sizeof(t->data) - 1;
+    }
+}
+
+static int usage_by_pid(const void *a, const void *b) {
+    pid_t pa = ((const ProcessUsage *)a)->pid, pb = ((const ProcessUsage *)b)->pid;
+    return (pa > pb) - (pa < pb);
+}
+
+/**
+ * @brief One row of the CPU usage section.
+ */
+static void usage_row(TextBuf *t, const char *name, const ProcessUsage *u) {
+    double cpu_s = (u->user_us + u->sys_us) / 1e6;
+    text_printf(t, "    %-20s %8.3f %8.3f %8.3f %6.1f %9lld %9lld %9lld\n", name,
+                u->wall_ns / 1e9, u->user_us / 1e6, u->sys_us / 1e6,
+                u->wall_ns > 0 ? 100.0 * cpu_s / (u->wall_ns / 1e9) : 0.0,
+                (long long)u->voluntary_cs, (long long)u->involuntary_cs, (long long)u->max_rss_kb);
+}
+
+/**
+ * @brief CPU usage section: rusage per process in PID (spawn) order, the tourists and the run total.
+ *
+ * With PERF_COUNTERS=1 a second table gives each process's user-space
+ * cycles, instructions and IPC.
+ */
+static void report_processes(TextBuf *t, const SharedState *state) {
+    const ProcessProfile *p = &state->profile;
+    uint32_t count = p->count < PROFILE_MAX_PROCESSES ? p->count : PROFILE_MAX_PROCESSES;
+    ProcessUsage usage[PROFILE_MAX_PROCESSES];
+    for (uint32_t i = 0; i < count; i++) {
+        usage[i] = p->usage[i];
+    }
+    qsort(usage, count, sizeof(usage[0]), usage_by_pid);
+
+    text_printf(t, "\n--- CPU Usage per Process (real s, CPU s) ---\n");
+    text_printf(t, "    %-20s %8s %8s %8s %6s %9s %9s %9s\n", "Process", "Wall", "User", "System",
+                "CPU%", "Vol. cs", "Invol. cs", "RSS KB");
+    char name[32];
+    for (uint32_t i = 0; i < count; i++) {
+        worker_name(state, usage[i].pid, name, sizeof(name));
+        usage_row(t, name, &usage[i]);
+    }
+    if (p->tourist_processes > 0) {
+        snprintf(name, sizeof(name), "Tourists (%u)", p->tourist_processes);
+        usage_row(t, name, &p->tourists);
+    }
+    usage_row(t, "Total", &p->total);
+    if (p->count > PROFILE_MAX_PROCESSES) {
+        text_printf(t, "  (%u processes not listed, PROFILE_MAX_PROCESSES %d)\n",
+                    p->count - PROFILE_MAX_PROCESSES, PROFILE_MAX_PROCESSES);
+    }
+
+    if (!state->cfg.perf_counters) {
+        return;
+    }
+    text_printf(t, "\n--- CPU Counters (user space, perf_event_open) ---\n");
+    text_printf(t, "    %-20s %16s %16s %6s\n", "Process", "Cycles", "Instructions", "IPC");
+    for (uint32_t i = 0; i < count; i++) {
+        worker_name(state, usage[i].pid, name, sizeof(name));
+        int err = usage[i].perf_error;
+        if (err == ENOENT || err == EOPNOTSUPP) {
+            text_printf(t, "    %-20s unavailable (no hardware counters on this CPU or VM)\n", name);
+        } else if (err == EACCES || err == EPERM) {
+            text_printf(t, "    %-20s unavailable (%s, see kernel.perf_event_paranoid)\n", name,
+                        strerror(err));
+        } else if (err != 0) {
+            text_printf(t, "    %-20s unavailable (%s)\n", name, strerror(err));
+        } else {
+            text_printf(t, "    %-20s %16llu %16llu %6.2f\n", name,
+                        (unsigned long long)usage[i].cycles, (unsigned long long)usage[i].instructions,
+                        usage[i].cycles > 0 ? (double)usage[i].instructions / usage[i].cycles : 0.0);
+        }
+    }
+}
+
+/**
+ * @brief Queue pressure section: limits, peaks, time at full and blocked sends per queue kind.
+ *
+ * Printed when QUEUE_SAMPLE_MS > 0 or some send found its queue full; without
+ * sampling only the blocked sends are known.
+ */
+static void report_queues(TextBuf *t, const SharedState *state) {
+    static const char *names[] = {"Cashier", "Platform", "Boarding", "Arrivals", "Worker", "Spawn"};
+    const QueueStats *qs = &state->queue_stats;
+    uint64_t blocked = 0;
+    for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+        blocked += qs->queue[k].blocked_sends;
+    }
+    int sampled = state->cfg.queue_sample_ms > 0;
+    if (!sampled && blocked == 0) {
+        return;
+    }
+
+    if (sampled) {
+        text_printf(t, "\n--- Queue Pressure (%llu samples, every %d ms) ---\n",
+                    (unsigned long long)qs->queue[QUEUE_PLATFORM].samples, state->cfg.queue_sample_ms);
+    } else {
+        text_printf(t, "\n--- Queue Pressure (not sampled, QUEUE_SAMPLE_MS=0) ---\n");
+    }
+    text_printf(t, "    %-10s %12s %10s %11s %9s %7s %10s\n", "Queue", "Limit", "Peak msgs",
+                "Peak bytes", "Full s", "Full%", "Blocked");
+    for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+        const QueuePressure *q = &qs->queue[k];
+        if (!sampled || q->samples == 0) {
+            text_printf(t, "    %-10s %12s %10s %11s %9s %7s %10llu\n", names[k], "-", "-", "-", "-",
+                        "-", (unsigned long long)q->blocked_sends);
+            continue;
+        }
+        char limit[24];
+        if (q->limit_bytes > 0) {
+            snprintf(limit, sizeof(limit), "%llu B", (unsigned long long)q->limit_bytes);
+        } else if (q->limit_messages > 0) {
+            snprintf(limit, sizeof(limit), "%u slots", q->limit_messages);
+        } else {
+            snprintf(limit, sizeof(limit), "-");
+        }
+        text_printf(t, "    %-10s %12s %10u %11llu %9.3f %6.1f%% %10llu\n", names[k], limit,
+                    q->high_water, (unsigned long long)q->high_water_bytes, q->full_ns / 1e9,
+                    100.0 * q->full_samples / q->samples, (unsigned long long)q->blocked_sends);
+    }
+}
+
+static char *put_str(char *p, const char *s) {
+    while (*s) *p++ = *s++;
+    return p;
+}
+
+/**
+ * @brief Left-aligned string padded with spaces to width (like "%-*s").
+ */
+static char *put_padded(char *p, const char *s, int width) {
+    char *start = p;
+    p = put_str(p, s);
+    while (p - start < width) *p++ = ' ';
+    return p;
+}
+
+static char *put_int_padded(char *p, int n, int width) {
+    char num[16];
+    int_to_str(n, num, sizeof(num));
+    return put_padded(p, num, width);
+}
+
+char *report_format_text_row(char *p, int id, const TouristEntry *e) {
+    p = put_int_padded(p, id, 6);
+    *p++ = ' ';
+    p = put_padded(p, type_names[e->tourist_type], 8);
+    *p++ = ' ';
+    p = put_padded(p, ticket_names[e->ticket_type], 10);
+    *p++ = ' ';
+    p = put_int_padded(p, (int)e->total_rides, 6);
+    *p++ = ' ';
+    if (e->is_vip) p = put_str(p, "VIP ");
+    if (e->kid_count > 0) {
+        *p++ = '+';
+        p = put_int_padded(p, (int)e->kid_count, 0);
+        p = put_str(p, " kids");
+    }
+    *p++ = '\n';
+    return p;
+}
+
+char *report_format_csv_row(char *p, int id, const TouristEntry *e) {
+    p = put_int_padded(p, id, 0);
+    *p++ = ',';
+    p = put_str(p, type_names[e->tourist_type]);
+    *p++ = ',';
+    p = put_str(p, ticket_names[e->ticket_type]);
+    *p++ = ',';
+    p = put_int_padded(p, (int)e->total_rides, 0);
+    *p++ = ',';
+    *p++ = e->is_vip ? '1' : '0';
+    *p++ = ',';
+    p = put_int_padded(p, (int)e->kid_count, 0);
+    *p++ = '\n';
+    return p;
+}
+
+/**
+ * @brief Format every active slot of one block.
+ */
+static void *format_block(void *arg) {
+    RowBlock *b = arg;
+    char *p = b->buf;
+    for (int i = b->begin; i < b->end; i++) {
+        const TouristEntry *e = &b->state->tourist_entries[i];
+        if (!__atomic_load_n(&e->active, __ATOMIC_ACQUIRE)) continue;
+        p = b->format(p, i + 1, e);
+    }
+    b->len = (size_t)(p - b->buf);
+    return NULL;
+}
+
+/**
+ * @brief writev() the whole vector, resuming after partial writes.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int write_all(int fd, struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        ssize_t n = writev(fd, iov, iovcnt);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("report: writev");
+            return -1;
+        }
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char *)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Stream every tracked tourist as rows between a head and a tail.
+ *
+ * @param fd Output file.
+ * @param state Shared state with the tourist table.
+ * @param format Row formatter.
+ * @param head Bytes before the first row (may be NULL / 0).
+ * @param tail Bytes after the last row (may be NULL / 0).
+ * @return 0 on success, -1 on error.
+ */
+static int stream_rows(int fd, const SharedState *state, RowFormatter format,
+                       const TextBuf *head, const TextBuf *tail) {
+    int slots = state->tourist_entry_count;
+    if (slots > state->max_tracked_tourists) slots = state->max_tracked_tourists;
+
+    int threads = (slots + REPORT_BLOCK_ROWS - 1) / REPORT_BLOCK_ROWS;
+    if (threads > REPORT_THREADS) threads = REPORT_THREADS;
+    if (threads < 1) threads = 1;
+
+    RowBlock blocks[REPORT_THREADS];
+    for (int t = 0; t < threads; t++) {
+        blocks[t].state = state;
+        blocks[t].format = format;
+        blocks[t].buf = malloc((size_t)REPORT_BLOCK_ROWS * REPORT_ROW_MAX);
+        if (!blocks[t].buf) {
+            perror("report: malloc");
+            while (t-- > 0) free(blocks[t].buf);
+            return -1;
+        }
+    }
+
+    int result = 0;
+    int next = 0;
+    int first = 1;
+    do {
+        struct iovec iov[REPORT_THREADS + 2];
+        int iovcnt = 0;
+        if (first && head) {
+            iov[iovcnt++] = (struct iovec){(void *)head->data, head->len};
+        }
+        first = 0;
+
+        // One block per thread this round; block 0 runs here
+        pthread_t tids[REPORT_THREADS];
+        int started[REPORT_THREADS] = {0};
+        int used = 0;
+        for (int t = 0; t < threads && next < slots; t++, used++) {
+            blocks[t].begin = next;
+            blocks[t].end = next + REPORT_BLOCK_ROWS < slots ? next + REPORT_BLOCK_ROWS : slots;
+            next = blocks[t].end;
+            if (t > 0) {
+                started[t] = pthread_create(&tids[t], NULL, format_block, &blocks[t]) == 0;
+            }
+        }
+        for (int t = 0; t < used; t++) {
+            if (t == 0 || !started[t]) {
+                format_block(&blocks[t]);  // Calling thread, or pthread_create failed
+            } else {
+                pthread_join(tids[t], NULL);
+            }
+            iov[iovcnt++] = (struct iovec){blocks[t].buf, blocks[t].len};
+        }
+
+        if (next >= slots && tail) {
+            iov[iovcnt++] = (struct iovec){(void *)tail->data, tail->len};
+        }
+        if (write_all(fd, iov, iovcnt) == -1) {
+            result = -1;
+            break;
+        }
+    } while (next < slots);
+
+    for (int t = 0; t < threads; t++) {
+        free(blocks[t].buf);
+    }
+    return result;
+}
+
+/**
+ * @brief Write head, the report writer's spool file, and tail; remove the spool.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int write_spooled_rows(int fd, const TextBuf *head, const TextBuf *tail) {
+    struct iovec iov = {(void *)head->data, head->len};
+    if (write_all(fd, &iov, 1) == -1) {
+        return -1;
+    }
+
+    int spool = open(REPORT_SPOOL_FILE_NAME, O_RDONLY);
+    if (spool == -1) {
+        perror("report: open spool");
+        return -1;
+    }
+    struct stat st;
+    int result = fstat(spool, &st);
+    off_t offset = 0;
+    while (result == 0 && offset < st.st_size) {
+        ssize_t n = sendfile(fd, spool, &offset, (size_t)(st.st_size - offset));
+        if (n == -1 && errno == EINTR) continue;
+        if (n <= 0) result = -1;
+    }
+    if (result == -1) {
+        perror("report: copy spool");
+    }
+    close(spool);
+    unlink(REPORT_SPOOL_FILE_NAME);
+
+    iov = (struct iovec){(void *)tail->data, tail->len};
+    if (result == 0 && write_all(fd, &iov, 1) == -1) {
+        result = -1;
+    }
+    return result;
+}
+
+/**
+ * @brief Open filepath for writing, stream the rows, close.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int write_rows_file(const SharedState *state, const char *filepath, RowFormatter format,
+                           const TextBuf *head, const TextBuf *tail) {
+    int fd = open(filepath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
         perror("Failed to open report file");
         return -1;
     }
+    int result = state->cfg.report_incremental ? write_spooled_rows(fd, head, tail)
+                                           : stream_rows(fd, state, format, head, tail);
+    if (close(fd) == -1) {
+        perror("report: close");
+        result = -1;
+    }
+    return result;
+}
 
+int write_report_to_file(SharedState *state, const char *filepath) {
     char start_buf[8], end_buf[8];
     time_format_minutes(state->sim_start_minutes, start_buf, sizeof(start_buf));
     time_format_minutes(state->sim_end_minutes, end_buf, sizeof(end_buf));
 
-    fprintf(f, "========== SIMULATION REPORT ==========\n");
-    fprintf(f, "Duration: %s - %s (simulated)\n", start_buf, end_buf);
-    fprintf(f, "Total tourists: %d\n", state->total_tourists);
-    fprintf(f, "Total rides: %d\n\n", state->total_rides);
+    StatsSnapshot stats;
+    stats_snapshot(state, &stats);
 
-    // Per-tourist summary
-    fprintf(f, "--- Per-Tourist Summary ---\n");
-    fprintf(f, "%-6s %-8s %-10s %-6s %s\n",
-           "ID", "Type", "Ticket", "Rides", "Notes");
-    fprintf(f, "-------------------------------------\n");
+    TextBuf head = {.len = 0};
+    text_printf(&head, "========== SIMULATION REPORT ==========\n");
+    text_printf(&head, "Duration: %s - %s (simulated)\n", start_buf, end_buf);
+    text_printf(&head, "Total tourists: %d\n", stats.total_tourists);
+    text_printf(&head, "Total rides: %d\n\n", stats.total_rides);
 
-    const char *ticket_names[] = {"SINGLE", "TIME_T1", "TIME_T2", "TIME_T3", "DAILY"};
-    const char *type_names[] = {"Walker", "Cyclist", "Family"};
+    // Per-tourist summary (rows streamed by stream_rows, or spooled by the report writer)
+    text_printf(&head, "--- Per-Tourist Summary ---\n");
+    text_printf(&head, "%-6s %-8s %-10s %-6s %s\n",
+                "ID", "Type", "Ticket", "Rides", "Notes");
+    text_printf(&head, "-------------------------------------\n");
 
-    for (int i = 0; i < state->tourist_entry_count && i < state->max_tracked_tourists; i++) {
-        TouristEntry *e = &state->tourist_entries[i];
-        if (!e->active) continue;
+    // Aggregates by ticket type
+    TextBuf tail = {.len = 0};
+    text_printf(&tail, "\n--- Aggregates by Ticket Type ---\n");
+    for (int i = 0; i < TICKET_COUNT; i++) {
+        text_printf(&tail, "  %-10s %5d tourists, %5d rides\n",
+                    ticket_names[i],
+                    stats.tourists_by_ticket[i],
+                    stats.rides_by_ticket[i]);
+    }
 
-        char notes[32] = "";
-        if (e->is_vip) strcat(notes, "VIP ");
-        if (e->kid_count > 0) {
-            char kid_note[16];
-            snprintf(kid_note, sizeof(kid_note), "+%d kids", e->kid_count);
-            strcat(notes, kid_note);
+    // Chair utilization: slots occupied on departed chairs out of CHAIR_CAPACITY each
+    text_printf(&tail, "\n--- Chair Utilization ---\n");
+    unsigned long long chairs_total = 0, slots_total = 0;
+    for (int l = 0; l < state->cfg.line_count; l++) {
+        unsigned long long chairs = __atomic_load_n(&state->lines[l].chairs_departed, __ATOMIC_RELAXED);
+        unsigned long long slots = __atomic_load_n(&state->lines[l].chair_slots_departed,
+                                                   __ATOMIC_RELAXED);
+        chairs_total += chairs;
+        slots_total += slots;
+        if (state->cfg.line_count > 1) {
+            text_printf(&tail, "  Line %-4d %8llu chairs, %5.1f%% of slots used\n", l + 1, chairs,
+                        chairs > 0 ? 100.0 * (double)slots / (double)(chairs * CHAIR_CAPACITY) : 0.0);
+        }
+    }
+    text_printf(&tail, "  Chairs departed: %llu\n", chairs_total);
+    text_printf(&tail, "  Slot utilization: %.1f%% (%.2f/%d slots per chair)\n",
+                chairs_total > 0 ? 100.0 * (double)slots_total / (double)(chairs_total * CHAIR_CAPACITY)
+                                 : 0.0,
+                chairs_total > 0 ? (double)slots_total / (double)chairs_total : 0.0, CHAIR_CAPACITY);
+    if (state->cfg.chair_interval_sim > 0) {
+        // Cadence departures: empty chairs count as departed above
+        text_printf(&tail, "  Chair ring: one chair every %d sim s, %d chairs going up\n",
+                    state->cfg.chair_interval_sim, chair_ring_transit(&state->cfg));
+        for (int l = 0; l < state->cfg.line_count; l++) {
+            const LineState *ls = &state->lines[l];
+            unsigned departures = __atomic_load_n(&ls->ring_departures, __ATOMIC_RELAXED);
+            unsigned empty = __atomic_load_n(&ls->ring_empty, __ATOMIC_RELAXED);
+            text_printf(&tail, "  Ring line %d: %u departures, %u empty (%.1f%%), %u seats going up at close\n",
+                        l + 1, departures, empty,
+                        departures > 0 ? 100.0 * (double)empty / (double)departures : 0.0,
+                        chair_ring_slots_up(ls));
         }
+    }
 
-        fprintf(f, "%-6d %-8s %-10s %-6d %s\n",
-               e->tourist_id,
-               type_names[e->tourist_type],
-               ticket_names[e->ticket_type],
-               e->total_rides,
-               notes);
+    // Wait latencies (real time, bucket upper edges: within ~6%)
+    const char *stage_names[] = {"Entry gates", "Lower station", "Platform gates",
+                                 "Boarding", "Exit gates"};
+    text_printf(&tail, "\n--- Wait Latency (real ms) ---\n");
+    text_printf(&tail, "  %-15s %8s %10s %10s %10s %10s %10s\n",
+                "Stage", "Samples", "Mean", "p50", "p90", "p99", "Max");
+    for (int i = 0; i < LAT_STAGE_COUNT; i++) {
+        const LatencyHistogram *h = &state->latency[i];
+        double mean_ms = h->count > 0 ? (double)h->sum_us / (double)h->count / 1000.0 : 0.0;
+        text_printf(&tail, "  %-15s %8llu %10.3f %10.3f %10.3f %10.3f %10.3f\n",
+                    stage_names[i],
+                    (unsigned long long)h->count,
+                    mean_ms,
+                    latency_percentile(h, 0.50) / 1000.0,
+                    latency_percentile(h, 0.90) / 1000.0,
+                    latency_percentile(h, 0.99) / 1000.0,
+                    h->max_us / 1000.0);
     }
 
-    // Aggregates by ticket type
-    fprintf(f, "\n--- Aggregates by Ticket Type ---\n");
-    for (int i = 0; i < TICKET_COUNT; i++) {
-        fprintf(f, "  %-10s %5d tourists, %5d rides\n",
-               ticket_names[i],
-               state->tourists_by_ticket[i],
-               state->rides_by_ticket[i]);
+    // Generator children: how they ended, how long they lived, how well reaping batched
+    const TouristExits *exits = &state->tourist_exits;
+    const LatencyHistogram *life = &exits->lifetime;
+    text_printf(&tail, "\n--- Tourist Processes ---\n");
+    text_printf(&tail, "  Reaped: %u (exit 0: %u, exit != 0: %u, killed: %u)\n",
+                exits->reaped, exits->exit_ok, exits->exit_error, exits->killed);
+    text_printf(&tail, "  Reaper wakeups: %u (%.2f children per wakeup, max %u)\n",
+                exits->wakeups,
+                exits->wakeups > 0 ? (double)exits->reaped / (double)exits->wakeups : 0.0,
+                exits->max_batch);
+    text_printf(&tail, "  Lifetime (real ms): mean %.3f, p50 %.3f, p99 %.3f, max %.3f (%llu samples)\n",
+                life->count > 0 ? (double)life->sum_us / (double)life->count / 1000.0 : 0.0,
+                latency_percentile(life, 0.50) / 1000.0,
+                latency_percentile(life, 0.99) / 1000.0,
+                life->max_us / 1000.0,
+                (unsigned long long)life->count);
+
+    // Checkpoint files written by this run and the checkpoint it continued
+    const CheckpointStats *ck = &state->checkpoint;
+    if (state->cfg.checkpoint_interval_sim > 0 || state->restored) {
+        text_printf(&tail, "\n--- Checkpoints ---\n");
+        if (state->restored) {
+            int resume_min = (int)(state->resume_sim_ms / 60000);
+            text_printf(&tail, "  Restored from: %02d:%02d (%d tourists spawned before)\n",
+                        resume_min / 60, resume_min % 60, state->resume_tourists);
+        }
+        if (state->cfg.checkpoint_interval_sim > 0) {
+            int last_min = (int)(ck->last_sim_ms / 60000);
+            text_printf(&tail, "  Written: %u of %u taken (every %d sim minutes, failed: %u, skipped: %u)\n",
+                        ck->written, ck->taken, state->cfg.checkpoint_interval_sim,
+                        ck->failed, ck->skipped);
+            if (ck->written > 0) {
+                text_printf(&tail, "  Last: %02d:%02d, %llu bytes\n", last_min / 60, last_min % 60,
+                            (unsigned long long)ck->last_bytes);
+            }
+            text_printf(&tail, "  Copy stall (real ms): mean %.3f, max %.3f; write + fsync max %.3f\n",
+                        ck->taken > 0 ? (double)ck->copy_ns_sum / ck->taken / 1e6 : 0.0,
+                        ck->copy_ns_max / 1e6, ck->write_ns_max / 1e6);
+        }
     }
 
-    fprintf(f, "\n=======================================\n");
+    // Danger stops recorded for, or replayed from, DANGER_SCHEDULE_FILE_NAME
+    const DangerLog *danger = &state->danger;
+    if (state->cfg.danger_schedule != DANGER_SCHEDULE_OFF) {
+        uint32_t kept = danger->count < DANGER_SCHEDULE_MAX ? danger->count : DANGER_SCHEDULE_MAX;
+        text_printf(&tail, "\n--- Danger Schedule ---\n");
+        if (state->cfg.danger_schedule == DANGER_SCHEDULE_RECORD) {
+            text_printf(&tail, "  Recorded: %u stops to %s (dropped: %u)\n",
+                        kept, DANGER_SCHEDULE_FILE_NAME, danger->dropped);
+        } else {
+            text_printf(&tail, "  Replayed: %u of %u stops from %s (missed: %u)\n",
+                        kept, danger->script_count, DANGER_SCHEDULE_FILE_NAME, danger->missed);
+        }
+        for (uint32_t i = 0; i < kept; i++) {
+            const DangerEvent *e = &danger->events[i];
+            int sec = (int)(e->sim_ms / 1000);
+            text_printf(&tail, "    %02d:%02d:%02d  line %u  %s worker\n", sec / 3600,
+                        (sec / 60) % 60, sec % 60, e->line,
+                        e->worker == WORKER_LOWER ? "lower" : "upper");
+        }
+    }
 
-    fclose(f);
-    return 0;
+    // Tourists queued by the remote gateway for other hosts
+    const RemoteStats *remote = &state->remote;
+    if (state->cfg.remote_port > 0) {
+        text_printf(&tail, "\n--- Remote Hosts ---\n");
+        text_printf(&tail, "  Port: %d, hosts: %u (refused: %u)\n", state->cfg.remote_port,
+                    remote->hosts, remote->hosts_refused);
+        text_printf(&tail, "  Tourists: %u of %d remote IDs queued, %u rejected\n",
+                    remote->accepted, state->cfg.remote_tourists, remote->rejected);
+        text_printf(&tail, "  Batches: %u (mean %.1f tourists, max %u), gateway time per batch (real ms): mean %.3f, max %.3f\n",
+                    remote->batches,
+                    remote->batches > 0 ? (double)(remote->accepted + remote->rejected) / remote->batches : 0.0,
+                    remote->max_batch,
+                    remote->batches > 0 ? (double)remote->batch_ns_sum / remote->batches / 1e6 : 0.0,
+                    remote->batch_ns_max / 1e6);
+    }
+
+    // Startup stages and each worker's fork-to-ready time, in ready order
+    const StartupTiming *st = &state->startup;
+    text_printf(&tail, "\n--- Startup (real ms) ---\n");
+    text_printf(&tail, "  %-22s %10.3f\n", "Config:", st->config_ns / 1e6);
+    text_printf(&tail, "  %-22s %10.3f\n", "Stale cleanup:", st->cleanup_ns / 1e6);
+    text_printf(&tail, "  %-22s %10.3f\n", st->ipc_reset ? "IPC reset:" : "IPC create:", st->ipc_ns / 1e6);
+    text_printf(&tail, "  %-22s %10.3f\n", "Fork:", st->fork_ns / 1e6);
+    text_printf(&tail, "  %-22s %10.3f\n", "Ready barrier:", st->ready_ns / 1e6);
+    uint32_t ready = st->ready_count < STARTUP_MAX_WORKERS ? st->ready_count : STARTUP_MAX_WORKERS;
+    text_printf(&tail, "  Worker fork to ready (%u):\n", ready);
+    for (uint32_t i = 0; i < ready; i++) {
+        char name[32];
+        worker_name(state, st->ready[i].pid, name, sizeof(name));
+        if (st->ready[i].spawn_ns > 0) {
+            text_printf(&tail, "    %-20s %10.3f\n", name,
+                        (st->ready[i].ready_ns - st->ready[i].spawn_ns) / 1e6);
+        } else {
+            text_printf(&tail, "    %-20s %10s\n", name, "-");
+        }
+    }
+
+    report_processes(&tail, state);
+    report_queues(&tail, state);
+
+    text_printf(&tail, "\n--- Resources ---\n");
+    text_printf(&tail, "  Shared memory: %zu bytes\n", state->shm_size);
+    text_printf(&tail, "  Page size: %zu bytes (%s)\n", state->shm_page_size,
+                state->cfg.shm_huge_pages == SHM_PAGES_TRANSPARENT ? "transparent huge pages advised"
+                : state->shm_page_size > (size_t)sysconf(_SC_PAGESIZE) ? "hugetlb" : "base pages");
+    text_printf(&tail, "  Config block: %zu of %d bytes, %s\n", sizeof(Config), CONFIG_BLOCK_SIZE,
+                state->cfg_sealed ? "read-only in children" : "writable (page larger than the block)");
+    if (state->numa_nodes > 0) {
+        text_printf(&tail, "  NUMA: %d line(s) over %d node(s)\n", state->cfg.line_count, state->numa_nodes);
+    }
+    if (state->worker_cpus > 0) {
+        if (state->tourist_cpus > 0) {
+            text_printf(&tail, "  Worker cores: %d dedicated, %d for main and tourists\n",
+                        state->worker_cpus, state->tourist_cpus);
+        } else {
+            text_printf(&tail, "  Worker cores: %d, shared with main and tourists\n", state->worker_cpus);
+        }
+    }
+    if (state->cfg.worker_sched_fifo > 0) {
+        text_printf(&tail, "  SCHED_FIFO: priority %d (time server, boarding workers)\n",
+                    state->cfg.worker_sched_fifo);
+    }
+
+    text_printf(&tail, "\n=======================================\n");
+
+    return write_rows_file(state, filepath, report_format_text_row, &head, &tail);
+}
+
+int write_report_csv(SharedState *state, const char *filepath) {
+    TextBuf head = {.len = 0};
+    text_printf(&head, REPORT_CSV_HEADER);
+    return write_rows_file(state, filepath, report_format_csv_row, &head, NULL);
 }
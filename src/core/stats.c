@@ -0,0 +1,121 @@
+/**
+ * @file core/stats.c
+ * @brief Sharded simulation statistics in shared memory.
+ */
+
+#include "core/stats.h"
+
+#include <string.h>
+
+_Static_assert(sizeof(StatsShard) == 64, "StatsShard must fill exactly one cache line");
+
+// This thread's claimed shard (NULL until first update)
+static __thread StatsShard *tls_shard = NULL;
+static __thread int tls_exclusive = 0;
+
+/**
+ * @brief Claim a free shard, or fall back to the shared slot 0.
+ */
+static StatsShard *shard_get(SharedState *state) {
+    if (tls_shard != NULL) {
+        return tls_shard;
+    }
+
+    uint32_t start = __atomic_fetch_add(&state->stats_shard_hint, 1, __ATOMIC_RELAXED);
+    for (int n = 0; n < STATS_SHARD_COUNT - 1; n++) {
+        int idx = 1 + (int)((start + (uint32_t)n) % (STATS_SHARD_COUNT - 1));
+        uint32_t expected = 0;
+        if (__atomic_compare_exchange_n(&state->stats_shards[idx].claimed, &expected, 1, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            tls_shard = &state->stats_shards[idx];
+            tls_exclusive = 1;
+            return tls_shard;
+        }
+    }
+
+    // Table full: share slot 0 with atomic adds
+    tls_shard = &state->stats_shards[0];
+    tls_exclusive = 0;
+    return tls_shard;
+}
+
+/**
+ * @brief Add n to a shard counter (plain store if owned, atomic add if shared).
+ */
+static void shard_add(int *counter, int n) {
+    if (tls_exclusive) {
+        __atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + n,
+                         __ATOMIC_RELAXED);
+    } else {
+        __atomic_add_fetch(counter, n, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Count completed rides for this thread's shard.
+ *
+ * @param state Shared state.
+ * @param ticket_type TicketType of the riders.
+ * @param rides Number of riders (parent + kids).
+ */
+void stats_add_rides(SharedState *state, int ticket_type, int rides) {
+    StatsShard *s = shard_get(state);
+    shard_add(&s->total_rides, rides);
+    if (ticket_type >= 0 && ticket_type < TICKET_COUNT) {
+        shard_add(&s->rides_by_ticket[ticket_type], rides);
+    }
+}
+
+/**
+ * @brief Count tourists sold a ticket for this thread's shard.
+ *
+ * @param state Shared state.
+ * @param ticket_type TicketType sold.
+ * @param tourists Number of tourists (parent + kids).
+ */
+void stats_add_tourists(SharedState *state, int ticket_type, int tourists) {
+    StatsShard *s = shard_get(state);
+    shard_add(&s->total_tourists, tourists);
+    if (ticket_type >= 0 && ticket_type < TICKET_COUNT) {
+        shard_add(&s->tourists_by_ticket[ticket_type], tourists);
+    }
+}
+
+/**
+ * @brief Return this thread's shard to the free pool.
+ *
+ * @param state Shared state.
+ */
+void stats_release(SharedState *state) {
+    (void)state;
+    if (tls_shard != NULL && tls_exclusive) {
+        // Release orders this thread's last updates before the next owner's
+        __atomic_store_n(&tls_shard->claimed, 0, __ATOMIC_RELEASE);
+    }
+    tls_shard = NULL;
+    tls_exclusive = 0;
+}
+
+/**
+ * @brief Sum all shards into a snapshot.
+ *
+ * Each counter is read atomically; the totals are a consistent sum only
+ * once writers have stopped (final report), and a close approximation
+ * while they run (live snapshot).
+ *
+ * @param state Shared state.
+ * @param out Output snapshot.
+ */
+void stats_snapshot(const SharedState *state, StatsSnapshot *out) {
+    memset(out, 0, sizeof(*out));
+    for (int i = 0; i < STATS_SHARD_COUNT; i++) {
+        const StatsShard *s = &state->stats_shards[i];
+        out->total_tourists += __atomic_load_n(&s->total_tourists, __ATOMIC_RELAXED);
+        out->total_rides += __atomic_load_n(&s->total_rides, __ATOMIC_RELAXED);
+        for (int t = 0; t < TICKET_COUNT; t++) {
+            out->rides_by_ticket[t] += __atomic_load_n(&s->rides_by_ticket[t], __ATOMIC_RELAXED);
+            out->tourists_by_ticket[t] += __atomic_load_n(&s->tourists_by_ticket[t],
+                                                          __ATOMIC_RELAXED);
+        }
+    }
+}
@@ -0,0 +1,154 @@
+/**
+ * @file core/sweep.c
+ * @brief Parameter sweeps over one set of IPC resources.
+ */
+
+#include "core/sweep.h"
+#include "core/latency.h"
+#include "core/stats.h"
+
+#include <stdio.h>
+#include <string.h>
+
+int sweep_add_axis(Sweep *sweep, const char *spec) {
+    if (sweep->axis_count >= SWEEP_MAX_AXES) {
+        fprintf(stderr, "sweep: at most %d --sweep options\n", SWEEP_MAX_AXES);
+        return -1;
+    }
+
+    const char *eq = strchr(spec, '=');
+    size_t key_len = eq != NULL ? (size_t)(eq - spec) : 0;
+    if (key_len == 0 || key_len >= sizeof(sweep->axes[0].key) || eq[1] == '\0') {
+        fprintf(stderr, "sweep: expected KEY=v1,v2,... (got %s)\n", spec);
+        return -1;
+    }
+
+    SweepAxis *axis = &sweep->axes[sweep->axis_count];
+    memcpy(axis->key, spec, key_len);
+    axis->key[key_len] = '\0';
+    axis->value_count = 0;
+
+    // A scratch config tells whether the key exists at all
+    Config probe;
+    config_set_defaults(&probe);
+    if (config_set_value(&probe, axis->key, "0") == -1) {
+        fprintf(stderr, "sweep: unknown config key %s\n", axis->key);
+        return -1;
+    }
+
+    const char *p = eq + 1;
+    while (*p != '\0') {
+        const char *comma = strchr(p, ',');
+        size_t len = comma != NULL ? (size_t)(comma - p) : strlen(p);
+        if (len == 0 || len >= SWEEP_VALUE_MAX || axis->value_count >= SWEEP_MAX_VALUES) {
+            fprintf(stderr, "sweep: %s takes up to %d values of up to %d characters\n",
+                    axis->key, SWEEP_MAX_VALUES, SWEEP_VALUE_MAX - 1);
+            return -1;
+        }
+        memcpy(axis->values[axis->value_count], p, len);
+        axis->values[axis->value_count][len] = '\0';
+        axis->value_count++;
+        p += len;
+        if (*p == ',') {
+            p++;
+        }
+    }
+
+    sweep->axis_count++;
+    return 0;
+}
+
+int sweep_run_count(const Sweep *sweep) {
+    int runs = 1;
+    for (int a = 0; a < sweep->axis_count; a++) {
+        runs *= sweep->axes[a].value_count;
+    }
+    return runs;
+}
+
+/**
+ * @brief Value index of one axis in a run (last axis changes fastest).
+ */
+static int sweep_value_index(const Sweep *sweep, int axis, int run) {
+    for (int a = sweep->axis_count - 1; a > axis; a--) {
+        run /= sweep->axes[a].value_count;
+    }
+    return run % sweep->axes[axis].value_count;
+}
+
+const char *sweep_value(const Sweep *sweep, int axis, int run) {
+    return sweep->axes[axis].values[sweep_value_index(sweep, axis, run)];
+}
+
+void sweep_run_config(const Sweep *sweep, const Config *base, int run, Config *out) {
+    *out = *base;
+    for (int a = 0; a < sweep->axis_count; a++) {
+        config_set_value(out, sweep->axes[a].key, sweep_value(sweep, a, run));
+    }
+}
+
+void sweep_collect(const SharedState *state, double wall_seconds, SweepResult *out) {
+    StatsSnapshot stats;
+    stats_snapshot(state, &stats);
+
+    unsigned long long slots = 0;
+    out->chairs_departed = 0;
+    for (int l = 0; l < state->cfg.line_count; l++) {
+        out->chairs_departed += __atomic_load_n(&state->lines[l].chairs_departed, __ATOMIC_RELAXED);
+        slots += __atomic_load_n(&state->lines[l].chair_slots_departed, __ATOMIC_RELAXED);
+    }
+
+    const LatencyHistogram *lower = &state->latency[LAT_LOWER_STATION];
+    out->total_tourists = stats.total_tourists;
+    out->total_rides = stats.total_rides;
+    out->slot_utilization = out->chairs_departed > 0
+        ? 100.0 * (double)slots / (double)(out->chairs_departed * CHAIR_CAPACITY) : 0.0;
+    out->lower_wait_p50_ms = latency_percentile(lower, 0.50) / 1000.0;
+    out->lower_wait_p99_ms = latency_percentile(lower, 0.99) / 1000.0;
+    out->wall_seconds = wall_seconds;
+}
+
+int sweep_write_report(const Sweep *sweep, const SweepResult *results, int run_count,
+                       const char *filepath) {
+    FILE *f = fopen(filepath, "w");
+    if (f == NULL) {
+        perror("sweep: fopen");
+        return -1;
+    }
+
+    double wall_total = 0.0;
+    for (int r = 0; r < run_count; r++) {
+        wall_total += results[r].wall_seconds;
+    }
+
+    fprintf(f, "========== SWEEP REPORT ==========\n");
+    fprintf(f, "Runs: %d of %d (one set of IPC resources)\n", run_count, sweep_run_count(sweep));
+    fprintf(f, "Run time: %.2f s\n\n", wall_total);
+
+    fprintf(f, "%-4s", "Run");
+    for (int a = 0; a < sweep->axis_count; a++) {
+        fprintf(f, " %16s", sweep->axes[a].key);
+    }
+    fprintf(f, " %9s %9s %9s %7s %10s %10s %8s\n",
+            "Tourists", "Rides", "Chairs", "Slots%", "Wait p50", "Wait p99", "Wall s");
+
+    for (int r = 0; r < run_count; r++) {
+        const SweepResult *res = &results[r];
+        fprintf(f, "%-4d", r + 1);
+        for (int a = 0; a < sweep->axis_count; a++) {
+            fprintf(f, " %16s", sweep_value(sweep, a, r));
+        }
+        fprintf(f, " %9d %9d %9llu %7.1f %10.3f %10.3f %8.2f\n",
+                res->total_tourists, res->total_rides, res->chairs_departed,
+                res->slot_utilization, res->lower_wait_p50_ms, res->lower_wait_p99_ms,
+                res->wall_seconds);
+    }
+    fprintf(f, "\nWait: lower station semaphore, real ms\n");
+    fprintf(f, "==================================\n");
+
+    if (fclose(f) == EOF) {
+        perror("sweep: fclose");
+        return -1;
+    }
+    return 0;
+}
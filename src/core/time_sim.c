@@ -2,14 +2,29 @@
  * @file time_sim.c
  * @brief Time simulation utilities
  *
- * Time is managed by the Time Server process, which updates SharedState.current_sim_time_ms
- * atomically. Other processes simply read this value - no pause offset calculation needed.
+ * Time is managed by the Time Server process. With CLOCK_SOURCE=0 it updates
+ * SharedState.control.current_sim_time_ms atomically every 10ms and other
+ * processes simply read this value. With CLOCK_SOURCE=1 it publishes only the
+ * epoch (start time shifted by every pause) and readers compute the sim time
+ * from CLOCK_MONOTONIC themselves. Neither needs pause offset calculation
+ * outside the Time Server. With MAX_SPEED=1 the elapsed time is the Time
+ * Server's virtual clock instead of CLOCK_MONOTONIC (see core/time_sim.h).
  */
 
 #include "core/time_sim.h"
+#include "ipc/control.h"
+#include "ipc/futex.h"
+#include "core/fiber.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <time.h>
 #include <errno.h>
+#include <unistd.h>
+
+// Set by time_participant_adopt: this thread's waits count (MAX_SPEED=1)
+static __thread SharedState *tls_participant = NULL;
+static __thread int tls_wait_depth = 0;
+static pthread_once_t g_participant_once = PTHREAD_ONCE_INIT;
 
 /**
  * @brief Initialize time simulation state
@@ -38,39 +53,325 @@ void time_init(SharedState *state, const Config *cfg) {
         state->time_acceleration = (double)sim_duration_minutes / (double)cfg->simulation_duration_real;
     }
 
-    state->chair_travel_time_sim = cfg->chair_travel_time_sim;
+    // A restored run continues the checkpoint's timeline (resume_elapsed_ns = 0 otherwise)
+    int64_t resume_ns = state->resume_elapsed_ns;
+
+    // Virtual clock starts at 0 with nothing pending (used only with MAX_SPEED=1)
+    state->vclock.now_ns = resume_ns;
+    state->vclock.next_deadline_ns = INT64_MAX;
+
+    // Initialize control.current_sim_time_ms to start time
+    state->control.current_sim_time_ms = state->restored
+        ? state->resume_sim_ms : (int64_t)state->sim_start_minutes * 60 * 1000;
+    // Epoch clock runs from now until the Time Server publishes its own start
+    state->control.epoch_base_ns = time_monotonic_ns() - resume_ns;
+    state->control.epoch_paused_ns = 0;
+}
+
+int64_t time_monotonic_ns(void) {
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts) == -1) {
+        return 0;
+    }
+    return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+int64_t time_elapsed_ns(const SharedState *state) {
+    if (state->cfg.max_speed) {
+        return __atomic_load_n(&state->vclock.now_ns, __ATOMIC_ACQUIRE);
+    }
+    int64_t base_ns, paused_ns;
+    control_epoch(state, &base_ns, &paused_ns);
+    int64_t now_ns = paused_ns != 0 ? paused_ns : time_monotonic_ns();
+    return now_ns > base_ns ? now_ns - base_ns : 0;
+}
+
+/**
+ * @brief Virtual clock version of time_sleep_until_elapsed_ns (MAX_SPEED=1).
+ *
+ * Reads the generation before the clock, so an advance between the check
+ * and the futex wait makes the wait return at once. A deadline registered
+ * just before the Time Server resets next_deadline_ns is registered again
+ * after the wakeup that follows the reset.
+ */
+static int vclock_sleep_until(SharedState *state, int64_t deadline_ns, const int *running_flag) {
+    VirtualClock *vc = &state->vclock;
+    while ((running_flag == NULL || *running_flag) && control_running(state)) {
+        uint32_t gen = __atomic_load_n(&vc->generation, __ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&vc->now_ns, __ATOMIC_ACQUIRE) >= deadline_ns) {
+            return 0;
+        }
+        int64_t next = __atomic_load_n(&vc->next_deadline_ns, __ATOMIC_RELAXED);
+        while (deadline_ns < next &&
+               !__atomic_compare_exchange_n(&vc->next_deadline_ns, &next, deadline_ns, 1,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_RELAXED)) {
+            // next reloaded by the failed CAS
+        }
+        __atomic_add_fetch(&vc->activity, 1, __ATOMIC_SEQ_CST);
+        time_wait_begin();
+        futex_wait(&vc->generation, gen, SHM_WAIT_TIMEOUT_MS);
+        time_wait_end();
+        __atomic_add_fetch(&vc->activity, 1, __ATOMIC_SEQ_CST);
+    }
+    return -1;
+}
+
+int time_sleep_until_elapsed_ns(SharedState *state, int64_t deadline_ns, const int *running_flag) {
+    if (state->cfg.max_speed) {
+        return vclock_sleep_until(state, deadline_ns, running_flag);
+    }
+    while ((running_flag == NULL || *running_flag) && control_running(state)) {
+        int64_t base_ns, paused_ns;
+        control_epoch(state, &base_ns, &paused_ns);
+
+        struct timespec ts;
+        int ret;
+        if (paused_ns != 0) {
+            // Clock frozen: the deadline moves with the pause, poll until resumed
+            ts.tv_sec = 0;
+            ts.tv_nsec = TIME_PAUSE_POLL_NS;
+            ret = fiber_clock_nanosleep(0, &ts);
+        } else {
+            int64_t wake_ns = base_ns + deadline_ns;
+            if (time_monotonic_ns() >= wake_ns) {
+                return 0;
+            }
+            ts.tv_sec = (time_t)(wake_ns / 1000000000);
+            ts.tv_nsec = (long)(wake_ns % 1000000000);
+            ret = fiber_clock_nanosleep(TIMER_ABSTIME, &ts);
+        }
+        if (ret != 0 && ret != EINTR) {
+            errno = ret;
+            perror("time_sleep_until_elapsed_ns: clock_nanosleep");
+            return -1;
+        }
+        // Woken (deadline, signal or poll step): re-check against the current epoch
+    }
+    return -1;
+}
+
+/**
+ * @brief This process's virtual timer slot, claimed on first use.
+ *
+ * @return Slot, or NULL if every slot is taken.
+ */
+static VirtualTimer *vclock_timer_slot(SharedState *state) {
+    static VirtualTimer *slot = NULL;
+    static pid_t slot_pid = 0;
+    pid_t self = getpid();
+    if (slot != NULL && slot_pid == self) {
+        return slot;
+    }
+    // First use in this process (or a forked child of the previous owner)
+    for (int i = 0; i < VCLOCK_TIMER_SLOTS; i++) {
+        VirtualTimer *t = &state->vclock.timers[i];
+        int32_t expected = 0;
+        if (__atomic_load_n(&t->pid, __ATOMIC_ACQUIRE) == self ||
+            __atomic_compare_exchange_n(&t->pid, &expected, self, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            slot = t;
+            slot_pid = self;
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Set this process's timer slot (deadline first, then kind).
+ */
+static void vclock_set_timer(SharedState *state, VirtualTimerKind kind, int64_t deadline_ns) {
+    VirtualTimer *t = vclock_timer_slot(state);
+    if (t == NULL) {
+        static int warned = 0;
+        if (!warned) {
+            warned = 1;
+            fprintf(stderr, "time_sim: no free virtual timer slot (VCLOCK_TIMER_SLOTS=%d)\n",
+                    VCLOCK_TIMER_SLOTS);
+        }
+        return;
+    }
+    __atomic_store_n(&t->kind, VTIMER_NONE, __ATOMIC_RELEASE);
+    __atomic_store_n(&t->deadline_ns, deadline_ns, __ATOMIC_RELEASE);
+    __atomic_store_n(&t->kind, kind, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&state->vclock.activity, 1, __ATOMIC_SEQ_CST);
+}
+
+void time_alarm_us(SharedState *state, unsigned int us) {
+    if (!state->cfg.max_speed) {
+        ualarm(us, 0);
+        return;
+    }
+    if (us == 0) {
+        vclock_set_timer(state, VTIMER_NONE, 0);
+    } else {
+        vclock_set_timer(state, VTIMER_ALARM, time_elapsed_ns(state) + (int64_t)us * 1000);
+    }
+}
+
+void time_hold_until_elapsed_ns(SharedState *state, int64_t deadline_ns) {
+    if (!state->cfg.max_speed) {
+        return;
+    }
+    if (deadline_ns < 0) {
+        vclock_set_timer(state, VTIMER_NONE, 0);
+    } else {
+        vclock_set_timer(state, VTIMER_HOLD, deadline_ns);
+    }
+}
+
+void time_wait_advance(SharedState *state, int timeout_ms) {
+    VirtualClock *vc = &state->vclock;
+    uint32_t gen = __atomic_load_n(&vc->generation, __ATOMIC_ACQUIRE);
+    time_wait_begin();
+    futex_wait(&vc->generation, gen, timeout_ms);
+    time_wait_end();
+}
+
+/**
+ * @brief Forked child: the thread that forked stays the parent's participant.
+ */
+static void participant_forget(void) {
+    tls_participant = NULL;
+    tls_wait_depth = 0;
+}
+
+static void participant_register_atfork(void) {
+    pthread_atfork(NULL, NULL, participant_forget);
+}
+
+void time_participant_add(SharedState *state) {
+    if (state->cfg.max_speed) {
+        __atomic_add_fetch(&state->vclock.participants, 1, __ATOMIC_SEQ_CST);
+    }
+}
+
+void time_participant_remove(SharedState *state) {
+    if (state->cfg.max_speed) {
+        __atomic_sub_fetch(&state->vclock.participants, 1, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&state->vclock.activity, 1, __ATOMIC_SEQ_CST);
+    }
+}
 
-    // Initialize current_sim_time_ms to start time
-    state->current_sim_time_ms = (int64_t)state->sim_start_minutes * 60 * 1000;
+void time_participant_adopt(SharedState *state) {
+    if (!state->cfg.max_speed) {
+        return;
+    }
+    pthread_once(&g_participant_once, participant_register_atfork);
+    tls_participant = state;
+    tls_wait_depth = 0;
+}
+
+void time_participant_join(SharedState *state) {
+    time_participant_add(state);
+    time_participant_adopt(state);
+}
+
+void time_participant_leave(SharedState *state) {
+    if (tls_participant != state || state == NULL) {
+        return;
+    }
+    if (tls_wait_depth > 0) {
+        __atomic_sub_fetch(&state->vclock.waiting, 1, __ATOMIC_SEQ_CST);
+    }
+    participant_forget();
+    time_participant_remove(state);
+}
+
+void time_wait_begin(void) {
+    SharedState *state = tls_participant;
+    if (state == NULL || tls_wait_depth++ > 0) {
+        return;
+    }
+    __atomic_add_fetch(&state->vclock.waiting, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&state->vclock.activity, 1, __ATOMIC_SEQ_CST);
+}
+
+void time_wait_end(void) {
+    SharedState *state = tls_participant;
+    if (state == NULL || tls_wait_depth == 0 || --tls_wait_depth > 0) {
+        return;
+    }
+    __atomic_sub_fetch(&state->vclock.waiting, 1, __ATOMIC_SEQ_CST);
+    __atomic_add_fetch(&state->vclock.activity, 1, __ATOMIC_SEQ_CST);
+}
+
+int64_t time_sim_ms_to_elapsed_ns(const SharedState *state, int64_t sim_ms) {
+    int64_t offset_ms = sim_ms - (int64_t)state->sim_start_minutes * 60000;
+    if (offset_ms <= 0 || state->time_acceleration <= 0) {
+        return 0;
+    }
+    // Inverse of sim_time_ms(): sim ms = elapsed ns * acceleration * 6e-5,
+    // rounded up so the returned instant really reads as sim_ms or later
+    double scale = state->time_acceleration * 6e-5;
+    int64_t ns = (int64_t)((double)offset_ms / scale);
+    while ((int64_t)((double)ns * scale) < offset_ms) {
+        ns++;
+    }
+    return ns;
+}
+
+/**
+ * @brief Current simulated milliseconds from the configured clock source.
+ *
+ * CLOCK_SOURCE=0 is one atomic load of the Time Server's last tick. With
+ * CLOCK_SOURCE=1 the time is computed from the epoch and CLOCK_MONOTONIC
+ * (vDSO, no system call), so it has sub-microsecond resolution.
+ *
+ * @param state Shared state
+ * @return Simulated milliseconds from midnight
+ */
+static int64_t sim_time_ms(const SharedState *state) {
+    if (state->cfg.clock_source != CLOCK_SOURCE_EPOCH) {
+        return __atomic_load_n(&state->control.current_sim_time_ms, __ATOMIC_ACQUIRE);
+    }
+
+    int64_t elapsed_ns = time_elapsed_ns(state);
+
+    // Sim ms = real seconds * sim minutes per real second * 60000
+    double sim_ms = (double)elapsed_ns * state->time_acceleration * 6e-5;
+    return (int64_t)state->sim_start_minutes * 60000 + (int64_t)sim_ms;
 }
 
 /**
  * @brief Get current simulated time in minutes from midnight
  *
- * Reads the atomic time value maintained by the Time Server.
+ * Reads the time maintained by the Time Server (see sim_time_ms).
  *
  * @param state Shared state
  * @return Current simulated time in minutes
  */
 int time_get_sim_minutes(SharedState *state) {
-    int64_t sim_ms = __atomic_load_n(&state->current_sim_time_ms, __ATOMIC_ACQUIRE);
+    int64_t sim_ms = sim_time_ms(state);
     return (int)(sim_ms / 60000);  // Convert ms to minutes
 }
 
 /**
  * @brief Get current simulated time in minutes with fractional precision
  *
- * Reads the atomic time value maintained by the Time Server.
+ * Reads the time maintained by the Time Server (see sim_time_ms).
  * Returns a double for sub-minute precision in logging.
  *
  * @param state Shared state
  * @return Current simulated time in minutes (with fraction)
  */
 double time_get_sim_minutes_f(SharedState *state) {
-    int64_t sim_ms = __atomic_load_n(&state->current_sim_time_ms, __ATOMIC_ACQUIRE);
+    int64_t sim_ms = sim_time_ms(state);
     return sim_ms / 60000.0;  // Convert ms to minutes
 }
 
+/**
+ * @brief Get current simulated time in milliseconds
+ *
+ * Reads the time maintained by the Time Server (see sim_time_ms).
+ *
+ * @param state Shared state
+ * @return Simulated milliseconds from midnight
+ */
+int64_t time_get_sim_ms(SharedState *state) {
+    return sim_time_ms(state);
+}
+
 /**
  * @brief Check if simulation time has ended
  *
@@ -106,6 +407,18 @@ double time_sim_to_real_seconds(SharedState *state, int sim_minutes) {
     return (double)sim_minutes / state->time_acceleration;
 }
 
+/**
+ * @brief Convert simulated milliseconds to real milliseconds
+ *
+ * @param state Shared state (for acceleration factor)
+ * @param sim_ms Simulated milliseconds to convert
+ * @return Equivalent real milliseconds
+ */
+double time_sim_ms_to_real_ms(SharedState *state, int64_t sim_ms) {
+    // One sim minute (60000 sim ms) takes 1000 / acceleration real ms
+    return time_sim_to_real_seconds(state, 1) * 1000.0 * (double)sim_ms / 60000.0;
+}
+
 /**
  * @brief Sleep for a specified number of simulated minutes
  *
@@ -133,7 +446,7 @@ int time_sleep_sim_minutes(SharedState *state, int sem_id, int sim_minutes) {
 
     while (remaining > 0) {
         // Check if simulation is stopping
-        if (!state->running) {
+        if (!control_running(state)) {
             return -1;
         }
 
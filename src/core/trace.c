@@ -0,0 +1,183 @@
+/**
+ * @file core/trace.c
+ * @brief Memory-mapped binary event trace (EVENT_TRACE=1).
+ */
+
+#include "core/trace.h"
+#include "core/time_sim.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Mapping of this process (inherited across fork, re-created after exec)
+static TraceHeader *g_trace = NULL;
+static TraceRecord *g_records = NULL;
+static SharedState *g_trace_state = NULL;
+static int g_trace_fd = -1;
+
+/**
+ * @brief Bytes of a trace file holding the given number of records.
+ */
+static size_t trace_file_size(uint64_t records) {
+    return sizeof(TraceHeader) + (size_t)records * sizeof(TraceRecord);
+}
+
+/**
+ * @brief Map an open trace file read-write and remember it for trace_emit().
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int trace_map(int fd, SharedState *state) {
+    void *base = mmap(NULL, trace_file_size(TRACE_MAX_RECORDS), PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        perror("trace: mmap");
+        return -1;
+    }
+    g_trace = base;
+    g_records = (TraceRecord *)((char *)base + sizeof(TraceHeader));
+    g_trace_state = state;
+    g_trace_fd = fd;
+    return 0;
+}
+
+int trace_create(SharedState *state, const char *path) {
+    char cwd[TRACE_PATH_MAX];
+    int len;
+    if (path[0] == '/') {
+        len = snprintf(state->trace_path, sizeof(state->trace_path), "%s", path);
+    } else if (getcwd(cwd, sizeof(cwd)) != NULL) {
+        len = snprintf(state->trace_path, sizeof(state->trace_path), "%s/%s", cwd, path);
+    } else {
+        perror("trace: getcwd");
+        return -1;
+    }
+    if (len < 0 || (size_t)len >= sizeof(state->trace_path)) {
+        fprintf(stderr, "trace: path too long (max %d bytes)\n", TRACE_PATH_MAX - 1);
+        state->trace_path[0] = '\0';
+        return -1;
+    }
+
+    int fd = open(state->trace_path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        perror("trace: open");
+        return -1;
+    }
+
+    // Sparse file: pages are only allocated as records are written
+    if (ftruncate(fd, (off_t)trace_file_size(TRACE_MAX_RECORDS)) == -1) {
+        perror("trace: ftruncate");
+        close(fd);
+        return -1;
+    }
+    if (trace_map(fd, state) == -1) {
+        close(fd);
+        return -1;
+    }
+
+    memcpy(g_trace->magic, TRACE_MAGIC, sizeof(g_trace->magic));
+    g_trace->version = TRACE_VERSION;
+    g_trace->record_size = sizeof(TraceRecord);
+    g_trace->capacity = TRACE_MAX_RECORDS;
+    g_trace->sim_start_minutes = state->sim_start_minutes;
+    g_trace->sim_end_minutes = state->sim_end_minutes;
+    g_trace->time_acceleration = state->time_acceleration;
+    return 0;
+}
+
+int trace_attach(SharedState *state) {
+    if (g_trace != NULL || !state->event_trace || state->trace_path[0] == '\0') {
+        return 0;
+    }
+
+    int fd = open(state->trace_path, O_RDWR);
+    if (fd == -1) {
+        perror("trace: open");
+        return -1;
+    }
+    if (trace_map(fd, state) == -1) {
+        close(fd);
+        return -1;
+    }
+    if (memcmp(g_trace->magic, TRACE_MAGIC, sizeof(g_trace->magic)) != 0 ||
+        g_trace->record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "trace: %s is not a trace file of this build\n", state->trace_path);
+        munmap(g_trace, trace_file_size(TRACE_MAX_RECORDS));
+        close(fd);
+        g_trace = NULL;
+        g_records = NULL;
+        g_trace_fd = -1;
+        return -1;
+    }
+    return 0;
+}
+
+void trace_emit(int source, int event, int tourist_id, int chair_id, int gate, int count) {
+    if (g_trace == NULL) {
+        return;
+    }
+
+    uint64_t idx = __atomic_fetch_add(&g_trace->count, 1, __ATOMIC_RELAXED);
+    if (idx >= g_trace->capacity) {
+        return;  // File full (or closed): counted as dropped by trace_close()
+    }
+
+    TraceRecord *rec = &g_records[idx];
+    rec->sim_time_ms = time_get_sim_ms(g_trace_state);
+    rec->tourist_id = tourist_id;
+    rec->chair_id = chair_id;
+    rec->event = (uint16_t)event;
+    rec->gate = (int16_t)gate;
+    rec->count = (uint16_t)count;
+    __atomic_store_n(&rec->source, (uint16_t)source, __ATOMIC_RELEASE);
+}
+
+void trace_tourist_stage(int tourist_id, TouristStage stage, int chair_id, int count) {
+    if (g_trace == NULL) {
+        return;
+    }
+
+    int gate = -1;
+    switch (stage) {
+        case STAGE_AT_ENTRY_GATES:
+            gate = SEM_ENTRY_GATES;
+            break;
+        case STAGE_ENTERED_LOWER_STATION:
+            gate = SEM_LOWER_STATION;
+            break;
+        case STAGE_QUEUED_FOR_PLATFORM:
+        case STAGE_AT_LOWER_PLATFORM:
+            gate = SEM_PLATFORM_GATES;
+            break;
+        case STAGE_AT_UPPER_PLATFORM_GATES:
+            gate = SEM_EXIT_GATES;
+            break;
+        default:
+            break;
+    }
+    trace_emit(TRACE_SRC_TOURIST, stage, tourist_id, chair_id, gate, count);
+}
+
+void trace_close(void) {
+    if (g_trace == NULL) {
+        return;
+    }
+
+    // Park the cursor at capacity: later claims land past the end and are dropped
+    uint64_t used = __atomic_exchange_n(&g_trace->count, g_trace->capacity, __ATOMIC_ACQ_REL);
+    uint64_t kept = used < g_trace->capacity ? used : g_trace->capacity;
+    g_trace->records = kept;
+    g_trace->dropped = used - kept;
+
+    munmap(g_trace, trace_file_size(TRACE_MAX_RECORDS));
+    if (ftruncate(g_trace_fd, (off_t)trace_file_size(kept)) == -1) {
+        perror("trace: ftruncate");
+    }
+    close(g_trace_fd);
+    g_trace = NULL;
+    g_records = NULL;
+    g_trace_fd = -1;
+}
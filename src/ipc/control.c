@@ -0,0 +1,133 @@
+/**
+ * @file ipc/control.c
+ * @brief Seqlock-versioned control block (run state and simulated clock).
+ */
+
+#include "ipc/control.h"
+
+#include <sched.h>
+
+_Static_assert(sizeof(ControlBlock) == 64, "ControlBlock must fill exactly one cache line");
+
+/**
+ * @brief Make seq odd, waiting for any other writer to finish.
+ *
+ * A writer killed between begin and end would otherwise wedge everyone, so
+ * after CONTROL_WRITE_SPINS failed attempts the lock is taken over.
+ */
+static void control_write_begin(SharedState *state) {
+    uint32_t seq = __atomic_load_n(&state->control.seq, __ATOMIC_RELAXED);
+    for (int spins = 0;; spins++) {
+        if ((seq & 1u) == 0 &&
+            __atomic_compare_exchange_n(&state->control.seq, &seq, seq + 1, 1,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            break;
+        }
+        if (spins >= CONTROL_WRITE_SPINS) {
+            __atomic_store_n(&state->control.seq, seq | 1u, __ATOMIC_RELAXED);
+            break;
+        }
+        sched_yield();
+        seq = __atomic_load_n(&state->control.seq, __ATOMIC_RELAXED);
+    }
+    // Field stores must not become visible before the odd version
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+/**
+ * @brief Publish the update (seq even again).
+ */
+static void control_write_end(SharedState *state) {
+    uint32_t seq = __atomic_load_n(&state->control.seq, __ATOMIC_RELAXED);
+    __atomic_store_n(&state->control.seq, (seq | 1u) + 1, __ATOMIC_RELEASE);
+}
+
+void control_snapshot(const SharedState *state, ControlBlock *out) {
+    const ControlBlock *c = &state->control;
+    uint32_t before;
+    for (int spins = 0;; spins++) {
+        before = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+        out->running = __atomic_load_n(&c->running, __ATOMIC_RELAXED);
+        out->closing = __atomic_load_n(&c->closing, __ATOMIC_RELAXED);
+        out->emergency_stop = __atomic_load_n(&c->emergency_stop, __ATOMIC_RELAXED);
+        out->current_sim_time_ms = __atomic_load_n(&c->current_sim_time_ms, __ATOMIC_RELAXED);
+        out->epoch_base_ns = __atomic_load_n(&c->epoch_base_ns, __ATOMIC_RELAXED);
+        out->epoch_paused_ns = __atomic_load_n(&c->epoch_paused_ns, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t after = __atomic_load_n(&c->seq, __ATOMIC_RELAXED);
+        if ((before == after && (before & 1u) == 0) || spins >= CONTROL_WRITE_SPINS) {
+            break;  // Same even version on both sides (or the writer died mid-update)
+        }
+        if (before & 1u) {
+            sched_yield();
+        }
+    }
+    out->seq = before;
+}
+
+int control_running(const SharedState *state) {
+    return __atomic_load_n(&state->control.running, __ATOMIC_ACQUIRE);
+}
+
+int control_closing(const SharedState *state) {
+    return __atomic_load_n(&state->control.closing, __ATOMIC_ACQUIRE);
+}
+
+int control_emergency_stop(const SharedState *state, int line) {
+    return (__atomic_load_n(&state->control.emergency_stop, __ATOMIC_ACQUIRE) >> line) & 1;
+}
+
+void control_set_running(SharedState *state, int running) {
+    control_write_begin(state);
+    __atomic_store_n(&state->control.running, running, __ATOMIC_RELEASE);
+    control_write_end(state);
+}
+
+void control_set_closing(SharedState *state, int closing) {
+    control_write_begin(state);
+    __atomic_store_n(&state->control.closing, closing, __ATOMIC_RELEASE);
+    control_write_end(state);
+}
+
+void control_set_emergency_stop(SharedState *state, int line, int emergency_stop) {
+    control_write_begin(state);
+    // Writers are serialized by seq, so the read-modify-write cannot lose a bit
+    int mask = __atomic_load_n(&state->control.emergency_stop, __ATOMIC_RELAXED);
+    mask = emergency_stop ? (mask | (1 << line)) : (mask & ~(1 << line));
+    __atomic_store_n(&state->control.emergency_stop, mask, __ATOMIC_RELEASE);
+    control_write_end(state);
+}
+
+void control_set_sim_time_ms(SharedState *state, int64_t sim_ms) {
+    control_write_begin(state);
+    __atomic_store_n(&state->control.current_sim_time_ms, sim_ms, __ATOMIC_RELEASE);
+    control_write_end(state);
+}
+
+void control_epoch(const SharedState *state, int64_t *base_ns, int64_t *paused_ns) {
+    const ControlBlock *c = &state->control;
+    for (int spins = 0;; spins++) {
+        uint32_t before = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+        *base_ns = __atomic_load_n(&c->epoch_base_ns, __ATOMIC_RELAXED);
+        *paused_ns = __atomic_load_n(&c->epoch_paused_ns, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        uint32_t after = __atomic_load_n(&c->seq, __ATOMIC_RELAXED);
+        if ((before == after && (before & 1u) == 0) || spins >= CONTROL_WRITE_SPINS) {
+            return;
+        }
+        if (before & 1u) {
+            sched_yield();
+        }
+    }
+}
+
+void control_set_epoch(SharedState *state, int64_t base_ns, int64_t paused_ns) {
+    control_write_begin(state);
+    __atomic_store_n(&state->control.epoch_base_ns, base_ns, __ATOMIC_RELEASE);
+    __atomic_store_n(&state->control.epoch_paused_ns, paused_ns, __ATOMIC_RELEASE);
+    control_write_end(state);
+}
+
+void control_mark_epoch_paused(SharedState *state, int64_t paused_ns) {
+    __atomic_store_n(&state->control.epoch_paused_ns, paused_ns, __ATOMIC_RELEASE);
+}
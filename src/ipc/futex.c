@@ -0,0 +1,52 @@
+/**
+ * @file ipc/futex.c
+ * @brief Process-shared futex wait/wake (Linux futex syscall).
+ */
+
+#include "ipc/futex.h"
+#include "core/fiber.h"
+
+#include <errno.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Sleep while *addr == expected (process-shared futex).
+ *
+ * @param addr Futex word (must live in shared memory).
+ * @param expected Value the caller last observed.
+ * @param timeout_ms Maximum wait in milliseconds (<= 0 waits forever).
+ * @return 0 when woken, -1 with errno EAGAIN, ETIMEDOUT or EINTR.
+ */
+int futex_wait(uint32_t *addr, uint32_t expected, int timeout_ms) {
+    struct timespec ts;
+    struct timespec *tsp = NULL;
+
+    if (fiber_active()) {
+        return fiber_futex_wait(addr, expected, timeout_ms);
+    }
+    if (timeout_ms > 0) {
+        ts.tv_sec = timeout_ms / 1000;
+        ts.tv_nsec = (long)(timeout_ms % 1000) * 1000000L;
+        tsp = &ts;
+    }
+
+    // Not FUTEX_PRIVATE_FLAG: waiters and wakers are different processes
+    if (syscall(SYS_futex, addr, FUTEX_WAIT, expected, tsp, NULL, 0) == -1) {
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Wake up to count waiters sleeping on addr.
+ *
+ * @param addr Futex word.
+ * @param count Maximum number of waiters to wake.
+ * @return Number of waiters woken, or -1 on error.
+ */
+int futex_wake(uint32_t *addr, int count) {
+    return (int)syscall(SYS_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
@@ -5,10 +5,16 @@
 
 #include "ipc/ipc.h"
 #include "ipc/internal.h"
+#include "ipc/numa.h"
+#include "ipc/transport.h"
 #include "core/logger.h"
+#include "core/completion_ring.h"
+#include "core/arrival_schedule.h"
+#include "core/danger_schedule.h"
 
 #include <errno.h>
 #include <signal.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
 #include <sys/msg.h>
@@ -16,6 +22,83 @@
 #include <sys/shm.h>
 #include <unistd.h>
 
+/**
+ * @brief Mark every resource ID unused (-1) and select line 0.
+ */
+static void ipc_reset_ids(IPCResources *res) {
+    memset(res, 0, sizeof(IPCResources));
+    res->shm_id = -1;
+    res->mq_cashier_id = -1;
+    res->mq_spawn_id = -1;
+    for (int c = 0; c < MAX_CASHIERS; c++) {
+        res->mq_cashier_ids[c] = -1;
+    }
+    res->cashier_count = 1;
+    for (int line = 0; line < MAX_LINES; line++) {
+        res->lines[line].sem_id = -1;
+        res->lines[line].mq_platform_id = -1;
+        res->lines[line].mq_boarding_id = -1;
+        res->lines[line].mq_arrivals_id = -1;
+        res->lines[line].mq_worker_id = -1;
+    }
+    res->line_count = 1;
+    ipc_select_line(res, 0);
+    res->state = NULL;
+}
+
+/**
+ * @brief Region offsets of the shared memory segment for a configuration.
+ */
+typedef struct {
+    size_t base_size;       // SharedState + tourist table
+    size_t transport_end;   // + optional ring transport block
+    size_t log_end;         // + optional log ring
+    size_t completion_end;  // + optional completion ring
+    size_t shm_size;        // + optional arrival schedule
+} ShmLayout;
+
+/**
+ * @brief Lay out the shared memory segment.
+ *
+ * Base + flexible array for tourist entries + optional ring transport block
+ * + optional log ring + optional completion ring + optional arrival schedule.
+ * With REPORT_INCREMENTAL=1 the tourist table is replaced by the completion ring.
+ */
+static void ipc_layout(const Config *cfg, ShmLayout *layout) {
+    size_t tracked = cfg->report_incremental ? 0 : (size_t)cfg->total_tourists;
+    layout->base_size = sizeof(SharedState) + (tracked * sizeof(TouristEntry));
+    layout->transport_end = layout->base_size + transport_shm_size(cfg, layout->base_size);
+    layout->log_end = layout->transport_end + log_ring_shm_size(cfg, layout->transport_end);
+    layout->completion_end = layout->log_end + completion_ring_shm_size(cfg, layout->log_end);
+    layout->shm_size = layout->completion_end +
+                       arrival_schedule_shm_size(cfg, layout->completion_end);
+}
+
+/**
+ * @brief Copy the configuration into shared state and set up every region.
+ *
+ * Expects the segment zeroed and the semaphores initialized.
+ */
+static int ipc_init_regions(IPCResources *res, const Config *cfg, const ShmLayout *layout) {
+    ipc_shm_init_state(res, cfg);
+    res->state->shm_size = layout->shm_size;
+    res->state->shm_page_size = res->shm_page_size;
+    res->state->cfg_sealed = res->shm_page_size > 0 && res->shm_page_size <= CONFIG_BLOCK_SIZE &&
+                             CONFIG_BLOCK_SIZE % res->shm_page_size == 0;
+    transport_init(res, cfg, layout->base_size);
+    log_ring_init(res->state, cfg, layout->transport_end);
+    completion_ring_init(res->state, cfg, layout->log_end);
+    if (arrival_schedule_init(res->state, cfg, layout->completion_end) == -1 ||
+        danger_schedule_init(res->state, cfg) == -1) {
+        return -1;
+    }
+    ipc_sem_bind(res);
+    if (cfg->numa_lines) {
+        numa_place_lines(res);
+    }
+    return 0;
+}
+
 /**
  * @brief Clean up stale IPC resources from a previous crashed run.
  *
@@ -56,24 +139,34 @@ int ipc_cleanup_stale(const IPCKeys *keys) {
     // Main process is dead - clean up orphaned resources
     write(STDERR_FILENO, "[INFO] [IPC] Cleaning stale IPC resources from previous run\n", 60);
 
-    // Remove message queues
-    int mq_ids[] = {
-        msgget(keys->mq_cashier_key, 0600),
-        msgget(keys->mq_platform_key, 0600),
-        msgget(keys->mq_boarding_key, 0600),
-        msgget(keys->mq_arrivals_key, 0600),
-        msgget(keys->mq_worker_key, 0600)
-    };
-    for (int i = 0; i < 5; i++) {
-        if (mq_ids[i] != -1) {
-            msgctl(mq_ids[i], IPC_RMID, NULL);
+    // Remove message queues (every possible line and cashier: the old
+    // LINE_COUNT and CASHIER_COUNT are unknown)
+    int spawn_id = msgget(keys->mq_spawn_key, 0600);
+    if (spawn_id != -1) {
+        msgctl(spawn_id, IPC_RMID, NULL);
+    }
+    for (int c = 0; c < MAX_CASHIERS; c++) {
+        int mq_id = msgget(keys->mq_cashier_keys[c], 0600);
+        if (mq_id != -1) {
+            msgctl(mq_id, IPC_RMID, NULL);
         }
     }
+    for (int line = 0; line < MAX_LINES; line++) {
+        const LineKeys *lk = &keys->lines[line];
+        key_t line_keys[] = {lk->mq_platform_key, lk->mq_boarding_key,
+                             lk->mq_arrivals_key, lk->mq_worker_key};
+        for (int i = 0; i < 4; i++) {
+            int mq_id = msgget(line_keys[i], 0600);
+            if (mq_id != -1) {
+                msgctl(mq_id, IPC_RMID, NULL);
+            }
+        }
 
-    // Remove semaphores
-    int sem_id = semget(keys->sem_key, 0, 0600);
-    if (sem_id != -1) {
-        semctl(sem_id, 0, IPC_RMID);
+        // Remove semaphores
+        int sem_id = semget(lk->sem_key, 0, 0600);
+        if (sem_id != -1) {
+            semctl(sem_id, 0, IPC_RMID);
+        }
     }
 
     // Remove shared memory
@@ -93,41 +186,44 @@ int ipc_cleanup_stale(const IPCKeys *keys) {
  * @return 0 on success, -1 on error.
  */
 int ipc_create(IPCResources *res, const IPCKeys *keys, const Config *cfg) {
-    memset(res, 0, sizeof(IPCResources));
-    res->shm_id = -1;
-    res->sem_id = -1;
-    res->mq_cashier_id = -1;
-    res->mq_platform_id = -1;
-    res->mq_boarding_id = -1;
-    res->mq_arrivals_id = -1;
-    res->mq_worker_id = -1;
-    res->state = NULL;
+    ipc_reset_ids(res);
+    res->line_count = cfg->line_count;
+    res->cashier_count = cfg->cashier_count;
 
-    log_debug("IPC", "Generated IPC keys: shm=%d sem=%d mq_c=%d mq_p=%d mq_b=%d mq_a=%d mq_w=%d",
+    log_debug("IPC", "Generated IPC keys: shm=%d sem=%d mq_c=%d mq_p=%d mq_b=%d mq_a=%d mq_w=%d mq_t=%d",
               keys->shm_key, keys->sem_key,
               keys->mq_cashier_key, keys->mq_platform_key,
-              keys->mq_boarding_key, keys->mq_arrivals_key, keys->mq_worker_key);
+              keys->mq_boarding_key, keys->mq_arrivals_key, keys->mq_worker_key,
+              keys->mq_spawn_key);
 
-    // Calculate shared memory size (base + flexible array for tourist entries)
-    size_t shm_size = sizeof(SharedState) + (cfg->total_tourists * sizeof(TouristEntry));
+    ShmLayout layout;
+    ipc_layout(cfg, &layout);
 
     // Create shared memory
-    if (ipc_shm_create(res, keys->shm_key, shm_size) == -1) {
+    if (ipc_shm_create(res, keys->shm_key, layout.shm_size, cfg->shm_huge_pages) == -1) {
         goto cleanup;
     }
 
-    // Create semaphore set
-    if (ipc_sem_create(res, keys->sem_key, cfg) == -1) {
-        goto cleanup;
+    // Create one semaphore set and one set of platform/boarding/arrivals/worker
+    // queues per line, plus one queue per cashier and the spawn queue
+    for (int line = 0; line < res->line_count; line++) {
+        if (ipc_sem_create(res, line, keys->lines[line].sem_key, cfg) == -1 ||
+            ipc_mq_create_line(res, line, &keys->lines[line]) == -1) {
+            goto cleanup;
+        }
     }
-
-    // Create message queues
     if (ipc_mq_create(res, keys) == -1) {
         goto cleanup;
     }
+    if (cfg->queue_bytes > 0 && ipc_mq_set_limit(res, cfg->queue_bytes) == -1) {
+        goto cleanup;
+    }
+    ipc_select_line(res, 0);
 
     // Initialize shared state with config values
-    ipc_shm_init_state(res, cfg);
+    if (ipc_init_regions(res, cfg, &layout) == -1) {
+        goto cleanup;
+    }
 
     log_debug("IPC", "All IPC resources created successfully");
     return 0;
@@ -137,6 +233,67 @@ cleanup:
     return -1;
 }
 
+/**
+ * @brief Shared memory segment size a configuration needs.
+ *
+ * @param cfg Configuration.
+ * @return Size in bytes.
+ */
+size_t ipc_shm_size(const Config *cfg) {
+    ShmLayout layout;
+    ipc_layout(cfg, &layout);
+    return layout.shm_size;
+}
+
+/**
+ * @brief Reset existing IPC resources for another run without recreating them.
+ *
+ * Empties every message queue, zeroes what the previous run wrote, sets
+ * every line's semaphores back to their initial values and copies the new
+ * configuration in. No process may be attached except the caller.
+ *
+ * @param res IPC resources from ipc_create.
+ * @param cfg Configuration of the next run (same layout: see ipc_shm_size).
+ * @return 0 on success, -1 on error.
+ */
+int ipc_reset(IPCResources *res, const Config *cfg) {
+    ShmLayout layout;
+    ipc_layout(cfg, &layout);
+    if (layout.shm_size != res->state->shm_size || cfg->line_count != res->line_count ||
+        cfg->cashier_count != res->cashier_count ||
+        cfg->shm_huge_pages != res->state->cfg.shm_huge_pages) {
+        fprintf(stderr, "ipc_reset: configuration changes the IPC layout\n");
+        return -1;
+    }
+
+    int drained = ipc_mq_drain(res);
+    if (cfg->queue_bytes > 0 && ipc_mq_set_limit(res, cfg->queue_bytes) == -1) {
+        return -1;
+    }
+
+    // Same state as a fresh IPC_EXCL segment. Tourist entries past the used
+    // count were never written and are still zero, so only the used prefix
+    // of the table is cleared and its untouched pages stay uncommitted.
+    size_t entries_end = offsetof(SharedState, tourist_entries) +
+                         (size_t)res->state->tourist_entry_count * sizeof(TouristEntry);
+    if (entries_end > layout.base_size) entries_end = layout.base_size;
+    memset(res->state, 0, entries_end);
+    memset((char *)res->state + layout.base_size, 0, layout.shm_size - layout.base_size);
+
+    for (int line = 0; line < res->line_count; line++) {
+        if (ipc_sem_reset(res, line, cfg) == -1) {
+            return -1;
+        }
+    }
+    ipc_select_line(res, 0);
+    if (ipc_init_regions(res, cfg, &layout) == -1) {
+        return -1;
+    }
+
+    log_debug("IPC", "IPC resources reset (%d stale messages discarded)", drained);
+    return 0;
+}
+
 /**
  * @brief Attach to existing IPC resources (for child processes).
  *
@@ -145,20 +302,27 @@ cleanup:
  * @return 0 on success, -1 on error.
  */
 int ipc_attach(IPCResources *res, const IPCKeys *keys) {
-    memset(res, 0, sizeof(IPCResources));
-    res->state = NULL;
+    ipc_reset_ids(res);
 
     // Attach to shared memory
     if (ipc_shm_attach(res, keys->shm_key) == -1) {
         return -1;
     }
-
-    // Attach to semaphore set
-    if (ipc_sem_attach(res, keys->sem_key) == -1) {
-        return -1;
+    ipc_seal_config(res);
+    res->line_count = res->state->cfg.line_count;
+    res->cashier_count = res->state->cfg.cashier_count;
+
+    // Attach to every line's semaphore set and message queues
+    for (int line = 0; line < res->line_count; line++) {
+        if (ipc_sem_attach(res, line, keys->lines[line].sem_key) == -1 ||
+            ipc_mq_attach_line(res, line, &keys->lines[line]) == -1) {
+            return -1;
+        }
     }
+    ipc_select_line(res, 0);
+    ipc_sem_bind(res);
 
-    // Attach to message queues
+    // Attach to the shared message queues
     if (ipc_mq_attach(res, keys) == -1) {
         return -1;
     }
@@ -166,6 +330,57 @@ int ipc_attach(IPCResources *res, const IPCKeys *keys) {
     return 0;
 }
 
+/**
+ * @brief Point the line-scoped IDs of res at one chairlift line.
+ *
+ * @param res IPC resources (created or attached).
+ * @param line Line index 0..res->line_count-1.
+ */
+void ipc_select_line(IPCResources *res, int line) {
+    const LineIds *ids = &res->lines[line];
+    res->line = line;
+    res->sem_id = ids->sem_id;
+    res->mq_platform_id = ids->mq_platform_id;
+    res->mq_boarding_id = ids->mq_boarding_id;
+    res->mq_arrivals_id = ids->mq_arrivals_id;
+    res->mq_worker_id = ids->mq_worker_id;
+}
+
+/**
+ * @brief Point mq_cashier_id at one cashier's request/response queue.
+ *
+ * @param res IPC resources (created or attached).
+ * @param cashier Cashier index 0..res->cashier_count-1.
+ */
+void ipc_select_cashier(IPCResources *res, int cashier) {
+    res->cashier = cashier;
+    res->mq_cashier_id = res->mq_cashier_ids[cashier];
+}
+
+/**
+ * @brief Queue of the cashier that serves a tourist.
+ *
+ * Tourists are sharded by ID, so each cashier's queue only holds its own
+ * tourists' requests and responses.
+ *
+ * @param res IPC resources.
+ * @param tourist_id Tourist ID.
+ * @return Message queue ID.
+ */
+int ipc_cashier_queue(const IPCResources *res, int tourist_id) {
+    return res->mq_cashier_ids[(unsigned int)tourist_id % (unsigned int)res->cashier_count];
+}
+
+/**
+ * @brief Shared state of the line res currently points at.
+ *
+ * @param res IPC resources.
+ * @return LineState of res->line.
+ */
+LineState *ipc_line_state(const IPCResources *res) {
+    return &res->state->lines[res->line];
+}
+
 /**
  * @brief Detach from IPC resources (for child processes before exit).
  *
@@ -8,9 +8,17 @@
 #include <stdio.h>
 #include <sys/ipc.h>
 
+_Static_assert(MAX_LINES <= 16, "Line key project IDs must fit in 8 bits");
+_Static_assert(MAX_CASHIERS <= 64 && (LINE_KEY_BASE | ((MAX_LINES - 1) << 3) | 7) < CASHIER_KEY_BASE,
+               "Cashier key project IDs must not collide with line keys");
+
 /**
  * @brief Generate IPC keys using ftok.
  *
+ * Line 0 uses the letters below; lines 1..MAX_LINES-1 use project IDs
+ * LINE_KEY_BASE | line << 3 | LINE_KEY_*, which never collide with them.
+ * Cashier queues 1..MAX_CASHIERS-1 use CASHIER_KEY_BASE | cashier.
+ *
  * @param keys Structure to populate with generated keys.
  * @param path File path to use for key generation.
  * @return 0 on success, -1 on error.
@@ -23,15 +31,45 @@ int ipc_generate_keys(IPCKeys *keys, const char *path) {
     keys->mq_boarding_key = ftok(path, 'B');
     keys->mq_arrivals_key = ftok(path, 'A');
     keys->mq_worker_key = ftok(path, 'W');
+    keys->mq_spawn_key = ftok(path, 'T');
 
     if (keys->shm_key == -1 || keys->sem_key == -1 ||
         keys->mq_cashier_key == -1 || keys->mq_platform_key == -1 ||
         keys->mq_boarding_key == -1 || keys->mq_arrivals_key == -1 ||
-        keys->mq_worker_key == -1) {
+        keys->mq_worker_key == -1 || keys->mq_spawn_key == -1) {
         perror("ipc_generate_keys: ftok");
         return -1;
     }
 
+    keys->lines[0].sem_key = keys->sem_key;
+    keys->lines[0].mq_platform_key = keys->mq_platform_key;
+    keys->lines[0].mq_boarding_key = keys->mq_boarding_key;
+    keys->lines[0].mq_arrivals_key = keys->mq_arrivals_key;
+    keys->lines[0].mq_worker_key = keys->mq_worker_key;
+    for (int line = 1; line < MAX_LINES; line++) {
+        int base = LINE_KEY_BASE | (line << 3);
+        LineKeys *lk = &keys->lines[line];
+        lk->sem_key = ftok(path, base | LINE_KEY_SEM);
+        lk->mq_platform_key = ftok(path, base | LINE_KEY_PLATFORM);
+        lk->mq_boarding_key = ftok(path, base | LINE_KEY_BOARDING);
+        lk->mq_arrivals_key = ftok(path, base | LINE_KEY_ARRIVALS);
+        lk->mq_worker_key = ftok(path, base | LINE_KEY_WORKER);
+        if (lk->sem_key == -1 || lk->mq_platform_key == -1 || lk->mq_boarding_key == -1 ||
+            lk->mq_arrivals_key == -1 || lk->mq_worker_key == -1) {
+            perror("ipc_generate_keys: ftok line");
+            return -1;
+        }
+    }
+
+    keys->mq_cashier_keys[0] = keys->mq_cashier_key;
+    for (int c = 1; c < MAX_CASHIERS; c++) {
+        keys->mq_cashier_keys[c] = ftok(path, CASHIER_KEY_BASE | c);
+        if (keys->mq_cashier_keys[c] == -1) {
+            perror("ipc_generate_keys: ftok cashier");
+            return -1;
+        }
+    }
+
     // Note: Keys are logged in ipc_create() to avoid duplicate logs from child processes
 
     return 0;
@@ -6,93 +6,142 @@
 #include "ipc/ipc.h"
 #include "core/logger.h"
 
+#include <errno.h>
 #include <stdio.h>
 #include <sys/msg.h>
 
 /**
- * @brief Create all message queues.
+ * @brief Create the cashier queues (one per cashier) and the spawn queue.
  *
- * Creates cashier, platform, boarding, arrivals, and worker message queues.
+ * The platform, boarding, arrivals and worker queues belong to a line
+ * (see ipc_mq_create_line). res->cashier_count must be set.
  *
  * @param res IPC resources structure to populate with queue IDs.
  * @param keys IPC keys for queue creation.
  * @return 0 on success, -1 on error.
  */
 int ipc_mq_create(IPCResources *res, const IPCKeys *keys) {
-    res->mq_cashier_id = msgget(keys->mq_cashier_key, IPC_CREAT | IPC_EXCL | 0600);
-    if (res->mq_cashier_id == -1) {
-        perror("ipc_mq_create: msgget cashier");
+    for (int c = 0; c < res->cashier_count; c++) {
+        res->mq_cashier_ids[c] = msgget(keys->mq_cashier_keys[c], IPC_CREAT | IPC_EXCL | 0600);
+        if (res->mq_cashier_ids[c] == -1) {
+            perror("ipc_mq_create: msgget cashier");
+            return -1;
+        }
+        log_debug("IPC", "Created cashier %d message queue: id=%d", c, res->mq_cashier_ids[c]);
+    }
+    res->mq_cashier_id = res->mq_cashier_ids[0];
+
+    res->mq_spawn_id = msgget(keys->mq_spawn_key, IPC_CREAT | IPC_EXCL | 0600);
+    if (res->mq_spawn_id == -1) {
+        perror("ipc_mq_create: msgget spawn");
         return -1;
     }
-    log_debug("IPC", "Created cashier message queue: id=%d", res->mq_cashier_id);
+    log_debug("IPC", "Created spawn message queue: id=%d", res->mq_spawn_id);
 
-    res->mq_platform_id = msgget(keys->mq_platform_key, IPC_CREAT | IPC_EXCL | 0600);
-    if (res->mq_platform_id == -1) {
+    return 0;
+}
+
+/**
+ * @brief Create one line's platform, boarding, arrivals and worker queues.
+ *
+ * @param res IPC resources structure to populate with queue IDs (lines[line]).
+ * @param line Line index.
+ * @param keys The line's keys.
+ * @return 0 on success, -1 on error.
+ */
+int ipc_mq_create_line(IPCResources *res, int line, const LineKeys *keys) {
+    LineIds *ids = &res->lines[line];
+
+    ids->mq_platform_id = msgget(keys->mq_platform_key, IPC_CREAT | IPC_EXCL | 0600);
+    if (ids->mq_platform_id == -1) {
         perror("ipc_mq_create: msgget platform");
         return -1;
     }
-    log_debug("IPC", "Created platform message queue: id=%d", res->mq_platform_id);
 
-    res->mq_boarding_id = msgget(keys->mq_boarding_key, IPC_CREAT | IPC_EXCL | 0600);
-    if (res->mq_boarding_id == -1) {
+    ids->mq_boarding_id = msgget(keys->mq_boarding_key, IPC_CREAT | IPC_EXCL | 0600);
+    if (ids->mq_boarding_id == -1) {
         perror("ipc_mq_create: msgget boarding");
         return -1;
     }
-    log_debug("IPC", "Created boarding message queue: id=%d", res->mq_boarding_id);
 
-    res->mq_arrivals_id = msgget(keys->mq_arrivals_key, IPC_CREAT | IPC_EXCL | 0600);
-    if (res->mq_arrivals_id == -1) {
+    ids->mq_arrivals_id = msgget(keys->mq_arrivals_key, IPC_CREAT | IPC_EXCL | 0600);
+    if (ids->mq_arrivals_id == -1) {
         perror("ipc_mq_create: msgget arrivals");
         return -1;
     }
-    log_debug("IPC", "Created arrivals message queue: id=%d", res->mq_arrivals_id);
 
-    res->mq_worker_id = msgget(keys->mq_worker_key, IPC_CREAT | IPC_EXCL | 0600);
-    if (res->mq_worker_id == -1) {
+    ids->mq_worker_id = msgget(keys->mq_worker_key, IPC_CREAT | IPC_EXCL | 0600);
+    if (ids->mq_worker_id == -1) {
         perror("ipc_mq_create: msgget worker");
         return -1;
     }
-    log_debug("IPC", "Created worker message queue: id=%d", res->mq_worker_id);
+    log_debug("IPC", "Created line %d message queues: platform=%d boarding=%d arrivals=%d worker=%d",
+              line, ids->mq_platform_id, ids->mq_boarding_id, ids->mq_arrivals_id,
+              ids->mq_worker_id);
 
     return 0;
 }
 
 /**
- * @brief Attach to existing message queues.
+ * @brief Attach to the existing cashier and spawn message queues.
  *
  * For child processes to access message queues created by main.
+ * res->cashier_count must be set.
  *
  * @param res IPC resources structure to populate with queue IDs.
  * @param keys IPC keys for queue lookup.
  * @return 0 on success, -1 on error.
  */
 int ipc_mq_attach(IPCResources *res, const IPCKeys *keys) {
-    res->mq_cashier_id = msgget(keys->mq_cashier_key, 0600);
-    if (res->mq_cashier_id == -1) {
-        perror("ipc_mq_attach: msgget cashier");
+    for (int c = 0; c < res->cashier_count; c++) {
+        res->mq_cashier_ids[c] = msgget(keys->mq_cashier_keys[c], 0600);
+        if (res->mq_cashier_ids[c] == -1) {
+            perror("ipc_mq_attach: msgget cashier");
+            return -1;
+        }
+    }
+    res->mq_cashier_id = res->mq_cashier_ids[0];
+
+    res->mq_spawn_id = msgget(keys->mq_spawn_key, 0600);
+    if (res->mq_spawn_id == -1) {
+        perror("ipc_mq_attach: msgget spawn");
         return -1;
     }
 
-    res->mq_platform_id = msgget(keys->mq_platform_key, 0600);
-    if (res->mq_platform_id == -1) {
+    return 0;
+}
+
+/**
+ * @brief Attach to one line's existing message queues.
+ *
+ * @param res IPC resources structure to populate with queue IDs (lines[line]).
+ * @param line Line index.
+ * @param keys The line's keys.
+ * @return 0 on success, -1 on error.
+ */
+int ipc_mq_attach_line(IPCResources *res, int line, const LineKeys *keys) {
+    LineIds *ids = &res->lines[line];
+
+    ids->mq_platform_id = msgget(keys->mq_platform_key, 0600);
+    if (ids->mq_platform_id == -1) {
         perror("ipc_mq_attach: msgget platform");
         return -1;
     }
 
-    res->mq_boarding_id = msgget(keys->mq_boarding_key, 0600);
-    if (res->mq_boarding_id == -1) {
+    ids->mq_boarding_id = msgget(keys->mq_boarding_key, 0600);
+    if (ids->mq_boarding_id == -1) {
         perror("ipc_mq_attach: msgget boarding");
         return -1;
     }
 
-    res->mq_arrivals_id = msgget(keys->mq_arrivals_key, 0600);
-    if (res->mq_arrivals_id == -1) {
+    ids->mq_arrivals_id = msgget(keys->mq_arrivals_key, 0600);
+    if (ids->mq_arrivals_id == -1) {
         perror("ipc_mq_attach: msgget arrivals");
         return -1;
     }
 
-    res->mq_worker_id = msgget(keys->mq_worker_key, 0600);
-    if (res->mq_worker_id == -1) {
+    ids->mq_worker_id = msgget(keys->mq_worker_key, 0600);
+    if (ids->mq_worker_id == -1) {
         perror("ipc_mq_attach: msgget worker");
         return -1;
     }
@@ -101,47 +150,128 @@ int ipc_mq_attach(IPCResources *res, const IPCKeys *keys) {
 }
 
 /**
- * @brief Destroy all message queues.
- *
- * Removes all message queues with IPC_RMID.
- *
- * @param res IPC resources containing queue IDs to destroy.
+ * @brief Remove one queue (IPC_RMID) and forget its ID.
  */
-void ipc_mq_destroy(IPCResources *res) {
-    if (res->mq_cashier_id != -1) {
-        if (msgctl(res->mq_cashier_id, IPC_RMID, NULL) == -1) {
-            perror("ipc_mq_destroy: msgctl cashier IPC_RMID");
+static void mq_remove(int *id, const char *what) {
+    if (*id != -1) {
+        if (msgctl(*id, IPC_RMID, NULL) == -1) {
+            fprintf(stderr, "ipc_mq_destroy: msgctl %s IPC_RMID: ", what);
+            perror(NULL);
         }
-        res->mq_cashier_id = -1;
+        *id = -1;
     }
+}
 
-    if (res->mq_platform_id != -1) {
-        if (msgctl(res->mq_platform_id, IPC_RMID, NULL) == -1) {
-            perror("ipc_mq_destroy: msgctl platform IPC_RMID");
-        }
-        res->mq_platform_id = -1;
+/**
+ * @brief Discard every message left in one queue (IPC_NOWAIT, any type).
+ *
+ * @param id Queue ID (-1 = unused).
+ * @return Messages discarded.
+ */
+static int mq_drain(int id) {
+    // Larger than any message type: MSG_NOERROR truncates, the content is dropped
+    struct {
+        long mtype;
+        char mtext[256];
+    } msg;
+    int drained = 0;
+
+    if (id == -1) {
+        return 0;
     }
+    while (msgrcv(id, &msg, sizeof(msg.mtext), 0, IPC_NOWAIT | MSG_NOERROR) != -1) {
+        drained++;
+    }
+    if (errno != ENOMSG) {
+        perror("ipc_mq_drain: msgrcv");
+    }
+    return drained;
+}
 
-    if (res->mq_boarding_id != -1) {
-        if (msgctl(res->mq_boarding_id, IPC_RMID, NULL) == -1) {
-            perror("ipc_mq_destroy: msgctl boarding IPC_RMID");
-        }
-        res->mq_boarding_id = -1;
+/**
+ * @brief Empty all message queues without removing them (sweep reset).
+ *
+ * @param res IPC resources containing queue IDs.
+ * @return Messages discarded.
+ */
+int ipc_mq_drain(IPCResources *res) {
+    int drained = mq_drain(res->mq_spawn_id);
+    for (int c = 0; c < MAX_CASHIERS; c++) {
+        drained += mq_drain(res->mq_cashier_ids[c]);
     }
+    for (int line = 0; line < MAX_LINES; line++) {
+        drained += mq_drain(res->lines[line].mq_platform_id);
+        drained += mq_drain(res->lines[line].mq_boarding_id);
+        drained += mq_drain(res->lines[line].mq_arrivals_id);
+        drained += mq_drain(res->lines[line].mq_worker_id);
+    }
+    return drained;
+}
 
-    if (res->mq_arrivals_id != -1) {
-        if (msgctl(res->mq_arrivals_id, IPC_RMID, NULL) == -1) {
-            perror("ipc_mq_destroy: msgctl arrivals IPC_RMID");
-        }
-        res->mq_arrivals_id = -1;
+/**
+ * @brief Set msg_qbytes of every queue (QUEUE_BYTES).
+ *
+ * Above kernel.msgmnb this needs CAP_SYS_RESOURCE; the preflight only
+ * asks for that when the process has it.
+ *
+ * @param res IPC resources containing queue IDs.
+ * @param qbytes New limit in bytes.
+ * @return 0 on success, -1 on error.
+ */
+int ipc_mq_set_limit(IPCResources *res, int qbytes) {
+    int ids[MAX_CASHIERS + 1 + MAX_LINES * 4];
+    int count = 0;
+    ids[count++] = res->mq_spawn_id;
+    for (int c = 0; c < res->cashier_count; c++) {
+        ids[count++] = res->mq_cashier_ids[c];
+    }
+    for (int line = 0; line < res->line_count; line++) {
+        ids[count++] = res->lines[line].mq_platform_id;
+        ids[count++] = res->lines[line].mq_boarding_id;
+        ids[count++] = res->lines[line].mq_arrivals_id;
+        ids[count++] = res->lines[line].mq_worker_id;
     }
 
-    if (res->mq_worker_id != -1) {
-        if (msgctl(res->mq_worker_id, IPC_RMID, NULL) == -1) {
-            perror("ipc_mq_destroy: msgctl worker IPC_RMID");
+    for (int i = 0; i < count; i++) {
+        struct msqid_ds ds;
+        if (msgctl(ids[i], IPC_STAT, &ds) == -1) {
+            perror("ipc_mq_set_limit: msgctl IPC_STAT");
+            return -1;
+        }
+        ds.msg_qbytes = (msglen_t)qbytes;
+        if (msgctl(ids[i], IPC_SET, &ds) == -1) {
+            perror("ipc_mq_set_limit: msgctl IPC_SET");
+            return -1;
         }
-        res->mq_worker_id = -1;
     }
+    log_debug("IPC", "Set msg_qbytes of %d message queues to %d", count, qbytes);
+    return 0;
+}
+
+/**
+ * @brief Destroy all message queues.
+ *
+ * Removes every cashier's queue, the spawn queue and every line's queues
+ * with IPC_RMID.
+ *
+ * @param res IPC resources containing queue IDs to destroy.
+ */
+void ipc_mq_destroy(IPCResources *res) {
+    for (int c = 0; c < MAX_CASHIERS; c++) {
+        mq_remove(&res->mq_cashier_ids[c], "cashier");
+    }
+    res->mq_cashier_id = -1;
+    for (int line = 0; line < MAX_LINES; line++) {
+        mq_remove(&res->lines[line].mq_platform_id, "platform");
+        mq_remove(&res->lines[line].mq_boarding_id, "boarding");
+        mq_remove(&res->lines[line].mq_arrivals_id, "arrivals");
+        mq_remove(&res->lines[line].mq_worker_id, "worker");
+    }
+    mq_remove(&res->mq_spawn_id, "spawn");
+    res->mq_platform_id = -1;
+    res->mq_boarding_id = -1;
+    res->mq_arrivals_id = -1;
+    res->mq_worker_id = -1;
 }
 
 /**
@@ -152,24 +282,29 @@ void ipc_mq_destroy(IPCResources *res) {
  * @param res IPC resources containing queue IDs to destroy.
  */
 void ipc_mq_destroy_signal_safe(IPCResources *res) {
-    if (res->mq_cashier_id != -1) {
-        msgctl(res->mq_cashier_id, IPC_RMID, NULL);
-        res->mq_cashier_id = -1;
+    if (res->mq_spawn_id != -1) {
+        msgctl(res->mq_spawn_id, IPC_RMID, NULL);
+        res->mq_spawn_id = -1;
     }
-    if (res->mq_platform_id != -1) {
-        msgctl(res->mq_platform_id, IPC_RMID, NULL);
-        res->mq_platform_id = -1;
-    }
-    if (res->mq_boarding_id != -1) {
-        msgctl(res->mq_boarding_id, IPC_RMID, NULL);
-        res->mq_boarding_id = -1;
-    }
-    if (res->mq_arrivals_id != -1) {
-        msgctl(res->mq_arrivals_id, IPC_RMID, NULL);
-        res->mq_arrivals_id = -1;
+    for (int c = 0; c < MAX_CASHIERS; c++) {
+        if (res->mq_cashier_ids[c] != -1) {
+            msgctl(res->mq_cashier_ids[c], IPC_RMID, NULL);
+            res->mq_cashier_ids[c] = -1;
+        }
     }
-    if (res->mq_worker_id != -1) {
-        msgctl(res->mq_worker_id, IPC_RMID, NULL);
-        res->mq_worker_id = -1;
+    res->mq_cashier_id = -1;
+    for (int line = 0; line < MAX_LINES; line++) {
+        int *line_ids[] = {&res->lines[line].mq_platform_id, &res->lines[line].mq_boarding_id,
+                           &res->lines[line].mq_arrivals_id, &res->lines[line].mq_worker_id};
+        for (int i = 0; i < 4; i++) {
+            if (*line_ids[i] != -1) {
+                msgctl(*line_ids[i], IPC_RMID, NULL);
+                *line_ids[i] = -1;
+            }
+        }
     }
+    res->mq_platform_id = -1;
+    res->mq_boarding_id = -1;
+    res->mq_arrivals_id = -1;
+    res->mq_worker_id = -1;
 }
@@ -0,0 +1,172 @@
+/**
+ * @file ipc/numa.c
+ * @brief Huge page size, NUMA node discovery and per-line placement.
+ */
+
+#include "ipc/numa.h"
+#include "core/logger.h"
+
+#include <errno.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Memory policy values from <numaif.h> (libnuma is not a dependency)
+#define NUMA_MPOL_PREFERRED 1
+#define NUMA_MPOL_MF_MOVE (1 << 1)
+
+#define NUMA_NODE_ONLINE_PATH "/sys/devices/system/node/online"
+#define NUMA_MASK_BITS (8 * sizeof(unsigned long))
+#define NUMA_MASK_WORDS (CPU_SETSIZE / NUMA_MASK_BITS)
+
+/**
+ * @brief Read a sysfs list ("0-3,8,10-11") into a set.
+ *
+ * @return Members in the set, -1 if the file cannot be read.
+ */
+static int read_list(const char *path, cpu_set_t *set) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    char buf[1024];
+    char *text = fgets(buf, sizeof(buf), f);
+    fclose(f);
+    if (text == NULL) {
+        return -1;
+    }
+
+    CPU_ZERO(set);
+    char *p = buf;
+    while (*p >= '0' && *p <= '9') {
+        long lo = strtol(p, &p, 10);
+        long hi = lo;
+        if (*p == '-') {
+            hi = strtol(p + 1, &p, 10);
+        }
+        for (long i = lo; i <= hi && i < CPU_SETSIZE; i++) {
+            CPU_SET((int)i, set);
+        }
+        if (*p == ',') {
+            p++;
+        }
+    }
+    return CPU_COUNT(set);
+}
+
+size_t numa_huge_page_size(void) {
+    FILE *f = fopen("/proc/meminfo", "r");
+    if (f == NULL) {
+        return 0;
+    }
+    char line[128];
+    size_t kb = 0;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (sscanf(line, "Hugepagesize: %zu kB", &kb) == 1) {
+            break;
+        }
+    }
+    fclose(f);
+    return kb * 1024;
+}
+
+int numa_node_count(void) {
+    cpu_set_t nodes;
+    int count = read_list(NUMA_NODE_ONLINE_PATH, &nodes);
+    return count > 0 ? count : 1;
+}
+
+int numa_line_node(int line) {
+    cpu_set_t nodes;
+    int count = read_list(NUMA_NODE_ONLINE_PATH, &nodes);
+    if (count <= 0) {
+        return 0;
+    }
+    int want = line % count;
+    for (int node = 0; node < CPU_SETSIZE; node++) {
+        if (CPU_ISSET(node, &nodes) && want-- == 0) {
+            return node;
+        }
+    }
+    return 0;
+}
+
+long numa_place_range(void *addr, size_t len, int node, size_t page_size) {
+    uintptr_t start = ((uintptr_t)addr + page_size - 1) & ~(uintptr_t)(page_size - 1);
+    uintptr_t end = ((uintptr_t)addr + len) & ~(uintptr_t)(page_size - 1);
+    if (end <= start) {
+        return 0;
+    }
+
+    unsigned long mask[NUMA_MASK_WORDS];
+    memset(mask, 0, sizeof(mask));
+    mask[node / NUMA_MASK_BITS] |= 1UL << (node % NUMA_MASK_BITS);
+    if (syscall(SYS_mbind, (void *)start, (unsigned long)(end - start), NUMA_MPOL_PREFERRED,
+                mask, (unsigned long)CPU_SETSIZE, NUMA_MPOL_MF_MOVE) == -1) {
+        return -1;
+    }
+    return (long)(end - start);
+}
+
+void numa_place_lines(IPCResources *res) {
+    SharedState *state = res->state;
+    size_t page_size = state->shm_page_size;
+
+    for (int line = 0; line < state->cfg.line_count; line++) {
+        int node = numa_line_node(line);
+        long placed = numa_place_range(&state->lines[line], sizeof(LineState), node, page_size);
+        if (placed >= 0 && state->transport_offset > 0) {
+            char *block = (char *)state + state->transport_offset +
+                          (size_t)line * state->transport_stride;
+            long t = numa_place_range(block, state->transport_stride, node, page_size);
+            placed = t >= 0 ? placed + t : -1;
+        }
+        if (placed == -1) {
+            log_warn("IPC", "NUMA placement unavailable (mbind: %s), using the default policy",
+                     strerror(errno));
+            return;
+        }
+        log_debug("IPC", "Line %d: %ld bytes of shared state prefer NUMA node %d",
+                  line, placed, node);
+    }
+    state->numa_nodes = numa_node_count();
+    log_info("IPC", "NUMA placement: %d line(s) over %d node(s)", state->cfg.line_count, state->numa_nodes);
+}
+
+int numa_bind_node(int node) {
+    char path[64];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    cpu_set_t cpus;
+    if (read_list(path, &cpus) <= 0) {
+        errno = ENOENT;
+        return -1;
+    }
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) == -1) {
+        return -1;
+    }
+
+    // Private allocations (stack, heap) follow the CPUs; not fatal if refused
+    unsigned long mask[NUMA_MASK_WORDS];
+    memset(mask, 0, sizeof(mask));
+    mask[node / NUMA_MASK_BITS] |= 1UL << (node % NUMA_MASK_BITS);
+    syscall(SYS_set_mempolicy, NUMA_MPOL_PREFERRED, mask, (unsigned long)CPU_SETSIZE);
+
+    return CPU_COUNT(&cpus);
+}
+
+void numa_bind_line_worker(const IPCResources *res, const char *tag) {
+    if (!res->state->cfg.numa_lines) {
+        return;
+    }
+    int node = numa_line_node(res->line);
+    int cpus = numa_bind_node(node);
+    if (cpus == -1) {
+        log_warn(tag, "Cannot bind to NUMA node %d: %s", node, strerror(errno));
+        return;
+    }
+    log_info(tag, "Bound to NUMA node %d (%d CPUs)", node, cpus);
+}
@@ -0,0 +1,125 @@
+/**
+ * @file ipc/queue_stats.c
+ * @brief Queue depth sampling and blocked-sender counts (QueueStats).
+ */
+
+#include "ipc/queue_stats.h"
+#include "ipc/ipc.h"
+#include "ipc/messages.h"
+#include "ipc/transport.h"
+#include "core/fiber.h"
+#include "core/time_sim.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/msg.h>
+
+void queue_note_blocked(SharedState *state, QueueKind kind) {
+    __atomic_add_fetch(&state->queue_stats.queue[kind].blocked_sends, 1, __ATOMIC_RELAXED);
+}
+
+int queue_msgsnd(SharedState *state, QueueKind kind, int msqid, const void *msgp,
+                 size_t msgsz, int msgflg) {
+    if (fiber_msgsnd(msqid, msgp, msgsz, msgflg | IPC_NOWAIT) == 0) {
+        return 0;
+    }
+    if (errno != EAGAIN || (msgflg & IPC_NOWAIT)) {
+        return -1;  // A polling caller counts its own wait, once
+    }
+    queue_note_blocked(state, kind);
+    time_wait_begin();
+    int ret = fiber_msgsnd(msqid, msgp, msgsz, msgflg);
+    time_wait_end();
+    return ret;
+}
+
+int queue_sample_msq(int msqid, size_t msgsz, QueueSample *out) {
+    struct msqid_ds ds;
+    memset(out, 0, sizeof(*out));
+    if (msqid == -1 || msgctl(msqid, IPC_STAT, &ds) == -1) {
+        return -1;
+    }
+    out->messages = (uint32_t)ds.msg_qnum;
+    out->bytes = ds.msg_cbytes;
+    out->limit_bytes = ds.msg_qbytes;
+    // Same test as the kernel's msgsnd: room for the bytes and for one more message
+    out->full = ds.msg_cbytes + msgsz > ds.msg_qbytes || ds.msg_qnum + 1 > ds.msg_qbytes;
+    return 0;
+}
+
+/**
+ * @brief One sampling pass over the queues of one kind.
+ */
+typedef struct {
+    int seen;                       // Queues sampled
+    QueueSample total;              // Messages summed, full if any queue is full
+    uint32_t peak_messages;         // Fullest single queue
+    uint64_t peak_bytes;
+} KindPass;
+
+static void fold(KindPass *k, const QueueSample *q) {
+    if (k->seen++ == 0) {
+        k->total.limit_bytes = q->limit_bytes;
+        k->total.limit_messages = q->limit_messages;
+    }
+    k->total.messages += q->messages;
+    k->total.full |= q->full;
+    if (q->messages > k->peak_messages) k->peak_messages = q->messages;
+    if (q->bytes > k->peak_bytes) k->peak_bytes = q->bytes;
+}
+
+/**
+ * @brief Record one pass of a kind: depth, peaks and time at full.
+ */
+static void record(QueuePressure *p, const KindPass *k, int64_t interval_ns) {
+    p->samples++;
+    p->depth = k->total.messages;
+    p->limit_bytes = k->total.limit_bytes;
+    p->limit_messages = k->total.limit_messages;
+    if (k->peak_messages > p->high_water) p->high_water = k->peak_messages;
+    if (k->peak_bytes > p->high_water_bytes) p->high_water_bytes = k->peak_bytes;
+    if (k->total.full) {
+        p->full_samples++;
+        p->full_ns += interval_ns;  // The interval ending in this sample counts as full
+    }
+}
+
+void queue_stats_sample(IPCResources *res) {
+    QueueStats *qs = &res->state->queue_stats;
+    int64_t now = time_monotonic_ns();
+    int64_t interval_ns = qs->last_sample_ns > 0 ? now - qs->last_sample_ns : 0;
+    qs->last_sample_ns = now;
+
+    KindPass pass[QUEUE_KIND_COUNT];
+    memset(pass, 0, sizeof(pass));
+    QueueSample q;
+
+    for (int c = 0; c < res->cashier_count; c++) {
+        if (queue_sample_msq(res->mq_cashier_ids[c], sizeof(CashierMsg) - sizeof(long), &q) == 0) {
+            fold(&pass[QUEUE_CASHIER], &q);
+        }
+    }
+    if (queue_sample_msq(res->mq_spawn_id, sizeof(TouristSpawnMsg) - sizeof(long), &q) == 0) {
+        fold(&pass[QUEUE_SPAWN], &q);
+    }
+
+    static const QueueKind channels[] = {QUEUE_PLATFORM, QUEUE_BOARDING, QUEUE_ARRIVALS};
+    IPCResources line_res = *res;
+    for (int l = 0; l < res->line_count; l++) {
+        ipc_select_line(&line_res, l);
+        for (int ch = TRANSPORT_PLATFORM; ch <= TRANSPORT_ARRIVALS; ch++) {
+            if (transport_stat(&line_res, (TransportChannel)ch, &q) == 0) {
+                fold(&pass[channels[ch]], &q);
+            }
+        }
+        if (queue_sample_msq(line_res.mq_worker_id, sizeof(WorkerMsg) - sizeof(long), &q) == 0) {
+            fold(&pass[QUEUE_WORKER], &q);
+        }
+    }
+
+    for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+        if (pass[k].seen > 0) {
+            record(&qs->queue[k], &pass[k], interval_ns);
+        }
+    }
+}
@@ -1,12 +1,25 @@
 /**
  * @file ipc/sem.c
- * @brief System V semaphore operations.
+ * @brief System V semaphore operations with an optional futex backend.
+ *
+ * With SEM_BACKEND=1 the indices in SEM_FUTEX_MASK are served from
+ * SharedState.futex_sems: acquire/release are a CAS/add on the counter and
+ * only enter the kernel (futex) when a caller has to sleep. Sleeps are sliced
+ * by SHM_WAIT_TIMEOUT_MS and probe the SysV set between slices, so IPC_RMID
+ * still unblocks waiters at shutdown exactly like semop. Unlike semop, a
+ * process SIGKILLed while holding a futex slot does not get it back from the
+ * kernel, which is why SysV stays the default.
  */
 
 #include "ipc/ipc.h"
+#include "ipc/internal.h"
+#include "ipc/futex.h"
+#include "core/fiber.h"
 #include "core/logger.h"
+#include "core/time_sim.h"
 
 #include <errno.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <sys/sem.h>
 
@@ -18,23 +31,122 @@ union semun {
     struct seminfo *_buf;
 };
 
+// Futex semaphores of this process's mapping, one array per line (none = SysV only).
+// sem_wait/sem_post only receive the set ID, so the mapping is bound once
+// per process by ipc_sem_bind() and matched against each line's set ID.
+static FutexSem *g_futex_sems[MAX_LINES];
+static int g_futex_sem_ids[MAX_LINES];
+static int g_futex_lines = 0;
+
+/**
+ * @brief Return the futex semaphore serving (sem_id, sem_num), or NULL for semop.
+ */
+static FutexSem *futex_sem_for(int sem_id, int sem_num) {
+    if (g_futex_lines == 0 || sem_num < 0 || sem_num >= SEM_COUNT ||
+        !(SEM_FUTEX_MASK & (1u << sem_num))) {
+        return NULL;
+    }
+    for (int line = 0; line < g_futex_lines; line++) {
+        if (g_futex_sem_ids[line] == sem_id) {
+            return &g_futex_sems[line][sem_num];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Try to take count slots without blocking.
+ *
+ * @return 0 on success, -1 with errno EAGAIN if not enough slots.
+ */
+static int futex_sem_trywait(FutexSem *fs, int count) {
+    uint32_t v = __atomic_load_n(&fs->value, __ATOMIC_RELAXED);
+    while (v >= (uint32_t)count) {
+        if (__atomic_compare_exchange_n(&fs->value, &v, v - (uint32_t)count, 1,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            return 0;
+        }
+    }
+    errno = EAGAIN;
+    return -1;
+}
+
 /**
- * @brief Create and initialize semaphore set.
+ * @brief Take count slots, sleeping on the futex word while short.
  *
- * @param res IPC resources structure to populate with semaphore ID.
+ * @return 0 on success, -1 with errno EINTR (signal) or EIDRM (set removed).
+ */
+static int futex_sem_wait(FutexSem *fs, int sem_id, int count) {
+    while (futex_sem_trywait(fs, count) == -1) {
+        uint32_t v = __atomic_load_n(&fs->value, __ATOMIC_RELAXED);
+        if (v >= (uint32_t)count) continue;
+
+        __atomic_add_fetch(&fs->waiters, 1, __ATOMIC_SEQ_CST);
+        time_wait_begin();
+        int rc = futex_wait(&fs->value, v, SHM_WAIT_TIMEOUT_MS);
+        int saved = errno;
+        time_wait_end();
+        __atomic_sub_fetch(&fs->waiters, 1, __ATOMIC_SEQ_CST);
+
+        if (rc == -1 && saved == EINTR) {
+            errno = EINTR;
+            return -1;
+        }
+        if (rc == -1 && saved == ETIMEDOUT && semctl(sem_id, 0, GETVAL) == -1) {
+            // Set removed (shutdown or stale cleanup) - same outcome as semop
+            errno = EIDRM;
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Release count slots and wake sleepers if any.
+ */
+static void futex_sem_post(FutexSem *fs, int sem_num, int count) {
+    __atomic_add_fetch(&fs->value, (uint32_t)count, __ATOMIC_RELEASE);
+    if (__atomic_load_n(&fs->waiters, __ATOMIC_SEQ_CST) > 0) {
+        // Mutex waiters all need one slot; capacity waiters may need several
+        // (families), so wake everyone and let them re-check.
+        int wake = (sem_num == SEM_STATE || sem_num == SEM_STATS) ? count : INT32_MAX;
+        futex_wake(&fs->value, wake);
+    }
+}
+
+/**
+ * @brief Create and initialize one line's semaphore set.
+ *
+ * @param res IPC resources structure to populate with semaphore ID (lines[line]).
+ * @param line Line index.
  * @param key Semaphore key for creation.
  * @param cfg Configuration with initial values.
  * @return 0 on success, -1 on error.
  */
-int ipc_sem_create(IPCResources *res, key_t key, const Config *cfg) {
-    res->sem_id = semget(key, SEM_COUNT, IPC_CREAT | IPC_EXCL | 0600);
-    if (res->sem_id == -1) {
+int ipc_sem_create(IPCResources *res, int line, key_t key, const Config *cfg) {
+    int sem_id = semget(key, SEM_COUNT, IPC_CREAT | IPC_EXCL | 0600);
+    res->lines[line].sem_id = sem_id;
+    if (sem_id == -1) {
         perror("ipc_sem_create: semget");
         return -1;
     }
-    log_debug("IPC", "Created semaphore set: id=%d", res->sem_id);
+    log_debug("IPC", "Created semaphore set: line=%d id=%d", line, sem_id);
+    return ipc_sem_reset(res, line, cfg);
+}
 
-    // Initialize semaphores
+/**
+ * @brief Set one line's semaphores (and futex mirrors) to their initial values.
+ *
+ * Used at creation and between sweep runs. SETALL also clears every
+ * process's SEM_UNDO adjustments for the set.
+ *
+ * @param res IPC resources with the line's semaphore set and shared state.
+ * @param line Line index.
+ * @param cfg Configuration (station capacity, backend).
+ * @return 0 on success, -1 on error.
+ */
+int ipc_sem_reset(IPCResources *res, int line, const Config *cfg) {
+    int sem_id = res->lines[line].sem_id;
     union semun arg;
     unsigned short sem_values[SEM_COUNT];
 
@@ -50,26 +162,57 @@ int ipc_sem_create(IPCResources *res, key_t key, const Config *cfg) {
     sem_values[SEM_EMERGENCY_LOCK] = 1;
 
     arg.array = sem_values;
-    if (semctl(res->sem_id, 0, SETALL, arg) == -1) {
-        perror("ipc_sem_create: semctl SETALL");
+    if (semctl(sem_id, 0, SETALL, arg) == -1) {
+        perror("ipc_sem_reset: semctl SETALL");
         return -1;
     }
     log_debug("IPC", "Initialized semaphores: station_capacity=%d, sem_count=%d",
               cfg->station_capacity, SEM_COUNT);
 
+    // Futex backend starts from the same values
+    if (cfg->sem_backend == SEM_BACKEND_FUTEX) {
+        FutexSem *sems = res->state->lines[line].futex_sems;
+        for (int i = 0; i < SEM_COUNT; i++) {
+            sems[i].value = sem_values[i];
+            sems[i].waiters = 0;
+        }
+        if (line == 0) {
+            log_debug("IPC", "Futex semaphore backend enabled: mask=0x%x", SEM_FUTEX_MASK);
+        }
+    }
+
     return 0;
 }
 
 /**
- * @brief Attach to existing semaphore set.
+ * @brief Bind this process's futex semaphores (no-op for SEM_BACKEND=0).
+ *
+ * Called once shared memory and the semaphore set are both attached.
+ *
+ * @param res IPC resources with attached shared state.
+ */
+void ipc_sem_bind(IPCResources *res) {
+    g_futex_lines = 0;
+    if (res->state != NULL && res->state->cfg.sem_backend == SEM_BACKEND_FUTEX) {
+        for (int line = 0; line < res->line_count; line++) {
+            g_futex_sems[line] = res->state->lines[line].futex_sems;
+            g_futex_sem_ids[line] = res->lines[line].sem_id;
+        }
+        g_futex_lines = res->line_count;
+    }
+}
+
+/**
+ * @brief Attach to one line's existing semaphore set.
  *
- * @param res IPC resources structure to populate with semaphore ID.
+ * @param res IPC resources structure to populate with semaphore ID (lines[line]).
+ * @param line Line index.
  * @param key Semaphore key for lookup.
  * @return 0 on success, -1 on error.
  */
-int ipc_sem_attach(IPCResources *res, key_t key) {
-    res->sem_id = semget(key, SEM_COUNT, 0600);
-    if (res->sem_id == -1) {
+int ipc_sem_attach(IPCResources *res, int line, key_t key) {
+    res->lines[line].sem_id = semget(key, SEM_COUNT, 0600);
+    if (res->lines[line].sem_id == -1) {
         perror("ipc_sem_attach: semget");
         return -1;
     }
@@ -77,17 +220,20 @@ int ipc_sem_attach(IPCResources *res, key_t key) {
 }
 
 /**
- * @brief Destroy semaphore set.
+ * @brief Destroy every line's semaphore set.
  *
- * @param res IPC resources containing semaphore ID to destroy.
+ * @param res IPC resources containing semaphore IDs to destroy.
  */
 void ipc_sem_destroy(IPCResources *res) {
-    if (res->sem_id != -1) {
-        if (semctl(res->sem_id, 0, IPC_RMID) == -1) {
-            perror("ipc_sem_destroy: semctl IPC_RMID");
+    for (int line = 0; line < MAX_LINES; line++) {
+        if (res->lines[line].sem_id != -1) {
+            if (semctl(res->lines[line].sem_id, 0, IPC_RMID) == -1) {
+                perror("ipc_sem_destroy: semctl IPC_RMID");
+            }
+            res->lines[line].sem_id = -1;
         }
-        res->sem_id = -1;
     }
+    res->sem_id = -1;
 }
 
 /**
@@ -95,13 +241,16 @@ void ipc_sem_destroy(IPCResources *res) {
  *
  * Uses only semctl which is async-signal-safe.
  *
- * @param res IPC resources containing semaphore ID to destroy.
+ * @param res IPC resources containing semaphore IDs to destroy.
  */
 void ipc_sem_destroy_signal_safe(IPCResources *res) {
-    if (res->sem_id != -1) {
-        semctl(res->sem_id, 0, IPC_RMID);
-        res->sem_id = -1;
+    for (int line = 0; line < MAX_LINES; line++) {
+        if (res->lines[line].sem_id != -1) {
+            semctl(res->lines[line].sem_id, 0, IPC_RMID);
+            res->lines[line].sem_id = -1;
+        }
     }
+    res->sem_id = -1;
 }
 
 /**
@@ -116,9 +265,16 @@ void ipc_sem_destroy_signal_safe(IPCResources *res) {
  */
 int sem_wait(int sem_id, int sem_num, int count) {
     if (count <= 0) return 0;
+    FutexSem *fs = futex_sem_for(sem_id, sem_num);
+    if (fs != NULL) {
+        return futex_sem_wait(fs, sem_id, count);
+    }
     struct sembuf sop = {sem_num, -count, 0};
 
-    if (semop(sem_id, &sop, 1) == -1) {
+    time_wait_begin();
+    int rc = fiber_semop(sem_id, &sop, 1);
+    time_wait_end();
+    if (rc == -1) {
         // EINTR: interrupted by signal
         // EIDRM: semaphore removed while blocked
         // EINVAL: semaphore already removed before call
@@ -144,9 +300,24 @@ int sem_wait(int sem_id, int sem_num, int count) {
  */
 int sem_wait_pauseable(IPCResources *res, int sem_num, int count) {
     if (count <= 0) return 0;
+    FutexSem *fs = futex_sem_for(res->sem_id, sem_num);
+    if (fs != NULL) {
+        while (futex_sem_wait(fs, res->sem_id, count) == -1) {
+            if (errno != EINTR) {
+                return -1;  // Shutdown - IPC destroyed
+            }
+        }
+        return 0;
+    }
     struct sembuf sop = {sem_num, -count, 0};
 
-    while (semop(res->sem_id, &sop, 1) == -1) {
+    for (;;) {
+        time_wait_begin();
+        int rc = fiber_semop(res->sem_id, &sop, 1);
+        time_wait_end();
+        if (rc == 0) {
+            return 0;
+        }
         // EIDRM: semaphore removed while blocked
         // EINVAL: semaphore already removed before call
         if (errno == EIDRM || errno == EINVAL) {
@@ -160,7 +331,6 @@ int sem_wait_pauseable(IPCResources *res, int sem_num, int count) {
         perror("sem_wait_pauseable: semop");
         return -1;
     }
-    return 0;
 }
 
 /**
@@ -175,6 +345,11 @@ int sem_wait_pauseable(IPCResources *res, int sem_num, int count) {
  */
 int sem_post(int sem_id, int sem_num, int count) {
     if (count <= 0) return 0;
+    FutexSem *fs = futex_sem_for(sem_id, sem_num);
+    if (fs != NULL) {
+        futex_sem_post(fs, sem_num, count);
+        return 0;
+    }
     struct sembuf sop = {sem_num, count, 0};
 
     if (semop(sem_id, &sop, 1) == -1) {
@@ -198,6 +373,10 @@ int sem_post(int sem_id, int sem_num, int count) {
  * @return 0 on success, -1 if would block (EAGAIN) or on error.
  */
 int sem_trywait(int sem_id, int sem_num) {
+    FutexSem *fs = futex_sem_for(sem_id, sem_num);
+    if (fs != NULL) {
+        return futex_sem_trywait(fs, 1);
+    }
     struct sembuf sop = {sem_num, -1, IPC_NOWAIT};
 
     if (semop(sem_id, &sop, 1) == -1) {
@@ -214,6 +393,33 @@ int sem_trywait(int sem_id, int sem_num) {
     return 0;
 }
 
+/**
+ * @brief Non-blocking semaphore wait by count.
+ *
+ * Acquires all count slots at once or none. errno is left from semop so
+ * callers can tell EAGAIN (would block) from EIDRM/EINVAL (shutdown).
+ *
+ * @param sem_id Semaphore set ID.
+ * @param sem_num Semaphore index within the set.
+ * @param count Number of slots to acquire.
+ * @return 0 on success, -1 if would block or on error.
+ */
+int sem_trywait_count(int sem_id, int sem_num, int count) {
+    FutexSem *fs = futex_sem_for(sem_id, sem_num);
+    if (fs != NULL) {
+        return futex_sem_trywait(fs, count);
+    }
+    struct sembuf sop = {sem_num, -count, IPC_NOWAIT};
+
+    if (semop(sem_id, &sop, 1) == -1) {
+        if (errno != EAGAIN && errno != EINTR && errno != EIDRM && errno != EINVAL) {
+            perror("sem_trywait_count: semop");
+        }
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * @brief Get current semaphore value.
  *
@@ -222,6 +428,10 @@ int sem_trywait(int sem_id, int sem_num) {
  * @return Current value, or -1 on error.
  */
 int sem_getval(int sem_id, int sem_num) {
+    FutexSem *fs = futex_sem_for(sem_id, sem_num);
+    if (fs != NULL) {
+        return (int)__atomic_load_n(&fs->value, __ATOMIC_RELAXED);
+    }
     int val = semctl(sem_id, sem_num, GETVAL);
     if (val == -1 && errno != EINVAL && errno != EIDRM) {
         perror("sem_getval: semctl GETVAL");
@@ -4,27 +4,113 @@
  */
 
 #include "ipc/ipc.h"
+#include "ipc/numa.h"
 #include "core/logger.h"
 
+#include <errno.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/mman.h>
 #include <sys/shm.h>
+#include <unistd.h>
+
+// SharedState regions (see ipc/shared_state.h) must each start a cache line
+#define ASSERT_LINE_START(field) \
+    _Static_assert(offsetof(SharedState, field) % 64 == 0, #field " must start a cache line")
+
+_Static_assert(offsetof(SharedState, cfg) == 0 && sizeof(Config) <= CONFIG_BLOCK_SIZE,
+               "Config must fit the first page of the segment");
+ASSERT_LINE_START(real_start_time);
+ASSERT_LINE_START(control);
+ASSERT_LINE_START(stats_shard_hint);
+ASSERT_LINE_START(stats_shards);
+ASSERT_LINE_START(lines);
+ASSERT_LINE_START(latency);
+ASSERT_LINE_START(vclock);
+ASSERT_LINE_START(max_tracked_tourists);
+_Static_assert(sizeof(FutexSem) == 64, "FutexSem must fill exactly one cache line");
+_Static_assert(sizeof(LineState) % 64 == 0 &&
+               offsetof(LineState, tourists_on_chairs) == 64 &&
+               offsetof(LineState, chair_dispatch_seq) == 128 &&
+               offsetof(LineState, emergency_waiters) == 192 &&
+               offsetof(LineState, futex_sems) % 64 == 0 &&
+               offsetof(LineState, chair_tracks) % 64 == 0 &&
+               offsetof(LineState, assembler) % 64 == 0,
+               "LineState fields must each start a cache line");
+_Static_assert(sizeof(TouristEntry) == 8, "TouristEntry must stay 8 bytes");
+_Static_assert(TICKET_COUNT <= 8 && MAX_KIDS_PER_ADULT <= 3,
+               "TouristEntry bitfields too narrow");
+
+/**
+ * @brief Ask for transparent huge pages on an attached segment.
+ *
+ * Takes effect when /sys/kernel/mm/transparent_hugepage/shmem_enabled is
+ * "advise" (or "always"); the flag belongs to this mapping, so every
+ * attacher sets it.
+ */
+static void shm_advise_huge(void *addr, size_t size) {
+    if (madvise(addr, size, MADV_HUGEPAGE) == -1) {
+        log_warn("IPC", "madvise(MADV_HUGEPAGE) failed: %s", strerror(errno));
+    }
+}
+
+/**
+ * @brief Create a SHM_HUGETLB segment, size rounded up to the huge page size.
+ *
+ * @return Segment ID, -1 with errno set (ENOMEM when the pool is empty,
+ *         EPERM outside hugetlb_shm_group, EINVAL without huge pages).
+ */
+static int shm_create_hugetlb(key_t key, size_t *size, size_t *page_size) {
+    size_t huge = numa_huge_page_size();
+    if (huge == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    size_t rounded = (*size + huge - 1) & ~(huge - 1);
+    int id = shmget(key, rounded, IPC_CREAT | IPC_EXCL | SHM_HUGETLB | 0600);
+    if (id != -1) {
+        *size = rounded;
+        *page_size = huge;
+    }
+    return id;
+}
 
 /**
  * @brief Create and attach shared memory segment.
  *
+ * With SHM_PAGES_HUGETLB a segment that cannot get huge pages falls back to
+ * base pages with a warning. The page size used is stored in res->shm_page_size.
+ *
  * @param res IPC resources structure to populate.
  * @param key Shared memory key.
  * @param size Size of shared memory segment.
+ * @param pages ShmPages (SHM_HUGE_PAGES config value).
  * @return 0 on success, -1 on error.
  */
-int ipc_shm_create(IPCResources *res, key_t key, size_t size) {
-    res->shm_id = shmget(key, size, IPC_CREAT | IPC_EXCL | 0600);
+int ipc_shm_create(IPCResources *res, key_t key, size_t size, int pages) {
+    res->shm_page_size = (size_t)sysconf(_SC_PAGESIZE);
+    res->shm_id = -1;
+    if (pages == SHM_PAGES_HUGETLB) {
+        res->shm_id = shm_create_hugetlb(key, &size, &res->shm_page_size);
+        if (res->shm_id == -1) {
+            if (errno == EEXIST) {
+                perror("ipc_shm_create: shmget SHM_HUGETLB");
+                return -1;
+            }
+            log_warn("IPC", "Huge pages unavailable (%s), using %zu-byte pages",
+                     strerror(errno), res->shm_page_size);
+        }
+    }
+    if (res->shm_id == -1) {
+        res->shm_id = shmget(key, size, IPC_CREAT | IPC_EXCL | 0600);
+    }
     if (res->shm_id == -1) {
         perror("ipc_shm_create: shmget");
         return -1;
     }
-    log_debug("IPC", "Created shared memory: id=%d, size=%zu", res->shm_id, size);
+    log_debug("IPC", "Created shared memory: id=%d, size=%zu, page=%zu",
+              res->shm_id, size, res->shm_page_size);
 
     // Attach shared memory
     res->state = (SharedState *)shmat(res->shm_id, NULL, 0);
@@ -34,9 +120,13 @@ int ipc_shm_create(IPCResources *res, key_t key, size_t size) {
         return -1;
     }
     log_debug("IPC", "Attached shared memory");
+    if (pages == SHM_PAGES_TRANSPARENT) {
+        shm_advise_huge(res->state, size);
+    }
 
-    // Initialize shared memory to zero (including flexible array)
-    memset(res->state, 0, size);
+    // New segments (IPC_EXCL) are zero-filled by the kernel. The segment is
+    // not cleared here, so tourist table pages are only committed when a
+    // tourist first writes its entry, not for the configured maximum.
 
     return 0;
 }
@@ -64,9 +154,27 @@ int ipc_shm_attach(IPCResources *res, key_t key) {
         return -1;
     }
 
+    if (res->state->cfg.shm_huge_pages == SHM_PAGES_TRANSPARENT) {
+        shm_advise_huge(res->state, res->state->shm_size);
+    }
+
     return 0;
 }
 
+/**
+ * @brief Map the first page (SharedState.cfg) read-only in this process.
+ *
+ * @param res IPC resources with the segment attached.
+ */
+void ipc_seal_config(const IPCResources *res) {
+    if (!res->state->cfg_sealed) {
+        return;  // Huge pages: the first page holds more than the config block
+    }
+    if (mprotect(res->state, CONFIG_BLOCK_SIZE, PROT_READ) == -1) {
+        log_warn("IPC", "Cannot seal the config block: %s", strerror(errno));
+    }
+}
+
 /**
  * @brief Detach from shared memory segment.
  *
@@ -118,29 +226,28 @@ void ipc_shm_destroy_signal_safe(IPCResources *res) {
  * @param cfg Configuration values to copy.
  */
 void ipc_shm_init_state(IPCResources *res, const Config *cfg) {
-    // Copy config to shared state
-    res->state->station_capacity = cfg->station_capacity;
+    // One copy of the whole config; children only ever read it (ipc_seal_config)
+    res->state->cfg = *cfg;
+
+    // Values derived from it
     res->state->tourists_to_generate = cfg->total_tourists;
-    res->state->tourist_spawn_delay_us = cfg->tourist_spawn_delay_us;
-    res->state->max_tracked_tourists = cfg->total_tourists;
+    res->state->worker_cpus = cfg->worker_cpus;
+    res->state->max_tracked_tourists = cfg->report_incremental ? 0 : cfg->total_tourists;
     res->state->tourist_entry_count = 0;
-    res->state->vip_percentage = cfg->vip_percentage;
-    res->state->walker_percentage = cfg->walker_percentage;
-    res->state->family_percentage = cfg->family_percentage;
-    res->state->trail_walk_time = cfg->trail_walk_time;
-    res->state->trail_bike_fast_time = cfg->trail_bike_fast_time;
-    res->state->trail_bike_medium_time = cfg->trail_bike_medium_time;
-    res->state->trail_bike_slow_time = cfg->trail_bike_slow_time;
-    res->state->ticket_t1_duration = cfg->ticket_t1_duration;
-    res->state->ticket_t2_duration = cfg->ticket_t2_duration;
-    res->state->ticket_t3_duration = cfg->ticket_t3_duration;
-    res->state->danger_probability = cfg->danger_probability;
-    res->state->danger_duration_sim = cfg->danger_duration_sim;
-    res->state->debug_logs_enabled = cfg->debug_logs_enabled;
-    res->state->scared_enabled = cfg->scared_enabled;
+    res->state->event_trace = cfg->event_trace;
+    res->state->arrival_poisson = 0;
+    for (int h = 0; h < ARRIVAL_RATE_HOURS; h++) {
+        res->state->arrival_rate_hour[h] = config_arrival_rate(cfg, h);
+        if (res->state->arrival_rate_hour[h] > 0) {
+            res->state->arrival_poisson = 1;
+        }
+    }
 
     // Set initial state
-    res->state->running = 1;
-    res->state->closing = 0;
-    res->state->emergency_stop = 0;
+    res->state->control.running = 1;
+    res->state->control.closing = 0;
+    res->state->control.emergency_stop = 0;
+    for (int line = 0; line < cfg->line_count; line++) {
+        res->state->lines[line].assembler.chair_id = 1;
+    }
 }
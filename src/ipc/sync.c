@@ -4,26 +4,60 @@
  */
 
 #include "ipc/ipc.h"
+#include "ipc/control.h"
+#include "ipc/futex.h"
 #include "core/logger.h"
+#include "core/time_sim.h"
 
 #include <errno.h>
 #include <string.h>
+#include <sys/sem.h>
+#include <unistd.h>
+
+// time_monotonic_ns() just before this process was forked (0 = not a spawned worker)
+static int64_t g_spawn_ns = 0;
+
+/**
+ * @brief Remember when the calling worker was forked (for its ready latency).
+ *
+ * Called in the child right after fork with the parent's pre-fork timestamp.
+ *
+ * @param spawn_ns time_monotonic_ns() taken by the parent before fork().
+ */
+void ipc_note_spawn(int64_t spawn_ns) {
+    g_spawn_ns = spawn_ns;
+}
 
 /**
- * @brief Wait for emergency stop to clear.
+ * @brief Wait for the emergency stop of res's line to clear.
  *
- * Properly tracks emergency_waiters for reliable wakeup.
+ * Properly tracks the line's emergency_waiters for reliable wakeup.
  *
  * @param res IPC resources.
  */
 void ipc_wait_emergency_clear(IPCResources *res) {
+    if (res->state->cfg.emergency_backend == EMERGENCY_BACKEND_FUTEX) {
+        LineState *ls = ipc_line_state(res);
+        uint32_t epoch;
+        while (((epoch = __atomic_load_n(&ls->emergency_epoch, __ATOMIC_ACQUIRE)) & 1) &&
+               control_running(res->state)) {
+            // Counted before the wait, so a resume that sees no sleepers found the epoch even first
+            __atomic_add_fetch(&ls->emergency_sleepers, 1, __ATOMIC_SEQ_CST);
+            time_wait_begin();
+            futex_wait(&ls->emergency_epoch, epoch, SHM_WAIT_TIMEOUT_MS);
+            time_wait_end();
+            __atomic_sub_fetch(&ls->emergency_sleepers, 1, __ATOMIC_SEQ_CST);
+        }
+        return;
+    }
+
     if (sem_wait(res->sem_id, SEM_STATE, 1) == -1) {
         return;  // Shutdown in progress
     }
-    int emergency = res->state->emergency_stop;
+    int emergency = control_emergency_stop(res->state, res->line);
     if (emergency) {
         // Track that we're waiting
-        res->state->emergency_waiters++;
+        ipc_line_state(res)->emergency_waiters++;
     }
     sem_post(res->sem_id, SEM_STATE, 1);
 
@@ -33,10 +67,43 @@ void ipc_wait_emergency_clear(IPCResources *res) {
     }
 }
 
+/**
+ * @brief Make the line's emergency epoch odd (EMERGENCY_BACKEND=1).
+ *
+ * @param res IPC resources.
+ * @return 1 if the caller stopped the line, 0 if it was already stopped.
+ */
+int ipc_emergency_epoch_stop(IPCResources *res) {
+    LineState *ls = ipc_line_state(res);
+    uint32_t epoch = __atomic_load_n(&ls->emergency_epoch, __ATOMIC_ACQUIRE);
+    if ((epoch & 1) ||
+        !__atomic_compare_exchange_n(&ls->emergency_epoch, &epoch, epoch + 1, 0,
+                                     __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    control_set_emergency_stop(res->state, res->line, 1);
+    return 1;
+}
+
+/**
+ * @brief Make the line's emergency epoch even and wake everyone sleeping on it.
+ *
+ * @param res IPC resources.
+ */
+void ipc_emergency_epoch_resume(IPCResources *res) {
+    LineState *ls = ipc_line_state(res);
+    // Bit first: a tourist woken by the epoch must not find the line still stopped
+    control_set_emergency_stop(res->state, res->line, 0);
+    __atomic_add_fetch(&ls->emergency_epoch, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ls->emergency_sleepers, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&ls->emergency_epoch, INT32_MAX);
+    }
+}
+
 /**
  * @brief Release all processes waiting for emergency to clear.
  *
- * Called when emergency stop is cleared (after both workers ready).
+ * Called when emergency stop is cleared (after both workers of the line are ready).
  *
  * @param res IPC resources.
  */
@@ -44,8 +111,9 @@ void ipc_release_emergency_waiters(IPCResources *res) {
     if (sem_wait(res->sem_id, SEM_STATE, 1) == -1) {
         return;  // Shutdown in progress
     }
-    int waiters = res->state->emergency_waiters;
-    res->state->emergency_waiters = 0;
+    LineState *ls = ipc_line_state(res);
+    int waiters = ls->emergency_waiters;
+    ls->emergency_waiters = 0;
     sem_post(res->sem_id, SEM_STATE, 1);
 
     // Release all waiters
@@ -58,12 +126,23 @@ void ipc_release_emergency_waiters(IPCResources *res) {
 /**
  * @brief Signal that a worker has completed initialization.
  *
- * Called by each worker (TimeServer, Cashier, LowerWorker, UpperWorker).
+ * Called by each worker (TimeServer, Cashier, LowerWorker, UpperWorker) on the
+ * set of res's line. Records the worker's fork and ready times in a
+ * StartupTiming.ready slot first.
  *
  * @param res IPC resources.
  * @return 0 on success, -1 on error.
  */
 int ipc_signal_worker_ready(IPCResources *res) {
+    StartupTiming *st = &res->state->startup;
+    uint32_t slot = __atomic_fetch_add(&st->ready_count, 1, __ATOMIC_RELAXED);
+    if (slot < STARTUP_MAX_WORKERS) {
+        st->ready[slot].pid = getpid();
+        st->ready[slot].spawn_ns = g_spawn_ns;
+        st->ready[slot].ready_ns = time_monotonic_ns();
+    }
+
+    // The post publishes the slot to main (semop is a full barrier)
     if (sem_post(res->sem_id, SEM_WORKER_READY, 1) == -1) {
         log_error("IPC", "sem_post(SEM_WORKER_READY) failed: %s", strerror(errno));
         return -1;
@@ -74,19 +153,28 @@ int ipc_signal_worker_ready(IPCResources *res) {
 /**
  * @brief Wait for all workers to signal ready.
  *
- * Called by main process before spawning tourist generator.
+ * Called by main process before spawning tourist generator. SEM_WORKER_READY
+ * always lives on the SysV set, so the wait is one semtimedop().
  *
  * @param res IPC resources.
  * @param expected_count Number of workers to wait for.
- * @return 0 on success, -1 on error/timeout.
+ * @param timeout_ms Wait cap (> 0).
+ * @return 0 on success, -1 on error/timeout (errno EAGAIN).
  */
-int ipc_wait_workers_ready(IPCResources *res, int expected_count) {
+int ipc_wait_workers_ready(IPCResources *res, int expected_count, int timeout_ms) {
     log_debug("IPC", "Waiting for %d workers to be ready...", expected_count);
 
     // Wait for expected_count posts to SEM_WORKER_READY
     // Each worker posts 1, so we wait for the total count
-    if (sem_wait(res->sem_id, SEM_WORKER_READY, expected_count) == -1) {
-        log_error("IPC", "sem_wait(SEM_WORKER_READY) failed: %s", strerror(errno));
+    struct sembuf sop = {SEM_WORKER_READY, (short)-expected_count, 0};
+    struct timespec timeout = {timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L};
+    if (semtimedop(res->sem_id, &sop, 1, &timeout) == -1) {
+        if (errno == EAGAIN) {
+            log_error("IPC", "Workers not ready after %d ms (%u ready in total so far)", timeout_ms,
+                      __atomic_load_n(&res->state->startup.ready_count, __ATOMIC_RELAXED));
+        } else {
+            log_error("IPC", "semtimedop(SEM_WORKER_READY) failed: %s", strerror(errno));
+        }
         return -1;
     }
 
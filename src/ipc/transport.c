@@ -0,0 +1,806 @@
+/**
+ * @file ipc/transport.c
+ * @brief Platform/boarding/arrivals transport: SysV message queues or shm rings.
+ *
+ * Ring mode uses bounded Vyukov queues (per-slot sequence numbers, CAS on the
+ * producer cursor) for tourists -> lower worker and tourists -> upper worker,
+ * and one single-message mailbox per tourist for boarding confirmations.
+ * Pushes and pops are plain atomics; futex_wait/futex_wake are only issued
+ * when a side has to sleep (waiter counters tell the other side whether a
+ * wake is needed). Sleeps are bounded by SHM_WAIT_TIMEOUT_MS so shutdown
+ * (running = 0) is noticed even though IPC_RMID does not wake futexes.
+ *
+ * With BOARDING_BATCH=1 a departure is one chair table record plus a
+ * chair_ref store per rider mailbox; riders sleep on the shared
+ * board_epoch word, so the lower worker issues one FUTEX_WAKE per chair.
+ * At most PLATFORM_GATES tourists wait for boarding at a time, which keeps
+ * the shared wake-up cheap.
+ */
+
+#include "ipc/transport.h"
+#include "ipc/queue_stats.h"
+#include "ipc/futex.h"
+#include "core/fiber.h"
+#include "ipc/control.h"
+#include "core/logger.h"
+#include "core/time_sim.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/msg.h>
+#include <time.h>
+
+_Static_assert(sizeof(PlatformMsg) <= SHM_RING_PAYLOAD, "PlatformMsg must fit a ring slot");
+_Static_assert(sizeof(ArrivalMsg) <= SHM_RING_PAYLOAD, "ArrivalMsg must fit a ring slot");
+_Static_assert((SHM_RING_CAPACITY & (SHM_RING_CAPACITY - 1)) == 0, "SHM_RING_CAPACITY must be a power of two");
+
+/**
+ * @brief Check whether the ring transport is active.
+ */
+static int use_rings(IPCResources *res) {
+    return res->state->cfg.queue_transport == QUEUE_TRANSPORT_SHM && res->state->transport_offset != 0;
+}
+
+/**
+ * @brief Check whether boarding confirmations go through the chair table.
+ */
+static int use_chair_table(IPCResources *res) {
+    return use_rings(res) && res->state->cfg.boarding_batch;
+}
+
+/**
+ * @brief Locate the transport block of res's line in this process's mapping.
+ */
+static ShmTransport *shm_transport(IPCResources *res) {
+    return (ShmTransport *)((char *)res->state + res->state->transport_offset +
+                            (size_t)res->line * res->state->transport_stride);
+}
+
+/**
+ * @brief Bytes of one line's transport block, rounded up to a cache line.
+ */
+static size_t transport_block_size(const Config *cfg) {
+    size_t size = sizeof(ShmTransport) + (size_t)(cfg->total_tourists + 1) * sizeof(ShmMailbox);
+    return (size + 63) & ~(size_t)63;
+}
+
+/**
+ * @brief Cache-line aligned offset of the transport block.
+ */
+static size_t transport_offset_for(size_t base_size) {
+    return (base_size + 63) & ~(size_t)63;
+}
+
+/**
+ * @brief Extra shm bytes needed by the ring transport (0 for SysV).
+ *
+ * One block per line (LINE_COUNT).
+ *
+ * @param cfg Configuration (QUEUE_TRANSPORT, TOTAL_TOURISTS, LINE_COUNT).
+ * @param base_size Size of SharedState plus tourist table.
+ * @return Bytes to add to the segment.
+ */
+size_t transport_shm_size(const Config *cfg, size_t base_size) {
+    if (cfg->queue_transport != QUEUE_TRANSPORT_SHM) {
+        return 0;
+    }
+    return (transport_offset_for(base_size) - base_size) +
+           (size_t)cfg->line_count * transport_block_size(cfg);
+}
+
+/**
+ * @brief Prime ring slot sequence numbers (slot i expects ticket i).
+ */
+static void ring_init(ShmRing *ring) {
+    for (uint64_t i = 0; i < SHM_RING_CAPACITY; i++) {
+        ring->slots[i].seq = i;
+    }
+}
+
+/**
+ * @brief Initialize the ring transport block of every line.
+ *
+ * @param res IPC resources with freshly zeroed shared state.
+ * @param cfg Configuration.
+ * @param base_size Size of SharedState plus tourist table.
+ */
+void transport_init(IPCResources *res, const Config *cfg, size_t base_size) {
+    if (cfg->queue_transport != QUEUE_TRANSPORT_SHM) {
+        res->state->transport_offset = 0;
+        return;
+    }
+
+    res->state->transport_offset = transport_offset_for(base_size);
+    res->state->transport_stride = transport_block_size(cfg);
+    IPCResources line_res = *res;
+    for (int line = 0; line < cfg->line_count; line++) {
+        line_res.line = line;
+        ShmTransport *t = shm_transport(&line_res);
+        ring_init(&t->platform_priority);
+        ring_init(&t->platform);
+        ring_init(&t->arrivals);
+        t->mailbox_count = cfg->total_tourists + 1;
+    }
+
+    log_debug("IPC", "Initialized shm ring transport: offset=%zu, lines=%d, ring_slots=%d, mailboxes=%d, chair_table=%s",
+              res->state->transport_offset, cfg->line_count, SHM_RING_CAPACITY,
+              cfg->total_tourists + 1, cfg->boarding_batch ? "on" : "off");
+}
+
+/**
+ * @brief Sleep for one slice on a futex word, honouring shutdown.
+ *
+ * Receivers report an expired slice as EINTR, like a msgrcv interrupted by
+ * the workers' periodic SIGALRM: a signal landing between two futex calls
+ * would otherwise only be noticed once a message arrives.
+ *
+ * @param res IPC resources.
+ * @param word Futex word.
+ * @param observed Value last seen.
+ * @param timeout_is_eintr 1 for receivers, 0 for senders (keep waiting for space).
+ * @return 0 to retry, -1 with errno EINTR (signal/slice) or EIDRM (shutdown).
+ */
+static int shm_sleep(IPCResources *res, uint32_t *word, uint32_t observed, int timeout_is_eintr) {
+    time_wait_begin();
+    int rc = futex_wait(word, observed, SHM_WAIT_TIMEOUT_MS);
+    time_wait_end();
+    if (rc == -1) {
+        if (errno == EINTR) {
+            return -1;
+        }
+        if (errno == ETIMEDOUT && timeout_is_eintr && control_running(res->state)) {
+            errno = EINTR;
+            return -1;
+        }
+    }
+    if (!control_running(res->state)) {
+        errno = EIDRM;
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Wake sleepers on a futex word if anyone registered as waiting.
+ */
+static void shm_notify(uint32_t *word, uint32_t *waiters) {
+    __atomic_add_fetch(word, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(word, INT32_MAX);
+    }
+}
+
+/**
+ * @brief Try to push one message (lock-free, multi-producer).
+ *
+ * @return 1 if pushed, 0 if the ring is full.
+ */
+static int ring_try_push(ShmRing *ring, const void *in, size_t size) {
+    uint64_t pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    ShmRingSlot *slot;
+
+    while (1) {
+        slot = &ring->slots[pos & (SHM_RING_CAPACITY - 1)];
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;  // Slot still holds an unconsumed message: full
+        } else {
+            pos = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(slot->payload, in, size);
+    __atomic_store_n(&slot->seq, pos + 1, __ATOMIC_RELEASE);
+    shm_notify(&ring->items, &ring->item_waiters);
+    return 1;
+}
+
+/**
+ * @brief Try to pop one message.
+ *
+ * @return 1 if popped, 0 if the ring is empty.
+ */
+static int ring_try_pop(ShmRing *ring, void *out, size_t size) {
+    uint64_t pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    ShmRingSlot *slot;
+
+    while (1) {
+        slot = &ring->slots[pos & (SHM_RING_CAPACITY - 1)];
+        uint64_t seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        int64_t diff = (int64_t)(seq - (pos + 1));
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->head, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return 0;  // Not yet published: empty
+        } else {
+            pos = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+        }
+    }
+
+    memcpy(out, slot->payload, size);
+    __atomic_store_n(&slot->seq, pos + SHM_RING_CAPACITY, __ATOMIC_RELEASE);
+    shm_notify(&ring->space, &ring->space_waiters);
+    return 1;
+}
+
+/**
+ * @brief Push, sleeping while the ring is full (unless IPC_NOWAIT).
+ *
+ * A push that finds the ring full and waits is counted once as a blocked
+ * send of kind (with IPC_NOWAIT the caller counts its own wait).
+ *
+ * @return 0 on success, -1 with errno EAGAIN, EINTR or EIDRM.
+ */
+static int ring_push(IPCResources *res, ShmRing *ring, QueueKind kind, const void *in, size_t size,
+                     int flags) {
+    if (ring_try_push(ring, in, size)) {
+        return 0;
+    }
+    if (flags & IPC_NOWAIT) {
+        errno = EAGAIN;
+        return -1;
+    }
+    queue_note_blocked(res->state, kind);
+    do {
+        __atomic_add_fetch(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t observed = __atomic_load_n(&ring->space, __ATOMIC_SEQ_CST);
+        int pushed = ring_try_push(ring, in, size);
+        int rc = pushed ? 0 : shm_sleep(res, &ring->space, observed, 0);
+        __atomic_sub_fetch(&ring->space_waiters, 1, __ATOMIC_SEQ_CST);
+        if (pushed) {
+            return 0;
+        }
+        if (rc == -1) {
+            return -1;
+        }
+    } while (!ring_try_push(ring, in, size));
+    return 0;
+}
+
+/**
+ * @brief Pop, sleeping while the ring is empty.
+ *
+ * @return 0 on success, -1 with errno EINTR or EIDRM.
+ */
+static int ring_pop(IPCResources *res, ShmRing *ring, void *out, size_t size) {
+    while (!ring_try_pop(ring, out, size)) {
+        if (!control_running(res->state)) {
+            errno = EIDRM;
+            return -1;
+        }
+        __atomic_add_fetch(&ring->item_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t observed = __atomic_load_n(&ring->items, __ATOMIC_SEQ_CST);
+        int popped = ring_try_pop(ring, out, size);
+        int rc = popped ? 0 : shm_sleep(res, &ring->items, observed, 1);
+        __atomic_sub_fetch(&ring->item_waiters, 1, __ATOMIC_SEQ_CST);
+        if (popped) {
+            return 0;
+        }
+        if (rc == -1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Wake every process sleeping in the ring transport of any line (shutdown).
+ *
+ * @param res IPC resources.
+ */
+void transport_wake_all(IPCResources *res) {
+    if (!use_rings(res)) {
+        return;
+    }
+    IPCResources line_res = *res;
+    for (int line = 0; line < res->state->cfg.line_count; line++) {
+        line_res.line = line;
+        ShmTransport *t = shm_transport(&line_res);
+        ShmRing *rings[] = {&t->platform_priority, &t->platform, &t->arrivals};
+        for (int i = 0; i < 3; i++) {
+            shm_notify(&rings[i]->items, &rings[i]->item_waiters);
+            shm_notify(&rings[i]->space, &rings[i]->space_waiters);
+        }
+        shm_notify(&t->board_epoch, &t->board_waiters);
+        for (int i = 0; i < t->mailbox_count; i++) {
+            if (__atomic_load_n(&t->mailboxes[i].waiters, __ATOMIC_SEQ_CST) > 0) {
+                futex_wake(&t->mailboxes[i].full, INT32_MAX);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Send a tourist's "ready to board" message to the lower worker.
+ *
+ * @param res IPC resources.
+ * @param msg Message (mtype 1 = priority/requeue, 2 = regular).
+ * @param flags 0 or IPC_NOWAIT.
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_platform_send(IPCResources *res, const PlatformMsg *msg, int flags) {
+    if (!use_rings(res)) {
+        return queue_msgsnd(res->state, QUEUE_PLATFORM, res->mq_platform_id, msg,
+                            sizeof(*msg) - sizeof(long), flags);
+    }
+    ShmTransport *t = shm_transport(res);
+    ShmRing *ring = (msg->mtype == 1) ? &t->platform_priority : &t->platform;
+    return ring_push(res, ring, QUEUE_PLATFORM, msg, sizeof(*msg), flags);
+}
+
+/**
+ * @brief Receive the next platform message, priority (mtype 1) first.
+ *
+ * Same order as msgrcv(..., -2, ...). Only the lower worker itself pushes
+ * priority messages (requeues), so sleeping on the regular ring is enough.
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @return 0 on success, -1 on error (errno as msgrcv).
+ */
+int transport_platform_recv(IPCResources *res, PlatformMsg *msg) {
+    if (!use_rings(res)) {
+        time_wait_begin();
+        ssize_t ret = msgrcv(res->mq_platform_id, msg, sizeof(*msg) - sizeof(long), -2, 0);
+        time_wait_end();
+        return ret == -1 ? -1 : 0;
+    }
+    ShmTransport *t = shm_transport(res);
+    if (ring_try_pop(&t->platform_priority, msg, sizeof(*msg))) {
+        return 0;
+    }
+    return ring_pop(res, &t->platform, msg, sizeof(*msg));
+}
+
+/**
+ * @brief Take the next platform message if one is waiting, priority first.
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @return 0 on success, -1 with errno ENOMSG if none is waiting (or as msgrcv).
+ */
+int transport_platform_try_recv(IPCResources *res, PlatformMsg *msg) {
+    if (!use_rings(res)) {
+        return msgrcv(res->mq_platform_id, msg, sizeof(*msg) - sizeof(long), -2,
+                      IPC_NOWAIT) == -1 ? -1 : 0;
+    }
+    ShmTransport *t = shm_transport(res);
+    if (ring_try_pop(&t->platform_priority, msg, sizeof(*msg)) ||
+        ring_try_pop(&t->platform, msg, sizeof(*msg))) {
+        return 0;
+    }
+    errno = ENOMSG;
+    return -1;
+}
+
+/**
+ * @brief Milliseconds left until a CLOCK_MONOTONIC deadline (never negative).
+ */
+static int ms_until(const struct timespec *deadline) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long ms = (long long)(deadline->tv_sec - now.tv_sec) * 1000 +
+                   (deadline->tv_nsec - now.tv_nsec) / 1000000;
+    return ms > 0 ? (int)ms : 0;
+}
+
+/**
+ * @brief Receive the next platform message, waiting at most timeout_ms.
+ *
+ * Ring mode sleeps on the regular ring's futex until a message arrives or
+ * the timeout expires; expired SHM_WAIT_TIMEOUT_MS slices are not reported
+ * to the caller. SysV mode blocks in msgrcv and ignores timeout_ms: the
+ * caller bounds it with its own one-shot timer (SIGALRM, reported as EINTR).
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @param timeout_ms Maximum wait in milliseconds (< 0 waits until a message or signal).
+ * @return 0 on success, -1 with errno ETIMEDOUT, EINTR or EIDRM.
+ */
+int transport_platform_recv_timeout(IPCResources *res, PlatformMsg *msg, int timeout_ms) {
+    if (!use_rings(res)) {
+        return transport_platform_recv(res, msg);
+    }
+    ShmTransport *t = shm_transport(res);
+    ShmRing *ring = &t->platform;
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_MONOTONIC, &deadline);
+    if (timeout_ms >= 0) {
+        deadline.tv_sec += timeout_ms / 1000;
+        deadline.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+        if (deadline.tv_nsec >= 1000000000L) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000L;
+        }
+    }
+
+    for (;;) {
+        if (ring_try_pop(&t->platform_priority, msg, sizeof(*msg)) ||
+            ring_try_pop(ring, msg, sizeof(*msg))) {
+            return 0;
+        }
+        if (!control_running(res->state)) {
+            errno = EIDRM;
+            return -1;
+        }
+        int slice = SHM_WAIT_TIMEOUT_MS;
+        if (timeout_ms >= 0) {
+            int left = ms_until(&deadline);
+            if (left == 0) {
+                errno = ETIMEDOUT;
+                return -1;
+            }
+            if (left < slice) slice = left;
+        }
+
+        __atomic_add_fetch(&ring->item_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t observed = __atomic_load_n(&ring->items, __ATOMIC_SEQ_CST);
+        int popped = ring_try_pop(ring, msg, sizeof(*msg));
+        time_wait_begin();
+        int rc = popped ? 0 : futex_wait(&ring->items, observed, slice);
+        int saved = errno;
+        time_wait_end();
+        __atomic_sub_fetch(&ring->item_waiters, 1, __ATOMIC_SEQ_CST);
+        if (popped) {
+            return 0;
+        }
+        if (rc == -1 && saved == EINTR) {
+            errno = EINTR;
+            return -1;
+        }
+    }
+}
+
+/**
+ * @brief Locate a tourist's mailbox.
+ *
+ * @return Mailbox, or NULL (errno EINVAL) if the ID is out of range.
+ */
+static ShmMailbox *shm_mailbox(IPCResources *res, long tourist_id) {
+    ShmTransport *t = shm_transport(res);
+    if (tourist_id <= 0 || tourist_id >= t->mailbox_count) {
+        errno = EINVAL;
+        return NULL;
+    }
+    return &t->mailboxes[tourist_id];
+}
+
+/**
+ * @brief Send a boarding confirmation to the tourist msg->mtype.
+ *
+ * @param res IPC resources.
+ * @param msg Confirmation (mtype = tourist ID).
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_boarding_send(IPCResources *res, const PlatformMsg *msg) {
+    if (!use_rings(res)) {
+        return queue_msgsnd(res->state, QUEUE_BOARDING, res->mq_boarding_id, msg,
+                            sizeof(*msg) - sizeof(long), 0);
+    }
+    ShmMailbox *mb = shm_mailbox(res, msg->mtype);
+    if (!mb) {
+        return -1;
+    }
+
+    // A tourist has at most one confirmation outstanding; wait if unread
+    if (__atomic_load_n(&mb->full, __ATOMIC_ACQUIRE)) {
+        queue_note_blocked(res->state, QUEUE_BOARDING);
+    }
+    while (__atomic_load_n(&mb->full, __ATOMIC_ACQUIRE)) {
+        __atomic_add_fetch(&mb->waiters, 1, __ATOMIC_SEQ_CST);
+        int rc = shm_sleep(res, &mb->full, 1, 0);
+        __atomic_sub_fetch(&mb->waiters, 1, __ATOMIC_SEQ_CST);
+        if (rc == -1) {
+            return -1;
+        }
+    }
+
+    mb->msg = *msg;
+    __atomic_store_n(&mb->full, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&mb->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&mb->full, INT32_MAX);
+    }
+    return 0;
+}
+
+/**
+ * @brief Confirm boarding for every tourist on a departing chair.
+ *
+ * Chair table slots are reused only after every rider has copied the
+ * record (pending == 0). A tourist has at most one confirmation
+ * outstanding, so its chair_ref is always free here.
+ *
+ * @param res IPC resources.
+ * @param chair Departing chair.
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_chair_dispatch(IPCResources *res, const ChairDispatch *chair) {
+    if (!use_chair_table(res)) {
+        for (int i = 0; i < chair->count; i++) {
+            PlatformMsg response;
+            memset(&response, 0, sizeof(response));
+            response.mtype = chair->members[i];
+            response.tourist_id = chair->members[i];
+            response.departure_ns = chair->departure_ns;
+            response.chair_id = chair->chair_id;
+            response.tourists_on_chair = chair->count;
+            response.dispatch_seq = chair->dispatch_seq;
+            if (transport_boarding_send(res, &response) == -1) {
+                return -1;
+            }
+        }
+        return 0;
+    }
+
+    ShmTransport *t = shm_transport(res);
+    ShmMailbox *boxes[CHAIR_CAPACITY];
+    for (int i = 0; i < chair->count; i++) {
+        boxes[i] = shm_mailbox(res, chair->members[i]);
+        if (!boxes[i]) {
+            return -1;
+        }
+    }
+
+    // Claim a slot whose previous riders have all read it (CAS, several
+    // boarding workers may dispatch at once); with at most
+    // MAX_CHAIRS_IN_TRANSIT chairs outstanding one is always free.
+    ShmChairSlot *slot = NULL;
+    int idx = 0;
+    uint32_t cursor = __atomic_load_n(&t->chair_cursor, __ATOMIC_RELAXED);
+    for (int n = 0; n < TOTAL_CHAIRS; n++) {
+        idx = (int)((cursor + (uint32_t)n) % TOTAL_CHAIRS);
+        uint32_t free_slot = 0;
+        if (__atomic_compare_exchange_n(&t->chairs[idx].pending, &free_slot,
+                                        (uint32_t)chair->count, 0,
+                                        __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+            slot = &t->chairs[idx];
+            break;
+        }
+    }
+    if (!slot) {
+        errno = EAGAIN;
+        return -1;
+    }
+    __atomic_store_n(&t->chair_cursor, (uint32_t)(idx + 1) % TOTAL_CHAIRS, __ATOMIC_RELAXED);
+
+    // Riders only look at the slot once their chair_ref points at it
+    slot->chair = *chair;
+    for (int i = 0; i < chair->count; i++) {
+        __atomic_store_n(&boxes[i]->chair_ref, (uint32_t)idx + 1, __ATOMIC_RELEASE);
+    }
+
+    // One wake for the whole chair
+    shm_notify(&t->board_epoch, &t->board_waiters);
+    return 0;
+}
+
+/**
+ * @brief Take this tourist's confirmation from the chair table.
+ *
+ * @return 1 if a record was waiting, 0 if not.
+ */
+static int chair_table_take(ShmTransport *t, ShmMailbox *mb, int tourist_id, PlatformMsg *msg) {
+    uint32_t ref = __atomic_load_n(&mb->chair_ref, __ATOMIC_ACQUIRE);
+    if (ref == 0) {
+        return 0;
+    }
+    ShmChairSlot *slot = &t->chairs[ref - 1];
+
+    memset(msg, 0, sizeof(*msg));
+    msg->mtype = tourist_id;
+    msg->tourist_id = tourist_id;
+    msg->departure_ns = slot->chair.departure_ns;
+    msg->chair_id = slot->chair.chair_id;
+    msg->tourists_on_chair = slot->chair.count;
+    msg->dispatch_seq = slot->chair.dispatch_seq;
+
+    __atomic_store_n(&mb->chair_ref, 0, __ATOMIC_RELAXED);
+    __atomic_sub_fetch(&slot->pending, 1, __ATOMIC_RELEASE);
+    return 1;
+}
+
+/**
+ * @brief Wait for this tourist's chair in the chair table.
+ */
+static int chair_table_recv(IPCResources *res, ShmMailbox *mb, int tourist_id,
+                            PlatformMsg *msg, int flags) {
+    ShmTransport *t = shm_transport(res);
+    while (!chair_table_take(t, mb, tourist_id, msg)) {
+        if (flags & IPC_NOWAIT) {
+            errno = ENOMSG;
+            return -1;
+        }
+        if (!control_running(res->state)) {
+            errno = EIDRM;
+            return -1;
+        }
+        uint32_t epoch = __atomic_load_n(&t->board_epoch, __ATOMIC_SEQ_CST);
+        __atomic_add_fetch(&t->board_waiters, 1, __ATOMIC_SEQ_CST);
+        int rc = __atomic_load_n(&mb->chair_ref, __ATOMIC_SEQ_CST)
+                     ? 0 : shm_sleep(res, &t->board_epoch, epoch, 1);
+        __atomic_sub_fetch(&t->board_waiters, 1, __ATOMIC_SEQ_CST);
+        if (rc == -1) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Receive this tourist's boarding confirmation.
+ *
+ * @param res IPC resources.
+ * @param tourist_id Tourist ID (mailbox / mtype).
+ * @param msg Output message.
+ * @param flags 0 or IPC_NOWAIT.
+ * @return 0 on success, -1 on error (errno as msgrcv).
+ */
+int transport_boarding_recv(IPCResources *res, int tourist_id, PlatformMsg *msg, int flags) {
+    if (!use_rings(res)) {
+        time_wait_begin();
+        ssize_t ret = fiber_msgrcv(res->mq_boarding_id, msg, sizeof(*msg) - sizeof(long),
+                                   tourist_id, flags);
+        time_wait_end();
+        return ret == -1 ? -1 : 0;
+    }
+    ShmMailbox *mb = shm_mailbox(res, tourist_id);
+    if (!mb) {
+        return -1;
+    }
+    if (use_chair_table(res)) {
+        return chair_table_recv(res, mb, tourist_id, msg, flags);
+    }
+
+    while (!__atomic_load_n(&mb->full, __ATOMIC_ACQUIRE)) {
+        if (flags & IPC_NOWAIT) {
+            errno = ENOMSG;
+            return -1;
+        }
+        if (!control_running(res->state)) {
+            errno = EIDRM;
+            return -1;
+        }
+        __atomic_add_fetch(&mb->waiters, 1, __ATOMIC_SEQ_CST);
+        int rc = __atomic_load_n(&mb->full, __ATOMIC_SEQ_CST) ? 0 : shm_sleep(res, &mb->full, 0, 1);
+        __atomic_sub_fetch(&mb->waiters, 1, __ATOMIC_SEQ_CST);
+        if (rc == -1) {
+            return -1;
+        }
+    }
+
+    *msg = mb->msg;
+    __atomic_store_n(&mb->full, 0, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&mb->waiters, __ATOMIC_SEQ_CST) > 0) {
+        futex_wake(&mb->full, INT32_MAX);
+    }
+    return 0;
+}
+
+/**
+ * @brief Notify the upper worker of an arrival.
+ *
+ * @param res IPC resources.
+ * @param msg Arrival message.
+ * @param flags 0 or IPC_NOWAIT.
+ * @return 0 on success, -1 on error (errno as msgsnd).
+ */
+int transport_arrival_send(IPCResources *res, const ArrivalMsg *msg, int flags) {
+    if (!use_rings(res)) {
+        return queue_msgsnd(res->state, QUEUE_ARRIVALS, res->mq_arrivals_id, msg,
+                            sizeof(*msg) - sizeof(long), flags);
+    }
+    return ring_push(res, &shm_transport(res)->arrivals, QUEUE_ARRIVALS, msg, sizeof(*msg), flags);
+}
+
+/**
+ * @brief Receive the next arrival notification.
+ *
+ * @param res IPC resources.
+ * @param msg Output message.
+ * @return 0 on success, -1 on error (errno as msgrcv).
+ */
+int transport_arrival_recv(IPCResources *res, ArrivalMsg *msg) {
+    if (!use_rings(res)) {
+        time_wait_begin();
+        ssize_t ret = msgrcv(res->mq_arrivals_id, msg, sizeof(*msg) - sizeof(long), 0, 0);
+        time_wait_end();
+        return ret == -1 ? -1 : 0;
+    }
+    return ring_pop(res, &shm_transport(res)->arrivals, msg, sizeof(*msg));
+}
+
+/**
+ * @brief Fill level of one ring (consumer cursor may briefly lag).
+ */
+static int ring_depth(const ShmRing *ring) {
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    return tail > head ? (int)(tail - head) : 0;
+}
+
+/**
+ * @brief Messages currently waiting in a channel (metrics, approximate).
+ *
+ * @param res IPC resources.
+ * @param channel Channel to measure.
+ * @return Messages waiting, or -1 if the queue is gone (shutdown).
+ */
+int transport_depth(IPCResources *res, TransportChannel channel) {
+    if (!use_rings(res)) {
+        int qid = (channel == TRANSPORT_PLATFORM) ? res->mq_platform_id :
+                  (channel == TRANSPORT_BOARDING) ? res->mq_boarding_id : res->mq_arrivals_id;
+        struct msqid_ds ds;
+        if (qid == -1 || msgctl(qid, IPC_STAT, &ds) == -1) {
+            return -1;
+        }
+        return (int)ds.msg_qnum;
+    }
+
+    ShmTransport *t = shm_transport(res);
+    int depth = 0;
+    switch (channel) {
+        case TRANSPORT_PLATFORM:
+            return ring_depth(&t->platform_priority) + ring_depth(&t->platform);
+        case TRANSPORT_ARRIVALS:
+            return ring_depth(&t->arrivals);
+        case TRANSPORT_BOARDING:
+            if (use_chair_table(res)) {
+                // Riders that have not read their chair's record yet
+                for (int i = 0; i < TOTAL_CHAIRS; i++) {
+                    depth += (int)__atomic_load_n(&t->chairs[i].pending, __ATOMIC_RELAXED);
+                }
+            } else {
+                for (int i = 0; i < t->mailbox_count; i++) {
+                    depth += (__atomic_load_n(&t->mailboxes[i].full, __ATOMIC_RELAXED) != 0);
+                }
+            }
+            return depth;
+    }
+    return -1;
+}
+
+/**
+ * @brief Fill level and limit of one channel, for queue_stats_sample().
+ *
+ * System V channels are IPC_STAT'ed. A ring is full when either of its
+ * rings has no free slot; mailboxes never are (a confirmation waits only
+ * for its own tourist).
+ *
+ * @param res IPC resources.
+ * @param channel Channel to measure.
+ * @param out Sample to fill.
+ * @return 0 on success, -1 if the queue is gone (shutdown).
+ */
+int transport_stat(IPCResources *res, TransportChannel channel, QueueSample *out) {
+    if (!use_rings(res)) {
+        return channel == TRANSPORT_PLATFORM
+            ? queue_sample_msq(res->mq_platform_id, sizeof(PlatformMsg) - sizeof(long), out)
+            : channel == TRANSPORT_BOARDING
+            ? queue_sample_msq(res->mq_boarding_id, sizeof(PlatformMsg) - sizeof(long), out)
+            : queue_sample_msq(res->mq_arrivals_id, sizeof(ArrivalMsg) - sizeof(long), out);
+    }
+
+    ShmTransport *t = shm_transport(res);
+    memset(out, 0, sizeof(*out));
+    out->messages = (uint32_t)transport_depth(res, channel);
+    if (channel == TRANSPORT_PLATFORM) {
+        out->limit_messages = SHM_RING_CAPACITY;
+        out->full = ring_depth(&t->platform_priority) >= SHM_RING_CAPACITY ||
+                    ring_depth(&t->platform) >= SHM_RING_CAPACITY;
+    } else if (channel == TRANSPORT_ARRIVALS) {
+        out->limit_messages = SHM_RING_CAPACITY;
+        out->full = ring_depth(&t->arrivals) >= SHM_RING_CAPACITY;
+    }
+    return 0;
+}
@@ -0,0 +1,364 @@
+/**
+ * @file lifecycle/checkpoint.c
+ * @brief Checkpoint files of a running simulation and restore (--restore).
+ */
+
+#include "lifecycle/checkpoint.h"
+#include "core/config.h"
+#include "core/logger.h"
+#include "core/time_sim.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/msg.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(CheckpointHeader) % 64 == 0, "Tourist entries must follow the header aligned");
+
+/**
+ * @brief Bytes of a checkpoint image, rounded up for aligned_alloc().
+ */
+static size_t checkpoint_size(uint32_t entry_count, uint32_t schedule_count) {
+    return sizeof(CheckpointHeader) + (size_t)entry_count * sizeof(TouristEntry) +
+           (size_t)schedule_count * sizeof(TouristDescriptor);
+}
+
+static size_t checkpoint_alloc_size(size_t size) {
+    return (size + 63) & ~(size_t)63;
+}
+
+/**
+ * @brief Add one queue's message and byte count (IPC_STAT; removed queues count 0).
+ */
+static void queue_depth(int mq_id, CheckpointHeader *h) {
+    struct msqid_ds ds;
+    if (mq_id == -1 || msgctl(mq_id, IPC_STAT, &ds) == -1) {
+        return;
+    }
+    h->queued_messages += (uint32_t)ds.msg_qnum;
+    h->queued_bytes += (uint64_t)ds.__msg_cbytes;
+}
+
+/**
+ * @brief Sum every statistics shard into one.
+ */
+static void merge_stats(const SharedState *state, StatsShard *out) {
+    memset(out, 0, sizeof(*out));
+    for (int s = 0; s < STATS_SHARD_COUNT; s++) {
+        const StatsShard *shard = &state->stats_shards[s];
+        out->total_tourists += __atomic_load_n(&shard->total_tourists, __ATOMIC_RELAXED);
+        out->total_rides += __atomic_load_n(&shard->total_rides, __ATOMIC_RELAXED);
+        for (int t = 0; t < TICKET_COUNT; t++) {
+            out->rides_by_ticket[t] += __atomic_load_n(&shard->rides_by_ticket[t], __ATOMIC_RELAXED);
+            out->tourists_by_ticket[t] += __atomic_load_n(&shard->tourists_by_ticket[t], __ATOMIC_RELAXED);
+        }
+    }
+}
+
+/**
+ * @brief Copy everything a restored run needs into one image.
+ *
+ * @return Image (aligned_alloc), or NULL if out of memory.
+ */
+static CheckpointHeader *checkpoint_copy(const IPCResources *res, size_t *size_out) {
+    SharedState *state = res->state;
+    ArrivalSchedule *schedule = arrival_schedule_get(state);
+
+    int entry_count = __atomic_load_n(&state->tourist_entry_count, __ATOMIC_RELAXED);
+    if (entry_count > state->max_tracked_tourists) {
+        entry_count = state->max_tracked_tourists;
+    }
+    uint32_t schedule_count = 0;
+    if (schedule != NULL && __atomic_load_n(&schedule->ready, __ATOMIC_ACQUIRE)) {
+        schedule_count = schedule->count;
+    }
+
+    size_t size = checkpoint_size((uint32_t)entry_count, schedule_count);
+    CheckpointHeader *h = aligned_alloc(64, checkpoint_alloc_size(size));
+    if (h == NULL) {
+        return NULL;
+    }
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, CHECKPOINT_MAGIC, sizeof(h->magic));
+    h->version = CHECKPOINT_VERSION;
+    h->header_size = sizeof(CheckpointHeader);
+    h->entry_count = (uint32_t)entry_count;
+    h->schedule_count = schedule_count;
+
+    // Clock and generator first: later counters can only be ahead of them
+    h->elapsed_ns = time_elapsed_ns(state);
+    h->sim_ms = time_get_sim_ms(state);
+    h->tourists_spawned = __atomic_load_n(&state->tourists_spawned, __ATOMIC_ACQUIRE);
+    h->cfg = state->cfg;
+
+    merge_stats(state, &h->stats);
+    for (int l = 0; l < state->cfg.line_count; l++) {
+        const LineState *line = &state->lines[l];
+        CheckpointLine *out = &h->lines[l];
+        out->chair_dispatch_seq = __atomic_load_n(&line->chair_dispatch_seq, __ATOMIC_RELAXED);
+        out->chairs_departed = __atomic_load_n(&line->chairs_departed, __ATOMIC_RELAXED);
+        out->chair_slots_departed = __atomic_load_n(&line->chair_slots_departed, __ATOMIC_RELAXED);
+        out->ring_departures = __atomic_load_n(&line->ring_departures, __ATOMIC_RELAXED);
+        out->ring_empty = __atomic_load_n(&line->ring_empty, __ATOMIC_RELAXED);
+    }
+    memcpy(h->latency, state->latency, sizeof(h->latency));
+    memcpy(&h->tourist_exits, &state->tourist_exits, sizeof(h->tourist_exits));
+
+    char *p = (char *)(h + 1);
+    memcpy(p, state->tourist_entries, (size_t)entry_count * sizeof(TouristEntry));
+    p += (size_t)entry_count * sizeof(TouristEntry);
+    if (schedule_count > 0) {
+        memcpy(p, schedule->tourists, (size_t)schedule_count * sizeof(TouristDescriptor));
+    }
+
+    for (int c = 0; c < res->cashier_count; c++) {
+        queue_depth(res->mq_cashier_ids[c], h);
+    }
+    queue_depth(res->mq_spawn_id, h);
+    for (int l = 0; l < res->line_count; l++) {
+        const LineIds *line = &res->lines[l];
+        queue_depth(line->mq_platform_id, h);
+        queue_depth(line->mq_boarding_id, h);
+        queue_depth(line->mq_arrivals_id, h);
+        queue_depth(line->mq_worker_id, h);
+    }
+
+    *size_out = size;
+    return h;
+}
+
+/**
+ * @brief Write the image to path + CHECKPOINT_TMP_SUFFIX, fsync it and rename it over path.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int checkpoint_write_file(const CheckpointHeader *h, size_t size, const char *path) {
+    char tmp_path[512];
+    snprintf(tmp_path, sizeof(tmp_path), "%s" CHECKPOINT_TMP_SUFFIX, path);
+
+    int fd = open(tmp_path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        perror("checkpoint: open");
+        return -1;
+    }
+
+    const char *p = (const char *)h;
+    size_t left = size;
+    while (left > 0) {
+        ssize_t n = write(fd, p, left);
+        if (n == -1 && errno == EINTR) {
+            continue;  // Main's SIGINT/SIGTERM handler returns at once in a child
+        }
+        if (n <= 0) {
+            perror("checkpoint: write");
+            close(fd);
+            unlink(tmp_path);
+            return -1;
+        }
+        p += n;
+        left -= (size_t)n;
+    }
+
+    if (fsync(fd) == -1) {
+        perror("checkpoint: fsync");
+        close(fd);
+        unlink(tmp_path);
+        return -1;
+    }
+    if (close(fd) == -1) {
+        perror("checkpoint: close");
+        unlink(tmp_path);
+        return -1;
+    }
+    if (rename(tmp_path, path) == -1) {
+        perror("checkpoint: rename");
+        unlink(tmp_path);
+        return -1;
+    }
+    return 0;
+}
+
+pid_t checkpoint_take(const IPCResources *res, const char *path) {
+    SharedState *state = res->state;
+    CheckpointStats *cs = &state->checkpoint;
+
+    uint32_t idle = 0;
+    if (!__atomic_compare_exchange_n(&cs->writer_busy, &idle, 1, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+        cs->skipped++;
+        return 0;
+    }
+
+    int64_t start_ns = time_monotonic_ns();
+    size_t size = 0;
+    CheckpointHeader *h = checkpoint_copy(res, &size);
+    int64_t copy_ns = time_monotonic_ns() - start_ns;
+    if (h == NULL) {
+        perror("checkpoint: aligned_alloc");
+        __atomic_add_fetch(&cs->failed, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&cs->writer_busy, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
+    cs->taken++;
+    cs->copy_ns_sum += copy_ns;
+    if (copy_ns > cs->copy_ns_max) {
+        cs->copy_ns_max = copy_ns;
+    }
+
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("checkpoint: fork");
+        free(h);
+        __atomic_add_fetch(&cs->failed, 1, __ATOMIC_RELAXED);
+        __atomic_store_n(&cs->writer_busy, 0, __ATOMIC_RELEASE);
+        return -1;
+    }
+
+    if (pid == 0) {
+        // Writer: the image is this process's private copy-on-write view
+        int64_t write_start_ns = time_monotonic_ns();
+        int rc = checkpoint_write_file(h, size, path);
+        int64_t write_ns = time_monotonic_ns() - write_start_ns;
+        if (rc == 0) {
+            cs->last_sim_ms = h->sim_ms;
+            cs->last_bytes = size;
+            if (write_ns > cs->write_ns_max) {
+                cs->write_ns_max = write_ns;
+            }
+            __atomic_add_fetch(&cs->written, 1, __ATOMIC_RELAXED);
+        } else {
+            __atomic_add_fetch(&cs->failed, 1, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&cs->writer_busy, 0, __ATOMIC_RELEASE);
+        _exit(rc == 0 ? 0 : 1);
+    }
+
+    free(h);
+    return pid;
+}
+
+int checkpoint_load(const char *path, Checkpoint *out) {
+    memset(out, 0, sizeof(*out));
+
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        perror("checkpoint: open");
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1) {
+        perror("checkpoint: fstat");
+        close(fd);
+        return -1;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size < sizeof(CheckpointHeader)) {
+        fprintf(stderr, "checkpoint: %s is not a checkpoint of this build\n", path);
+        close(fd);
+        return -1;
+    }
+
+    CheckpointHeader *h = aligned_alloc(64, checkpoint_alloc_size(size));
+    if (h == NULL) {
+        perror("checkpoint: aligned_alloc");
+        close(fd);
+        return -1;
+    }
+    size_t done = 0;
+    while (done < size) {
+        ssize_t n = read(fd, (char *)h + done, size - done);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            fprintf(stderr, "checkpoint: %s is truncated\n", path);
+            close(fd);
+            free(h);
+            return -1;
+        }
+        done += (size_t)n;
+    }
+    close(fd);
+
+    if (memcmp(h->magic, CHECKPOINT_MAGIC, sizeof(h->magic)) != 0 ||
+        h->version != CHECKPOINT_VERSION || h->header_size != sizeof(CheckpointHeader)) {
+        fprintf(stderr, "checkpoint: %s is not a checkpoint of this build\n", path);
+        free(h);
+        return -1;
+    }
+    if (size != checkpoint_size(h->entry_count, h->schedule_count)) {
+        fprintf(stderr, "checkpoint: %s is truncated\n", path);
+        free(h);
+        return -1;
+    }
+    if (config_validate(&h->cfg) == -1 ||
+        h->entry_count > (uint32_t)h->cfg.total_tourists ||
+        h->schedule_count > (uint32_t)h->cfg.total_tourists ||
+        h->tourists_spawned < 0 || h->tourists_spawned > h->cfg.total_tourists ||
+        h->elapsed_ns < 0) {
+        fprintf(stderr, "checkpoint: %s holds an invalid run state\n", path);
+        free(h);
+        return -1;
+    }
+
+    out->header = h;
+    out->entries = (const TouristEntry *)(h + 1);
+    out->schedule = (const TouristDescriptor *)(out->entries + h->entry_count);
+    out->size = size;
+    return 0;
+}
+
+int checkpoint_restore(const Checkpoint *ckpt, SharedState *state) {
+    const CheckpointHeader *h = ckpt->header;
+    if (h->entry_count > (uint32_t)state->max_tracked_tourists) {
+        fprintf(stderr, "checkpoint: %u tourist entries do not fit the table (%d)\n",
+                h->entry_count, state->max_tracked_tourists);
+        return -1;
+    }
+
+    state->restored = 1;
+    state->resume_tourists = h->tourists_spawned;
+    state->resume_elapsed_ns = h->elapsed_ns;
+    state->resume_sim_ms = h->sim_ms;
+    state->tourists_spawned = h->tourists_spawned;
+
+    // Shard 0 is never claimed, so the totals stay there for the whole run
+    state->stats_shards[0] = h->stats;
+    for (int l = 0; l < state->cfg.line_count; l++) {
+        LineState *line = &state->lines[l];
+        const CheckpointLine *in = &h->lines[l];
+        line->chair_dispatch_seq = in->chair_dispatch_seq;
+        line->chairs_departed = in->chairs_departed;
+        line->chair_slots_departed = in->chair_slots_departed;
+        line->ring_departures = in->ring_departures;
+        line->ring_empty = in->ring_empty;
+    }
+    memcpy(state->latency, h->latency, sizeof(state->latency));
+    memcpy(&state->tourist_exits, &h->tourist_exits, sizeof(state->tourist_exits));
+
+    memcpy(state->tourist_entries, ckpt->entries, (size_t)h->entry_count * sizeof(TouristEntry));
+    state->tourist_entry_count = (int)h->entry_count;
+
+    ArrivalSchedule *schedule = arrival_schedule_get(state);
+    if (schedule != NULL && h->schedule_count > 0) {
+        uint32_t count = h->schedule_count < schedule->capacity ? h->schedule_count : schedule->capacity;
+        memcpy(schedule->tourists, ckpt->schedule, (size_t)count * sizeof(TouristDescriptor));
+        arrival_schedule_publish(schedule, count);
+        state->tourists_to_generate = (int)count;
+    }
+
+    if (h->queued_messages > 0) {
+        log_warn("MAIN", "Checkpoint: %u queued messages (%llu bytes) belonged to tourists in flight, not restored",
+                 h->queued_messages, (unsigned long long)h->queued_bytes);
+    }
+    return 0;
+}
+
+void checkpoint_free(Checkpoint *ckpt) {
+    free(ckpt->header);
+    memset(ckpt, 0, sizeof(*ckpt));
+}
@@ -0,0 +1,276 @@
+/**
+ * @file lifecycle/child_reaper.c
+ * @brief Event-loop reaper for the generator's children (signalfd + epoll).
+ */
+
+#include "lifecycle/child_reaper.h"
+#include "core/latency.h"
+#include "core/logger.h"
+#include "core/time_sim.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/signalfd.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define REAPER_PID_MAX_PATH "/proc/sys/kernel/pid_max"
+#define REAPER_MAX_SLOTS (1 << 22)      // Default 64-bit pid_max; larger PIDs get no lifetime
+#define REAPER_SIGINFO_BATCH 16         // signalfd records read per call
+
+/**
+ * @brief PID table size (pid_max, capped at REAPER_MAX_SLOTS).
+ */
+static size_t reaper_slot_count(void) {
+    FILE *f = fopen(REAPER_PID_MAX_PATH, "r");
+    long pid_max = 0;
+    if (f != NULL) {
+        if (fscanf(f, "%ld", &pid_max) != 1) {
+            pid_max = 0;
+        }
+        fclose(f);
+    }
+    if (pid_max <= 0 || pid_max > REAPER_MAX_SLOTS) {
+        pid_max = REAPER_MAX_SLOTS;
+    }
+    return (size_t)pid_max;
+}
+
+/**
+ * @brief Account one reaped child.
+ *
+ * A child reaped before its parent called child_reaper_track() has no fork
+ * time yet: its slot is set to -1, and the late track call frees it.
+ */
+static void reaper_record(ChildReaper *r, const siginfo_t *info) {
+    TouristExits *exits = &r->state->tourist_exits;
+    pid_t pid = info->si_pid;
+
+    int64_t spawn_ns = 0;
+    int tourist_id = 0;
+    if (r->slots != NULL && (size_t)pid < r->slot_count) {
+        ChildSlot *slot = &r->slots[pid];
+        spawn_ns = __atomic_load_n(&slot->spawn_ns, __ATOMIC_ACQUIRE);
+        while (!__atomic_compare_exchange_n(&slot->spawn_ns, &spawn_ns, spawn_ns > 0 ? 0 : -1, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            // spawn_ns reloaded by the failed CAS
+        }
+        tourist_id = spawn_ns > 0 ? slot->tourist_id : 0;
+    }
+
+    exits->reaped++;
+    __atomic_sub_fetch(&r->active, 1, __ATOMIC_RELAXED);
+
+    double lifetime_ms = -1.0;
+    if (spawn_ns > 0) {
+        int64_t lifetime_ns = time_monotonic_ns() - spawn_ns;
+        if (lifetime_ns < 0) {
+            lifetime_ns = 0;
+        }
+        latency_hist_record(&exits->lifetime, (uint64_t)lifetime_ns / 1000);
+        lifetime_ms = (double)lifetime_ns / 1e6;
+    }
+
+    if (info->si_code == CLD_EXITED && info->si_status == 0) {
+        exits->exit_ok++;
+        log_debug("GENERATOR", "Reaped tourist %d (PID %d): exit 0 after %.1f ms",
+                  tourist_id, (int)pid, lifetime_ms);
+    } else if (info->si_code == CLD_EXITED) {
+        exits->exit_error++;
+        log_debug("GENERATOR", "Reaped tourist %d (PID %d): exit %d after %.1f ms",
+                  tourist_id, (int)pid, info->si_status, lifetime_ms);
+    } else {
+        exits->killed++;
+        log_debug("GENERATOR", "Reaped tourist %d (PID %d): killed by signal %d after %.1f ms",
+                  tourist_id, (int)pid, info->si_status, lifetime_ms);
+    }
+}
+
+/**
+ * @brief Reap every exited child (waitid WNOHANG until none is left exited).
+ *
+ * @return 0 if children remain, -1 once waitid reports none (ECHILD).
+ */
+static int reaper_drain(ChildReaper *r) {
+    TouristExits *exits = &r->state->tourist_exits;
+    uint32_t batch = 0;
+    int rc = 0;
+
+    while (1) {
+        siginfo_t info;
+        memset(&info, 0, sizeof(info));
+        if (waitid(P_ALL, 0, &info, WEXITED | WNOHANG) == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno != ECHILD) {
+                perror("child_reaper: waitid");
+            }
+            rc = -1;
+            break;
+        }
+        if (info.si_pid == 0) {
+            break;  // Children left, none of them exited
+        }
+        reaper_record(r, &info);
+        batch++;
+    }
+
+    if (batch > 0) {
+        exits->wakeups++;
+        if (batch > exits->max_batch) {
+            exits->max_batch = batch;
+        }
+    }
+    return rc;
+}
+
+/**
+ * @brief Reaper thread: one drain per signalfd wakeup until finish() and no children left.
+ */
+static void *reaper_thread_func(void *arg) {
+    ChildReaper *r = arg;
+    int stopping = 0;
+
+    while (1) {
+        struct epoll_event events[2];
+        int n = epoll_wait(r->epoll_fd, events, 2, -1);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;  // SIGTERM/SIGINT handled by the generator's handler
+            }
+            perror("child_reaper: epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.fd == r->stop_fd) {
+                uint64_t value;
+                if (read(r->stop_fd, &value, sizeof(value)) == -1 && errno != EAGAIN) {
+                    perror("child_reaper: read eventfd");
+                }
+                stopping = 1;
+                continue;
+            }
+            // Consume the queued SIGCHLDs first: an exit after this read wakes us again
+            struct signalfd_siginfo infos[REAPER_SIGINFO_BATCH];
+            while (read(r->signal_fd, infos, sizeof(infos)) > 0) {
+            }
+        }
+
+        if (reaper_drain(r) == -1 && stopping) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+int child_reaper_start(ChildReaper *reaper, SharedState *state) {
+    memset(reaper, 0, sizeof(*reaper));
+    reaper->state = state;
+    reaper->signal_fd = -1;
+    reaper->stop_fd = -1;
+    reaper->epoll_fd = -1;
+
+    sigset_t mask;
+    sigemptyset(&mask);
+    sigaddset(&mask, SIGCHLD);
+    pthread_sigmask(SIG_BLOCK, &mask, NULL);
+
+    reaper->signal_fd = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    reaper->stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    reaper->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (reaper->signal_fd == -1 || reaper->stop_fd == -1 || reaper->epoll_fd == -1) {
+        perror("child_reaper: signalfd/eventfd/epoll_create1");
+        goto fail;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.fd = reaper->signal_fd;
+    if (epoll_ctl(reaper->epoll_fd, EPOLL_CTL_ADD, reaper->signal_fd, &ev) == -1) {
+        perror("child_reaper: epoll_ctl signalfd");
+        goto fail;
+    }
+    ev.data.fd = reaper->stop_fd;
+    if (epoll_ctl(reaper->epoll_fd, EPOLL_CTL_ADD, reaper->stop_fd, &ev) == -1) {
+        perror("child_reaper: epoll_ctl eventfd");
+        goto fail;
+    }
+
+    // Untouched pages cost nothing: only the PID range actually used gets memory
+    reaper->slot_count = reaper_slot_count();
+    void *slots = mmap(NULL, reaper->slot_count * sizeof(ChildSlot), PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (slots == MAP_FAILED) {
+        log_warn("GENERATOR", "No PID table (%s), tourist lifetimes are not recorded",
+                 strerror(errno));
+        reaper->slot_count = 0;
+    } else {
+        reaper->slots = slots;
+    }
+
+    if (pthread_create(&reaper->thread, NULL, reaper_thread_func, reaper) != 0) {
+        perror("child_reaper: pthread_create");
+        goto fail;
+    }
+    reaper->running = 1;
+    return 0;
+
+fail:
+    if (reaper->slots != NULL) {
+        munmap(reaper->slots, reaper->slot_count * sizeof(ChildSlot));
+        reaper->slots = NULL;
+    }
+    if (reaper->signal_fd != -1) close(reaper->signal_fd);
+    if (reaper->stop_fd != -1) close(reaper->stop_fd);
+    if (reaper->epoll_fd != -1) close(reaper->epoll_fd);
+    return -1;
+}
+
+void child_reaper_track(ChildReaper *reaper, pid_t pid, int64_t spawn_ns, int tourist_id) {
+    __atomic_add_fetch(&reaper->active, 1, __ATOMIC_RELAXED);
+    if (reaper->slots == NULL || pid <= 0 || (size_t)pid >= reaper->slot_count) {
+        return;
+    }
+
+    ChildSlot *slot = &reaper->slots[pid];
+    slot->tourist_id = tourist_id;
+    int64_t expected = 0;
+    if (!__atomic_compare_exchange_n(&slot->spawn_ns, &expected, spawn_ns > 0 ? spawn_ns : 1, 0,
+                                     __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+        // Already reaped (slot marked -1): free it for the next child with this PID
+        __atomic_store_n(&slot->spawn_ns, 0, __ATOMIC_RELAXED);
+    }
+}
+
+int child_reaper_active(const ChildReaper *reaper) {
+    return __atomic_load_n(&reaper->active, __ATOMIC_RELAXED);
+}
+
+void child_reaper_finish(ChildReaper *reaper) {
+    if (!reaper->running) {
+        return;
+    }
+
+    uint64_t one = 1;
+    if (write(reaper->stop_fd, &one, sizeof(one)) == -1) {
+        perror("child_reaper: write eventfd");
+    }
+    pthread_join(reaper->thread, NULL);
+    reaper->running = 0;
+
+    if (reaper->slots != NULL) {
+        munmap(reaper->slots, reaper->slot_count * sizeof(ChildSlot));
+        reaper->slots = NULL;
+    }
+    close(reaper->signal_fd);
+    close(reaper->stop_fd);
+    close(reaper->epoll_fd);
+}
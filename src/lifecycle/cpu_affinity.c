@@ -0,0 +1,48 @@
+/**
+ * @file lifecycle/cpu_affinity.c
+ * @brief Dedicated cores for the fixed workers (WORKER_CPUS).
+ */
+
+#include "lifecycle/cpu_affinity.h"
+
+#include <string.h>
+
+int cpu_plan_init(CpuPlan *plan, const cpu_set_t *allowed, int worker_cpus) {
+    memset(plan, 0, sizeof(*plan));
+    plan->other_cpus = *allowed;
+
+    for (int cpu = 0; cpu < CPU_SETSIZE && plan->worker_count < worker_cpus; cpu++) {
+        if (CPU_ISSET(cpu, allowed)) {
+            plan->worker_cpus[plan->worker_count++] = cpu;
+            CPU_CLR(cpu, &plan->other_cpus);
+        }
+    }
+
+    // Nothing left over: everyone else shares the worker cores
+    if (plan->worker_count > 0 && CPU_COUNT(&plan->other_cpus) == 0) {
+        plan->other_cpus = *allowed;
+        plan->shared = 1;
+    }
+    return plan->worker_count;
+}
+
+int cpu_plan_next(CpuPlan *plan) {
+    if (plan->worker_count == 0) {
+        return -1;
+    }
+    int cpu = plan->worker_cpus[plan->next % plan->worker_count];
+    plan->next++;
+    return cpu;
+}
+
+int cpu_pin(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set);
+}
+
+int cpu_set_fifo(int priority) {
+    struct sched_param param = {.sched_priority = priority};
+    return sched_setscheduler(0, SCHED_FIFO, &param);
+}
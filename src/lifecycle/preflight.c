@@ -0,0 +1,488 @@
+/**
+ * @file lifecycle/preflight.c
+ * @brief Startup check of the run against kernel IPC limits, rlimits and memory.
+ */
+
+#include "lifecycle/preflight.h"
+#include "ipc/ipc.h"
+#include "ipc/messages.h"
+
+#include <ctype.h>
+#include <dirent.h>
+#include <linux/capability.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+/**
+ * @brief What the host allows (-1 = could not be read, not checked).
+ */
+typedef struct {
+    long semmsl, semmns, semmni;        // kernel.sem (SEMOPM is not needed: at most 2 ops per call)
+    long sem_sets_used, sems_used;
+    long msgmni, msgmnb, msgmax;
+    long queues_used;
+    long long shmmax, shmall, shmmni;   // shmall in pages
+    long segments_used;
+    long long shm_pages_used;
+    long tasks_free;                    // Least of threads-max, pid_max and RLIMIT_NPROC headroom
+    long long mem_available_kb;
+    struct rlimit nofile;
+    int sys_resource;                   // CAP_SYS_RESOURCE: msg_qbytes above msgmnb, no RLIMIT_NPROC
+} HostLimits;
+
+/**
+ * @brief What one run needs.
+ */
+typedef struct {
+    long line_queue_bytes;              // Fullest platform, boarding or arrivals queue (System V)
+    long cashier_queue_bytes;           // Every live tourist of one cashier waiting at once
+    long cashier_waiters;
+    long fixed_tasks;                   // Workers, helpers, generator and main
+    long tasks;                         // Plus tourists (threads count against RLIMIT_NPROC too)
+    long processes;
+    long fds;
+    size_t shm_size;
+    long long memory_kb;
+} RunNeeds;
+
+/**
+ * @brief Read up to n whitespace-separated numbers from a /proc file.
+ *
+ * @return Numbers read (0 if the file is missing).
+ */
+static int read_numbers(const char *path, long long *vals, int n) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return 0;
+    }
+    int count = 0;
+    while (count < n && fscanf(f, "%lld", &vals[count]) == 1) {
+        count++;
+    }
+    fclose(f);
+    return count;
+}
+
+static long long read_number(const char *path) {
+    long long v;
+    return read_numbers(path, &v, 1) == 1 ? v : -1;
+}
+
+/**
+ * @brief Count the rows of a /proc/sysvipc table and sum one column.
+ *
+ * @param path Table (first line is the header).
+ * @param column Zero-based column to sum (-1 = none).
+ * @param sum Output: column total.
+ * @return Rows, or -1 if the table is missing.
+ */
+static long sysvipc_rows(const char *path, int column, long long *sum) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    char line[512];
+    long rows = 0;
+    *sum = 0;
+    if (fgets(line, sizeof(line), f) != NULL) {
+        while (fgets(line, sizeof(line), f) != NULL) {
+            rows++;
+            char *save = NULL;
+            char *tok = strtok_r(line, " \t\n", &save);
+            for (int c = 0; tok != NULL && c < column; c++) {
+                tok = strtok_r(NULL, " \t\n", &save);
+            }
+            if (column >= 0 && tok != NULL) {
+                *sum += strtoll(tok, NULL, 10);
+            }
+        }
+    }
+    fclose(f);
+    return rows;
+}
+
+/**
+ * @brief Value of a "Key: value" line of a /proc status-style file (-1 if absent).
+ */
+static long long status_field(const char *path, const char *key, int base) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+    char line[256];
+    size_t len = strlen(key);
+    long long v = -1;
+    while (fgets(line, sizeof(line), f) != NULL) {
+        if (strncmp(line, key, len) == 0 && line[len] == ':') {
+            v = strtoll(line + len + 1, NULL, base);
+            break;
+        }
+    }
+    fclose(f);
+    return v;
+}
+
+/**
+ * @brief Tasks (threads) of every process whose real UID is ours.
+ *
+ * RLIMIT_NPROC counts these, not processes.
+ */
+static long user_tasks(void) {
+    DIR *d = opendir("/proc");
+    if (d == NULL) {
+        return -1;
+    }
+    uid_t uid = getuid();
+    long tasks = 0;
+    struct dirent *e;
+    while ((e = readdir(d)) != NULL) {
+        if (!isdigit((unsigned char)e->d_name[0])) {
+            continue;
+        }
+        char path[sizeof(e->d_name) + 16];
+        snprintf(path, sizeof(path), "/proc/%s/status", e->d_name);
+        if (status_field(path, "Uid", 10) == (long long)uid) {
+            long long threads = status_field(path, "Threads", 10);
+            tasks += threads > 0 ? threads : 1;
+        }
+    }
+    closedir(d);
+    return tasks;
+}
+
+static void read_limits(HostLimits *h) {
+    long long v[4];
+    memset(h, 0, sizeof(*h));
+    long long sum = 0;
+
+    if (read_numbers("/proc/sys/kernel/sem", v, 4) == 4) {
+        h->semmsl = (long)v[0];
+        h->semmns = (long)v[1];
+        h->semmni = (long)v[3];
+    } else {
+        h->semmsl = h->semmns = h->semmni = -1;
+    }
+    h->sem_sets_used = sysvipc_rows("/proc/sysvipc/sem", 3, &sum);
+    h->sems_used = (long)sum;
+
+    h->msgmni = (long)read_number("/proc/sys/kernel/msgmni");
+    h->msgmnb = (long)read_number("/proc/sys/kernel/msgmnb");
+    h->msgmax = (long)read_number("/proc/sys/kernel/msgmax");
+    h->queues_used = sysvipc_rows("/proc/sysvipc/msg", -1, &sum);
+
+    h->shmmax = read_number("/proc/sys/kernel/shmmax");
+    h->shmall = read_number("/proc/sys/kernel/shmall");
+    h->shmmni = read_number("/proc/sys/kernel/shmmni");
+    h->segments_used = sysvipc_rows("/proc/sysvipc/shm", 3, &sum);
+    long page = sysconf(_SC_PAGESIZE);
+    h->shm_pages_used = (sum + page - 1) / page;
+
+    long long caps = status_field("/proc/self/status", "CapEff", 16);
+    h->sys_resource = caps > 0 && (caps >> CAP_SYS_RESOURCE) & 1;
+
+    // Free tasks: system-wide (threads-max, pid_max) and, unless exempt, our user's
+    h->tasks_free = -1;
+    long long total_tasks = -1;
+    FILE *f = fopen("/proc/loadavg", "r");
+    if (f != NULL) {
+        double l1, l5, l15;
+        long long running;
+        if (fscanf(f, "%lf %lf %lf %lld/%lld", &l1, &l5, &l15, &running, &total_tasks) != 5) {
+            total_tasks = -1;
+        }
+        fclose(f);
+    }
+    long long threads_max = read_number("/proc/sys/kernel/threads-max");
+    long long pid_max = read_number("/proc/sys/kernel/pid_max");
+    if (total_tasks >= 0) {
+        if (threads_max > 0) h->tasks_free = (long)(threads_max - total_tasks);
+        if (pid_max > 0 && (h->tasks_free < 0 || pid_max - total_tasks < h->tasks_free)) {
+            h->tasks_free = (long)(pid_max - total_tasks);
+        }
+    }
+    int nproc_exempt = h->sys_resource || (caps > 0 && (caps >> CAP_SYS_ADMIN) & 1);
+    struct rlimit nproc;
+    if (!nproc_exempt && getrlimit(RLIMIT_NPROC, &nproc) == 0 && nproc.rlim_cur != RLIM_INFINITY) {
+        long used = user_tasks();
+        long free_user = (long)nproc.rlim_cur - (used > 0 ? used : 0);
+        if (h->tasks_free < 0 || free_user < h->tasks_free) {
+            h->tasks_free = free_user;
+        }
+    }
+
+    getrlimit(RLIMIT_NOFILE, &h->nofile);
+    h->mem_available_kb = status_field("/proc/meminfo", "MemAvailable", 10);
+}
+
+static void run_needs(const Config *cfg, RunNeeds *n) {
+    memset(n, 0, sizeof(*n));
+    // A tourist holds a platform gate from its send until its boarding confirmation, and an
+    // exit gate while it sends its arrival, so the gates bound every line queue. Requeues and
+    // BOARDING_WINDOW slots are messages the workers already took from those gate holders.
+    long platform = PLATFORM_GATES * (long)(sizeof(PlatformMsg) - sizeof(long));
+    long arrivals = EXIT_GATES * (long)(sizeof(ArrivalMsg) - sizeof(long));
+    n->line_queue_bytes = cfg->queue_transport == QUEUE_TRANSPORT_SHM ? 0
+                        : platform > arrivals ? platform : arrivals;
+
+    // A cashier queue holds one request per tourist of that cashier waiting at once
+    long tourists = cfg->total_tourists;
+    if (cfg->tourist_engine == TOURIST_ENGINE_PROCESS && cfg->tourist_pool_size > 0 &&
+        cfg->tourist_pool_size < tourists) {
+        tourists = cfg->tourist_pool_size;
+    }
+    n->cashier_waiters = (tourists + cfg->cashier_count - 1) / cfg->cashier_count;
+    n->cashier_queue_bytes = n->cashier_waiters * (long)(sizeof(CashierMsg) - sizeof(long));
+
+    n->fixed_tasks = 1 + 1 + cfg->cashier_count + cfg->line_count * (1 + cfg->boarding_workers) + 1 +
+                     (cfg->log_async != LOG_ASYNC_OFF) +
+                     (cfg->metrics_interval_ms > 0 || cfg->queue_sample_ms > 0) +
+                     (cfg->report_incremental != 0) + (cfg->remote_port > 0) +
+                     (cfg->checkpoint_interval_sim > 0);
+    long tourist_processes = 1, tourist_threads = 0;
+    long long stack_kb = 0;
+    switch (cfg->tourist_engine) {
+        case TOURIST_ENGINE_PROCESS:
+            tourist_processes = cfg->tourist_pool_size > 0 ? cfg->tourist_pool_size : cfg->total_tourists;
+            break;
+        case TOURIST_ENGINE_THREAD:
+            tourist_processes = cfg->tourist_pool_size > 0 ? cfg->tourist_pool_size : 1;
+            tourist_threads = cfg->total_tourists;
+            stack_kb = (long long)cfg->total_tourists * (TOURIST_THREAD_STACK_SIZE / 1024);
+            break;
+        case TOURIST_ENGINE_FIBER:
+            tourist_threads = cfg->fiber_threads - 1;
+            stack_kb = (long long)cfg->total_tourists * (FIBER_STACK_SIZE / 1024);
+            break;
+        default:
+            break;
+    }
+    n->processes = n->fixed_tasks + tourist_processes;
+    n->tasks = n->processes + tourist_threads + PREFLIGHT_TASK_MARGIN;
+    n->fds = PREFLIGHT_FD_MIN + (cfg->remote_port > 0 ? REMOTE_MAX_HOSTS : 0) +
+             (cfg->tourist_engine == TOURIST_ENGINE_FIBER ? cfg->fiber_threads : 0);
+    n->shm_size = ipc_shm_size(cfg);
+    n->memory_kb = (long long)(n->shm_size / 1024) + n->processes * PREFLIGHT_PROCESS_KB + stack_kb;
+}
+
+/**
+ * @brief System V semaphore, queue and segment counts and sizes (never adapted).
+ */
+static int check_ipc_counts(const Config *cfg, const RunNeeds *n, const HostLimits *h) {
+    int ok = 1;
+    if (cfg->station_capacity > PREFLIGHT_SEMVMX) {
+        fprintf(stderr, "preflight: STATION_CAPACITY=%d exceeds SEMVMX (%d), the largest semaphore value\n",
+                cfg->station_capacity, PREFLIGHT_SEMVMX);
+        ok = 0;
+    }
+    if (h->semmsl >= 0 && h->semmsl < SEM_COUNT) {
+        fprintf(stderr, "preflight: kernel.sem SEMMSL=%ld, a line's set needs %d semaphores\n",
+                h->semmsl, SEM_COUNT);
+        ok = 0;
+    }
+    if (h->semmni >= 0 && h->sem_sets_used >= 0 && h->sem_sets_used + cfg->line_count > h->semmni) {
+        fprintf(stderr, "preflight: %d semaphore sets needed, %ld of SEMMNI=%ld in use\n",
+                cfg->line_count, h->sem_sets_used, h->semmni);
+        ok = 0;
+    }
+    if (h->semmns >= 0 && h->sems_used + (long)cfg->line_count * SEM_COUNT > h->semmns) {
+        fprintf(stderr, "preflight: %d semaphores needed, %ld of SEMMNS=%ld in use\n",
+                cfg->line_count * SEM_COUNT, h->sems_used, h->semmns);
+        ok = 0;
+    }
+
+    long queues = cfg->cashier_count + 1 + 4L * cfg->line_count;
+    if (h->msgmni >= 0 && h->queues_used >= 0 && h->queues_used + queues > h->msgmni) {
+        fprintf(stderr, "preflight: %ld message queues needed, %ld of kernel.msgmni=%ld in use\n",
+                queues, h->queues_used, h->msgmni);
+        ok = 0;
+    }
+    if (h->msgmax >= 0 && h->msgmax < (long)(sizeof(PlatformMsg) - sizeof(long))) {
+        fprintf(stderr, "preflight: kernel.msgmax=%ld is below one platform message (%zu bytes)\n",
+                h->msgmax, sizeof(PlatformMsg) - sizeof(long));
+        ok = 0;
+    }
+
+    long page = sysconf(_SC_PAGESIZE);
+    long long pages = (long long)((n->shm_size + page - 1) / page);
+    if (h->shmmax >= 0 && (long long)n->shm_size > h->shmmax) {
+        fprintf(stderr, "preflight: %zu bytes of shared memory exceed kernel.shmmax=%lld\n",
+                n->shm_size, h->shmmax);
+        ok = 0;
+    }
+    if (h->shmall >= 0 && h->shm_pages_used + pages > h->shmall) {
+        fprintf(stderr, "preflight: %lld shared memory pages needed, %lld of kernel.shmall=%lld in use\n",
+                pages, h->shm_pages_used, h->shmall);
+        ok = 0;
+    }
+    if (h->shmmni >= 0 && h->segments_used >= 0 && h->segments_used + 1 > h->shmmni) {
+        fprintf(stderr, "preflight: no shared memory segment left (%ld of kernel.shmmni=%lld in use)\n",
+                h->segments_used, h->shmmni);
+        ok = 0;
+    }
+    if (h->mem_available_kb >= 0 && (long long)(n->shm_size / 1024) > h->mem_available_kb) {
+        fprintf(stderr, "preflight: %zu KB of shared memory exceed MemAvailable (%lld KB)\n",
+                n->shm_size / 1024, h->mem_available_kb);
+        ok = 0;
+    }
+    return ok;
+}
+
+/**
+ * @brief Fit the System V queues: raise QUEUE_BYTES, or move the line queues to shm rings.
+ */
+static int fit_queues(Config *runs, int run_count, int mode, const HostLimits *h) {
+    long line_need = 0, cashier_need = 0, cashier_waiters = 0;
+    for (int r = 0; r < run_count; r++) {
+        RunNeeds n;
+        run_needs(&runs[r], &n);
+        if (n.line_queue_bytes > line_need) line_need = n.line_queue_bytes;
+        if (n.cashier_queue_bytes > cashier_need) {
+            cashier_need = n.cashier_queue_bytes;
+            cashier_waiters = n.cashier_waiters;
+        }
+    }
+    if (h->msgmnb < 0) {
+        return 1;  // Limit unknown
+    }
+
+    long limit = runs[0].queue_bytes > 0 ? runs[0].queue_bytes : h->msgmnb;
+    if (runs[0].queue_bytes > h->msgmnb && !h->sys_resource) {
+        fprintf(stderr, "preflight: QUEUE_BYTES=%d exceeds kernel.msgmnb=%ld without CAP_SYS_RESOURCE\n",
+                runs[0].queue_bytes, h->msgmnb);
+        return 0;
+    }
+
+    // Only a small QUEUE_BYTES or kernel.msgmnb gets here. Raising msg_qbytes up to msgmnb
+    // needs no capability, so the cashier estimate is taken along where it fits.
+    if (line_need > limit) {
+        if (mode == PREFLIGHT_ADAPT && (line_need <= h->msgmnb || h->sys_resource)) {
+            long was = limit;
+            long ceiling = h->sys_resource ? cashier_need : h->msgmnb;
+            limit = cashier_need < ceiling ? cashier_need : ceiling;
+            if (limit < line_need) limit = line_need;
+            printf("Preflight: QUEUE_BYTES=%ld (%d platform gates need %ld bytes per line queue, "
+                   "msg_qbytes was %ld)\n", limit, PLATFORM_GATES, line_need, was);
+            for (int r = 0; r < run_count; r++) {
+                runs[r].queue_bytes = (int)limit;
+            }
+        } else if (mode == PREFLIGHT_ADAPT) {
+            printf("Preflight: QUEUE_TRANSPORT=1 (%d platform gates need %ld bytes per line queue, "
+                   "msg_qbytes is %ld)\n", PLATFORM_GATES, line_need, limit);
+            for (int r = 0; r < run_count; r++) {
+                runs[r].queue_transport = QUEUE_TRANSPORT_SHM;
+            }
+        } else {
+            fprintf(stderr, "preflight: %d platform gates need %ld bytes per line queue, "
+                            "msg_qbytes is %ld (raise QUEUE_BYTES or set QUEUE_TRANSPORT=1)\n",
+                    PLATFORM_GATES, line_need, limit);
+            return 0;
+        }
+    }
+
+    // Estimate only: tourists seldom all queue at once, so a full cashier queue just slows them
+    if (cashier_need > limit) {
+        if (mode == PREFLIGHT_ADAPT && h->sys_resource) {
+            printf("Preflight: QUEUE_BYTES=%ld (up to %ld tourists per cashier queue)\n",
+                   cashier_need, cashier_waiters);
+            for (int r = 0; r < run_count; r++) {
+                runs[r].queue_bytes = (int)cashier_need;
+            }
+        } else {
+            fprintf(stderr, "preflight: warning: up to %ld tourists may queue at one cashier (%ld bytes), "
+                            "msg_qbytes is %ld; the rest wait in msgsnd\n",
+                    cashier_waiters, cashier_need, limit);
+        }
+    }
+    return 1;
+}
+
+/**
+ * @brief Fit the tasks of one run: cap tourist processes with a pool.
+ */
+static int fit_tasks(Config *cfg, int mode, const HostLimits *h, int run) {
+    RunNeeds n;
+    run_needs(cfg, &n);
+    if (h->tasks_free < 0 || n.tasks <= h->tasks_free) {
+        return 1;
+    }
+    long pool = h->tasks_free - n.fixed_tasks - PREFLIGHT_TASK_MARGIN;
+    if (mode == PREFLIGHT_ADAPT && cfg->tourist_engine == TOURIST_ENGINE_PROCESS && pool >= 1) {
+        printf("Preflight: TOURIST_POOL_SIZE=%ld (run %d needs %ld tasks, %ld free)\n",
+               pool, run + 1, n.tasks, h->tasks_free);
+        cfg->tourist_pool_size = (int)pool;
+        return 1;
+    }
+    fprintf(stderr, "preflight: run %d needs %ld tasks, %ld free under RLIMIT_NPROC, "
+                    "kernel.threads-max and pid_max (lower TOTAL_TOURISTS or use a pool or "
+                    "TOURIST_ENGINE=2)\n", run + 1, n.tasks, h->tasks_free);
+    return 0;
+}
+
+/**
+ * @brief Fit the descriptors: raise the soft RLIMIT_NOFILE (inherited by every child).
+ */
+static int fit_fds(long need, int mode, HostLimits *h) {
+    if (h->nofile.rlim_cur == RLIM_INFINITY || (long)h->nofile.rlim_cur >= need) {
+        return 1;
+    }
+    if (mode == PREFLIGHT_ADAPT && (h->nofile.rlim_max == RLIM_INFINITY || (long)h->nofile.rlim_max >= need)) {
+        struct rlimit raised = h->nofile;
+        raised.rlim_cur = (rlim_t)need;
+        if (setrlimit(RLIMIT_NOFILE, &raised) == 0) {
+            printf("Preflight: RLIMIT_NOFILE raised to %ld\n", need);
+            h->nofile = raised;
+            return 1;
+        }
+        perror("preflight: setrlimit RLIMIT_NOFILE");
+    }
+    fprintf(stderr, "preflight: %ld file descriptors needed, RLIMIT_NOFILE is %llu\n",
+            need, (unsigned long long)h->nofile.rlim_cur);
+    return 0;
+}
+
+int preflight_run(Config *runs, int run_count, int mode) {
+    if (mode == PREFLIGHT_OFF) {
+        return 0;
+    }
+    HostLimits h;
+    read_limits(&h);
+
+    int ok = fit_queues(runs, run_count, mode, &h);
+    long fds = 0, tasks = 0;
+    long long memory_kb = 0;
+    size_t shm_size = 0;
+    for (int r = 0; r < run_count; r++) {
+        ok &= fit_tasks(&runs[r], mode, &h, r);
+        RunNeeds n;
+        run_needs(&runs[r], &n);
+        ok &= check_ipc_counts(&runs[r], &n, &h);
+        if (n.fds > fds) fds = n.fds;
+        if (n.tasks > tasks) tasks = n.tasks;
+        if (n.memory_kb > memory_kb) memory_kb = n.memory_kb;
+        if (n.shm_size > shm_size) shm_size = n.shm_size;
+    }
+    ok &= fit_fds(fds, mode, &h);
+    if (!ok) {
+        return -1;
+    }
+
+    if (h.mem_available_kb >= 0 && memory_kb > h.mem_available_kb) {
+        fprintf(stderr, "preflight: warning: the run may use up to %lld MB, %lld MB available\n",
+                memory_kb / 1024, h.mem_available_kb / 1024);
+    }
+    char free_tasks[24];
+    if (h.tasks_free >= 0) {
+        snprintf(free_tasks, sizeof(free_tasks), "%ld", h.tasks_free);
+    } else {
+        snprintf(free_tasks, sizeof(free_tasks), "unknown");
+    }
+    printf("Preflight: %ld tasks (%s free), %zu KB shared memory, msg_qbytes %ld, ~%lld MB of %lld MB available\n",
+           tasks, free_tasks, shm_size / 1024,
+           runs[0].queue_bytes > 0 ? (long)runs[0].queue_bytes : h.msgmnb,
+           memory_kb / 1024, h.mem_available_kb >= 0 ? h.mem_available_kb / 1024 : -1);
+    fflush(stdout);     // Before the first fork, or every child repeats it
+    return 0;
+}
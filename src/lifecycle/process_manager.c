@@ -4,10 +4,15 @@
  */
 
 #include "lifecycle/process_manager.h"
+#include "lifecycle/cpu_affinity.h"
 #include "core/logger.h"
+#include "core/profile.h"
+#include "core/time_sim.h"
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 // Forward declaration for tourist generator entry point
@@ -25,6 +30,24 @@ void tourist_generator_main(IPCResources *res, IPCKeys *keys, const char *touris
 pid_t spawn_worker(void (*worker_func)(IPCResources*, IPCKeys*),
                    IPCResources *res, IPCKeys *keys,
                    const char *name) {
+    return spawn_worker_pinned(worker_func, res, keys, name, -1, 0);
+}
+
+/**
+ * @brief Spawn a worker process on a dedicated core.
+ *
+ * @param worker_func Worker entry point function.
+ * @param res IPC resources for the worker.
+ * @param keys IPC keys for the worker.
+ * @param name Worker name for logging.
+ * @param cpu Core to pin to (-1 = inherit main's mask).
+ * @param fifo_priority SCHED_FIFO priority (0 = keep SCHED_OTHER).
+ * @return Child PID on success, -1 on error.
+ */
+pid_t spawn_worker_pinned(void (*worker_func)(IPCResources*, IPCKeys*),
+                          IPCResources *res, IPCKeys *keys,
+                          const char *name, int cpu, int fifo_priority) {
+    int64_t spawn_ns = time_monotonic_ns();
     pid_t pid = fork();
 
     if (pid == -1) {
@@ -33,9 +56,27 @@ pid_t spawn_worker(void (*worker_func)(IPCResources*, IPCKeys*),
     }
 
     if (pid == 0) {
-        // Child process
+        // Child process: placement first, so the worker never runs elsewhere
+        ipc_note_spawn(spawn_ns);
+        ipc_seal_config(res);
+        if (cpu >= 0) {
+            if (cpu_pin(cpu) == -1) {
+                log_warn("MAIN", "%s: cannot pin to CPU %d: %s", name, cpu, strerror(errno));
+            } else {
+                log_info("MAIN", "%s pinned to CPU %d", name, cpu);
+            }
+        }
+        if (fifo_priority > 0 && cpu_set_fifo(fifo_priority) == -1) {
+            log_warn("MAIN", "%s: SCHED_FIFO %d refused: %s", name, fifo_priority, strerror(errno));
+        } else if (fifo_priority > 0) {
+            log_info("MAIN", "%s running SCHED_FIFO priority %d", name, fifo_priority);
+        }
         log_debug("MAIN", "%s process started (PID %d)", name, getpid());
+        ProfileScope profile;
+        profile_begin(&profile, &res->state->cfg);
         worker_func(res, keys);
+        time_participant_leave(res->state);
+        profile_end(&profile, res->state);
         exit(0);
     }
 
@@ -49,9 +90,10 @@ pid_t spawn_worker(void (*worker_func)(IPCResources*, IPCKeys*),
  * @param res IPC resources for the generator.
  * @param keys IPC keys for the generator.
  * @param tourist_exe Path to the tourist executable.
+ * @param own_group 1 = put the generator (and so every tourist) in a new process group.
  * @return Child PID on success, -1 on error.
  */
-pid_t spawn_generator(IPCResources *res, IPCKeys *keys, const char *tourist_exe) {
+pid_t spawn_generator(IPCResources *res, IPCKeys *keys, const char *tourist_exe, int own_group) {
     pid_t pid = fork();
 
     if (pid == -1) {
@@ -60,11 +102,26 @@ pid_t spawn_generator(IPCResources *res, IPCKeys *keys, const char *tourist_exe)
     }
 
     if (pid == 0) {
+        // Set on both sides of the fork, so neither tourists nor a kill(-pid)
+        // can see the group before it exists
+        if (own_group) {
+            setpgid(0, 0);
+        }
+        ipc_seal_config(res);
         log_info("MAIN", "Tourist generator started (PID %d)", getpid());
+        ProfileScope profile;
+        profile_begin(&profile, &res->state->cfg);
         tourist_generator_main(res, keys, tourist_exe);
+        time_participant_leave(res->state);
+        // Every child has been reaped by now (child_reaper_finish)
+        profile_end_tourists(&profile, res->state, res->state->tourist_exits.reaped);
+        profile_end(&profile, res->state);
         exit(0);
     }
 
+    if (own_group) {
+        setpgid(pid, pid);
+    }
     log_debug("MAIN", "Spawned tourist generator with PID %d", pid);
     return pid;
 }
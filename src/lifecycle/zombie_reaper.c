@@ -7,7 +7,9 @@
 #include "lifecycle/process_signals.h"
 
 #include <errno.h>
+#include <signal.h>
 #include <stdio.h>
+#include <time.h>
 #include <sys/wait.h>
 #include <unistd.h>
 
@@ -63,3 +65,65 @@ void wait_for_workers(void) {
         perror("wait_for_workers: waitpid");
     }
 }
+
+/**
+ * @brief Wait for one worker process to exit (blocking).
+ *
+ * Used to keep the log drainer alive until the other workers are gone.
+ *
+ * @param pid Child PID (ignored if <= 0).
+ */
+void wait_for_worker(pid_t pid) {
+    if (pid <= 0) return;
+
+    int status;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            return;  // ECHILD: already reaped by reap_zombies()
+        }
+    }
+
+    char buf[64];
+    int len = snprintf(buf, sizeof(buf), "[DEBUG] [MAIN] Worker exited: PID %d\n", (int)pid);
+    if (len > 0 && len < (int)sizeof(buf)) {
+        write(STDERR_FILENO, buf, len);
+    }
+}
+
+/**
+ * @brief Wait for one worker process to exit, killing it after a timeout.
+ *
+ * Polls waitpid(WNOHANG) every millisecond.
+ *
+ * @param pid Child PID (ignored if <= 0).
+ * @param timeout_ms Grace period before SIGKILL.
+ * @param kill_group 1 = SIGKILL the process group pid leads, 0 = the process only.
+ * @return 0 if it exited in time (or was not running), 1 if it had to be killed.
+ */
+int wait_for_worker_timeout(pid_t pid, int timeout_ms, int kill_group) {
+    if (pid <= 0) return 0;
+
+    int status;
+    for (int waited = 0; waited < timeout_ms; waited++) {
+        pid_t rc = waitpid(pid, &status, WNOHANG);
+        if (rc == pid || (rc == -1 && errno != EINTR)) {
+            // Exited, or ECHILD: already reaped by reap_zombies()
+            if (rc == pid) {
+                char buf[64];
+                int len = snprintf(buf, sizeof(buf), "[DEBUG] [MAIN] Worker exited: PID %d\n", (int)pid);
+                if (len > 0 && len < (int)sizeof(buf)) {
+                    write(STDERR_FILENO, buf, len);
+                }
+            }
+            return 0;
+        }
+        struct timespec ts = {0, 1000000L};
+        nanosleep(&ts, NULL);
+    }
+
+    if (kill(kill_group ? -pid : pid, SIGKILL) == -1 && errno != ESRCH) {
+        perror("wait_for_worker_timeout: kill");
+    }
+    wait_for_worker(pid);
+    return 1;
+}
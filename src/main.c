@@ -10,18 +10,31 @@
 #include "core/logger.h"
 #include "core/time_sim.h"
 #include "core/report.h"
+#include "core/trace.h"
+#include "core/completion_ring.h"
+#include "core/sweep.h"
+#include "core/danger_schedule.h"
+#include "core/profile.h"
 #include "ipc/ipc.h"
+#include "ipc/transport.h"
+#include "ipc/control.h"
 #include "lifecycle/process_signals.h"
 #include "lifecycle/process_manager.h"
+#include "lifecycle/cpu_affinity.h"
 #include "lifecycle/zombie_reaper.h"
+#include "lifecycle/checkpoint.h"
+#include "lifecycle/preflight.h"
 
 #include <errno.h>
+#include <sched.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/msg.h>
 #include <sys/sem.h>
+#include <sys/time.h>
+#include <time.h>
 #include <unistd.h>
 
 // Forward declarations for worker entry points
@@ -29,26 +42,49 @@ void time_server_main(IPCResources *res, IPCKeys *keys);
 void cashier_main(IPCResources *res, IPCKeys *keys);
 void lower_worker_main(IPCResources *res, IPCKeys *keys);
 void upper_worker_main(IPCResources *res, IPCKeys *keys);
+void boarding_worker_main(IPCResources *res, IPCKeys *keys);
+void log_drainer_main(IPCResources *res, IPCKeys *keys);
+void metrics_exporter_main(IPCResources *res, IPCKeys *keys);
+void remote_gateway_main(IPCResources *res, IPCKeys *keys);
+void report_writer_main(IPCResources *res, IPCKeys *keys);
 
 // Global IPC resources (used by signal handler via signals_init)
 static IPCResources g_res;
 
+// 1 = runs of a sweep share g_res: a run ends without IPC_RMID
+static int g_sweep = 0;
+
+// Main's affinity mask at startup (WORKER_CPUS reserves cores out of it)
+static cpu_set_t g_initial_cpus;
+
+// Stages before the next run's spawns (copied into SharedState.startup by run_simulation)
+static StartupTiming g_startup;
+
 /**
  * @brief Print usage information to stderr.
  *
  * @param prog Program name (argv[0]).
  */
 static void print_usage(const char *prog) {
-    fprintf(stderr, "Usage: %s [config_path]\n", prog);
+    fprintf(stderr, "Usage: %s [config_path] [--sweep KEY=v1,v2,...]...\n", prog);
+    fprintf(stderr, "       %s --restore checkpoint_path\n", prog);
     fprintf(stderr, "  config_path: Config file path or name (default: default.conf)\n");
     fprintf(stderr, "               If just a filename, looks in ../config/\n");
+    fprintf(stderr, "  --sweep:     Run once per value (cartesian product of all --sweep\n");
+    fprintf(stderr, "               options) over one set of IPC resources, results in\n");
+    fprintf(stderr, "               " SWEEP_REPORT_FILE_NAME "\n");
+    fprintf(stderr, "  --restore:   Continue the run saved in a checkpoint file (its config,\n");
+    fprintf(stderr, "               clock, statistics and tourist table)\n");
 }
 
 /**
  * @brief Signal workers to stop and destroy IPC to unblock blocked operations.
  *
- * Sends SIGTERM to all worker processes and destroys message queues
- * and semaphores to unblock any stuck operations.
+ * Sends SIGTERM to all worker processes (every line's worker pair) and
+ * destroys message queues and semaphores to unblock any stuck operations.
+ * In a sweep the IPC objects are kept for the next run: the generator's
+ * process group (every tourist) gets the SIGTERM too, and processes still
+ * blocked after SWEEP_DRAIN_MS are killed (see await_worker).
  */
 static void shutdown_workers(void) {
     // Send SIGTERM to worker processes
@@ -58,80 +94,543 @@ static void shutdown_workers(void) {
             perror("main: kill time_server");
         }
     }
-    if (g_res.state->cashier_pid > 0) {
-        if (kill(g_res.state->cashier_pid, SIGTERM) == -1 && errno != ESRCH) {
-            perror("main: kill cashier");
+    for (int c = 0; c < g_res.cashier_count; c++) {
+        if (g_res.state->cashier_pid[c] > 0) {
+            if (kill(g_res.state->cashier_pid[c], SIGTERM) == -1 && errno != ESRCH) {
+                perror("main: kill cashier");
+            }
         }
     }
-    if (g_res.state->lower_worker_pid > 0) {
-        if (kill(g_res.state->lower_worker_pid, SIGTERM) == -1 && errno != ESRCH) {
-            perror("main: kill lower_worker");
+    for (int l = 0; l < g_res.line_count; l++) {
+        if (g_res.state->lower_worker_pid[l] > 0) {
+            if (kill(g_res.state->lower_worker_pid[l], SIGTERM) == -1 && errno != ESRCH) {
+                perror("main: kill lower_worker");
+            }
+        }
+        if (g_res.state->upper_worker_pid[l] > 0) {
+            if (kill(g_res.state->upper_worker_pid[l], SIGTERM) == -1 && errno != ESRCH) {
+                perror("main: kill upper_worker");
+            }
+        }
+        for (int b = 0; b < g_res.state->cfg.boarding_workers - 1; b++) {
+            pid_t pid = g_res.state->boarding_worker_pid[l][b];
+            if (pid > 0 && kill(pid, SIGTERM) == -1 && errno != ESRCH) {
+                perror("main: kill boarding_worker");
+            }
         }
     }
-    if (g_res.state->upper_worker_pid > 0) {
-        if (kill(g_res.state->upper_worker_pid, SIGTERM) == -1 && errno != ESRCH) {
-            perror("main: kill upper_worker");
+    if (g_res.state->gateway_pid > 0) {
+        if (kill(g_res.state->gateway_pid, SIGTERM) == -1 && errno != ESRCH) {
+            perror("main: kill remote_gateway");
         }
     }
     if (g_res.state->generator_pid > 0) {
-        if (kill(g_res.state->generator_pid, SIGTERM) == -1 && errno != ESRCH) {
+        pid_t target = g_sweep ? -g_res.state->generator_pid : g_res.state->generator_pid;
+        if (kill(target, SIGTERM) == -1 && errno != ESRCH) {
             perror("main: kill generator");
         }
     }
 
+    // Wake processes sleeping in the shm ring transport (futexes ignore IPC_RMID)
+    transport_wake_all(&g_res);
+
+    if (g_sweep) {
+        return;  // Queues are drained and semaphores reset by ipc_reset instead
+    }
+
     // Destroy message queues to unblock any stuck msgrcv/msgsnd operations
-    if (g_res.mq_cashier_id != -1) {
-        msgctl(g_res.mq_cashier_id, IPC_RMID, NULL);
-        g_res.mq_cashier_id = -1;
+    for (int c = 0; c < g_res.cashier_count; c++) {
+        if (g_res.mq_cashier_ids[c] != -1) {
+            msgctl(g_res.mq_cashier_ids[c], IPC_RMID, NULL);
+            g_res.mq_cashier_ids[c] = -1;
+        }
+    }
+    g_res.mq_cashier_id = -1;
+    if (g_res.mq_spawn_id != -1) {
+        msgctl(g_res.mq_spawn_id, IPC_RMID, NULL);
+        g_res.mq_spawn_id = -1;
+    }
+    for (int l = 0; l < g_res.line_count; l++) {
+        LineIds *line = &g_res.lines[l];
+        int *queues[] = {&line->mq_platform_id, &line->mq_boarding_id,
+                         &line->mq_arrivals_id, &line->mq_worker_id};
+        for (size_t q = 0; q < sizeof(queues) / sizeof(queues[0]); q++) {
+            if (*queues[q] != -1) {
+                msgctl(*queues[q], IPC_RMID, NULL);
+                *queues[q] = -1;
+            }
+        }
+
+        // Destroy semaphores to unblock any stuck semop operations
+        if (line->sem_id != -1) {
+            semctl(line->sem_id, 0, IPC_RMID);
+            line->sem_id = -1;
+        }
+    }
+    ipc_select_line(&g_res, 0);
+}
+
+/**
+ * @brief Wait for one worker to exit (bounded in a sweep, see shutdown_workers).
+ *
+ * @param pid Child PID (ignored if <= 0).
+ * @param group 1 = pid leads a process group to kill with it (generator).
+ */
+static void await_worker(pid_t pid, int group) {
+    if (!g_sweep) {
+        wait_for_worker(pid);
+    } else if (wait_for_worker_timeout(pid, SWEEP_DRAIN_MS, group) == 1) {
+        log_warn("MAIN", "PID %d still running %d ms after shutdown, killed", (int)pid,
+                 SWEEP_DRAIN_MS);
+    }
+}
+
+/**
+ * @brief Wait for the time server, cashiers, line workers and generator.
+ */
+static void await_simulation_workers(void) {
+    await_worker(g_res.state->time_server_pid, 0);
+    for (int c = 0; c < g_res.cashier_count; c++) {
+        await_worker(g_res.state->cashier_pid[c], 0);
+    }
+    for (int l = 0; l < g_res.line_count; l++) {
+        await_worker(g_res.state->lower_worker_pid[l], 0);
+        await_worker(g_res.state->upper_worker_pid[l], 0);
+        for (int b = 0; b < g_res.state->cfg.boarding_workers - 1; b++) {
+            await_worker(g_res.state->boarding_worker_pid[l][b], 0);
+        }
+    }
+    await_worker(g_res.state->gateway_pid, 0);
+    await_worker(g_res.state->generator_pid, 1);
+}
+
+/**
+ * @brief Reserve the worker cores of a run and move main off them.
+ *
+ * Every process main forks afterwards (helpers, generator, tourists)
+ * inherits the remaining cores; fixed workers pin themselves.
+ */
+static void place_main(const Config *cfg, CpuPlan *plan) {
+    cpu_plan_init(plan, &g_initial_cpus, cfg->worker_cpus);
+    if (CPU_COUNT(&plan->other_cpus) > 0 &&
+        sched_setaffinity(0, sizeof(plan->other_cpus), &plan->other_cpus) == -1) {
+        log_warn("MAIN", "Cannot set main's CPU affinity: %s", strerror(errno));
+    }
+    g_res.state->worker_cpus = plan->worker_count;
+    g_res.state->tourist_cpus = plan->shared ? 0 : CPU_COUNT(&plan->other_cpus);
+    if (plan->shared) {
+        log_warn("MAIN", "CPU isolation: all %d core(s) reserved for workers, tourists share them",
+                 plan->worker_count);
+    } else if (plan->worker_count > 0) {
+        log_info("MAIN", "CPU isolation: %d worker core(s), %d core(s) for everything else",
+                 plan->worker_count, g_res.state->tourist_cpus);
+    }
+}
+
+/**
+ * @brief First CHECKPOINT_INTERVAL_SIM_MINUTES boundary after a sim time.
+ */
+static int next_checkpoint_minutes(const SharedState *state, int interval, int now_minutes) {
+    int done = (now_minutes - state->sim_start_minutes) / interval;
+    return state->sim_start_minutes + (done + 1) * interval;
+}
+
+/**
+ * @brief Take a checkpoint once the sim clock passes the next boundary.
+ *
+ * @param next_minutes Boundary due next (advanced past the current time).
+ * @return Real ms until the main loop should wake up (at most 1000, MAIN_VCLOCK_POLL_MS with MAX_SPEED=1).
+ */
+static int checkpoint_if_due(const Config *cfg, int *next_minutes) {
+    if (cfg->checkpoint_interval_sim <= 0) {
+        return 1000;
+    }
+    int now = time_get_sim_minutes(g_res.state);
+    if (now < *next_minutes && cfg->max_speed) {
+        return MAIN_VCLOCK_POLL_MS;  // The virtual clock outruns any real-time estimate
+    }
+    if (now < *next_minutes) {
+        double wait_ms = time_sim_ms_to_real_ms(g_res.state,
+                                                ((int64_t)*next_minutes * 60000) - time_get_sim_ms(g_res.state));
+        return wait_ms < 1.0 ? 1 : wait_ms > 1000.0 ? 1000 : (int)wait_ms + 1;
+    }
+    pid_t pid = checkpoint_take(&g_res, CHECKPOINT_FILE_NAME);
+    if (pid > 0) {
+        log_debug("MAIN", "Checkpoint at %02d:%02d handed to writer PID %d", now / 60, now % 60, (int)pid);
+    } else if (pid == 0) {
+        log_warn("MAIN", "Checkpoint at %02d:%02d skipped, previous writer still running",
+                 now / 60, now % 60);
+    }
+    *next_minutes = next_checkpoint_minutes(g_res.state, cfg->checkpoint_interval_sim, now);
+    return 1;
+}
+
+/**
+ * @brief Run one simulated day on already created (or reset) IPC resources.
+ *
+ * Spawns the workers and the generator, waits for the end of the day and
+ * for every process to exit. The report is left to the caller.
+ *
+ * @param cfg Configuration of this run (already copied into shared state).
+ * @param keys IPC keys.
+ * @param tourist_exe Path to the tourist executable.
+ */
+static void run_simulation(const Config *cfg, IPCKeys *keys, const char *tourist_exe) {
+    StartupTiming *st = &g_res.state->startup;
+    st->config_ns = g_startup.config_ns;
+    st->cleanup_ns = g_startup.cleanup_ns;
+    st->ipc_ns = g_startup.ipc_ns;
+    st->ipc_reset = g_startup.ipc_reset;
+
+    // Main's share of the run's CPU time, and every child's once reaped
+    ProfileScope profile;
+    profile_begin(&profile, cfg);
+
+    // Initialize logger with shared state
+    logger_init(g_res.state, LOG_MAIN);
+    logger_set_debug_enabled(cfg->debug_logs_enabled);
+
+    // Initialize time
+    time_init(g_res.state, cfg);
+
+    // Store main PID
+    g_res.state->main_pid = g_main_pid;
+
+    log_debug("MAIN", "Simulation starting at %02d:%02d",
+             cfg->sim_start_hour, cfg->sim_start_minute);
+
+    CpuPlan plan;
+    place_main(cfg, &plan);
+    int fifo = cfg->worker_sched_fifo;
+
+    // Create the event trace before any worker can emit into it
+    if (g_res.state->event_trace && trace_create(g_res.state, TRACE_FILE_NAME) == -1) {
+        g_res.state->event_trace = 0;
+        log_warn("MAIN", "Failed to create event trace, tracing disabled");
+    } else if (g_res.state->event_trace) {
+        log_debug("MAIN", "Event trace: %s", g_res.state->trace_path);
+    }
+
+    // Spawn the log drainer before anyone else logs into the ring
+    if (g_res.state->cfg.log_async != LOG_ASYNC_OFF) {
+        g_res.state->log_drainer_pid = spawn_worker(log_drainer_main, &g_res, keys, "LogDrainer");
+        if (g_res.state->log_drainer_pid == -1) {
+            logger_async_stop();
+            g_res.state->log_drainer_pid = 0;
+            log_warn("MAIN", "Failed to spawn log drainer, logging directly");
+        }
+    }
+
+    // Spawn the metrics exporter (reads counters and samples queues, never blocks the simulation)
+    if (g_res.state->cfg.metrics_interval_ms > 0 || g_res.state->cfg.queue_sample_ms > 0) {
+        g_res.state->metrics_pid = spawn_worker(metrics_exporter_main, &g_res, keys, "MetricsExporter");
+        if (g_res.state->metrics_pid == -1) {
+            g_res.state->metrics_pid = 0;
+            log_warn("MAIN", "Failed to spawn metrics exporter, metrics disabled");
+        }
+    }
+
+    // Spawn the report writer before any tourist can finish
+    if (completion_ring_get(g_res.state) != NULL) {
+        g_res.state->report_writer_pid = spawn_worker(report_writer_main, &g_res, keys, "ReportWriter");
+        if (g_res.state->report_writer_pid == -1) {
+            g_res.state->report_writer_pid = 0;
+            log_error("MAIN", "Failed to spawn report writer");
+            control_set_running(g_res.state, 0);
+        }
+    }
+
+    // Main counts on the virtual clock until the generator takes over spawning
+    time_participant_join(g_res.state);
+
+    // Spawn Time Server (handles time tracking and pause offset)
+    int64_t fork_start_ns = time_monotonic_ns();
+    g_res.state->time_server_pid = spawn_worker_pinned(time_server_main, &g_res, keys, "TimeServer",
+                                                       cpu_plan_next(&plan), fifo);
+
+    int spawn_failed = g_res.state->time_server_pid == -1;
+
+    // One cashier per ticket office queue, each forked from a view of its queue
+    for (int c = 0; c < g_res.cashier_count; c++) {
+        IPCResources cashier_res = g_res;
+        char name[32] = "Cashier";
+        ipc_select_cashier(&cashier_res, c);
+        if (c > 0) {
+            snprintf(name, sizeof(name), "Cashier%d", c);
+        }
+        g_res.state->cashier_pid[c] = spawn_worker_pinned(cashier_main, &cashier_res, keys, name,
+                                                          cpu_plan_next(&plan), 0);
+        if (g_res.state->cashier_pid[c] == -1) {
+            spawn_failed = 1;
+        }
+    }
+
+    // One lower/upper worker pair per line, each forked from a view of its line
+    for (int l = 0; l < g_res.line_count; l++) {
+        IPCResources line_res = g_res;
+        char lower_name[32] = "LowerWorker";
+        char upper_name[32] = "UpperWorker";
+        ipc_select_line(&line_res, l);
+        if (l > 0) {
+            snprintf(lower_name, sizeof(lower_name), "LowerWorker%d", l);
+            snprintf(upper_name, sizeof(upper_name), "UpperWorker%d", l);
+        }
+        g_res.state->lower_worker_pid[l] = spawn_worker_pinned(lower_worker_main, &line_res, keys,
+                                                               lower_name, cpu_plan_next(&plan), fifo);
+        g_res.state->upper_worker_pid[l] = spawn_worker_pinned(upper_worker_main, &line_res, keys,
+                                                               upper_name, cpu_plan_next(&plan), 0);
+        if (g_res.state->lower_worker_pid[l] == -1 || g_res.state->upper_worker_pid[l] == -1) {
+            spawn_failed = 1;
+        }
+
+        // Extra boarding workers share the line's platform queue and chair assembler
+        for (int b = 0; b < g_res.state->cfg.boarding_workers - 1; b++) {
+            pid_t pid = spawn_worker_pinned(boarding_worker_main, &line_res, keys, "BoardingWorker",
+                                            cpu_plan_next(&plan), fifo);
+            g_res.state->boarding_worker_pid[l][b] = pid;
+            if (pid == -1) {
+                spawn_failed = 1;
+            }
+        }
+    }
+
+    int64_t ready_start_ns = time_monotonic_ns();
+    st->fork_ns = ready_start_ns - fork_start_ns;
+
+    if (spawn_failed) {
+        log_error("MAIN", "Failed to spawn one or more workers");
+        control_set_running(g_res.state, 0);
+    }
+
+    // Wait for all workers to be ready before starting tourist generator
+    // (line 0 also counts the time server and every cashier, other lines
+    // their pair, every line its extra boarding workers). Every fork above
+    // was issued before this wait, so the workers initialize concurrently
+    // and one WORKER_READY_TIMEOUT_MS deadline covers all lines.
+    for (int l = 0; l < g_res.line_count && control_running(g_res.state); l++) {
+        IPCResources line_res = g_res;
+        ipc_select_line(&line_res, l);
+        int expected = (l == 0 ? WORKER_COUNT_FOR_BARRIER + g_res.cashier_count - 1
+                                : WORKER_COUNT_PER_LINE) +
+                       g_res.state->cfg.boarding_workers - 1;
+        int64_t left_ms = WORKER_READY_TIMEOUT_MS - (time_monotonic_ns() - ready_start_ns) / 1000000;
+        if (ipc_wait_workers_ready(&line_res, expected, left_ms > 0 ? (int)left_ms : 1) == -1) {
+            log_error("MAIN", "Failed to wait for workers to be ready");
+            control_set_running(g_res.state, 0);
+        }
+    }
+    st->ready_ns = time_monotonic_ns() - ready_start_ns;
+    log_info("MAIN", "Startup: config %.3f ms, cleanup %.3f ms, IPC %s %.3f ms, fork %.3f ms, ready %.3f ms",
+             st->config_ns / 1e6, st->cleanup_ns / 1e6, st->ipc_reset ? "reset" : "create",
+             st->ipc_ns / 1e6, st->fork_ns / 1e6, st->ready_ns / 1e6);
+
+    // Remote hosts feed the same spawn queue as the generator
+    if (cfg->remote_port > 0 && control_running(g_res.state)) {
+        g_res.state->gateway_pid = spawn_worker(remote_gateway_main, &g_res, keys, "RemoteGateway");
+        if (g_res.state->gateway_pid == -1) {
+            g_res.state->gateway_pid = 0;
+            g_res.state->remote.done = 1;
+            log_warn("MAIN", "Failed to spawn remote gateway, local tourists only");
+        }
+    }
+
+    // Now spawn the tourist generator (workers are guaranteed to be ready)
+    if (control_running(g_res.state)) {
+        time_participant_add(g_res.state);
+        g_res.state->generator_pid = spawn_generator(&g_res, keys, tourist_exe, g_sweep);
+        if (g_res.state->generator_pid == -1) {
+            time_participant_remove(g_res.state);
+            log_error("MAIN", "Failed to spawn tourist generator");
+            control_set_running(g_res.state, 0);
+        }
+    }
+    time_participant_leave(g_res.state);
+
+    log_debug("MAIN", "All workers spawned, simulation running");
+
+    int next_checkpoint = cfg->checkpoint_interval_sim > 0
+        ? next_checkpoint_minutes(g_res.state, cfg->checkpoint_interval_sim,
+                                  time_get_sim_minutes(g_res.state))
+        : 0;
+
+    // Main loop - handle signals and reap zombies
+    while (g_running && control_running(g_res.state)) {
+        reap_zombies();
+
+        // Check if simulation time is over
+        if (time_is_simulation_over(g_res.state)) {
+            log_info("MAIN", "Simulation time ended");
+            control_set_closing(g_res.state, 1);
+            break;
+        }
+
+        // Copy the state for a writer child (the copy is the only stall)
+        int wait_ms = checkpoint_if_due(cfg, &next_checkpoint);
+
+        // Set alarm to wake up in 1 second to check time (sooner if a checkpoint is due)
+        struct itimerval wake = {
+            .it_interval = {0, 0},
+            .it_value = {wait_ms / 1000, (wait_ms % 1000) * 1000}
+        };
+        setitimer(ITIMER_REAL, &wake, NULL);
+
+        // Block until next signal (SIGCHLD, SIGALRM, etc.)
+        pause();
     }
-    if (g_res.mq_platform_id != -1) {
-        msgctl(g_res.mq_platform_id, IPC_RMID, NULL);
-        g_res.mq_platform_id = -1;
+
+    log_info("MAIN", "Shutting down simulation");
+
+    // Signal all processes to stop
+    control_set_running(g_res.state, 0);
+
+    // Signal workers and destroy IPC to unblock them
+    shutdown_workers();
+
+    // Wait for workers to exit (the report writer, metrics exporter and log
+    // drainer last, once every tourist has left, the counters are final and
+    // nobody else logs)
+    if (g_res.state->log_drainer_pid > 0 || g_res.state->metrics_pid > 0 ||
+        g_res.state->report_writer_pid > 0) {
+        await_simulation_workers();
+        if (g_res.state->report_writer_pid > 0) {
+            completion_ring_stop(completion_ring_get(g_res.state));
+            await_worker(g_res.state->report_writer_pid, 0);
+        }
+        if (g_res.state->metrics_pid > 0) {
+            if (kill(g_res.state->metrics_pid, SIGTERM) == -1 && errno != ESRCH) {
+                perror("main: kill metrics_exporter");
+            }
+            await_worker(g_res.state->metrics_pid, 0);
+        }
+        logger_async_stop();
+    } else if (g_sweep) {
+        await_simulation_workers();  // Bounded: no IPC_RMID unblocks stragglers
     }
-    if (g_res.mq_boarding_id != -1) {
-        msgctl(g_res.mq_boarding_id, IPC_RMID, NULL);
-        g_res.mq_boarding_id = -1;
+    wait_for_workers();
+    profile_end(&profile, g_res.state);
+    profile_end_total(&profile, g_res.state);
+
+    // Shrink the event trace to the records written
+    trace_close();
+}
+
+
+/**
+ * @brief Write the report of a single run (text, plus CSV with REPORT_FORMAT=1).
+ */
+static void write_reports(void) {
+    if (write_report_to_file(g_res.state, "simulation_report.txt") == 0) {
+        write(STDERR_FILENO, "[INFO] [MAIN] Report saved to simulation_report.txt\n", 52);
     }
-    if (g_res.mq_arrivals_id != -1) {
-        msgctl(g_res.mq_arrivals_id, IPC_RMID, NULL);
-        g_res.mq_arrivals_id = -1;
+    // With REPORT_INCREMENTAL=1 the report writer has already written the CSV
+    if (g_res.state->cfg.report_format == REPORT_FORMAT_CSV &&
+        (g_res.state->cfg.report_incremental ||
+         write_report_csv(g_res.state, REPORT_CSV_FILE_NAME) == 0)) {
+        write(STDERR_FILENO, "[INFO] [MAIN] Tourist table saved to " REPORT_CSV_FILE_NAME "\n", 59);
     }
-    if (g_res.mq_worker_id != -1) {
-        msgctl(g_res.mq_worker_id, IPC_RMID, NULL);
-        g_res.mq_worker_id = -1;
+}
+
+/**
+ * @brief Build and check the configuration of every sweep run.
+ *
+ * Every run must be valid and share the first run's IPC layout (same
+ * segment size, LINE_COUNT and CASHIER_COUNT), since they reuse its
+ * resources.
+ *
+ * @param sweep Swept keys.
+ * @param base Configuration from the file.
+ * @param runs Output, sweep_run_count() entries.
+ * @return 0 on success, -1 on error.
+ */
+static int sweep_prepare(const Sweep *sweep, const Config *base, Config *runs) {
+    int run_count = sweep_run_count(sweep);
+    for (int r = 0; r < run_count; r++) {
+        sweep_run_config(sweep, base, r, &runs[r]);
+        if (config_validate(&runs[r]) == -1) {
+            fprintf(stderr, "Error: Invalid configuration in sweep run %d\n", r + 1);
+            return -1;
+        }
+        if (ipc_shm_size(&runs[r]) != ipc_shm_size(&runs[0]) ||
+            runs[r].line_count != runs[0].line_count ||
+            runs[r].cashier_count != runs[0].cashier_count ||
+            runs[r].shm_huge_pages != runs[0].shm_huge_pages) {
+            fprintf(stderr, "Error: Sweep run %d changes the IPC layout (LINE_COUNT, "
+                            "CASHIER_COUNT, TOTAL_TOURISTS, SHM_HUGE_PAGES or an optional region)\n", r + 1);
+            return -1;
+        }
     }
+    return 0;
+}
 
-    // Destroy semaphores to unblock any stuck semop operations
-    if (g_res.sem_id != -1) {
-        semctl(g_res.sem_id, 0, IPC_RMID);
-        g_res.sem_id = -1;
+/**
+ * @brief Print the swept values of one run to stdout.
+ */
+static void sweep_print_run(const Sweep *sweep, int run, int run_count) {
+    printf("Sweep run %d/%d:", run + 1, run_count);
+    for (int a = 0; a < sweep->axis_count; a++) {
+        printf(" %s=%s", sweep->axes[a].key, sweep_value(sweep, a, run));
     }
+    printf("\n");
 }
 
 /**
  * @brief Main entry point for ropeway simulation.
  *
  * Loads config, creates IPC, spawns workers, runs main loop, handles shutdown.
+ * With --sweep it runs once per combination of swept values, resetting the
+ * IPC resources between runs instead of recreating them.
  *
  * @param argc Argument count.
- * @param argv Argument vector (optional config path).
+ * @param argv Argument vector (optional config path, --sweep options).
  * @return 0 on success, 1 on error.
  */
 int main(int argc, char *argv[]) {
     static char config_path[256];
+    static Config run_cfgs[SWEEP_MAX_RUNS];
+    static SweepResult results[SWEEP_MAX_RUNS];
     const char *config_name = "default.conf";
 #ifndef TOURIST_EXE_PATH
 #error "TOURIST_EXE_PATH must be defined by CMake"
 #endif
     const char *tourist_exe = TOURIST_EXE_PATH;
+    Sweep sweep = {.axis_count = 0};
+    const char *restore_path = NULL;
+    int config_given = 0;
+    Checkpoint ckpt = {0};
+
+    if (sched_getaffinity(0, sizeof(g_initial_cpus), &g_initial_cpus) == -1) {
+        perror("sched_getaffinity");
+        CPU_ZERO(&g_initial_cpus);
+    }
 
     // Parse arguments
-    if (argc > 1) {
-        if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
         }
-        config_name = argv[1];
+        if (strcmp(argv[i], "--sweep") == 0) {
+            if (i + 1 >= argc || sweep_add_axis(&sweep, argv[i + 1]) == -1) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--restore") == 0) {
+            if (i + 1 >= argc) {
+                print_usage(argv[0]);
+                return 1;
+            }
+            restore_path = argv[++i];
+        } else {
+            config_name = argv[i];
+            config_given = 1;
+        }
+    }
+    g_sweep = sweep.axis_count > 0;
+    if (restore_path != NULL && (g_sweep || config_given)) {
+        fprintf(stderr, "Error: --restore takes its configuration from the checkpoint "
+                        "(no config path or --sweep)\n");
+        return 1;
     }
 
     // Build config path
@@ -150,9 +649,17 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
-    // Load configuration
+    // Load configuration (a restored run's comes from the checkpoint)
+    int64_t stage_ns = time_monotonic_ns();
     Config cfg;
-    if (config_load(config_path, &cfg) == -1) {
+    if (restore_path != NULL) {
+        if (checkpoint_load(restore_path, &ckpt) == -1) {
+            fprintf(stderr, "Error: Failed to load checkpoint from %s\n", restore_path);
+            return 1;
+        }
+        cfg = ckpt.header->cfg;
+        snprintf(config_path, sizeof(config_path), "%s (checkpoint)", restore_path);
+    } else if (config_load(config_path, &cfg) == -1) {
         fprintf(stderr, "Error: Failed to load config from %s\n", config_path);
         return 1;
     }
@@ -162,6 +669,17 @@ int main(int argc, char *argv[]) {
         return 1;
     }
 
+    // Every sweep run is checked before any IPC resource exists
+    int run_count = sweep_run_count(&sweep);
+    if (run_count > SWEEP_MAX_RUNS) {
+        fprintf(stderr, "Error: Sweep has %d runs (max %d)\n", run_count, SWEEP_MAX_RUNS);
+        return 1;
+    }
+    if (sweep_prepare(&sweep, &cfg, run_cfgs) == -1) {
+        return 1;
+    }
+    g_startup.config_ns = time_monotonic_ns() - stage_ns;
+
     printf("Ropeway Simulation Starting\n");
     printf("Config: %s\n", config_path);
     printf("Station capacity: %d\n", cfg.station_capacity);
@@ -169,6 +687,14 @@ int main(int argc, char *argv[]) {
            cfg.sim_start_hour, cfg.sim_start_minute,
            cfg.sim_end_hour, cfg.sim_end_minute,
            cfg.simulation_duration_real);
+    if (g_sweep) {
+        printf("Sweep: %d runs over one set of IPC resources\n", run_count);
+    }
+    if (ckpt.header != NULL) {
+        int minutes = (int)(ckpt.header->sim_ms / 60000);
+        printf("Restore: from %02d:%02d, %d tourists spawned before\n",
+               minutes / 60, minutes % 60, ckpt.header->tourists_spawned);
+    }
 
     // Generate IPC keys
     IPCKeys keys;
@@ -178,99 +704,91 @@ int main(int argc, char *argv[]) {
     }
 
     // Clean up stale IPC resources from previous crashed run
+    stage_ns = time_monotonic_ns();
     ipc_cleanup_stale(&keys);
+    g_startup.cleanup_ns = time_monotonic_ns() - stage_ns;
+
+    // Fit every run to the kernel's limits before anything is created or forked
+    // (a restored run keeps the checkpoint's configuration: check only)
+    int preflight = cfg.preflight;
+    if (ckpt.header != NULL && preflight == PREFLIGHT_ADAPT) {
+        preflight = PREFLIGHT_CHECK;
+    }
+    if (preflight_run(run_cfgs, run_count, preflight) == -1) {
+        fprintf(stderr, "Error: Preflight failed, the host cannot run this configuration\n");
+        if (ckpt.header != NULL) {
+            checkpoint_free(&ckpt);
+        }
+        return 1;
+    }
 
     // Create IPC resources
-    if (ipc_create(&g_res, &keys, &cfg) == -1) {
+    stage_ns = time_monotonic_ns();
+    if (ipc_create(&g_res, &keys, &run_cfgs[0]) == -1) {
         fprintf(stderr, "Error: Failed to create IPC resources\n");
         return 1;
     }
+    g_startup.ipc_ns = time_monotonic_ns() - stage_ns;
+
+    // A restored run starts from the checkpoint's counters, table and clock
+    if (ckpt.header != NULL) {
+        int rc = checkpoint_restore(&ckpt, g_res.state);
+        checkpoint_free(&ckpt);
+        if (rc == -1) {
+            fprintf(stderr, "Error: Failed to restore checkpoint\n");
+            ipc_destroy(&g_res);
+            return 1;
+        }
+    }
 
-    // Initialize logger with shared state
-    logger_init(g_res.state, LOG_MAIN);
-    logger_set_debug_enabled(cfg.debug_logs_enabled);
-
-    // Initialize time
-    time_init(g_res.state, &cfg);
-
-    // Store main PID
+    // Store main PID (copied into shared state by every run)
     g_main_pid = getpid();
-    g_res.state->main_pid = g_main_pid;
-
-    log_debug("MAIN", "Simulation starting at %02d:%02d",
-             cfg.sim_start_hour, cfg.sim_start_minute);
 
     // Initialize and install signal handlers
     signals_init(&g_res);
     install_signal_handlers();
 
-    // Spawn Time Server first (handles time tracking and pause offset)
-    g_res.state->time_server_pid = spawn_worker(time_server_main, &g_res, &keys, "TimeServer");
-
-    // Spawn other workers
-    g_res.state->cashier_pid = spawn_worker(cashier_main, &g_res, &keys, "Cashier");
-    g_res.state->lower_worker_pid = spawn_worker(lower_worker_main, &g_res, &keys, "LowerWorker");
-    g_res.state->upper_worker_pid = spawn_worker(upper_worker_main, &g_res, &keys, "UpperWorker");
-
-    if (g_res.state->time_server_pid == -1 ||
-        g_res.state->cashier_pid == -1 ||
-        g_res.state->lower_worker_pid == -1 ||
-        g_res.state->upper_worker_pid == -1) {
-        log_error("MAIN", "Failed to spawn one or more workers");
-        g_res.state->running = 0;
-    }
-
-    // Wait for all workers to be ready before starting tourist generator
-    if (g_res.state->running) {
-        if (ipc_wait_workers_ready(&g_res, WORKER_COUNT_FOR_BARRIER) == -1) {
-            log_error("MAIN", "Failed to wait for workers to be ready");
-            g_res.state->running = 0;
+    int runs_done = 0;
+    for (int r = 0; r < run_count && g_running; r++) {
+        if (r > 0) {
+            // Config and stale cleanup happened once, before the first run
+            stage_ns = time_monotonic_ns();
+            if (ipc_reset(&g_res, &run_cfgs[r]) == -1) {
+                fprintf(stderr, "Error: Failed to reset IPC resources for sweep run %d\n", r + 1);
+                break;
+            }
+            g_startup.config_ns = 0;
+            g_startup.cleanup_ns = 0;
+            g_startup.ipc_ns = time_monotonic_ns() - stage_ns;
+            g_startup.ipc_reset = 1;
         }
-    }
-
-    // Now spawn the tourist generator (workers are guaranteed to be ready)
-    if (g_res.state->running) {
-        g_res.state->generator_pid = spawn_generator(&g_res, &keys, tourist_exe);
-        if (g_res.state->generator_pid == -1) {
-            log_error("MAIN", "Failed to spawn tourist generator");
-            g_res.state->running = 0;
+        if (g_sweep) {
+            sweep_print_run(&sweep, r, run_count);
+            fflush(stdout);
         }
-    }
 
-    log_debug("MAIN", "All workers spawned, simulation running");
-
-    // Main loop - handle signals and reap zombies
-    while (g_running && g_res.state->running) {
-        reap_zombies();
+        struct timespec start, end;
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        run_simulation(&run_cfgs[r], &keys, tourist_exe);
+        clock_gettime(CLOCK_MONOTONIC, &end);
 
-        // Check if simulation time is over
-        if (time_is_simulation_over(g_res.state)) {
-            log_info("MAIN", "Simulation time ended");
-            g_res.state->closing = 1;
-            break;
+        if (g_sweep) {
+            double wall = (double)(end.tv_sec - start.tv_sec) +
+                          (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+            sweep_collect(g_res.state, wall, &results[r]);
         }
-
-        // Set alarm to wake up in 1 second to check time
-        alarm(1);
-
-        // Block until next signal (SIGCHLD, SIGALRM, etc.)
-        pause();
+        runs_done++;
     }
 
-    log_info("MAIN", "Shutting down simulation");
-
-    // Signal all processes to stop
-    g_res.state->running = 0;
-
-    // Signal workers and destroy IPC to unblock them
-    shutdown_workers();
-
-    // Wait for workers to exit
-    wait_for_workers();
-
     // Write report to file
-    if (write_report_to_file(g_res.state, "simulation_report.txt") == 0) {
-        write(STDERR_FILENO, "[INFO] [MAIN] Report saved to simulation_report.txt\n", 52);
+    if (!g_sweep) {
+        write_reports();
+        if (g_res.state->cfg.danger_schedule == DANGER_SCHEDULE_RECORD &&
+            danger_schedule_save(g_res.state, DANGER_SCHEDULE_FILE_NAME) == 0) {
+            write(STDERR_FILENO, "[INFO] [MAIN] Danger schedule saved to " DANGER_SCHEDULE_FILE_NAME "\n", 59);
+        }
+    } else if (sweep_write_report(&sweep, results, runs_done, SWEEP_REPORT_FILE_NAME) == 0) {
+        write(STDERR_FILENO, "[INFO] [MAIN] Sweep report saved to " SWEEP_REPORT_FILE_NAME "\n", 53);
     }
 
     // Cleanup remaining IPC resources (shared memory)
@@ -3,8 +3,12 @@
 #include "constants.h"
 #include "ipc/messages.h"
 #include "ipc/ipc.h"
+#include "ipc/control.h"
+#include "ipc/queue_stats.h"
 #include "core/logger.h"
 #include "core/time_sim.h"
+#include "core/stats.h"
+#include "core/trace.h"
 #include "common/signal_common.h"
 
 #include <stdio.h>
@@ -17,39 +21,49 @@
 #include <time.h>
 
 static int g_running = 1;
+static const char *g_tag = "CASHIER";  // Log tag (carries the cashier number on cashiers > 0)
 
 // Use macro-generated signal handler for basic shutdown handling
 DEFINE_BASIC_SIGNAL_HANDLER(signal_handler)
 
+// Fixed tariff in PLN, indexed by TicketType
+static const int base_prices[TICKET_COUNT] = {15, 30, 50, 70, 80};
+
+// Age bands of the tariff: under 10 or 65+ get the discount
+#define AGE_BAND_DISCOUNT 0
+#define AGE_BAND_FULL 1
+#define AGE_BAND_COUNT 2
+
+// Whole-party price by (ticket, vip, parent's age band, kids) and ticket
+// validity in sim minutes from the sale (-1 = until closing), filled once by
+// build_tariff_tables() so a sale is a table lookup
+static int g_price_table[TICKET_COUNT][2][AGE_BAND_COUNT][MAX_KIDS_PER_ADULT + 1];
+static int g_validity_minutes[TICKET_COUNT];
+
 /**
  * @brief Calculate ticket expiration time in simulated minutes.
  *
- * @param state Shared state with ticket duration settings.
+ * @param state Shared state (closing time).
  * @param ticket Type of ticket being purchased.
+ * @param now_minutes Sim time of the sale (read once per batch).
  * @return Expiration time in simulated minutes from midnight.
  */
-static int calculate_ticket_validity(SharedState *state, TicketType ticket) {
-    int current_minutes = time_get_sim_minutes(state);
-
-    switch (ticket) {
-        case TICKET_SINGLE:
-            return state->sim_end_minutes;  // Valid all day (single use)
-
-        case TICKET_TIME_T1:
-            return current_minutes + state->ticket_t1_duration;
-
-        case TICKET_TIME_T2:
-            return current_minutes + state->ticket_t2_duration;
-
-        case TICKET_TIME_T3:
-            return current_minutes + state->ticket_t3_duration;
-
-        case TICKET_DAILY:
-            return state->sim_end_minutes;
-
-        default:
-            return state->sim_end_minutes;
+static int calculate_ticket_validity(const SharedState *state, TicketType ticket, int now_minutes) {
+    int minutes = g_validity_minutes[ticket];
+    if (minutes < 0) {
+        return state->sim_end_minutes;  // Single and daily tickets: valid all day
     }
+    return now_minutes + minutes;
+}
+
+/**
+ * @brief Age band of a tourist for the price table.
+ *
+ * @param age Tourist age in years.
+ * @return AGE_BAND_DISCOUNT (under 10 or 65+) or AGE_BAND_FULL.
+ */
+static int age_band(int age) {
+    return (age < 10 || age >= 65) ? AGE_BAND_DISCOUNT : AGE_BAND_FULL;
 }
 
 /**
@@ -63,8 +77,6 @@ static int calculate_ticket_validity(SharedState *state, TicketType ticket) {
  * @return Price in PLN.
  */
 static int calculate_price(int age, TicketType ticket, int is_vip) {
-    // Base prices
-    int base_prices[] = {15, 30, 50, 70, 80};
     int price = base_prices[ticket];
 
     // VIP surcharge
@@ -108,21 +120,146 @@ static int calculate_family_price(int parent_age, TicketType ticket, int is_vip,
     return total;
 }
 
+/**
+ * @brief Fill the price and validity tables (once, at cashier startup).
+ *
+ * Prices come from calculate_family_price() for one representative age per
+ * band; validity from the configured T1/T2/T3 durations.
+ *
+ * @param state Shared state with ticket duration settings.
+ */
+static void build_tariff_tables(const SharedState *state) {
+    static const int band_age[AGE_BAND_COUNT] = {[AGE_BAND_DISCOUNT] = 65, [AGE_BAND_FULL] = 30};
+
+    for (int t = 0; t < TICKET_COUNT; t++) {
+        for (int vip = 0; vip < 2; vip++) {
+            for (int band = 0; band < AGE_BAND_COUNT; band++) {
+                for (int kids = 0; kids <= MAX_KIDS_PER_ADULT; kids++) {
+                    g_price_table[t][vip][band][kids] =
+                        calculate_family_price(band_age[band], (TicketType)t, vip, kids);
+                }
+            }
+        }
+    }
+
+    g_validity_minutes[TICKET_SINGLE] = -1;
+    g_validity_minutes[TICKET_TIME_T1] = state->cfg.ticket_t1_duration;
+    g_validity_minutes[TICKET_TIME_T2] = state->cfg.ticket_t2_duration;
+    g_validity_minutes[TICKET_TIME_T3] = state->cfg.ticket_t3_duration;
+    g_validity_minutes[TICKET_DAILY] = -1;
+}
+
+/**
+ * @brief Send one reply (mtype = response base + tourist_id).
+ *
+ * @param res IPC resources.
+ * @param response Reply with ticket_type set (-1 = refused).
+ * @param what Operation name for perror.
+ * @return 0 if sent, 1 if not delivered (interrupted or error), -1 if the queue was removed.
+ */
+static int send_reply(IPCResources *res, CashierMsg *response, const char *what) {
+    response->mtype = MSG_CASHIER_RESPONSE_BASE + response->tourist_id;
+    if (queue_msgsnd(res->state, QUEUE_CASHIER, res->mq_cashier_id, response,
+                     sizeof(*response) - sizeof(long), 0) == -1) {
+        if (errno == EIDRM || errno == EINVAL) {
+            log_debug(g_tag, "Message queue removed during send");
+            return -1;
+        }
+        if (errno != EINTR) perror(what);
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Sell one ticket: price and validity lookup, reply, log.
+ *
+ * @param res IPC resources.
+ * @param request Ticket request.
+ * @param now_minutes Sim time of the batch.
+ * @param sold In/out: tourists (parent + kids) sold per TicketType this batch.
+ * @return 0 on success, -1 if the queue was removed.
+ */
+static int sell_ticket(IPCResources *res, const CashierMsg *request, int now_minutes,
+                       int sold[TICKET_COUNT]) {
+    // Use ticket type requested by tourist
+    TicketType ticket = request->ticket_type;
+    int valid_until = calculate_ticket_validity(res->state, ticket, now_minutes);
+
+    // Price for whole family (table lookup, see build_tariff_tables)
+    int price = g_price_table[ticket][request->is_vip ? 1 : 0][age_band(request->age)]
+                             [request->kid_count];
+
+    // Statistics are added once per batch (count parent + kids as separate tourists)
+    sold[ticket] += 1 + request->kid_count;
+    trace_emit(TRACE_SRC_CASHIER, TRACE_TICKET_SOLD, request->tourist_id, 0, -1,
+               1 + request->kid_count);
+
+    // Send ticket response
+    CashierMsg response = *request;
+    response.ticket_type = ticket;
+    response.ticket_valid_until = valid_until;
+    int rc = send_reply(res, &response, "cashier: msgsnd ticket");
+    if (rc != 0) {
+        return rc == -1 ? -1 : 0;  // Not delivered: already counted, not logged
+    }
+
+    const char *ticket_names[] = {"SINGLE", "TIME_T1", "TIME_T2", "TIME_T3", "DAILY"};
+    const char *type_names[] = {"walker", "cyclist", "family"};
+    const char *type_name = type_names[request->tourist_type];
+
+    char valid_buf[8];
+    time_format_minutes(valid_until, valid_buf, sizeof(valid_buf));
+
+    if (request->kid_count > 0) {
+        log_info(g_tag, "Sold %s family ticket to tourist %d (%s, age %d%s) + %d kid(s) - valid until %s, price %d PLN",
+                 ticket_names[ticket],
+                 request->tourist_id,
+                 type_name,
+                 request->age,
+                 request->is_vip ? ", VIP" : "",
+                 request->kid_count,
+                 valid_buf,
+                 price);
+    } else {
+        log_info(g_tag, "Sold %s ticket to tourist %d (%s, age %d%s) - valid until %s, price %d PLN",
+                 ticket_names[ticket],
+                 request->tourist_id,
+                 type_name,
+                 request->age,
+                 request->is_vip ? ", VIP" : "",
+                 valid_buf,
+                 price);
+    }
+    return 0;
+}
+
 /**
  * @brief Cashier process entry point.
  *
  * Handles ticket sales via message queue. Calculates prices with age discounts
  * and VIP surcharges. Runs until station closes or shutdown signal received.
+ * With CASHIER_COUNT > 1 each cashier serves only the tourists sharded to its
+ * own queue; sales are counted in the process's own stats shard, so cashiers
+ * never contend on a lock. Each wakeup drains up to CASHIER_BATCH waiting
+ * requests (IPC_NOWAIT after the first), reads the sim clock once and adds
+ * the batch's sales to the statistics once per ticket type.
  *
- * @param res IPC resources (message queues, semaphores, shared memory).
+ * @param res IPC resources (message queues, semaphores, shared memory), set to this cashier's queue.
  * @param keys IPC keys (unused, kept for interface consistency).
  */
 void cashier_main(IPCResources *res, IPCKeys *keys) {
     (void)keys;
 
+    static char tag[24];
+    if (res->cashier > 0) {
+        snprintf(tag, sizeof(tag), "CASHIER_%d", res->cashier);
+        g_tag = tag;
+    }
+
     // Initialize logger with component type
     logger_init(res->state, LOG_CASHIER);
-    logger_set_debug_enabled(res->state->debug_logs_enabled);
+    logger_set_debug_enabled(res->state->cfg.debug_logs_enabled);
 
     // Install signal handlers
     struct sigaction sa;
@@ -132,121 +269,81 @@ void cashier_main(IPCResources *res, IPCKeys *keys) {
     sigaction(SIGTERM, &sa, NULL);
     sigaction(SIGINT, &sa, NULL);
 
-    // Seed random number generator
-    srand(time(NULL) ^ getpid());
+    build_tariff_tables(res->state);
+    int batch_size = res->state->cfg.cashier_batch;
+
+    // Counted on the virtual clock from here until the process exits
+    time_participant_join(res->state);
 
     // Signal that this worker is ready (startup barrier)
     if (ipc_signal_worker_ready(res) == -1) {
-        log_error("CASHIER", "Failed to signal ready, exiting");
+        log_error(g_tag, "Failed to signal ready, exiting");
         return;
     }
-    log_info("CASHIER", "Cashier ready to serve tourists");
+    log_info(g_tag, "Cashier ready to serve tourists");
 
-    while (g_running && res->state->running) {
+    int queue_removed = 0;
+    while (!queue_removed && g_running && control_running(res->state)) {
         // Check if closing
-        if (res->state->closing) {
-            log_info("CASHIER", "Station closing, no more tickets");
+        if (control_closing(res->state)) {
+            log_info(g_tag, "Station closing, no more tickets");
             break;
         }
 
         // Wait for ticket request (only receive requests, not responses)
-        CashierMsg request;
-        ssize_t ret = msgrcv(res->mq_cashier_id, &request, sizeof(request) - sizeof(long),
+        CashierMsg batch[MAX_CASHIER_BATCH];
+        time_wait_begin();
+        ssize_t ret = msgrcv(res->mq_cashier_id, &batch[0], sizeof(batch[0]) - sizeof(long),
                              MSG_CASHIER_REQUEST, 0);
+        time_wait_end();
 
         if (ret == -1) {
             if (errno == EINTR) {
                 continue;  // Interrupted by signal
             }
             if (errno == EIDRM) {
-                log_debug("CASHIER", "Message queue removed, exiting");
+                log_debug(g_tag, "Message queue removed, exiting");
                 break;
             }
             perror("cashier: msgrcv");
             continue;
         }
 
-        // Check again if closing
-        if (res->state->closing) {
-            log_info("CASHIER", "Station closing, refusing ticket for tourist %d", request.tourist_id);
-
-            // Send rejection (mtype = response base + tourist_id, ticket_type = -1)
-            CashierMsg response = request;
-            response.mtype = MSG_CASHIER_RESPONSE_BASE + request.tourist_id;
-            response.ticket_type = -1;
-
-            if (msgsnd(res->mq_cashier_id, &response, sizeof(response) - sizeof(long), 0) == -1) {
-                if (errno == EIDRM) break;
-                if (errno != EINTR) perror("cashier: msgsnd rejection");
-            }
-            continue;
+        // Take whatever else is already waiting, up to the batch size
+        int count = 1;
+        while (count < batch_size &&
+               msgrcv(res->mq_cashier_id, &batch[count], sizeof(batch[0]) - sizeof(long),
+                      MSG_CASHIER_REQUEST, IPC_NOWAIT) != -1) {
+            count++;
         }
-
-        // Use ticket type requested by tourist
-        TicketType ticket = request.ticket_type;
-        int valid_until = calculate_ticket_validity(res->state, ticket);
-
-        // Calculate price for whole family
-        int price;
-        if (request.kid_count > 0) {
-            price = calculate_family_price(request.age, ticket, request.is_vip,
-                                           request.kid_count);
-        } else {
-            price = calculate_price(request.age, ticket, request.is_vip);
+        if (count > 1) {
+            log_debug(g_tag, "Serving batch of %d requests", count);
         }
 
-        // Update statistics (count parent + kids as separate tourists)
-        if (sem_wait_pauseable(res, SEM_STATS, 1) == -1) {
-            continue;  // Check loop condition on failure
-        }
-        res->state->total_tourists += (1 + request.kid_count);
-        res->state->tourists_by_ticket[ticket] += (1 + request.kid_count);
-        sem_post(res->sem_id, SEM_STATS, 1);
-
-        // Send ticket response (mtype = response base + tourist_id)
-        CashierMsg response = request;
-        response.mtype = MSG_CASHIER_RESPONSE_BASE + request.tourist_id;
-        response.ticket_type = ticket;
-        response.ticket_valid_until = valid_until;
-
-        if (msgsnd(res->mq_cashier_id, &response, sizeof(response) - sizeof(long), 0) == -1) {
-            if (errno == EINTR) continue;
-            if (errno == EIDRM) {
-                log_debug("CASHIER", "Message queue removed during send");
-                break;
+        // Check again if closing
+        if (control_closing(res->state)) {
+            for (int i = 0; i < count && !queue_removed; i++) {
+                log_info(g_tag, "Station closing, refusing ticket for tourist %d", batch[i].tourist_id);
+
+                // Send rejection (ticket_type = -1)
+                CashierMsg response = batch[i];
+                response.ticket_type = -1;
+                queue_removed = send_reply(res, &response, "cashier: msgsnd rejection") == -1;
             }
-            perror("cashier: msgsnd ticket");
             continue;
         }
 
-        const char *ticket_names[] = {"SINGLE", "TIME_T1", "TIME_T2", "TIME_T3", "DAILY"};
-        const char *type_names[] = {"walker", "cyclist", "family"};
-        const char *type_name = type_names[request.tourist_type];
-
-        char valid_buf[8];
-        time_format_minutes(valid_until, valid_buf, sizeof(valid_buf));
-
-        if (request.kid_count > 0) {
-            log_info("CASHIER", "Sold %s family ticket to tourist %d (%s, age %d%s) + %d kid(s) - valid until %s, price %d PLN",
-                     ticket_names[ticket],
-                     request.tourist_id,
-                     type_name,
-                     request.age,
-                     request.is_vip ? ", VIP" : "",
-                     request.kid_count,
-                     valid_buf,
-                     price);
-        } else {
-            log_info("CASHIER", "Sold %s ticket to tourist %d (%s, age %d%s) - valid until %s, price %d PLN",
-                     ticket_names[ticket],
-                     request.tourist_id,
-                     type_name,
-                     request.age,
-                     request.is_vip ? ", VIP" : "",
-                     valid_buf,
-                     price);
+        int now_minutes = time_get_sim_minutes(res->state);
+        int sold[TICKET_COUNT] = {0};
+        for (int i = 0; i < count && !queue_removed; i++) {
+            queue_removed = sell_ticket(res, &batch[i], now_minutes, sold) == -1;
+        }
+        for (int t = 0; t < TICKET_COUNT; t++) {
+            if (sold[t] > 0) {
+                stats_add_tourists(res->state, t, sold[t]);
+            }
         }
     }
 
-    log_info("CASHIER", "Cashier shutting down");
+    log_info(g_tag, "Cashier shutting down");
 }
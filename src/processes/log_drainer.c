@@ -0,0 +1,163 @@
+/**
+ * @file log_drainer.c
+ * @brief Log drainer process - writes the shm log ring to stderr (LOG_ASYNC > 0).
+ *
+ * Every other process appends binary records to the LogRing. The drainer
+ * formats them and writes up to LOG_DRAIN_BUFFER bytes per write(), so
+ * stderr sees a few large writes instead of one write per line. It keeps
+ * running until main calls logger_async_stop() (after every other worker
+ * has exited) or main disappears, and drains the ring before exiting.
+ */
+
+#include "ipc/ipc.h"
+#include "ipc/futex.h"
+#include "core/logger.h"
+#include "core/log_ring.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static volatile sig_atomic_t g_running = 1;
+
+/**
+ * @brief SIGTERM handler - drain what is queued and exit.
+ *
+ * @param sig Signal number (unused).
+ */
+static void sigterm_handler(int sig) {
+    (void)sig;
+    g_running = 0;
+}
+
+/**
+ * @brief Write the whole buffer to stderr, retrying short writes.
+ *
+ * @param buf Bytes to write.
+ * @param len Number of bytes.
+ */
+static void write_all(const char *buf, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(STDERR_FILENO, buf, len);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            return;  // stderr gone: nothing sensible left to do
+        }
+        buf += n;
+        len -= (size_t)n;
+    }
+}
+
+/**
+ * @brief Format and write every published record.
+ *
+ * @param ring Log ring.
+ * @param use_colors 1 to add ANSI colors.
+ * @return Number of records written.
+ */
+static int drain_ring(LogRing *ring, int use_colors) {
+    static char out[LOG_DRAIN_BUFFER];
+    size_t used = 0;
+    int count = 0;
+    LogRecord *rec;
+
+    while ((rec = log_ring_peek(ring)) != NULL) {
+        if (used + 512 > sizeof(out)) {
+            write_all(out, used);
+            used = 0;
+        }
+        used += (size_t)logger_format_record(rec, out + used, (int)(sizeof(out) - used), use_colors);
+        log_ring_release(ring, rec);
+        count++;
+    }
+
+    if (used > 0) {
+        write_all(out, used);
+    }
+    if (count > 0) {
+        __atomic_add_fetch(&ring->written, (uint64_t)count, __ATOMIC_RELAXED);
+    }
+    return count;
+}
+
+/**
+ * @brief Log drainer process entry point.
+ *
+ * @param res IPC resources (shared memory holding the log ring).
+ * @param keys IPC keys (unused, kept for interface consistency).
+ */
+void log_drainer_main(IPCResources *res, IPCKeys *keys) {
+    (void)keys;
+    SharedState *state = res->state;
+    LogRing *ring = log_ring_get(state);
+    if (ring == NULL) {
+        return;
+    }
+
+    logger_init(state, LOG_IPC);
+    logger_set_debug_enabled(state->cfg.debug_logs_enabled);
+
+    // Ctrl+C reaches the whole process group: let main shut down and stop us
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGINT, &sa, NULL);
+    sa.sa_handler = sigterm_handler;
+    sigaction(SIGTERM, &sa, NULL);
+
+    pid_t parent = getppid();
+    int use_colors = isatty(STDERR_FILENO);
+    int stalled_ms = 0;
+    __atomic_store_n(&ring->drainer_alive, 1, __ATOMIC_RELEASE);
+
+    log_debug("LOG_DRAINER", "Log drainer started (PID %d, ring=%d records, mode=%s)",
+              getpid(), LOG_RING_CAPACITY,
+              state->cfg.log_async == LOG_ASYNC_BLOCK ? "wait" : "drop");
+
+    while (1) {
+        if (drain_ring(ring, use_colors) > 0) {
+            stalled_ms = 0;
+        }
+
+        int done = __atomic_load_n(&ring->stop, __ATOMIC_ACQUIRE) || !g_running ||
+                   getppid() != parent;
+        if (done && log_ring_peek(ring) == NULL) {
+            break;
+        }
+
+        // Sleep until a producer publishes (one slice at most)
+        __atomic_store_n(&ring->item_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t observed = __atomic_load_n(&ring->items, __ATOMIC_SEQ_CST);
+        if (log_ring_peek(ring) == NULL) {
+            if (futex_wait(&ring->items, observed, SHM_WAIT_TIMEOUT_MS) == -1 &&
+                errno == ETIMEDOUT) {
+                // Head slot claimed by a producer that never published it?
+                if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == ring->head) {
+                    stalled_ms = 0;
+                } else {
+                    stalled_ms += SHM_WAIT_TIMEOUT_MS;
+                }
+                if (stalled_ms >= LOG_STALL_MS && log_ring_skip_stalled(ring)) {
+                    stalled_ms = 0;
+                }
+            }
+        }
+        __atomic_store_n(&ring->item_waiters, 0, __ATOMIC_SEQ_CST);
+    }
+
+    // From here on every process writes directly again
+    __atomic_store_n(&ring->drainer_alive, 0, __ATOMIC_RELEASE);
+    logger_async_stop();
+    drain_ring(ring, use_colors);
+
+    uint64_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    if (dropped > 0) {
+        log_warn("LOG_DRAINER", "Log ring full: %llu records dropped",
+                 (unsigned long long)dropped);
+    }
+    log_debug("LOG_DRAINER", "Log drainer exiting (records written: %llu)",
+              (unsigned long long)__atomic_load_n(&ring->written, __ATOMIC_RELAXED));
+}
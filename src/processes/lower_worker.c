@@ -3,8 +3,17 @@
 #include "constants.h"
 #include "ipc/messages.h"
 #include "ipc/ipc.h"
+#include "ipc/transport.h"
+#include "ipc/control.h"
+#include "ipc/numa.h"
 #include "core/logger.h"
 #include "core/time_sim.h"
+#include "core/rng.h"
+#include "core/chair_tracker.h"
+#include "core/chair_assembler.h"
+#include "core/chair_ring.h"
+#include "core/trace.h"
+#include "core/danger_schedule.h"
 #include "common/signal_common.h"
 #include "common/worker_emergency.h"
 
@@ -15,17 +24,22 @@
 #include <signal.h>
 #include <errno.h>
 #include <sys/msg.h>
+#include <sys/time.h>
+#include <time.h>
 
 static int g_running = 1;
 static int g_emergency_signal = 0;
 static int g_resume_signal = 0;
 static int g_alarm_signal = 0;
 static double g_last_danger_time_sim = 0.0;       // Last danger detection (sim minutes)
+static uint32_t g_danger_cursor = 0;              // Next replay script event (DANGER_SCHEDULE=2)
 static double g_emergency_start_time_sim = 0.0;  // When current emergency started (sim minutes)
 static int g_is_emergency_initiator = 0;         // 1 if this worker detected danger
+static const char *g_tag = "LOWER_WORKER";          // Log tag (carries the line number on lines > 0)
 
 // State pointers for worker_emergency functions
 static WorkerEmergencyState g_emergency_state;
+static Rng g_rng;                                // Danger checks (RANDOM_SEED stream per line)
 
 /**
  * @brief Buffered tourist awaiting chair departure.
@@ -39,6 +53,66 @@ typedef struct {
 static PendingBoarding g_pending[MAX_PENDING_PER_CHAIR];
 static int g_pending_count = 0;
 
+// Look-ahead loader (BOARDING_WINDOW > 0): received requests not yet seated, oldest first
+static PlatformMsg g_window[MAX_BOARDING_WINDOW];
+static int g_window_count = 0;
+
+// Deadline dispatcher (CHAIR_FILL_DEADLINE_SIM_SECONDS > 0)
+static int64_t g_fill_deadline_sim_ms = 0;  // Sim time the partial chair must leave by
+static int g_fill_timer_armed = 0;          // SysV transport: one-shot SIGALRM pending
+
+// Cadence departures (CHAIR_INTERVAL_SIM_SECONDS > 0): g_fill_deadline_sim_ms is
+// the departure time of the chair at the platform
+static int g_ring_transit = 0;              // Ring positions between the platforms
+static int g_ring_rebase = 1;               // Next departure counted from now (start, after a stop)
+static PlatformMsg g_held;                  // Group that did not fit on the platform chair
+static int g_held_valid = 0;
+
+/**
+ * @brief Arm (ms > 0) or cancel (ms == 0) the one-shot fill timer.
+ *
+ * Only used with SysV queues, where msgrcv cannot time out on its own.
+ */
+static void set_fill_timer(int ms) {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    timer.it_value.tv_sec = ms / 1000;
+    timer.it_value.tv_usec = (ms % 1000) * 1000;
+    setitimer(ITIMER_REAL, &timer, NULL);
+    g_fill_timer_armed = (ms > 0);
+}
+
+/**
+ * @brief Keep the one-shot fill timer armed for the next wait (SysV queues).
+ *
+ * @param wait_ms Real ms until the deadline (<= 0 = nothing to wait for).
+ */
+static void arm_fill_timer(int wait_ms) {
+    if (g_alarm_signal) {
+        g_alarm_signal = 0;
+        g_fill_timer_armed = 0;
+    }
+    if (wait_ms > 0 && !g_fill_timer_armed) {
+        set_fill_timer(wait_ms);
+    }
+}
+
+/**
+ * @brief Real milliseconds until the partial chair's deadline.
+ *
+ * In cadence mode: until the platform chair leaves, empty or not.
+ *
+ * @return -1 if no chair is being filled, otherwise >= 1.
+ */
+static int fill_wait_ms(IPCResources *res) {
+    if (g_pending_count == 0 && res->state->cfg.chair_interval_sim == 0) {
+        return -1;
+    }
+    int64_t left_sim = g_fill_deadline_sim_ms - time_get_sim_ms(res->state);
+    int ms = (int)(time_sim_ms_to_real_ms(res->state, left_sim) + 0.999);
+    return ms > 0 ? ms : 1;
+}
+
 /**
  * @brief Get the appropriate logging tag for a tourist based on type.
  *
@@ -54,23 +128,46 @@ static const char *get_tourist_tag(TouristType type) {
 // Use macro-generated signal handler for emergency-capable workers
 DEFINE_EMERGENCY_SIGNAL_HANDLER(signal_handler, "LOWER_WORKER")
 
+/**
+ * @brief Record a detected danger and stop the line.
+ *
+ * @param res IPC resources for emergency coordination.
+ * @param sim_ms Sim ms since midnight of the detection.
+ */
+static void trigger_danger(IPCResources *res, int64_t sim_ms) {
+    danger_schedule_record(res->state, res->line, WORKER_LOWER, sim_ms);
+    trace_emit(TRACE_SRC_LOWER, TRACE_DANGER_DETECTED, 0, 0, -1, res->line);
+    worker_trigger_emergency_stop(res, WORKER_LOWER, &g_emergency_state);
+}
+
 /**
  * @brief Check for random danger and trigger emergency stop if detected.
  *
- * Uses pause-adjusted time for cooldown calculation.
+ * Uses pause-adjusted time for cooldown calculation. With DANGER_SCHEDULE=2
+ * the recorded stops replace the random draw.
  *
  * @param res IPC resources for emergency coordination.
  * @return 1 if danger was detected, 0 otherwise.
  */
 static int check_for_danger(IPCResources *res) {
-    int probability = res->state->danger_probability;
+    if (res->state->cfg.danger_schedule == DANGER_SCHEDULE_REPLAY) {
+        int64_t now_ms = time_get_sim_ms(res->state);
+        if (!danger_schedule_due(res->state, res->line, WORKER_LOWER, &g_danger_cursor, now_ms)) {
+            return 0;
+        }
+        g_last_danger_time_sim = (double)now_ms / 60000.0;
+        trigger_danger(res, now_ms);
+        return 1;
+    }
+
+    int probability = res->state->cfg.danger_probability;
     if (probability <= 0) {
         return 0;  // Danger detection disabled
     }
 
     // Check if still within duration of previous danger (can't trigger new one)
     double now_sim = time_get_sim_minutes_f(res->state);
-    int duration_sim = res->state->danger_duration_sim;
+    int duration_sim = res->state->cfg.danger_duration_sim;
 
     if (g_last_danger_time_sim > 0) {
         if ((now_sim - g_last_danger_time_sim) < duration_sim) {
@@ -79,75 +176,364 @@ static int check_for_danger(IPCResources *res) {
     }
 
     // Random check
-    if ((rand() % 100) < probability) {
+    if (rng_below(&g_rng, 100) < probability) {
         g_last_danger_time_sim = now_sim;  // Store simulated time
-        worker_trigger_emergency_stop(res, WORKER_LOWER, &g_emergency_state);
+        trigger_danger(res, time_get_sim_ms(res->state));
         return 1;
     }
     return 0;
 }
 
 /**
- * @brief Dispatch the current chair with all buffered tourists.
+ * @brief Send one chair off with its riders.
  *
- * Acquires a chair slot, then sends boarding confirmations to all buffered
- * tourists with the same departure_time so they arrive together.
- * The upper_worker releases the chair slot when all tourists have arrived.
+ * Acquires a chair slot, then confirms boarding for all riders with one
+ * chair record (same departure_ns so they arrive together). The chair is
+ * registered in the shared chair tracker first; the upper_worker releases
+ * the chair slot when all tourists have arrived. Cadence departures take no
+ * chair slot: the ring's spacing already bounds the chairs going up.
  *
  * @param res IPC resources for semaphores and message queues.
- * @param chair_number Chair identifier for logging.
+ * @param chair_number Chair ID (1..TOTAL_CHAIRS) for tracking and logging.
+ * @param members Tourist IDs on the chair.
+ * @param tourists_on_chair Riders (groups) on the chair.
  * @param slots_used Total slots used on this chair.
+ * @return 0 once dispatched, -1 if interrupted by shutdown.
  */
-static void dispatch_chair(IPCResources *res, int chair_number, int slots_used) {
+static int depart_chair(IPCResources *res, int chair_number, const int *members,
+                        int tourists_on_chair, int slots_used) {
+    LineState *line = ipc_line_state(res);
+    if (res->state->cfg.chair_interval_sim > 0) {
+        log_info(g_tag, "Chair %d departed with %d tourists (%d/%d slots) [ring departure %u]",
+                 chair_number, tourists_on_chair, slots_used, CHAIR_CAPACITY,
+                 line->ring_departures + 1);
+    } else {
+        // Acquire chair slot (blocks if 36 chairs already in transit)
+        if (sem_wait_pauseable(res, SEM_CHAIRS, 1) == -1) {
+            return -1;  // Interrupted/shutdown
+        }
+
+        // Get available chairs count after acquiring (for logging)
+        int chairs_available = sem_getval(res->sem_id, SEM_CHAIRS);
+
+        log_info(g_tag, "Chair %d departed with %d tourists (%d/%d slots) [chairs available: %d/%d]",
+                 chair_number, tourists_on_chair, slots_used, CHAIR_CAPACITY,
+                 chairs_available, MAX_CHAIRS_IN_TRANSIT);
+    }
+
+    int64_t departure_ns = time_elapsed_ns(res->state);
+
+    // Confirm boarding for all buffered tourists (one chair record)
+    ChairDispatch chair;
+    memset(&chair, 0, sizeof(chair));
+    chair.chair_id = chair_number;
+    chair.dispatch_seq = chair_tracker_register(line->chair_tracks, &line->chair_dispatch_seq,
+                                                chair_number, tourists_on_chair);
+    chair.departure_ns = departure_ns;
+    chair.count = tourists_on_chair;
+    for (int i = 0; i < tourists_on_chair; i++) {
+        chair.members[i] = members[i];
+    }
+    __atomic_add_fetch(&line->chairs_departed, 1, __ATOMIC_RELAXED);
+    __atomic_add_fetch(&line->chair_slots_departed, (uint32_t)slots_used, __ATOMIC_RELAXED);
+    trace_emit(TRACE_SRC_LOWER, TRACE_CHAIR_DEPARTED, 0, chair_number, -1, tourists_on_chair);
+
+    if (transport_chair_dispatch(res, &chair) == -1) {
+        // EINVAL can occur during shutdown when queue is being destroyed
+        if (errno != EINTR && errno != EIDRM && errno != EINVAL) {
+            perror("lower_worker: msgsnd boarding dispatch");
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Dispatch the current chair with all buffered tourists.
+ *
+ * @param res IPC resources for semaphores and message queues.
+ * @param chair_number Chair ID (1..TOTAL_CHAIRS) for tracking and logging.
+ * @param slots_used Total slots used on this chair.
+ * @return 0 once dispatched (or nothing to send), -1 if interrupted by shutdown.
+ */
+static int dispatch_chair(IPCResources *res, int chair_number, int slots_used) {
     if (g_pending_count == 0) {
-        return;  // No tourists to dispatch
+        return 0;  // No tourists to dispatch
+    }
+
+    int members[MAX_PENDING_PER_CHAIR];
+    for (int i = 0; i < g_pending_count; i++) {
+        members[i] = g_pending[i].tourist_id;
+    }
+    if (depart_chair(res, chair_number, members, g_pending_count, slots_used) == -1) {
+        return -1;
+    }
+
+    g_pending_count = 0;
+    g_fill_deadline_sim_ms = 0;
+    if (g_fill_timer_armed) {
+        set_fill_timer(0);
+    }
+    return 0;
+}
+
+/**
+ * @brief Log one group taking its seats on a chair.
+ *
+ * @param msg Platform request of the group.
+ * @param chair_number Chair the group boarded.
+ * @param chair_slots Slots used on the chair after boarding.
+ */
+static void log_boarded(const PlatformMsg *msg, int chair_number, int chair_slots) {
+    const char *tag = get_tourist_tag(msg->tourist_type);
+    const char *type_names[] = {"walker", "cyclist", "family"};
+    const char *type_name = type_names[msg->tourist_type];
+    if (msg->kid_count > 0) {
+        log_info(tag, "Tourist %d (%s) + %d kid(s) (%d slots) boarded chair %d [%d/%d slots]",
+                 msg->tourist_id, type_name, msg->kid_count, msg->slots_needed,
+                 chair_number, chair_slots, CHAIR_CAPACITY);
+    } else {
+        log_info(tag, "Tourist %d (%s, %d slots) boarded chair %d [%d/%d slots]",
+                 msg->tourist_id, type_name, msg->slots_needed,
+                 chair_number, chair_slots, CHAIR_CAPACITY);
     }
+}
 
-    // Acquire chair slot (blocks if 36 chairs already in transit)
-    if (sem_wait_pauseable(res, SEM_CHAIRS, 1) == -1) {
-        return;  // Interrupted/shutdown
+/**
+ * @brief Seat a group on the chair being loaded (FIFO loader).
+ *
+ * @param msg Platform request of the group.
+ * @param chair_number Chair being loaded.
+ * @param chair_slots In/out: slots used on it.
+ */
+static void pending_board(const PlatformMsg *msg, int chair_number, int *chair_slots) {
+    if (g_pending_count < MAX_PENDING_PER_CHAIR) {
+        g_pending[g_pending_count].tourist_id = msg->tourist_id;
+        g_pending[g_pending_count].slots_needed = msg->slots_needed;
+        g_pending_count++;
     }
+    *chair_slots += msg->slots_needed;
+    log_boarded(msg, chair_number, *chair_slots);
+}
 
-    // Get available chairs count after acquiring (for logging)
-    int chairs_available = sem_getval(res->sem_id, SEM_CHAIRS);
+/**
+ * @brief Send off the chair at the platform, full or empty, and move the rope on.
+ *
+ * A group held back for lack of room boards the chair that comes round.
+ *
+ * @param res IPC resources (this worker's line).
+ * @param chair_slots In/out: slots used on the platform chair.
+ * @return 0 once departed, -1 if interrupted by shutdown.
+ */
+static int ring_depart(IPCResources *res, int *chair_slots) {
+    LineState *line = ipc_line_state(res);
+    int chair_number = chair_ring_platform_chair(line);
+    int riders = g_pending_count;
+
+    if (riders > 0) {
+        if (dispatch_chair(res, chair_number, *chair_slots) == -1) {
+            return -1;
+        }
+    } else {
+        __atomic_add_fetch(&line->chairs_departed, 1, __ATOMIC_RELAXED);
+        trace_emit(TRACE_SRC_LOWER, TRACE_CHAIR_DEPARTED, 0, chair_number, -1, 0);
+        log_debug(g_tag, "Chair %d departed empty", chair_number);
+    }
+    chair_ring_depart(line, g_ring_transit, *chair_slots, riders);
+    *chair_slots = 0;
 
-    time_t departure_time = time(NULL);
-    int tourists_on_chair = g_pending_count;
+    if (g_held_valid) {
+        g_held_valid = 0;
+        pending_board(&g_held, chair_ring_platform_chair(line), chair_slots);
+    }
+    return 0;
+}
 
-    log_info("LOWER_WORKER", "Chair %d departed with %d tourists (%d/%d slots) [chairs available: %d/%d]",
-             chair_number, tourists_on_chair, slots_used, CHAIR_CAPACITY,
-             chairs_available, MAX_CHAIRS_IN_TRANSIT);
+/**
+ * @brief Send off every chair whose departure time has passed (cadence mode).
+ *
+ * After a start or an emergency stop the rope restarts on the next interval
+ * boundary instead of catching up. A worker more than a full lap behind
+ * restarts the same way.
+ *
+ * @param res IPC resources (this worker's line).
+ * @param chair_slots In/out: slots used on the platform chair.
+ * @param interval_ms Sim ms between departures.
+ * @return 0 on success, -1 if interrupted by shutdown.
+ */
+static int ring_step(IPCResources *res, int *chair_slots, int64_t interval_ms) {
+    int64_t now = time_get_sim_ms(res->state);
+    if (g_ring_rebase) {
+        g_fill_deadline_sim_ms = (now / interval_ms + 1) * interval_ms;
+        g_ring_rebase = 0;
+        return 0;
+    }
 
-    // Send boarding confirmations to all buffered tourists
-    for (int i = 0; i < g_pending_count; i++) {
-        PlatformMsg response;
-        memset(&response, 0, sizeof(response));
-        response.mtype = g_pending[i].tourist_id;
-        response.tourist_id = g_pending[i].tourist_id;
-        response.departure_time = departure_time;
-        response.chair_id = chair_number;
-        response.tourists_on_chair = tourists_on_chair;
-
-        if (msgsnd(res->mq_boarding_id, &response, sizeof(response) - sizeof(long), 0) == -1) {
-            // EINVAL can occur during shutdown when queue is being destroyed
-            if (errno != EINTR && errno != EIDRM && errno != EINVAL) {
-                perror("lower_worker: msgsnd boarding dispatch");
+    for (int n = 0; now >= g_fill_deadline_sim_ms; n++) {
+        if (n == TOTAL_CHAIRS) {
+            g_ring_rebase = 1;
+            return 0;
+        }
+        int64_t due = g_fill_deadline_sim_ms;
+        if (ring_depart(res, chair_slots) == -1) {
+            return -1;
+        }
+        g_fill_deadline_sim_ms = due + interval_ms;  // dispatch_chair cleared it
+    }
+    return 0;
+}
+
+/**
+ * @brief Choose the window request to seat next on a chair with free_slots left.
+ *
+ * An empty chair always takes the oldest request, so a request passed over
+ * by the packing boards within as many chairs as there are requests ahead
+ * of it. Otherwise best fit: the largest group that still fits, the oldest
+ * one on ties.
+ *
+ * @param free_slots Slots still free on the chair being loaded.
+ * @return Window index, or -1 if no waiting group fits.
+ */
+static int window_pick(int free_slots) {
+    if (g_window_count == 0) {
+        return -1;
+    }
+    if (free_slots == CHAIR_CAPACITY) {
+        return 0;
+    }
+    int best = -1;
+    for (int i = 0; i < g_window_count; i++) {
+        int slots = g_window[i].slots_needed;
+        if (slots <= free_slots && (best == -1 || slots > g_window[best].slots_needed)) {
+            best = i;
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Seat window requests on the current chair until nothing more fits.
+ *
+ * The window was topped up from the queue first, so a group that does not
+ * fit means nothing waiting fits: the partial chair departs and the group
+ * heads the next one. A full chair departs at once. With the window empty a
+ * partial chair waits for more requests or the 100ms poll tick, as in FIFO
+ * loading.
+ *
+ * @param res IPC resources.
+ * @param chair_number In/out: chair being loaded.
+ * @param chair_slots In/out: slots used on it.
+ * @return 0 when nothing more fits, -1 on shutdown.
+ */
+static int window_load(IPCResources *res, int *chair_number, int *chair_slots) {
+    while (g_running) {
+        int idx = window_pick(CHAIR_CAPACITY - *chair_slots);
+        if (idx == -1) {
+            if (g_window_count == 0) {
+                return 0;
+            }
+            // Nothing waiting fits: the partial chair leaves
+        } else {
+            PlatformMsg *msg = &g_window[idx];
+            g_pending[g_pending_count].tourist_id = msg->tourist_id;
+            g_pending[g_pending_count].slots_needed = msg->slots_needed;
+            g_pending_count++;
+            *chair_slots += msg->slots_needed;
+            log_boarded(msg, *chair_number, *chair_slots);
+
+            g_window_count--;
+            memmove(&g_window[idx], &g_window[idx + 1],
+                    (size_t)(g_window_count - idx) * sizeof(g_window[0]));
+            if (*chair_slots < CHAIR_CAPACITY) {
+                continue;
             }
-            break;  // Stop trying to send if queue is gone
         }
+
+        if (dispatch_chair(res, *chair_number, *chair_slots) == -1) {
+            return -1;
+        }
+        *chair_slots = 0;
+        *chair_number = chair_tracker_next_id(ipc_line_state(res)->chair_tracks, *chair_number);
     }
+    return -1;
+}
 
-    g_pending_count = 0;
+/**
+ * @brief Send off the chair this worker closed and open the next one.
+ *
+ * The next chair opens before this one waits for SEM_CHAIRS, so the other
+ * boarding workers keep loading while it departs.
+ *
+ * @param res IPC resources (this worker's line).
+ */
+static void assembler_dispatch(IPCResources *res) {
+    LineState *line = ipc_line_state(res);
+    int members[CHAIR_CAPACITY];
+    int chair_number = 0;
+    int slots_used = 0;
+
+    int count = chair_assembler_take(&line->assembler, &chair_number, members, &slots_used);
+    chair_assembler_open(&line->assembler, chair_tracker_next_id(line->chair_tracks, chair_number));
+    if (count > 0) {
+        depart_chair(res, chair_number, members, count, slots_used);
+    }
+}
+
+/**
+ * @brief Dispatch the partially filled chair on a poll timeout or at shutdown.
+ *
+ * @param res IPC resources (this worker's line).
+ */
+static void assembler_flush(IPCResources *res) {
+    if (chair_assembler_close(&ipc_line_state(res)->assembler)) {
+        assembler_dispatch(res);
+    }
+}
+
+/**
+ * @brief Board one platform request through the line's chair assembler.
+ *
+ * A group that does not fit closes the partial chair, sends it off and then
+ * boards the next chair, without the requeue round trip.
+ *
+ * @param res IPC resources (this worker's line).
+ * @param msg Platform request.
+ * @return 0 once boarded, -1 on shutdown.
+ */
+static int assembler_board(IPCResources *res, const PlatformMsg *msg) {
+    ChairAssembler *a = &ipc_line_state(res)->assembler;
+
+    while (g_running && control_running(res->state)) {
+        ChairClaim claim;
+        ChairClaimResult rc = chair_assembler_claim(a, msg->tourist_id, msg->slots_needed, &claim);
+        if (rc == CHAIR_CLAIM_BUSY) {
+            chair_assembler_wait(a, claim.epoch, SHM_WAIT_TIMEOUT_MS);
+            continue;
+        }
+        if (rc == CHAIR_CLAIM_NO_FIT) {
+            assembler_dispatch(res);
+            continue;
+        }
+
+        log_boarded(msg, claim.chair_id, claim.slots_used);
+        if (rc == CHAIR_CLAIM_FILLED) {
+            assembler_dispatch(res);
+        }
+        return 0;
+    }
+    return -1;
 }
 
 /**
  * @brief Lower platform worker process entry point.
  *
  * Manages tourist boarding onto chairlift. Buffers tourists until chair is full
- * or queue is empty, then dispatches. Handles emergency stops and random danger
- * detection.
+ * or queue is empty, then dispatches. With BOARDING_WINDOW > 0 it packs chairs
+ * best-fit from a window of waiting requests instead of requeueing misfits.
+ * With BOARDING_WORKERS > 1 it fills the
+ * line's shared chair assembler together with the boarding workers instead.
+ * Handles emergency stops and random danger detection.
  *
- * @param res IPC resources (message queues, semaphores, shared memory).
+ * @param res IPC resources (message queues, semaphores, shared memory), set to this worker's line.
  * @param keys IPC keys (unused, kept for interface consistency).
  */
 void lower_worker_main(IPCResources *res, IPCKeys *keys) {
@@ -156,10 +542,11 @@ void lower_worker_main(IPCResources *res, IPCKeys *keys) {
     // Initialize emergency state pointers
     g_emergency_state.is_initiator = &g_is_emergency_initiator;
     g_emergency_state.start_time_sim = &g_emergency_start_time_sim;
+    g_tag = worker_log_tag(res, WORKER_LOWER);
 
     // Initialize logger with component type
     logger_init(res->state, LOG_LOWER_WORKER);
-    logger_set_debug_enabled(res->state->debug_logs_enabled);
+    logger_set_debug_enabled(res->state->cfg.debug_logs_enabled);
 
     // Install signal handlers
     struct sigaction sa;
@@ -173,24 +560,50 @@ void lower_worker_main(IPCResources *res, IPCKeys *keys) {
     sigaction(SIGALRM, &sa, NULL);
 
     // Seed random number generator for danger detection
-    srand((unsigned int)(time(NULL) ^ getpid()));
+    rng_seed(&g_rng, rng_base_seed(res->state->cfg.random_seed), RNG_STREAM_LOWER_WORKER + res->line);
+
+    numa_bind_line_worker(res, g_tag);
+
+    // Counted on the virtual clock from here until the process exits
+    time_participant_join(res->state);
 
     // Signal that this worker is ready (startup barrier)
     if (ipc_signal_worker_ready(res) == -1) {
-        log_error("LOWER_WORKER", "Failed to signal ready, exiting");
+        log_error(g_tag, "Failed to signal ready, exiting");
         return;
     }
-    log_info("LOWER_WORKER", "Lower platform worker ready");
+    log_info(g_tag, "Lower platform worker ready");
 
     int current_chair_slots = 0;  // Slots used on current chair being loaded
-    int chair_number = 1;         // For logging (1-indexed for user-friendliness)
+    int chair_number = 1;         // Chair ID being loaded (1-indexed, skips chairs in transit)
+
+    // Deadline mode: a partial chair leaves CHAIR_FILL_DEADLINE_SIM_SECONDS
+    // (sim time, so pauses stop it) after its first tourist boarded, instead
+    // of on the next 100ms SIGALRM tick.
+    int deadline_mode = res->state->cfg.chair_fill_deadline_sim > 0;
+    int64_t fill_window_sim_ms = (int64_t)res->state->cfg.chair_fill_deadline_sim * 1000;
+    int sysv_queues = res->state->cfg.queue_transport != QUEUE_TRANSPORT_SHM;
+    int assembler = res->state->cfg.boarding_workers > 1;
+    int window_size = res->state->cfg.boarding_window;
+    int cadence = res->state->cfg.chair_interval_sim > 0;
+    int64_t interval_sim_ms = (int64_t)res->state->cfg.chair_interval_sim * 1000;
+    if (cadence) {
+        g_ring_transit = chair_ring_transit(&res->state->cfg);
+        log_info(g_tag, "Chair ring: one chair every %d sim seconds, %d chairs going up",
+                 res->state->cfg.chair_interval_sim, g_ring_transit);
+    }
+    if (deadline_mode) {
+        log_info(g_tag, "Deadline dispatcher: partial chairs leave after %d sim seconds",
+                 res->state->cfg.chair_fill_deadline_sim);
+    }
 
-    while (g_running && res->state->running) {
+    while (g_running && control_running(res->state)) {
         // Handle SIGUSR1 - emergency stop from upper worker
         if (g_emergency_signal) {
             g_emergency_signal = 0;
             // Receiving worker: acknowledge and wait (blocks until resume)
             worker_acknowledge_emergency_stop(res, WORKER_LOWER, &g_emergency_state);
+            g_ring_rebase = 1;  // The rope stood still
             continue;  // After resume, continue main loop
         }
 
@@ -198,75 +611,125 @@ void lower_worker_main(IPCResources *res, IPCKeys *keys) {
         if (g_resume_signal) {
             g_resume_signal = 0;
             // Resume signal received - logging only, actual resume handled by semaphores
-            log_debug("LOWER_WORKER", "Resume signal (SIGUSR2) received");
+            log_debug(g_tag, "Resume signal (SIGUSR2) received");
         }
 
         // Check if we're the emergency initiator and need to wait for duration
         if (g_is_emergency_initiator && g_emergency_start_time_sim > 0) {
             // Use simulated time for duration (already accounts for pause)
             double now_sim = time_get_sim_minutes_f(res->state);
-            int duration_sim = res->state->danger_duration_sim;
+            int duration_sim = res->state->cfg.danger_duration_sim;
 
+            g_ring_rebase = 1;
             if ((now_sim - g_emergency_start_time_sim) >= duration_sim) {
                 // Duration passed - initiate resume
                 worker_initiate_resume(res, WORKER_LOWER, &g_emergency_state);
+            } else if (deadline_mode || cadence) {
+                // Still in cooldown - sleep 100ms (signals cut it short)
+                if (g_fill_timer_armed) {
+                    set_fill_timer(0);  // Re-armed from the deadline afterwards
+                }
+                struct timespec ts = {0, 100000000L};
+                nanosleep(&ts, NULL);
             } else {
                 // Still in cooldown - wait with SIGALRM timeout (100ms)
-                ualarm(100000, 0);
+                time_alarm_us(res->state, 100000);
+                time_wait_begin();
                 pause();  // Interrupted by SIGALRM or other signals
-                ualarm(0, 0);
+                time_wait_end();
+                time_alarm_us(res->state, 0);
             }
             continue;
         }
 
         // Check emergency_stop (for re-entry after signal interrupts)
-        if (sem_wait(res->sem_id, SEM_STATE, 1) == -1) {
-            continue;  // Check loop condition on failure
-        }
-        int emergency = res->state->emergency_stop;
-        sem_post(res->sem_id, SEM_STATE, 1);
+        int emergency = control_emergency_stop(res->state, res->line);
 
         if (emergency) {
             // Emergency is active but we're not the initiator - acknowledge and wait
             worker_acknowledge_emergency_stop(res, WORKER_LOWER, &g_emergency_state);
+            g_ring_rebase = 1;
             continue;
         }
 
-        // msgrcv with -2 returns lowest mtype first (1=VIP before 2=regular)
-        // Use blocking msgrcv with SIGALRM timeout for periodic chair dispatch
+        // Receive lowest mtype first (1=VIP/requeued before 2=regular)
         PlatformMsg msg;
-        ualarm(100000, 0);  // 100ms timeout for periodic dispatch
-        ssize_t ret = msgrcv(res->mq_platform_id, &msg, sizeof(msg) - sizeof(long), -2, 0);
-        ualarm(0, 0);  // Cancel alarm if message received
+        int ret;
+        if (cadence) {
+            // Chairs leave on the interval, full or not
+            if (ring_step(res, &current_chair_slots, interval_sim_ms) == -1) {
+                break;
+            }
+            int wait_ms = fill_wait_ms(res);
+            if (sysv_queues) {
+                arm_fill_timer(wait_ms);
+            }
+            if (g_held_valid || current_chair_slots >= CHAIR_CAPACITY) {
+                // No room left on the platform chair: wait for it to leave
+                struct timespec ts = {wait_ms / 1000, (long)(wait_ms % 1000) * 1000000L};
+                nanosleep(&ts, NULL);
+                continue;
+            }
+            ret = transport_platform_recv_timeout(res, &msg, wait_ms);
+            if (ret == -1 && (errno == ETIMEDOUT || errno == EINTR)) {
+                continue;  // Departure re-checked at the top of the loop
+            }
+        } else if (deadline_mode) {
+            // Partial chair past its deadline leaves now
+            if (g_pending_count > 0 && time_get_sim_ms(res->state) >= g_fill_deadline_sim_ms) {
+                dispatch_chair(res, chair_number, current_chair_slots);
+                current_chair_slots = 0;
+                chair_number = chair_tracker_next_id(ipc_line_state(res)->chair_tracks, chair_number);
+                continue;
+            }
+
+            // Wake at the deadline or on the next request, whichever is first
+            int wait_ms = fill_wait_ms(res);
+            if (sysv_queues) {
+                arm_fill_timer(wait_ms);
+            }
+            ret = transport_platform_recv_timeout(res, &msg, wait_ms);
+            if (ret == -1 && (errno == ETIMEDOUT || errno == EINTR)) {
+                continue;  // Deadline re-checked at the top of the loop
+            }
+        } else {
+            // Use blocking receive with SIGALRM timeout for periodic chair dispatch
+            time_alarm_us(res->state, 100000);  // 100ms timeout for periodic dispatch
+            ret = transport_platform_recv(res, &msg);
+            time_alarm_us(res->state, 0);  // Cancel alarm if message received
+        }
 
         if (ret == -1) {
             if (errno == EINTR) {
                 // Interrupted by signal (SIGALRM or other) - dispatch any pending chair
-                if (g_pending_count > 0) {
-                    dispatch_chair(res, chair_number, current_chair_slots);
+                if (assembler) {
+                    assembler_flush(res);
+                } else if (g_pending_count > 0 &&
+                           dispatch_chair(res, chair_number, current_chair_slots) == 0) {
                     current_chair_slots = 0;
-                    chair_number = (chair_number % TOTAL_CHAIRS) + 1;
+                    chair_number = chair_tracker_next_id(ipc_line_state(res)->chair_tracks, chair_number);
+                    // Seat the requests the departed chair had no room for
+                    if (window_size > 0 &&
+                        window_load(res, &chair_number, &current_chair_slots) == -1) {
+                        break;
+                    }
                 }
                 continue;
             }
             if (errno == EIDRM) {
-                log_debug("LOWER_WORKER", "Platform queue removed, exiting");
+                log_debug(g_tag, "Platform queue removed, exiting");
                 break;
             }
             perror("lower_worker: msgrcv platform");
             continue;
         }
 
-        if (sem_wait(res->sem_id, SEM_STATE, 1) == -1) {
-            continue;  // Check loop condition on failure
-        }
-        emergency = res->state->emergency_stop;
-        sem_post(res->sem_id, SEM_STATE, 1);
+        emergency = control_emergency_stop(res->state, res->line);
 
         if (emergency) {
             // Put tourist back in queue with high priority
             msg.mtype = 1;
-            if (msgsnd(res->mq_platform_id, &msg, sizeof(msg) - sizeof(long), 0) == -1) {
+            if (transport_platform_send(res, &msg, 0) == -1) {
                 if (errno != EINTR && errno != EIDRM) {
                     perror("lower_worker: msgsnd requeue emergency");
                 }
@@ -274,8 +737,37 @@ void lower_worker_main(IPCResources *res, IPCKeys *keys) {
             continue;
         }
 
+        if (assembler) {
+            if (assembler_board(res, &msg) == -1) {
+                break;
+            }
+            check_for_danger(res);
+            continue;
+        }
+
+        if (window_size > 0) {
+            // Look ahead: top the window up with whatever is already waiting, then pack
+            g_window[g_window_count++] = msg;
+            while (g_window_count < window_size &&
+                   transport_platform_try_recv(res, &g_window[g_window_count]) == 0) {
+                g_window_count++;
+            }
+            if (window_load(res, &chair_number, &current_chair_slots) == -1) {
+                break;
+            }
+            check_for_danger(res);
+            continue;
+        }
+
         int slots_needed = msg.slots_needed;
 
+        // Cadence: a group that does not fit waits for the next chair round
+        if (cadence && current_chair_slots + slots_needed > CHAIR_CAPACITY) {
+            g_held = msg;
+            g_held_valid = 1;
+            continue;
+        }
+
         // Check if tourist fits on current chair
         if (current_chair_slots + slots_needed > CHAIR_CAPACITY) {
             // Doesn't fit - dispatch current chair with buffered tourists, start new one
@@ -283,13 +775,13 @@ void lower_worker_main(IPCResources *res, IPCKeys *keys) {
                 dispatch_chair(res, chair_number, current_chair_slots);
             }
             current_chair_slots = 0;
-            chair_number = (chair_number % TOTAL_CHAIRS) + 1;
+            chair_number = chair_tracker_next_id(ipc_line_state(res)->chair_tracks, chair_number);
 
             // Put tourist back in queue with high priority
             msg.mtype = 1;  // VIP priority so they're next
-            if (msgsnd(res->mq_platform_id, &msg, sizeof(msg) - sizeof(long), 0) == -1) {
+            if (transport_platform_send(res, &msg, 0) == -1) {
                 if (errno == EIDRM) {
-                    log_debug("LOWER_WORKER", "Platform queue removed during requeue");
+                    log_debug(g_tag, "Platform queue removed during requeue");
                     break;
                 }
                 if (errno != EINTR) {
@@ -300,32 +792,17 @@ void lower_worker_main(IPCResources *res, IPCKeys *keys) {
         }
 
         // Tourist fits - buffer them (don't send confirmation yet)
-        if (g_pending_count < MAX_PENDING_PER_CHAIR) {
-            g_pending[g_pending_count].tourist_id = msg.tourist_id;
-            g_pending[g_pending_count].slots_needed = slots_needed;
-            g_pending_count++;
-        }
-
-        current_chair_slots += slots_needed;
-
-        const char *tag = get_tourist_tag(msg.tourist_type);
-        const char *type_names[] = {"walker", "cyclist", "family"};
-        const char *type_name = type_names[msg.tourist_type];
-        if (msg.kid_count > 0) {
-            log_info(tag, "Tourist %d (%s) + %d kid(s) (%d slots) boarded chair %d [%d/%d slots]",
-                     msg.tourist_id, type_name, msg.kid_count, slots_needed,
-                     chair_number, current_chair_slots, CHAIR_CAPACITY);
-        } else {
-            log_info(tag, "Tourist %d (%s, %d slots) boarded chair %d [%d/%d slots]",
-                     msg.tourist_id, type_name, slots_needed,
-                     chair_number, current_chair_slots, CHAIR_CAPACITY);
+        if (g_pending_count == 0 && deadline_mode) {
+            g_fill_deadline_sim_ms = time_get_sim_ms(res->state) + fill_window_sim_ms;
         }
+        pending_board(&msg, cadence ? chair_ring_platform_chair(ipc_line_state(res)) : chair_number,
+                      &current_chair_slots);
 
-        // If chair is full, dispatch and reset
-        if (current_chair_slots >= CHAIR_CAPACITY) {
+        // If chair is full, dispatch and reset (cadence chairs wait for their time)
+        if (!cadence && current_chair_slots >= CHAIR_CAPACITY) {
             dispatch_chair(res, chair_number, current_chair_slots);
             current_chair_slots = 0;
-            chair_number = (chair_number % TOTAL_CHAIRS) + 1;
+            chair_number = chair_tracker_next_id(ipc_line_state(res)->chair_tracks, chair_number);
         }
 
         // Check for random danger after each boarding
@@ -333,9 +810,106 @@ void lower_worker_main(IPCResources *res, IPCKeys *keys) {
     }
 
     // Dispatch any remaining pending tourists before shutdown
-    if (g_pending_count > 0) {
+    if (assembler) {
+        assembler_flush(res);
+    } else if (cadence) {
+        while ((g_pending_count > 0 || g_held_valid) &&
+               ring_depart(res, &current_chair_slots) == 0) {
+        }
+    } else if (g_pending_count > 0) {
         dispatch_chair(res, chair_number, current_chair_slots);
     }
 
-    log_info("LOWER_WORKER", "Lower platform worker shutting down");
+    log_info(g_tag, "Lower platform worker shutting down");
+}
+
+/**
+ * @brief Extra boarding worker process entry point (BOARDING_WORKERS > 1).
+ *
+ * Pops its line's platform requests and boards them through the shared chair
+ * assembler alongside the lower worker. Danger detection and the emergency
+ * protocol stay with the lower worker: during an emergency stop a request
+ * goes back to the queue (priority) and the worker waits for the stop to
+ * clear like a tourist.
+ *
+ * @param res IPC resources, set to this worker's line.
+ * @param keys IPC keys (unused, kept for interface consistency).
+ */
+void boarding_worker_main(IPCResources *res, IPCKeys *keys) {
+    (void)keys;
+
+    static char tag[32];
+    if (res->line == 0) {
+        snprintf(tag, sizeof(tag), "BOARDING_WORKER");
+    } else {
+        snprintf(tag, sizeof(tag), "BOARDING_WORKER_%d", res->line);
+    }
+    g_tag = tag;
+
+    logger_init(res->state, LOG_LOWER_WORKER);
+    logger_set_debug_enabled(res->state->cfg.debug_logs_enabled);
+
+    struct sigaction sa;
+    sa.sa_handler = signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGALRM, &sa, NULL);
+
+    numa_bind_line_worker(res, g_tag);
+
+    // Counted on the virtual clock from here until the process exits
+    time_participant_join(res->state);
+
+    // Signal that this worker is ready (startup barrier)
+    if (ipc_signal_worker_ready(res) == -1) {
+        log_error(g_tag, "Failed to signal ready, exiting");
+        return;
+    }
+    log_info(g_tag, "Boarding worker ready (PID %d)", getpid());
+
+    while (g_running && control_running(res->state)) {
+        if (control_emergency_stop(res->state, res->line)) {
+            ipc_wait_emergency_clear(res);
+            continue;
+        }
+
+        // Same 100ms SIGALRM poll as the lower worker for partial chairs
+        PlatformMsg msg;
+        time_alarm_us(res->state, 100000);
+        int ret = transport_platform_recv(res, &msg);
+        time_alarm_us(res->state, 0);
+
+        if (ret == -1) {
+            if (errno == EINTR) {
+                assembler_flush(res);
+                continue;
+            }
+            if (errno == EIDRM) {
+                log_debug(g_tag, "Platform queue removed, exiting");
+                break;
+            }
+            perror("boarding_worker: msgrcv platform");
+            continue;
+        }
+
+        if (control_emergency_stop(res->state, res->line)) {
+            // Put tourist back in queue with high priority
+            msg.mtype = 1;
+            if (transport_platform_send(res, &msg, 0) == -1) {
+                if (errno != EINTR && errno != EIDRM) {
+                    perror("boarding_worker: msgsnd requeue emergency");
+                }
+            }
+            continue;
+        }
+
+        if (assembler_board(res, &msg) == -1) {
+            break;
+        }
+    }
+
+    assembler_flush(res);
+    log_info(g_tag, "Boarding worker shutting down");
 }
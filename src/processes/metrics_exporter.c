@@ -0,0 +1,340 @@
+/**
+ * @file metrics_exporter.c
+ * @brief Metrics exporter process - live counters as a Prometheus text file.
+ *
+ * Every METRICS_INTERVAL_MS the exporter reads SharedState counters,
+ * semaphore values and queue depths and rewrites METRICS_FILE_NAME
+ * (write to a temporary file, then rename(), so a scraper such as the
+ * node_exporter textfile collector never sees a half-written file).
+ *
+ * It never takes SEM_STATE or any other semaphore: the run flags come from
+ * one control_snapshot(), the clock from time_get_sim_ms(), counters are read with plain atomic loads
+ * and summed over every line. Writers do not publish a version, so the counter block
+ * is read twice and re-read (up to METRICS_SNAPSHOT_RETRIES times) until two
+ * consecutive passes agree; the tourist hot path does no extra work.
+ *
+ * Main stops the exporter only after every other worker has exited, so the
+ * last snapshot written holds the final totals.
+ */
+
+#include "constants.h"
+#include "ipc/ipc.h"
+#include "ipc/transport.h"
+#include "ipc/queue_stats.h"
+#include "ipc/control.h"
+#include "core/logger.h"
+#include "core/stats.h"
+#include "core/latency.h"
+#include "core/time_sim.h"
+#include "common/signal_common.h"
+
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/msg.h>
+#include <time.h>
+#include <unistd.h>
+
+static int g_running = 1;
+
+DEFINE_BASIC_SIGNAL_HANDLER(signal_handler)
+
+/**
+ * @brief Counters that must be read as one consistent set.
+ */
+typedef struct {
+    StatsSnapshot stats;
+    int lower_station_count;
+    int tourists_on_chairs;
+    uint32_t chairs_dispatched;
+    uint32_t chair_slots_departed;
+    uint64_t wait_count[LAT_STAGE_COUNT];
+    uint64_t wait_sum_us[LAT_STAGE_COUNT];
+} MetricsCounters;
+
+/**
+ * @brief Read every counter once (relaxed loads, no locks).
+ */
+static void read_counters(const SharedState *state, MetricsCounters *out) {
+    memset(out, 0, sizeof(*out));
+    stats_snapshot(state, &out->stats);
+    for (int l = 0; l < state->cfg.line_count; l++) {
+        const LineState *line = &state->lines[l];
+        out->lower_station_count += __atomic_load_n(&line->lower_station_count, __ATOMIC_RELAXED);
+        out->tourists_on_chairs += __atomic_load_n(&line->tourists_on_chairs, __ATOMIC_RELAXED);
+        out->chairs_dispatched += __atomic_load_n(&line->chair_dispatch_seq, __ATOMIC_RELAXED);
+        out->chair_slots_departed += __atomic_load_n(&line->chair_slots_departed, __ATOMIC_RELAXED);
+    }
+    for (int i = 0; i < LAT_STAGE_COUNT; i++) {
+        out->wait_count[i] = __atomic_load_n(&state->latency[i].count, __ATOMIC_RELAXED);
+        out->wait_sum_us[i] = __atomic_load_n(&state->latency[i].sum_us, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Read the counters until two consecutive passes agree.
+ *
+ * @param state Shared state.
+ * @param out Output counters (the last pass if no two agreed).
+ * @param retries_out Output: extra passes needed.
+ * @return 1 if the snapshot is consistent, 0 otherwise.
+ */
+static int snapshot_counters(const SharedState *state, MetricsCounters *out, int *retries_out) {
+    MetricsCounters check;
+    read_counters(state, out);
+    for (int i = 0; i < METRICS_SNAPSHOT_RETRIES; i++) {
+        read_counters(state, &check);
+        if (memcmp(out, &check, sizeof(check)) == 0) {
+            *retries_out = i;
+            return 1;
+        }
+        *out = check;
+    }
+    *retries_out = METRICS_SNAPSHOT_RETRIES;
+    return 0;
+}
+
+/**
+ * @brief Write one snapshot to path (via path.tmp and rename).
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int write_metrics(IPCResources *res, const char *path, unsigned long long scrapes) {
+    SharedState *state = res->state;
+    MetricsCounters c;
+    int retries = 0;
+    int consistent = snapshot_counters(state, &c, &retries);
+
+    char tmp_path[TRACE_PATH_MAX];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+    FILE *f = fopen(tmp_path, "w");
+    if (!f) {
+        perror("metrics_exporter: fopen");
+        return -1;
+    }
+
+    static const char *ticket_names[] = {"single", "time_t1", "time_t2", "time_t3", "daily"};
+    static const char *stage_names[] = {"entry_gates", "lower_station", "platform_gates",
+                                        "boarding", "exit_gates"};
+
+    ControlBlock control;
+    control_snapshot(state, &control);
+
+    fprintf(f, "# HELP ropeway_sim_time_seconds Simulated time of day.\n");
+    fprintf(f, "# TYPE ropeway_sim_time_seconds gauge\n");
+    fprintf(f, "ropeway_sim_time_seconds %.3f\n", time_get_sim_ms(state) / 1000.0);
+    fprintf(f, "# TYPE ropeway_running gauge\nropeway_running %d\n", control.running);
+    fprintf(f, "# TYPE ropeway_closing gauge\nropeway_closing %d\n", control.closing);
+    fprintf(f, "# TYPE ropeway_emergency_stop gauge\nropeway_emergency_stop %d\n",
+            control.emergency_stop != 0);
+    if (state->cfg.line_count > 1) {
+        fprintf(f, "# TYPE ropeway_line_emergency_stop gauge\n");
+        for (int l = 0; l < state->cfg.line_count; l++) {
+            fprintf(f, "ropeway_line_emergency_stop{line=\"%d\"} %d\n", l,
+                    (control.emergency_stop >> l) & 1);
+        }
+    }
+
+    fprintf(f, "# HELP ropeway_tourists_total Tourists sold a ticket (parent + kids).\n");
+    fprintf(f, "# TYPE ropeway_tourists_total counter\n");
+    fprintf(f, "ropeway_tourists_total %d\n", c.stats.total_tourists);
+    fprintf(f, "# HELP ropeway_rides_total Rides completed (parent + kids).\n");
+    fprintf(f, "# TYPE ropeway_rides_total counter\n");
+    fprintf(f, "ropeway_rides_total %d\n", c.stats.total_rides);
+    fprintf(f, "# TYPE ropeway_rides_by_ticket_total counter\n");
+    for (int i = 0; i < TICKET_COUNT; i++) {
+        fprintf(f, "ropeway_rides_by_ticket_total{ticket=\"%s\"} %d\n",
+                ticket_names[i], c.stats.rides_by_ticket[i]);
+    }
+    fprintf(f, "# TYPE ropeway_chairs_dispatched_total counter\n");
+    fprintf(f, "ropeway_chairs_dispatched_total %u\n", c.chairs_dispatched);
+    fprintf(f, "# TYPE ropeway_chair_slots_departed_total counter\n");
+    fprintf(f, "ropeway_chair_slots_departed_total %u\n", c.chair_slots_departed);
+    fprintf(f, "# TYPE ropeway_lower_station_count gauge\n");
+    fprintf(f, "ropeway_lower_station_count %d\n", c.lower_station_count);
+    fprintf(f, "# TYPE ropeway_tourists_on_chairs gauge\n");
+    fprintf(f, "ropeway_tourists_on_chairs %d\n", c.tourists_on_chairs);
+
+    // Semaphores and queues are gone during shutdown: omit rather than report -1
+    IPCResources line_res = *res;
+    int chairs = 0;
+    int station = 0;
+    int depths[3] = {0, 0, 0};
+    for (int l = 0; l < res->line_count; l++) {
+        ipc_select_line(&line_res, l);
+        int line_chairs = sem_getval(line_res.sem_id, SEM_CHAIRS);
+        int line_station = sem_getval(line_res.sem_id, SEM_LOWER_STATION);
+        chairs = (chairs < 0 || line_chairs < 0) ? -1 : chairs + line_chairs;
+        station = (station < 0 || line_station < 0) ? -1 : station + line_station;
+        for (int q = 0; q < 3; q++) {
+            int depth = transport_depth(&line_res, (TransportChannel)q);
+            depths[q] = (depths[q] < 0 || depth < 0) ? -1 : depths[q] + depth;
+        }
+    }
+    fprintf(f, "# HELP ropeway_semaphore_value Free slots of a semaphore.\n");
+    fprintf(f, "# TYPE ropeway_semaphore_value gauge\n");
+    if (chairs >= 0) fprintf(f, "ropeway_semaphore_value{sem=\"chairs\"} %d\n", chairs);
+    if (station >= 0) fprintf(f, "ropeway_semaphore_value{sem=\"lower_station\"} %d\n", station);
+
+    struct {
+        const char *name;
+        int depth;
+    } queues[] = {
+        {"platform", depths[TRANSPORT_PLATFORM]},
+        {"boarding", depths[TRANSPORT_BOARDING]},
+        {"arrivals", depths[TRANSPORT_ARRIVALS]},
+        {"cashier", -1},
+    };
+    struct msqid_ds ds;
+    for (int c = 0; c < res->cashier_count; c++) {
+        if (res->mq_cashier_ids[c] != -1 && msgctl(res->mq_cashier_ids[c], IPC_STAT, &ds) == 0) {
+            queues[3].depth = (queues[3].depth < 0 ? 0 : queues[3].depth) + (int)ds.msg_qnum;
+        }
+    }
+    fprintf(f, "# HELP ropeway_queue_depth Messages waiting in a queue.\n");
+    fprintf(f, "# TYPE ropeway_queue_depth gauge\n");
+    for (size_t i = 0; i < sizeof(queues) / sizeof(queues[0]); i++) {
+        if (queues[i].depth >= 0) {
+            fprintf(f, "ropeway_queue_depth{queue=\"%s\"} %d\n", queues[i].name, queues[i].depth);
+        }
+    }
+
+    // Backpressure: blocked sends are always counted, the rest needs QUEUE_SAMPLE_MS
+    static const char *queue_kind_names[] = {"cashier", "platform", "boarding", "arrivals",
+                                             "worker", "spawn"};
+    const QueueStats *qs = &state->queue_stats;
+    fprintf(f, "# HELP ropeway_queue_blocked_sends_total Sends that found their queue full.\n");
+    fprintf(f, "# TYPE ropeway_queue_blocked_sends_total counter\n");
+    for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+        fprintf(f, "ropeway_queue_blocked_sends_total{queue=\"%s\"} %llu\n", queue_kind_names[k],
+                (unsigned long long)__atomic_load_n(&qs->queue[k].blocked_sends, __ATOMIC_RELAXED));
+    }
+    if (state->cfg.queue_sample_ms > 0) {
+        fprintf(f, "# HELP ropeway_queue_high_water_messages Most messages seen in one queue.\n");
+        fprintf(f, "# TYPE ropeway_queue_high_water_messages gauge\n");
+        for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+            fprintf(f, "ropeway_queue_high_water_messages{queue=\"%s\"} %u\n", queue_kind_names[k],
+                    qs->queue[k].high_water);
+        }
+        fprintf(f, "# HELP ropeway_queue_high_water_bytes Most bytes seen in one System V queue.\n");
+        fprintf(f, "# TYPE ropeway_queue_high_water_bytes gauge\n");
+        for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+            fprintf(f, "ropeway_queue_high_water_bytes{queue=\"%s\"} %llu\n", queue_kind_names[k],
+                    (unsigned long long)qs->queue[k].high_water_bytes);
+        }
+        fprintf(f, "# HELP ropeway_queue_limit_bytes msg_qbytes of one queue (absent for shm rings).\n");
+        fprintf(f, "# TYPE ropeway_queue_limit_bytes gauge\n");
+        for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+            if (qs->queue[k].limit_bytes > 0) {
+                fprintf(f, "ropeway_queue_limit_bytes{queue=\"%s\"} %llu\n", queue_kind_names[k],
+                        (unsigned long long)qs->queue[k].limit_bytes);
+            }
+        }
+        fprintf(f, "# HELP ropeway_queue_full_seconds_total Real time some queue of the kind was full.\n");
+        fprintf(f, "# TYPE ropeway_queue_full_seconds_total counter\n");
+        for (int k = 0; k < QUEUE_KIND_COUNT; k++) {
+            fprintf(f, "ropeway_queue_full_seconds_total{queue=\"%s\"} %.3f\n", queue_kind_names[k],
+                    qs->queue[k].full_ns / 1e9);
+        }
+        fprintf(f, "# TYPE ropeway_queue_samples_total counter\n");
+        fprintf(f, "ropeway_queue_samples_total %llu\n",
+                (unsigned long long)qs->queue[QUEUE_PLATFORM].samples);
+    }
+
+    fprintf(f, "# HELP ropeway_wait_seconds Real time tourists waited at each blocking point.\n");
+    fprintf(f, "# TYPE ropeway_wait_seconds summary\n");
+    static const double quantiles[] = {0.5, 0.9, 0.99};
+    for (int i = 0; i < LAT_STAGE_COUNT; i++) {
+        for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+            fprintf(f, "ropeway_wait_seconds{stage=\"%s\",quantile=\"%g\"} %.6f\n",
+                    stage_names[i], quantiles[q],
+                    latency_percentile(&state->latency[i], quantiles[q]) / 1e6);
+        }
+        fprintf(f, "ropeway_wait_seconds_sum{stage=\"%s\"} %.6f\n",
+                stage_names[i], c.wait_sum_us[i] / 1e6);
+        fprintf(f, "ropeway_wait_seconds_count{stage=\"%s\"} %llu\n",
+                stage_names[i], (unsigned long long)c.wait_count[i]);
+    }
+
+    fprintf(f, "# HELP ropeway_snapshot_consistent 1 if two consecutive counter reads agreed.\n");
+    fprintf(f, "# TYPE ropeway_snapshot_consistent gauge\n");
+    fprintf(f, "ropeway_snapshot_consistent %d\n", consistent);
+    fprintf(f, "# TYPE ropeway_snapshot_retries gauge\nropeway_snapshot_retries %d\n", retries);
+    fprintf(f, "# TYPE ropeway_exporter_scrapes_total counter\n");
+    fprintf(f, "ropeway_exporter_scrapes_total %llu\n", scrapes);
+
+    if (fclose(f) != 0) {
+        perror("metrics_exporter: fclose");
+        return -1;
+    }
+    if (rename(tmp_path, path) == -1) {
+        perror("metrics_exporter: rename");
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Metrics exporter process entry point.
+ *
+ * @param res IPC resources (shared memory, semaphore set, queues).
+ * @param keys IPC keys (unused, kept for interface consistency).
+ */
+void metrics_exporter_main(IPCResources *res, IPCKeys *keys) {
+    (void)keys;
+    SharedState *state = res->state;
+
+    logger_init(state, LOG_IPC);
+    logger_set_debug_enabled(state->cfg.debug_logs_enabled);
+
+    struct sigaction sa;
+    sa.sa_handler = signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    pid_t parent = getppid();
+    int interval_ms = state->cfg.metrics_interval_ms;
+    int sample_ms = state->cfg.queue_sample_ms;
+    unsigned long long scrapes = 0;
+
+    log_debug("METRICS", "Metrics exporter started (PID %d, metrics every %d ms to %s, "
+              "queue samples every %d ms)", getpid(), interval_ms, METRICS_FILE_NAME, sample_ms);
+
+    int64_t next_sample_ns = 0;
+    int64_t next_write_ns = 0;
+    while (g_running && getppid() == parent) {
+        int64_t now = time_monotonic_ns();
+        if (sample_ms > 0 && now >= next_sample_ns) {
+            queue_stats_sample(res);
+            next_sample_ns = now + (int64_t)sample_ms * 1000000;
+        }
+        if (interval_ms > 0 && now >= next_write_ns) {
+            if (write_metrics(res, METRICS_FILE_NAME, ++scrapes) == -1) {
+                log_warn("METRICS", "Failed to write %s", METRICS_FILE_NAME);
+            }
+            next_write_ns = now + (int64_t)interval_ms * 1000000;
+        }
+
+        // Sleep until the next job, at most SHM_WAIT_TIMEOUT_MS so shutdown is noticed quickly
+        int64_t next = sample_ms > 0 ? next_sample_ns : next_write_ns;
+        if (sample_ms > 0 && interval_ms > 0 && next_write_ns < next) {
+            next = next_write_ns;
+        }
+        int64_t wait_ns = next - time_monotonic_ns();
+        if (wait_ns > (int64_t)SHM_WAIT_TIMEOUT_MS * 1000000) {
+            wait_ns = (int64_t)SHM_WAIT_TIMEOUT_MS * 1000000;
+        }
+        if (wait_ns > 0) {
+            struct timespec ts = {(time_t)(wait_ns / 1000000000), (long)(wait_ns % 1000000000)};
+            nanosleep(&ts, NULL);
+        }
+    }
+
+    // Final totals (queues and semaphores are gone by now)
+    if (interval_ms > 0) {
+        write_metrics(res, METRICS_FILE_NAME, ++scrapes);
+    }
+    log_debug("METRICS", "Metrics exporter exiting (%llu snapshots)", scrapes);
+}
@@ -0,0 +1,506 @@
+/**
+ * @file remote_gateway.c
+ * @brief Remote gateway process - tourists from other hosts over TCP (REMOTE_PORT > 0).
+ *
+ * Listens on REMOTE_PORT for up to REMOTE_MAX_HOSTS remote hosts (protocol
+ * in ipc/remote.h). Each ARRIVALS frame is one round trip: every valid
+ * tourist in it gets the next of the last REMOTE_TOURISTS IDs and is queued
+ * on MQ_SPAWN like a generated tourist, then one ACK carries the counts and
+ * the current sim time back. One thread serves every host from an epoll
+ * loop; frames are gathered per connection, so a slow host never blocks the
+ * others. A full spawn queue does block the gateway, which is the
+ * backpressure remote hosts see as slower ACKs.
+ *
+ * The gateway sets SharedState.remote.done once the remote IDs are used up
+ * or the station closes; the generator sends the pool sentinels only then.
+ */
+
+#include "constants.h"
+#include "ipc/ipc.h"
+#include "ipc/control.h"
+#include "ipc/messages.h"
+#include "ipc/queue_stats.h"
+#include "ipc/remote.h"
+#include "core/logger.h"
+#include "core/time_sim.h"
+#include "common/signal_common.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/msg.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define GATEWAY_FRAME_MAX (sizeof(RemoteFrameHeader) + REMOTE_BATCH_MAX * sizeof(RemoteTourist))
+
+static int g_running = 1;
+
+DEFINE_BASIC_SIGNAL_HANDLER(signal_handler)
+
+/**
+ * @brief One remote host connection.
+ */
+typedef struct {
+    int fd;                         // -1 = slot free
+    int greeted;                    // 1 once the HELLO was answered
+    int64_t connected_ns;           // Accept time (REMOTE_HELLO_TIMEOUT_MS until the HELLO)
+    size_t have;                    // Bytes gathered in buf
+    char name[REMOTE_HOST_NAME_LEN + 1];
+    unsigned char buf[GATEWAY_FRAME_MAX];
+} RemoteConn;
+
+static RemoteConn g_conns[REMOTE_MAX_HOSTS];
+static int g_last_id;               // Last remote tourist ID
+
+/**
+ * @brief Mark the remote IDs closed (release: the generator then sends its sentinels).
+ */
+static void gateway_set_done(SharedState *state, const char *why) {
+    if (!__atomic_load_n(&state->remote.done, __ATOMIC_RELAXED)) {
+        __atomic_store_n(&state->remote.done, 1, __ATOMIC_RELEASE);
+        int queued = state->remote.next_id - (g_last_id - state->cfg.remote_tourists + 1);
+        log_info("GATEWAY", "No more remote tourists: %s (%d queued)", why, queued);
+    }
+}
+
+/**
+ * @brief Current sim time for a frame.
+ */
+static uint32_t gateway_sim_ms(SharedState *state) {
+    int64_t ms = time_get_sim_ms(state);
+    return htonl(ms > 0 ? (uint32_t)ms : 0);
+}
+
+/**
+ * @brief Send one frame (header + payload) in full.
+ *
+ * @return 0 on success, -1 if the host cannot take it (connection dropped).
+ */
+static int gateway_send(int fd, uint32_t type, const void *payload, size_t len) {
+    unsigned char frame[sizeof(RemoteFrameHeader) + sizeof(RemoteWelcome)];
+    RemoteFrameHeader hdr = {htonl(type), 0};
+    memcpy(frame, &hdr, sizeof(hdr));
+    memcpy(frame + sizeof(hdr), payload, len);
+
+    size_t total = sizeof(hdr) + len;
+    size_t sent = 0;
+    while (sent < total) {
+        ssize_t n = send(fd, frame + sent, total - sent, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR && g_running) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;  // EAGAIN included: a host that does not read its ACKs is dropped
+        }
+        sent += (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Close a connection and free its slot.
+ */
+static void gateway_close(RemoteConn *c, const char *why) {
+    log_info("GATEWAY", "Remote host %s disconnected (%s)", c->name[0] ? c->name : "?", why);
+    close(c->fd);
+    c->fd = -1;
+}
+
+/**
+ * @brief Compare a HELLO's token with REMOTE_TOKEN in time independent of where they differ.
+ *
+ * @return 1 if equal (both NUL-padded to REMOTE_TOKEN_LEN).
+ */
+static int gateway_token_ok(const Config *cfg, const char *token) {
+    unsigned char diff = 0;
+    for (int i = 0; i < REMOTE_TOKEN_LEN; i++) {
+        diff |= (unsigned char)(token[i] ^ cfg->remote_token[i]);
+    }
+    return diff == 0;
+}
+
+/**
+ * @brief Answer a HELLO with the run's epoch, ID range and mix.
+ *
+ * @return 0 on success, -1 to drop the connection.
+ */
+static int gateway_hello(IPCResources *res, RemoteConn *c, const RemoteHello *hello) {
+    SharedState *state = res->state;
+    if (ntohl(hello->magic) != REMOTE_MAGIC || ntohl(hello->version) != REMOTE_VERSION) {
+        state->remote.hosts_refused++;
+        return -1;
+    }
+    memcpy(c->name, hello->host, REMOTE_HOST_NAME_LEN);
+    c->name[REMOTE_HOST_NAME_LEN] = '\0';
+    if (!gateway_token_ok(&state->cfg, hello->token)) {
+        state->remote.hosts_refused++;
+        log_warn("GATEWAY", "Refused remote host %s: wrong REMOTE_TOKEN", c->name[0] ? c->name : "?");
+        return -1;
+    }
+
+    RemoteWelcome w;
+    memset(&w, 0, sizeof(w));
+    w.version = htonl(REMOTE_VERSION);
+    w.sim_start_ms = htonl((uint32_t)state->sim_start_minutes * 60000u);
+    w.sim_end_ms = htonl((uint32_t)state->sim_end_minutes * 60000u);
+    w.sim_ms = gateway_sim_ms(state);
+    w.sim_ms_per_real_s = htonl((uint32_t)(state->time_acceleration * 60000.0));
+    w.first_id = htonl((uint32_t)(g_last_id - state->cfg.remote_tourists + 1));
+    w.last_id = htonl((uint32_t)g_last_id);
+    w.batch_max = htonl(REMOTE_BATCH_MAX);
+    w.vip_percentage = htonl((uint32_t)state->cfg.vip_percentage);
+    w.walker_percentage = htonl((uint32_t)state->cfg.walker_percentage);
+    w.family_percentage = htonl((uint32_t)state->cfg.family_percentage);
+    if (gateway_send(c->fd, REMOTE_MSG_WELCOME, &w, sizeof(w)) == -1) {
+        return -1;
+    }
+
+    c->greeted = 1;
+    state->remote.hosts++;
+    log_info("GATEWAY", "Remote host %s connected (IDs %u-%d shared by every host)",
+             c->name, ntohl(w.first_id), g_last_id);
+    return 0;
+}
+
+/**
+ * @brief Check one remote tourist the way the generator would draw it.
+ */
+static int remote_tourist_valid(const RemoteTourist *t) {
+    if (t->age < REMOTE_MIN_AGE || t->age > REMOTE_MAX_AGE || t->type > TOURIST_FAMILY ||
+        t->vip > 1 || t->ticket >= TICKET_COUNT || t->kid_count > MAX_KIDS_PER_ADULT) {
+        return 0;
+    }
+    return (t->type == TOURIST_FAMILY) == (t->kid_count > 0);
+}
+
+/**
+ * @brief Queue one remote tourist on MQ_SPAWN (retries on EINTR while running).
+ *
+ * @return 0 on success, -1 on shutdown or error.
+ */
+static int gateway_queue(IPCResources *res, const RemoteTourist *t, int tourist_id) {
+    TouristSpawnMsg msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.mtype = 1;
+    msg.tourist_id = tourist_id;
+    msg.age = t->age;
+    msg.tourist_type = (TouristType)t->type;
+    msg.is_vip = t->vip;
+    msg.kid_count = t->kid_count;
+    msg.ticket_type = t->ticket;
+    while (queue_msgsnd(res->state, QUEUE_SPAWN, res->mq_spawn_id, &msg, sizeof(msg) - sizeof(long), 0) == -1) {
+        if (errno == EINTR && g_running) {
+            continue;
+        }
+        if (errno != EINTR && errno != EIDRM && errno != EINVAL) {
+            perror("remote_gateway: msgsnd spawn");
+        }
+        return -1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Queue one ARRIVALS frame and answer it.
+ *
+ * @return 0 on success, -1 to drop the connection.
+ */
+static int gateway_arrivals(IPCResources *res, RemoteConn *c, const RemoteTourist *tourists,
+                            uint32_t count) {
+    SharedState *state = res->state;
+    RemoteStats *rs = &state->remote;
+    int64_t start_ns = time_monotonic_ns();
+
+    uint32_t accepted = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (!remote_tourist_valid(&tourists[i]) ||
+            __atomic_load_n(&rs->done, __ATOMIC_RELAXED) || control_closing(state)) {
+            continue;
+        }
+        int id = rs->next_id;
+        if (gateway_queue(res, &tourists[i], id) == -1) {
+            break;
+        }
+        rs->next_id++;
+        accepted++;
+        log_debug("GATEWAY", "Queued tourist %d from %s: age=%d, type=%d, vip=%d, kids=%d, ticket=%d",
+                  id, c->name, tourists[i].age, tourists[i].type, tourists[i].vip,
+                  tourists[i].kid_count, tourists[i].ticket);
+        if (rs->next_id > g_last_id) {
+            gateway_set_done(state, "every remote ID used");
+        }
+    }
+
+    rs->batches++;
+    rs->accepted += accepted;
+    rs->rejected += count - accepted;
+    if (count > rs->max_batch) {
+        rs->max_batch = count;
+    }
+
+    RemoteAck ack;
+    ack.accepted = htonl(accepted);
+    ack.rejected = htonl(count - accepted);
+    ack.sim_ms = gateway_sim_ms(state);
+    ack.flags = htonl(__atomic_load_n(&rs->done, __ATOMIC_RELAXED) ? REMOTE_FLAG_CLOSED : 0);
+    int rc = gateway_send(c->fd, REMOTE_MSG_ACK, &ack, sizeof(ack));
+
+    int64_t batch_ns = time_monotonic_ns() - start_ns;
+    rs->batch_ns_sum += batch_ns;
+    if (batch_ns > rs->batch_ns_max) {
+        rs->batch_ns_max = batch_ns;
+    }
+    return rc;
+}
+
+/**
+ * @brief Handle every complete frame gathered on a connection.
+ *
+ * @return 0 to keep the connection, -1 to drop it.
+ */
+static int gateway_frames(IPCResources *res, RemoteConn *c) {
+    while (c->have >= sizeof(RemoteFrameHeader)) {
+        RemoteFrameHeader hdr;
+        memcpy(&hdr, c->buf, sizeof(hdr));
+        uint32_t type = ntohl(hdr.type);
+        uint32_t count = ntohl(hdr.count);
+
+        size_t payload;
+        if (!c->greeted && type == REMOTE_MSG_HELLO) {
+            payload = sizeof(RemoteHello);
+        } else if (c->greeted && type == REMOTE_MSG_ARRIVALS && count <= REMOTE_BATCH_MAX) {
+            payload = count * sizeof(RemoteTourist);
+        } else {
+            log_warn("GATEWAY", "Remote host %s sent an invalid frame (type %u, count %u)",
+                     c->name[0] ? c->name : "?", type, count);
+            return -1;
+        }
+        if (c->have < sizeof(hdr) + payload) {
+            return 0;  // Rest of the frame still in flight
+        }
+
+        const unsigned char *body = c->buf + sizeof(hdr);
+        int rc;
+        if (type == REMOTE_MSG_HELLO) {
+            RemoteHello hello;
+            memcpy(&hello, body, sizeof(hello));
+            rc = gateway_hello(res, c, &hello);
+        } else {
+            RemoteTourist tourists[REMOTE_BATCH_MAX];
+            memcpy(tourists, body, payload);
+            rc = gateway_arrivals(res, c, tourists, count);
+        }
+        if (rc == -1) {
+            return -1;
+        }
+
+        size_t used = sizeof(hdr) + payload;
+        memmove(c->buf, c->buf + used, c->have - used);
+        c->have -= used;
+    }
+    return 0;
+}
+
+/**
+ * @brief Accept a pending connection into a free slot.
+ */
+static void gateway_accept(SharedState *state, int listen_fd, int epoll_fd) {
+    int fd = accept4(listen_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+    if (fd == -1) {
+        if (errno != EAGAIN && errno != EINTR) {
+            perror("remote_gateway: accept4");
+        }
+        return;
+    }
+
+    RemoteConn *c = NULL;
+    for (int i = 0; i < REMOTE_MAX_HOSTS && c == NULL; i++) {
+        if (g_conns[i].fd == -1) {
+            c = &g_conns[i];
+        }
+    }
+    if (c == NULL) {
+        state->remote.hosts_refused++;
+        log_warn("GATEWAY", "Refused a remote host: %d already connected", REMOTE_MAX_HOSTS);
+        close(fd);
+        return;
+    }
+
+    // One small ACK per round trip: do not let Nagle hold it back
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    memset(c, 0, sizeof(*c));
+    c->fd = fd;
+    c->connected_ns = time_monotonic_ns();
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = c;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) == -1) {
+        perror("remote_gateway: epoll_ctl client");
+        close(fd);
+        c->fd = -1;
+    }
+}
+
+/**
+ * @brief Read what a host sent and handle the complete frames.
+ */
+static void gateway_read(IPCResources *res, RemoteConn *c) {
+    while (c->fd != -1) {
+        ssize_t n = recv(c->fd, c->buf + c->have, sizeof(c->buf) - c->have, 0);
+        if (n == -1 && errno == EINTR && g_running) {
+            continue;
+        }
+        if (n == -1 && errno == EAGAIN) {
+            return;
+        }
+        if (n <= 0) {
+            gateway_close(c, n == 0 ? "closed" : strerror(errno));
+            return;
+        }
+        c->have += (size_t)n;
+        if (gateway_frames(res, c) == -1) {
+            gateway_close(c, "protocol error");
+        }
+    }
+}
+
+/**
+ * @brief Close connections that did not say HELLO within REMOTE_HELLO_TIMEOUT_MS.
+ *
+ * Otherwise idle connections could hold every REMOTE_MAX_HOSTS slot.
+ */
+static void gateway_expire(SharedState *state) {
+    int64_t now = time_monotonic_ns();
+    for (int i = 0; i < REMOTE_MAX_HOSTS; i++) {
+        RemoteConn *c = &g_conns[i];
+        if (c->fd != -1 && !c->greeted &&
+            now - c->connected_ns > (int64_t)REMOTE_HELLO_TIMEOUT_MS * 1000000) {
+            state->remote.hosts_refused++;
+            gateway_close(c, "no HELLO");
+        }
+    }
+}
+
+/**
+ * @brief Open the listening socket on REMOTE_BIND:REMOTE_PORT.
+ *
+ * @param bind_addr IPv4 address, host order.
+ * @param port TCP port.
+ * @return Socket, or -1 on error.
+ */
+static int gateway_listen(unsigned int bind_addr, int port) {
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd == -1) {
+        perror("remote_gateway: socket");
+        return -1;
+    }
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(bind_addr);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) == -1 ||
+        listen(fd, REMOTE_MAX_HOSTS) == -1) {
+        perror("remote_gateway: bind/listen");
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Remote gateway process entry point.
+ *
+ * Serves remote hosts until shutdown. Without a listening socket it marks
+ * the remote IDs done at once, so the run goes on with local tourists only.
+ *
+ * @param res IPC resources (spawn queue and shared state).
+ * @param keys IPC keys (unused, kept for interface consistency).
+ */
+void remote_gateway_main(IPCResources *res, IPCKeys *keys) {
+    (void)keys;
+    SharedState *state = res->state;
+
+    logger_init(state, LOG_GENERATOR);
+    logger_set_debug_enabled(state->cfg.debug_logs_enabled);
+
+    struct sigaction sa;
+    sa.sa_handler = signal_handler;
+    sigemptyset(&sa.sa_mask);
+    sa.sa_flags = 0;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+
+    g_last_id = state->tourists_to_generate;
+    state->remote.next_id = g_last_id - state->cfg.remote_tourists + 1;
+    for (int i = 0; i < REMOTE_MAX_HOSTS; i++) {
+        g_conns[i].fd = -1;
+    }
+
+    char bind_str[INET_ADDRSTRLEN];
+    struct in_addr bind_in = { htonl(state->cfg.remote_bind) };
+    inet_ntop(AF_INET, &bind_in, bind_str, sizeof(bind_str));
+    int listen_fd = gateway_listen(state->cfg.remote_bind, state->cfg.remote_port);
+    int epoll_fd = listen_fd == -1 ? -1 : epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;  // NULL = listening socket
+    if (epoll_fd == -1 || epoll_ctl(epoll_fd, EPOLL_CTL_ADD, listen_fd, &ev) == -1) {
+        log_error("GATEWAY", "Cannot serve remote hosts on %s:%d", bind_str, state->cfg.remote_port);
+        gateway_set_done(state, "no listening socket");
+        if (listen_fd != -1) close(listen_fd);
+        if (epoll_fd != -1) close(epoll_fd);
+        return;
+    }
+    log_info("GATEWAY", "Listening on %s:%d for %d remote tourists (IDs %d-%d%s)",
+             bind_str, state->cfg.remote_port, state->cfg.remote_tourists, state->remote.next_id, g_last_id,
+             state->cfg.remote_token[0] ? ", token required" : "");
+
+    while (g_running && control_running(state)) {
+        if (control_closing(state)) {
+            gateway_set_done(state, "station closing");
+        }
+
+        struct epoll_event events[REMOTE_MAX_HOSTS + 1];
+        int n = epoll_wait(epoll_fd, events, REMOTE_MAX_HOSTS + 1, REMOTE_POLL_MS);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("remote_gateway: epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            if (events[i].data.ptr == NULL) {
+                gateway_accept(state, listen_fd, epoll_fd);
+            } else {
+                gateway_read(res, events[i].data.ptr);
+            }
+        }
+        gateway_expire(state);
+    }
+
+    gateway_set_done(state, "shutting down");
+    for (int i = 0; i < REMOTE_MAX_HOSTS; i++) {
+        if (g_conns[i].fd != -1) {
+            gateway_close(&g_conns[i], "shutdown");
+        }
+    }
+    close(epoll_fd);
+    close(listen_fd);
+    log_info("GATEWAY", "Remote gateway exiting (%u hosts, %u tourists in %u batches)",
+             state->remote.hosts, state->remote.accepted, state->remote.batches);
+}
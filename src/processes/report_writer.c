@@ -0,0 +1,194 @@
+/**
+ * @file report_writer.c
+ * @brief Report writer process - appends finished tourists to the report spool (REPORT_INCREMENTAL=1).
+ *
+ * Tourists push their final TouristEntry to the CompletionRing when they
+ * leave. The writer formats each record as a report row into a buffer of
+ * REPORT_SPOOL_BUFFER bytes, appends it to REPORT_SPOOL_FILE_NAME (and the
+ * CSV file with REPORT_FORMAT=1) and frees the slot, so no per-tourist data
+ * stays in shared memory. Main stops it after the generator (and with it
+ * every tourist) has exited, then builds the report around the spool.
+ */
+
+#include "constants.h"
+#include "ipc/ipc.h"
+#include "ipc/futex.h"
+#include "core/logger.h"
+#include "core/report.h"
+#include "core/completion_ring.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+/**
+ * @brief Output file with its batching buffer.
+ */
+typedef struct {
+    int fd;                         // -1 = not written
+    size_t used;
+    char buf[REPORT_SPOOL_BUFFER];
+} SpoolFile;
+
+static SpoolFile g_rows = {.fd = -1};
+static SpoolFile g_csv = {.fd = -1};
+
+/**
+ * @brief Write the buffered bytes, retrying short writes.
+ *
+ * @param f Output file.
+ * @return 0 on success, -1 on error.
+ */
+static int spool_flush(SpoolFile *f) {
+    const char *p = f->buf;
+    size_t len = f->used;
+    f->used = 0;
+    while (len > 0) {
+        ssize_t n = write(f->fd, p, len);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("report_writer: write");
+            return -1;
+        }
+        p += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Append every published record to the spool (and CSV).
+ *
+ * @param ring Completion ring.
+ * @return Number of records written.
+ */
+static int drain_ring(CompletionRing *ring) {
+    int count = 0;
+    CompletionRecord *rec;
+
+    while ((rec = completion_ring_peek(ring)) != NULL) {
+        if (g_rows.used + REPORT_ROW_MAX > sizeof(g_rows.buf)) {
+            spool_flush(&g_rows);
+        }
+        g_rows.used = (size_t)(report_format_text_row(g_rows.buf + g_rows.used, rec->id,
+                                                      &rec->entry) - g_rows.buf);
+        if (g_csv.fd != -1) {
+            if (g_csv.used + REPORT_ROW_MAX > sizeof(g_csv.buf)) {
+                spool_flush(&g_csv);
+            }
+            g_csv.used = (size_t)(report_format_csv_row(g_csv.buf + g_csv.used, rec->id,
+                                                        &rec->entry) - g_csv.buf);
+        }
+        completion_ring_release(ring, rec);
+        count++;
+    }
+
+    if (g_rows.used > 0) {
+        spool_flush(&g_rows);
+    }
+    if (g_csv.used > 0) {
+        spool_flush(&g_csv);
+    }
+    if (count > 0) {
+        __atomic_add_fetch(&ring->written, (uint64_t)count, __ATOMIC_RELAXED);
+    }
+    return count;
+}
+
+/**
+ * @brief Report writer process entry point.
+ *
+ * @param res IPC resources (shared memory holding the completion ring).
+ * @param keys IPC keys (unused, kept for interface consistency).
+ */
+void report_writer_main(IPCResources *res, IPCKeys *keys) {
+    (void)keys;
+    SharedState *state = res->state;
+    CompletionRing *ring = completion_ring_get(state);
+    if (ring == NULL) {
+        return;
+    }
+
+    logger_init(state, LOG_IPC);
+    logger_set_debug_enabled(state->cfg.debug_logs_enabled);
+
+    // Records must survive shutdown: only main's stop flag ends the writer
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = SIG_IGN;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    g_rows.fd = open(REPORT_SPOOL_FILE_NAME, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (g_rows.fd == -1) {
+        perror("report_writer: open spool");
+        return;
+    }
+    if (state->cfg.report_format == REPORT_FORMAT_CSV) {
+        g_csv.fd = open(REPORT_CSV_FILE_NAME, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (g_csv.fd == -1) {
+            perror("report_writer: open csv");
+        } else {
+            g_csv.used = strlen(REPORT_CSV_HEADER);
+            memcpy(g_csv.buf, REPORT_CSV_HEADER, g_csv.used);
+        }
+    }
+
+    pid_t parent = getppid();
+    int stalled_ms = 0;
+    __atomic_store_n(&ring->writer_alive, 1, __ATOMIC_RELEASE);
+
+    log_debug("REPORT_WRITER", "Report writer started (PID %d, ring=%d records, spool=%s)",
+              getpid(), COMPLETION_RING_CAPACITY, REPORT_SPOOL_FILE_NAME);
+
+    while (1) {
+        if (drain_ring(ring) > 0) {
+            stalled_ms = 0;
+        }
+
+        int done = __atomic_load_n(&ring->stop, __ATOMIC_ACQUIRE) || getppid() != parent;
+        if (done && completion_ring_peek(ring) == NULL) {
+            break;
+        }
+
+        // Sleep until a tourist publishes (one slice at most)
+        __atomic_store_n(&ring->item_waiters, 1, __ATOMIC_SEQ_CST);
+        uint32_t observed = __atomic_load_n(&ring->items, __ATOMIC_SEQ_CST);
+        if (completion_ring_peek(ring) == NULL) {
+            if (futex_wait(&ring->items, observed, SHM_WAIT_TIMEOUT_MS) == -1 &&
+                errno == ETIMEDOUT) {
+                // Head slot claimed by a tourist that died before publishing it?
+                if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == ring->head) {
+                    stalled_ms = 0;
+                } else {
+                    stalled_ms += SHM_WAIT_TIMEOUT_MS;
+                }
+                if (stalled_ms >= COMPLETION_STALL_MS && completion_ring_skip_stalled(ring)) {
+                    stalled_ms = 0;
+                }
+            }
+        }
+        __atomic_store_n(&ring->item_waiters, 0, __ATOMIC_SEQ_CST);
+    }
+
+    __atomic_store_n(&ring->writer_alive, 0, __ATOMIC_RELEASE);
+    drain_ring(ring);
+    if (g_csv.fd != -1) {
+        close(g_csv.fd);
+    }
+    if (close(g_rows.fd) == -1) {
+        perror("report_writer: close spool");
+    }
+
+    uint64_t dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+    if (dropped > 0) {
+        log_warn("REPORT_WRITER", "%llu finished tourists missing from the report",
+                 (unsigned long long)dropped);
+    }
+    log_debug("REPORT_WRITER", "Report writer exiting (tourists written: %llu)",
+              (unsigned long long)__atomic_load_n(&ring->written, __ATOMIC_RELAXED));
+}
@@ -7,19 +7,27 @@
  * The Time Server is responsible for:
  * - Maintaining the current simulated time with sub-millisecond precision
  * - Handling SIGTSTP/SIGCONT pause tracking and offset calculation
- * - Atomically updating SharedState.current_sim_time_ms for other processes to read
- *
- * Other processes simply read the atomic time value - no time calculation needed.
+ * - CLOCK_SOURCE=0: atomically updating SharedState.control.current_sim_time_ms
+ *   every 10ms (setitimer) for other processes to read
+ * - CLOCK_SOURCE=1: publishing only the clock epoch (start time shifted by
+ *   every pause); other processes compute the time from CLOCK_MONOTONIC and
+ *   the Time Server wakes up only for SIGTSTP/SIGCONT and shutdown
+ * - MAX_SPEED=1: advancing the virtual clock (SharedState.vclock) to the
+ *   earliest pending deadline whenever every process is blocked
  */
 
 #include "ipc/ipc.h"
+#include "ipc/control.h"
 #include "core/logger.h"
+#include "core/time_sim.h"
+#include "ipc/futex.h"
 
 #include <signal.h>
 #include <stdio.h>
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <sys/prctl.h>
 #include <sys/time.h>
 #include <errno.h>
 
@@ -35,6 +43,10 @@ static double g_total_pause_offset = 0.0;  // In seconds
 // Real start time with high precision
 static struct timespec g_real_start_time;
 
+// Clock epoch: start time plus every pause so far, in ns (see time_elapsed_ns)
+static SharedState *g_state = NULL;
+static int64_t g_epoch_base_ns = 0;
+
 // Saved sigaction for SIGTSTP reinstallation (used in SIGCONT handler)
 static struct sigaction g_sigtstp_action;
 
@@ -54,6 +66,11 @@ static void sigtstp_handler(int sig) {
         write(STDERR_FILENO, "[SIGNAL] [TIME_SERVER] clock_gettime failed\n", 44);
     }
     g_paused = 1;
+    if (g_state != NULL) {
+        // Freeze the readers' epoch clock and deadlines before stopping (one atomic store)
+        control_mark_epoch_paused(g_state, (int64_t)g_pause_start.tv_sec * 1000000000 +
+                                           g_pause_start.tv_nsec);
+    }
     write(STDERR_FILENO, "[SIGNAL] [TIME_SERVER] SIGTSTP received\n", 40);
 
     // Re-raise SIGTSTP to actually stop (handler was reset to SIG_DFL by SA_RESETHAND)
@@ -101,7 +118,8 @@ static void sigalrm_handler(int sig) {
  * @brief Handle pause offset calculation after SIGCONT.
  *
  * Called outside signal handler context to safely calculate the pause
- * duration and update the total pause offset.
+ * duration and update the total pause offset. The clock epoch is shifted
+ * by the pause and unfrozen.
  */
 static void handle_resume(void) {
     if (!g_sigcont_received) return;
@@ -121,6 +139,10 @@ static void handle_resume(void) {
         g_total_pause_offset += pause_duration;
         g_paused = 0;
 
+        g_epoch_base_ns += (int64_t)(now.tv_sec - g_pause_start.tv_sec) * 1000000000 +
+                           (now.tv_nsec - g_pause_start.tv_nsec);
+        control_set_epoch(g_state, g_epoch_base_ns, 0);
+
         log_info("TIME_SERVER", "Resumed after %.2f seconds pause (total offset: %.2f)",
                  pause_duration, g_total_pause_offset);
     }
@@ -160,8 +182,195 @@ static void update_sim_time(SharedState *state) {
     double sim_minutes = state->sim_start_minutes + effective_elapsed * state->time_acceleration;
     int64_t sim_ms = (int64_t)(sim_minutes * 60.0 * 1000.0);
 
-    // Atomic store for other processes to read
-    __atomic_store_n(&state->current_sim_time_ms, sim_ms, __ATOMIC_RELEASE);
+    // Seqlock-published for other processes to read
+    control_set_sim_time_ms(state, sim_ms);
+}
+
+/**
+ * @brief Epoch clock main loop (CLOCK_SOURCE=1).
+ *
+ * The start epoch is already published, so it only sleeps in sigsuspend():
+ * readers compute the sim time themselves, so only SIGCONT (shift the epoch
+ * by the pause) and SIGTERM/SIGINT (exit) wake the Time Server up. The
+ * signals stay blocked outside sigsuspend(), so a SIGCONT that arrives
+ * between handle_resume() and the sleep is not lost.
+ *
+ * @param res IPC resources.
+ */
+static void time_server_epoch_loop(IPCResources *res) {
+    SharedState *state = res->state;
+
+    log_debug("TIME_SERVER", "Epoch clock published (no timer)");
+
+    // Signal that this worker is ready (startup barrier)
+    if (ipc_signal_worker_ready(res) == -1) {
+        log_error("TIME_SERVER", "Failed to signal ready, exiting");
+        return;
+    }
+    log_info("TIME_SERVER", "Time Server ready");
+
+    sigset_t wake_mask, sleep_mask;
+    sigemptyset(&wake_mask);
+    sigaddset(&wake_mask, SIGCONT);
+    sigaddset(&wake_mask, SIGTERM);
+    sigaddset(&wake_mask, SIGINT);
+    sigprocmask(SIG_BLOCK, &wake_mask, &sleep_mask);
+
+    while (g_running && control_running(state)) {
+        handle_resume();
+        sigsuspend(&sleep_mask);
+    }
+
+    sigprocmask(SIG_SETMASK, &sleep_mask, NULL);
+    log_debug("TIME_SERVER", "Time Server exiting");
+}
+
+/**
+ * @brief Fire due virtual alarms and find the earliest pending alarm or hold.
+ *
+ * @param now_ns Current virtual time.
+ * @param blocked Output: 1 if a hold at or before now_ns forbids advancing.
+ * @return Earliest future alarm or hold deadline (INT64_MAX = none).
+ */
+static int64_t vclock_scan_timers(SharedState *state, int64_t now_ns, int *blocked) {
+    VirtualClock *vc = &state->vclock;
+    int64_t earliest = INT64_MAX;
+    *blocked = 0;
+    for (int i = 0; i < VCLOCK_TIMER_SLOTS; i++) {
+        VirtualTimer *t = &vc->timers[i];
+        pid_t pid = __atomic_load_n(&t->pid, __ATOMIC_ACQUIRE);
+        uint32_t kind = __atomic_load_n(&t->kind, __ATOMIC_ACQUIRE);
+        if (pid == 0 || kind == VTIMER_NONE) {
+            continue;
+        }
+        int64_t deadline = __atomic_load_n(&t->deadline_ns, __ATOMIC_ACQUIRE);
+        if (deadline > now_ns) {
+            if (deadline < earliest) earliest = deadline;
+        } else if (kind == VTIMER_ALARM) {
+            // Due: one-shot, cleared before the signal so a re-arm is not lost
+            uint32_t armed = VTIMER_ALARM;
+            if (__atomic_compare_exchange_n(&t->kind, &armed, VTIMER_NONE, 0,
+                                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+                __atomic_add_fetch(&vc->activity, 1, __ATOMIC_SEQ_CST);
+                if (kill(pid, SIGALRM) == -1 && errno == ESRCH) {
+                    __atomic_store_n(&t->pid, 0, __ATOMIC_RELEASE);  // Owner gone, free the slot
+                }
+            }
+        } else if (kill(pid, 0) == 0) {
+            *blocked = 1;  // Holder has not caught up with the clock yet
+        } else {
+            __atomic_store_n(&t->kind, VTIMER_NONE, __ATOMIC_RELEASE);
+        }
+    }
+    return earliest;
+}
+
+/**
+ * @brief Move the virtual clock once every process is blocked.
+ *
+ * Jumps to the earliest sleeper deadline, alarm or hold; with nothing
+ * pending it steps VCLOCK_IDLE_STEP_NS until the end of the day so the
+ * closing time is still reached. Sleepers are woken by one futex call and
+ * register their deadlines again before the next advance.
+ *
+ * @param end_ns Elapsed time of sim_end_minutes.
+ */
+static void vclock_advance(SharedState *state, int64_t end_ns) {
+    VirtualClock *vc = &state->vclock;
+    int64_t now = __atomic_load_n(&vc->now_ns, __ATOMIC_ACQUIRE);
+    int blocked;
+    int64_t target = vclock_scan_timers(state, now, &blocked);
+    int64_t next = __atomic_load_n(&vc->next_deadline_ns, __ATOMIC_ACQUIRE);
+    if (blocked) {
+        return;
+    }
+    if (next < target) {
+        target = next;
+    }
+    if (target == INT64_MAX) {
+        if (now >= end_ns) {
+            return;  // Day over and nothing pending: main is shutting down
+        }
+        target = now + VCLOCK_IDLE_STEP_NS;
+    }
+    if (target < now) {
+        target = now;  // Sleeper registered a deadline already reached: just wake it
+    }
+
+    __atomic_store_n(&vc->now_ns, target, __ATOMIC_RELEASE);
+    if (state->cfg.clock_source != CLOCK_SOURCE_EPOCH) {
+        double sim_ms = (double)target * state->time_acceleration * 6e-5;
+        control_set_sim_time_ms(state, (int64_t)state->sim_start_minutes * 60000 + (int64_t)sim_ms);
+    }
+    __atomic_store_n(&vc->next_deadline_ns, INT64_MAX, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&vc->generation, 1, __ATOMIC_SEQ_CST);
+    futex_wake(&vc->generation, INT32_MAX);
+    __atomic_add_fetch(&vc->advances, 1, __ATOMIC_RELAXED);
+
+    vclock_scan_timers(state, target, &blocked);
+    if (now < end_ns && target >= end_ns && state->main_pid > 0) {
+        kill(state->main_pid, SIGALRM);  // Main checks the end of the day now, not on its 1s alarm
+    }
+}
+
+/**
+ * @brief Virtual clock main loop (MAX_SPEED=1).
+ *
+ * Each round sleeps VCLOCK_SETTLE_NS so a participant the kernel has just
+ * woken gets the CPU first, then advances the clock if every live
+ * participant is waiting (vclock.waiting == vclock.participants) and none
+ * changed its waits or deadlines meanwhile (vclock.activity). A participant
+ * that died without leaving would stop the day, so once the participants
+ * have not all been waiting for VCLOCK_STALL_MS of real time the clock
+ * advances anyway, with a warning.
+ *
+ * @param res IPC resources.
+ */
+static void time_server_vclock_loop(IPCResources *res) {
+    SharedState *state = res->state;
+    VirtualClock *vc = &state->vclock;
+    int64_t end_ns = time_sim_ms_to_elapsed_ns(state, (int64_t)state->sim_end_minutes * 60000);
+
+    // Settle sleeps are short; do not let timer slack stretch them to 50us
+    prctl(PR_SET_TIMERSLACK, 1UL);
+
+    if (ipc_signal_worker_ready(res) == -1) {
+        log_error("TIME_SERVER", "Failed to signal ready, exiting");
+        return;
+    }
+    log_info("TIME_SERVER", "Time Server ready (max speed, virtual clock)");
+
+    int64_t settled_ns = time_monotonic_ns();
+    int stall_warned = 0;
+    while (g_running && control_running(state)) {
+        uint64_t before = __atomic_load_n(&vc->activity, __ATOMIC_SEQ_CST);
+        struct timespec ts = {0, VCLOCK_SETTLE_NS};
+        nanosleep(&ts, NULL);
+        int32_t waiting = __atomic_load_n(&vc->waiting, __ATOMIC_SEQ_CST);
+        int32_t participants = __atomic_load_n(&vc->participants, __ATOMIC_SEQ_CST);
+        int64_t now = time_monotonic_ns();
+        if (waiting >= participants) {
+            settled_ns = now;
+        } else if (now - settled_ns >= (int64_t)VCLOCK_STALL_MS * 1000000) {
+            if (!stall_warned) {
+                stall_warned = 1;
+                log_warn("TIME_SERVER", "Virtual clock stalled: %d of %d participants waiting "
+                         "for %d ms, advancing anyway", waiting, participants, VCLOCK_STALL_MS);
+            }
+            settled_ns = now;
+            vclock_advance(state, end_ns);
+            continue;
+        }
+        if (waiting < participants || __atomic_load_n(&vc->activity, __ATOMIC_SEQ_CST) != before) {
+            continue;
+        }
+        vclock_advance(state, end_ns);
+    }
+
+    log_info("TIME_SERVER", "Virtual clock: %llu advances, %.3f s of simulated run time",
+             (unsigned long long)__atomic_load_n(&vc->advances, __ATOMIC_RELAXED),
+             (double)__atomic_load_n(&vc->now_ns, __ATOMIC_RELAXED) / 1e9);
+    log_debug("TIME_SERVER", "Time Server exiting");
 }
 
 /**
@@ -169,7 +378,9 @@ static void update_sim_time(SharedState *state) {
  *
  * Maintains the current simulated time with sub-millisecond precision.
  * Handles SIGTSTP/SIGCONT pause tracking and offset calculation.
- * Atomically updates SharedState.current_sim_time_ms for other processes.
+ * Atomically updates SharedState.control.current_sim_time_ms for other processes
+ * every 10ms, or with CLOCK_SOURCE=1 publishes the epoch once and then sleeps
+ * until a signal arrives.
  *
  * @param res IPC resources (shared memory for time updates).
  * @param keys IPC keys (unused, kept for interface consistency).
@@ -177,10 +388,11 @@ static void update_sim_time(SharedState *state) {
 void time_server_main(IPCResources *res, IPCKeys *keys) {
     (void)keys;
     SharedState *state = res->state;
+    g_state = state;
 
     // Initialize logger
     logger_init(state, LOG_TIME_SERVER);
-    logger_set_debug_enabled(state->debug_logs_enabled);
+    logger_set_debug_enabled(state->cfg.debug_logs_enabled);
 
     log_info("TIME_SERVER", "Time Server started (PID %d)", getpid());
 
@@ -191,6 +403,14 @@ void time_server_main(IPCResources *res, IPCKeys *keys) {
         return;
     }
 
+    // A restored run started resume_elapsed_ns before now (see lifecycle/checkpoint.h)
+    if (state->resume_elapsed_ns > 0) {
+        int64_t start_ns = (int64_t)g_real_start_time.tv_sec * 1000000000 +
+                           g_real_start_time.tv_nsec - state->resume_elapsed_ns;
+        g_real_start_time.tv_sec = (time_t)(start_ns / 1000000000);
+        g_real_start_time.tv_nsec = (long)(start_ns % 1000000000);
+    }
+
     // Install signal handlers
     struct sigaction sa;
 
@@ -211,6 +431,19 @@ void time_server_main(IPCResources *res, IPCKeys *keys) {
     sigaction(SIGTERM, &sa, NULL);
     sigaction(SIGINT, &sa, NULL);
 
+    // Epoch for time_elapsed_ns() (both clock sources) and the CLOCK_SOURCE=1 clock
+    g_epoch_base_ns = (int64_t)g_real_start_time.tv_sec * 1000000000 + g_real_start_time.tv_nsec;
+    control_set_epoch(state, g_epoch_base_ns, 0);
+
+    if (state->cfg.max_speed) {
+        time_server_vclock_loop(res);
+        return;
+    }
+    if (state->cfg.clock_source == CLOCK_SOURCE_EPOCH) {
+        time_server_epoch_loop(res);
+        return;
+    }
+
     sa.sa_handler = sigalrm_handler;
     sa.sa_flags = SA_RESTART;
     sigaction(SIGALRM, &sa, NULL);
@@ -238,7 +471,7 @@ void time_server_main(IPCResources *res, IPCKeys *keys) {
     update_sim_time(state);
 
     // Main loop
-    while (g_running && state->running) {
+    while (g_running && control_running(state)) {
         // Handle resume if we got SIGCONT
         handle_resume();
 
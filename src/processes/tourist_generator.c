@@ -1,28 +1,31 @@
 #define _GNU_SOURCE
 
 #include "constants.h"
+#include "ipc/messages.h"
 #include "ipc/ipc.h"
+#include "ipc/control.h"
+#include "ipc/queue_stats.h"
 #include "core/logger.h"
 #include "core/time_sim.h"
+#include "core/rng.h"
+#include "core/arrival_schedule.h"
+#include "lifecycle/child_reaper.h"
 
 #include <errno.h>
-#include <pthread.h>
+#include <math.h>
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/msg.h>
-#include <sys/wait.h>
 #include <time.h>
 #include <unistd.h>
 
 static int g_running = 1;
 static int g_alarm_signal = 0;
 
-// Zombie reaper thread state
-static pthread_t reaper_thread;
-static volatile int reaper_running = 0;
-static volatile int active_tourists = 0;
+// Reaps tourists, pool members and hosts (signalfd + epoll thread)
+static ChildReaper g_reaper;
 
 /**
  * @brief Signal handler for SIGTERM, SIGINT, and SIGALRM.
@@ -38,87 +41,68 @@ static void signal_handler(int sig) {
 }
 
 /**
- * @brief Zombie reaper thread function.
- *
- * Uses sigwait() to wait for SIGCHLD and reaps zombie child processes.
+ * @brief Generated attributes of one tourist.
  */
-static void *reaper_thread_func(void *arg) {
-    (void)arg;
-
-    sigset_t set;
-    sigemptyset(&set);
-    sigaddset(&set, SIGCHLD);
-
-    while (reaper_running) {
-        int sig;
-        int ret = sigwait(&set, &sig);
-
-        if (ret != 0 || !reaper_running) {
-            break;
-        }
-
-        // Reap all zombie children (multiple may have exited)
-        pid_t pid;
-        int status;
-        while ((pid = waitpid(-1, &status, WNOHANG)) > 0) {
-            __atomic_fetch_sub(&active_tourists, 1, __ATOMIC_SEQ_CST);
-        }
-    }
-
-    return NULL;
-}
+typedef struct {
+    int age;
+    TouristType type;
+    int vip;
+    TicketType ticket;
+    int kid_count;
+} TouristAttrs;
+
+// Random draws per tourist record (one RngLanes step each)
+enum {
+    DRAW_AGE_BAND = 0,
+    DRAW_AGE,
+    DRAW_TYPE,
+    DRAW_VIP,
+    DRAW_TICKET,
+    DRAW_FAMILY,
+    DRAW_KIDS,
+    DRAW_COUNT
+};
+
+// Attribute records filled per refill (whole RngLanes steps)
+#define TOURIST_ATTR_BATCH (RNG_LANES * 4)
+
+static RngLanes g_rng;
+static TouristAttrs g_attr_batch[TOURIST_ATTR_BATCH];
+static int g_attr_next = TOURIST_ATTR_BATCH;
+
+// Poisson arrival process (ARRIVAL_RATE > 0)
+static Rng g_arrival_rng;
+static double g_last_arrival_ms = -1.0;  // Sim ms since midnight of the previous arrival
+
+// Spawn timing against the arrival times (schedule or Poisson)
+static int g_spawns_late = 0;
+static int64_t g_max_spawn_lag_ns = 0;
 
 /**
- * @brief Start the zombie reaper thread.
- *
- * @return 0 on success, -1 on error.
- */
-static int start_reaper_thread(void) {
-    reaper_running = 1;
-    if (pthread_create(&reaper_thread, NULL, reaper_thread_func, NULL) != 0) {
-        perror("generator: pthread_create reaper");
-        reaper_running = 0;
-        return -1;
-    }
-    return 0;
-}
-
-/**
- * @brief Stop the zombie reaper thread.
- */
-static void stop_reaper_thread(void) {
-    if (!reaper_running) {
-        return;
-    }
-
-    reaper_running = 0;
-    pthread_kill(reaper_thread, SIGCHLD);  // Wake up sigwait()
-    pthread_join(reaper_thread, NULL);
-}
-
-/**
- * @brief Generate random age (8-80) and check if person can have kids.
+ * @brief Generate age (8-80) and check if person can have kids.
  *
  * Adults 26+ can be guardians for kids aged 4-7.
  *
+ * @param band Random bits choosing the age band.
+ * @param pick Random bits choosing the age within the band.
  * @param can_have_kids Output: 1 if person can be a guardian, 0 otherwise.
  * @return Generated age in years.
  */
-static int generate_age(int *can_have_kids) {
-    int r = rand() % 100;
+static int generate_age(uint64_t band, uint64_t pick, int *can_have_kids) {
+    int r = rng_scale(band, 100);
 
     if (r < 5) {
         *can_have_kids = 1;  // Seniors 65+ can be guardians
-        return 65 + (rand() % 16);  // 5% seniors (65-80)
+        return 65 + rng_scale(pick, 16);  // 5% seniors (65-80)
     } else if (r < 15) {
         *can_have_kids = 0;  // Young (8-17) cannot have kids
-        return 8 + (rand() % 10);   // 10% young (8-17)
+        return 8 + rng_scale(pick, 10);   // 10% young (8-17)
     } else if (r < 30) {
         *can_have_kids = 0;  // Young adults 18-25 cannot have kids
-        return 18 + (rand() % 8);   // 15% young adults (18-25)
+        return 18 + rng_scale(pick, 8);   // 15% young adults (18-25)
     } else {
         *can_have_kids = 1;  // Adults 26+ can be guardians
-        return 26 + (rand() % 39);  // 70% adults (26-64)
+        return 26 + rng_scale(pick, 39);  // 70% adults (26-64)
     }
 }
 
@@ -126,12 +110,13 @@ static int generate_age(int *can_have_kids) {
  * @brief Generate number of kids for a family (1-2).
  *
  * Distribution: ~63% one kid, ~37% two kids (based on original 25:15 ratio).
- * Only called when family_percentage check already passed.
+ * Only used when family_percentage check already passed.
  *
+ * @param x Random bits.
  * @return Number of children (1 or 2).
  */
-static int generate_kid_count(void) {
-    int r = rand() % 100;
+static int generate_kid_count(uint64_t x) {
+    int r = rng_scale(x, 100);
     if (r < 63) return 1;  // 63% one kid
     return 2;              // 37% two kids
 }
@@ -141,10 +126,11 @@ static int generate_kid_count(void) {
  * @brief Generate tourist type based on walker/cyclist percentage config.
  *
  * @param state Shared state with walker_percentage setting.
+ * @param x Random bits.
  * @return TOURIST_WALKER or TOURIST_CYCLIST.
  */
-static TouristType generate_type(SharedState *state) {
-    return (rand() % 100) < state->walker_percentage ? TOURIST_WALKER : TOURIST_CYCLIST;
+static TouristType generate_type(const SharedState *state, uint64_t x) {
+    return rng_scale(x, 100) < state->cfg.walker_percentage ? TOURIST_WALKER : TOURIST_CYCLIST;
 }
 
 /**
@@ -152,10 +138,11 @@ static TouristType generate_type(SharedState *state) {
  *
  * Distribution: 30% single, 20% T1, 20% T2, 15% T3, 15% daily.
  *
+ * @param x Random bits.
  * @return Random ticket type.
  */
-static TicketType select_ticket_type(void) {
-    int r = rand() % 100;
+static TicketType select_ticket_type(uint64_t x) {
+    int r = rng_scale(x, 100);
     if (r < 30) return TICKET_SINGLE;
     if (r < 50) return TICKET_TIME_T1;
     if (r < 70) return TICKET_TIME_T2;
@@ -167,18 +154,305 @@ static TicketType select_ticket_type(void) {
  * @brief Check if tourist should be VIP based on percentage config.
  *
  * @param state Shared state with vip_percentage setting.
+ * @param x Random bits.
  * @return 1 if VIP, 0 otherwise.
  */
-static int is_vip(SharedState *state) {
-    return (rand() % 100) < state->vip_percentage;
+static int is_vip(const SharedState *state, uint64_t x) {
+    return rng_scale(x, 100) < state->cfg.vip_percentage;
+}
+
+/**
+ * @brief Fill g_attr_batch with TOURIST_ATTR_BATCH new tourists.
+ *
+ * Draws DRAW_COUNT RngLanes steps per RNG_LANES records (lane L feeds
+ * record L of the group), then maps the draws to attributes. Only walkers
+ * 26+ who pass family_percentage become families.
+ *
+ * @param state Shared state with the distribution settings.
+ */
+static void generate_tourist_batch(const SharedState *state) {
+    for (int g = 0; g < TOURIST_ATTR_BATCH; g += RNG_LANES) {
+        uint64_t draws[DRAW_COUNT][RNG_LANES];
+        for (int d = 0; d < DRAW_COUNT; d++) {
+            rng_lanes_next(&g_rng, draws[d]);
+        }
+
+        for (int l = 0; l < RNG_LANES; l++) {
+            TouristAttrs *a = &g_attr_batch[g + l];
+            int can_have_kids = 0;
+            a->age = generate_age(draws[DRAW_AGE_BAND][l], draws[DRAW_AGE][l], &can_have_kids);
+            a->type = generate_type(state, draws[DRAW_TYPE][l]);
+            a->vip = is_vip(state, draws[DRAW_VIP][l]);
+            a->ticket = select_ticket_type(draws[DRAW_TICKET][l]);
+            a->kid_count = 0;
+
+            // Determine if this walker becomes a family (only walkers 26+ can have kids)
+            if (a->type == TOURIST_WALKER && can_have_kids && a->age >= 26 &&
+                rng_scale(draws[DRAW_FAMILY][l], 100) < state->cfg.family_percentage) {
+                a->kid_count = generate_kid_count(draws[DRAW_KIDS][l]);
+                a->type = TOURIST_FAMILY;
+            }
+        }
+    }
+    g_attr_next = 0;
+}
+
+/**
+ * @brief Next generated tourist (refills the batch when it runs out).
+ *
+ * @param state Shared state with the distribution settings.
+ * @return Attributes of the next tourist.
+ */
+static TouristAttrs next_tourist_attrs(const SharedState *state) {
+    if (g_attr_next == TOURIST_ATTR_BATCH) {
+        generate_tourist_batch(state);
+    }
+    return g_attr_batch[g_attr_next++];
+}
+
+/**
+ * @brief Time of the next Poisson arrival on the time_elapsed_ns() timeline.
+ *
+ * The rate is piecewise constant per simulated hour (arrival_rate_hour).
+ * An Exp(1) draw is spent against the integrated rate hour by hour from the
+ * previous arrival, which gives the next arrival of the non-homogeneous
+ * process exactly (inversion, no rejected draws). Hours with rate 0 are
+ * skipped.
+ *
+ * @param state Shared state with the rate profile and the sim day.
+ * @return Pause-adjusted ns since the simulation start, or -1 when there is
+ *         no arrival left before the end of the simulated day.
+ */
+static int64_t next_poisson_arrival_ns(const SharedState *state) {
+    const double hour_ms = 3600000.0;
+    double start_ms = state->sim_start_minutes * 60000.0;
+    double end_ms = state->sim_end_minutes * 60000.0;
+    double t = g_last_arrival_ms < 0 ? start_ms : g_last_arrival_ms;
+
+    // Uniform in (0, 1): -log() is finite and > 0
+    double u = ((double)(rng_next(&g_arrival_rng) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    double need = -log(u);
+
+    while (t < end_ms) {
+        double hour_end = (floor(t / hour_ms) + 1.0) * hour_ms;
+        if (hour_end > end_ms) {
+            hour_end = end_ms;
+        }
+        double rate_per_ms = state->arrival_rate_hour[(int)(t / hour_ms) % ARRIVAL_RATE_HOURS] / hour_ms;
+        double expected = rate_per_ms * (hour_end - t);
+        if (need <= expected) {
+            t += need / rate_per_ms;
+            g_last_arrival_ms = t;
+            return (int64_t)((t - start_ms) / (state->time_acceleration * 6e-5));
+        }
+        need -= expected;
+        t = hour_end;
+    }
+    g_last_arrival_ms = end_ms;
+    return -1;
+}
+
+/**
+ * @brief Sleep until a tourist's arrival time and record how late the spawn is.
+ *
+ * Arrival times are absolute, so a slow fork or a full spawn queue only
+ * delays the tourists behind it until the generator catches up; it does
+ * not lower the offered rate.
+ *
+ * @param state Shared state.
+ * @param arrival_ns Arrival on the time_elapsed_ns() timeline.
+ * @return 0 at (or past) the arrival time, -1 on shutdown.
+ */
+static int wait_for_arrival(SharedState *state, int64_t arrival_ns) {
+    if (time_sleep_until_elapsed_ns(state, arrival_ns, &g_running) == -1) {
+        return -1;
+    }
+    int64_t lag_ns = time_elapsed_ns(state) - arrival_ns;
+    if (lag_ns > ARRIVAL_LATE_NS) {
+        g_spawns_late++;
+    }
+    if (lag_ns > g_max_spawn_lag_ns) {
+        g_max_spawn_lag_ns = lag_ns;
+    }
+    return 0;
+}
+
+/**
+ * @brief Fixed TOURIST_SPAWN_DELAY_US pause between spawns.
+ *
+ * On the virtual clock with MAX_SPEED=1, so the delay is simulated time
+ * there as well.
+ *
+ * @param state Shared state.
+ * @param delay_us Delay in microseconds (0 = none).
+ */
+static void spawn_pause(SharedState *state, int delay_us) {
+    if (delay_us <= 0) {
+        return;
+    }
+    if (state->cfg.max_speed) {
+        time_sleep_until_elapsed_ns(state, time_elapsed_ns(state) + (int64_t)delay_us * 1000,
+                                    &g_running);
+    } else {
+        usleep(delay_us);
+    }
+}
+
+/**
+ * @brief Draw the whole arrival schedule (ARRIVAL_SCHEDULE=1) and save it for replays.
+ *
+ * With a Poisson rate profile every tourist gets its arrival time, and the
+ * schedule ends early if the day has no arrivals left. Otherwise tourist N
+ * spawns (N - 1) * TOURIST_SPAWN_DELAY_US after the schedule is drawn.
+ *
+ * @param state Shared state with the distribution settings.
+ * @param schedule Schedule block to fill (capacity TOTAL_TOURISTS).
+ */
+static void build_arrival_schedule(SharedState *state, ArrivalSchedule *schedule) {
+    int64_t start_ns = time_monotonic_ns();
+    uint64_t base_us = (uint64_t)time_elapsed_ns(state) / 1000;
+    uint32_t capacity = (uint32_t)state->tourists_to_generate;
+    uint64_t delay_us = (uint64_t)state->cfg.tourist_spawn_delay_us;
+    uint32_t count = 0;
+
+    for (uint32_t i = 0; i < capacity; i++) {
+        uint64_t spawn_us = base_us + i * delay_us;
+        if (state->arrival_poisson) {
+            int64_t arrival_ns = next_poisson_arrival_ns(state);
+            if (arrival_ns < 0) {
+                break;
+            }
+            spawn_us = (uint64_t)arrival_ns / 1000;
+        }
+
+        TouristAttrs a = next_tourist_attrs(state);
+        TouristDescriptor *d = &schedule->tourists[i];
+        d->id = (int32_t)i + 1;
+        d->age = (uint8_t)a.age;
+        d->type = (uint8_t)a.type;
+        d->vip = (uint8_t)a.vip;
+        d->kid_count = (uint8_t)a.kid_count;
+        d->ticket = (uint8_t)a.ticket;
+        d->spawn_us = spawn_us > UINT32_MAX ? UINT32_MAX : (uint32_t)spawn_us;
+        count++;
+    }
+    arrival_schedule_publish(schedule, count);
+
+    log_info("GENERATOR", "Arrival schedule: %u tourists drawn in %.2f ms", count,
+             (double)(time_monotonic_ns() - start_ns) / 1e6);
+    if (arrival_schedule_save(schedule, ARRIVAL_SCHEDULE_FILE_NAME) == 0) {
+        log_debug("GENERATOR", "Arrival schedule saved to %s", ARRIVAL_SCHEDULE_FILE_NAME);
+    }
+}
+
+/**
+ * @brief Attributes of a scheduled tourist.
+ */
+static TouristAttrs descriptor_attrs(const TouristDescriptor *d) {
+    TouristAttrs a;
+    a.age = d->age;
+    a.type = (TouristType)d->type;
+    a.vip = d->vip;
+    a.ticket = (TicketType)d->ticket;
+    a.kid_count = d->kid_count;
+    return a;
+}
+
+/**
+ * @brief Start the pre-forked tourist pool.
+ *
+ * Each pool member is exec'd once as "tourist --pool" (one tourist at a
+ * time), "tourist --host" (one thread per tourist), "tourist --events"
+ * (event engine) or "tourist --fibers" (fiber engine), attaches to IPC once,
+ * and then runs tourists from descriptors sent over MQ_SPAWN.
+ *
+ * @param state Shared state (each member is a virtual clock participant).
+ * @param tourist_exe Path to tourist executable.
+ * @param pool_size Number of pool members to start.
+ * @param mode_arg "--pool", "--host", "--events" or "--fibers".
+ * @return Number of pool members started.
+ */
+static int start_tourist_pool(SharedState *state, const char *tourist_exe, int pool_size,
+                              const char *mode_arg) {
+    int started = 0;
+
+    for (int i = 0; i < pool_size && g_running; i++) {
+        int64_t spawn_ns = time_monotonic_ns();
+        time_participant_add(state);
+        pid_t pid = fork();
+
+        if (pid == -1) {
+            perror("generator: fork pool member");
+            time_participant_remove(state);
+            break;
+        }
+
+        if (pid == 0) {
+            execl(tourist_exe, "tourist", mode_arg, NULL);
+            perror("generator: execl pool member");
+            time_participant_remove(state);
+            _exit(1);
+        }
+
+        child_reaper_track(&g_reaper, pid, spawn_ns, 0);
+        started++;
+    }
+
+    return started;
+}
+
+/**
+ * @brief Wait until the remote gateway queues no more tourists (REMOTE_PORT > 0).
+ *
+ * Remote tourists go onto MQ_SPAWN from the gateway, so the pool sentinels
+ * must not be queued ahead of them.
+ *
+ * @param state Shared state.
+ */
+static void wait_for_remote_hosts(SharedState *state) {
+    if (state->cfg.remote_port == 0) {
+        return;
+    }
+    log_debug("GENERATOR", "Waiting for the remote gateway before the pool sentinels");
+    while (g_running && control_running(state) &&
+           !__atomic_load_n(&state->remote.done, __ATOMIC_ACQUIRE)) {
+        usleep(REMOTE_POLL_MS * 1000);
+    }
+}
+
+/**
+ * @brief Send a tourist descriptor to the pool (retries on EINTR while running).
+ *
+ * @param res IPC resources.
+ * @param msg Descriptor to send (tourist_id == 0 for sentinel).
+ * @return 0 on success, -1 on shutdown or error.
+ */
+static int send_spawn_descriptor(IPCResources *res, TouristSpawnMsg *msg) {
+    msg->mtype = 1;
+    while (queue_msgsnd(res->state, QUEUE_SPAWN, res->mq_spawn_id, msg, sizeof(*msg) - sizeof(long), 0) == -1) {
+        if (errno == EINTR && g_running) {
+            continue;
+        }
+        if (errno != EINTR && errno != EIDRM && errno != EINVAL) {
+            perror("generator: msgsnd spawn");
+        }
+        return -1;
+    }
+    return 0;
 }
 
 /**
  * @brief Tourist generator process entry point.
  *
  * Spawns tourist processes with random attributes (age, type, VIP status,
- * ticket type, kids). Uses fork+exec to create tourist processes. Uses a
- * dedicated zombie reaper thread to handle SIGCHLD via sigwait().
+ * ticket type, kids). Uses fork+exec to create tourist processes, or, when
+ * TOURIST_POOL_SIZE > 0 or TOURIST_ENGINE=1/2/3, hands descriptors over
+ * MQ_SPAWN to pre-forked pool members, thread hosts, the event host or the
+ * fiber host. Children are reaped by a signalfd/epoll thread
+ * (lifecycle/child_reaper.h) that records their exit status and lifetime.
+ * With ARRIVAL_SCHEDULE > 0 the attributes and spawn times come from the
+ * arrival schedule and each tourist is handed over by ID only. With
+ * REMOTE_PORT > 0 the last REMOTE_TOURISTS IDs are left to the remote gateway.
  *
  * @param res IPC resources (shared memory for config values).
  * @param keys IPC keys (unused, kept for interface consistency).
@@ -187,23 +461,20 @@ static int is_vip(SharedState *state) {
 void tourist_generator_main(IPCResources *res, IPCKeys *keys, const char *tourist_exe) {
     (void)keys;
 
+    // Main counted the generator as a participant before forking it
+    time_participant_adopt(res->state);
+
     // Initialize logger with component type
     logger_init(res->state, LOG_GENERATOR);
-    logger_set_debug_enabled(res->state->debug_logs_enabled);
-
-    // Block SIGCHLD - will be handled by reaper thread via sigwait()
-    sigset_t sigchld_mask;
-    sigemptyset(&sigchld_mask);
-    sigaddset(&sigchld_mask, SIGCHLD);
-    pthread_sigmask(SIG_BLOCK, &sigchld_mask, NULL);
+    logger_set_debug_enabled(res->state->cfg.debug_logs_enabled);
 
-    // Start zombie reaper thread
-    if (start_reaper_thread() != 0) {
+    // Blocks SIGCHLD and reads it from a signalfd on the reaper thread
+    if (child_reaper_start(&g_reaper, res->state) != 0) {
         log_error("GENERATOR", "Failed to start reaper thread");
         return;
     }
 
-    // Install signal handlers (not SIGCHLD - handled by thread)
+    // Install signal handlers (not SIGCHLD - read by the reaper)
     struct sigaction sa;
     sa.sa_handler = signal_handler;
     sigemptyset(&sa.sa_mask);
@@ -212,42 +483,146 @@ void tourist_generator_main(IPCResources *res, IPCKeys *keys, const char *touris
     sigaction(SIGINT, &sa, NULL);
     sigaction(SIGALRM, &sa, NULL);
 
-    // Seed random number generator
-    srand(time(NULL) ^ getpid());
+    // Attribute and arrival streams: reproducible with RANDOM_SEED
+    uint64_t seed = rng_base_seed(res->state->cfg.random_seed);
+    rng_lanes_seed(&g_rng, seed, RNG_STREAM_GENERATOR);
+    rng_seed(&g_arrival_rng, seed, RNG_STREAM_ARRIVALS);
 
     log_info("GENERATOR", "Tourist generator started (total: %d, delay: %d us)",
-             res->state->tourists_to_generate, res->state->tourist_spawn_delay_us);
+             res->state->tourists_to_generate, res->state->cfg.tourist_spawn_delay_us);
 
-    int tourist_id = 0;
+    // A restored run goes on from the checkpoint's next ID (0 otherwise)
+    int tourist_id = res->state->resume_tourists;
     int total_to_spawn = res->state->tourists_to_generate;
-    int spawn_delay_us = res->state->tourist_spawn_delay_us;
+    int spawn_delay_us = res->state->cfg.tourist_spawn_delay_us;
+    int pool_size = res->state->cfg.tourist_pool_size;
+
+    // Precomputed schedule: drawn here (mode 1) or loaded by main (mode 2)
+    ArrivalSchedule *schedule = arrival_schedule_get(res->state);
+    if (schedule != NULL && res->state->cfg.arrival_schedule == ARRIVAL_SCHEDULE_GENERATE &&
+        !res->state->restored) {
+        build_arrival_schedule(res->state, schedule);
+    }
+    if (res->state->restored) {
+        // Same attribute stream as the checkpointed run with RANDOM_SEED; Poisson arrivals resume there
+        for (int i = 0; i < tourist_id && schedule == NULL; i++) {
+            next_tourist_attrs(res->state);
+        }
+        g_last_arrival_ms = (double)res->state->resume_sim_ms;
+        log_info("GENERATOR", "Restored run: spawning from tourist %d", tourist_id + 1);
+    }
+    if (schedule != NULL) {
+        total_to_spawn = (int)schedule->count;
+    }
+    // The last REMOTE_TOURISTS IDs are handed out by the remote gateway
+    if (res->state->cfg.remote_port > 0) {
+        total_to_spawn -= res->state->cfg.remote_tourists;
+    }
+    int paced = schedule != NULL || res->state->arrival_poisson;
+    if (paced) {
+        spawn_delay_us = 0;  // Paced by arrival times instead
+    }
 
-    while (g_running && res->state->running && tourist_id < total_to_spawn) {
+    if (res->state->cfg.tourist_engine == TOURIST_ENGINE_EVENT) {
+        // Event engine: a single process drives every tourist as a state record
+        pool_size = start_tourist_pool(res->state, tourist_exe, 1, "--events");
+        log_info("GENERATOR", "Started tourist event engine (%d process)", pool_size);
+        if (pool_size == 0) {
+            g_running = 0;
+        }
+    } else if (res->state->cfg.tourist_engine == TOURIST_ENGINE_FIBER) {
+        // Fiber engine: one process, FIBER_THREADS scheduler threads inside it
+        pool_size = start_tourist_pool(res->state, tourist_exe, 1, "--fibers");
+        log_info("GENERATOR", "Started tourist fiber engine (%d process, %d threads)",
+                 pool_size, res->state->cfg.fiber_threads);
+        if (pool_size == 0) {
+            g_running = 0;
+        }
+    } else if (res->state->cfg.tourist_engine == TOURIST_ENGINE_THREAD) {
+        // Thread engine: TOURIST_POOL_SIZE is the number of host processes (default 1)
+        if (pool_size == 0) {
+            pool_size = 1;
+        }
+        pool_size = start_tourist_pool(res->state, tourist_exe, pool_size, "--host");
+        log_info("GENERATOR", "Started tourist thread hosts (%d processes)", pool_size);
+        if (pool_size == 0) {
+            g_running = 0;
+        }
+    } else if (pool_size > 0) {
+        pool_size = start_tourist_pool(res->state, tourist_exe, pool_size, "--pool");
+        log_info("GENERATOR", "Started tourist pool (%d processes)", pool_size);
+        if (pool_size == 0) {
+            g_running = 0;
+        }
+    }
+
+    while (g_running && control_running(res->state) && tourist_id < total_to_spawn) {
         // Check if closing
-        if (res->state->closing) {
+        if (control_closing(res->state)) {
             log_info("GENERATOR", "Station closing, stopping tourist generation");
             break;
         }
 
-        // Generate tourist attributes
+        // Generate tourist attributes, waiting for the arrival time when paced
         tourist_id++;
-        int can_have_kids = 0;
-        int age = generate_age(&can_have_kids);
-        TouristType type = generate_type(res->state);
-        int vip = is_vip(res->state);
-        TicketType ticket = select_ticket_type();
-
-        // Determine if this walker becomes a family (only walkers 26+ can have kids)
-        int kid_count = 0;
-        if (type == TOURIST_WALKER && can_have_kids && age >= 26) {
-            // Use family_percentage to decide if walker becomes a family
-            if ((rand() % 100) < res->state->family_percentage) {
-                kid_count = generate_kid_count();
-                type = TOURIST_FAMILY;
+        TouristAttrs attrs;
+        if (schedule != NULL) {
+            const TouristDescriptor *d = &schedule->tourists[tourist_id - 1];
+            if (wait_for_arrival(res->state, (int64_t)d->spawn_us * 1000) == -1) {
+                tourist_id--;
+                break;
+            }
+            attrs = descriptor_attrs(d);
+        } else if (res->state->arrival_poisson) {
+            int64_t arrival_ns = next_poisson_arrival_ns(res->state);
+            if (arrival_ns < 0) {
+                log_info("GENERATOR", "No arrivals left in the rate profile today");
+                tourist_id--;
+                break;
+            }
+            if (wait_for_arrival(res->state, arrival_ns) == -1) {
+                tourist_id--;
+                break;
+            }
+            attrs = next_tourist_attrs(res->state);
+        } else {
+            attrs = next_tourist_attrs(res->state);
+        }
+        int age = attrs.age;
+        TouristType type = attrs.type;
+        int vip = attrs.vip;
+        TicketType ticket = attrs.ticket;
+        int kid_count = attrs.kid_count;
+
+        const char *type_names[] = {"walker", "cyclist", "family"};
+        const char *type_name = type_names[type];
+        const char *ticket_names[] = {"SINGLE", "T1", "T2", "T3", "DAILY"};
+
+        if (pool_size > 0) {
+            // Hand descriptor to the pool (blocks if every member is busy and the queue is full)
+            TouristSpawnMsg msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.tourist_id = tourist_id;
+            if (schedule == NULL) {
+                msg.age = age;
+                msg.tourist_type = type;
+                msg.is_vip = vip;
+                msg.kid_count = kid_count;
+                msg.ticket_type = ticket;
+            }
+            if (send_spawn_descriptor(res, &msg) == -1) {
+                tourist_id--;
+                break;
             }
+            __atomic_store_n(&res->state->tourists_spawned, tourist_id, __ATOMIC_RELEASE);
+
+            log_debug("GENERATOR", "Queued tourist %d: age=%d, type=%s, vip=%s, kids=%d, ticket=%s (pool)",
+                      tourist_id, age, type_name, vip ? "yes" : "no", kid_count, ticket_names[ticket]);
+            spawn_pause(res->state, spawn_delay_us);
+            continue;
         }
 
-        // Prepare arguments for exec
+        // Prepare arguments for exec (a scheduled tourist gets only its ID)
         char id_str[16];
         char age_str[8];
         char type_str[2];
@@ -256,38 +631,46 @@ void tourist_generator_main(IPCResources *res, IPCKeys *keys, const char *touris
         char ticket_str[2];
 
         snprintf(id_str, sizeof(id_str), "%d", tourist_id);
-        snprintf(age_str, sizeof(age_str), "%d", age);
-        snprintf(type_str, sizeof(type_str), "%d", type);
-        snprintf(vip_str, sizeof(vip_str), "%d", vip);
-        snprintf(kid_count_str, sizeof(kid_count_str), "%d", kid_count);
-        snprintf(ticket_str, sizeof(ticket_str), "%d", ticket);
+        if (schedule == NULL) {
+            snprintf(age_str, sizeof(age_str), "%d", age);
+            snprintf(type_str, sizeof(type_str), "%d", type);
+            snprintf(vip_str, sizeof(vip_str), "%d", vip);
+            snprintf(kid_count_str, sizeof(kid_count_str), "%d", kid_count);
+            snprintf(ticket_str, sizeof(ticket_str), "%d", ticket);
+        }
 
         // Fork and exec tourist process
+        int64_t spawn_ns = time_monotonic_ns();
+        time_participant_add(res->state);
         pid_t pid = fork();
 
         if (pid == -1) {
             perror("generator: fork");
-            usleep(spawn_delay_us);
+            time_participant_remove(res->state);
+            spawn_pause(res->state, spawn_delay_us);
             continue;
         }
 
         if (pid == 0) {
             // Child process - stays in foreground process group for SIGTSTP
             // exec tourist
-            execl(tourist_exe, "tourist", id_str, age_str, type_str, vip_str,
-                  kid_count_str, ticket_str, NULL);
+            if (schedule != NULL) {
+                execl(tourist_exe, "tourist", id_str, NULL);
+            } else {
+                execl(tourist_exe, "tourist", id_str, age_str, type_str, vip_str,
+                      kid_count_str, ticket_str, NULL);
+            }
 
             // If exec fails
             perror("generator: execl");
+            time_participant_remove(res->state);
             _exit(1);
         }
 
-        // Parent process - increment active count
-        __atomic_fetch_add(&active_tourists, 1, __ATOMIC_SEQ_CST);
+        // Parent process - fork time and ID for the reaper
+        child_reaper_track(&g_reaper, pid, spawn_ns, tourist_id);
+        __atomic_store_n(&res->state->tourists_spawned, tourist_id, __ATOMIC_RELEASE);
 
-        const char *type_names[] = {"walker", "cyclist", "family"};
-        const char *type_name = type_names[type];
-        const char *ticket_names[] = {"SINGLE", "T1", "T2", "T3", "DAILY"};
         if (kid_count > 0) {
             log_debug("GENERATOR", "Spawned tourist %d: age=%d, type=%s, vip=%s, kids=%d, ticket=%s (PID %d)",
                      tourist_id, age, type_name, vip ? "yes" : "no", kid_count, ticket_names[ticket], pid);
@@ -297,33 +680,30 @@ void tourist_generator_main(IPCResources *res, IPCKeys *keys, const char *touris
         }
 
         // Sleep before next spawn (if delay configured)
-        usleep(spawn_delay_us);
+        spawn_pause(res->state, spawn_delay_us);
     }
 
     log_info("GENERATOR", "Tourist generator shutting down (spawned %d tourists)", tourist_id);
+    if (paced) {
+        log_info("GENERATOR", "Arrival timing: %d of %d spawns more than 1 ms late (max %.2f ms)",
+                 g_spawns_late, tourist_id, (double)g_max_spawn_lag_ns / 1e6);
+    }
 
-    // Stop reaper thread first
-    stop_reaper_thread();
-
-    // Wait for all children using blocking waitpid (proper synchronization, no polling)
-    int current_active = __atomic_load_n(&active_tourists, __ATOMIC_SEQ_CST);
-    log_debug("GENERATOR", "Waiting for %d tourists to exit...", current_active);
-
-    pid_t pid;
-    int status;
-    while (1) {
-        pid = waitpid(-1, &status, 0);
-        if (pid > 0) {
-            log_debug("GENERATOR", "Reaped tourist PID %d", pid);
-            continue;
-        }
-        if (pid == -1 && errno == EINTR) {
-            // Signal interrupted waitpid, retry
-            continue;
+    // One sentinel per pool member: queued behind remaining descriptors, so the
+    // pool drains all work before exiting
+    wait_for_remote_hosts(res->state);
+    for (int i = 0; i < pool_size; i++) {
+        TouristSpawnMsg sentinel;
+        memset(&sentinel, 0, sizeof(sentinel));
+        if (send_spawn_descriptor(res, &sentinel) == -1) {
+            break;
         }
-        // ECHILD or other error - no more children
-        break;
     }
 
+    // The reaper drains the rest and exits once waitid reports no children
+    time_participant_leave(res->state);
+    log_debug("GENERATOR", "Waiting for %d tourists to exit...", child_reaper_active(&g_reaper));
+    child_reaper_finish(&g_reaper);
+
     log_debug("GENERATOR", "All tourists exited");
 }
@@ -3,8 +3,15 @@
 #include "constants.h"
 #include "ipc/messages.h"
 #include "ipc/ipc.h"
+#include "ipc/transport.h"
+#include "ipc/control.h"
+#include "ipc/numa.h"
 #include "core/logger.h"
 #include "core/time_sim.h"
+#include "core/rng.h"
+#include "core/chair_tracker.h"
+#include "core/trace.h"
+#include "core/danger_schedule.h"
 #include "common/signal_common.h"
 #include "common/worker_emergency.h"
 
@@ -21,11 +28,14 @@ static int g_emergency_signal = 0;
 static int g_resume_signal = 0;
 static int g_alarm_signal = 0;
 static double g_last_danger_time_sim = 0.0;       // Last danger detection (sim minutes)
+static uint32_t g_danger_cursor = 0;              // Next replay script event (DANGER_SCHEDULE=2)
 static double g_emergency_start_time_sim = 0.0;  // When current emergency started (sim minutes)
 static int g_is_emergency_initiator = 0;         // 1 if this worker detected danger
+static const char *g_tag = "UPPER_WORKER";          // Log tag (carries the line number on lines > 0)
 
 // State pointers for worker_emergency functions
 static WorkerEmergencyState g_emergency_state;
+static Rng g_rng;                                // Danger checks (RANDOM_SEED stream per line)
 
 /**
  * @brief Get the appropriate logging tag for a tourist based on type.
@@ -42,23 +52,46 @@ static const char *get_tourist_tag(TouristType type) {
 // Use macro-generated signal handler for emergency-capable workers
 DEFINE_EMERGENCY_SIGNAL_HANDLER(signal_handler, "UPPER_WORKER")
 
+/**
+ * @brief Record a detected danger and stop the line.
+ *
+ * @param res IPC resources for emergency coordination.
+ * @param sim_ms Sim ms since midnight of the detection.
+ */
+static void trigger_danger(IPCResources *res, int64_t sim_ms) {
+    danger_schedule_record(res->state, res->line, WORKER_UPPER, sim_ms);
+    trace_emit(TRACE_SRC_UPPER, TRACE_DANGER_DETECTED, 0, 0, -1, res->line);
+    worker_trigger_emergency_stop(res, WORKER_UPPER, &g_emergency_state);
+}
+
 /**
  * @brief Check for random danger and trigger emergency stop if detected.
  *
- * Uses pause-adjusted time for cooldown calculation.
+ * Uses pause-adjusted time for cooldown calculation. With DANGER_SCHEDULE=2
+ * the recorded stops replace the random draw.
  *
  * @param res IPC resources for emergency coordination.
  * @return 1 if danger was detected, 0 otherwise.
  */
 static int check_for_danger(IPCResources *res) {
-    int probability = res->state->danger_probability;
+    if (res->state->cfg.danger_schedule == DANGER_SCHEDULE_REPLAY) {
+        int64_t now_ms = time_get_sim_ms(res->state);
+        if (!danger_schedule_due(res->state, res->line, WORKER_UPPER, &g_danger_cursor, now_ms)) {
+            return 0;
+        }
+        g_last_danger_time_sim = (double)now_ms / 60000.0;
+        trigger_danger(res, now_ms);
+        return 1;
+    }
+
+    int probability = res->state->cfg.danger_probability;
     if (probability <= 0) {
         return 0;  // Danger detection disabled
     }
 
     // Check if still within duration of previous danger (can't trigger new one)
     double now_sim = time_get_sim_minutes_f(res->state);
-    int duration_sim = res->state->danger_duration_sim;
+    int duration_sim = res->state->cfg.danger_duration_sim;
 
     if (g_last_danger_time_sim > 0) {
         if ((now_sim - g_last_danger_time_sim) < duration_sim) {
@@ -67,68 +100,14 @@ static int check_for_danger(IPCResources *res) {
     }
 
     // Random check
-    if ((rand() % 100) < probability) {
+    if (rng_below(&g_rng, 100) < probability) {
         g_last_danger_time_sim = now_sim;  // Store simulated time
-        worker_trigger_emergency_stop(res, WORKER_UPPER, &g_emergency_state);
+        trigger_danger(res, time_get_sim_ms(res->state));
         return 1;
     }
     return 0;
 }
 
-// ============================================================================
-// Chair tracking for atomic SEM_CHAIRS release
-// ============================================================================
-
-#define MAX_ACTIVE_CHAIRS 64  // Track up to 64 chairs in transit
-
-typedef struct {
-    int chair_id;
-    int expected;   // tourists_on_chair
-    int arrived;    // count of tourists arrived so far
-} ChairTracker;
-
-static ChairTracker g_chairs[MAX_ACTIVE_CHAIRS];
-static int g_chair_count = 0;
-
-/**
- * @brief Find or create a tracker for a chair.
- *
- * @param chair_id Chair identifier to find or create tracker for.
- * @param tourists_on_chair Expected number of tourists on this chair.
- * @return Pointer to tracker, or NULL if tracking array is full.
- */
-static ChairTracker* get_chair_tracker(int chair_id, int tourists_on_chair) {
-    // Find existing tracker
-    for (int i = 0; i < g_chair_count; i++) {
-        if (g_chairs[i].chair_id == chair_id) {
-            return &g_chairs[i];
-        }
-    }
-
-    // Create new tracker
-    if (g_chair_count < MAX_ACTIVE_CHAIRS) {
-        g_chairs[g_chair_count].chair_id = chair_id;
-        g_chairs[g_chair_count].expected = tourists_on_chair;
-        g_chairs[g_chair_count].arrived = 0;
-        return &g_chairs[g_chair_count++];
-    }
-
-    return NULL;  // Tracking array full (should not happen in normal operation)
-}
-
-/**
- * @brief Remove a completed chair from tracking by index.
- *
- * Uses swap-and-pop for O(1) removal.
- *
- * @param idx Index of tracker to remove.
- */
-static void remove_chair_tracker(int idx) {
-    if (idx >= 0 && idx < g_chair_count) {
-        g_chairs[idx] = g_chairs[--g_chair_count];
-    }
-}
-
 /**
  * @brief Upper platform worker process entry point.
  *
@@ -136,7 +115,7 @@ static void remove_chair_tracker(int idx) {
  * chair slots when all tourists from a chair have arrived. Handles emergency
  * stops and random danger detection.
  *
- * @param res IPC resources (message queues, semaphores, shared memory).
+ * @param res IPC resources (message queues, semaphores, shared memory), set to this worker's line.
  * @param keys IPC keys (unused, kept for interface consistency).
  */
 void upper_worker_main(IPCResources *res, IPCKeys *keys) {
@@ -145,10 +124,11 @@ void upper_worker_main(IPCResources *res, IPCKeys *keys) {
     // Initialize emergency state pointers
     g_emergency_state.is_initiator = &g_is_emergency_initiator;
     g_emergency_state.start_time_sim = &g_emergency_start_time_sim;
+    g_tag = worker_log_tag(res, WORKER_UPPER);
 
     // Initialize logger with component type
     logger_init(res->state, LOG_UPPER_WORKER);
-    logger_set_debug_enabled(res->state->debug_logs_enabled);
+    logger_set_debug_enabled(res->state->cfg.debug_logs_enabled);
 
     // Install signal handlers
     struct sigaction sa;
@@ -161,19 +141,24 @@ void upper_worker_main(IPCResources *res, IPCKeys *keys) {
     sigaction(SIGUSR2, &sa, NULL);
     sigaction(SIGALRM, &sa, NULL);
 
-    // Seed random number generator for danger detection (different seed than lower worker)
-    srand((unsigned int)(time(NULL) ^ (getpid() << 1)));
+    // Seed random number generator for danger detection (different stream than lower worker)
+    rng_seed(&g_rng, rng_base_seed(res->state->cfg.random_seed), RNG_STREAM_UPPER_WORKER + res->line);
+
+    numa_bind_line_worker(res, g_tag);
+
+    // Counted on the virtual clock from here until the process exits
+    time_participant_join(res->state);
 
     // Signal that this worker is ready (startup barrier)
     if (ipc_signal_worker_ready(res) == -1) {
-        log_error("UPPER_WORKER", "Failed to signal ready, exiting");
+        log_error(g_tag, "Failed to signal ready, exiting");
         return;
     }
-    log_info("UPPER_WORKER", "Upper platform worker ready");
+    log_info(g_tag, "Upper platform worker ready");
 
     int arrivals_count = 0;
 
-    while (g_running && res->state->running) {
+    while (g_running && control_running(res->state)) {
         // Handle SIGUSR1 - emergency stop from lower worker
         if (g_emergency_signal) {
             g_emergency_signal = 0;
@@ -186,7 +171,7 @@ void upper_worker_main(IPCResources *res, IPCKeys *keys) {
         if (g_resume_signal) {
             g_resume_signal = 0;
             // Resume signal received - logging only, actual resume handled by semaphores
-            log_debug("UPPER_WORKER", "Resume signal (SIGUSR2) received");
+            log_debug(g_tag, "Resume signal (SIGUSR2) received");
         }
 
         // Note: Pause handled by kernel SIGTSTP automatically
@@ -195,38 +180,53 @@ void upper_worker_main(IPCResources *res, IPCKeys *keys) {
         if (g_is_emergency_initiator && g_emergency_start_time_sim > 0) {
             // Use simulated time for duration (already accounts for pause)
             double now_sim = time_get_sim_minutes_f(res->state);
-            int duration_sim = res->state->danger_duration_sim;
+            int duration_sim = res->state->cfg.danger_duration_sim;
 
             if ((now_sim - g_emergency_start_time_sim) >= duration_sim) {
                 // Duration passed - initiate resume
                 worker_initiate_resume(res, WORKER_UPPER, &g_emergency_state);
             } else {
                 // Still in cooldown - wait with SIGALRM timeout (100ms)
-                ualarm(100000, 0);
+                time_alarm_us(res->state, 100000);
+                time_wait_begin();
                 pause();  // Interrupted by SIGALRM or other signals
-                ualarm(0, 0);
+                time_wait_end();
+                time_alarm_us(res->state, 0);
             }
             continue;
         }
 
+        // Futex emergencies send no SIGUSR1: the stop is seen here and after each receive
+        int futex_emergency = res->state->cfg.emergency_backend == EMERGENCY_BACKEND_FUTEX;
+        if (futex_emergency && control_emergency_stop(res->state, res->line)) {
+            worker_acknowledge_emergency_stop(res, WORKER_UPPER, &g_emergency_state);
+            continue;
+        }
+
         // Wait for tourist arrival notification
         ArrivalMsg msg;
-        ssize_t ret = msgrcv(res->mq_arrivals_id, &msg, sizeof(msg) - sizeof(long), 0, 0);
+        int ret = transport_arrival_recv(res, &msg);
 
         if (ret == -1) {
             if (errno == EINTR) {
                 continue;  // Interrupted by signal
             }
             if (errno == EIDRM) {
-                log_debug("UPPER_WORKER", "Arrivals queue removed, exiting");
+                log_debug(g_tag, "Arrivals queue removed, exiting");
                 break;
             }
             perror("upper_worker: msgrcv arrivals");
             continue;
         }
+        if (futex_emergency && control_emergency_stop(res->state, res->line)) {
+            // Chair stopped mid-line: hold this arrival until the resume
+            worker_acknowledge_emergency_stop(res, WORKER_UPPER, &g_emergency_state);
+        }
 
         // Count parent + kids as separate arrivals
         arrivals_count += (1 + msg.kid_count);
+        trace_emit(TRACE_SRC_UPPER, TRACE_RIDER_ARRIVED, msg.tourist_id, msg.chair_id, -1,
+                   1 + msg.kid_count);
 
         const char *tag = get_tourist_tag(msg.tourist_type);
         if (msg.kid_count > 0) {
@@ -237,32 +237,34 @@ void upper_worker_main(IPCResources *res, IPCKeys *keys) {
                      msg.tourist_id, arrivals_count);
         }
 
-        // Track chair arrivals for atomic SEM_CHAIRS release
-        ChairTracker *tracker = get_chair_tracker(msg.chair_id, msg.tourists_on_chair);
-        if (tracker) {
-            tracker->arrived++;
-
-            // Check if all tourists from this chair have arrived
-            if (tracker->arrived >= tracker->expected) {
-                sem_post(res->sem_id, SEM_CHAIRS, 1);
-
-                // Get available chairs count after releasing (for logging)
-                int chairs_available = sem_getval(res->sem_id, SEM_CHAIRS);
-
-                log_debug("UPPER_WORKER", "Chair %d complete (%d/%d tourists), releasing slot [chairs available: %d/%d]",
-                          msg.chair_id, tracker->arrived, tracker->expected,
-                          chairs_available, MAX_CHAIRS_IN_TRANSIT);
-
-                // Remove from tracking
-                int idx = (int)(tracker - g_chairs);
-                remove_chair_tracker(idx);
-            }
+        // Track chair arrivals for atomic SEM_CHAIRS release (O(1), keyed on chair + dispatch seq)
+        int arrived = 0;
+        int expected = 0;
+        int done = chair_tracker_arrive(ipc_line_state(res)->chair_tracks, msg.chair_id,
+                                        msg.dispatch_seq, &arrived, &expected);
+        if (done == 1 && res->state->cfg.chair_interval_sim > 0) {
+            // Cadence chairs took no SEM_CHAIRS slot
+            trace_emit(TRACE_SRC_UPPER, TRACE_CHAIR_RELEASED, 0, msg.chair_id, -1, expected);
+            log_debug(g_tag, "Chair %d complete (%d/%d tourists)", msg.chair_id, arrived, expected);
+        } else if (done == 1) {
+            sem_post(res->sem_id, SEM_CHAIRS, 1);
+            trace_emit(TRACE_SRC_UPPER, TRACE_CHAIR_RELEASED, 0, msg.chair_id, -1, expected);
+
+            // Get available chairs count after releasing (for logging)
+            int chairs_available = sem_getval(res->sem_id, SEM_CHAIRS);
+
+            log_debug(g_tag, "Chair %d complete (%d/%d tourists), releasing slot [chairs available: %d/%d]",
+                      msg.chair_id, arrived, expected,
+                      chairs_available, MAX_CHAIRS_IN_TRANSIT);
+        } else if (done == -1) {
+            log_warn(g_tag, "Tourist %d arrived on untracked chair %d (seq %u), ignoring",
+                     msg.tourist_id, msg.chair_id, msg.dispatch_seq);
         }
 
         // Check for random danger after each arrival
         check_for_danger(res);
     }
 
-    log_info("UPPER_WORKER", "Upper platform worker shutting down (processed %d arrivals)",
+    log_info(g_tag, "Upper platform worker shutting down (processed %d arrivals)",
              arrivals_count);
 }
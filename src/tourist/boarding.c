@@ -5,7 +5,10 @@
 
 #include "tourist/boarding.h"
 #include "ipc/messages.h"
+#include "ipc/transport.h"
+#include "ipc/control.h"
 #include "core/logger.h"
+#include "core/latency.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -17,23 +20,23 @@
  *
  * @param res IPC resources.
  * @param data Tourist data.
- * @param departure_time_out Output: chair departure time.
+ * @param departure_ns_out Output: chair departure (pause-adjusted ns, see time_elapsed_ns).
  * @param chair_id_out Output: chair ID for tracking.
  * @param tourists_on_chair_out Output: number of tourists on this chair.
+ * @param dispatch_seq_out Output: chair dispatch sequence for tracking.
  * @return 0 on success, -1 on error or shutdown.
  */
-int tourist_board_chair(IPCResources *res, TouristData *data, time_t *departure_time_out,
-                        int *chair_id_out, int *tourists_on_chair_out) {
+int tourist_board_chair(IPCResources *res, TouristData *data, int64_t *departure_ns_out,
+                        int *chair_id_out, int *tourists_on_chair_out,
+                        uint32_t *dispatch_seq_out) {
     // Note: SEM_CHAIRS is now acquired by lower_worker when chair departs,
     // and released by upper_worker when all tourists from that chair arrive.
 
-    if (sem_wait_pauseable(res, SEM_STATE, 1) == -1) {
+    if (!control_running(res->state)) {
         return -1;
     }
-    int emergency = res->state->emergency_stop;
-    sem_post(res->sem_id, SEM_STATE, 1);
 
-    if (emergency) {
+    if (control_emergency_stop(res->state, res->line)) {
         ipc_wait_emergency_clear(res);
     }
 
@@ -46,7 +49,8 @@ int tourist_board_chair(IPCResources *res, TouristData *data, time_t *departure_
     msg.slots_needed = data->chair_slots;  // Chair slots include bike for cyclists
     msg.kid_count = data->kid_count;
 
-    if (msgsnd(res->mq_platform_id, &msg, sizeof(msg) - sizeof(long), 0) == -1) {
+    uint64_t board_start = latency_now_us();
+    if (transport_platform_send(res, &msg, 0) == -1) {
         if (errno == EINTR) return -1;
         if (errno == EIDRM) {
             return -1;
@@ -58,9 +62,7 @@ int tourist_board_chair(IPCResources *res, TouristData *data, time_t *departure_
     // Wait for boarding confirmation (mtype = tourist_id)
     PlatformMsg response;
     while (1) {
-        ssize_t ret = msgrcv(res->mq_boarding_id, &response,
-                             sizeof(response) - sizeof(long), data->id, 0);
-        if (ret == -1) {
+        if (transport_boarding_recv(res, data->id, &response, 0) == -1) {
             if (errno == EINTR) {
                 continue;
             }
@@ -72,11 +74,13 @@ int tourist_board_chair(IPCResources *res, TouristData *data, time_t *departure_
         }
         break;
     }
+    latency_record_since(res->state, LAT_BOARDING, board_start);
 
     // Return the departure time and chair info for synchronized arrival
-    if (departure_time_out) *departure_time_out = response.departure_time;
+    if (departure_ns_out) *departure_ns_out = response.departure_ns;
     if (chair_id_out) *chair_id_out = response.chair_id;
     if (tourists_on_chair_out) *tourists_on_chair_out = response.tourists_on_chair;
+    if (dispatch_seq_out) *dispatch_seq_out = response.dispatch_seq;
 
     return 0;
 }
@@ -88,16 +92,19 @@ int tourist_board_chair(IPCResources *res, TouristData *data, time_t *departure_
  * @param data Tourist data.
  * @param chair_id Chair ID for tracking.
  * @param tourists_on_chair Number of tourists on this chair.
+ * @param dispatch_seq Chair dispatch sequence for tracking.
  * @return 0 on success, -1 on error.
  */
 int tourist_arrive_upper(IPCResources *res, TouristData *data,
-                         int chair_id, int tourists_on_chair) {
+                         int chair_id, int tourists_on_chair, uint32_t dispatch_seq) {
     // Note: SEM_CHAIRS is released by upper_worker when all tourists from chair arrive
 
     // Wait for exit gate
+    uint64_t gate_start = latency_now_us();
     if (sem_wait_pauseable(res, SEM_EXIT_GATES, 1) == -1) {
         return -1;
     }
+    latency_record_since(res->state, LAT_EXIT_GATES, gate_start);
 
     // Notify upper worker of arrival (with chair info for tracking)
     ArrivalMsg msg;
@@ -107,8 +114,9 @@ int tourist_arrive_upper(IPCResources *res, TouristData *data,
     msg.kid_count = data->kid_count;  // For family logging at upper platform
     msg.chair_id = chair_id;
     msg.tourists_on_chair = tourists_on_chair;
+    msg.dispatch_seq = dispatch_seq;
 
-    if (msgsnd(res->mq_arrivals_id, &msg, sizeof(msg) - sizeof(long), 0) == -1) {
+    if (transport_arrival_send(res, &msg, 0) == -1) {
         if (errno != EINTR && errno != EIDRM) {
             perror("tourist: msgsnd arrivals");
         }
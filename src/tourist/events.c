@@ -0,0 +1,997 @@
+/**
+ * @file tourist/events.c
+ * @brief Discrete-event tourist engine: state records, timer heap, wait queues.
+ *
+ * Every tourist is an EventTourist record indexed by tourist ID. A record
+ * advances through TouristStage values until it has to wait:
+ * - for time (chair ride, trail descent): pushed on a min-heap keyed on
+ *   SharedState.control.current_sim_time_ms, which stands still while paused;
+ * - for a semaphore or a full message queue: parked in that resource's FIFO
+ *   wait queue and retried (IPC_NOWAIT) on every loop pass, head first;
+ * - for a worker/cashier reply: picked up by the non-blocking drain loops
+ *   and dispatched by tourist ID (with QUEUE_TRANSPORT=1 the mailboxes of
+ *   records awaiting boarding are polled instead).
+ * Nothing in the loop blocks on IPC (the emergency flag is read from the
+ * control block), so one process drives every tourist.
+ */
+
+#include "tourist/events.h"
+#include "tourist/init.h"
+#include "tourist/lifecycle.h"
+#include "tourist/stats.h"
+#include "ipc/messages.h"
+#include "ipc/transport.h"
+#include "ipc/queue_stats.h"
+#include "ipc/control.h"
+#include "core/time_sim.h"
+#include "core/logger.h"
+#include "core/trace.h"
+#include "core/latency.h"
+#include "core/rng.h"
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/msg.h>
+#include <time.h>
+
+#define EV_POLL_NS 1000000L         // Idle sleep while records wait on IPC (1ms)
+#define EV_IDLE_NS 10000000L        // Idle sleep while only timers are pending (10ms)
+#define EV_SPAWN_BATCH 256          // Max descriptors accepted per loop pass
+#define EV_TICKET_WINDOW 64         // Ticket requests in flight (cashier queues keep room for replies)
+
+// EventTourist.flags
+#define EVF_LIVE        0x01        // Record in use
+#define EVF_CHECKED     0x02        // Ride-loop exit checks done for this ride
+#define EVF_ENTRY_GATE  0x04        // Holds an entry gate
+#define EVF_EXIT_GATE   0x08        // Holds an exit gate
+#define EVF_AWAITING    0x10        // Cashier request or platform message sent, reply pending
+#define EVF_NO_EXIT_LOG 0x20        // Left without a ticket (no "exiting" line)
+#define EVF_SEND_BLOCKED 0x40       // Pending send already counted as blocked (QueueStats)
+
+/**
+ * @brief Resources a record can wait for (one FIFO each).
+ */
+typedef enum {
+    WQ_CASHIER_SEND = 0,
+    WQ_ENTRY_GATE,
+    WQ_STATION,
+    WQ_PLATFORM_GATE,
+    WQ_PLATFORM_SEND,
+    WQ_EXIT_GATE,
+    WQ_ARRIVAL_SEND,
+    WQ_COUNT
+} WaitQueueId;
+
+/**
+ * @brief Lightweight tourist state record.
+ */
+typedef struct {
+    TouristData data;
+    TouristStage stage;
+    int flags;                      // EVF_* bits
+    int64_t wake_ms;                // Timer deadline (sim ms from midnight)
+    int heap_pos;                   // Position in timer heap, -1 if not scheduled
+    int waiting_on;                 // WaitQueueId, -1 if not parked
+    int wait_next;                  // Next tourist ID in wait queue, 0 = none
+    int chair_id;
+    int tourists_on_chair;
+    uint32_t dispatch_seq;
+    uint64_t wait_start_us;         // Parked (or boarding request sent) at, for LatencyStage
+} EventTourist;
+
+/**
+ * @brief Intrusive FIFO of tourist IDs (0 = empty).
+ */
+typedef struct {
+    int head;
+    int tail;
+} WaitQueue;
+
+/**
+ * @brief Engine state (private to the event host process).
+ */
+typedef struct {
+    IPCResources *res;
+    EventTourist *tourists;         // Indexed by tourist ID
+    int capacity;                   // Valid IDs are 1..capacity
+    int *heap;                      // Min-heap of tourist IDs by wake_ms
+    int heap_size;
+    WaitQueue queues[WQ_COUNT];
+    int live;                       // Records not yet left
+    int awaiting_tickets;           // Cashier replies pending
+    int awaiting_boarding;          // Boarding confirmations pending
+    int *boarding_ids;              // Records awaiting boarding (ring transport only)
+    int boarding_count;
+    int accepting;                  // 0 after the sentinel descriptor
+    int served;
+    int fatal;                      // IPC removed (shutdown)
+    unsigned long long transitions; // Stage changes (throughput figure)
+} EventEngine;
+
+static void ev_advance(EventEngine *e, EventTourist *t);
+
+/**
+ * @brief Make sure tourist ID fits in the record table (grows by doubling).
+ *
+ * @param e Engine.
+ * @param id Tourist ID.
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int ev_reserve(EventEngine *e, int id) {
+    if (id <= e->capacity) {
+        return 0;
+    }
+    int cap = e->capacity > 0 ? e->capacity : 64;
+    while (cap < id) {
+        cap *= 2;
+    }
+
+    EventTourist *tourists = realloc(e->tourists, (size_t)(cap + 1) * sizeof(EventTourist));
+    int *heap = realloc(e->heap, (size_t)(cap + 1) * sizeof(int));
+    int *boarding_ids = realloc(e->boarding_ids, (size_t)(cap + 1) * sizeof(int));
+    if (tourists) e->tourists = tourists;
+    if (heap) e->heap = heap;
+    if (boarding_ids) e->boarding_ids = boarding_ids;
+    if (!tourists || !heap || !boarding_ids) {
+        perror("tourist events: realloc");
+        return -1;
+    }
+
+    memset(&e->tourists[e->capacity + 1], 0, (size_t)(cap - e->capacity) * sizeof(EventTourist));
+    e->capacity = cap;
+    return 0;
+}
+
+/**
+ * @brief Record a stage change.
+ */
+static void ev_set_stage(EventEngine *e, EventTourist *t, TouristStage stage) {
+    t->stage = stage;
+    e->transitions++;
+    int riding = (stage == STAGE_ON_CHAIR || stage == STAGE_AT_UPPER_PLATFORM_GATES);
+    trace_tourist_stage(t->data.id, stage, riding ? t->chair_id : 0, 1 + t->data.kid_count);
+}
+
+// ---------------------------------------------------------------------------
+// Timer heap
+// ---------------------------------------------------------------------------
+
+static void ev_heap_swap(EventEngine *e, int a, int b) {
+    int ida = e->heap[a];
+    int idb = e->heap[b];
+    e->heap[a] = idb;
+    e->heap[b] = ida;
+    e->tourists[idb].heap_pos = a;
+    e->tourists[ida].heap_pos = b;
+}
+
+static int64_t ev_heap_key(EventEngine *e, int pos) {
+    return e->tourists[e->heap[pos]].wake_ms;
+}
+
+/**
+ * @brief Schedule a record to advance at sim time wake_ms.
+ *
+ * @param e Engine.
+ * @param t Record (must not already be scheduled).
+ * @param wake_ms Deadline in sim ms from midnight.
+ */
+static void ev_schedule(EventEngine *e, EventTourist *t, int64_t wake_ms) {
+    int pos = e->heap_size++;
+    t->wake_ms = wake_ms;
+    t->heap_pos = pos;
+    e->heap[pos] = t->data.id;
+
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (ev_heap_key(e, parent) <= ev_heap_key(e, pos)) break;
+        ev_heap_swap(e, parent, pos);
+        pos = parent;
+    }
+}
+
+/**
+ * @brief Remove and return the earliest record from the heap.
+ *
+ * @param e Engine (heap must be non-empty).
+ * @return Record that was at the top.
+ */
+static EventTourist *ev_heap_pop(EventEngine *e) {
+    EventTourist *top = &e->tourists[e->heap[0]];
+    top->heap_pos = -1;
+
+    e->heap_size--;
+    if (e->heap_size > 0) {
+        e->heap[0] = e->heap[e->heap_size];
+        e->tourists[e->heap[0]].heap_pos = 0;
+
+        int pos = 0;
+        while (1) {
+            int left = 2 * pos + 1;
+            int right = left + 1;
+            int smallest = pos;
+            if (left < e->heap_size && ev_heap_key(e, left) < ev_heap_key(e, smallest)) smallest = left;
+            if (right < e->heap_size && ev_heap_key(e, right) < ev_heap_key(e, smallest)) smallest = right;
+            if (smallest == pos) break;
+            ev_heap_swap(e, pos, smallest);
+            pos = smallest;
+        }
+    }
+    return top;
+}
+
+/**
+ * @brief Convert a real-time duration to sim milliseconds.
+ */
+static int64_t ev_real_to_sim_ms(EventEngine *e, double real_seconds) {
+    double accel = e->res->state->time_acceleration > 0 ? e->res->state->time_acceleration : 1.0;
+    return (int64_t)(real_seconds * accel * 60000.0);
+}
+
+// ---------------------------------------------------------------------------
+// Wait queues
+// ---------------------------------------------------------------------------
+
+static void ev_park(EventEngine *e, EventTourist *t, WaitQueueId q) {
+    WaitQueue *wq = &e->queues[q];
+    t->waiting_on = q;
+    t->wait_next = 0;
+    t->wait_start_us = latency_now_us();
+    if (wq->tail) {
+        e->tourists[wq->tail].wait_next = t->data.id;
+    } else {
+        wq->head = t->data.id;
+    }
+    wq->tail = t->data.id;
+}
+
+static void ev_unpark_head(EventEngine *e, WaitQueueId q) {
+    WaitQueue *wq = &e->queues[q];
+    EventTourist *t = &e->tourists[wq->head];
+    wq->head = t->wait_next;
+    if (wq->head == 0) {
+        wq->tail = 0;
+    }
+    t->waiting_on = -1;
+    t->wait_next = 0;
+}
+
+/**
+ * @brief Handle a failed IPC_NOWAIT operation.
+ *
+ * Parks the record on EAGAIN/EINTR; flags the engine fatal if IPC is gone.
+ *
+ * @return 0 if parked (caller returns and retries later), -1 on shutdown.
+ */
+static int ev_would_block(EventEngine *e, EventTourist *t, WaitQueueId q) {
+    if (errno == EAGAIN || errno == EINTR) {
+        if (t->waiting_on != (int)q) {
+            ev_park(e, t, q);
+        }
+        return 0;
+    }
+    e->fatal = 1;
+    return -1;
+}
+
+/**
+ * @brief Try to acquire count slots of a semaphore in FIFO order.
+ *
+ * @param e Engine.
+ * @param t Record.
+ * @param q Wait queue for this semaphore.
+ * @param sem_num Semaphore index.
+ * @param count Slots to acquire.
+ * @return 1 if acquired, 0 if parked, -1 on shutdown.
+ */
+static int ev_try_acquire(EventEngine *e, EventTourist *t, WaitQueueId q, int sem_num, int count) {
+    // Do not overtake records already waiting for this resource
+    if (t->waiting_on != (int)q && e->queues[q].head != 0) {
+        ev_park(e, t, q);
+        return 0;
+    }
+    if (sem_trywait_count(e->res->sem_id, sem_num, count) == -1) {
+        return ev_would_block(e, t, q);
+    }
+    uint64_t wait_us = 0;
+    if (t->waiting_on == (int)q) {
+        wait_us = latency_now_us() - t->wait_start_us;
+        ev_unpark_head(e, q);
+    }
+
+    // Same blocking points as the process engine measures around sem_wait_pauseable()
+    static const int wait_stage[WQ_COUNT] = {
+        [WQ_CASHIER_SEND] = -1, [WQ_ENTRY_GATE] = LAT_ENTRY_GATES,
+        [WQ_STATION] = LAT_LOWER_STATION, [WQ_PLATFORM_GATE] = LAT_PLATFORM_GATES,
+        [WQ_PLATFORM_SEND] = -1, [WQ_EXIT_GATE] = LAT_EXIT_GATES, [WQ_ARRIVAL_SEND] = -1,
+    };
+    if (wait_stage[q] >= 0) {
+        latency_record(e->res->state, (LatencyStage)wait_stage[q], wait_us);
+    }
+    return 1;
+}
+
+/**
+ * @brief Count a record's pending send as blocked, once per send.
+ *
+ * A blocking sender counts one wait however long it sleeps; the IPC_NOWAIT
+ * retries of a parked record must not count again.
+ */
+static void ev_note_blocked(EventEngine *e, EventTourist *t, WaitQueueId q) {
+    static const QueueKind send_kind[WQ_COUNT] = {
+        [WQ_CASHIER_SEND] = QUEUE_CASHIER, [WQ_PLATFORM_SEND] = QUEUE_PLATFORM,
+        [WQ_ARRIVAL_SEND] = QUEUE_ARRIVALS,
+    };
+    if (!(t->flags & EVF_SEND_BLOCKED)) {
+        t->flags |= EVF_SEND_BLOCKED;
+        queue_note_blocked(e->res->state, send_kind[q]);
+    }
+}
+
+/**
+ * @brief Try to send a message in FIFO order.
+ *
+ * @param e Engine.
+ * @param t Record.
+ * @param q Send queue: WQ_CASHIER_SEND (CashierMsg), WQ_PLATFORM_SEND
+ *          (PlatformMsg) or WQ_ARRIVAL_SEND (ArrivalMsg).
+ * @param msg Message (including mtype).
+ * @return 1 if sent, 0 if parked, -1 on shutdown.
+ */
+static int ev_try_send(EventEngine *e, EventTourist *t, WaitQueueId q, const void *msg) {
+    if (t->waiting_on != (int)q && e->queues[q].head != 0) {
+        // Behind a sender the full queue holds up (not one held by EV_TICKET_WINDOW)
+        if (e->tourists[e->queues[q].head].flags & EVF_SEND_BLOCKED) {
+            ev_note_blocked(e, t, q);
+        }
+        ev_park(e, t, q);
+        return 0;
+    }
+
+    int ret;
+    if (q == WQ_PLATFORM_SEND) {
+        ret = transport_platform_send(e->res, msg, IPC_NOWAIT);
+    } else if (q == WQ_ARRIVAL_SEND) {
+        ret = transport_arrival_send(e->res, msg, IPC_NOWAIT);
+    } else {
+        int queue = ipc_cashier_queue(e->res, ((const CashierMsg *)msg)->tourist_id);
+        ret = queue_msgsnd(e->res->state, QUEUE_CASHIER, queue, msg,
+                           sizeof(CashierMsg) - sizeof(long), IPC_NOWAIT);
+    }
+    if (ret == -1) {
+        if (errno == EAGAIN) {
+            ev_note_blocked(e, t, q);
+        }
+        return ev_would_block(e, t, q);
+    }
+    t->flags &= ~EVF_SEND_BLOCKED;
+    if (t->waiting_on == (int)q) {
+        ev_unpark_head(e, q);
+    }
+    return 1;
+}
+
+// ---------------------------------------------------------------------------
+// Stage machine
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Leave the lower station (update count, release station slots).
+ */
+static void ev_leave_station(EventEngine *e, EventTourist *t) {
+    IPCResources *res = e->res;
+    __atomic_sub_fetch(&ipc_line_state(res)->lower_station_count, t->data.station_slots,
+                       __ATOMIC_RELAXED);
+    sem_post(res->sem_id, SEM_LOWER_STATION, t->data.station_slots);
+}
+
+/**
+ * @brief Pick the trail descent time (sim minutes) for this tourist.
+ */
+static int ev_trail_time(EventEngine *e, EventTourist *t) {
+    SharedState *state = e->res->state;
+    if (t->data.type != TOURIST_CYCLIST) {
+        return state->cfg.trail_walk_time;
+    }
+    switch (rng_below(rng_local(), 3)) {
+        case 0:
+            return state->cfg.trail_bike_fast_time;
+        case 1:
+            return state->cfg.trail_bike_medium_time;
+        default:
+            return state->cfg.trail_bike_slow_time;
+    }
+}
+
+/**
+ * @brief Advance a record until it has to wait (timer, queue, reply) or leaves.
+ *
+ * Mirrors the ride loop in tourist_run() step for step, including its log lines.
+ *
+ * @param e Engine.
+ * @param t Record.
+ */
+static void ev_advance(EventEngine *e, EventTourist *t) {
+    IPCResources *res = e->res;
+    TouristData *data = &t->data;
+    const char *tag = tourist_get_tag(data);
+
+    logger_set_thread_component(data->is_vip ? LOG_VIP : LOG_TOURIST);
+
+    while (!e->fatal) {
+        switch (t->stage) {
+            case STAGE_AT_CASHIER: {
+                if (t->flags & EVF_AWAITING) {
+                    return;
+                }
+                // Requests and replies share the cashier queue: a queue full of
+                // requests would block the cashier's reply forever
+                if (e->awaiting_tickets >= EV_TICKET_WINDOW) {
+                    if (t->waiting_on != WQ_CASHIER_SEND) {
+                        ev_park(e, t, WQ_CASHIER_SEND);
+                    }
+                    return;
+                }
+                CashierMsg request;
+                memset(&request, 0, sizeof(request));
+                request.mtype = MSG_CASHIER_REQUEST;
+                request.tourist_id = data->id;
+                request.tourist_type = data->type;
+                request.age = data->age;
+                request.is_vip = data->is_vip;
+                request.kid_count = data->kid_count;
+                request.ticket_type = data->ticket_type;
+                if (ev_try_send(e, t, WQ_CASHIER_SEND, &request) <= 0) {
+                    return;
+                }
+                t->flags |= EVF_AWAITING;
+                e->awaiting_tickets++;
+                return;
+            }
+
+            case STAGE_AT_ENTRY_GATES:
+                if (!(t->flags & EVF_CHECKED)) {
+                    if (!tourist_is_ticket_valid(res, data)) {
+                        log_info(tag, "%d leaving (ticket expired)", data->id);
+                        ev_set_stage(e, t, STAGE_LEAVING);
+                        break;
+                    }
+                    if (tourist_is_station_closing(res)) {
+                        log_info(tag, "%d leaving (station closing)", data->id);
+                        ev_set_stage(e, t, STAGE_LEAVING);
+                        break;
+                    }
+                    t->flags |= EVF_CHECKED;
+                    if (data->is_vip) {
+                        log_info(tag, "%d skipped gate queue", data->id);
+                    }
+                }
+
+                if (!data->is_vip && !(t->flags & EVF_ENTRY_GATE)) {
+                    if (ev_try_acquire(e, t, WQ_ENTRY_GATE, SEM_ENTRY_GATES, 1) <= 0) {
+                        return;
+                    }
+                    t->flags |= EVF_ENTRY_GATE;
+                    log_info(tag, "%d entered through gate", data->id);
+                }
+
+                if (ev_try_acquire(e, t, WQ_STATION, SEM_LOWER_STATION, data->station_slots) <= 0) {
+                    return;
+                }
+                ev_set_stage(e, t, STAGE_ENTERED_LOWER_STATION);
+                break;
+
+            case STAGE_ENTERED_LOWER_STATION: {
+                int count = __atomic_add_fetch(&ipc_line_state(res)->lower_station_count,
+                                               data->station_slots, __ATOMIC_RELAXED);
+
+                if (t->flags & EVF_ENTRY_GATE) {
+                    sem_post(res->sem_id, SEM_ENTRY_GATES, 1);
+                    t->flags &= ~EVF_ENTRY_GATE;
+                }
+
+                if (data->kid_count > 0) {
+                    log_info(tag, "%d + %d kids in lower station (count: %d/%d)",
+                             data->id, data->kid_count, count, res->state->cfg.station_capacity);
+                } else {
+                    log_info(tag, "%d in lower station (count: %d/%d)",
+                             data->id, count, res->state->cfg.station_capacity);
+                }
+
+                if (tourist_is_too_scared(res, data)) {
+                    const char *reason = tourist_scared_reason(data);
+                    if (data->kid_count > 0) {
+                        log_info(tag, "%d + %d kids leaving lower station (%s)",
+                                 data->id, data->kid_count, reason);
+                    } else {
+                        log_info(tag, "%d leaving lower station (%s)", data->id, reason);
+                    }
+                    ev_leave_station(e, t);
+                    ev_set_stage(e, t, STAGE_LEAVING);
+                    break;
+                }
+                ev_set_stage(e, t, STAGE_QUEUED_FOR_PLATFORM);
+                break;
+            }
+
+            case STAGE_QUEUED_FOR_PLATFORM:
+                if (ev_try_acquire(e, t, WQ_PLATFORM_GATE, SEM_PLATFORM_GATES, 1) <= 0) {
+                    return;
+                }
+                log_info(tag, "%d passed through platform gate", data->id);
+                ev_leave_station(e, t);
+                ev_set_stage(e, t, STAGE_AT_LOWER_PLATFORM);
+                break;
+
+            case STAGE_AT_LOWER_PLATFORM: {
+                if (t->flags & EVF_AWAITING) {
+                    return;
+                }
+                if (control_emergency_stop(res->state, res->line)) {
+                    // Re-check on the next time tick instead of blocking on SEM_EMERGENCY_CLEAR.
+                    // A record parked on the platform queue is already retried every pass,
+                    // and one already on the heap must not be pushed twice (cap + 1 slots).
+                    if (t->waiting_on != WQ_PLATFORM_SEND && t->heap_pos == -1) {
+                        ev_schedule(e, t, time_get_sim_ms(res->state) + 1);
+                    }
+                    return;
+                }
+
+                PlatformMsg msg;
+                memset(&msg, 0, sizeof(msg));
+                msg.mtype = 2;
+                msg.tourist_id = data->id;
+                msg.tourist_type = data->type;
+                msg.slots_needed = data->chair_slots;
+                msg.kid_count = data->kid_count;
+                if (t->waiting_on != WQ_PLATFORM_SEND) {
+                    t->wait_start_us = latency_now_us();  // Boarding wait includes a full queue
+                }
+                if (ev_try_send(e, t, WQ_PLATFORM_SEND, &msg) <= 0) {
+                    return;
+                }
+                t->flags |= EVF_AWAITING;
+                e->awaiting_boarding++;
+                if (res->state->cfg.queue_transport == QUEUE_TRANSPORT_SHM) {
+                    e->boarding_ids[e->boarding_count++] = data->id;
+                }
+                return;
+            }
+
+            case STAGE_ON_CHAIR:
+                // Ride timer expired
+                ev_set_stage(e, t, STAGE_AT_UPPER_PLATFORM_GATES);
+                break;
+
+            case STAGE_AT_UPPER_PLATFORM_GATES: {
+                if (!(t->flags & EVF_EXIT_GATE)) {
+                    if (ev_try_acquire(e, t, WQ_EXIT_GATE, SEM_EXIT_GATES, 1) <= 0) {
+                        return;
+                    }
+                    t->flags |= EVF_EXIT_GATE;
+                }
+
+                ArrivalMsg msg;
+                memset(&msg, 0, sizeof(msg));
+                msg.mtype = 1;
+                msg.tourist_id = data->id;
+                msg.tourist_type = data->type;
+                msg.kid_count = data->kid_count;
+                msg.chair_id = t->chair_id;
+                msg.tourists_on_chair = t->tourists_on_chair;
+                msg.dispatch_seq = t->dispatch_seq;
+                if (ev_try_send(e, t, WQ_ARRIVAL_SEND, &msg) <= 0) {
+                    return;
+                }
+
+                sem_post(res->sem_id, SEM_EXIT_GATES, 1);
+                t->flags &= ~EVF_EXIT_GATE;
+
+                int trail_time_sim = ev_trail_time(e, t);
+                log_info(tag, "%d descending trail (%.1f real seconds)",
+                         data->id, time_sim_to_real_seconds(res->state, trail_time_sim));
+                ev_set_stage(e, t, STAGE_ON_TRAIL);
+                ev_schedule(e, t, time_get_sim_ms(res->state) + (int64_t)trail_time_sim * 60000);
+                return;
+            }
+
+            case STAGE_ON_TRAIL:
+                // Trail timer expired
+                data->rides_completed++;
+                tourist_update_stats(res, data);
+
+                if (data->kid_count > 0) {
+                    log_info(tag, "%d + %d kids completed ride #%d",
+                             data->id, data->kid_count, data->rides_completed);
+                } else {
+                    log_info(tag, "%d completed ride #%d", data->id, data->rides_completed);
+                }
+
+                if (data->ticket_type == TICKET_SINGLE) {
+                    log_info(tag, "%d leaving (single ticket used)", data->id);
+                    ev_set_stage(e, t, STAGE_LEAVING);
+                    break;
+                }
+                t->flags &= ~EVF_CHECKED;
+                ev_set_stage(e, t, STAGE_AT_ENTRY_GATES);
+                break;
+
+            case STAGE_RIDE_COMPLETE:
+                ev_set_stage(e, t, STAGE_AT_UPPER_PLATFORM_GATES);
+                break;
+
+            case STAGE_LEAVING:
+                if (!(t->flags & EVF_NO_EXIT_LOG)) {
+                    if (data->kid_count > 0) {
+                        log_info(tag, "%d + %d kids exiting (total rides: %d)",
+                                 data->id, data->kid_count, data->rides_completed);
+                    } else {
+                        log_info(tag, "%d exiting (total rides: %d)",
+                                 data->id, data->rides_completed);
+                    }
+                }
+                tourist_record_exit(e->res, data);
+                t->flags = 0;
+                e->live--;
+                e->served++;
+                return;
+        }
+    }
+}
+
+/**
+ * @brief Cashier replied: start the ride loop or leave.
+ */
+static void ev_on_ticket(EventEngine *e, EventTourist *t, const CashierMsg *resp) {
+    const char *tag = tourist_get_tag(&t->data);
+    static const char *ticket_names[] = {"SINGLE", "TIME_T1", "TIME_T2", "TIME_T3", "DAILY"};
+
+    t->flags &= ~EVF_AWAITING;
+    e->awaiting_tickets--;
+    logger_set_thread_component(t->data.is_vip ? LOG_VIP : LOG_TOURIST);
+
+    if (resp->ticket_type == -1) {
+        log_info(tag, "%d leaving (no ticket)", t->data.id);
+        t->flags |= EVF_NO_EXIT_LOG;
+        ev_set_stage(e, t, STAGE_LEAVING);
+        ev_advance(e, t);
+        return;
+    }
+
+    t->data.ticket_type = resp->ticket_type;
+    t->data.ticket_valid_until = resp->ticket_valid_until;
+    if (t->data.kid_count > 0) {
+        log_info(tag, "%d got %s family ticket for %d",
+                 t->data.id, ticket_names[t->data.ticket_type], 1 + t->data.kid_count);
+    } else {
+        log_info(tag, "%d got %s ticket", t->data.id, ticket_names[t->data.ticket_type]);
+    }
+    tourist_record_entry(e->res, &t->data);
+
+    ev_set_stage(e, t, STAGE_AT_ENTRY_GATES);
+    ev_advance(e, t);
+}
+
+/**
+ * @brief Lower worker confirmed boarding: release platform gate, start ride timer.
+ */
+static void ev_on_boarded(EventEngine *e, EventTourist *t, const PlatformMsg *resp) {
+    IPCResources *res = e->res;
+    TouristData *data = &t->data;
+    const char *tag = tourist_get_tag(data);
+
+    t->flags &= ~EVF_AWAITING;
+    e->awaiting_boarding--;
+    t->chair_id = resp->chair_id;
+    t->tourists_on_chair = resp->tourists_on_chair;
+    t->dispatch_seq = resp->dispatch_seq;
+    latency_record_since(res->state, LAT_BOARDING, t->wait_start_us);
+    logger_set_thread_component(data->is_vip ? LOG_VIP : LOG_TOURIST);
+
+    sem_post(res->sem_id, SEM_PLATFORM_GATES, 1);
+
+    if (data->kid_count > 0) {
+        log_info(tag, "%d + %d kids boarded chairlift", data->id, data->kid_count);
+    } else {
+        log_info(tag, "%d boarded chairlift", data->id);
+    }
+
+    // Same arrival instant as tourist_ride_chairlift(): departure + travel time
+    double travel_seconds = time_sim_to_real_seconds(res->state, res->state->cfg.chair_travel_time_sim);
+    int64_t arrival_ns = resp->departure_ns + (int64_t)(travel_seconds * 1e9);
+    double remaining = (double)(arrival_ns - time_elapsed_ns(res->state)) / 1e9;
+    if (remaining < 0) {
+        remaining = 0;
+    }
+
+    log_info(tag, "%d riding chairlift (%.1f real seconds)", data->id, travel_seconds);
+    ev_set_stage(e, t, STAGE_ON_CHAIR);
+    ev_schedule(e, t, time_get_sim_ms(res->state) + ev_real_to_sim_ms(e, remaining));
+}
+
+// ---------------------------------------------------------------------------
+// Event sources
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Look up a live record by ID.
+ */
+static EventTourist *ev_lookup(EventEngine *e, int id) {
+    if (id < 1 || id > e->capacity || !(e->tourists[id].flags & EVF_LIVE)) {
+        return NULL;
+    }
+    return &e->tourists[id];
+}
+
+/**
+ * @brief Accept new tourist descriptors from MQ_SPAWN.
+ *
+ * @return Number of descriptors handled.
+ */
+static int ev_accept(EventEngine *e) {
+    int handled = 0;
+
+    while (e->accepting && handled < EV_SPAWN_BATCH) {
+        TouristSpawnMsg msg;
+        if (msgrcv(e->res->mq_spawn_id, &msg, sizeof(msg) - sizeof(long), 0, IPC_NOWAIT) == -1) {
+            if (errno != ENOMSG && errno != EINTR) {
+                e->fatal = 1;
+            }
+            break;
+        }
+        handled++;
+
+        if (msg.tourist_id == 0) {
+            e->accepting = 0;
+            break;
+        }
+        if (msg.tourist_id < 0 || ev_reserve(e, msg.tourist_id) == -1 ||
+            (e->tourists[msg.tourist_id].flags & EVF_LIVE)) {
+            fprintf(stderr, "tourist events: cannot host tourist %d\n", msg.tourist_id);
+            continue;
+        }
+
+        EventTourist *t = &e->tourists[msg.tourist_id];
+        memset(t, 0, sizeof(*t));
+        int rc = e->res->state->cfg.arrival_schedule != ARRIVAL_SCHEDULE_OFF
+            ? tourist_init_scheduled(&t->data, e->res->state, msg.tourist_id)
+            : tourist_init_data(&t->data, msg.tourist_id, msg.age, msg.tourist_type,
+                                msg.is_vip, msg.kid_count, msg.ticket_type);
+        if (rc == -1) {
+            fprintf(stderr, "tourist: invalid descriptor for tourist %d\n", msg.tourist_id);
+            continue;
+        }
+        t->flags = EVF_LIVE;
+        t->heap_pos = -1;
+        t->waiting_on = -1;
+        t->stage = STAGE_AT_CASHIER;
+        e->live++;
+        trace_tourist_stage(t->data.id, STAGE_AT_CASHIER, 0, 1 + t->data.kid_count);
+
+        const TouristData *data = &t->data;
+        const char *type_names[] = {"walker", "cyclist", "family"};
+        logger_set_thread_component(data->is_vip ? LOG_VIP : LOG_TOURIST);
+        if (data->kid_count > 0) {
+            log_info(tourist_get_tag(data), "%d arrived (age %d, %s%s) with %d kid(s)",
+                     data->id, data->age, type_names[data->type],
+                     data->is_vip ? ", VIP" : "", data->kid_count);
+        } else {
+            log_info(tourist_get_tag(data), "%d arrived (age %d, %s%s)",
+                     data->id, data->age, type_names[data->type], data->is_vip ? ", VIP" : "");
+        }
+
+        ev_advance(e, t);
+    }
+
+    return handled;
+}
+
+/**
+ * @brief Dispatch pending cashier responses (every mtype except requests).
+ *
+ * Drains every cashier's queue in turn, each until it is empty.
+ *
+ * @return Number of responses handled.
+ */
+static int ev_drain_cashier(EventEngine *e) {
+    int handled = 0;
+    int cashier = 0;
+
+    while (e->awaiting_tickets > 0 && !e->fatal && cashier < e->res->cashier_count) {
+        CashierMsg resp;
+        if (msgrcv(e->res->mq_cashier_ids[cashier], &resp, sizeof(resp) - sizeof(long),
+                   MSG_CASHIER_REQUEST, IPC_NOWAIT | MSG_EXCEPT) == -1) {
+            if (errno != ENOMSG && errno != EINTR) {
+                e->fatal = 1;
+            }
+            cashier++;
+            continue;
+        }
+        handled++;
+
+        EventTourist *t = ev_lookup(e, (int)(resp.mtype - MSG_CASHIER_RESPONSE_BASE));
+        if (t && t->stage == STAGE_AT_CASHIER && (t->flags & EVF_AWAITING)) {
+            ev_on_ticket(e, t, &resp);
+        }
+    }
+
+    return handled;
+}
+
+/**
+ * @brief Dispatch pending boarding confirmations (mtype = tourist ID).
+ *
+ * @return Number of confirmations handled.
+ */
+static int ev_drain_boarding(EventEngine *e) {
+    int handled = 0;
+
+    if (e->res->state->cfg.queue_transport == QUEUE_TRANSPORT_SHM) {
+        // Poll the mailbox of every record awaiting boarding (bounded by platform gates)
+        int i = 0;
+        while (i < e->boarding_count && !e->fatal) {
+            EventTourist *t = &e->tourists[e->boarding_ids[i]];
+            PlatformMsg resp;
+            if (transport_boarding_recv(e->res, t->data.id, &resp, IPC_NOWAIT) == -1) {
+                if (errno != ENOMSG) {
+                    e->fatal = 1;
+                }
+                i++;
+                continue;
+            }
+            e->boarding_ids[i] = e->boarding_ids[--e->boarding_count];
+            handled++;
+            ev_on_boarded(e, t, &resp);
+        }
+        return handled;
+    }
+
+    while (e->awaiting_boarding > 0 && !e->fatal) {
+        PlatformMsg resp;
+        if (msgrcv(e->res->mq_boarding_id, &resp, sizeof(resp) - sizeof(long),
+                   0, IPC_NOWAIT) == -1) {
+            if (errno != ENOMSG && errno != EINTR) {
+                e->fatal = 1;
+            }
+            break;
+        }
+        handled++;
+
+        EventTourist *t = ev_lookup(e, (int)resp.mtype);
+        if (t && t->stage == STAGE_AT_LOWER_PLATFORM && (t->flags & EVF_AWAITING)) {
+            ev_on_boarded(e, t, &resp);
+        }
+    }
+
+    return handled;
+}
+
+/**
+ * @brief Advance every record whose timer has expired.
+ *
+ * @return Number of timers fired.
+ */
+static int ev_fire_timers(EventEngine *e) {
+    int fired = 0;
+    int64_t now = time_get_sim_ms(e->res->state);
+
+    while (e->heap_size > 0 && ev_heap_key(e, 0) <= now && !e->fatal) {
+        ev_advance(e, ev_heap_pop(e));
+        fired++;
+    }
+
+    return fired;
+}
+
+/**
+ * @brief Retry the head of every wait queue until one is still blocked.
+ *
+ * @return Number of records that got past their wait.
+ */
+static int ev_service_queues(EventEngine *e) {
+    int moved = 0;
+
+    for (int q = 0; q < WQ_COUNT && !e->fatal; q++) {
+        while (e->queues[q].head != 0 && !e->fatal) {
+            int id = e->queues[q].head;
+            ev_advance(e, &e->tourists[id]);
+            if (e->queues[q].head == id) {
+                break;  // Head still blocked: FIFO keeps everyone behind it waiting
+            }
+            moved++;
+        }
+    }
+
+    return moved;
+}
+
+/**
+ * @brief Check whether any record is waiting on IPC (not just on a timer).
+ */
+static int ev_ipc_pending(EventEngine *e) {
+    if (e->accepting || e->awaiting_tickets > 0 || e->awaiting_boarding > 0) {
+        return 1;
+    }
+    for (int q = 0; q < WQ_COUNT; q++) {
+        if (e->queues[q].head != 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Run all tourists as state records in a single-threaded event loop.
+ *
+ * @param res Attached IPC resources.
+ * @param running_flag Pointer to running flag cleared on SIGTERM/SIGINT.
+ * @return Number of tourists served.
+ */
+int tourist_events_run(IPCResources *res, int *running_flag) {
+    EventEngine e;
+    memset(&e, 0, sizeof(e));
+    e.res = res;
+    e.accepting = 1;
+    rng_local_seed(rng_base_seed(res->state->cfg.random_seed), RNG_STREAM_EVENTS);
+
+    if (ev_reserve(&e, res->state->max_tracked_tourists) == -1) {
+        free(e.tourists);
+        free(e.heap);
+        free(e.boarding_ids);
+        return 0;
+    }
+
+    log_info("TOURIST", "Event engine started (capacity: %d tourists)", e.capacity);
+
+    while (*running_flag && control_running(res->state) && !e.fatal) {
+        int progress = 0;
+
+        progress += ev_accept(&e);
+        progress += ev_drain_cashier(&e);
+        progress += ev_drain_boarding(&e);
+        progress += ev_fire_timers(&e);
+        progress += ev_service_queues(&e);
+
+        if (!e.accepting && e.live == 0) {
+            break;
+        }
+
+        if (progress == 0) {
+            int ipc_pending = ev_ipc_pending(&e);
+            if (res->state->cfg.max_speed) {
+                // Virtual clock: hold it at the next timer, then wait for it to move
+                time_hold_until_elapsed_ns(res->state, e.heap_size > 0
+                    ? time_sim_ms_to_elapsed_ns(res->state, ev_heap_key(&e, 0)) : -1);
+                if (!ipc_pending) {
+                    time_wait_advance(res->state, 1);
+                    continue;
+                }
+            }
+            // Idle until another participant answers, so the clock may move meanwhile
+            struct timespec ts = {0, ipc_pending ? EV_POLL_NS : EV_IDLE_NS};
+            time_wait_begin();
+            nanosleep(&ts, NULL);
+            time_wait_end();
+        }
+    }
+    time_hold_until_elapsed_ns(res->state, -1);
+
+    // Tourists still inside at shutdown are reported with the rides they made
+    for (int id = 1; id <= e.capacity; id++) {
+        if (e.tourists[id].flags & EVF_LIVE) {
+            tourist_record_exit(res, &e.tourists[id].data);
+        }
+    }
+
+    logger_set_thread_component(LOG_TOURIST);
+    log_info("TOURIST", "Event engine finished (served: %d, stage transitions: %llu)",
+             e.served, e.transitions);
+
+    free(e.tourists);
+    free(e.heap);
+    free(e.boarding_ids);
+    return e.served;
+}
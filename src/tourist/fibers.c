@@ -0,0 +1,197 @@
+/**
+ * @file tourist/fibers.c
+ * @brief Fiber tourist engine: tourist_run() on io_uring-scheduled fibers (TOURIST_ENGINE=3).
+ */
+
+#include "tourist/fibers.h"
+#include "tourist/init.h"
+#include "tourist/run.h"
+#include "ipc/messages.h"
+#include "core/fiber.h"
+#include "core/logger.h"
+#include "core/stats.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/msg.h>
+
+/**
+ * @brief State shared by every scheduler thread of the engine.
+ */
+typedef struct {
+    IPCResources *res;
+    int *running_flag;
+    int accepting;                      // Cleared by the first thread to see the sentinel
+} FiberEngine;
+
+/**
+ * @brief One scheduler thread and its totals.
+ */
+typedef struct {
+    FiberEngine *engine;
+    pthread_t thread;
+    int started;
+    int failed;                         // No scheduler could be created
+    int served;
+    FiberStats stats;
+} FiberHost;
+
+/**
+ * @brief Argument of a tourist's fiber (freed when it returns).
+ */
+typedef struct {
+    FiberEngine *engine;
+    TouristData data;
+} FiberTourist;
+
+/**
+ * @brief Fiber entry point: the whole life of one tourist.
+ */
+static void fiber_tourist_func(void *arg) {
+    FiberTourist *ft = (FiberTourist *)arg;
+    tourist_run(ft->engine->res, &ft->data, ft->engine->running_flag);
+    free(ft);
+}
+
+static int fiber_accepting(FiberEngine *e) {
+    return __atomic_load_n(&e->accepting, __ATOMIC_ACQUIRE) && *e->running_flag;
+}
+
+/**
+ * @brief Start a fiber for each queued descriptor, up to FIBER_SPAWN_BATCH.
+ *
+ * The sentinel, or a queue error at shutdown, stops intake on every thread
+ * (the generator sends one sentinel for the whole engine).
+ */
+static void fiber_accept(FiberHost *h, FiberScheduler *s) {
+    FiberEngine *e = h->engine;
+
+    for (int handled = 0; handled < FIBER_SPAWN_BATCH && fiber_accepting(e); handled++) {
+        TouristSpawnMsg msg;
+        if (msgrcv(e->res->mq_spawn_id, &msg, sizeof(msg) - sizeof(long), 0, IPC_NOWAIT) == -1) {
+            if (errno != ENOMSG && errno != EINTR) {
+                __atomic_store_n(&e->accepting, 0, __ATOMIC_RELEASE);  // Queue removed
+            }
+            return;
+        }
+        if (msg.tourist_id == 0) {
+            __atomic_store_n(&e->accepting, 0, __ATOMIC_RELEASE);
+            return;
+        }
+
+        FiberTourist *ft = malloc(sizeof(FiberTourist));
+        if (ft == NULL) {
+            perror("tourist fibers: malloc");
+            continue;
+        }
+        ft->engine = e;
+        int rc = e->res->state->cfg.arrival_schedule != ARRIVAL_SCHEDULE_OFF
+            ? tourist_init_scheduled(&ft->data, e->res->state, msg.tourist_id)
+            : tourist_init_data(&ft->data, msg.tourist_id, msg.age, msg.tourist_type,
+                                msg.is_vip, msg.kid_count, msg.ticket_type);
+        if (rc == -1) {
+            fprintf(stderr, "tourist: invalid descriptor for tourist %d\n", msg.tourist_id);
+            free(ft);
+            continue;
+        }
+        if (fiber_spawn(s, fiber_tourist_func, ft) == -1) {
+            // No stack: run inline so the descriptor is not lost
+            fiber_tourist_func(ft);
+        }
+        h->served++;
+    }
+}
+
+/**
+ * @brief Scheduler thread: accept tourists and run their fibers until all are done.
+ *
+ * @param arg FiberHost of this thread.
+ * @return NULL.
+ */
+static void *fiber_host_func(void *arg) {
+    FiberHost *h = (FiberHost *)arg;
+    FiberEngine *e = h->engine;
+    logger_set_thread_component(LOG_TOURIST);
+
+    FiberScheduler *s = fiber_scheduler_create();
+    if (s == NULL) {
+        h->failed = 1;
+        return NULL;
+    }
+
+    while (1) {
+        if (fiber_accepting(e)) {
+            fiber_accept(h, s);
+        }
+        int accepting = fiber_accepting(e);
+        if (!accepting && fiber_scheduler_stats(s).live == 0) {
+            break;
+        }
+        // While accepting, come back for MQ_SPAWN at least every FIBER_POLL_NS
+        fiber_scheduler_run(s, accepting ? FIBER_POLL_NS : (int64_t)SHM_WAIT_TIMEOUT_MS * 1000000);
+    }
+
+    h->stats = fiber_scheduler_stats(s);
+    fiber_scheduler_destroy(s);
+    stats_release(e->res->state);
+    return NULL;
+}
+
+int tourist_fibers_run(IPCResources *res, int *running_flag) {
+    FiberEngine engine = {res, running_flag, 1};
+    int threads = res->state->cfg.fiber_threads;
+    FiberHost hosts[MAX_FIBER_THREADS];
+    memset(hosts, 0, sizeof(hosts));
+
+    log_info("TOURIST", "Fiber engine started (%d threads)", threads);
+
+    // The calling thread is host 0
+    for (int i = 0; i < threads; i++) {
+        hosts[i].engine = &engine;
+    }
+    for (int i = 1; i < threads; i++) {
+        int rc = pthread_create(&hosts[i].thread, NULL, fiber_host_func, &hosts[i]);
+        if (rc != 0) {
+            errno = rc;
+            perror("tourist fibers: pthread_create");
+            continue;
+        }
+        hosts[i].started = 1;
+    }
+    fiber_host_func(&hosts[0]);
+
+    int served = 0, peak = 0, running = 0, futex_op = 0;
+    unsigned long long switches = 0, uring_waits = 0, polls = 0;
+    for (int i = 0; i < threads; i++) {
+        if (i > 0 && !hosts[i].started) {
+            continue;
+        }
+        if (i > 0) {
+            pthread_join(hosts[i].thread, NULL);
+        }
+        if (hosts[i].failed) {
+            continue;
+        }
+        running++;
+        served += hosts[i].served;
+        peak += hosts[i].stats.peak;
+        switches += hosts[i].stats.switches;
+        uring_waits += hosts[i].stats.uring_waits;
+        polls += hosts[i].stats.polls;
+        futex_op |= hosts[i].stats.futex_op;
+    }
+    if (running == 0) {
+        fprintf(stderr, "tourist fibers: no scheduler thread could start (io_uring unavailable?)\n");
+        return -1;
+    }
+
+    logger_set_thread_component(LOG_TOURIST);
+    log_info("TOURIST", "Fiber engine finished (served: %d, threads: %d, peak fibers: %d, "
+             "switches: %llu, io_uring waits: %llu%s, System V polls: %llu)",
+             served, running, peak, switches, uring_waits,
+             futex_op ? "" : " [no IORING_OP_FUTEX_WAIT]", polls);
+    return served;
+}
@@ -7,6 +7,7 @@
 
 #include "tourist/init.h"
 #include "constants.h"
+#include "core/arrival_schedule.h"
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -38,18 +39,38 @@ static void signal_handler(int sig) {
 int tourist_parse_args(int argc, char *argv[], TouristData *data) {
     if (argc != 7) {
         fprintf(stderr, "Usage: tourist <id> <age> <type> <vip> <kid_count> <ticket_type>\n");
+        fprintf(stderr, "       tourist --pool | --host | --events\n");
         return -1;
     }
 
-    data->id = atoi(argv[1]);
-    data->age = atoi(argv[2]);
-    data->type = atoi(argv[3]);
-    data->is_vip = atoi(argv[4]);
-    data->kid_count = atoi(argv[5]);
-    data->ticket_type = atoi(argv[6]);
+    return tourist_init_data(data, atoi(argv[1]), atoi(argv[2]), atoi(argv[3]),
+                             atoi(argv[4]), atoi(argv[5]), atoi(argv[6]));
+}
+
+/**
+ * @brief Populate tourist data from descriptor fields and validate constraints.
+ *
+ * @param data Tourist data structure to populate.
+ * @param id Tourist ID.
+ * @param age Tourist age.
+ * @param type Tourist type.
+ * @param is_vip VIP flag.
+ * @param kid_count Number of kids.
+ * @param ticket_type Requested ticket type.
+ * @return 0 on success, -1 on error.
+ */
+int tourist_init_data(TouristData *data, int id, int age, int type,
+                      int is_vip, int kid_count, int ticket_type) {
+    data->id = id;
+    data->age = age;
+    data->type = type;
+    data->is_vip = is_vip;
+    data->kid_count = kid_count;
+    data->ticket_type = ticket_type;
 
     data->rides_completed = 0;
     data->ticket_valid_until = 0;
+    data->entry_time_sim = -1;
 
     // Validate constraints
     if (data->kid_count > 0) {
@@ -77,6 +98,23 @@ int tourist_parse_args(int argc, char *argv[], TouristData *data) {
     return 0;
 }
 
+/**
+ * @brief Populate tourist data from the tourist's scheduled descriptor.
+ *
+ * @param data Tourist data structure to populate.
+ * @param state Shared state holding the schedule.
+ * @param id Tourist ID.
+ * @return 0 on success, -1 on error.
+ */
+int tourist_init_scheduled(TouristData *data, SharedState *state, int id) {
+    const TouristDescriptor *d = arrival_schedule_lookup(state, id);
+    if (d == NULL) {
+        fprintf(stderr, "Error: Tourist %d is not in the arrival schedule\n", id);
+        return -1;
+    }
+    return tourist_init_data(data, d->id, d->age, d->type, d->vip, d->kid_count, d->ticket);
+}
+
 /**
  * @brief Get logging tag based on tourist type and VIP status.
  *
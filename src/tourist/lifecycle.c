@@ -5,7 +5,11 @@
 
 #include "tourist/lifecycle.h"
 #include "ipc/messages.h"
+#include "ipc/control.h"
+#include "ipc/queue_stats.h"
 #include "core/time_sim.h"
+#include "core/rng.h"
+#include "core/fiber.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -15,7 +19,8 @@
 /**
  * @brief Buy ticket at cashier via message queue.
  *
- * For families, parent buys tickets for all kids (same type).
+ * For families, parent buys tickets for all kids (same type). The request
+ * goes to the tourist's own cashier (ipc_cashier_queue).
  *
  * @param res IPC resources.
  * @param data Tourist data (updated with ticket info).
@@ -30,9 +35,10 @@ int tourist_buy_ticket(IPCResources *res, TouristData *data) {
     request.is_vip = data->is_vip;
     request.kid_count = data->kid_count;
     request.ticket_type = data->ticket_type;
+    int queue = ipc_cashier_queue(res, data->id);
 
     // Send request
-    if (msgsnd(res->mq_cashier_id, &request, sizeof(request) - sizeof(long), 0) == -1) {
+    if (queue_msgsnd(res->state, QUEUE_CASHIER, queue, &request, sizeof(request) - sizeof(long), 0) == -1) {
         if (errno == EIDRM) return -1;
         perror("tourist: msgsnd cashier request");
         return -1;
@@ -41,9 +47,11 @@ int tourist_buy_ticket(IPCResources *res, TouristData *data) {
     // Wait for response (mtype = MSG_CASHIER_RESPONSE_BASE + tourist_id)
     CashierMsg response;
     while (1) {
-        ssize_t ret = msgrcv(res->mq_cashier_id, &response,
-                             sizeof(response) - sizeof(long),
-                             MSG_CASHIER_RESPONSE_BASE + data->id, 0);
+        time_wait_begin();
+        ssize_t ret = fiber_msgrcv(queue, &response,
+                                   sizeof(response) - sizeof(long),
+                                   MSG_CASHIER_RESPONSE_BASE + data->id, 0);
+        time_wait_end();
         if (ret == -1) {
             if (errno == EINTR) continue;
             if (errno == EIDRM) return -1;
@@ -89,12 +97,35 @@ int tourist_is_ticket_valid(IPCResources *res, TouristData *data) {
  * @return 1 if closing, 0 if open.
  */
 int tourist_is_station_closing(IPCResources *res) {
-    if (sem_wait_pauseable(res, SEM_STATE, 1) == -1) {
-        return 1;  // Assume closing on failure (shutdown)
+    // Shutdown counts as closing
+    return control_closing(res->state) || !control_running(res->state);
+}
+
+/**
+ * @brief Pick the chairlift line for the next ride and point res at it.
+ *
+ * @param res IPC resources (the tourist's own copy).
+ * @param data Tourist data.
+ * @return Selected line index.
+ */
+int tourist_choose_line(IPCResources *res, TouristData *data) {
+    int lines = res->line_count;
+    if (lines <= 1) {
+        return 0;
+    }
+
+    int best = data->id % lines;
+    int best_load = __atomic_load_n(&res->state->lines[best].lower_station_count, __ATOMIC_RELAXED);
+    for (int i = 1; i < lines && best_load > 0; i++) {
+        int line = (data->id + i) % lines;
+        int load = __atomic_load_n(&res->state->lines[line].lower_station_count, __ATOMIC_RELAXED);
+        if (load < best_load) {
+            best = line;
+            best_load = load;
+        }
     }
-    int closing = res->state->closing;
-    sem_post(res->sem_id, SEM_STATE, 1);
-    return closing;
+    ipc_select_line(res, best);
+    return best;
 }
 
 /**
@@ -106,7 +137,7 @@ int tourist_is_station_closing(IPCResources *res) {
  */
 int tourist_is_too_scared(IPCResources *res, TouristData *data) {
     // Check if scared behavior is enabled
-    if (!res->state->scared_enabled) {
+    if (!res->state->cfg.scared_enabled) {
         return 0;
     }
     // Only check on first two potential rides
@@ -114,7 +145,7 @@ int tourist_is_too_scared(IPCResources *res, TouristData *data) {
         return 0;
     }
     // ~10% chance to be scared
-    return (rand() % 10) == 0;
+    return rng_below(rng_local(), 10) == 0;
 }
 
 /**
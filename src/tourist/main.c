@@ -1,258 +1,261 @@
 /**
  * @file tourist/main.c
- * @brief Tourist process entry point and main ride loop orchestration.
+ * @brief Tourist process entry point (single tourist, pooled worker, thread host, event host, or fiber host).
  */
 
 #include "tourist/types.h"
 #include "tourist/init.h"
-#include "tourist/threads.h"
-#include "tourist/lifecycle.h"
-#include "tourist/boarding.h"
-#include "tourist/movement.h"
-#include "tourist/stats.h"
+#include "tourist/run.h"
+#include "tourist/events.h"
+#include "tourist/fibers.h"
+#include "ipc/messages.h"
 #include "ipc/ipc.h"
 #include "core/logger.h"
+#include "core/stats.h"
+#include "core/time_sim.h"
+#include "core/trace.h"
 
+#include <errno.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/msg.h>
 #include <unistd.h>
-#include <time.h>
 
 static int g_running = 1;
 
-int main(int argc, char *argv[]) {
-    TouristData data;
-    FamilyState family;
-    pthread_t kid_threads[MAX_KIDS_PER_ADULT];
-    KidThreadData kid_data[MAX_KIDS_PER_ADULT];
-    pthread_t bike_thread;
-    BikeThreadData bike_data;
-    int bike_thread_created = 0;
-
-    memset(&family, 0, sizeof(family));
-    memset(&bike_data, 0, sizeof(bike_data));
-
-    if (tourist_parse_args(argc, argv, &data) == -1) {
-        return 1;
-    }
+// Thread host state (TOURIST_ENGINE=1)
+static pthread_mutex_t g_host_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_host_idle = PTHREAD_COND_INITIALIZER;
+static int g_host_active = 0;
 
-    // Install signal handlers
-    tourist_setup_signals(&g_running);
+/**
+ * @brief Per-thread argument for a hosted tourist.
+ */
+typedef struct {
+    IPCResources *res;
+    TouristData data;
+} HostedTourist;
 
-    // Seed random number generator
-    srand(time(NULL) ^ getpid());
+/**
+ * @brief Receive the next descriptor from MQ_SPAWN.
+ *
+ * @param res Attached IPC resources.
+ * @param data Tourist data to populate.
+ * @return 1 if a tourist was received, 0 on sentinel/shutdown.
+ */
+static int receive_descriptor(IPCResources *res, TouristData *data) {
+    while (g_running) {
+        TouristSpawnMsg msg;
+        time_wait_begin();
+        ssize_t ret = msgrcv(res->mq_spawn_id, &msg, sizeof(msg) - sizeof(long), 0, 0);
+        time_wait_end();
+        if (ret == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            // EIDRM/EINVAL: queue removed during shutdown
+            return 0;
+        }
 
-    // Generate IPC keys (using current directory - same for all processes)
-    IPCKeys keys;
-    if (ipc_generate_keys(&keys, ".") == -1) {
-        fprintf(stderr, "tourist %d: Failed to generate IPC keys\n", data.id);
-        return 1;
-    }
+        if (msg.tourist_id == 0) {
+            return 0;
+        }
 
-    // Attach to IPC resources
-    IPCResources res;
-    if (ipc_attach(&res, &keys) == -1) {
-        fprintf(stderr, "tourist %d: Failed to attach to IPC\n", data.id);
+        // With a schedule the descriptor carries only the ID
+        int rc = res->state->cfg.arrival_schedule != ARRIVAL_SCHEDULE_OFF
+            ? tourist_init_scheduled(data, res->state, msg.tourist_id)
+            : tourist_init_data(data, msg.tourist_id, msg.age, msg.tourist_type,
+                                msg.is_vip, msg.kid_count, msg.ticket_type);
+        if (rc == -1) {
+            fprintf(stderr, "tourist: invalid descriptor for tourist %d\n", msg.tourist_id);
+            continue;
+        }
         return 1;
     }
+    return 0;
+}
 
-    // Initialize logger (VIPs get distinct color)
-    logger_init(res.state, data.is_vip ? LOG_VIP : LOG_TOURIST);
-    logger_set_debug_enabled(res.state->debug_logs_enabled);
-
-    // Initialize family state (simple data only - no sync primitives)
-    family.parent_id = data.id;
-    family.kid_count = data.kid_count;
-    family.has_bike = (data.type == TOURIST_CYCLIST);
-    family.res = &res;
-
-    // Create family threads (kids and bike)
-    if (tourist_create_family_threads(&data, &family, kid_data, kid_threads,
-                                       &bike_data, &bike_thread, &bike_thread_created) == -1) {
-        ipc_detach(&res);
-        return 1;
-    }
+/**
+ * @brief Pool mode: run tourists received over MQ_SPAWN until a sentinel arrives.
+ *
+ * IPC is attached once for the life of the process. Exits on a sentinel
+ * descriptor (tourist_id == 0), SIGTERM, or queue removal (EIDRM on shutdown).
+ *
+ * @param res Attached IPC resources.
+ * @return Number of tourists served.
+ */
+static int run_pool(IPCResources *res) {
+    int served = 0;
+    TouristData data;
 
-    const char *tag = tourist_get_tag(&data);
-    const char *type_names[] = {"walker", "cyclist", "family"};
-    const char *type_name = type_names[data.type];
-    if (data.kid_count > 0) {
-        log_info(tag, "%d arrived (age %d, %s%s) with %d kid(s)",
-                 data.id, data.age, type_name, data.is_vip ? ", VIP" : "", data.kid_count);
-    } else {
-        log_info(tag, "%d arrived (age %d, %s%s)",
-                 data.id, data.age, type_name, data.is_vip ? ", VIP" : "");
+    while (receive_descriptor(res, &data)) {
+        tourist_run(res, &data, &g_running);
+        served++;
     }
 
-    // Buy ticket at cashier (parent buys for whole family)
-    if (tourist_buy_ticket(&res, &data) == -1) {
-        log_info(tag, "%d leaving (no ticket)", data.id);
-        goto cleanup_family;
-    }
+    return served;
+}
 
-    const char *ticket_names[] = {"SINGLE", "TIME_T1", "TIME_T2", "TIME_T3", "DAILY"};
-    if (data.kid_count > 0) {
-        log_info(tag, "%d got %s family ticket for %d",
-                 data.id, ticket_names[data.ticket_type], 1 + data.kid_count);
-    } else {
-        log_info(tag, "%d got %s ticket",
-                 data.id, ticket_names[data.ticket_type]);
+/**
+ * @brief Thread entry point for a hosted tourist.
+ *
+ * @param arg Pointer to heap-allocated HostedTourist (freed here).
+ * @return NULL.
+ */
+static void *hosted_tourist_func(void *arg) {
+    HostedTourist *ht = (HostedTourist *)arg;
+
+    time_participant_adopt(ht->res->state);
+    tourist_run(ht->res, &ht->data, &g_running);
+    time_participant_leave(ht->res->state);
+    stats_release(ht->res->state);
+    free(ht);
+
+    pthread_mutex_lock(&g_host_lock);
+    g_host_active--;
+    if (g_host_active == 0) {
+        pthread_cond_signal(&g_host_idle);
     }
+    pthread_mutex_unlock(&g_host_lock);
 
-    // Record tourist entry for final report
-    tourist_record_entry(&res, &data);
-
-    // Main ride loop
-    while (g_running && res.state->running) {
-        // Check exit conditions
-        if (!tourist_is_ticket_valid(&res, &data)) {
-            log_info(tag, "%d leaving (ticket expired)", data.id);
-            break;
-        }
-
-        if (tourist_is_station_closing(&res)) {
-            log_info(tag, "%d leaving (station closing)", data.id);
-            break;
-        }
-
-        // Enter through entry gate (VIPs skip the queue)
-        if (data.is_vip) {
-            log_info(tag, "%d skipped gate queue", data.id);
-        } else {
-            if (sem_wait_pauseable(&res, SEM_ENTRY_GATES, 1) == -1) {
-                break;
-            }
-            log_info(tag, "%d entered through gate", data.id);
-        }
-
-        // Enter lower station (wait if full)
-        if (sem_wait_pauseable(&res, SEM_LOWER_STATION, data.station_slots) == -1) {
-            if (!data.is_vip) sem_post(res.sem_id, SEM_ENTRY_GATES, 1);
-            break;
-        }
-
-        // Update station count for logging
-        if (sem_wait_pauseable(&res, SEM_STATE, 1) == -1) {
-            if (!data.is_vip) sem_post(res.sem_id, SEM_ENTRY_GATES, 1);
-            sem_post(res.sem_id, SEM_LOWER_STATION, data.station_slots);
-            break;
-        }
-        res.state->lower_station_count += data.station_slots;
-        int count = res.state->lower_station_count;
-        sem_post(res.sem_id, SEM_STATE, 1);
-
-        // Release entry gate now that we're in station
-        if (!data.is_vip) {
-            sem_post(res.sem_id, SEM_ENTRY_GATES, 1);
-        }
-
-        if (data.kid_count > 0) {
-            log_info(tag, "%d + %d kids in lower station (count: %d/%d)",
-                     data.id, data.kid_count, count, res.state->station_capacity);
-        } else {
-            log_info(tag, "%d in lower station (count: %d/%d)",
-                     data.id, count, res.state->station_capacity);
-        }
+    return NULL;
+}
 
-        // Check if tourist is too scared to ride
-        if (tourist_is_too_scared(&res, &data)) {
-            const char *reason = tourist_scared_reason(&data);
-            if (data.kid_count > 0) {
-                log_info(tag, "%d + %d kids leaving lower station (%s)",
-                         data.id, data.kid_count, reason);
-            } else {
-                log_info(tag, "%d leaving lower station (%s)", data.id, reason);
-            }
-            // Release lower station slots
-            if (sem_wait_pauseable(&res, SEM_STATE, 1) == 0) {
-                res.state->lower_station_count -= data.station_slots;
-                sem_post(res.sem_id, SEM_STATE, 1);
-            }
-            sem_post(res.sem_id, SEM_LOWER_STATION, data.station_slots);
-            break;
+/**
+ * @brief Thread host mode: run each received tourist as a detached thread.
+ *
+ * All threads share this process's IPCResources. After the sentinel (or
+ * shutdown) the host waits for every hosted tourist to finish.
+ *
+ * @param res Attached IPC resources.
+ * @return Number of tourists hosted.
+ */
+static int run_host(IPCResources *res) {
+    int hosted = 0;
+    pthread_attr_t attr;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    pthread_attr_setstacksize(&attr, TOURIST_THREAD_STACK_SIZE);
+
+    HostedTourist *ht = malloc(sizeof(HostedTourist));
+    while (ht && receive_descriptor(res, &ht->data)) {
+        ht->res = res;
+
+        pthread_mutex_lock(&g_host_lock);
+        g_host_active++;
+        pthread_mutex_unlock(&g_host_lock);
+
+        pthread_t tid;
+        int rc;
+        time_participant_add(res->state);
+        while ((rc = pthread_create(&tid, &attr, hosted_tourist_func, ht)) == EAGAIN && g_running) {
+            // Thread limit reached: wait for hosted tourists to finish
+            time_wait_begin();
+            usleep(10000);
+            time_wait_end();
         }
 
-        // Wait for platform gate (3 gates on lower platform)
-        if (sem_wait_pauseable(&res, SEM_PLATFORM_GATES, 1) == -1) {
-            if (sem_wait_pauseable(&res, SEM_STATE, 1) == 0) {
-                res.state->lower_station_count -= data.station_slots;
-                sem_post(res.sem_id, SEM_STATE, 1);
+        if (rc != 0) {
+            if (rc != EAGAIN) {
+                errno = rc;
+                perror("tourist host: pthread_create");
             }
-            sem_post(res.sem_id, SEM_LOWER_STATION, data.station_slots);
-            break;
+            // Run inline so the descriptor is not lost
+            time_participant_remove(res->state);
+            pthread_mutex_lock(&g_host_lock);
+            g_host_active--;
+            pthread_mutex_unlock(&g_host_lock);
+            tourist_run(res, &ht->data, &g_running);
+            free(ht);
         }
 
-        log_info(tag, "%d passed through platform gate", data.id);
+        hosted++;
+        ht = malloc(sizeof(HostedTourist));
+    }
+    free(ht);
 
-        // Release station slots now that we're past the platform gate
-        if (sem_wait_pauseable(&res, SEM_STATE, 1) == 0) {
-            res.state->lower_station_count -= data.station_slots;
-            sem_post(res.sem_id, SEM_STATE, 1);
-        }
-        sem_post(res.sem_id, SEM_LOWER_STATION, data.station_slots);
-
-        // Board chair (family boards together)
-        time_t departure_time = 0;
-        int chair_id = 0;
-        int tourists_on_chair = 0;
-        if (tourist_board_chair(&res, &data, &departure_time, &chair_id, &tourists_on_chair) == -1) {
-            sem_post(res.sem_id, SEM_PLATFORM_GATES, 1);
-            break;
-        }
+    pthread_attr_destroy(&attr);
 
-        // Release platform gate (now boarding chair)
-        sem_post(res.sem_id, SEM_PLATFORM_GATES, 1);
+    // Wait for all hosted tourists before detaching IPC (they hold the clock, not the host)
+    time_participant_leave(res->state);
+    pthread_mutex_lock(&g_host_lock);
+    while (g_host_active > 0) {
+        pthread_cond_wait(&g_host_idle, &g_host_lock);
+    }
+    pthread_mutex_unlock(&g_host_lock);
 
-        if (data.kid_count > 0) {
-            log_info(tag, "%d + %d kids boarded chairlift", data.id, data.kid_count);
-        } else {
-            log_info(tag, "%d boarded chairlift", data.id);
-        }
+    return hosted;
+}
 
-        // Ride chairlift (synchronized with other passengers via departure_time)
-        if (tourist_ride_chairlift(&res, &data, departure_time, &g_running) == -1) {
-            break;
-        }
+int main(int argc, char *argv[]) {
+    TouristData data;
+    int pool_mode = (argc == 2 && strcmp(argv[1], "--pool") == 0);
+    int host_mode = (argc == 2 && strcmp(argv[1], "--host") == 0);
+    int events_mode = (argc == 2 && strcmp(argv[1], "--events") == 0);
+    int fibers_mode = (argc == 2 && strcmp(argv[1], "--fibers") == 0);
+    int engine_mode = pool_mode || host_mode || events_mode || fibers_mode;
+    // "tourist <id>": attributes come from the arrival schedule once attached
+    int scheduled = (argc == 2 && !engine_mode);
+
+    if (!engine_mode && !scheduled &&
+        tourist_parse_args(argc, argv, &data) == -1) {
+        return 1;
+    }
 
-        // Arrive at upper platform (pass chair info for atomic SEM_CHAIRS release)
-        if (tourist_arrive_upper(&res, &data, chair_id, tourists_on_chair) == -1) {
-            break;
-        }
+    // Install signal handlers
+    tourist_setup_signals(&g_running);
 
-        // Descend trail
-        if (tourist_descend_trail(&res, &data, &g_running) == -1) {
-            break;
-        }
+    // Generate IPC keys (using current directory - same for all processes)
+    IPCKeys keys;
+    if (ipc_generate_keys(&keys, ".") == -1) {
+        fprintf(stderr, "tourist: Failed to generate IPC keys\n");
+        return 1;
+    }
 
-        data.rides_completed++;
-        tourist_update_stats(&res, &data);
+    // Attach to IPC resources
+    IPCResources res;
+    if (ipc_attach(&res, &keys) == -1) {
+        fprintf(stderr, "tourist: Failed to attach to IPC\n");
+        return 1;
+    }
+    // The generator counted this process as a participant before forking it
+    time_participant_adopt(res.state);
+    if (scheduled && tourist_init_scheduled(&data, res.state, atoi(argv[1])) == -1) {
+        time_participant_leave(res.state);
+        ipc_detach(&res);
+        return 1;
+    }
 
-        if (data.kid_count > 0) {
-            log_info(tag, "%d + %d kids completed ride #%d",
-                     data.id, data.kid_count, data.rides_completed);
-        } else {
-            log_info(tag, "%d completed ride #%d",
-                     data.id, data.rides_completed);
-        }
+    // Initialize logger (VIPs get distinct color)
+    int single_vip = !engine_mode && data.is_vip;
+    logger_init(res.state, single_vip ? LOG_VIP : LOG_TOURIST);
+    logger_set_debug_enabled(res.state->cfg.debug_logs_enabled);
 
-        // Single ticket: one ride only
-        if (data.ticket_type == TICKET_SINGLE) {
-            log_info(tag, "%d leaving (single ticket used)", data.id);
-            break;
-        }
+    // Map the event trace again (the mapping does not survive exec)
+    if (trace_attach(res.state) == -1) {
+        fprintf(stderr, "tourist: Failed to map event trace, not tracing\n");
     }
 
-    if (data.kid_count > 0) {
-        log_info(tag, "%d + %d kids exiting (total rides: %d)",
-                 data.id, data.kid_count, data.rides_completed);
-    } else {
-        log_info(tag, "%d exiting (total rides: %d)",
-                 data.id, data.rides_completed);
+    int ret = 0;
+    if (pool_mode) {
+        run_pool(&res);
+    } else if (host_mode) {
+        run_host(&res);
+    } else if (events_mode) {
+        tourist_events_run(&res, &g_running);
+    } else if (fibers_mode) {
+        if (tourist_fibers_run(&res, &g_running) == -1) {
+            ret = 1;
+        }
+    } else if (tourist_run(&res, &data, &g_running) == -1) {
+        ret = 1;
     }
 
-cleanup_family:
-    tourist_join_family_threads(&data, kid_threads, bike_thread, bike_thread_created);
+    time_participant_leave(res.state);
+    stats_release(res.state);
     ipc_detach(&res);
-    return 0;
+    return ret;
 }
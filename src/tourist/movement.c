@@ -4,17 +4,18 @@
  */
 
 #include "tourist/movement.h"
+#include "ipc/control.h"
 #include "tourist/init.h"
 #include "core/time_sim.h"
 #include "core/logger.h"
-
-#include <errno.h>
-#include <stdlib.h>
+#include "core/rng.h"
 
 /**
  * @brief Pause-aware sleep for simulated durations.
  *
- * Handles EINTR from signals and checks running flags.
+ * Sleeps to an absolute deadline on the pause-adjusted clock
+ * (time_sleep_until_elapsed_ns), so EINTR and pauses neither shorten nor
+ * stretch the sleep.
  *
  * @param res IPC resources.
  * @param real_seconds Duration to sleep in real seconds.
@@ -22,25 +23,8 @@
  * @return 0 on success, -1 if interrupted by shutdown.
  */
 int tourist_pauseable_sleep(IPCResources *res, double real_seconds, int *running_flag) {
-    time_t start = time(NULL);
-    double remaining = real_seconds;
-
-    while (remaining > 0 && *running_flag && res->state->running) {
-        struct timespec ts;
-        ts.tv_sec = (time_t)remaining;
-        ts.tv_nsec = (long)((remaining - ts.tv_sec) * 1e9);
-
-        int ret = nanosleep(&ts, &ts);
-
-        if (ret == -1 && errno == EINTR) {
-            // Signal interrupted sleep - recalculate remaining time
-            remaining = real_seconds - (double)(time(NULL) - start);
-        } else {
-            break;
-        }
-    }
-
-    return (*running_flag && res->state->running) ? 0 : -1;
+    int64_t deadline_ns = time_elapsed_ns(res->state) + (int64_t)(real_seconds * 1e9);
+    return time_sleep_until_elapsed_ns(res->state, deadline_ns, running_flag);
 }
 
 /**
@@ -48,29 +32,20 @@ int tourist_pauseable_sleep(IPCResources *res, double real_seconds, int *running
  *
  * @param res IPC resources.
  * @param data Tourist data.
- * @param departure_time Time when chair departed.
+ * @param departure_ns Chair departure on the time_elapsed_ns() timeline.
  * @param running_flag Pointer to running flag.
  * @return 0 on success, -1 if interrupted by shutdown.
  */
 int tourist_ride_chairlift(IPCResources *res, TouristData *data,
-                           time_t departure_time, int *running_flag) {
-    // Calculate expected arrival time
-    double travel_seconds = time_sim_to_real_seconds(res->state, res->state->chair_travel_time_sim);
-    time_t arrival_time = departure_time + (time_t)travel_seconds;
-
-    // Calculate how long we still need to wait
-    time_t now = time(NULL);
-    double remaining = (double)(arrival_time - now);
+                           int64_t departure_ns, int *running_flag) {
+    // Every rider of the chair sleeps to the same arrival deadline
+    double travel_seconds = time_sim_to_real_seconds(res->state, res->state->cfg.chair_travel_time_sim);
+    int64_t arrival_ns = departure_ns + (int64_t)(travel_seconds * 1e9);
 
     log_info(tourist_get_tag(data), "%d riding chairlift (%.1f real seconds)",
              data->id, travel_seconds);
 
-    // Only sleep if we haven't already reached arrival time
-    if (remaining > 0) {
-        return tourist_pauseable_sleep(res, remaining, running_flag);
-    }
-
-    return 0;
+    return time_sleep_until_elapsed_ns(res->state, arrival_ns, running_flag);
 }
 
 /**
@@ -86,21 +61,21 @@ int tourist_descend_trail(IPCResources *res, TouristData *data, int *running_fla
 
     if (data->type == TOURIST_CYCLIST) {
         // Cyclists randomly pick a bike trail
-        int r = rand() % 3;
+        int r = rng_below(rng_local(), 3);
         switch (r) {
             case 0:
-                trail_time_sim = res->state->trail_bike_fast_time;
+                trail_time_sim = res->state->cfg.trail_bike_fast_time;
                 break;
             case 1:
-                trail_time_sim = res->state->trail_bike_medium_time;
+                trail_time_sim = res->state->cfg.trail_bike_medium_time;
                 break;
             default:
-                trail_time_sim = res->state->trail_bike_slow_time;
+                trail_time_sim = res->state->cfg.trail_bike_slow_time;
                 break;
         }
     } else {
         // Walkers and families walk the trail
-        trail_time_sim = res->state->trail_walk_time;
+        trail_time_sim = res->state->cfg.trail_walk_time;
     }
 
     double trail_seconds = time_sim_to_real_seconds(res->state, trail_time_sim);
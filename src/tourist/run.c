@@ -0,0 +1,258 @@
+/**
+ * @file tourist/run.c
+ * @brief Single tourist lifecycle (ticket, ride loop, exit) on attached IPC.
+ */
+
+#include "tourist/run.h"
+#include "ipc/control.h"
+#include "tourist/init.h"
+#include "tourist/threads.h"
+#include "tourist/lifecycle.h"
+#include "tourist/boarding.h"
+#include "tourist/movement.h"
+#include "tourist/stats.h"
+#include "core/logger.h"
+#include "core/trace.h"
+#include "core/latency.h"
+#include "core/rng.h"
+
+#include <string.h>
+#include <time.h>
+
+/**
+ * @brief Run one tourist from arrival to exit.
+ *
+ * @param res Attached IPC resources (may be shared by several tourist threads).
+ * @param data Tourist data (initialized by tourist_init_data).
+ * @param running_flag Pointer to running flag cleared on SIGTERM/SIGINT.
+ * @return 0 on completion, -1 if family threads could not be created.
+ */
+int tourist_run(IPCResources *res, TouristData *data, int *running_flag) {
+    FamilyState family;
+    pthread_t kid_threads[MAX_KIDS_PER_ADULT];
+    KidThreadData kid_data[MAX_KIDS_PER_ADULT];
+    pthread_t bike_thread;
+    BikeThreadData bike_data;
+    int bike_thread_created = 0;
+
+    memset(&family, 0, sizeof(family));
+    memset(&bike_data, 0, sizeof(bike_data));
+
+    // Private copy: tourist_choose_line() re-points it at a line every ride
+    IPCResources line_res = *res;
+    res = &line_res;
+
+    // Per-thread log color (VIPs get distinct color; logger_init done by caller)
+    logger_set_thread_component(data->is_vip ? LOG_VIP : LOG_TOURIST);
+
+    // Own random stream per tourist (reproducible with RANDOM_SEED)
+    rng_local_seed(rng_base_seed(res->state->cfg.random_seed), RNG_STREAM_TOURIST + (uint64_t)data->id);
+
+    // Initialize family state (simple data only - no sync primitives)
+    family.parent_id = data->id;
+    family.kid_count = data->kid_count;
+    family.has_bike = (data->type == TOURIST_CYCLIST);
+    family.res = res;
+
+    // Create family threads (kids and bike)
+    if (tourist_create_family_threads(data, &family, kid_data, kid_threads,
+                                       &bike_data, &bike_thread, &bike_thread_created) == -1) {
+        return -1;
+    }
+
+    const char *tag = tourist_get_tag(data);
+    const char *type_names[] = {"walker", "cyclist", "family"};
+    const char *type_name = type_names[data->type];
+    if (data->kid_count > 0) {
+        log_info(tag, "%d arrived (age %d, %s%s) with %d kid(s)",
+                 data->id, data->age, type_name, data->is_vip ? ", VIP" : "", data->kid_count);
+    } else {
+        log_info(tag, "%d arrived (age %d, %s%s)",
+                 data->id, data->age, type_name, data->is_vip ? ", VIP" : "");
+    }
+
+    int party = 1 + data->kid_count;
+
+    // Buy ticket at cashier (parent buys for whole family)
+    trace_tourist_stage(data->id, STAGE_AT_CASHIER, 0, party);
+    if (tourist_buy_ticket(res, data) == -1) {
+        log_info(tag, "%d leaving (no ticket)", data->id);
+        goto cleanup_family;
+    }
+
+    const char *ticket_names[] = {"SINGLE", "TIME_T1", "TIME_T2", "TIME_T3", "DAILY"};
+    if (data->kid_count > 0) {
+        log_info(tag, "%d got %s family ticket for %d",
+                 data->id, ticket_names[data->ticket_type], 1 + data->kid_count);
+    } else {
+        log_info(tag, "%d got %s ticket",
+                 data->id, ticket_names[data->ticket_type]);
+    }
+
+    // Record tourist entry for final report
+    tourist_record_entry(res, data);
+
+    // Main ride loop
+    while (*running_flag && control_running(res->state)) {
+        // Check exit conditions
+        if (!tourist_is_ticket_valid(res, data)) {
+            log_info(tag, "%d leaving (ticket expired)", data->id);
+            break;
+        }
+
+        if (tourist_is_station_closing(res)) {
+            log_info(tag, "%d leaving (station closing)", data->id);
+            break;
+        }
+
+        // Pick this ride's line (least-loaded lower station)
+        int line = tourist_choose_line(res, data);
+        if (res->line_count > 1) {
+            log_debug(tag, "%d heading to line %d", data->id, line);
+        }
+
+        // Enter through entry gate (VIPs skip the queue)
+        trace_tourist_stage(data->id, STAGE_AT_ENTRY_GATES, 0, party);
+        if (data->is_vip) {
+            log_info(tag, "%d skipped gate queue", data->id);
+        } else {
+            uint64_t gate_start = latency_now_us();
+            if (sem_wait_pauseable(res, SEM_ENTRY_GATES, 1) == -1) {
+                break;
+            }
+            latency_record_since(res->state, LAT_ENTRY_GATES, gate_start);
+            log_info(tag, "%d entered through gate", data->id);
+        }
+
+        // Enter lower station (wait if full)
+        uint64_t station_start = latency_now_us();
+        if (sem_wait_pauseable(res, SEM_LOWER_STATION, data->station_slots) == -1) {
+            if (!data->is_vip) sem_post(res->sem_id, SEM_ENTRY_GATES, 1);
+            break;
+        }
+        latency_record_since(res->state, LAT_LOWER_STATION, station_start);
+
+        // Update station count for logging (lock-free, display only)
+        int count = __atomic_add_fetch(&ipc_line_state(res)->lower_station_count,
+                                       data->station_slots, __ATOMIC_RELAXED);
+
+        trace_tourist_stage(data->id, STAGE_ENTERED_LOWER_STATION, 0, party);
+
+        // Release entry gate now that we're in station
+        if (!data->is_vip) {
+            sem_post(res->sem_id, SEM_ENTRY_GATES, 1);
+        }
+
+        if (data->kid_count > 0) {
+            log_info(tag, "%d + %d kids in lower station (count: %d/%d)",
+                     data->id, data->kid_count, count, res->state->cfg.station_capacity);
+        } else {
+            log_info(tag, "%d in lower station (count: %d/%d)",
+                     data->id, count, res->state->cfg.station_capacity);
+        }
+
+        // Check if tourist is too scared to ride
+        if (tourist_is_too_scared(res, data)) {
+            const char *reason = tourist_scared_reason(data);
+            if (data->kid_count > 0) {
+                log_info(tag, "%d + %d kids leaving lower station (%s)",
+                         data->id, data->kid_count, reason);
+            } else {
+                log_info(tag, "%d leaving lower station (%s)", data->id, reason);
+            }
+            // Release lower station slots
+            __atomic_sub_fetch(&ipc_line_state(res)->lower_station_count, data->station_slots,
+                               __ATOMIC_RELAXED);
+            sem_post(res->sem_id, SEM_LOWER_STATION, data->station_slots);
+            break;
+        }
+
+        // Wait for platform gate (3 gates on lower platform)
+        trace_tourist_stage(data->id, STAGE_QUEUED_FOR_PLATFORM, 0, party);
+        uint64_t platform_start = latency_now_us();
+        if (sem_wait_pauseable(res, SEM_PLATFORM_GATES, 1) == -1) {
+            __atomic_sub_fetch(&ipc_line_state(res)->lower_station_count, data->station_slots,
+                               __ATOMIC_RELAXED);
+            sem_post(res->sem_id, SEM_LOWER_STATION, data->station_slots);
+            break;
+        }
+        latency_record_since(res->state, LAT_PLATFORM_GATES, platform_start);
+
+        log_info(tag, "%d passed through platform gate", data->id);
+        trace_tourist_stage(data->id, STAGE_AT_LOWER_PLATFORM, 0, party);
+
+        // Release station slots now that we're past the platform gate
+        __atomic_sub_fetch(&ipc_line_state(res)->lower_station_count, data->station_slots,
+                           __ATOMIC_RELAXED);
+        sem_post(res->sem_id, SEM_LOWER_STATION, data->station_slots);
+
+        // Board chair (family boards together)
+        int64_t departure_ns = 0;
+        int chair_id = 0;
+        int tourists_on_chair = 0;
+        uint32_t dispatch_seq = 0;
+        if (tourist_board_chair(res, data, &departure_ns, &chair_id, &tourists_on_chair,
+                                &dispatch_seq) == -1) {
+            sem_post(res->sem_id, SEM_PLATFORM_GATES, 1);
+            break;
+        }
+
+        // Release platform gate (now boarding chair)
+        sem_post(res->sem_id, SEM_PLATFORM_GATES, 1);
+
+        if (data->kid_count > 0) {
+            log_info(tag, "%d + %d kids boarded chairlift", data->id, data->kid_count);
+        } else {
+            log_info(tag, "%d boarded chairlift", data->id);
+        }
+
+        // Ride chairlift (synchronized with other passengers via departure_ns)
+        trace_tourist_stage(data->id, STAGE_ON_CHAIR, chair_id, party);
+        if (tourist_ride_chairlift(res, data, departure_ns, running_flag) == -1) {
+            break;
+        }
+        trace_tourist_stage(data->id, STAGE_AT_UPPER_PLATFORM_GATES, chair_id, party);
+
+        // Arrive at upper platform (pass chair info for atomic SEM_CHAIRS release)
+        if (tourist_arrive_upper(res, data, chair_id, tourists_on_chair, dispatch_seq) == -1) {
+            break;
+        }
+
+        // Descend trail
+        trace_tourist_stage(data->id, STAGE_ON_TRAIL, 0, party);
+        if (tourist_descend_trail(res, data, running_flag) == -1) {
+            break;
+        }
+
+        data->rides_completed++;
+        tourist_update_stats(res, data);
+
+        if (data->kid_count > 0) {
+            log_info(tag, "%d + %d kids completed ride #%d",
+                     data->id, data->kid_count, data->rides_completed);
+        } else {
+            log_info(tag, "%d completed ride #%d",
+                     data->id, data->rides_completed);
+        }
+
+        // Single ticket: one ride only
+        if (data->ticket_type == TICKET_SINGLE) {
+            log_info(tag, "%d leaving (single ticket used)", data->id);
+            break;
+        }
+    }
+
+    if (data->kid_count > 0) {
+        log_info(tag, "%d + %d kids exiting (total rides: %d)",
+                 data->id, data->kid_count, data->rides_completed);
+    } else {
+        log_info(tag, "%d exiting (total rides: %d)",
+                 data->id, data->rides_completed);
+    }
+    tourist_record_exit(res, data);
+
+cleanup_family:
+    trace_tourist_stage(data->id, STAGE_LEAVING, 0, party);
+    tourist_join_family_threads(data, kid_threads, bike_thread, bike_thread_created);
+    return 0;
+}
@@ -1,10 +1,31 @@
 /**
  * @file tourist/stats.c
  * @brief Statistics recording for final report.
+ *
+ * All updates are lock-free: every tourist only writes its own
+ * tourist_entries slot, and totals go to this thread's statistics shard,
+ * so the ride path never waits on SEM_STATS or shares a cache line.
+ * With REPORT_INCREMENTAL=1 there is no table: the entry is built from
+ * TouristData once, when the tourist leaves, and pushed to the completion
+ * ring.
  */
 
 #include "tourist/stats.h"
+#include "core/stats.h"
 #include "core/time_sim.h"
+#include "core/logger.h"
+#include "core/completion_ring.h"
+
+/**
+ * @brief Raise *target to at least value.
+ */
+static void atomic_max_int(int *target, int value) {
+    int cur = __atomic_load_n(target, __ATOMIC_RELAXED);
+    while (cur < value &&
+           !__atomic_compare_exchange_n(target, &cur, value, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+    }
+}
 
 /**
  * @brief Record tourist entry in shared state for final report.
@@ -13,28 +34,25 @@
  * @param data Tourist data.
  */
 void tourist_record_entry(IPCResources *res, TouristData *data) {
-    if (sem_wait_pauseable(res, SEM_STATS, 1) == -1) {
-        return;  // Shutdown in progress
-    }
+    data->entry_time_sim = time_get_sim_minutes(res->state);
 
     int idx = data->id - 1;
-    if (idx >= 0 && idx < res->state->max_tracked_tourists) {
-        TouristEntry *entry = &res->state->tourist_entries[idx];
-        entry->active = 1;
-        entry->tourist_id = data->id;
-        entry->ticket_type = data->ticket_type;
-        entry->entry_time_sim = time_get_sim_minutes(res->state);
-        entry->total_rides = 0;
-        entry->is_vip = data->is_vip;
-        entry->tourist_type = data->type;
-        entry->kid_count = data->kid_count;
-
-        if (idx >= res->state->tourist_entry_count) {
-            res->state->tourist_entry_count = idx + 1;
-        }
+    if (idx < 0 || idx >= res->state->max_tracked_tourists) {
+        return;
     }
 
-    sem_post(res->sem_id, SEM_STATS, 1);
+    // Untouched table pages are never committed: this is the first write to the slot's page
+    TouristEntry *entry = &res->state->tourist_entries[idx];
+    entry->ticket_type = (uint8_t)data->ticket_type;
+    entry->entry_time_sim = (uint16_t)data->entry_time_sim;
+    entry->total_rides = 0;
+    entry->is_vip = data->is_vip ? 1 : 0;
+    entry->tourist_type = (uint8_t)data->type;
+    entry->kid_count = (uint8_t)data->kid_count;
+
+    // Publish the slot after its fields are written
+    __atomic_store_n(&entry->active, 1, __ATOMIC_RELEASE);
+    atomic_max_int(&res->state->tourist_entry_count, idx + 1);
 }
 
 /**
@@ -44,29 +62,39 @@ void tourist_record_entry(IPCResources *res, TouristData *data) {
  * @param data Tourist data.
  */
 void tourist_update_stats(IPCResources *res, TouristData *data) {
-    if (sem_wait_pauseable(res, SEM_STATS, 1) == -1) {
-        return;  // Shutdown in progress
-    }
+    // Parent ride plus kid rides (same ticket type as parent)
+    stats_add_rides(res->state, data->ticket_type, 1 + data->kid_count);
 
-    // Count parent ride
-    res->state->total_rides++;
-    if (data->ticket_type >= 0 && data->ticket_type < TICKET_COUNT) {
-        res->state->rides_by_ticket[data->ticket_type]++;
-    }
-
-    // Update per-tourist ride count
+    // Update per-tourist ride count (only this tourist writes its slot)
     int idx = data->id - 1;
     if (idx >= 0 && idx < res->state->max_tracked_tourists) {
-        res->state->tourist_entries[idx].total_rides++;
+        __atomic_add_fetch(&res->state->tourist_entries[idx].total_rides, 1, __ATOMIC_RELAXED);
     }
+}
 
-    // Count kid rides (same ticket type as parent)
-    for (int i = 0; i < data->kid_count; i++) {
-        res->state->total_rides++;
-        if (data->ticket_type >= 0 && data->ticket_type < TICKET_COUNT) {
-            res->state->rides_by_ticket[data->ticket_type]++;
-        }
+/**
+ * @brief Push the finished tourist to the completion ring (REPORT_INCREMENTAL=1).
+ *
+ * @param res IPC resources.
+ * @param data Tourist data.
+ */
+void tourist_record_exit(IPCResources *res, TouristData *data) {
+    CompletionRing *ring = completion_ring_get(res->state);
+    if (ring == NULL || data->entry_time_sim < 0) {
+        return;  // Table mode, or never got a ticket, or already reported
     }
 
-    sem_post(res->sem_id, SEM_STATS, 1);
+    TouristEntry entry = {0};
+    entry.total_rides = (uint16_t)data->rides_completed;
+    entry.entry_time_sim = (uint16_t)data->entry_time_sim;
+    entry.ticket_type = (uint8_t)data->ticket_type;
+    entry.tourist_type = (uint8_t)data->type;
+    entry.is_vip = data->is_vip ? 1 : 0;
+    entry.kid_count = (uint8_t)data->kid_count;
+    entry.active = 1;
+    data->entry_time_sim = -1;
+
+    if (completion_ring_push(ring, data->id, &entry) == -1) {
+        log_warn("TOURIST", "%d missing from report (report writer gone)", data->id);
+    }
 }
@@ -1,7 +1,7 @@
 #!/bin/bash
 # Run all tests
 # Usage: ./run_all.sh [category]
-# Categories: all, integration, stress, edge, recovery, signal, sync
+# Categories: all, integration, stress, edge, recovery, signal, sync, modes
 
 SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
 BUILD_DIR="${SCRIPT_DIR}/../build"
@@ -114,6 +114,51 @@ if [ "$CATEGORY" = "all" ] || [ "$CATEGORY" = "sync" ]; then
     run_test "Test 19: SIGALRM Sync" "${SCRIPT_DIR}/test19_sigalrm_sync.sh"
 fi
 
+# Execution mode tests (Test 21+)
+if [ "$CATEGORY" = "all" ] || [ "$CATEGORY" = "modes" ]; then
+    echo ">>> EXECUTION MODE TESTS <<<"
+    run_test "Test 21: Tourist Pool" "${SCRIPT_DIR}/test21_tourist_pool.sh"
+    run_test "Test 22: Thread Engine" "${SCRIPT_DIR}/test22_thread_engine.sh"
+    run_test "Test 23: Event Engine" "${SCRIPT_DIR}/test23_event_engine.sh"
+    run_test "Test 24: Shm Transport" "${SCRIPT_DIR}/test24_shm_transport.sh"
+    run_test "Test 25: Futex Semaphores" "${SCRIPT_DIR}/test25_futex_sems.sh"
+    run_test "Test 26: Batched Boarding" "${SCRIPT_DIR}/test26_boarding_batch.sh"
+    run_test "Test 27: Deadline Dispatcher" "${SCRIPT_DIR}/test27_deadline_dispatch.sh"
+    run_test "Test 28: Async Logger" "${SCRIPT_DIR}/test28_async_log.sh"
+    run_test "Test 29: Event Trace" "${SCRIPT_DIR}/test29_event_trace.sh"
+    run_test "Test 30: Latency Histograms" "${SCRIPT_DIR}/test30_latency_histograms.sh"
+    run_test "Test 31: Metrics Exporter" "${SCRIPT_DIR}/test31_metrics_exporter.sh"
+    run_test "Test 32: Compact Tourist Table" "${SCRIPT_DIR}/test32_compact_tourist_table.sh"
+    run_test "Test 33: Report CSV" "${SCRIPT_DIR}/test33_report_csv.sh"
+    run_test "Test 34: Incremental Report" "${SCRIPT_DIR}/test34_incremental_report.sh"
+    run_test "Test 35: Multi-Line" "${SCRIPT_DIR}/test35_multi_line.sh"
+    run_test "Test 36: Boarding Workers" "${SCRIPT_DIR}/test36_boarding_workers.sh"
+    run_test "Test 37: Bin-Packing Loader" "${SCRIPT_DIR}/test37_bin_packing.sh"
+    run_test "Test 38: Multi-Cashier" "${SCRIPT_DIR}/test38_multi_cashier.sh"
+    run_test "Test 39: Batched Cashier" "${SCRIPT_DIR}/test39_batched_cashier.sh"
+    run_test "Test 40: Epoch Clock" "${SCRIPT_DIR}/test40_epoch_clock.sh"
+    run_test "Test 41: Ride Deadline" "${SCRIPT_DIR}/test41_ride_deadline.sh"
+    run_test "Test 42: Seeded RNG" "${SCRIPT_DIR}/test42_seeded_rng.sh"
+    run_test "Test 43: Arrival Schedule" "${SCRIPT_DIR}/test43_arrival_schedule.sh"
+    run_test "Test 44: Poisson Arrivals" "${SCRIPT_DIR}/test44_poisson_arrivals.sh"
+    run_test "Test 45: Max Speed" "${SCRIPT_DIR}/test45_max_speed.sh"
+    run_test "Test 46: Parameter Sweep" "${SCRIPT_DIR}/test46_sweep.sh"
+    run_test "Test 47: Huge Pages and NUMA" "${SCRIPT_DIR}/test47_numa_hugepages.sh"
+    run_test "Test 48: CPU Isolation" "${SCRIPT_DIR}/test48_cpu_isolation.sh"
+    run_test "Test 49: Startup Telemetry" "${SCRIPT_DIR}/test49_startup_telemetry.sh"
+    run_test "Test 50: Config Block" "${SCRIPT_DIR}/test50_config_block.sh"
+    run_test "Test 51: Emergency Futex" "${SCRIPT_DIR}/test51_emergency_futex.sh"
+    run_test "Test 52: Child Reaper" "${SCRIPT_DIR}/test52_child_reaper.sh"
+    run_test "Test 53: Chair Ring" "${SCRIPT_DIR}/test53_chair_ring.sh"
+    run_test "Test 54: Checkpoint" "${SCRIPT_DIR}/test54_checkpoint.sh"
+    run_test "Test 55: Danger Replay" "${SCRIPT_DIR}/test55_danger_replay.sh"
+    run_test "Test 56: Remote Hosts" "${SCRIPT_DIR}/test56_remote_hosts.sh"
+    run_test "Test 57: Fiber Engine" "${SCRIPT_DIR}/test57_fiber_engine.sh"
+    run_test "Test 58: Process Usage" "${SCRIPT_DIR}/test58_process_usage.sh"
+    run_test "Test 59: Queue Pressure" "${SCRIPT_DIR}/test59_queue_pressure.sh"
+    run_test "Test 60: Preflight" "${SCRIPT_DIR}/test60_preflight.sh"
+fi
+
 # Summary
 echo "=========================================="
 echo "SUMMARY"
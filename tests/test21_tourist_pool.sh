@@ -0,0 +1,92 @@
+#!/bin/bash
+# Test 21: Pre-forked Tourist Pool
+#
+# Goal: Tourists are served by a fixed pool of long-lived tourist processes.
+#
+# Rationale: With TOURIST_POOL_SIZE > 0 the generator execs the pool once and
+# sends descriptors over MQ_SPAWN. Verifies that descriptors are consumed,
+# pool members run more than one tourist each, and that sentinels/EIDRM make
+# every pool member exit (no zombies, orphans or leftover IPC).
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: Pool started, tourists complete rides, more tourists than
+# pool processes, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test21_tourist_pool.conf"
+LOG_FILE="/tmp/ropeway_test21.log"
+POOL_SIZE=16
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 21: Pre-forked Tourist Pool ==="
+echo "Goal: Verify $POOL_SIZE pooled processes serve many tourists"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - pool members did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Started tourist pool ($POOL_SIZE processes)" "$LOG_FILE"; then
+    echo "FAIL: Tourist pool was not started"
+    exit 1
+fi
+
+ARRIVED=$(grep -c "arrived (age" "$LOG_FILE")
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+echo "Tourists arrived: $ARRIVED"
+echo "Rides completed: $RIDES"
+
+if [ "$ARRIVED" -le "$POOL_SIZE" ]; then
+    echo "FAIL: Pool did not serve more tourists than it has processes"
+    exit 1
+fi
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed in pool mode"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned pool members
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pgrep -a tourist
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Tourist pool served $ARRIVED tourists with $POOL_SIZE processes"
+exit 0
@@ -0,0 +1,107 @@
+#!/bin/bash
+# Test 22: Thread-per-Tourist Engine
+#
+# Goal: Tourists run as threads inside a small number of host processes.
+#
+# Rationale: With TOURIST_ENGINE=1 the generator execs "tourist --host"
+# TOURIST_POOL_SIZE times and each descriptor becomes a detached thread that
+# shares the host's IPCResources. Verifies the same state machine works when
+# many tourists share one address space (per-tourist boarding/cashier mtypes,
+# shared semaphores) and that hosts wait for their threads before exiting.
+#
+# Parameters: tourists=1000, hosts=2, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: Only host processes exist for tourists, far more tourists
+# than processes, rides complete, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test22_thread_engine.conf"
+LOG_FILE="/tmp/ropeway_test22.log"
+HOSTS=2
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 22: Thread-per-Tourist Engine ==="
+echo "Goal: Verify 1000 tourists run as threads in $HOSTS host processes"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Sample tourist process/thread counts mid-run
+sleep 5
+TOURIST_PROCS=$(pgrep -x tourist | wc -l)
+TOURIST_THREADS=$(ps -eLo comm | grep -c "^tourist$")
+echo "Tourist host processes: $TOURIST_PROCS, threads: $TOURIST_THREADS"
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - hosts did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Started tourist thread hosts ($HOSTS processes)" "$LOG_FILE"; then
+    echo "FAIL: Thread hosts were not started"
+    exit 1
+fi
+
+if [ "$TOURIST_PROCS" -gt "$HOSTS" ]; then
+    echo "FAIL: Found $TOURIST_PROCS tourist processes (expected at most $HOSTS)"
+    exit 1
+fi
+
+ARRIVED=$(grep -c "arrived (age" "$LOG_FILE")
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+echo "Tourists arrived: $ARRIVED"
+echo "Rides completed: $RIDES"
+
+if [ "$ARRIVED" -le "$HOSTS" ]; then
+    echo "FAIL: Hosts did not run more tourists than processes"
+    exit 1
+fi
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed in thread engine"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned hosts
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pgrep -a tourist
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Thread engine ran $ARRIVED tourists in $HOSTS host processes"
+exit 0
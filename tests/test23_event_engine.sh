@@ -0,0 +1,108 @@
+#!/bin/bash
+# Test 23: Discrete-Event Tourist Engine
+#
+# Goal: All tourists run as state records inside a single event host process.
+#
+# Rationale: With TOURIST_ENGINE=2 the generator execs one "tourist --events"
+# process. Each descriptor becomes a record that moves between TouristStage
+# values; chair rides and trails are timers on a min-heap keyed on sim time,
+# and every semaphore/queue operation is non-blocking with FIFO retry. Verifies
+# that one single-threaded process can drive the whole ride loop against the
+# real cashier and platform workers, and that it exits once every record left.
+#
+# Parameters: tourists=2000, event hosts=1, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: One tourist process with one thread, rides complete,
+# clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test23_event_engine.conf"
+LOG_FILE="/tmp/ropeway_test23.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 23: Discrete-Event Tourist Engine ==="
+echo "Goal: Verify 2000 tourists run as state records in one event host"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Sample tourist process/thread counts mid-run
+sleep 5
+TOURIST_PROCS=$(pgrep -x tourist | wc -l)
+TOURIST_THREADS=$(ps -eLo comm | grep -c "^tourist$")
+echo "Tourist processes: $TOURIST_PROCS, threads: $TOURIST_THREADS"
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - event host did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Started tourist event engine (1 process)" "$LOG_FILE"; then
+    echo "FAIL: Event engine was not started"
+    exit 1
+fi
+
+if [ "$TOURIST_PROCS" -gt 1 ] || [ "$TOURIST_THREADS" -gt 1 ]; then
+    echo "FAIL: Found $TOURIST_PROCS tourist processes / $TOURIST_THREADS threads (expected 1)"
+    exit 1
+fi
+
+ARRIVED=$(grep -c "arrived (age" "$LOG_FILE")
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+echo "Tourists arrived: $ARRIVED"
+echo "Rides completed: $RIDES"
+grep "Event engine finished" "$LOG_FILE" | tail -1
+
+if [ "$ARRIVED" -le 1 ]; then
+    echo "FAIL: Event host did not run more than one tourist"
+    exit 1
+fi
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed in event engine"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pgrep -a tourist
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Event engine ran $ARRIVED tourists in one process"
+exit 0
@@ -0,0 +1,101 @@
+#!/bin/bash
+# Test 24: Shared-Memory Ring Transport
+#
+# Goal: Platform, boarding and arrivals traffic runs over lock-free rings and
+# per-tourist mailboxes in the shm segment instead of System V queues.
+#
+# Rationale: With QUEUE_TRANSPORT=1 tourists push "ready to board" messages
+# into an MPSC ring drained by the lower worker (requeues go to a priority
+# ring), confirmations land in per-tourist mailboxes, and arrivals go through
+# a second MPSC ring to the upper worker. Sleepers use futexes with bounded
+# waits, so the SIGALRM dispatch timeout and shutdown must still work.
+#
+# Parameters: tourists=400, pool=16, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: Rides complete, every completed ride was seen by the upper
+# worker, station capacity respected, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test24_shm_transport.conf"
+LOG_FILE="/tmp/ropeway_test24.log"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 24: Shared-Memory Ring Transport ==="
+echo "Goal: Verify boarding and arrivals work over shm rings"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - ring waiters did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Initialized shm ring transport" "$LOG_FILE"; then
+    echo "FAIL: Ring transport was not initialized"
+    exit 1
+fi
+
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+UPPER=$(grep -c "arrived at upper platform" "$LOG_FILE")
+echo "Rides completed: $RIDES"
+echo "Upper platform arrivals: $UPPER"
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed over ring transport"
+    exit 1
+fi
+
+# A ride completes only after its arrival went through the arrivals ring
+if [ "$UPPER" -lt "$RIDES" ]; then
+    echo "FAIL: Upper worker saw $UPPER arrivals for $RIDES completed rides"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Ring transport completed $RIDES rides"
+exit 0
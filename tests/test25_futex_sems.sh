@@ -0,0 +1,91 @@
+#!/bin/bash
+# Test 25: Futex Semaphores
+#
+# Goal: SEM_STATE, SEM_STATS and the gate/station capacity semaphores run on
+# futex words in shared memory instead of semop().
+#
+# Rationale: With SEM_BACKEND=1 uncontended acquire/release is a single CAS or
+# atomic add and only contended callers enter the kernel. Capacity limits must
+# still hold, and sleepers must notice IPC_RMID at shutdown even though the
+# kernel does not wake futex waiters when the SysV set is removed.
+#
+# Parameters: tourists=400, pool=16, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: Rides complete, station capacity respected, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test25_futex_sems.conf"
+LOG_FILE="/tmp/ropeway_test25.log"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 25: Futex Semaphores ==="
+echo "Goal: Verify locks and capacity semaphores work on futexes"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - futex waiters did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Futex semaphore backend enabled" "$LOG_FILE"; then
+    echo "FAIL: Futex semaphore backend was not enabled"
+    exit 1
+fi
+
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+echo "Rides completed: $RIDES"
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed with futex semaphores"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Futex semaphores completed $RIDES rides"
+exit 0
@@ -0,0 +1,102 @@
+#!/bin/bash
+# Test 26: Batched Boarding
+#
+# Goal: Each departing chair confirms all of its riders through one chair
+# table record and a single futex wake-up.
+#
+# Rationale: With BOARDING_BATCH=1 the lower worker writes (chair_id,
+# departure_time, members) once to the chair table in the ring transport,
+# stores a reference in each rider's mailbox, and wakes the shared
+# board_epoch futex once. Riders of one chair must share its departure,
+# table slots must only be reused after every rider has read them, and
+# shutdown must still wake sleepers.
+#
+# Parameters: tourists=400, pool=16, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: Rides complete, every completed ride was seen by the upper
+# worker, station capacity respected, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test26_boarding_batch.conf"
+LOG_FILE="/tmp/ropeway_test26.log"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 26: Batched Boarding ==="
+echo "Goal: Verify chair departures confirm riders via the chair table"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - boarding waiters did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Initialized shm ring transport.*chair_table=on" "$LOG_FILE"; then
+    echo "FAIL: Chair table was not enabled"
+    exit 1
+fi
+
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+UPPER=$(grep -c "arrived at upper platform" "$LOG_FILE")
+echo "Rides completed: $RIDES"
+echo "Upper platform arrivals: $UPPER"
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed with batched boarding"
+    exit 1
+fi
+
+# A ride completes only after its arrival went through the arrivals ring
+if [ "$UPPER" -lt "$RIDES" ]; then
+    echo "FAIL: Upper worker saw $UPPER arrivals for $RIDES completed rides"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Batched boarding completed $RIDES rides"
+exit 0
@@ -0,0 +1,100 @@
+#!/bin/bash
+# Test 27: Deadline Dispatcher
+#
+# Goal: Partially filled chairs leave at a fill deadline measured in
+# simulated time, without the lower worker's 100ms SIGALRM polling.
+#
+# Rationale: With CHAIR_FILL_DEADLINE_SIM_SECONDS > 0 the lower worker wakes
+# exactly when the next platform request arrives or the partial chair's
+# deadline passes. On SysV queues that takes one one-shot timer per partial
+# chair, not one ualarm per msgrcv. Partial chairs must still depart, and
+# full chairs must leave immediately.
+#
+# Parameters: tourists=400, pool=16, deadline=10 sim seconds, simulation_time=15s.
+#
+# Expected outcome: Rides complete, partial chairs depart, station capacity
+# respected, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test27_deadline_dispatch.conf"
+LOG_FILE="/tmp/ropeway_test27.log"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 27: Deadline Dispatcher ==="
+echo "Goal: Verify partial chairs leave at the sim-time fill deadline"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - dispatcher did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Deadline dispatcher: partial chairs leave after" "$LOG_FILE"; then
+    echo "FAIL: Deadline dispatcher was not enabled"
+    exit 1
+fi
+
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+PARTIAL=$(grep -c "departed with [0-9]* tourists ([123]/4 slots)" "$LOG_FILE")
+echo "Rides completed: $RIDES"
+echo "Partial chairs dispatched: $PARTIAL"
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed with the deadline dispatcher"
+    exit 1
+fi
+
+if [ "$PARTIAL" -eq 0 ]; then
+    echo "FAIL: No partially filled chair left at its deadline"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Deadline dispatcher completed $RIDES rides ($PARTIAL partial chairs)"
+exit 0
@@ -0,0 +1,118 @@
+#!/bin/bash
+# Test 28: Asynchronous Logger
+#
+# Goal: With LOG_ASYNC=1 every process appends binary records to the shm log
+# ring and the log drainer process formats and writes them in batches.
+#
+# Rationale: Producers format the message into a claimed ring slot and never
+# call write(); the drainer is the only writer to stderr. It must keep
+# running until every other worker has exited, drain the ring before exiting,
+# and in wait mode (LOG_ASYNC=1) no line may be lost or torn.
+#
+# Parameters: tourists=400, pool=16, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: Drainer starts and exits last, every ride's arrival and
+# completion lines are present, no dropped records, no torn lines, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test28_async_log.conf"
+LOG_FILE="/tmp/ropeway_test28.log"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 28: Asynchronous Logger ==="
+echo "Goal: Verify log lines go through the shm log ring and the log drainer"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - log drainer or producers did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Log drainer started" "$LOG_FILE"; then
+    echo "FAIL: Log drainer did not start"
+    exit 1
+fi
+
+if ! grep -q "Log drainer exiting" "$LOG_FILE"; then
+    echo "FAIL: Log drainer did not drain the ring and exit"
+    exit 1
+fi
+
+if grep -q "records dropped" "$LOG_FILE"; then
+    echo "FAIL: Records dropped in wait mode: $(grep "records dropped" "$LOG_FILE")"
+    exit 1
+fi
+
+# Every stderr line must be a whole log line (stdout banner lines excepted)
+TORN=$(grep -v '^\[' "$LOG_FILE" | grep -v -e "^Ropeway Simulation Starting" -e "^Config:" \
+       -e "^Station capacity:" -e "^Simulation:" -e "^Preflight:" | wc -l)
+if [ "$TORN" -gt 0 ]; then
+    echo "FAIL: Found $TORN torn or interleaved log lines"
+    exit 1
+fi
+
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+UPPER=$(grep -c "arrived at upper platform" "$LOG_FILE")
+echo "Rides completed: $RIDES"
+echo "Upper platform arrivals: $UPPER"
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed"
+    exit 1
+fi
+
+# A ride completes only after its arrival was logged, so no arrival line may be missing
+if [ "$UPPER" -lt "$RIDES" ]; then
+    echo "FAIL: Upper worker saw $UPPER arrivals for $RIDES completed rides"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Async logger wrote all lines for $RIDES rides"
+exit 0
@@ -0,0 +1,163 @@
+#!/bin/bash
+# Test 29: Event Trace
+#
+# Goal: With EVENT_TRACE=1 every tourist stage transition and every cashier,
+# lower worker and upper worker event is appended to the memory-mapped
+# binary trace, and trace_convert turns it into CSV and Chrome trace JSON.
+#
+# Rationale: Workers inherit the mapping through fork, pooled tourists map
+# the file again after exec. Each writer claims its record with one atomic
+# add, so the trace must hold exactly one record per logged event, and each
+# tourist's records must be in simulated-time order.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: Trace file closed with no drops, record counts match the
+# log, per-tourist timestamps never go backwards, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test29_event_trace.conf"
+LOG_FILE="/tmp/ropeway_test29.log"
+CSV_FILE="/tmp/ropeway_test29.csv"
+JSON_FILE="/tmp/ropeway_test29.json"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 29: Event Trace ==="
+echo "Goal: Verify every stage transition and worker event lands in the binary trace"
+echo "Running simulation..."
+
+rm -f event_trace.bin
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if [ ! -s event_trace.bin ]; then
+    echo "FAIL: event_trace.bin was not written"
+    exit 1
+fi
+
+if grep -q "event trace" "$LOG_FILE"; then
+    echo "FAIL: Trace errors: $(grep "event trace" "$LOG_FILE" | head -1)"
+    exit 1
+fi
+
+if ! ./trace_convert --csv event_trace.bin "$CSV_FILE" 2> /tmp/ropeway_test29.err; then
+    echo "FAIL: trace_convert --csv failed: $(cat /tmp/ropeway_test29.err)"
+    exit 1
+fi
+
+if grep -q "dropped" /tmp/ropeway_test29.err; then
+    echo "FAIL: $(cat /tmp/ropeway_test29.err)"
+    exit 1
+fi
+
+# Closed trace is shrunk to header + 24-byte records
+RECORDS=$(( $(tail -n +2 "$CSV_FILE" | wc -l) ))
+SIZE=$(stat -c %s event_trace.bin)
+echo "Trace records: $RECORDS ($SIZE bytes)"
+if [ "$SIZE" -ne $(( 64 + RECORDS * 24 )) ]; then
+    echo "FAIL: Trace file size $SIZE does not match $RECORDS records"
+    exit 1
+fi
+
+count_event() {
+    awk -F, -v src="$1" -v ev="$2" '$3 == src && $5 == ev' "$CSV_FILE" | wc -l
+}
+
+SOLD=$(count_event cashier ticket_sold)
+DEPARTED=$(count_event lower_worker chair_departed)
+ARRIVED=$(count_event upper_worker rider_arrived)
+ON_CHAIR=$(count_event tourist on_chair)
+LOG_SOLD=$(grep -c "Sold .* ticket to tourist" "$LOG_FILE")
+LOG_DEPARTED=$(grep -c "departed with" "$LOG_FILE")
+LOG_ARRIVED=$(grep -c "arrived at upper platform" "$LOG_FILE")
+LOG_BOARDED=$(grep -c "boarded chairlift" "$LOG_FILE")
+
+echo "Tickets sold: $SOLD (log: $LOG_SOLD)"
+echo "Chairs departed: $DEPARTED (log: $LOG_DEPARTED)"
+echo "Upper arrivals: $ARRIVED (log: $LOG_ARRIVED)"
+echo "Boardings: $ON_CHAIR (log: $LOG_BOARDED)"
+
+if [ "$ARRIVED" -eq 0 ]; then
+    echo "FAIL: No arrivals traced"
+    exit 1
+fi
+
+if [ "$SOLD" -ne "$LOG_SOLD" ] || [ "$DEPARTED" -ne "$LOG_DEPARTED" ] || \
+   [ "$ARRIVED" -ne "$LOG_ARRIVED" ] || [ "$ON_CHAIR" -ne "$LOG_BOARDED" ]; then
+    echo "FAIL: Trace record counts do not match the log"
+    exit 1
+fi
+
+# Every tourist that got a record starts at the cashier, and its clock never goes back
+BAD_ORDER=$(awk -F, '$3 == "tourist" {
+        id = $4
+        if (!(id in last) && $5 != "at_cashier") bad++
+        if ((id in last) && $1 < last[id]) bad++
+        last[id] = $1
+    } END { print bad + 0 }' "$CSV_FILE")
+if [ "$BAD_ORDER" -gt 0 ]; then
+    echo "FAIL: $BAD_ORDER tourist records out of order"
+    exit 1
+fi
+
+if ! ./trace_convert --chrome event_trace.bin "$JSON_FILE"; then
+    echo "FAIL: trace_convert --chrome failed"
+    exit 1
+fi
+if command -v python3 > /dev/null && ! python3 -m json.tool "$JSON_FILE" > /dev/null; then
+    echo "FAIL: Chrome trace is not valid JSON"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+rm -f "$CSV_FILE" "$JSON_FILE" /tmp/ropeway_test29.err
+echo "PASS: Event trace holds $RECORDS records matching the log"
+exit 0
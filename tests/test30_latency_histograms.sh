@@ -0,0 +1,116 @@
+#!/bin/bash
+# Test 30: Wait Latency Histograms
+#
+# Goal: Every blocking call a tourist makes (entry gates, lower station,
+# platform gates, boarding confirmation, exit gates) records its wait in a
+# shared-memory latency histogram, and the report prints p50/p90/p99/max.
+#
+# Rationale: Histograms are updated with relaxed atomic adds from hundreds
+# of tourist processes at once. A lost update would make a stage's sample
+# count differ from the number of matching log lines.
+#
+# Parameters: tourists=300 (one process each), station_capacity=20,
+# simulation_time=15s.
+#
+# Expected outcome: Each stage's sample count matches the log, percentiles
+# are ordered p50 <= p90 <= p99 <= max, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test30_latency_histograms.conf"
+LOG_FILE="/tmp/ropeway_test30.log"
+REPORT="simulation_report.txt"
+STATION_CAPACITY=20
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 30: Wait Latency Histograms ==="
+echo "Goal: Verify every blocking point feeds its latency histogram and the report prints percentiles"
+echo "Running simulation..."
+
+rm -f "$REPORT"
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "^--- Wait Latency" "$REPORT" 2>/dev/null; then
+    echo "FAIL: Report has no wait latency section"
+    exit 1
+fi
+
+# check_stage <report label> <log pattern>
+LAT_STAGES=0
+check_stage() {
+    local row samples expected
+    row=$(grep "^  $1 " "$REPORT")
+    samples=$(echo "$row" | awk '{print $(NF-5)}')
+    expected=$(grep -c "$2" "$LOG_FILE")
+    echo "$row"
+    if [ -z "$row" ] || [ "${samples:-0}" -eq 0 ]; then
+        echo "FAIL: No samples for $1"
+        exit 1
+    fi
+    if [ "$samples" -ne "$expected" ]; then
+        echo "FAIL: $1 has $samples samples, log has $expected matching lines"
+        exit 1
+    fi
+    if ! echo "$row" | awk '{ if ($(NF-3) > $(NF-2) || $(NF-2) > $(NF-1) || $(NF-1) > $NF) exit 1 }'; then
+        echo "FAIL: $1 percentiles out of order"
+        exit 1
+    fi
+    LAT_STAGES=$((LAT_STAGES + 1))
+}
+
+check_stage "Entry gates" "entered through gate"
+check_stage "Lower station" "in lower station"
+check_stage "Platform gates" "passed through platform gate"
+check_stage "Boarding" "boarded chairlift"
+check_stage "Exit gates" "arrived at upper platform"
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Latency histograms match the log for all $LAT_STAGES stages"
+exit 0
@@ -0,0 +1,160 @@
+#!/bin/bash
+# Test 31: Metrics Exporter
+#
+# Goal: With METRICS_INTERVAL_MS > 0 the metrics exporter rewrites
+# ropeway_metrics.prom (Prometheus text format) while the simulation runs,
+# and its last snapshot holds the same totals as the report.
+#
+# Rationale: The exporter reads counters with plain atomic loads (two passes
+# that must agree) and never takes SEM_STATE, so it cannot slow tourists
+# down. Main stops it after every other worker has exited, so the final
+# snapshot must be consistent and match simulation_report.txt exactly.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, interval=200ms,
+# simulation_time=15s.
+#
+# Expected outcome: Live snapshot with semaphore and queue gauges, final
+# totals equal to the report, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test31_metrics_exporter.conf"
+LOG_FILE="/tmp/ropeway_test31.log"
+LIVE_FILE="/tmp/ropeway_test31_live.prom"
+METRICS_FILE="ropeway_metrics.prom"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 31: Metrics Exporter ==="
+echo "Goal: Verify live metrics snapshots and final totals without taking SEM_STATE"
+echo "Running simulation..."
+
+rm -f "$METRICS_FILE" "$METRICS_FILE.tmp" "$LIVE_FILE"
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Grab a snapshot while the simulation is running
+sleep 5
+if [ -f "$METRICS_FILE" ]; then
+    cp "$METRICS_FILE" "$LIVE_FILE"
+fi
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if [ ! -s "$LIVE_FILE" ]; then
+    echo "FAIL: No metrics file written while the simulation was running"
+    exit 1
+fi
+
+if [ ! -s "$METRICS_FILE" ]; then
+    echo "FAIL: $METRICS_FILE missing after shutdown"
+    exit 1
+fi
+
+if [ -e "$METRICS_FILE.tmp" ]; then
+    echo "FAIL: Temporary metrics file left behind"
+    exit 1
+fi
+
+metric() {
+    awk -v name="$2" '$1 == name { print $2 }' "$1"
+}
+
+LIVE_RUNNING=$(metric "$LIVE_FILE" ropeway_running)
+LIVE_CHAIRS=$(metric "$LIVE_FILE" 'ropeway_semaphore_value{sem="chairs"}')
+LIVE_STATION=$(metric "$LIVE_FILE" 'ropeway_semaphore_value{sem="lower_station"}')
+LIVE_PLATFORM=$(metric "$LIVE_FILE" 'ropeway_queue_depth{queue="platform"}')
+echo "Live snapshot: running=$LIVE_RUNNING chairs=$LIVE_CHAIRS station=$LIVE_STATION platform=$LIVE_PLATFORM"
+
+if [ "$LIVE_RUNNING" != "1" ] || [ -z "$LIVE_CHAIRS" ] || [ -z "$LIVE_STATION" ] || [ -z "$LIVE_PLATFORM" ]; then
+    echo "FAIL: Live snapshot is missing gauges"
+    exit 1
+fi
+
+if [ "$LIVE_STATION" -lt 0 ] || [ "$LIVE_STATION" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Lower station semaphore out of range ($LIVE_STATION)"
+    exit 1
+fi
+
+FINAL_TOURISTS=$(metric "$METRICS_FILE" ropeway_tourists_total)
+FINAL_RIDES=$(metric "$METRICS_FILE" ropeway_rides_total)
+CONSISTENT=$(metric "$METRICS_FILE" ropeway_snapshot_consistent)
+SCRAPES=$(metric "$METRICS_FILE" ropeway_exporter_scrapes_total)
+REPORT_TOURISTS=$(grep "^Total tourists:" simulation_report.txt | awk '{print $3}')
+REPORT_RIDES=$(grep "^Total rides:" simulation_report.txt | awk '{print $3}')
+
+echo "Final snapshot: tourists=$FINAL_TOURISTS rides=$FINAL_RIDES (report: $REPORT_TOURISTS / $REPORT_RIDES)"
+echo "Snapshots written: $SCRAPES"
+
+if [ "${FINAL_RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides exported"
+    exit 1
+fi
+
+if [ "$FINAL_TOURISTS" != "$REPORT_TOURISTS" ] || [ "$FINAL_RIDES" != "$REPORT_RIDES" ]; then
+    echo "FAIL: Final metrics do not match the report"
+    exit 1
+fi
+
+if [ "$CONSISTENT" != "1" ]; then
+    echo "FAIL: Final snapshot not consistent"
+    exit 1
+fi
+
+# 15 s at 200 ms intervals: expect well over 20 snapshots
+if [ "${SCRAPES:-0}" -lt 20 ]; then
+    echo "FAIL: Only $SCRAPES snapshots written"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+rm -f "$LIVE_FILE"
+echo "PASS: Metrics exporter wrote $SCRAPES snapshots, final totals match the report"
+exit 0
@@ -0,0 +1,136 @@
+#!/bin/bash
+# Test 32: Compact Tourist Table
+#
+# Goal: The per-tourist table is sized for TOTAL_TOURISTS but only the
+# pages of tourists that were actually spawned are committed, and the
+# compact 8-byte entries still produce a correct per-tourist report.
+#
+# Rationale: The kernel zero-fills new SysV segments, so the table is no
+# longer cleared at creation; a page is committed when the first tourist
+# writing to it records its entry. Each entry packs ticket, type, VIP flag
+# and kid count into bitfields, so a wrong field width would show up as
+# per-tourist rides that no longer add up to the ride total.
+#
+# Parameters: tourists=4000000 (configured), pool=16, spawn_delay=2ms,
+# simulation_time=15s.
+#
+# Expected outcome: Resident size of the segment far below its size,
+# sum of rides x (1 + kids) over the report equals the total, clean
+# shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test32_compact_tourist_table.conf"
+LOG_FILE="/tmp/ropeway_test32.log"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 32: Compact Tourist Table ==="
+echo "Goal: Verify the tourist table only commits pages for spawned tourists"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Sample the segment while the simulation is running (size and rss in bytes)
+sleep 8
+SHM_LINE=$(awk -v uid="$(id -u)" 'NR > 1 && $8 == uid { print $4, $15 }' /proc/sysvipc/shm 2>/dev/null | sort -n | tail -1)
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if [ -n "$SHM_LINE" ]; then
+    SHM_SIZE=${SHM_LINE% *}
+    SHM_RSS=${SHM_LINE#* }
+    echo "Segment: $SHM_SIZE bytes, $SHM_RSS resident"
+    # 4M entries x 8 bytes = 32 MB reserved; a few hundred tourists touch a few pages
+    if [ "$SHM_SIZE" -lt 32000000 ]; then
+        echo "FAIL: Segment smaller than the configured table ($SHM_SIZE bytes)"
+        exit 1
+    fi
+    if [ "$SHM_RSS" -gt $(( SHM_SIZE / 16 )) ]; then
+        echo "FAIL: Tourist table committed up front ($SHM_RSS of $SHM_SIZE bytes resident)"
+        exit 1
+    fi
+else
+    echo "Note: /proc/sysvipc/shm not available, residency not checked"
+fi
+
+# Sum of per-tourist rides, each counted for the parent and its kids
+REPORT_SUM=$(awk '/^--- Per-Tourist/ { f = 1; next } /^--- Aggregates/ { f = 0 }
+    f && $1 ~ /^[0-9]+$/ {
+        kids = 0
+        if (match($0, /\+[0-9]+ kids/)) kids = substr($0, RSTART + 1, 1)
+        sum += $4 * (1 + kids)
+    } END { print sum + 0 }' simulation_report.txt)
+REPORT_TOTAL=$(grep "^Total rides:" simulation_report.txt | awk '{print $3}')
+ENTRIES=$(awk '/^--- Per-Tourist/ { f = 1; next } /^--- Aggregates/ { f = 0 } f && $1 ~ /^[0-9]+$/' simulation_report.txt | wc -l)
+LOG_TOURISTS=$(grep -c "Sold .* ticket to tourist" "$LOG_FILE")
+
+echo "Report entries: $ENTRIES (tickets sold: $LOG_TOURISTS)"
+echo "Per-tourist rides: $REPORT_SUM (total: $REPORT_TOTAL)"
+
+if [ "${REPORT_TOTAL:-0}" -eq 0 ]; then
+    echo "FAIL: No rides completed"
+    exit 1
+fi
+
+if [ "$REPORT_SUM" -ne "$REPORT_TOTAL" ]; then
+    echo "FAIL: Per-tourist rides do not add up to the total"
+    exit 1
+fi
+
+if [ "$ENTRIES" -ne "$LOG_TOURISTS" ]; then
+    echo "FAIL: Report has $ENTRIES entries for $LOG_TOURISTS tourists"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Compact tourist table recorded $ENTRIES tourists without committing the full table"
+exit 0
@@ -0,0 +1,120 @@
+#!/bin/bash
+# Test 33: Report CSV
+#
+# Goal: With REPORT_FORMAT=1 the per-tourist table is also written to
+# simulation_report.csv, and the streamed text report is still well formed.
+#
+# Rationale: Both files are produced by the same block formatter (hand-rolled
+# integer formatting, writev output) with different row layouts, so every
+# CSV row re-printed with the text layout must match the text report line
+# for line, and the rides must add up to the report total.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, simulation_time=15s.
+#
+# Expected outcome: CSV rows match the text rows, sum of rides x (1 + kids)
+# equals the total, report ends with its closing line, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test33_report_csv.conf"
+LOG_FILE="/tmp/ropeway_test33.log"
+TEXT_ROWS="/tmp/ropeway_test33_text.txt"
+CSV_ROWS="/tmp/ropeway_test33_csv.txt"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 33: Report CSV ==="
+echo "Goal: Verify the streamed text report and the CSV tourist table agree"
+echo "Running simulation..."
+
+rm -f simulation_report.txt simulation_report.csv
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if [ ! -s simulation_report.txt ] || [ ! -s simulation_report.csv ]; then
+    echo "FAIL: Report or CSV file was not written"
+    exit 1
+fi
+
+if [ "$(head -1 simulation_report.csv)" != "id,type,ticket,rides,vip,kids" ]; then
+    echo "FAIL: Unexpected CSV header: $(head -1 simulation_report.csv)"
+    exit 1
+fi
+
+if [ "$(tail -1 simulation_report.txt)" != "=======================================" ]; then
+    echo "FAIL: Text report is truncated"
+    exit 1
+fi
+
+# Per-tourist rows of the text report, and the CSV re-printed in that layout
+sed -n '/^--- Per-Tourist Summary ---$/,/^$/p' simulation_report.txt | tail -n +4 | sed '/^$/d' > "$TEXT_ROWS"
+tail -n +2 simulation_report.csv | awk -F, '{
+        notes = ""
+        if ($5 == 1) notes = "VIP "
+        if ($6 > 0) notes = notes "+" $6 " kids"
+        printf "%-6d %-8s %-10s %-6d %s\n", $1, $2, $3, $4, notes
+    }' > "$CSV_ROWS"
+
+ROWS=$(wc -l < "$TEXT_ROWS")
+echo "Tourist rows: $ROWS (CSV: $(wc -l < "$CSV_ROWS"))"
+if [ "$ROWS" -eq 0 ]; then
+    echo "FAIL: No tourist rows in the report"
+    exit 1
+fi
+
+if ! cmp -s "$TEXT_ROWS" "$CSV_ROWS"; then
+    echo "FAIL: CSV rows differ from the text report:"
+    diff "$TEXT_ROWS" "$CSV_ROWS" | head -5
+    exit 1
+fi
+
+TOTAL_RIDES=$(grep "^Total rides:" simulation_report.txt | awk '{print $3}')
+CSV_RIDES=$(tail -n +2 simulation_report.csv | awk -F, '{ sum += $4 * (1 + $6) } END { print sum + 0 }')
+echo "Total rides: $TOTAL_RIDES (CSV: $CSV_RIDES)"
+if [ "$CSV_RIDES" -ne "$TOTAL_RIDES" ]; then
+    echo "FAIL: CSV rides do not add up to the report total"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+rm -f simulation_report.csv "$TEXT_ROWS" "$CSV_ROWS"
+echo "PASS: $ROWS CSV rows match the text report"
+exit 0
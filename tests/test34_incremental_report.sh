@@ -0,0 +1,161 @@
+#!/bin/bash
+# Test 34: Incremental Report
+#
+# Goal: With REPORT_INCREMENTAL=1 there is no per-tourist table in shared
+# memory; every tourist pushes its final entry onto the completion ring when
+# it leaves, and the report writer appends it to the report as it goes.
+#
+# Rationale: The segment must be sized by the completion ring, not by
+# TOTAL_TOURISTS. Each ticketed tourist pushes exactly once (the entry holds
+# its final ride count), so the report must list every tourist sold a ticket
+# exactly once and the per-tourist rides must still add up to the total.
+#
+# Parameters: tourists=4000000 (configured), pool=16, spawn_delay=2ms,
+# REPORT_FORMAT=1, simulation_time=15s.
+#
+# Expected outcome: Segment far smaller than a 4M-entry table, one report
+# row per ticket sold with unique IDs, rides add up, CSV matches, spool file
+# removed, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test34_incremental_report.conf"
+LOG_FILE="/tmp/ropeway_test34.log"
+STATION_CAPACITY=100
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 34: Incremental Report ==="
+echo "Goal: Verify finished tourists stream to the report writer with no tourist table in shm"
+echo "Running simulation..."
+
+rm -f simulation_report.txt simulation_report.csv simulation_report.rows
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Sample the segment and the spool while the simulation is running
+sleep 8
+SHM_SIZE=$(awk -v uid="$(id -u)" 'NR > 1 && $8 == uid { print $4 }' /proc/sysvipc/shm 2>/dev/null | sort -n | tail -1)
+SPOOL_ROWS=$(wc -l < simulation_report.rows 2>/dev/null || echo 0)
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if [ -n "$SHM_SIZE" ]; then
+    echo "Segment: $SHM_SIZE bytes"
+    # A 4M-entry table alone would be 32 MB
+    if [ "$SHM_SIZE" -gt 4194304 ]; then
+        echo "FAIL: Segment still sized for the tourist table ($SHM_SIZE bytes)"
+        exit 1
+    fi
+else
+    echo "Note: /proc/sysvipc/shm not available, segment size not checked"
+fi
+
+echo "Rows spooled mid-run: $SPOOL_ROWS"
+if [ "$SPOOL_ROWS" -eq 0 ]; then
+    echo "FAIL: Report writer did not append rows while the simulation ran"
+    exit 1
+fi
+
+if [ -e simulation_report.rows ]; then
+    echo "FAIL: Spool file left behind"
+    exit 1
+fi
+
+if [ "$(tail -1 simulation_report.txt)" != "=======================================" ]; then
+    echo "FAIL: Text report is truncated"
+    exit 1
+fi
+
+if grep -q "missing from" "$LOG_FILE"; then
+    echo "FAIL: $(grep "missing from" "$LOG_FILE" | head -1)"
+    exit 1
+fi
+
+ROWS=$(awk '/^--- Per-Tourist/ { f = 1; next } /^--- Aggregates/ { f = 0 } f && $1 ~ /^[0-9]+$/ { print $1 }' simulation_report.txt)
+ENTRIES=$(echo "$ROWS" | grep -c .)
+UNIQUE=$(echo "$ROWS" | sort -u | grep -c .)
+LOG_TOURISTS=$(grep -c "Sold .* ticket to tourist" "$LOG_FILE")
+CSV_ROWS=$(( $(wc -l < simulation_report.csv) - 1 ))
+
+REPORT_SUM=$(awk '/^--- Per-Tourist/ { f = 1; next } /^--- Aggregates/ { f = 0 }
+    f && $1 ~ /^[0-9]+$/ {
+        kids = 0
+        if (match($0, /\+[0-9]+ kids/)) kids = substr($0, RSTART + 1, 1)
+        sum += $4 * (1 + kids)
+    } END { print sum + 0 }' simulation_report.txt)
+REPORT_TOTAL=$(grep "^Total rides:" simulation_report.txt | awk '{print $3}')
+
+echo "Report entries: $ENTRIES ($UNIQUE unique, tickets sold: $LOG_TOURISTS, CSV: $CSV_ROWS)"
+echo "Per-tourist rides: $REPORT_SUM (total: $REPORT_TOTAL)"
+
+if [ "${REPORT_TOTAL:-0}" -eq 0 ]; then
+    echo "FAIL: No rides completed"
+    exit 1
+fi
+
+if [ "$ENTRIES" -ne "$LOG_TOURISTS" ] || [ "$UNIQUE" -ne "$ENTRIES" ]; then
+    echo "FAIL: Report has $ENTRIES entries ($UNIQUE unique) for $LOG_TOURISTS tourists"
+    exit 1
+fi
+
+if [ "$CSV_ROWS" -ne "$ENTRIES" ]; then
+    echo "FAIL: CSV has $CSV_ROWS rows for $ENTRIES report entries"
+    exit 1
+fi
+
+if [ "$REPORT_SUM" -ne "$REPORT_TOTAL" ]; then
+    echo "FAIL: Per-tourist rides do not add up to the total"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+rm -f simulation_report.csv
+echo "PASS: Report writer streamed $ENTRIES tourists with a $SHM_SIZE-byte segment"
+exit 0
@@ -0,0 +1,106 @@
+#!/bin/bash
+# Test 35: Multi-Line
+#
+# Goal: With LINE_COUNT=3 the simulation runs three independent chairlifts
+# (own semaphore set, queues, station counter and worker pair each) behind
+# one cashier and one tourist generator.
+#
+# Rationale: Tourists pick the least-loaded lower station before every
+# ride, so every line must dispatch chairs, and no station may ever hold
+# more than STATION_CAPACITY tourists. Every per-line semaphore set and
+# queue must be removed at shutdown.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, LINE_COUNT=3,
+# STATION_CAPACITY=20 (per line), simulation_time=15s.
+#
+# Expected outcome: Chairs depart on all three lines, ride count matches the
+# dispatched chairs, per-line capacity respected, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test35_multi_line.conf"
+LOG_FILE="/tmp/ropeway_test35.log"
+STATION_CAPACITY=20
+LINE_COUNT=3
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 35: Multi-Line ==="
+echo "Goal: Verify $LINE_COUNT chairlift lines share one cashier and generator"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+# Line 0 keeps the plain tag, the others append their index
+TOTAL_DEPARTED=0
+for LINE in $(seq 0 $((LINE_COUNT - 1))); do
+    if [ "$LINE" -eq 0 ]; then
+        TAG="LOWER_WORKER"
+    else
+        TAG="LOWER_WORKER_${LINE}"
+    fi
+    DEPARTED=$(grep -c "\[${TAG}\] Chair .* departed with" "$LOG_FILE")
+    echo "Line $LINE chairs departed: $DEPARTED"
+    if [ "$DEPARTED" -eq 0 ]; then
+        echo "FAIL: Line $LINE never dispatched a chair"
+        exit 1
+    fi
+    TOTAL_DEPARTED=$((TOTAL_DEPARTED + DEPARTED))
+done
+
+BOARDED=$(grep -c "boarded chairlift" "$LOG_FILE")
+echo "Chairs departed: $TOTAL_DEPARTED, boardings: $BOARDED"
+if [ "$BOARDED" -eq 0 ]; then
+    echo "FAIL: No tourist boarded"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0} (per line)"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $LINE_COUNT lines dispatched $TOTAL_DEPARTED chairs within capacity"
+exit 0
@@ -0,0 +1,116 @@
+#!/bin/bash
+# Test 36: Boarding Workers
+#
+# Goal: With BOARDING_WORKERS=3 the lower worker and two boarding workers pop
+# platform requests concurrently and fill chairs through the line's shared
+# chair assembler.
+#
+# Rationale: Seats are claimed with one CAS on the packed chair state, so a
+# chair can never hold more than CHAIR_CAPACITY slots however the workers
+# interleave, and exactly one worker sends each chair off. A group that
+# does not fit boards the next chair without being requeued, so there is no
+# requeue traffic at all.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, BOARDING_WORKERS=3,
+# simulation_time=15s.
+#
+# Expected outcome: Chairs dispatched by both the lower worker and the
+# boarding workers, never more than 4 slots per chair, every confirmed rider
+# was on a departed chair, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test36_boarding_workers.conf"
+LOG_FILE="/tmp/ropeway_test36.log"
+STATION_CAPACITY=100
+CHAIR_CAPACITY=4
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 36: Boarding Workers ==="
+echo "Goal: Verify concurrent boarding workers assemble chairs without overfilling"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+READY=$(grep -c "Boarding worker ready" "$LOG_FILE")
+BY_LOWER=$(grep -c "\[LOWER_WORKER\] Chair .* departed with" "$LOG_FILE")
+BY_BOARDING=$(grep -c "\[BOARDING_WORKER\] Chair .* departed with" "$LOG_FILE")
+echo "Boarding workers started: $READY"
+echo "Chairs sent by lower worker: $BY_LOWER, by boarding workers: $BY_BOARDING"
+
+if [ "$READY" -ne 2 ]; then
+    echo "FAIL: Expected 2 boarding workers, $READY started"
+    exit 1
+fi
+
+if [ "$BY_LOWER" -eq 0 ] || [ "$BY_BOARDING" -eq 0 ]; then
+    echo "FAIL: Chairs were not assembled by several workers"
+    exit 1
+fi
+
+# Slots per departed chair (from "(N/4 slots)")
+OVERFULL=$(grep -o "departed with [0-9]* tourists ([0-9]*/" "$LOG_FILE" | \
+    sed 's/.*(//; s/\///' | awk -v cap="$CHAIR_CAPACITY" '$1 > cap || $1 < 1' | wc -l)
+if [ "$OVERFULL" -gt 0 ]; then
+    echo "FAIL: $OVERFULL chairs left with an invalid slot count"
+    exit 1
+fi
+
+RIDERS=$(grep -o "departed with [0-9]* tourists" "$LOG_FILE" | awk '{s += $3} END {print s + 0}')
+BOARDED=$(grep -c "boarded chairlift" "$LOG_FILE")
+echo "Riders on departed chairs: $RIDERS, boardings confirmed: $BOARDED"
+if [ "$BOARDED" -eq 0 ] || [ "$BOARDED" -gt "$RIDERS" ]; then
+    echo "FAIL: Confirmed boardings do not match departed chairs"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $((BY_LOWER + BY_BOARDING)) chairs assembled by 3 boarding workers"
+exit 0
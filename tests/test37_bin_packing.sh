@@ -0,0 +1,122 @@
+#!/bin/bash
+# Test 37: Bin-Packing Loader
+#
+# Goal: With BOARDING_WINDOW=8 the lower worker packs chairs from the next
+# 8 platform requests instead of sending a partial chair off and requeueing
+# the group that did not fit.
+#
+# Rationale: FIFO loading sends a chair off 3/4 full whenever a cyclist (2
+# slots) or a family queues behind three walkers. The look-ahead loader
+# seats the largest waiting group that still fits, so the same workload
+# fills more slots per chair. An empty chair always takes the oldest
+# request, so no group is passed over for long.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, STATION_CAPACITY=50,
+# simulation_time=15s, run once with BOARDING_WINDOW=0 and once with 8.
+#
+# Expected outcome: Higher slot utilization in the report with the window,
+# never more than 4 slots per chair, every confirmed rider on a departed
+# chair, clean shutdown after both runs.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test37_bin_packing.conf"
+FIFO_CONFIG="/tmp/ropeway_test37_fifo.conf"
+LOG_FILE="/tmp/ropeway_test37.log"
+FIFO_LOG="/tmp/ropeway_test37_fifo.log"
+STATION_CAPACITY=50
+CHAIR_CAPACITY=4
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 37: Bin-Packing Loader ==="
+echo "Goal: Verify look-ahead chair packing beats FIFO loading with requeues"
+
+# Runs the simulation; prints the report's slot utilization (percent)
+run_sim() {
+    timeout 40 ./ropeway_simulation "$1" > "$2" 2>&1
+    local rc=$?
+    if [ $rc -eq 124 ]; then
+        echo "FAIL: Simulation timed out ($1)" >&2
+        pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+        return 1
+    fi
+    if [ $rc -ne 0 ]; then
+        echo "FAIL: Simulation exited with error code $rc ($1)" >&2
+        return 1
+    fi
+    grep -o "Slot utilization: [0-9.]*" simulation_report.txt | awk '{print $3}'
+}
+
+sed 's/^BOARDING_WINDOW=.*/BOARDING_WINDOW=0/' "$CONFIG" > "$FIFO_CONFIG"
+
+echo "Running FIFO baseline (BOARDING_WINDOW=0)..."
+FIFO_UTIL=$(run_sim "$FIFO_CONFIG" "$FIFO_LOG") || exit 1
+echo "Running look-ahead loader (BOARDING_WINDOW=8)..."
+WINDOW_UTIL=$(run_sim "$CONFIG" "$LOG_FILE") || exit 1
+rm -f "$FIFO_CONFIG"
+
+echo
+echo "Analyzing results..."
+echo "Slot utilization: FIFO ${FIFO_UTIL:-?}%, window ${WINDOW_UTIL:-?}%"
+
+if [ -z "$FIFO_UTIL" ] || [ -z "$WINDOW_UTIL" ]; then
+    echo "FAIL: Report has no chair utilization"
+    exit 1
+fi
+
+if ! awk -v w="$WINDOW_UTIL" -v f="$FIFO_UTIL" 'BEGIN { exit !(w > f) }'; then
+    echo "FAIL: Look-ahead loader did not fill chairs better than FIFO"
+    exit 1
+fi
+
+# Slots per departed chair (from "(N/4 slots)")
+BAD=$(grep -o "departed with [0-9]* tourists ([0-9]*/" "$LOG_FILE" | \
+    sed 's/.*(//; s/\///' | awk -v cap="$CHAIR_CAPACITY" '$1 > cap || $1 < 1' | wc -l)
+if [ "$BAD" -gt 0 ]; then
+    echo "FAIL: $BAD chairs left with an invalid slot count"
+    exit 1
+fi
+
+RIDERS=$(grep -o "departed with [0-9]* tourists" "$LOG_FILE" | awk '{s += $3} END {print s + 0}')
+BOARDED=$(grep -c "boarded chairlift" "$LOG_FILE")
+echo "Riders on departed chairs: $RIDERS, boardings confirmed: $BOARDED"
+if [ "$BOARDED" -eq 0 ] || [ "$BOARDED" -gt "$RIDERS" ]; then
+    echo "FAIL: Confirmed boardings do not match departed chairs"
+    exit 1
+fi
+
+MAX_SEEN=$(grep -o "count: [0-9]*/" "$LOG_FILE" | sed 's/count: //' | sed 's/\///' | sort -n | tail -1)
+echo "Max station count: ${MAX_SEEN:-0}"
+if [ "${MAX_SEEN:-0}" -gt "$STATION_CAPACITY" ]; then
+    echo "FAIL: Capacity exceeded ($MAX_SEEN > $STATION_CAPACITY)"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Look-ahead loader filled ${WINDOW_UTIL}% of chair slots (FIFO ${FIFO_UTIL}%)"
+exit 0
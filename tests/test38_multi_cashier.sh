@@ -0,0 +1,112 @@
+#!/bin/bash
+# Test 38: Multi-Cashier
+#
+# Goal: With CASHIER_COUNT=4 four cashier processes sell tickets, each from
+# its own request/response queue.
+#
+# Rationale: Tourists are sharded by ID (tourist_id % CASHIER_COUNT), so a
+# cashier's queue only ever holds its own tourists' requests and responses
+# and the kernel's mtype scan stays short. Every cashier counts its sales in
+# its own stats shard, so the ticket office never serializes on a lock.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, CASHIER_COUNT=4,
+# simulation_time=15s.
+#
+# Expected outcome: Four cashiers ready, each one sells tickets, every sale
+# is made by the cashier the tourist's ID maps to, no tourist buys twice,
+# clean shutdown with every cashier queue removed.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test38_multi_cashier.conf"
+LOG_FILE="/tmp/ropeway_test38.log"
+CASHIER_COUNT=4
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 38: Multi-Cashier ==="
+echo "Goal: Verify sharded cashiers each serve only their own tourists"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+READY=$(grep -c "Cashier ready to serve tourists" "$LOG_FILE")
+echo "Cashiers ready: $READY"
+if [ "$READY" -ne "$CASHIER_COUNT" ]; then
+    echo "FAIL: Expected $CASHIER_COUNT cashiers, $READY started"
+    exit 1
+fi
+
+# "<cashier> <tourist>" for every sale ([CASHIER] is cashier 0)
+SALES=$(grep -o "\[CASHIER[_0-9]*\] Sold [A-Z0-9_]* \(family \)\?ticket to tourist [0-9]*" "$LOG_FILE" | \
+    awk '{c = $1; gsub(/[^0-9]/, "", c); print (c == "" ? 0 : c), $NF}')
+TOTAL=$(echo "$SALES" | grep -c .)
+echo "Tickets sold: $TOTAL"
+if [ "$TOTAL" -eq 0 ]; then
+    echo "FAIL: No tickets sold"
+    exit 1
+fi
+
+for c in $(seq 0 $((CASHIER_COUNT - 1))); do
+    N=$(echo "$SALES" | awk -v c="$c" '$1 == c' | wc -l)
+    echo "  cashier $c: $N"
+    if [ "$N" -eq 0 ]; then
+        echo "FAIL: Cashier $c sold nothing"
+        exit 1
+    fi
+done
+
+MISROUTED=$(echo "$SALES" | awk -v n="$CASHIER_COUNT" '$2 % n != $1' | wc -l)
+if [ "$MISROUTED" -gt 0 ]; then
+    echo "FAIL: $MISROUTED tickets sold by a cashier the tourist does not map to"
+    exit 1
+fi
+
+DUPLICATES=$(echo "$SALES" | awk '{print $2}' | sort | uniq -d | wc -l)
+if [ "$DUPLICATES" -gt 0 ]; then
+    echo "FAIL: $DUPLICATES tourists bought more than one ticket"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $CASHIER_COUNT cashiers sold $TOTAL tickets, each to its own shard"
+exit 0
@@ -0,0 +1,111 @@
+#!/bin/bash
+# Test 39: Batched Cashier
+#
+# Goal: With CASHIER_BATCH=16 the cashier takes every request already
+# waiting (up to 16) after each blocking receive and serves them together.
+#
+# Rationale: A queue that builds up during a spawn burst is drained with
+# IPC_NOWAIT receives instead of one wakeup per tourist; the sim clock is
+# read once and the statistics are updated once per ticket type per batch.
+# Batching must not lose, duplicate or miscount a sale.
+#
+# Parameters: tourists=300, pool=16, spawn_delay=0, CASHIER_BATCH=16,
+# debug logs on, simulation_time=15s.
+#
+# Expected outcome: At least one batch of more than one request, no batch
+# larger than 16, no tourist buys twice, the report counts exactly the
+# tourists (parents + kids) the cashier logged, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test39_batched_cashier.conf"
+LOG_FILE="/tmp/ropeway_test39.log"
+CASHIER_BATCH=16
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 39: Batched Cashier ==="
+echo "Goal: Verify the cashier serves waiting requests in batches"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+BATCHES=$(grep -o "Serving batch of [0-9]* requests" "$LOG_FILE" | awk '{print $4}')
+BATCH_COUNT=$(echo "$BATCHES" | grep -c .)
+MAX_BATCH=$(echo "$BATCHES" | sort -n | tail -1)
+echo "Batches of more than one request: $BATCH_COUNT (largest: ${MAX_BATCH:-0})"
+if [ "$BATCH_COUNT" -eq 0 ]; then
+    echo "FAIL: Cashier never served more than one request per wakeup"
+    exit 1
+fi
+if [ "$MAX_BATCH" -gt "$CASHIER_BATCH" ]; then
+    echo "FAIL: Batch of $MAX_BATCH exceeds CASHIER_BATCH=$CASHIER_BATCH"
+    exit 1
+fi
+
+SALES=$(grep -o "Sold [A-Z0-9_]* \(family \)\?ticket to tourist [0-9]*.*- valid until" "$LOG_FILE")
+TOTAL=$(echo "$SALES" | grep -c .)
+echo "Tickets sold: $TOTAL"
+if [ "$TOTAL" -eq 0 ]; then
+    echo "FAIL: No tickets sold"
+    exit 1
+fi
+
+DUPLICATES=$(echo "$SALES" | awk '{for (i = 1; i < NF; i++) if ($i == "tourist") print $(i + 1)}' | \
+    sort | uniq -d | wc -l)
+if [ "$DUPLICATES" -gt 0 ]; then
+    echo "FAIL: $DUPLICATES tourists bought more than one ticket"
+    exit 1
+fi
+
+# Parents plus kids, as counted in the statistics
+LOGGED=$(echo "$SALES" | awk '{n = 1; if (match($0, /\+ [0-9]+ kid/)) n += substr($0, RSTART + 2, RLENGTH - 6); s += n} END {print s + 0}')
+REPORTED=$(grep -m1 "^Total tourists:" "${BUILD_DIR}/simulation_report.txt" 2>/dev/null | awk '{print $3}')
+echo "Tourists logged: $LOGGED, reported: ${REPORTED:-missing}"
+if [ "$LOGGED" != "$REPORTED" ]; then
+    echo "FAIL: Report total does not match the tourists sold to"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $TOTAL tickets sold in batches of up to $MAX_BATCH, totals match"
+exit 0
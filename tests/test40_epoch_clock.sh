@@ -0,0 +1,121 @@
+#!/bin/bash
+# Test 40: Epoch Clock
+#
+# Goal: With CLOCK_SOURCE=1 the Time Server publishes only a clock epoch,
+# every process computes the sim time from CLOCK_MONOTONIC, and a
+# SIGTSTP/SIGCONT pause of the whole simulation shifts the epoch.
+#
+# Rationale: Without the 10ms setitimer the Time Server sleeps until a
+# signal arrives, so the clock must still start, advance to closing time
+# and stand still while paused. If the pause were not added to the epoch
+# the sim day would end about 3 real seconds early.
+#
+# Parameters: tourists=60, simulation_time=8s, CLOCK_SOURCE=1, process
+# group stopped for 3s after 2s.
+#
+# Expected outcome: No timer started, pause and resume logged by the Time
+# Server, the run lasts at least duration + pause, sim time reaches the
+# end of the day, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test40_epoch_clock.conf"
+LOG_FILE="/tmp/ropeway_test40.log"
+DURATION=8
+PAUSE=3
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 40: Epoch Clock ==="
+echo "Goal: Verify the epoch clock advances and freezes while paused"
+echo "Running simulation..."
+
+# Job control: the simulation gets its own (non-orphaned) process group
+set -m
+START=$(date +%s.%N)
+./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+set +m
+
+sleep 2
+echo "Pausing process group for ${PAUSE}s..."
+kill -TSTP -- -"$SIM_PID" 2>/dev/null
+sleep "$PAUSE"
+kill -CONT -- -"$SIM_PID" 2>/dev/null
+
+for i in $(seq 1 40); do
+    kill -0 "$SIM_PID" 2>/dev/null || break
+    sleep 0.5
+done
+if kill -0 "$SIM_PID" 2>/dev/null; then
+    echo "FAIL: Simulation timed out"
+    kill -9 -- -"$SIM_PID" 2>/dev/null
+    exit 1
+fi
+wait "$SIM_PID"
+EXIT_CODE=$?
+ELAPSED=$(awk -v s="$START" -v e="$(date +%s.%N)" 'BEGIN {printf "%.1f", e - s}')
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Epoch clock published (no timer)" "$LOG_FILE"; then
+    echo "FAIL: Time Server did not start the epoch clock"
+    exit 1
+fi
+if grep -q "Timer started (10ms interval)" "$LOG_FILE"; then
+    echo "FAIL: Time Server started the 10ms timer"
+    exit 1
+fi
+
+if ! grep -q "\[TIME_SERVER\] Resumed after" "$LOG_FILE"; then
+    echo "FAIL: Time Server did not log the resume"
+    exit 1
+fi
+grep -o "Resumed after [0-9.]* seconds pause" "$LOG_FILE" | head -1
+
+echo "Real run time: ${ELAPSED}s (day ${DURATION}s + pause ${PAUSE}s)"
+if awk -v t="$ELAPSED" -v min="$((DURATION + PAUSE))" 'BEGIN {exit !(t < min - 0.5)}'; then
+    echo "FAIL: Run ended too early, the pause was counted as sim time"
+    exit 1
+fi
+
+LAST_TIME=$(grep -o "^\[[0-9][0-9]:[0-9][0-9]" "$LOG_FILE" | tail -1 | tr -d '[')
+echo "Last logged sim time: $LAST_TIME"
+if [[ "$LAST_TIME" < "16:30" ]]; then
+    echo "FAIL: Sim time did not reach the end of the day"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Epoch clock ran the day in ${ELAPSED}s and froze during the pause"
+exit 0
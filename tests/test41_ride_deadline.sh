@@ -0,0 +1,102 @@
+#!/bin/bash
+# Test 41: Ride Deadline
+#
+# Goal: Every rider of a chair sleeps to the same absolute deadline,
+# departure + travel time, so the chair completes at the upper station
+# one travel time after it left.
+#
+# Rationale: Departures are carried as pause-adjusted CLOCK_MONOTONIC
+# nanoseconds and rides sleep with clock_nanosleep(TIMER_ABSTIME). With
+# whole-second time(NULL) stamps a 37ms ride (2 sim minutes at 54 sim
+# minutes per real second) would round to zero and riders would arrive
+# at once, or up to a second apart.
+#
+# Parameters: tourists=120, simulation_time=10s, CHAIR_TRAVEL_TIME=2 sim
+# minutes, CLOCK_SOURCE=1 (sub-tick log timestamps), debug logs on.
+#
+# Expected outcome: No chair completes before its travel time (120 sim
+# seconds, 1s tolerance); 90% of chairs complete within 6 sim seconds
+# (about 2ms real) of it; clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test41_ride_deadline.conf"
+LOG_FILE="/tmp/ropeway_test41.log"
+TRAVEL_SIM_SECONDS=120
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 41: Ride Deadline ==="
+echo "Goal: Verify chairs arrive exactly one travel time after departure"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+# Sim seconds from "Chair N departed" to the next "Chair N complete"
+RIDES=$(awk 'function sec(s) {gsub(/[\[\]]/, "", s); split(s, a, ":"); return a[1] * 3600 + a[2] * 60 + a[3]}
+    /Chair [0-9]+ departed with/ {for (i = 1; i < NF; i++) if ($i == "Chair") id = $(i + 1); dep[id] = sec($1)}
+    /Chair [0-9]+ complete/ {for (i = 1; i < NF; i++) if ($i == "Chair") id = $(i + 1)
+                             if (id in dep) {print sec($1) - dep[id]; delete dep[id]}}' "$LOG_FILE")
+TOTAL=$(echo "$RIDES" | grep -c .)
+echo "Chairs completed: $TOTAL"
+if [ "$TOTAL" -lt 20 ]; then
+    echo "FAIL: Too few chairs completed to judge ($TOTAL)"
+    exit 1
+fi
+
+EARLY=$(echo "$RIDES" | awk -v t="$TRAVEL_SIM_SECONDS" '$1 < t - 1' | wc -l)
+ON_TIME=$(echo "$RIDES" | awk -v t="$TRAVEL_SIM_SECONDS" '$1 >= t - 1 && $1 <= t + 6' | wc -l)
+echo "Early: $EARLY, within 6 sim seconds of the travel time: $ON_TIME"
+echo "$RIDES" | sort -n | uniq -c | sort -nr | head -3 | awk '{print "  " $1 " chairs at " $2 " sim seconds"}'
+
+if [ "$EARLY" -gt 0 ]; then
+    echo "FAIL: $EARLY chairs arrived before their travel time"
+    exit 1
+fi
+if [ $((ON_TIME * 10)) -lt $((TOTAL * 9)) ]; then
+    echo "FAIL: Fewer than 90% of chairs arrived on their deadline"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $ON_TIME of $TOTAL chairs arrived on their absolute deadline"
+exit 0
@@ -0,0 +1,115 @@
+#!/bin/bash
+# Test 42: Seeded RNG
+#
+# Goal: With RANDOM_SEED set, the generator draws the same tourist
+# attributes (age, type, VIP, kids, ticket) on every run; another seed
+# draws a different sequence.
+#
+# Rationale: The generator fills its attribute batches from a xoshiro256**
+# lane generator seeded from RANDOM_SEED instead of rand() and the clock,
+# so a run can be repeated exactly. The attribute sequence does not depend
+# on timing, only on the seed.
+#
+# Parameters: tourists=200, pool=16, RANDOM_SEED=12345 (twice) and 54321,
+# debug logs on, simulation_time=8s.
+#
+# Expected outcome: The two 12345 runs queue identical tourists, the 54321
+# run differs, ages lie in 8-80, every ticket type is drawn, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test42_seeded_rng.conf"
+OTHER_CONFIG="/tmp/ropeway_test42_other.conf"
+LOG_FILE="/tmp/ropeway_test42.log"
+REPEAT_LOG="/tmp/ropeway_test42_repeat.log"
+OTHER_LOG="/tmp/ropeway_test42_other.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 42: Seeded RNG ==="
+echo "Goal: Verify RANDOM_SEED reproduces the generated tourists"
+
+# Runs the simulation; prints the queued tourists' attributes, one per line
+run_sim() {
+    timeout 40 ./ropeway_simulation "$1" > "$2" 2>&1
+    local rc=$?
+    if [ $rc -eq 124 ]; then
+        echo "FAIL: Simulation timed out ($1)" >&2
+        pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+        return 1
+    fi
+    if [ $rc -ne 0 ]; then
+        echo "FAIL: Simulation exited with error code $rc ($1)" >&2
+        return 1
+    fi
+    grep -o "Queued tourist [0-9]*: .*(pool)" "$2"
+}
+
+sed 's/^RANDOM_SEED=.*/RANDOM_SEED=54321/' "$CONFIG" > "$OTHER_CONFIG"
+
+echo "Running RANDOM_SEED=12345 twice and RANDOM_SEED=54321..."
+FIRST=$(run_sim "$CONFIG" "$LOG_FILE") || exit 1
+REPEAT=$(run_sim "$CONFIG" "$REPEAT_LOG") || exit 1
+OTHER=$(run_sim "$OTHER_CONFIG" "$OTHER_LOG") || exit 1
+rm -f "$OTHER_CONFIG"
+
+echo
+echo "Analyzing results..."
+
+COUNT=$(echo "$FIRST" | grep -c .)
+echo "Tourists queued: $COUNT"
+if [ "$COUNT" -ne 200 ]; then
+    echo "FAIL: Expected 200 queued tourists, got $COUNT"
+    exit 1
+fi
+
+if [ "$FIRST" != "$REPEAT" ]; then
+    echo "FAIL: Same seed produced different tourists"
+    diff <(echo "$FIRST") <(echo "$REPEAT") | head -5
+    exit 1
+fi
+if [ "$FIRST" = "$OTHER" ]; then
+    echo "FAIL: Different seeds produced the same tourists"
+    exit 1
+fi
+
+BAD_AGES=$(echo "$FIRST" | grep -o "age=[0-9]*" | awk -F= '$2 < 8 || $2 > 80' | wc -l)
+if [ "$BAD_AGES" -gt 0 ]; then
+    echo "FAIL: $BAD_AGES ages outside 8-80"
+    exit 1
+fi
+
+TICKET_TYPES=$(echo "$FIRST" | grep -o "ticket=[A-Z0-9_]*" | sort -u | wc -l)
+echo "Distinct ticket types: $TICKET_TYPES"
+if [ "$TICKET_TYPES" -lt 5 ]; then
+    echo "FAIL: Not every ticket type was drawn"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $COUNT tourists reproduced exactly from RANDOM_SEED"
+exit 0
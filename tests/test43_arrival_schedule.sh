@@ -0,0 +1,140 @@
+#!/bin/bash
+# Test 43: Arrival Schedule
+#
+# Goal: With ARRIVAL_SCHEDULE=1 the generator draws every tourist up front
+# and saves the schedule; ARRIVAL_SCHEDULE=2 replays that file exactly, and
+# tourists read their attributes from the schedule by ID.
+#
+# Rationale: Separating generation from spawning makes a run repeatable
+# from a file and leaves a tourist only its ID to receive (one argv string
+# or one integer in the spawn descriptor).
+#
+# Parameters: tourists=150, pool=8, spawn_delay=2ms, ARRIVAL_SCHEDULE=1,
+# then ARRIVAL_SCHEDULE=2 with the event engine and with fork+exec, debug
+# logs on, simulation_time=8s.
+#
+# Expected outcome: The schedule file holds 150 descriptors, the event
+# engine replay queues the same tourists, every ticket sold in the fork+exec
+# replay matches the schedule's age and ticket type, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test43_arrival_schedule.conf"
+EVENTS_CONFIG="/tmp/ropeway_test43_events.conf"
+FORK_CONFIG="/tmp/ropeway_test43_fork.conf"
+LOG_FILE="/tmp/ropeway_test43.log"
+EVENTS_LOG="/tmp/ropeway_test43_events.log"
+FORK_LOG="/tmp/ropeway_test43_fork.log"
+SCHEDULE_FILE="arrival_schedule.bin"
+TOURISTS=150
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 43: Arrival Schedule ==="
+echo "Goal: Verify the arrival schedule is saved, replayed and read by tourists"
+
+# Runs the simulation
+run_sim() {
+    timeout 40 ./ropeway_simulation "$1" > "$2" 2>&1
+    local rc=$?
+    if [ $rc -eq 124 ]; then
+        echo "FAIL: Simulation timed out ($1)"
+        pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+        return 1
+    fi
+    if [ $rc -ne 0 ]; then
+        echo "FAIL: Simulation exited with error code $rc ($1)"
+        return 1
+    fi
+}
+
+sed -e 's/^ARRIVAL_SCHEDULE=.*/ARRIVAL_SCHEDULE=2/' -e 's/^TOURIST_POOL_SIZE=.*/TOURIST_ENGINE=2/' \
+    "$CONFIG" > "$EVENTS_CONFIG"
+sed -e 's/^ARRIVAL_SCHEDULE=.*/ARRIVAL_SCHEDULE=2/' -e 's/^TOURIST_POOL_SIZE=.*/TOURIST_POOL_SIZE=0/' \
+    "$CONFIG" > "$FORK_CONFIG"
+
+rm -f "$SCHEDULE_FILE"
+echo "Running ARRIVAL_SCHEDULE=1 (pool), then replays (event engine, fork+exec)..."
+run_sim "$CONFIG" "$LOG_FILE" || exit 1
+SCHEDULE_SIZE=$(stat -c %s "$SCHEDULE_FILE" 2>/dev/null || echo 0)
+run_sim "$EVENTS_CONFIG" "$EVENTS_LOG" || exit 1
+run_sim "$FORK_CONFIG" "$FORK_LOG" || exit 1
+rm -f "$EVENTS_CONFIG" "$FORK_CONFIG" "$SCHEDULE_FILE"
+
+echo
+echo "Analyzing results..."
+
+# 24-byte header + 16 bytes per descriptor
+EXPECTED_SIZE=$((24 + 16 * TOURISTS))
+echo "Schedule file: $SCHEDULE_SIZE bytes (expected $EXPECTED_SIZE)"
+if [ "$SCHEDULE_SIZE" -ne "$EXPECTED_SIZE" ]; then
+    echo "FAIL: Schedule file has the wrong size"
+    exit 1
+fi
+if ! grep -q "Arrival schedule: $TOURISTS tourists drawn" "$LOG_FILE"; then
+    echo "FAIL: Generator did not draw the schedule up front"
+    exit 1
+fi
+
+GENERATED=$(grep -o "Queued tourist [0-9]*: .*(pool)" "$LOG_FILE")
+REPLAYED=$(grep -o "Queued tourist [0-9]*: .*(pool)" "$EVENTS_LOG")
+COUNT=$(echo "$GENERATED" | grep -c .)
+echo "Tourists queued: $COUNT generated, $(echo "$REPLAYED" | grep -c .) replayed"
+if [ "$COUNT" -ne "$TOURISTS" ]; then
+    echo "FAIL: Expected $TOURISTS queued tourists, got $COUNT"
+    exit 1
+fi
+if [ "$GENERATED" != "$REPLAYED" ]; then
+    echo "FAIL: Replay queued different tourists"
+    diff <(echo "$GENERATED") <(echo "$REPLAYED") | head -5
+    exit 1
+fi
+
+if grep -q "not in the arrival schedule" "$FORK_LOG" "$EVENTS_LOG"; then
+    echo "FAIL: A tourist did not find its descriptor"
+    exit 1
+fi
+
+# Cashier sales in the fork+exec replay: age and ticket as scheduled
+MISMATCHES=$( { echo "$GENERATED"; grep -o "Sold [A-Z0-9_]* .*ticket to tourist [0-9]* ([a-z]*, age [0-9]*" "$FORK_LOG"; } | \
+    awk '/^Queued/ { id = $3; sub(":", "", id); age[id] = $4; sub("age=", "", age[id]); sub(",", "", age[id]);
+                     t = $0; sub(/.*ticket=/, "", t); sub(/ .*/, "", t); ticket[id] = t; next }
+         /^Sold/ { for (i = 1; i < NF; i++) if ($i == "tourist") id = $(i + 1);
+                   a = $NF; t = $2; sub("TIME_", "", t); sold++;
+                   if (age[id] != a || ticket[id] != t) bad++ }
+         END { print (sold + 0) " " (bad + 0) }')
+SOLD=${MISMATCHES% *}
+BAD=${MISMATCHES#* }
+echo "Tickets sold in the fork+exec replay: $SOLD, not as scheduled: $BAD"
+if [ "$SOLD" -eq 0 ] || [ "$BAD" -gt 0 ]; then
+    echo "FAIL: Tourists did not use their scheduled attributes"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $TOURISTS scheduled tourists saved, replayed and sold as scheduled"
+exit 0
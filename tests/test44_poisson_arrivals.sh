@@ -0,0 +1,104 @@
+#!/bin/bash
+# Test 44: Poisson Arrivals
+#
+# Goal: With ARRIVAL_RATE_HH set, tourists arrive as an open-loop Poisson
+# process whose rate follows the per-hour profile of the simulated day.
+#
+# Rationale: Arrival times are drawn on the simulated clock and the
+# generator sleeps to each one as an absolute deadline, so the offered load
+# is set by the profile, not by how fast tourists are spawned. The lunch
+# dip (rate 0) must produce no arrivals at all.
+#
+# Parameters: 08:00-12:00 in 12s, event engine, rates 240/720/0/240
+# tourists per sim hour for hours 8-11, debug logs on.
+#
+# Expected outcome: Arrivals per hour within Poisson tolerance of the
+# profile (about 3 standard deviations), none during the dip, the generator
+# runs out of arrivals at the end of the day, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test44_poisson_arrivals.conf"
+LOG_FILE="/tmp/ropeway_test44.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 44: Poisson Arrivals ==="
+echo "Goal: Verify arrivals follow the per-hour rate profile"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+# Arrivals per simulated hour, from the generator's log timestamps
+count_hour() {
+    grep "Queued tourist" "$LOG_FILE" | grep -c "^\[$1:"
+}
+H08=$(count_hour 08)
+H09=$(count_hour 09)
+H10=$(count_hour 10)
+H11=$(count_hour 11)
+echo "Arrivals per hour: 08=$H08 (240) 09=$H09 (720) 10=$H10 (0) 11=$H11 (240)"
+
+# Expected count +- max(3 sd, 10)
+within() {
+    awk -v n="$1" -v e="$2" 'BEGIN { tol = 3 * sqrt(e); if (tol < 10) tol = 10;
+                                     exit (n >= e - tol && n <= e + tol) ? 0 : 1 }'
+}
+if ! within "$H08" 240 || ! within "$H09" 720 || ! within "$H11" 240; then
+    echo "FAIL: Arrivals do not follow the rate profile"
+    exit 1
+fi
+# An arrival at the end of 09:59 may be logged one tick into 10:00
+if [ "$H10" -gt 2 ]; then
+    echo "FAIL: $H10 arrivals during the zero-rate hour"
+    exit 1
+fi
+
+if ! grep -q "No arrivals left in the rate profile today" "$LOG_FILE"; then
+    echo "FAIL: Generator did not stop at the end of the rate profile"
+    exit 1
+fi
+grep -o "Arrival timing: .*" "$LOG_FILE" | head -1
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $((H08 + H09 + H10 + H11)) Poisson arrivals followed the rate profile"
+exit 0
@@ -0,0 +1,102 @@
+#!/bin/bash
+# Test 45: Max Speed
+#
+# Goal: With MAX_SPEED=1 the Time Server drives a virtual clock that jumps
+# straight to the next pending deadline once every process is blocked, so a
+# long simulated day finishes in a fraction of its nominal real time.
+#
+# Rationale: Sleeps on the time_elapsed_ns() timeline become futex waits on
+# the clock generation and worker polls become virtual alarms. If any
+# sleeper were missed the day would stall (timeout); if the clock skipped
+# ahead of a deadline the arrival process would lose tourists.
+#
+# Parameters: 08:00-12:00 nominally in 300s, event engine, Poisson
+# arrivals at 240 tourists per sim hour, MAX_SPEED=1, debug logs on.
+#
+# Expected outcome: Run ends within 60 real seconds, arrivals within Poisson
+# tolerance of 960, rides happen, the clock reports its advances, clean
+# shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test45_max_speed.conf"
+LOG_FILE="/tmp/ropeway_test45.log"
+NOMINAL=300
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 45: Max Speed ==="
+echo "Goal: Verify the virtual clock runs a ${NOMINAL}s day far faster than real time"
+echo "Running simulation..."
+
+START=$(date +%s)
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+ELAPSED=$(( $(date +%s) - START ))
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out (virtual clock stalled?)"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Time Server ready (max speed, virtual clock)" "$LOG_FILE"; then
+    echo "FAIL: Time Server did not start the virtual clock"
+    exit 1
+fi
+grep -o "Virtual clock: .*" "$LOG_FILE" | head -1
+if grep -q "Virtual clock stalled" "$LOG_FILE"; then
+    echo "FAIL: $(grep -o "Virtual clock stalled.*" "$LOG_FILE" | head -1)"
+    exit 1
+fi
+echo "Real run time: ${ELAPSED}s (nominal ${NOMINAL}s)"
+
+ARRIVALS=$(grep -c "Queued tourist" "$LOG_FILE")
+echo "Arrivals: $ARRIVALS (expected about 960)"
+if ! awk -v n="$ARRIVALS" 'BEGIN { tol = 3 * sqrt(960); exit (n >= 960 - tol && n <= 960 + tol) ? 0 : 1 }'; then
+    echo "FAIL: Arrivals do not match the rate (deadlines skipped?)"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides on the virtual clock"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: ${NOMINAL}s simulated day ran in ${ELAPSED}s on the virtual clock"
+exit 0
@@ -0,0 +1,114 @@
+#!/bin/bash
+# Test 46: Parameter Sweep
+#
+# Goal: --sweep runs the simulation once per combination of values while
+# main keeps the IPC objects alive, and writes one aggregated report.
+#
+# Rationale: Between runs the queues are drained, the semaphores reset with
+# SETALL and the shared state re-initialized instead of recreated. A stale
+# message, semaphore value or counter from one run would show up in the
+# next (wrong totals, stuck tourists); a straggler that had to be killed
+# means a run did not shut down on its own.
+#
+# Parameters: 120 tourists per run, event engine, 4s per run,
+# STATION_CAPACITY=5,20,80 x VIP_PERCENTAGE=0,20 (6 runs), debug logs on.
+#
+# Expected outcome: Six report rows in sweep order with tourists and rides
+# in every run, one shared memory segment created and five resets, no
+# process killed after shutdown, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test46_sweep.conf"
+LOG_FILE="/tmp/ropeway_test46.log"
+REPORT="sweep_report.txt"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 46: Parameter Sweep ==="
+echo "Goal: Verify sweep runs reuse the IPC resources and aggregate results"
+echo "Running simulation..."
+
+rm -f "$REPORT"
+timeout 90 ./ropeway_simulation "$CONFIG" --sweep STATION_CAPACITY=5,20,80 \
+    --sweep VIP_PERCENTAGE=0,20 > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Sweep timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Sweep exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if [ ! -f "$REPORT" ]; then
+    echo "FAIL: $REPORT not written"
+    exit 1
+fi
+cat "$REPORT"
+
+# Data rows: run number, STATION_CAPACITY, VIP_PERCENTAGE, tourists, rides, ...
+ROWS=$(awk '$1 ~ /^[0-9]+$/ && NF >= 10' "$REPORT" | wc -l)
+if [ "$ROWS" -ne 6 ]; then
+    echo "FAIL: Expected 6 sweep rows, found $ROWS"
+    exit 1
+fi
+ORDER=$(awk '$1 ~ /^[0-9]+$/ && NF >= 10 { printf "%s/%s ", $2, $3 }' "$REPORT")
+if [ "$ORDER" != "5/0 5/20 20/0 20/20 80/0 80/20 " ]; then
+    echo "FAIL: Runs not in sweep order: $ORDER"
+    exit 1
+fi
+EMPTY=$(awk '$1 ~ /^[0-9]+$/ && NF >= 10 && ($4 == 0 || $5 == 0)' "$REPORT" | wc -l)
+if [ "$EMPTY" -gt 0 ]; then
+    echo "FAIL: $EMPTY runs without tourists or rides"
+    exit 1
+fi
+
+CREATED=$(grep -c "Created shared memory" "$LOG_FILE")
+RESETS=$(grep -c "IPC resources reset" "$LOG_FILE")
+echo "Shared memory segments created: $CREATED, resets: $RESETS"
+if [ "$CREATED" -ne 1 ] || [ "$RESETS" -ne 5 ]; then
+    echo "FAIL: Runs did not share one set of IPC resources"
+    exit 1
+fi
+
+if grep -q "after shutdown, killed" "$LOG_FILE"; then
+    echo "FAIL: A run left processes that had to be killed"
+    grep "after shutdown, killed" "$LOG_FILE" | head -3
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $ROWS sweep runs shared one set of IPC resources"
+exit 0
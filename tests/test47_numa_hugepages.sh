@@ -0,0 +1,115 @@
+#!/bin/bash
+# Test 47: Huge Pages and NUMA Placement
+#
+# Goal: SHM_HUGE_PAGES and NUMA_LINES either take effect or fall back to the
+# default behaviour with a warning, and the simulation runs the same either way.
+#
+# Rationale: Huge pages need a reserved pool (or transparent huge pages for
+# shmem) and NUMA placement needs a kernel with NUMA support. A machine
+# without them must still get a working segment, and each line worker must
+# bind to its line's node (node 0 on a single-node machine).
+#
+# Parameters: 120 tourists, 2 lines, shm rings, thread engine, 4s,
+# NUMA_LINES=1; one run with SHM_HUGE_PAGES=1 and one with SHM_HUGE_PAGES=2,
+# debug logs on.
+#
+# Expected outcome: Both runs finish with rides. The first reports hugetlb
+# pages or logs the fallback; the second reports transparent huge pages.
+# Both lines are placed and all four line workers bound, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test47_numa_hugepages.conf"
+THP_CONFIG="/tmp/ropeway_test47_thp.conf"
+LOG_FILE="/tmp/ropeway_test47.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 47: Huge Pages and NUMA Placement ==="
+echo "Goal: Verify huge page and NUMA options work or fall back cleanly"
+
+sed 's/^SHM_HUGE_PAGES=1/SHM_HUGE_PAGES=2/' "$CONFIG" > "$THP_CONFIG"
+
+for MODE in 1 2; do
+    RUN_CONFIG="$CONFIG"
+    [ "$MODE" -eq 2 ] && RUN_CONFIG="$THP_CONFIG"
+    echo
+    echo "Running simulation (SHM_HUGE_PAGES=$MODE)..."
+    rm -f simulation_report.txt
+    timeout 60 ./ropeway_simulation "$RUN_CONFIG" > "$LOG_FILE" 2>&1
+    EXIT_CODE=$?
+
+    if [ $EXIT_CODE -eq 124 ]; then
+        echo "FAIL: Simulation timed out"
+        pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+        exit 1
+    fi
+    if [ $EXIT_CODE -ne 0 ]; then
+        echo "FAIL: Simulation exited with error code $EXIT_CODE"
+        exit 1
+    fi
+
+    PAGES=$(grep -o "Page size: .*" simulation_report.txt 2>/dev/null)
+    echo "$PAGES"
+    if [ "$MODE" -eq 1 ]; then
+        if ! echo "$PAGES" | grep -q "hugetlb" && ! grep -q "Huge pages unavailable" "$LOG_FILE"; then
+            echo "FAIL: Neither hugetlb pages nor a fallback warning"
+            exit 1
+        fi
+        grep -o "Huge pages unavailable.*" "$LOG_FILE" | head -1
+    elif ! echo "$PAGES" | grep -q "transparent huge pages advised"; then
+        echo "FAIL: Transparent huge pages not reported"
+        exit 1
+    fi
+
+    RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+    echo "Total rides: ${RIDES:-0}"
+    if [ "${RIDES:-0}" -eq 0 ]; then
+        echo "FAIL: No rides recorded"
+        exit 1
+    fi
+
+    if grep -q "NUMA placement unavailable" "$LOG_FILE"; then
+        echo "NUMA placement not supported by this kernel (fallback)"
+    else
+        if ! grep -q "NUMA placement: 2 line(s)" "$LOG_FILE"; then
+            echo "FAIL: Line regions not placed"
+            exit 1
+        fi
+        BOUND=$(grep -c "Bound to NUMA node" "$LOG_FILE")
+        echo "Line workers bound: $BOUND"
+        if [ "$BOUND" -ne 4 ]; then
+            echo "FAIL: Expected 4 line workers bound to their node, found $BOUND"
+            exit 1
+        fi
+    fi
+done
+rm -f "$THP_CONFIG"
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Huge page and NUMA options ran with placement or a clean fallback"
+exit 0
@@ -0,0 +1,135 @@
+#!/bin/bash
+# Test 48: CPU Isolation
+#
+# Goal: WORKER_CPUS pins the time server, cashier and line workers to the
+# reserved core, WORKER_SCHED_FIFO raises the time server and lower worker,
+# and tourists run on the remaining cores.
+#
+# Rationale: The fixed workers are on the critical path of every chair. A
+# worker that was not pinned, or a tourist that can still run on the
+# reserved core, would bring back the contention the option removes. A
+# refused SCHED_FIFO (no CAP_SYS_NICE) must only cost a warning.
+#
+# Parameters: 120 tourists, process engine, 4s, WORKER_CPUS=1,
+# WORKER_SCHED_FIFO=10, debug logs on.
+#
+# Expected outcome: Four workers pinned, two SCHED_FIFO switches (or
+# warnings), rides > 0. With more than one core, a running tourist's
+# affinity excludes the reserved core. Clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test48_cpu_isolation.conf"
+LOG_FILE="/tmp/ropeway_test48.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 48: CPU Isolation ==="
+echo "Goal: Verify fixed workers get a dedicated core and tourists the rest"
+echo "Running simulation..."
+
+# The reserved core is the first one this shell may use
+RESERVED=$(awk '/^Cpus_allowed_list/ { split($2, a, /[-,]/); print a[1] }' /proc/self/status)
+NCPU=$(nproc)
+
+rm -f simulation_report.txt
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Sample one tourist's affinity while the day runs
+TOURIST_CPUS=""
+for _ in $(seq 1 40); do
+    sleep 0.1
+    TPID=$(pgrep -x tourist | head -1)
+    if [ -n "$TPID" ]; then
+        TOURIST_CPUS=$(awk '/^Cpus_allowed_list/ { print $2 }' "/proc/$TPID/status" 2>/dev/null)
+        [ -n "$TOURIST_CPUS" ] && break
+    fi
+done
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+PINNED=$(grep -c "pinned to CPU $RESERVED" "$LOG_FILE")
+echo "Workers pinned to CPU $RESERVED: $PINNED"
+if [ "$PINNED" -ne 4 ]; then
+    echo "FAIL: Expected TimeServer, Cashier, LowerWorker and UpperWorker pinned"
+    grep -E "pinned|cannot pin" "$LOG_FILE" | head -5
+    exit 1
+fi
+
+FIFO=$(grep -cE "running SCHED_FIFO priority 10|SCHED_FIFO 10 refused" "$LOG_FILE")
+echo "SCHED_FIFO switches (or refusals): $FIFO"
+if [ "$FIFO" -ne 2 ]; then
+    echo "FAIL: Expected the TimeServer and LowerWorker to request SCHED_FIFO"
+    exit 1
+fi
+if ! grep -q "TimeServer running SCHED_FIFO" "$LOG_FILE"; then
+    echo "SCHED_FIFO not permitted here (warning only)"
+fi
+
+echo "Tourist CPUs: ${TOURIST_CPUS:-not sampled} (of $NCPU)"
+if [ "$NCPU" -gt 1 ] && [ -n "$TOURIST_CPUS" ]; then
+    ON_RESERVED=$(echo "$TOURIST_CPUS" | awk -v cpu="$RESERVED" -F, '{
+        for (i = 1; i <= NF; i++) {
+            n = split($i, r, "-"); lo = r[1]; hi = (n > 1) ? r[2] : r[1]
+            if (cpu >= lo && cpu <= hi) found = 1
+        }
+        print found ? 1 : 0 }')
+    if [ "$ON_RESERVED" -ne 0 ]; then
+        echo "FAIL: Tourist may run on the reserved CPU $RESERVED"
+        exit 1
+    fi
+elif [ "$NCPU" -eq 1 ] && ! grep -q "tourists share them" "$LOG_FILE"; then
+    echo "FAIL: Single core without the shared-core warning"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Fixed workers pinned to CPU $RESERVED with $RIDES rides"
+exit 0
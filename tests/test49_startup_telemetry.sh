@@ -0,0 +1,115 @@
+#!/bin/bash
+# Test 49: Startup Telemetry
+#
+# Goal: The report breaks startup into stages (config, stale cleanup, IPC
+# create, fork, ready barrier) and lists the fork-to-ready time of every
+# fixed worker.
+#
+# Rationale: Each worker claims a ready slot just before it posts the
+# barrier. A worker missing from the list, an unnamed PID or one without a
+# fork timestamp means a slot was lost or written by the wrong process.
+#
+# Parameters: 120 tourists, 2 lines, 2 cashiers, 2 boarding workers per
+# line, shm rings, thread engine, 4s, debug logs on.
+#
+# Expected outcome: Five stage rows, nine distinct named workers with a
+# ready time, ready barrier well below WORKER_READY_TIMEOUT_MS, rides > 0,
+# clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test49_startup_telemetry.conf"
+LOG_FILE="/tmp/ropeway_test49.log"
+REPORT="simulation_report.txt"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 49: Startup Telemetry ==="
+echo "Goal: Verify startup stages and per-worker ready times are reported"
+echo "Running simulation..."
+
+rm -f "$REPORT"
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+SECTION=$(sed -n '/--- Startup (real ms) ---/,/--- Resources ---/p' "$REPORT")
+if [ -z "$SECTION" ]; then
+    echo "FAIL: No startup section in the report"
+    exit 1
+fi
+echo "$SECTION"
+
+STAGES=$(echo "$SECTION" | grep -cE "^  (Config|Stale cleanup|IPC create|Fork|Ready barrier): +[0-9]+\.[0-9]+$")
+if [ "$STAGES" -ne 5 ]; then
+    echo "FAIL: Expected 5 startup stages, found $STAGES"
+    exit 1
+fi
+
+WORKERS=$(echo "$SECTION" | awk '/Worker fork to ready/ { on = 1; next } on && NF == 2 && $2 ~ /^[0-9]+\.[0-9]+$/ { print $1 }')
+COUNT=$(echo "$WORKERS" | grep -c .)
+DISTINCT=$(echo "$WORKERS" | sort -u | grep -c .)
+echo "Workers with a ready time: $COUNT ($DISTINCT distinct)"
+if [ "$COUNT" -ne 9 ] || [ "$DISTINCT" -ne 9 ] || echo "$WORKERS" | grep -q "^?$"; then
+    echo "FAIL: Expected 9 distinct named workers"
+    exit 1
+fi
+
+BARRIER=$(echo "$SECTION" | awk '/Ready barrier:/ { print $3 }')
+if awk -v b="$BARRIER" 'BEGIN { exit !(b >= 10000) }'; then
+    echo "FAIL: Ready barrier took $BARRIER ms"
+    exit 1
+fi
+
+if ! grep -q "\[MAIN\] Startup: config" "$LOG_FILE"; then
+    echo "FAIL: Startup summary not logged"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" "$REPORT" 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $COUNT workers ready after a $BARRIER ms barrier"
+exit 0
@@ -0,0 +1,131 @@
+#!/bin/bash
+# Test 50: Config Block
+#
+# Goal: Every child maps the first page of the segment (SharedState.cfg)
+# read-only, while main keeps it writable for ipc_reset().
+#
+# Rationale: The config block replaces the per-field copies in SharedState,
+# so every process reads its settings from that one page. It is written once
+# per run by main; a child that could write it would change the settings for
+# everyone mid-run. The seal is per mapping, so both forked workers and
+# exec'd tourists (ipc_attach) must apply it themselves.
+#
+# Parameters: 120 tourists, process engine, 4s, debug logs on.
+#
+# Expected outcome: The first SysV page is r--s in a worker and a tourist
+# and rw-s in main, the report shows the block as read-only in children,
+# rides > 0, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test50_config_block.conf"
+LOG_FILE="/tmp/ropeway_test50.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 50: Config Block ==="
+echo "Goal: Verify the shared config page is read-only in every child"
+echo "Running simulation..."
+
+# Permissions and size of the mapping at offset 0 of the SysV segment
+first_page() {
+    local range perms
+    read -r range perms < <(awk '/SYSV/ && $3 == "00000000" { print $1, $2; exit }' \
+                                 "/proc/$1/maps" 2>/dev/null)
+    [ -n "$range" ] && echo "$perms $(( 16#${range#*-} - 16#${range%-*} ))"
+}
+
+rm -f simulation_report.txt
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Sample main, one forked worker and one tourist while the day runs
+MAIN_MAP=""
+WORKER_MAP=""
+TOURIST_MAP=""
+for _ in $(seq 1 40); do
+    sleep 0.1
+    MAIN=$(pgrep -P "$SIM_PID" -x ropeway_simulat | head -1)
+    [ -z "$MAIN" ] && continue
+    [ -z "$MAIN_MAP" ] && MAIN_MAP=$(first_page "$MAIN")
+    WPID=$(pgrep -P "$MAIN" -x ropeway_simulat | head -1)
+    [ -n "$WPID" ] && [ -z "$WORKER_MAP" ] && WORKER_MAP=$(first_page "$WPID")
+    TPID=$(pgrep -x tourist | head -1)
+    [ -n "$TPID" ] && [ -z "$TOURIST_MAP" ] && TOURIST_MAP=$(first_page "$TPID")
+    [ -n "$MAIN_MAP" ] && [ -n "$WORKER_MAP" ] && [ -n "$TOURIST_MAP" ] && break
+done
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+echo "First page - main: ${MAIN_MAP:-not sampled}, worker: ${WORKER_MAP:-not sampled}, tourist: ${TOURIST_MAP:-not sampled}"
+if [ "${WORKER_MAP}" != "r--s 4096" ] || [ "${TOURIST_MAP}" != "r--s 4096" ]; then
+    echo "FAIL: Expected a read-only 4096-byte config page in the worker and the tourist"
+    exit 1
+fi
+case "$MAIN_MAP" in
+    rw-s*) ;;
+    *) echo "FAIL: Main must keep the config page writable"; exit 1 ;;
+esac
+
+if grep -q "Cannot seal the config block" "$LOG_FILE"; then
+    echo "FAIL: Sealing the config block failed"
+    grep "Cannot seal" "$LOG_FILE" | head -3
+    exit 1
+fi
+
+BLOCK=$(grep -o "Config block: .*" simulation_report.txt 2>/dev/null)
+echo "Report: ${BLOCK:-missing}"
+if ! echo "$BLOCK" | grep -q "read-only in children"; then
+    echo "FAIL: Report does not show the sealed config block"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Config block read-only in children with $RIDES rides"
+exit 0
@@ -0,0 +1,101 @@
+#!/bin/bash
+# Test 51: Emergency Stop via the Futex Epoch
+#
+# Goal: With EMERGENCY_BACKEND=1 a danger stop and its resume go through
+# LineState.emergency_epoch only: no SIGUSR1/SIGUSR2, no emergency lock and
+# no MQ_WORKER handshake.
+#
+# Rationale: The signals protocol costs two signal deliveries and two
+# message round trips per stop. The futex backend replaces them with one
+# CAS to stop and one increment plus wake to resume; the other worker sees
+# the stop from the control word on its next loop pass. A lost wake-up would
+# leave tourists parked until the shutdown, so the day must keep riding
+# after every resume.
+#
+# Parameters: 40 tourists, 5s, DANGER_PROBABILITY=20 with 5 sim minutes of
+# danger, debug logs on.
+#
+# Expected outcome: At least one epoch stop and resume, no signals-protocol
+# log lines, rides > 0, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test51_emergency_futex.conf"
+LOG_FILE="/tmp/ropeway_test51.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 51: Emergency Stop via the Futex Epoch ==="
+echo "Goal: Verify emergency stop/resume without signals or the MQ handshake"
+echo "Running simulation..."
+
+rm -f simulation_report.txt
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+STOPS=$(grep -c "Stopped the line (emergency epoch)" "$LOG_FILE")
+RESUMES=$(grep -c "Chairlift resumed" "$LOG_FILE")
+echo "Epoch stops: $STOPS, resumes logged: $RESUMES"
+if [ "$STOPS" -eq 0 ]; then
+    echo "FAIL: No emergency stop through the epoch"
+    exit 1
+fi
+if [ "$RESUMES" -eq 0 ]; then
+    echo "FAIL: The line never resumed"
+    exit 1
+fi
+
+if grep -qE "Acquired emergency lock|Waiting for resume message|Released emergency lock|SIGUSR2" "$LOG_FILE"; then
+    echo "FAIL: Signals protocol used with EMERGENCY_BACKEND=1"
+    grep -E "Acquired emergency lock|Waiting for resume message|Released emergency lock|SIGUSR2" "$LOG_FILE" | head -3
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $STOPS emergency stop(s) through the futex epoch with $RIDES rides"
+exit 0
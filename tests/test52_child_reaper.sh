@@ -0,0 +1,112 @@
+#!/bin/bash
+# Test 52: Child Reaper
+#
+# Goal: The generator reaps every tourist through its signalfd/epoll reaper
+# and the report accounts for each one's exit status and lifetime.
+#
+# Rationale: SIGCHLD is read from a signalfd and each wakeup drains all
+# exited children with waitid(WNOHANG), so coalesced signals must never
+# leave a zombie behind. A burst of short-lived tourists makes several exit
+# per wakeup. The fork time and tourist ID come from a PID-indexed table
+# filled after fork(); a child that exits before that must still be counted.
+#
+# Parameters: 300 fork+exec tourists, no spawn delay, 4s, debug logs on.
+#
+# Expected outcome: Reaped count equals tourists spawned, one debug line per
+# reaped child, wakeups no more than children, a lifetime sample for
+# (nearly) every child, rides > 0, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test52_child_reaper.conf"
+LOG_FILE="/tmp/ropeway_test52.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 52: Child Reaper ==="
+echo "Goal: Verify exit status and lifetime accounting for every tourist process"
+echo "Running simulation..."
+
+rm -f simulation_report.txt
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+SPAWNED=$(grep -o "spawned [0-9]* tourists" "$LOG_FILE" | grep -o "[0-9]*" | tail -1)
+read -r REAPED OK FAILED KILLED < <(sed -n 's/.*Reaped: \([0-9]*\) (exit 0: \([0-9]*\), exit != 0: \([0-9]*\), killed: \([0-9]*\)).*/\1 \2 \3 \4/p' simulation_report.txt 2>/dev/null)
+read -r WAKEUPS MAX_BATCH < <(sed -n 's/.*Reaper wakeups: \([0-9]*\) .*max \([0-9]*\)).*/\1 \2/p' simulation_report.txt 2>/dev/null)
+SAMPLES=$(sed -n 's/.*Lifetime (real ms): .*(\([0-9]*\) samples).*/\1/p' simulation_report.txt 2>/dev/null)
+LINES=$(grep -c "Reaped tourist [0-9]* (PID" "$LOG_FILE")
+
+echo "Spawned: ${SPAWNED:-?}, reaped: ${REAPED:-?} (exit 0: ${OK:-?}, exit != 0: ${FAILED:-?}, killed: ${KILLED:-?})"
+echo "Wakeups: ${WAKEUPS:-?} (max batch ${MAX_BATCH:-?}), lifetime samples: ${SAMPLES:-?}, debug lines: $LINES"
+
+if [ -z "$SPAWNED" ] || [ -z "$REAPED" ] || [ -z "$WAKEUPS" ] || [ -z "$SAMPLES" ]; then
+    echo "FAIL: Missing generator summary or Tourist Processes section"
+    exit 1
+fi
+if [ "$SPAWNED" -eq 0 ] || [ "$REAPED" -ne "$SPAWNED" ]; then
+    echo "FAIL: Reaped count does not match tourists spawned"
+    exit 1
+fi
+if [ $((OK + FAILED + KILLED)) -ne "$REAPED" ] || [ "$LINES" -ne "$REAPED" ]; then
+    echo "FAIL: Exit statuses do not add up to the reaped count"
+    exit 1
+fi
+if [ "$WAKEUPS" -eq 0 ] || [ "$WAKEUPS" -gt "$REAPED" ]; then
+    echo "FAIL: Reaper wakeups out of range"
+    exit 1
+fi
+# A child that exits before the generator records its fork time has no sample
+if [ "$SAMPLES" -gt "$REAPED" ] || [ $((SAMPLES * 100)) -lt $((REAPED * 95)) ]; then
+    echo "FAIL: Lifetime samples missing for more than 5% of the children"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $REAPED tourists reaped in $WAKEUPS wakeups with $SAMPLES lifetimes"
+exit 0
@@ -0,0 +1,117 @@
+#!/bin/bash
+# Test 53: Chair Ring
+#
+# Goal: With CHAIR_INTERVAL_SIM_SECONDS > 0 a chair leaves the lower platform
+# on every interval, full or empty, and chair IDs follow the ring.
+#
+# Rationale: Cadence departures replace "leave when full" with a moving
+# rope: the p-th departure is ring position p % TOTAL_CHAIRS, and no
+# SEM_CHAIRS slot is taken because the spacing already bounds the chairs
+# going up. Over a whole day the departure count is fixed by the interval,
+# so a worker that stalls or departs early shows up as a wrong count.
+#
+# Parameters: 200 tourists, 5s, one chair every 10 sim seconds, 1 minute
+# ride, debug logs on.
+#
+# Expected outcome: Departures within 2% of the day length over the interval,
+# empty chairs counted and logged, every loaded chair's ID matches its ring
+# departure number, no SEM_CHAIRS logging, rides > 0, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test53_chair_ring.conf"
+LOG_FILE="/tmp/ropeway_test53.log"
+INTERVAL=10
+DAY_SECONDS=$(( (17 - 8) * 3600 ))
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 53: Chair Ring ==="
+echo "Goal: Verify cadence departures around the chair ring"
+echo "Running simulation..."
+
+rm -f simulation_report.txt
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+read -r DEPARTURES EMPTY < <(sed -n 's/.*Ring line 1: \([0-9]*\) departures, \([0-9]*\) empty.*/\1 \2/p' simulation_report.txt 2>/dev/null)
+EXPECTED=$(( DAY_SECONDS / INTERVAL ))
+EMPTY_LINES=$(grep -c "departed empty" "$LOG_FILE")
+echo "Ring departures: ${DEPARTURES:-?} (expected ~$EXPECTED), empty: ${EMPTY:-?}, logged empty: $EMPTY_LINES"
+
+if [ -z "$DEPARTURES" ]; then
+    echo "FAIL: Chair ring missing from the report"
+    exit 1
+fi
+if [ $((DEPARTURES * 100)) -lt $((EXPECTED * 98)) ] || [ $((DEPARTURES * 100)) -gt $((EXPECTED * 102)) ]; then
+    echo "FAIL: Departure count does not match the cadence"
+    exit 1
+fi
+if [ "${EMPTY:-0}" -eq 0 ] || [ "$EMPTY_LINES" -ne "$EMPTY" ]; then
+    echo "FAIL: Empty departures not counted or not logged"
+    exit 1
+fi
+
+# Loaded chairs: "Chair N departed ... [ring departure K]" with N = (K - 1) % 72 + 1
+MISMATCH=$(sed -n 's/.*Chair \([0-9]*\) departed with .*\[ring departure \([0-9]*\)\].*/\1 \2/p' "$LOG_FILE" |
+           awk '$1 != ($2 - 1) % 72 + 1 { bad++ } END { print bad + 0 }')
+LOADED=$(grep -c "ring departure" "$LOG_FILE")
+echo "Loaded departures: $LOADED, chair ID mismatches: $MISMATCH"
+if [ "$LOADED" -eq 0 ] || [ "$MISMATCH" -ne 0 ]; then
+    echo "FAIL: Loaded chairs do not follow the ring"
+    exit 1
+fi
+
+if grep -q "chairs available" "$LOG_FILE"; then
+    echo "FAIL: SEM_CHAIRS used in cadence mode"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $DEPARTURES cadence departures ($EMPTY empty) with $RIDES rides"
+exit 0
@@ -0,0 +1,141 @@
+#!/bin/bash
+# Test 54: Checkpoint
+#
+# Goal: A run writes a checkpoint every CHECKPOINT_INTERVAL_SIM_MINUTES and
+# --restore continues the day from the last one.
+#
+# Rationale: Main copies the state and a forked writer writes the file
+# (temporary file, fsync, rename), so every due checkpoint must land and no
+# temporary file may be left. A restored run takes its clock, generator
+# position and counters from the file: it starts at the checkpoint's sim
+# time, spawns from the next tourist ID and only runs the rest of the day.
+#
+# Parameters: 400 tourists spread over the day, 6s, checkpoint every 60 sim
+# minutes, debug logs on.
+#
+# Expected outcome: 8 checkpoints written (09:00-16:00), none failed, the
+# file matches the reported size. The restore starts at 16:00, spawns from
+# the next ID first, finishes in well under the full run time, records
+# rides, clean shutdown after both runs.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test54_checkpoint.conf"
+LOG_FILE="/tmp/ropeway_test54.log"
+RESTORE_LOG="/tmp/ropeway_test54_restore.log"
+CHECKPOINT="simulation_checkpoint.bin"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 54: Checkpoint ==="
+echo "Goal: Verify periodic checkpoints and restoring the last one"
+echo "Running simulation..."
+
+rm -f simulation_report.txt "$CHECKPOINT" "$CHECKPOINT.tmp"
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+read -r WRITTEN TAKEN FAILED < <(sed -n 's/.*Written: \([0-9]*\) of \([0-9]*\) taken .*failed: \([0-9]*\),.*/\1 \2 \3/p' simulation_report.txt 2>/dev/null)
+read -r LAST BYTES < <(sed -n 's/.*Last: \([0-9:]*\), \([0-9]*\) bytes.*/\1 \2/p' simulation_report.txt 2>/dev/null)
+SIZE=$(stat -c %s "$CHECKPOINT" 2>/dev/null)
+
+echo "Checkpoints: ${WRITTEN:-?} written of ${TAKEN:-?} (failed: ${FAILED:-?}), last ${LAST:-?}, ${BYTES:-?} bytes, file ${SIZE:-missing}"
+
+if [ -z "$WRITTEN" ] || [ -z "$LAST" ] || [ -z "$SIZE" ]; then
+    echo "FAIL: Missing Checkpoints section or checkpoint file"
+    exit 1
+fi
+if [ "$WRITTEN" -ne 8 ] || [ "$TAKEN" -ne 8 ] || [ "$FAILED" -ne 0 ]; then
+    echo "FAIL: Expected 8 checkpoints written (09:00-16:00)"
+    exit 1
+fi
+if [ "$LAST" != "16:00" ] || [ "$SIZE" -ne "$BYTES" ] || [ -e "$CHECKPOINT.tmp" ]; then
+    echo "FAIL: Last checkpoint is not the complete 16:00 file"
+    exit 1
+fi
+
+echo
+echo "Restoring..."
+START_NS=$(date +%s%N)
+timeout 60 ./ropeway_simulation --restore "$CHECKPOINT" > "$RESTORE_LOG" 2>&1
+EXIT_CODE=$?
+RESTORE_MS=$(( ($(date +%s%N) - START_NS) / 1000000 ))
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Restored simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Restored simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+NEXT_ID=$(grep -o "spawning from tourist [0-9]*" "$RESTORE_LOG" | grep -o "[0-9]*$")
+FIRST_ID=$(grep -o "Spawned tourist [0-9]*:" "$RESTORE_LOG" | head -1 | grep -o "[0-9]*")
+read -r FROM BEFORE < <(sed -n 's/.*Restored from: \([0-9:]*\) (\([0-9]*\) tourists.*/\1 \2/p' simulation_report.txt 2>/dev/null)
+RIDES=$(grep -o "Total rides: [0-9]*" simulation_report.txt 2>/dev/null | grep -o "[0-9]*")
+
+echo "Restored from ${FROM:-?} (${BEFORE:-?} tourists before), first spawn ${FIRST_ID:-?}, ${RESTORE_MS} ms"
+echo "Total rides: ${RIDES:-0}"
+
+if [ "$FROM" != "16:00" ] || [ -z "$NEXT_ID" ] || [ "$NEXT_ID" -ne $((BEFORE + 1)) ]; then
+    echo "FAIL: Restore did not continue the 16:00 checkpoint"
+    exit 1
+fi
+if [ -n "$FIRST_ID" ] && [ "$FIRST_ID" -ne "$NEXT_ID" ]; then
+    echo "FAIL: Restored run spawned tourist $FIRST_ID first (expected $NEXT_ID)"
+    exit 1
+fi
+# One sim hour of a 9 hour day in 6s: well under the full run
+if [ "$RESTORE_MS" -gt 3000 ]; then
+    echo "FAIL: Restored run took $RESTORE_MS ms"
+    exit 1
+fi
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $WRITTEN checkpoints, restore from $FROM went on at tourist $NEXT_ID"
+exit 0
@@ -0,0 +1,140 @@
+#!/bin/bash
+# Test 55: Danger Replay
+#
+# Goal: With DANGER_SCHEDULE=1 every danger stop (sim time, line, worker)
+# is saved next to the arrival schedule; DANGER_SCHEDULE=2 with
+# ARRIVAL_SCHEDULE=2 replays both, so the same stops come back without a
+# single random draw.
+#
+# Rationale: Danger detection is the workers' own random draw, so a
+# recorded run could not be reproduced from its arrivals alone. Replaying
+# the stops makes an emergency-heavy run repeatable for debugging.
+#
+# Parameters: tourists=150, pool=8, spawn_delay=40ms, DANGER_PROBABILITY=3,
+# DANGER_DURATION_SIM_MINUTES=20, RANDOM_SEED=4242, ARRIVAL_SCHEDULE=1 and
+# DANGER_SCHEDULE=1, then both set to 2 with DANGER_PROBABILITY=0,
+# simulation_time=8s.
+#
+# Expected outcome: The danger schedule holds the recorded stops, the replay
+# reports them as replayed, each replayed stop matches a recorded one (same
+# line and worker, in order) at most 3 sim minutes late, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test55_danger_replay.conf"
+REPLAY_CONFIG="/tmp/ropeway_test55_replay.conf"
+LOG_FILE="/tmp/ropeway_test55.log"
+REPLAY_LOG="/tmp/ropeway_test55_replay.log"
+RECORD_REPORT="/tmp/ropeway_test55_report.txt"
+DANGER_FILE="danger_schedule.bin"
+MAX_LAG_SEC=180
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 55: Danger Replay ==="
+echo "Goal: Verify danger stops are recorded and replayed at the same sim times"
+
+# Runs the simulation
+run_sim() {
+    timeout 40 ./ropeway_simulation "$1" > "$2" 2>&1
+    local rc=$?
+    if [ $rc -eq 124 ]; then
+        echo "FAIL: Simulation timed out ($1)"
+        pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+        return 1
+    fi
+    if [ $rc -ne 0 ]; then
+        echo "FAIL: Simulation exited with error code $rc ($1)"
+        return 1
+    fi
+}
+
+# Stops listed in a report's Danger Schedule section: "seconds worker"
+report_stops() {
+    sed -n '/--- Danger Schedule ---/,/^$/p' "$1" | \
+        awk '/ line [0-9]+ / { split($1, t, ":"); print t[1] * 3600 + t[2] * 60 + t[3], $3 "/" $4 }'
+}
+
+sed -e 's/^ARRIVAL_SCHEDULE=.*/ARRIVAL_SCHEDULE=2/' -e 's/^DANGER_SCHEDULE=.*/DANGER_SCHEDULE=2/' \
+    -e 's/^DANGER_PROBABILITY=.*/DANGER_PROBABILITY=0/' "$CONFIG" > "$REPLAY_CONFIG"
+
+rm -f "$DANGER_FILE" arrival_schedule.bin
+echo "Running DANGER_SCHEDULE=1, then DANGER_SCHEDULE=2..."
+run_sim "$CONFIG" "$LOG_FILE" || exit 1
+cp simulation_report.txt "$RECORD_REPORT"
+DANGER_SIZE=$(stat -c %s "$DANGER_FILE" 2>/dev/null || echo 0)
+run_sim "$REPLAY_CONFIG" "$REPLAY_LOG" || exit 1
+rm -f "$REPLAY_CONFIG" "$DANGER_FILE" arrival_schedule.bin
+
+echo
+echo "Analyzing results..."
+
+RECORDED=$(grep -o "Recorded: [0-9]* stops" "$RECORD_REPORT" | grep -o "[0-9]*")
+REPLAYED=$(grep -o "Replayed: [0-9]* of [0-9]* stops" simulation_report.txt)
+echo "Recorded: ${RECORDED:-none}; ${REPLAYED:-no replay section}"
+if [ -z "$RECORDED" ] || [ "$RECORDED" -eq 0 ]; then
+    echo "FAIL: No danger stop recorded"
+    exit 1
+fi
+
+# 24-byte header + 16 bytes per event
+EXPECTED_SIZE=$((24 + 16 * RECORDED))
+echo "Danger schedule file: $DANGER_SIZE bytes (expected $EXPECTED_SIZE)"
+if [ "$DANGER_SIZE" -ne "$EXPECTED_SIZE" ]; then
+    echo "FAIL: Danger schedule file has the wrong size"
+    exit 1
+fi
+if [ -z "$REPLAYED" ] || [ "$(echo "$REPLAYED" | awk '{ print $4 }')" -ne "$RECORDED" ]; then
+    echo "FAIL: Replay did not load the recorded stops"
+    exit 1
+fi
+
+# Match each replayed stop to the next recorded one of the same worker (greedy, in order)
+RESULT=$( { report_stops "$RECORD_REPORT" | sed 's/^/R /'; report_stops simulation_report.txt | sed 's/^/P /'; } | \
+    awk -v max_lag="$MAX_LAG_SEC" '
+        $1 == "R" { rt[nr] = $2; rw[nr] = $3; nr++; next }
+        $1 == "P" { played++
+                    while (j < nr && !(rw[j] == $3 && $2 >= rt[j] && $2 - rt[j] <= max_lag)) j++
+                    if (j == nr) bad++; else { if ($2 - rt[j] > lag) lag = $2 - rt[j]; j++ } }
+        END { print (played + 0) " " (bad + 0) " " (lag + 0) }')
+PLAYED=$(echo "$RESULT" | awk '{ print $1 }')
+UNMATCHED=$(echo "$RESULT" | awk '{ print $2 }')
+LAG=$(echo "$RESULT" | awk '{ print $3 }')
+echo "Replayed stops: $PLAYED, not matching a recording: $UNMATCHED, worst lag: ${LAG}s sim"
+if [ "$PLAYED" -eq 0 ]; then
+    echo "FAIL: No stop replayed"
+    exit 1
+fi
+if [ "$UNMATCHED" -gt 0 ]; then
+    echo "FAIL: Replay stopped the line where the recording did not"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+rm -f "$RECORD_REPORT"
+echo "PASS: $RECORDED danger stops recorded, $PLAYED replayed in order (lag <= ${LAG}s sim)"
+exit 0
@@ -0,0 +1,168 @@
+#!/bin/bash
+# Test 56: Remote Hosts
+#
+# Goal: Tourists from other hosts join the run through the TCP gateway.
+#
+# Rationale: With REMOTE_PORT > 0 main starts a gateway that reserves the last
+# REMOTE_TOURISTS IDs for remote hosts. Two remote_tourists clients connect,
+# read the sim clock epoch from the WELCOME frame and send arrivals in
+# batches: hostA paced on the run's clock (one per sim minute), hostB as fast
+# as it can. The gateway queues each one into MQ_SPAWN for the event host
+# and answers every batch with the current sim time. Together the clients
+# offer more tourists than there are remote IDs, so the gateway must close
+# the range and tell the remaining host to stop. The gateway listens on
+# loopback only and wants REMOTE_TOKEN in every HELLO: a third host with
+# the wrong token must be refused without adding a tourist.
+#
+# Parameters: tourists=300 (IDs 151-300 remote), event hosts=1, 2 remote
+# hosts offering 100 each, 1 host with a wrong token, simulation_time=8s.
+#
+# Expected outcome: 2 hosts served and 1 refused, all 150 remote IDs queued
+# and arrived, the generator's 150 tourists arrived, rides complete, clean
+# shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test56_remote_hosts.conf"
+LOG_FILE="/tmp/ropeway_test56.log"
+HOST_A_LOG="/tmp/ropeway_test56_hostA.log"
+HOST_B_LOG="/tmp/ropeway_test56_hostB.log"
+INTRUDER_LOG="/tmp/ropeway_test56_intruder.log"
+PORT=47156
+TOKEN="test56-secret"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 56: Remote Hosts ==="
+echo "Goal: Verify two remote hosts send tourists through the gateway on port $PORT"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# The clients retry until the gateway listens
+timeout 30 ./remote_tourists --name hostA --seed 1 --rate 60 --token "$TOKEN" "127.0.0.1:$PORT" 100 > "$HOST_A_LOG" 2>&1 &
+HOST_A_PID=$!
+timeout 30 ./remote_tourists --name hostB --seed 2 --token "$TOKEN" "127.0.0.1:$PORT" 100 > "$HOST_B_LOG" 2>&1 &
+HOST_B_PID=$!
+timeout 30 ./remote_tourists --name intruder --seed 3 --token wrong "127.0.0.1:$PORT" 100 > "$INTRUDER_LOG" 2>&1 &
+INTRUDER_PID=$!
+
+wait $HOST_A_PID
+HOST_A_EXIT=$?
+wait $HOST_B_PID
+HOST_B_EXIT=$?
+wait $INTRUDER_PID
+INTRUDER_EXIT=$?
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+cat "$HOST_A_LOG" "$HOST_B_LOG" "$INTRUDER_LOG"
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if [ $HOST_A_EXIT -ne 0 ] || [ $HOST_B_EXIT -ne 0 ]; then
+    echo "FAIL: Remote hosts exited with $HOST_A_EXIT / $HOST_B_EXIT"
+    exit 1
+fi
+
+if [ $INTRUDER_EXIT -ne 1 ] || ! grep -q "did not accept the connection" "$INTRUDER_LOG"; then
+    echo "FAIL: The host with the wrong token was not refused (exit $INTRUDER_EXIT)"
+    exit 1
+fi
+
+if ! grep -q "Listening on 127.0.0.1:$PORT for 150 remote tourists (IDs 151-300, token required)" "$LOG_FILE"; then
+    echo "FAIL: Gateway did not listen on loopback for IDs 151-300 with a token"
+    exit 1
+fi
+
+if ! grep -q "Refused remote host intruder: wrong REMOTE_TOKEN" "$LOG_FILE"; then
+    echo "FAIL: Gateway did not log the wrong token"
+    exit 1
+fi
+
+REPORT="simulation_report.txt"
+grep -A3 "^--- Remote Hosts ---" "$REPORT"
+
+if ! grep -q "hosts: 2 (refused: 1)" "$REPORT"; then
+    echo "FAIL: Report does not show 2 remote hosts and 1 refused"
+    exit 1
+fi
+
+if ! grep -q "Tourists: 150 of 150 remote IDs queued" "$REPORT"; then
+    echo "FAIL: Not every remote ID was queued"
+    exit 1
+fi
+
+# Every remote tourist came from a named host and reached the event host
+REMOTE_QUEUED=$(grep -cE "\[GATEWAY\] Queued tourist [0-9]+ from host[AB]" "$LOG_FILE")
+REMOTE_ARRIVED=$(grep -E "\] [0-9]+ arrived \(age" "$LOG_FILE" | \
+    sed -E 's/.*\] ([0-9]+) arrived.*/\1/' | awk '$1 > 150' | sort -un | wc -l)
+LOCAL_ARRIVED=$(grep -E "\] [0-9]+ arrived \(age" "$LOG_FILE" | \
+    sed -E 's/.*\] ([0-9]+) arrived.*/\1/' | awk '$1 <= 150' | sort -un | wc -l)
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+echo "Remote tourists queued: $REMOTE_QUEUED, arrived: $REMOTE_ARRIVED"
+echo "Generated tourists arrived: $LOCAL_ARRIVED"
+echo "Rides completed: $RIDES"
+
+if [ "$REMOTE_QUEUED" -ne 150 ] || [ "$REMOTE_ARRIVED" -ne 150 ]; then
+    echo "FAIL: Expected 150 remote tourists queued and arrived"
+    exit 1
+fi
+
+if [ "$LOCAL_ARRIVED" -ne 150 ]; then
+    echo "FAIL: Expected the generator's 150 tourists to arrive"
+    exit 1
+fi
+
+# 200 offered for 150 IDs: the gateway told a host it was closed
+if ! grep -q "gateway closed" "$HOST_A_LOG" "$HOST_B_LOG"; then
+    echo "FAIL: No remote host was told the gateway closed"
+    exit 1
+fi
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) + $(pgrep -x remote_tourists | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pgrep -a tourist
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null
+    pkill -9 -x remote_tourists 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: 2 remote hosts supplied all 150 remote tourists through the gateway"
+exit 0
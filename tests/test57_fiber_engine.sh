@@ -0,0 +1,117 @@
+#!/bin/bash
+# Test 57: Fiber Tourist Engine
+#
+# Goal: All tourists run as ucontext fibers on the io_uring scheduler threads
+# of a single fiber host process.
+#
+# Rationale: With TOURIST_ENGINE=3 the generator execs one "tourist --fibers"
+# process with FIBER_THREADS scheduler threads. Each descriptor becomes a
+# fiber running the unchanged tourist_run(); its futex waits and sleeps are
+# io_uring futex waits and timeouts, and its System V calls are retried once
+# per scheduler pass. Verifies that thousands of tourists share two threads
+# against the real cashier and platform workers, and that the host exits
+# once every fiber has returned.
+#
+# Parameters: tourists=2000, fiber threads=2, futex backends, spawn_delay=0,
+# simulation_time=15s.
+#
+# Expected outcome: One tourist process, more live fibers than threads,
+# rides complete, clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test57_fiber_engine.conf"
+LOG_FILE="/tmp/ropeway_test57.log"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 57: Fiber Tourist Engine ==="
+echo "Goal: Verify 2000 tourists run as fibers on 2 threads in one process"
+echo "Running simulation..."
+
+timeout 40 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1 &
+SIM_PID=$!
+
+# Sample tourist process/thread counts mid-run
+sleep 5
+TOURIST_PROCS=$(pgrep -x tourist | wc -l)
+echo "Tourist processes: $TOURIST_PROCS"
+
+wait $SIM_PID
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out - fiber host did not exit"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+if ! grep -q "Started tourist fiber engine (1 process, 2 threads)" "$LOG_FILE"; then
+    echo "FAIL: Fiber engine was not started"
+    exit 1
+fi
+
+if [ "$TOURIST_PROCS" -gt 1 ]; then
+    echo "FAIL: Found $TOURIST_PROCS tourist processes (expected 1)"
+    exit 1
+fi
+
+FINISHED=$(grep "Fiber engine finished" "$LOG_FILE" | tail -1)
+if [ -z "$FINISHED" ]; then
+    echo "FAIL: Fiber host did not report its summary"
+    exit 1
+fi
+PEAK=$(echo "$FINISHED" | sed -n 's/.*peak fibers: \([0-9]*\).*/\1/p')
+
+ARRIVED=$(grep -c "arrived (age" "$LOG_FILE")
+RIDES=$(grep -c "completed ride" "$LOG_FILE")
+echo "Tourists arrived: $ARRIVED"
+echo "Rides completed: $RIDES"
+echo "$FINISHED"
+
+if [ "$ARRIVED" -le 1 ] || [ "${PEAK:-0}" -le 2 ]; then
+    echo "FAIL: Fiber host did not run more tourists than threads at once (peak: ${PEAK:-0})"
+    exit 1
+fi
+
+if [ "$RIDES" -eq 0 ]; then
+    echo "FAIL: No rides completed in fiber engine"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pgrep -a tourist
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Fiber engine ran $ARRIVED tourists on 2 threads (peak $PEAK fibers)"
+exit 0
@@ -0,0 +1,133 @@
+#!/bin/bash
+# Test 58: Process CPU Usage
+#
+# Goal: The report lists the wall time, CPU time and context switches of
+# every worker, helper, the generator and main, the tourists as one
+# aggregate row, and a run total; with PERF_COUNTERS=1 it adds a cycle
+# counter table.
+#
+# Rationale: Each forked process records its getrusage() delta in a
+# ProcessProfile slot as it exits, the generator adds RUSAGE_CHILDREN once
+# every tourist is reaped, and main adds its own usage and all of its
+# children's as the total. A missing or unnamed row means a slot was lost,
+# and a total below the sum of the rows means a delta was taken wrong.
+# Hardware counters may be missing in a VM or refused by
+# perf_event_paranoid; then every row must say why instead of a number.
+#
+# Parameters: 120 tourists (one process each), 2 lines, 2 cashiers, 2
+# boarding workers per line, shm rings, PERF_COUNTERS=1, 4s.
+#
+# Expected outcome: Eleven distinct named process rows, a "Tourists (120)"
+# row, total CPU at least the sum of the rows, eleven counter rows, rides > 0,
+# clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test58_process_usage.conf"
+LOG_FILE="/tmp/ropeway_test58.log"
+REPORT="simulation_report.txt"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 58: Process CPU Usage ==="
+echo "Goal: Verify per-process rusage and counters are reported"
+echo "Running simulation..."
+
+rm -f "$REPORT"
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+SECTION=$(sed -n '/--- CPU Usage per Process/,/^$/p' "$REPORT")
+if [ -z "$SECTION" ]; then
+    echo "FAIL: No CPU usage section in the report"
+    exit 1
+fi
+echo "$SECTION"
+
+# Rows: name wall user system cpu% vol invol rss
+ROWS=$(echo "$SECTION" | awk 'NF == 8 && $2 ~ /^[0-9]+\.[0-9]+$/ && $1 != "Total" { print $1 }')
+COUNT=$(echo "$ROWS" | grep -c .)
+DISTINCT=$(echo "$ROWS" | sort -u | grep -c .)
+echo "Process rows: $COUNT ($DISTINCT distinct)"
+if [ "$COUNT" -ne 11 ] || [ "$DISTINCT" -ne 11 ] || echo "$ROWS" | grep -q "^?$"; then
+    echo "FAIL: Expected 11 distinct named processes"
+    exit 1
+fi
+for NAME in Main TimeServer Cashier Cashier1 LowerWorker UpperWorker BoardingWorker0.1 Generator; do
+    if ! echo "$ROWS" | grep -qx "$NAME"; then
+        echo "FAIL: No row for $NAME"
+        exit 1
+    fi
+done
+
+if ! echo "$SECTION" | grep -qE "^    Tourists \(120\) +[0-9]+\.[0-9]+"; then
+    echo "FAIL: No aggregate row for the 120 tourist processes"
+    exit 1
+fi
+
+# Total CPU (user + system) covers every row, tourists included (0.002s rounding per row)
+if ! echo "$SECTION" | awk '
+    $1 == "Total" { total = $3 + $4; next }
+    $1 == "Tourists" { sum += $4 + $5; rows++; next }
+    NF == 8 && $2 ~ /^[0-9]+\.[0-9]+$/ { sum += $3 + $4; rows++ }
+    END { printf "CPU total %.3f s, sum of rows %.3f s\n", total, sum; exit !(total + 0.002 * rows >= sum && total > 0) }'; then
+    echo "FAIL: Total CPU time below the sum of the processes"
+    exit 1
+fi
+
+COUNTERS=$(sed -n '/--- CPU Counters/,/^$/p' "$REPORT")
+echo "$COUNTERS"
+COUNTER_ROWS=$(echo "$COUNTERS" | grep -cE "^    [^ ]+ +([0-9]+ +[0-9]+ +[0-9]+\.[0-9]+|unavailable \(.+\))$")
+if [ "$COUNTER_ROWS" -ne 11 ]; then
+    echo "FAIL: Expected 11 counter rows, found $COUNTER_ROWS"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" "$REPORT" 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: $COUNT processes and 120 tourists profiled"
+exit 0
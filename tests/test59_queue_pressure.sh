@@ -0,0 +1,131 @@
+#!/bin/bash
+# Test 59: Queue Pressure
+#
+# Goal: The report and the metrics file show, per queue kind, the msg_qbytes
+# limit, the high-water mark in messages and bytes, the time spent full and
+# the sends that found the queue full.
+#
+# Rationale: Senders count a blocked send when their IPC_NOWAIT attempt
+# fails with EAGAIN, and the metrics exporter IPC_STATs every queue each
+# QUEUE_SAMPLE_MS. A generator queuing 3000 descriptors at once for a pool
+# of four always fills MQ_SPAWN, so its row must show a peak within the
+# limit, time at full and blocked sends; a zero there means sampling or
+# the send wrapper is not wired in.
+#
+# Parameters: 3000 tourists on a 4-process pool (no spawn delay), 2 lines,
+# 2 cashiers, System V queues, QUEUE_SAMPLE_MS=5, METRICS_INTERVAL_MS=200, 4s.
+#
+# Expected outcome: Six queue rows; Spawn with 0 < peak bytes <= limit, full
+# time > 0 and blocked sends > 0, matching the metrics file; rides > 0,
+# clean shutdown.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test59_queue_pressure.conf"
+LOG_FILE="/tmp/ropeway_test59.log"
+REPORT="simulation_report.txt"
+METRICS="ropeway_metrics.prom"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 59: Queue Pressure ==="
+echo "Goal: Verify queue depths, time at full and blocked sends are reported"
+echo "Running simulation..."
+
+rm -f "$REPORT" "$METRICS"
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    exit 1
+fi
+
+SECTION=$(sed -n '/--- Queue Pressure/,/^$/p' "$REPORT")
+if [ -z "$SECTION" ]; then
+    echo "FAIL: No queue pressure section in the report"
+    exit 1
+fi
+echo "$SECTION"
+
+# Rows: name limit B peak_msgs peak_bytes full_s full% blocked
+ROWS=$(echo "$SECTION" | awk '$3 == "B" && NF == 8' | grep -c .)
+if [ "$ROWS" -ne 6 ]; then
+    echo "FAIL: Expected 6 sampled System V queue rows, found $ROWS"
+    exit 1
+fi
+
+SPAWN=$(echo "$SECTION" | awk '$1 == "Spawn"')
+LIMIT=$(echo "$SPAWN" | awk '{ print $2 }')
+PEAK_BYTES=$(echo "$SPAWN" | awk '{ print $5 }')
+FULL_S=$(echo "$SPAWN" | awk '{ print $6 }')
+BLOCKED=$(echo "$SPAWN" | awk '{ print $8 }')
+echo "Spawn: limit $LIMIT B, peak $PEAK_BYTES B, full ${FULL_S}s, $BLOCKED blocked sends"
+if [ "${PEAK_BYTES:-0}" -le 0 ] || [ "$PEAK_BYTES" -gt "${LIMIT:-0}" ]; then
+    echo "FAIL: Spawn peak must be within (0, msg_qbytes]"
+    exit 1
+fi
+if ! awk -v s="$FULL_S" 'BEGIN { exit !(s > 0) }'; then
+    echo "FAIL: Spawn queue never sampled full"
+    exit 1
+fi
+if [ "${BLOCKED:-0}" -le 0 ]; then
+    echo "FAIL: No blocked sends on the spawn queue"
+    exit 1
+fi
+
+PROM_BLOCKED=$(grep -o '^ropeway_queue_blocked_sends_total{queue="spawn"} [0-9]*' "$METRICS" | awk '{ print $2 }')
+PROM_PEAK=$(grep -o '^ropeway_queue_high_water_bytes{queue="spawn"} [0-9]*' "$METRICS" | awk '{ print $2 }')
+echo "Metrics: $PROM_BLOCKED blocked sends, peak $PROM_PEAK B"
+if [ "$PROM_BLOCKED" != "$BLOCKED" ] || [ "$PROM_PEAK" != "$PEAK_BYTES" ]; then
+    echo "FAIL: Final metrics disagree with the report"
+    exit 1
+fi
+if ! grep -q '^ropeway_queue_full_seconds_total{queue="platform"}' "$METRICS"; then
+    echo "FAIL: No time-at-full series in the metrics file"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" "$REPORT" 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    exit 1
+fi
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Spawn queue full for ${FULL_S}s, $BLOCKED blocked sends reported"
+exit 0
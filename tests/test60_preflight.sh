@@ -0,0 +1,130 @@
+#!/bin/bash
+# Test 60: Preflight
+#
+# Goal: A run whose QUEUE_BYTES cannot hold one line's queued messages is
+# adapted at startup instead of crawling, and a run the host cannot hold
+# fails before any IPC is created or any process forked.
+#
+# Rationale: A tourist holds one of the three platform gates from its send
+# until its boarding confirmation, so a platform queue never holds more than
+# three messages (120 bytes). QUEUE_BYTES=64 holds one, and two cashier
+# requests, so gate holders and buyers wait in msgsnd and the run completes
+# a small fraction of its rides. PREFLIGHT=1 must raise QUEUE_BYTES (msgmnb
+# needs no capability); PREFLIGHT=2 must refuse the same run, and
+# STATION_CAPACITY=40000 is above SEMVMX whatever the mode.
+#
+# Parameters: QUEUE_BYTES=64, STATION_CAPACITY=50, 1 line, 300 tourists,
+# System V queues, 3s; then PREFLIGHT=2, then STATION_CAPACITY=40000.
+#
+# Expected outcome: First run prints a QUEUE_BYTES adaptation of at least
+# 120 bytes and records rides; the other two exit 1 with a "preflight:"
+# reason (SEMVMX for the last), no tourist started and no IPC left behind.
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+BUILD_DIR="${SCRIPT_DIR}/../build"
+CONFIG="${SCRIPT_DIR}/../config/test60_preflight.conf"
+CHECK_CONFIG="/tmp/ropeway_test60_check.conf"
+SEM_CONFIG="/tmp/ropeway_test60_semvmx.conf"
+LOG_FILE="/tmp/ropeway_test60.log"
+REPORT="simulation_report.txt"
+
+cd "$BUILD_DIR" || exit 1
+
+echo "=== Test 60: Preflight ==="
+echo "Goal: Verify oversized runs are adapted or refused before startup"
+echo "Running simulation..."
+
+sed 's/^PREFLIGHT=1/PREFLIGHT=2/' "$CONFIG" > "$CHECK_CONFIG"
+sed 's/^STATION_CAPACITY=50$/STATION_CAPACITY=40000/' "$CONFIG" > "$SEM_CONFIG"
+
+rm -f "$REPORT"
+timeout 60 ./ropeway_simulation "$CONFIG" > "$LOG_FILE" 2>&1
+EXIT_CODE=$?
+
+echo
+echo "Analyzing results..."
+
+if [ $EXIT_CODE -eq 124 ]; then
+    echo "FAIL: Simulation timed out"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+    exit 1
+fi
+
+if [ $EXIT_CODE -ne 0 ]; then
+    echo "FAIL: Simulation exited with error code $EXIT_CODE"
+    rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+    exit 1
+fi
+
+ADAPTED=$(grep -E "^Preflight: QUEUE_BYTES=" "$LOG_FILE")
+echo "$ADAPTED"
+QUEUE_BYTES=$(echo "$ADAPTED" | grep -o "QUEUE_BYTES=[0-9]*" | grep -o "[0-9]*")
+if [ "${QUEUE_BYTES:-0}" -lt 120 ]; then
+    echo "FAIL: QUEUE_BYTES=64 was not raised to hold three platform messages"
+    rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+    exit 1
+fi
+
+RIDES=$(grep -o "Total rides: [0-9]*" "$REPORT" 2>/dev/null | grep -o "[0-9]*")
+echo "Total rides: ${RIDES:-0}"
+if [ "${RIDES:-0}" -eq 0 ]; then
+    echo "FAIL: No rides recorded"
+    rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+    exit 1
+fi
+
+# The refused runs must stop before any process or IPC exists
+for RUN in "check:$CHECK_CONFIG:msg_qbytes" "semvmx:$SEM_CONFIG:SEMVMX"; do
+    NAME=$(echo "$RUN" | cut -d: -f1)
+    RUN_CONFIG=$(echo "$RUN" | cut -d: -f2)
+    REASON=$(echo "$RUN" | cut -d: -f3)
+
+    timeout 20 ./ropeway_simulation "$RUN_CONFIG" > "$LOG_FILE" 2>&1
+    EXIT_CODE=$?
+    if [ $EXIT_CODE -ne 1 ]; then
+        echo "FAIL: The $NAME run exited with $EXIT_CODE, expected 1"
+        rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+        exit 1
+    fi
+    if ! grep "^preflight: " "$LOG_FILE" | grep -q "$REASON"; then
+        echo "FAIL: The $NAME run gave no preflight reason mentioning $REASON"
+        rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+        exit 1
+    fi
+    if grep -q "TOURIST" "$LOG_FILE"; then
+        echo "FAIL: The $NAME run started processes before failing"
+        rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+        exit 1
+    fi
+    echo "$NAME run refused: $(grep -m1 "^preflight: .*$REASON" "$LOG_FILE")"
+done
+rm -f "$CHECK_CONFIG" "$SEM_CONFIG"
+
+# Check for zombies
+ZOMBIES=$(ps aux | grep -E "(ropeway|tourist)" | grep -v grep | grep defunct | wc -l)
+if [ "$ZOMBIES" -gt 0 ]; then
+    echo "FAIL: Found $ZOMBIES zombie processes"
+    exit 1
+fi
+
+# Check for orphaned processes
+ORPHANS=$(( $(pgrep -x tourist | wc -l) + $(pgrep -x ropeway_simulat | wc -l) ))
+if [ "$ORPHANS" -gt 0 ]; then
+    echo "FAIL: Found $ORPHANS orphaned processes"
+    pkill -9 -x tourist 2>/dev/null; pkill -9 -x ropeway_simulat 2>/dev/null || true
+    exit 1
+fi
+
+# Check for leftover IPC
+IPC_SEM=$(ipcs -s 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_SHM=$(ipcs -m 2>/dev/null | grep "$(id -u)" | wc -l)
+IPC_MQ=$(ipcs -q 2>/dev/null | grep "$(id -u)" | wc -l)
+
+if [ "$IPC_SEM" -gt 0 ] || [ "$IPC_SHM" -gt 0 ] || [ "$IPC_MQ" -gt 0 ]; then
+    echo "FAIL: Leftover IPC resources found"
+    exit 1
+fi
+
+echo "PASS: Undersized QUEUE_BYTES adapted, check-only and SEMVMX runs refused at startup"
+exit 0
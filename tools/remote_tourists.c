@@ -0,0 +1,339 @@
+/**
+ * @file tools/remote_tourists.c
+ * @brief Remote tourist host: send a tourist population to a run's remote gateway.
+ *
+ * Connects to a simulation started with REMOTE_PORT > 0 (protocol in
+ * ipc/remote.h), takes the run's sim clock epoch from the WELCOME and
+ * draws COUNT tourists with the run's VIP, walker and family mix. Arrivals
+ * are Poisson at RATE tourists per sim hour from the current sim time (or
+ * as fast as the gateway takes them with RATE 0). Everything due is sent in
+ * one ARRIVALS frame, so a round trip carries up to REMOTE_BATCH_MAX
+ * tourists. The sim time in every ACK resynchronizes the local clock
+ * estimate. Several hosts can feed one run; they share its remote IDs.
+ *
+ * The HELLO carries --token, which must equal the run's REMOTE_TOKEN (none
+ * by default).
+ *
+ * Usage: remote_tourists [--name NAME] [--seed N] [--rate PER_SIM_HOUR] [--token TOKEN] HOST:PORT COUNT
+ */
+
+#include "constants.h"
+#include "core/rng.h"
+#include "ipc/remote.h"
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <math.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CONNECT_RETRY_MS 5000       // The run may still be starting
+#define CLOCK_QUERY_MS 200          // Empty ARRIVALS frame while nothing is due
+
+/**
+ * @brief Local estimate of the run's sim clock.
+ */
+typedef struct {
+    uint32_t sim_ms;                // Last sim time from the gateway
+    int64_t at_ns;                  // CLOCK_MONOTONIC when it arrived
+    uint32_t rate;                  // sim ms per real second
+} SimClock;
+
+static int64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static double clock_now(const SimClock *c) {
+    return c->sim_ms + (double)(monotonic_ns() - c->at_ns) / 1e9 * c->rate;
+}
+
+static void clock_sync(SimClock *c, uint32_t sim_ms) {
+    c->sim_ms = sim_ms;
+    c->at_ns = monotonic_ns();
+}
+
+/**
+ * @brief Read exactly len bytes.
+ *
+ * @return 0 on success, -1 on error or EOF.
+ */
+static int read_full(int fd, void *buf, size_t len) {
+    size_t got = 0;
+    while (got < len) {
+        ssize_t n = recv(fd, (char *)buf + got, len - got, 0);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        got += (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Send one frame.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int send_frame(int fd, uint32_t type, uint32_t count, const void *payload, size_t len) {
+    unsigned char frame[sizeof(RemoteFrameHeader) + REMOTE_BATCH_MAX * sizeof(RemoteTourist)];
+    RemoteFrameHeader hdr = {htonl(type), htonl(count)};
+    memcpy(frame, &hdr, sizeof(hdr));
+    memcpy(frame + sizeof(hdr), payload, len);
+    size_t total = sizeof(hdr) + len;
+    size_t sent = 0;
+    while (sent < total) {
+        ssize_t n = send(fd, frame + sent, total - sent, MSG_NOSIGNAL);
+        if (n == -1 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return -1;
+        }
+        sent += (size_t)n;
+    }
+    return 0;
+}
+
+/**
+ * @brief Read one frame of the expected type into payload.
+ *
+ * @return 0 on success, -1 on error.
+ */
+static int recv_frame(int fd, uint32_t type, void *payload, size_t len) {
+    RemoteFrameHeader hdr;
+    if (read_full(fd, &hdr, sizeof(hdr)) == -1 || ntohl(hdr.type) != type) {
+        return -1;
+    }
+    return read_full(fd, payload, len);
+}
+
+/**
+ * @brief Connect to HOST:PORT, retrying while the gateway is not listening yet.
+ *
+ * @return Socket, or -1 on error.
+ */
+static int connect_gateway(const char *target) {
+    char host[256];
+    snprintf(host, sizeof(host), "%s", target);
+    char *colon = strrchr(host, ':');
+    if (colon == NULL) {
+        fprintf(stderr, "remote_tourists: expected HOST:PORT, got %s\n", target);
+        return -1;
+    }
+    *colon = '\0';
+    const char *port = colon + 1;
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo *list;
+    int rc = getaddrinfo(host, port, &hints, &list);
+    if (rc != 0) {
+        fprintf(stderr, "remote_tourists: %s: %s\n", target, gai_strerror(rc));
+        return -1;
+    }
+
+    int64_t deadline_ns = monotonic_ns() + (int64_t)CONNECT_RETRY_MS * 1000000LL;
+    int fd = -1;
+    while (fd == -1) {
+        for (struct addrinfo *ai = list; ai != NULL && fd == -1; ai = ai->ai_next) {
+            fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+            if (fd != -1 && connect(fd, ai->ai_addr, ai->ai_addrlen) == -1) {
+                close(fd);
+                fd = -1;
+            }
+        }
+        if (fd == -1) {
+            if (monotonic_ns() > deadline_ns) {
+                perror("remote_tourists: connect");
+                break;
+            }
+            usleep(50000);
+        }
+    }
+    freeaddrinfo(list);
+    if (fd != -1) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+/**
+ * @brief Draw one tourist with the run's mix (same shape as the generator's draw).
+ */
+static RemoteTourist draw_tourist(Rng *rng, const RemoteWelcome *w) {
+    RemoteTourist t;
+    memset(&t, 0, sizeof(t));
+    int band = rng_below(rng, 100);
+    int can_have_kids = 1;
+    if (band < 5) {
+        t.age = (uint8_t)(65 + rng_below(rng, 16));
+    } else if (band < 15) {
+        t.age = (uint8_t)(8 + rng_below(rng, 10));
+        can_have_kids = 0;
+    } else if (band < 30) {
+        t.age = (uint8_t)(18 + rng_below(rng, 8));
+        can_have_kids = 0;
+    } else {
+        t.age = (uint8_t)(26 + rng_below(rng, 39));
+    }
+    t.type = rng_below(rng, 100) < (int)ntohl(w->walker_percentage) ? TOURIST_WALKER
+                                                                       : TOURIST_CYCLIST;
+    t.vip = rng_below(rng, 100) < (int)ntohl(w->vip_percentage);
+    int r = rng_below(rng, 100);
+    t.ticket = r < 30 ? TICKET_SINGLE : r < 50 ? TICKET_TIME_T1 : r < 70 ? TICKET_TIME_T2
+             : r < 85 ? TICKET_TIME_T3 : TICKET_DAILY;
+    if (t.type == TOURIST_WALKER && can_have_kids &&
+        rng_below(rng, 100) < (int)ntohl(w->family_percentage)) {
+        t.type = TOURIST_FAMILY;
+        t.kid_count = rng_below(rng, 100) < 63 ? 1 : 2;
+    }
+    return t;
+}
+
+/**
+ * @brief Next Poisson arrival, sim ms (rate tourists per sim hour).
+ */
+static double next_arrival(Rng *rng, double from_ms, int rate) {
+    double u = ((double)(rng_next(rng) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+    return from_ms - log(u) * 3600000.0 / rate;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--name NAME] [--seed N] [--rate PER_SIM_HOUR] [--token TOKEN] HOST:PORT COUNT\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    const char *name = "remote";
+    const char *token = "";
+    int seed = 0;
+    int rate = 0;
+    int arg = 1;
+    for (; arg + 1 < argc && strncmp(argv[arg], "--", 2) == 0; arg += 2) {
+        if (strcmp(argv[arg], "--name") == 0) {
+            name = argv[arg + 1];
+        } else if (strcmp(argv[arg], "--seed") == 0) {
+            seed = atoi(argv[arg + 1]);
+        } else if (strcmp(argv[arg], "--rate") == 0) {
+            rate = atoi(argv[arg + 1]);
+        } else if (strcmp(argv[arg], "--token") == 0) {
+            token = argv[arg + 1];
+        } else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (argc - arg != 2 || atoi(argv[arg + 1]) <= 0 || rate < 0 || seed < 0 ||
+        strlen(token) >= REMOTE_TOKEN_LEN) {
+        usage(argv[0]);
+        return 1;
+    }
+    int count = atoi(argv[arg + 1]);
+
+    int fd = connect_gateway(argv[arg]);
+    if (fd == -1) {
+        return 1;
+    }
+
+    RemoteHello hello;
+    memset(&hello, 0, sizeof(hello));
+    hello.magic = htonl(REMOTE_MAGIC);
+    hello.version = htonl(REMOTE_VERSION);
+    strncpy(hello.host, name, sizeof(hello.host));
+    memcpy(hello.token, token, strlen(token));  // Rest stays NUL
+    RemoteWelcome w;
+    if (send_frame(fd, REMOTE_MSG_HELLO, 0, &hello, sizeof(hello)) == -1 ||
+        recv_frame(fd, REMOTE_MSG_WELCOME, &w, sizeof(w)) == -1 ||
+        ntohl(w.version) != REMOTE_VERSION) {
+        fprintf(stderr, "remote_tourists: %s did not accept the connection\n", argv[arg]);
+        close(fd);
+        return 1;
+    }
+
+    SimClock clock = {0, 0, ntohl(w.sim_ms_per_real_s)};
+    clock_sync(&clock, ntohl(w.sim_ms));
+    uint32_t batch_max = ntohl(w.batch_max);
+    if (batch_max == 0 || batch_max > REMOTE_BATCH_MAX) {
+        batch_max = REMOTE_BATCH_MAX;
+    }
+    double sim_end_ms = ntohl(w.sim_end_ms);
+    printf("remote_tourists: %s connected, sim %02u:%02u, IDs %u-%u, %u sim ms per s\n", name,
+           ntohl(w.sim_ms) / 3600000, ntohl(w.sim_ms) / 60000 % 60, ntohl(w.first_id),
+           ntohl(w.last_id), clock.rate);
+
+    Rng rng;
+    rng_seed(&rng, rng_base_seed(seed), RNG_STREAM_REMOTE);
+    double due_ms = rate > 0 ? next_arrival(&rng, clock.sim_ms, rate) : 0.0;
+
+    int sent = 0;
+    unsigned accepted = 0, rejected = 0, round_trips = 0, max_batch = 0;
+    int64_t rtt_max_ns = 0;
+    int64_t last_ack_ns = monotonic_ns();
+    int closed = 0;
+    while (sent < count && !closed) {
+        double now = clock_now(&clock);
+        if (now >= sim_end_ms) {
+            break;
+        }
+
+        RemoteTourist batch[REMOTE_BATCH_MAX];
+        uint32_t n = 0;
+        while (n < batch_max && sent + (int)n < count && due_ms <= now) {
+            batch[n++] = draw_tourist(&rng, &w);
+            if (rate > 0) {
+                due_ms = next_arrival(&rng, due_ms, rate);
+            }
+        }
+        if (n == 0 && (monotonic_ns() - last_ack_ns) / 1000000 < CLOCK_QUERY_MS) {
+            // Sleep until the next arrival is due (at most until the next clock query)
+            double wait_ms = clock.rate > 0 ? (due_ms - now) * 1000.0 / clock.rate : CLOCK_QUERY_MS;
+            if (wait_ms > CLOCK_QUERY_MS) wait_ms = CLOCK_QUERY_MS;
+            if (wait_ms < 1) wait_ms = 1;
+            usleep((useconds_t)(wait_ms * 1000));
+            continue;
+        }
+
+        int64_t start_ns = monotonic_ns();
+        RemoteAck ack;
+        if (send_frame(fd, REMOTE_MSG_ARRIVALS, n, batch, n * sizeof(RemoteTourist)) == -1 ||
+            recv_frame(fd, REMOTE_MSG_ACK, &ack, sizeof(ack)) == -1) {
+            fprintf(stderr, "remote_tourists: connection to the gateway lost\n");
+            break;
+        }
+        last_ack_ns = monotonic_ns();
+        if (last_ack_ns - start_ns > rtt_max_ns) {
+            rtt_max_ns = last_ack_ns - start_ns;
+        }
+        clock_sync(&clock, ntohl(ack.sim_ms));
+        sent += (int)n;
+        accepted += ntohl(ack.accepted);
+        rejected += ntohl(ack.rejected);
+        round_trips++;
+        if (n > max_batch) {
+            max_batch = n;
+        }
+        closed = (ntohl(ack.flags) & REMOTE_FLAG_CLOSED) != 0;
+    }
+    close(fd);
+
+    printf("remote_tourists: %s sent %d, accepted %u, rejected %u in %u round trips "
+           "(max batch %u, max round trip %.3f ms)%s\n", name, sent, accepted, rejected,
+           round_trips, max_batch, rtt_max_ns / 1e6, closed ? ", gateway closed" : "");
+    return 0;
+}
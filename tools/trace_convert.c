@@ -0,0 +1,276 @@
+/**
+ * @file tools/trace_convert.c
+ * @brief Convert a binary event trace (EVENT_TRACE=1) to CSV or Chrome trace JSON.
+ *
+ * CSV has one row per record. Chrome trace JSON (chrome://tracing, Perfetto)
+ * shows one track per tourist with a duration slice per stage, and one track
+ * per worker with instant events; timestamps are simulated time since the
+ * start of the day. Also reads a trace that is still being written or was
+ * left behind by a crashed run (unpublished records are skipped).
+ *
+ * Usage: trace_convert [--csv | --chrome] <trace.bin> [output]
+ */
+
+#include "constants.h"
+#include "core/trace.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+static const char *g_stage_names[] = {
+    "at_cashier", "at_entry_gates", "entered_lower_station", "queued_for_platform",
+    "at_lower_platform", "on_chair", "ride_complete", "at_upper_platform_gates",
+    "on_trail", "leaving"
+};
+
+static const char *g_source_names[] = {"none", "tourist", "cashier", "lower_worker", "upper_worker"};
+
+/**
+ * @brief Name of a record's event code.
+ */
+static const char *event_name(int event) {
+    if (event >= 0 && event <= STAGE_LEAVING) {
+        return g_stage_names[event];
+    }
+    switch (event) {
+        case TRACE_TICKET_SOLD:     return "ticket_sold";
+        case TRACE_CHAIR_DEPARTED:  return "chair_departed";
+        case TRACE_RIDER_ARRIVED:   return "rider_arrived";
+        case TRACE_CHAIR_RELEASED:  return "chair_released";
+        case TRACE_DANGER_DETECTED: return "danger_detected";
+        default:                    return "unknown";
+    }
+}
+
+/**
+ * @brief Name of the gate (semaphore index) a record refers to.
+ */
+static const char *gate_name(int gate) {
+    switch (gate) {
+        case SEM_ENTRY_GATES:    return "entry_gates";
+        case SEM_LOWER_STATION:  return "lower_station";
+        case SEM_PLATFORM_GATES: return "platform_gates";
+        case SEM_EXIT_GATES:     return "exit_gates";
+        default:                 return "";
+    }
+}
+
+/**
+ * @brief Name of the process that wrote a record.
+ */
+static const char *source_name(int source) {
+    if (source >= 0 && source <= TRACE_SRC_UPPER) {
+        return g_source_names[source];
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Load header and published records from a trace file.
+ *
+ * @param path Trace file.
+ * @param header Output header.
+ * @param count_out Number of records returned.
+ * @return Records (malloc'd, caller frees), or NULL on error.
+ */
+static TraceRecord *load_trace(const char *path, TraceHeader *header, size_t *count_out) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        perror("trace_convert: fopen");
+        return NULL;
+    }
+
+    struct stat st;
+    if (fstat(fileno(f), &st) == -1 || fread(header, sizeof(*header), 1, f) != 1) {
+        fprintf(stderr, "trace_convert: %s: cannot read header\n", path);
+        fclose(f);
+        return NULL;
+    }
+    if (memcmp(header->magic, TRACE_MAGIC, sizeof(header->magic)) != 0 ||
+        header->version != TRACE_VERSION || header->record_size != sizeof(TraceRecord)) {
+        fprintf(stderr, "trace_convert: %s: not a version %d trace file\n", path, TRACE_VERSION);
+        fclose(f);
+        return NULL;
+    }
+
+    // Closed trace: records is exact. Open or crashed: bounded by cursor and file size.
+    uint64_t wanted = header->records;
+    if (wanted == 0) {
+        wanted = header->count < header->capacity ? header->count : header->capacity;
+    }
+    uint64_t in_file = ((uint64_t)st.st_size - sizeof(*header)) / sizeof(TraceRecord);
+    if (wanted > in_file) {
+        wanted = in_file;
+    }
+
+    TraceRecord *records = malloc((size_t)(wanted > 0 ? wanted : 1) * sizeof(TraceRecord));
+    if (records == NULL) {
+        perror("trace_convert: malloc");
+        fclose(f);
+        return NULL;
+    }
+
+    size_t kept = 0;
+    TraceRecord rec;
+    for (uint64_t i = 0; i < wanted && fread(&rec, sizeof(rec), 1, f) == 1; i++) {
+        if (rec.source != 0) {
+            records[kept++] = rec;
+        }
+    }
+    fclose(f);
+    *count_out = kept;
+    return records;
+}
+
+/**
+ * @brief Write one CSV row per record.
+ */
+static void write_csv(FILE *out, const TraceRecord *records, size_t count) {
+    fprintf(out, "sim_time_ms,sim_time,source,tourist_id,event,chair_id,gate,count\n");
+    for (size_t i = 0; i < count; i++) {
+        const TraceRecord *r = &records[i];
+        int64_t ms = r->sim_time_ms;
+        fprintf(out, "%lld,%02d:%02d:%02d.%03d,%s,%d,%s,%d,%s,%d\n",
+                (long long)ms,
+                (int)(ms / 3600000), (int)(ms / 60000 % 60), (int)(ms / 1000 % 60), (int)(ms % 1000),
+                source_name(r->source), r->tourist_id, event_name(r->event),
+                r->chair_id, gate_name(r->gate), r->count);
+    }
+}
+
+/**
+ * @brief Open stage of one tourist (Chrome output).
+ */
+typedef struct {
+    int open;
+    TraceRecord rec;
+} OpenStage;
+
+/**
+ * @brief Write one Chrome trace event (always follows the metadata events).
+ */
+static void chrome_event(FILE *out, const TraceRecord *r, int64_t start_ms,
+                         const char *phase, int64_t dur_us) {
+    int pid = (r->source == TRACE_SRC_TOURIST) ? 1 : 2;
+    int tid = (r->source == TRACE_SRC_TOURIST) ? r->tourist_id : r->source;
+    int64_t ts_us = (r->sim_time_ms - start_ms) * 1000;
+
+    fprintf(out, ",\n{\"name\":\"%s\",\"ph\":\"%s\",\"pid\":%d,\"tid\":%d,\"ts\":%lld",
+            event_name(r->event), phase, pid, tid, (long long)ts_us);
+    if (phase[0] == 'X') {
+        fprintf(out, ",\"dur\":%lld", (long long)dur_us);
+    } else {
+        fprintf(out, ",\"s\":\"t\"");
+    }
+    fprintf(out, ",\"args\":{\"tourist_id\":%d,\"chair_id\":%d,\"gate\":\"%s\",\"count\":%d}}",
+            r->tourist_id, r->chair_id, gate_name(r->gate), r->count);
+}
+
+/**
+ * @brief Write Chrome trace JSON: stage slices per tourist, instants per worker.
+ *
+ * @return 0 on success, -1 on allocation failure.
+ */
+static int write_chrome(FILE *out, const TraceHeader *header, const TraceRecord *records,
+                        size_t count) {
+    int max_id = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (records[i].tourist_id > max_id) {
+            max_id = records[i].tourist_id;
+        }
+    }
+    OpenStage *stages = calloc((size_t)max_id + 1, sizeof(OpenStage));
+    if (stages == NULL) {
+        perror("trace_convert: calloc");
+        return -1;
+    }
+
+    int64_t start_ms = (int64_t)header->sim_start_minutes * 60000;
+    fprintf(out, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+    fprintf(out, "\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"tourists\"}}");
+    fprintf(out, ",\n{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":2,\"args\":{\"name\":\"workers\"}}");
+    for (int src = TRACE_SRC_CASHIER; src <= TRACE_SRC_UPPER; src++) {
+        fprintf(out, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":2,\"tid\":%d,"
+                "\"args\":{\"name\":\"%s\"}}", src, source_name(src));
+    }
+
+    // A tourist's records are in claim order, so each stage ends where the next begins
+    for (size_t i = 0; i < count; i++) {
+        const TraceRecord *r = &records[i];
+        if (r->source != TRACE_SRC_TOURIST) {
+            chrome_event(out, r, start_ms, "i", 0);
+            continue;
+        }
+        OpenStage *s = &stages[r->tourist_id];
+        if (s->open) {
+            chrome_event(out, &s->rec, start_ms, "X",
+                         (r->sim_time_ms - s->rec.sim_time_ms) * 1000);
+        }
+        s->rec = *r;
+        s->open = (r->event != STAGE_LEAVING);
+        if (!s->open) {
+            chrome_event(out, r, start_ms, "i", 0);
+        }
+    }
+
+    // Stages still open when the trace ended (shutdown mid-ride)
+    for (int id = 0; id <= max_id; id++) {
+        if (stages[id].open) {
+            chrome_event(out, &stages[id].rec, start_ms, "i", 0);
+        }
+    }
+    fprintf(out, "\n]}\n");
+    free(stages);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    int chrome = 0;
+    int argi = 1;
+    if (argi < argc && strcmp(argv[argi], "--chrome") == 0) {
+        chrome = 1;
+        argi++;
+    } else if (argi < argc && strcmp(argv[argi], "--csv") == 0) {
+        argi++;
+    }
+    if (argi >= argc || argc - argi > 2) {
+        fprintf(stderr, "Usage: %s [--csv | --chrome] <trace.bin> [output]\n", argv[0]);
+        return 1;
+    }
+
+    TraceHeader header;
+    size_t count = 0;
+    TraceRecord *records = load_trace(argv[argi], &header, &count);
+    if (records == NULL) {
+        return 1;
+    }
+
+    FILE *out = stdout;
+    if (argi + 1 < argc) {
+        out = fopen(argv[argi + 1], "w");
+        if (out == NULL) {
+            perror("trace_convert: fopen output");
+            free(records);
+            return 1;
+        }
+    }
+
+    int ret = 0;
+    if (chrome) {
+        ret = write_chrome(out, &header, records, count);
+    } else {
+        write_csv(out, records, count);
+    }
+
+    if (header.dropped > 0) {
+        fprintf(stderr, "trace_convert: %llu records were dropped (trace file full)\n",
+                (unsigned long long)header.dropped);
+    }
+    if (out != stdout) {
+        fclose(out);
+    }
+    free(records);
+    return ret == 0 ? 0 : 1;
+}